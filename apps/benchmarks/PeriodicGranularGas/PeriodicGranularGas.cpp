@@ -19,11 +19,13 @@
 //======================================================================================================================
 
 #include <pe/basic.h>
+#include <pe/ccd/VerletCCDDataHandling.h>
 #include <pe/vtk/SphereVtkOutput.h>
 
 #include <core/Abort.h>
 #include <core/Environment.h>
 #include <core/math/Random.h>
+#include <core/mpi/Reduce.h>
 #include <core/grid_generator/SCIterator.h>
 #include <core/logging/Logging.h>
 #include <core/timing/TimingTree.h>
@@ -57,6 +59,7 @@ int main( int argc, char ** argv )
    bool bHCSITS = false;
 
    bool bNN = false;
+   bool bNNDelta = false;
    bool bSO = false;
 
    bool bInelasticFrictionlessContact = false;
@@ -70,6 +73,7 @@ int main( int argc, char ** argv )
       if( std::strcmp( argv[i], "--HCSITS" ) == 0 ) bHCSITS = true;
 
       if( std::strcmp( argv[i], "--syncNextNeighbor" ) == 0 ) bNN = true;
+      if( std::strcmp( argv[i], "--syncNextNeighborDelta" ) == 0 ) bNNDelta = true;
       if( std::strcmp( argv[i], "--syncShadowOwners" ) == 0 ) bSO = true;
 
       if( std::strcmp( argv[i], "--InelasticFrictionlessContact" ) == 0 ) bInelasticFrictionlessContact = true;
@@ -93,6 +97,10 @@ int main( int argc, char ** argv )
    WALBERLA_LOG_INFO_ON_ROOT("visSpacing: " << visSpacing);
    const std::string path = mainConf.getParameter<std::string>("path",  "vtk_out" );
    WALBERLA_LOG_INFO_ON_ROOT("path: " << path);
+   const real_t verletSkin = mainConf.getParameter<real_t>("verletSkin", real_t(0) );
+   WALBERLA_LOG_INFO_ON_ROOT("verletSkin: " << verletSkin);
+   const real_t deltaTolerance = mainConf.getParameter<real_t>("deltaTolerance", real_t(0) );
+   WALBERLA_LOG_INFO_ON_ROOT("deltaTolerance: " << deltaTolerance);
 
    WALBERLA_LOG_INFO_ON_ROOT("*** GLOBALBODYSTORAGE ***");
    shared_ptr<BodyStorage> globalBodyStorage = make_shared<BodyStorage>();
@@ -117,7 +125,16 @@ int main( int argc, char ** argv )
    WALBERLA_LOG_INFO_ON_ROOT("*** STORAGEDATAHANDLING ***");
    // add block data
    auto storageID           = forest->addBlockData(createStorageDataHandling<BodyTuple>(), "Storage");
-   auto ccdID               = forest->addBlockData(ccd::createHashGridsDataHandling( globalBodyStorage, storageID ), "CCD");
+   BlockDataID ccdID;
+   if (verletSkin > real_t(0))
+   {
+      ccdID = forest->addBlockData(ccd::createVerletCCDDataHandling( globalBodyStorage, storageID, verletSkin ), "CCD");
+      WALBERLA_LOG_INFO_ON_ROOT("Using Verlet lists!");
+   } else
+   {
+      ccdID = forest->addBlockData(ccd::createHashGridsDataHandling( globalBodyStorage, storageID ), "CCD");
+      WALBERLA_LOG_INFO_ON_ROOT("Using HashGrids!");
+   }
    auto fcdID               = forest->addBlockData(fcd::createGenericFCDDataHandling<BodyTuple, fcd::AnalyticCollideFunctor>(), "FCD");
 
    WALBERLA_LOG_INFO_ON_ROOT("*** INTEGRATOR ***");
@@ -165,6 +182,10 @@ int main( int argc, char ** argv )
    {
       syncCallWithoutTT = std::bind( pe::syncNextNeighbors<BodyTuple>, boost::ref(*forest), storageID, &tt, real_c(0.1), false );
       WALBERLA_LOG_INFO_ON_ROOT("Using NextNeighbor sync!");
+   } else if (bNNDelta)
+   {
+      syncCallWithoutTT = std::bind( pe::syncNextNeighborsDelta<BodyTuple>, boost::ref(*forest), storageID, &tt, real_c(0.1), false, deltaTolerance );
+      WALBERLA_LOG_INFO_ON_ROOT("Using NextNeighbor sync with delta-encoded updates!");
    } else if (bSO)
    {
       syncCallWithoutTT = std::bind( pe::syncShadowOwners<BodyTuple>, boost::ref(*forest), storageID, &tt, real_c(0.1), false );
@@ -230,6 +251,20 @@ int main( int argc, char ** argv )
    WALBERLA_MPI_BARRIER();
    timer.end();
    WALBERLA_LOG_INFO_ON_ROOT("runtime: " << timer.average());
+   if (verletSkin > real_t(0))
+   {
+      uint_t rebuilds = 0;
+      uint_t updates  = 0;
+      for (auto& currentBlock : *forest)
+      {
+         ccd::VerletCCD* ccd = currentBlock.getData< ccd::VerletCCD >( ccdID );
+         rebuilds += ccd->getRebuildCount();
+         updates  += ccd->getUpdateCount();
+      }
+      mpi::reduceInplace(rebuilds, mpi::SUM);
+      mpi::reduceInplace(updates, mpi::SUM);
+      WALBERLA_LOG_INFO_ON_ROOT("Verlet list rebuilds: " << rebuilds << " / " << updates << " (" << real_c(rebuilds) / real_c(std::max(updates, uint_t(1))) << ")");
+   }
    WALBERLA_LOG_INFO_ON_ROOT("*** SIMULATION - END ***");
 
    auto temp = tt.getReduced( );
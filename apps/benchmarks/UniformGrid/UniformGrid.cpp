@@ -67,6 +67,7 @@
 #include "lbm/sweeps/SplitPureSweep.h"
 #include "lbm/sweeps/SplitSweep.h"
 #include "lbm/sweeps/SweepWrappers.h"
+#include "lbm/sweeps/TemporalBlockingSweep.h"
 #include "lbm/vtk/Density.h"
 #include "lbm/vtk/Velocity.h"
 
@@ -81,6 +82,7 @@
 #include "vtk/Initialization.h"
 #include "vtk/VTKOutput.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -501,7 +503,8 @@ struct AddLB
 
    static void add( shared_ptr< blockforest::StructuredBlockForest > & blocks, SweepTimeloop & timeloop,
                     const BlockDataID & pdfFieldId, const BlockDataID & flagFieldId, const BlockDataID & boundaryHandlingId,
-                    const bool split, const bool pure, const bool fullComm, const bool fused, const bool directComm )
+                    const bool split, const bool pure, const bool fullComm, const bool fused, const bool directComm,
+                    const uint_t temporalBlockingDepth )
    {
       // setup of the LB communication for synchronizing the pdf field between neighboring blocks
 
@@ -539,7 +542,18 @@ struct AddLB
          }
       }
 
-      if( fused )
+      if( temporalBlockingDepth > uint_t(0) )
+      {
+         using BoundaryHandling_T = typename MyBoundaryHandling<LatticeModel_T>::BoundaryHandling_T;
+
+         lbm::TemporalBlockingSweep temporalBlocking( temporalBlockingDepth );
+         temporalBlocking.addSweep( lbm::TemporalBlockingBoundarySweep< BoundaryHandling_T >( boundaryHandlingId ) );
+         temporalBlocking.addSweep( lbm::makeStreamCollideSweep( lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( pdfFieldId, flagFieldId, Fluid_Flag ) ) );
+
+         timeloop.add() << BeforeFunction( commFunction, "LB communication" )
+                        << Sweep( temporalBlocking, "cell-wise LB sweep (boundary & stream & collide, temporal blocking)" );
+      }
+      else if( fused )
       {
          timeloop.add() << BeforeFunction( commFunction, "LB communication" )
                         << Sweep( MyBoundaryHandling<LatticeModel_T>::BoundaryHandling_T::getBlockSweep( boundaryHandlingId ), "LB boundary sweep" );
@@ -605,7 +619,8 @@ struct AddLB< LatticeModel_T, typename boost::enable_if_c< boost::mpl::or_<
 
    static void add( shared_ptr< blockforest::StructuredBlockForest > & blocks, SweepTimeloop & timeloop,
                     const BlockDataID & pdfFieldId, const BlockDataID & flagFieldId, const BlockDataID & boundaryHandlingId,
-                    const bool /*split*/, const bool /*pure*/, const bool fullComm, const bool fused, const bool directComm )
+                    const bool /*split*/, const bool /*pure*/, const bool fullComm, const bool fused, const bool directComm,
+                    const uint_t temporalBlockingDepth )
    {
       // setup of the LB communication for synchronizing the pdf field between neighboring blocks
 
@@ -644,7 +659,18 @@ struct AddLB< LatticeModel_T, typename boost::enable_if_c< boost::mpl::or_<
          }
       }
 
-      if( fused )
+      if( temporalBlockingDepth > uint_t(0) )
+      {
+         using BoundaryHandling_T = typename MyBoundaryHandling<LatticeModel_T>::BoundaryHandling_T;
+
+         lbm::TemporalBlockingSweep temporalBlocking( temporalBlockingDepth );
+         temporalBlocking.addSweep( lbm::TemporalBlockingBoundarySweep< BoundaryHandling_T >( boundaryHandlingId ) );
+         temporalBlocking.addSweep( lbm::makeStreamCollideSweep( lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( pdfFieldId, flagFieldId, Fluid_Flag ) ) );
+
+         timeloop.add() << BeforeFunction( commFunction, "LB communication" )
+                        << Sweep( temporalBlocking, "cell-wise LB sweep (boundary & stream & collide, temporal blocking)" );
+      }
+      else if( fused )
       {
          timeloop.add() << BeforeFunction( commFunction, "LB communication" )
                         << Sweep( MyBoundaryHandling<LatticeModel_T>::BoundaryHandling_T::getBlockSweep( boundaryHandlingId ), "LB boundary sweep" );
@@ -666,7 +692,8 @@ struct AddLB< LatticeModel_T, typename boost::enable_if_c< boost::mpl::or_<
 
 template< typename LatticeModel_T >
 void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeModel,
-          const bool split, const bool pure, const bool fzyx, const bool fullComm, const bool fused, const bool directComm )
+          const bool split, const bool pure, const bool fzyx, const bool fullComm, const bool fused, const bool directComm,
+          const uint_t temporalBlockingDepth )
 {
    using PdfField = typename Types<LatticeModel_T>::PdfField_T;
 
@@ -676,18 +703,22 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
 
    auto blocks = createStructuredBlockForest( configBlock );
 
+   // temporal blocking: all time steps that are blocked require their own ghost layer
+
+   const uint_t ghostLayers = std::max( FieldGhostLayers, temporalBlockingDepth );
+
    // add pdf field to blocks
 
    BlockDataID pdfFieldId = fzyx ? lbm::addPdfFieldToStorage( blocks, "pdf field (fzyx)", latticeModel,
                                                               Vector3< real_t >( real_c(0), real_c(0), real_c(0) ), real_t(1),
-                                                              FieldGhostLayers, field::fzyx ) :
+                                                              ghostLayers, field::fzyx ) :
                                    lbm::addPdfFieldToStorage( blocks, "pdf field (zyxf)", latticeModel,
                                                               Vector3< real_t >( real_c(0), real_c(0), real_c(0) ), real_t(1),
-                                                              FieldGhostLayers, field::zyxf );
+                                                              ghostLayers, field::zyxf );
 
    // add flag field to blocks
 
-   BlockDataID flagFieldId = field::addFlagFieldToStorage< FlagField_T >( blocks, "flag field" );
+   BlockDataID flagFieldId = field::addFlagFieldToStorage< FlagField_T >( blocks, "flag field", ghostLayers );
 
    // add LB boundary handling to blocks
 
@@ -701,7 +732,14 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
    const uint_t outerTimeSteps = configBlock.getParameter< uint_t >( "outerTimeSteps", uint_c(1 ) );
    const uint_t innerTimeSteps = configBlock.getParameter< uint_t >( "innerTimeSteps", uint_c(10) );
 
-   SweepTimeloop timeloop( blocks->getBlockStorage(), outerTimeSteps * innerTimeSteps );
+   // with temporal blocking, every time step of the time loop advances the simulation by 'temporalBlockingDepth' LBM time steps
+
+   const uint_t timeStepsPerTimeloopStep = std::max( uint_t(1), temporalBlockingDepth );
+   if( innerTimeSteps % timeStepsPerTimeloopStep != uint_t(0) )
+      WALBERLA_ABORT( "The number of inner time steps (" << innerTimeSteps << ") must be a multiple of the temporal blocking depth ("
+                      << timeStepsPerTimeloopStep << ")!" );
+
+   SweepTimeloop timeloop( blocks->getBlockStorage(), ( outerTimeSteps * innerTimeSteps ) / timeStepsPerTimeloopStep );
 
    // VTK
 
@@ -719,7 +757,8 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
 
    // add LB kernel, boundary handling, and communication to time loop
 
-   AddLB< LatticeModel_T >::add( blocks, timeloop, pdfFieldId, flagFieldId, boundaryHandlingId, split, pure, fullComm, fused, directComm );
+   AddLB< LatticeModel_T >::add( blocks, timeloop, pdfFieldId, flagFieldId, boundaryHandlingId, split, pure, fullComm, fused, directComm,
+                                 temporalBlockingDepth );
 
    // logging right before the benchmark starts
 
@@ -735,7 +774,8 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
                               "\n- pure kernel:                     " << ( pure ? "yes (collision is also performed within obstacle cells)" : "no" ) <<
                               "\n- data layout:                     " << ( fzyx ? "fzyx (structure of arrays [SoA])" : "zyxf (array of structures [AoS])" ) <<
                               "\n- communication:                   " << ( fullComm ? "full synchronization" : "direction-aware optimizations" ) <<
-                              "\n- direct communication:            " << ( directComm ? "enabled" : "disabled" ) );
+                              "\n- direct communication:            " << ( directComm ? "enabled" : "disabled" ) <<
+                              "\n- temporal blocking:               " << ( temporalBlockingDepth > uint_t(0) ? std::to_string( temporalBlockingDepth ) + " time steps" : std::string("disabled") ) );
 
    // run the benchmark
 
@@ -749,7 +789,7 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
       WcTimer timer;
       timer.start();
 
-      for( uint_t innerRun = 0; innerRun < innerTimeSteps; ++innerRun )
+      for( uint_t innerRun = 0; innerRun < innerTimeSteps; innerRun += timeStepsPerTimeloopStep )
          timeloop.singleStep( timeloopTiming );
 
       timer.end();
@@ -788,6 +828,8 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
             stringProperties[ "fullCommunication" ] = ( fullComm ? "yes" : "no" );
             stringProperties[ "directComm"]         = ( directComm ? "yes" : "no" );
 
+            integerProperties[ "temporalBlockingDepth" ] = int_c( temporalBlockingDepth );
+
             auto runId = postprocessing::storeRunInSqliteDB( sqlFile, integerProperties, stringProperties, realProperties );
             postprocessing::storeTimingPoolInSqliteDB( sqlFile, runId, *reducedTimeloopTiming, "Timeloop" );
          }
@@ -807,7 +849,8 @@ void run( const shared_ptr< Config > & config, const LatticeModel_T & latticeMod
                               "\n- pure kernel:                     " << ( pure ? "yes (collision is also performed within obstacle cells)" : "no" ) <<
                               "\n- data layout:                     " << ( fzyx ? "fzyx (structure of arrays [SoA])" : "zyxf (array of structures [AoS])" ) <<
                               "\n- communication:                   " << ( fullComm ? "full synchronization" : "direction-aware optimizations" ) <<
-                              "\n- direct communication:            " << ( directComm ? "enabled" : "disabled" ) );
+                              "\n- direct communication:            " << ( directComm ? "enabled" : "disabled" ) <<
+                              "\n- temporal blocking:               " << ( temporalBlockingDepth > uint_t(0) ? std::to_string( temporalBlockingDepth ) + " time steps" : std::string("disabled") ) );
 
 }
 
@@ -826,7 +869,7 @@ int main( int argc, char **argv )
    {
       WALBERLA_ROOT_SECTION()
       {
-         std::cout << "Usage: " << argv[0] << " path-to-configuration-file [--trt | --mrt] [--comp] [--not-split] [--not-pure] [--zyxf] [--full-comm] [--not-fused] [--direct-comm]\n"
+         std::cout << "Usage: " << argv[0] << " path-to-configuration-file [--trt | --mrt] [--comp] [--not-split] [--not-pure] [--zyxf] [--full-comm] [--not-fused] [--direct-comm] [--temporal-blocking]\n"
                       "\n"
                       "By default, SRT is selected as collision model, a communication with direction-aware optimizations is chosen, and an\n"
                       "incompressible, split, pure LB kernel is executed on a PDF field with layout 'fzyx' (= structure of arrays [SoA]).\n"
@@ -846,6 +889,11 @@ int main( int argc, char **argv )
                       " --not-fused:   Selects separate LB kernels for collision and streaming.\n"
                       "                By default, a 'fused' stream & collide kernel is used.\n"
                       " --direct-comm: Enables bufferless direct communication\n"
+                      " --temporal-blocking: Enables temporal blocking: all ghost layers are synchronized only every\n"
+                      "                'temporalBlockingDepth' (configuration file, default: 2) time steps, in between each block\n"
+                      "                performs this many fused, cell-wise stream & collide steps in a row. Requires full\n"
+                      "                communication and non-split kernels. Choose small blocks ('blocksPerProcess') that fit\n"
+                      "                into the cache.\n"
                       "\n"
                       "Please note: For small/very small blocks (i.e., blocks with only few cells), the best performance may be achieved with\n"
                       "             basic (non-split), incompressible LB kernels combined with an array of structures ('zyxf') data layout!" << std::endl;
@@ -910,6 +958,7 @@ int main( int argc, char **argv )
    bool fullComm     = false;
    bool fused        = true;
    bool directComm   = false;
+   bool temporalBlocking = false;
 
    for( int i = 2; i < argc; ++i )
    {
@@ -923,6 +972,7 @@ int main( int argc, char **argv )
       if( std::strcmp( argv[i], "--full-comm" )   == 0 ) fullComm       = true;
       if( std::strcmp( argv[i], "--not-fused" )   == 0 ) fused          = false;
       if( std::strcmp( argv[i], "--direct-comm" ) == 0 ) directComm     = true;
+      if( std::strcmp( argv[i], "--temporal-blocking" ) == 0 ) temporalBlocking = true;
    }
 
    if( pure && !split )
@@ -949,6 +999,24 @@ int main( int argc, char **argv )
       pure         = false;
    }
 
+   uint_t temporalBlockingDepth = uint_t(0);
+   if( temporalBlocking )
+   {
+      temporalBlockingDepth = configBlock.getParameter< uint_t >( "temporalBlockingDepth", uint_t(2) );
+      if( temporalBlockingDepth == uint_t(0) )
+         WALBERLA_ABORT( "Parameter \"temporalBlockingDepth\" must be greater than zero!" );
+
+      if( split || pure || !fullComm || !fused )
+      {
+         WALBERLA_LOG_WARNING_ON_ROOT( "Option \"--temporal-blocking\" requires options \"--not-split\", \"--not-pure\", and \"--full-comm\" and\n"
+                                       "can only be used with fused kernels! Setting \"split\" and \"pure\" to false and \"fullComm\" and \"fused\" to true ..." );
+         split    = false;
+         pure     = false;
+         fullComm = true;
+         fused    = true;
+      }
+   }
+
    WALBERLA_NON_MPI_SECTION()
    {
       if( directComm )
@@ -968,12 +1036,12 @@ int main( int argc, char **argv )
       if( compressible )
       {
          D3Q19_SRT_COMP latticeModel = D3Q19_SRT_COMP( lbm::collision_model::SRT( omega ) );
-         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm );
+         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm, temporalBlockingDepth );
       }
       else
       {
          D3Q19_SRT_INCOMP latticeModel = D3Q19_SRT_INCOMP( lbm::collision_model::SRT( omega ) );
-         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm );
+         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm, temporalBlockingDepth );
       }
    }
    else if( collisionModel == CMTRT ) // TRT
@@ -981,23 +1049,23 @@ int main( int argc, char **argv )
       if( compressible )
       {
          D3Q19_TRT_COMP latticeModel = D3Q19_TRT_COMP( lbm::collision_model::TRT::constructWithMagicNumber( omega ) );
-         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm );
+         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm, temporalBlockingDepth );
       }
       else
       {
          D3Q19_TRT_INCOMP latticeModel = D3Q19_TRT_INCOMP( lbm::collision_model::TRT::constructWithMagicNumber( omega ) );
-         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm );
+         run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm, temporalBlockingDepth );
       }
    }
    else if( collisionModel == CMMRT ) // MRT
    {
       D3Q19_MRT_INCOMP latticeModel = D3Q19_MRT_INCOMP( lbm::collision_model::D3Q19MRT::constructTRTWithMagicNumber( omega ) );
-      run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm );
+      run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm, temporalBlockingDepth );
    }
    else  // Cumulant
    {
       D3Q27_CUMULANT_COMP latticeModel = D3Q27_CUMULANT_COMP( lbm::collision_model::D3Q27Cumulant(omega) );
-      run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm );
+      run( config, latticeModel, split, pure, fzyx, fullComm, fused, directComm, temporalBlockingDepth );
    }
 
    logging::Logging::printFooterOnStream();
@@ -27,6 +27,7 @@
 #include "core/config/Config.h"
 #include "core/math/AABB.h"
 
+#include <algorithm>
 #include <vector>
 
 
@@ -136,6 +137,27 @@ public:
       }
    }
 
+   // for static refinement of a distributed block forest (see refineBlockForestDistributed in Initialization.h):
+   // results in the same block structure as the static refinement of a SetupBlockForest, blocks are never coarsened
+   void staticRefinement( std::vector< std::pair< const Block *, uint_t > > & minTargetLevels,
+                          std::vector< const Block * > &, const BlockForest & forest ) const
+   {
+      std::vector< std::pair< math::AABB, uint_t > > aabbs = transformRegionsToAABBs( forest.getDomain() );
+      aabbs.insert( aabbs.end(), aabbs_.begin(), aabbs_.end() );
+
+      for( auto it = minTargetLevels.begin(); it != minTargetLevels.end(); ++it )
+      {
+         uint_t targetLevelOfBlock = it->first->getLevel();
+
+         for( auto aabb = aabbs.begin(); aabb != aabbs.end(); ++aabb )
+         {
+            if( it->first->getAABB().intersects( aabb->first ) )
+               targetLevelOfBlock = std::max( targetLevelOfBlock, aabb->second );
+         }
+
+         it->second = targetLevelOfBlock;
+      }
+   }
 
 private:
 
@@ -0,0 +1,297 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file AsyncCheckpointWriter.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "AsyncCheckpointWriter.h"
+
+#include "core/Abort.h"
+#include "core/logging/Logging.h"
+#include "core/mpi/MPIManager.h"
+#include "core/mpi/Reduce.h"
+#include "core/timing/Timer.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace walberla {
+namespace blockforest {
+namespace internal {
+
+
+
+/// executed by an I/O thread: compresses the chunks of the snapshot (no MPI calls!)
+static double compressCheckpointSnapshot( const shared_ptr< CheckpointSnapshot > snapshot, const bool compress, const uint_t elementSize )
+{
+   WcTimer timer;
+   timer.start();
+
+   if( compress )
+      compressCheckpointChunks( elementSize, *snapshot );
+
+   timer.end();
+   return timer.last();
+}
+
+
+
+/// executed by an I/O thread: writes the part of the file that belongs to this process (no MPI calls!)
+static double writeCheckpointSnapshot( const std::string file, const shared_ptr< const CheckpointSnapshot > snapshot )
+{
+   WcTimer timer;
+   timer.start();
+
+   // the file was already created by the root process, it must not be truncated
+   std::fstream stream( file.c_str(), std::fstream::in | std::fstream::out | std::fstream::binary );
+   if( !stream )
+      throw std::runtime_error( "Error while opening file \"" + file + "\" for writing." );
+
+   if( !snapshot->data.empty() )
+   {
+      stream.seekp( numeric_cast< std::streamoff >( snapshot->offset ) );
+      stream.write( reinterpret_cast< const char * >( &(snapshot->data[0]) ), numeric_cast< std::streamsize >( snapshot->data.size() ) );
+   }
+   if( !snapshot->header.empty() )
+   {
+      stream.seekp( 0 );
+      stream.write( reinterpret_cast< const char * >( &(snapshot->header[0]) ), numeric_cast< std::streamsize >( snapshot->header.size() ) );
+   }
+   if( !snapshot->index.empty() )
+   {
+      stream.seekp( numeric_cast< std::streamoff >( snapshot->indexOffset ) );
+      stream.write( reinterpret_cast< const char * >( &(snapshot->index[0]) ), numeric_cast< std::streamsize >( snapshot->index.size() ) );
+   }
+
+   stream.close();
+   if( !stream )
+      throw std::runtime_error( "Error while writing to file \"" + file + "\"." );
+
+   timer.end();
+   return timer.last();
+}
+
+
+
+static bool isReady( const std::future< double > & future )
+{
+   return future.wait_for( std::chrono::seconds(0) ) == std::future_status::ready;
+}
+
+/// returns the result of an I/O thread, an error of the I/O thread aborts the program (on the calling thread)
+static double result( std::future< double > & future, const std::string & file )
+{
+   try
+   {
+      return future.get();
+   }
+   catch( const std::exception & e )
+   {
+      WALBERLA_ABORT( "Error while writing checkpoint \"" << file << "\" in the background: " << e.what() );
+   }
+   return 0.0;
+}
+
+
+
+} // namespace internal
+
+
+
+AsyncCheckpointWriter::AsyncCheckpointWriter( const shared_ptr< StructuredBlockForest > & blocks, const std::vector< BlockDataID > & ids,
+                                              const uint_t maxInFlight, const bool compress, const uint_t elementSize ) :
+   blocks_( blocks ), ids_( ids ), maxInFlight_( maxInFlight ), compress_( compress ), elementSize_( elementSize ),
+   lastSnapshotTime_( 0.0 )
+{
+   WALBERLA_CHECK_GREATER( maxInFlight_, uint_t(0) );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   Takes a snapshot of the block data and starts writing it to 'file' in the background (must be called by all
+*   processes). If the maximal number of checkpoints is already being written, or if 'file' is still being written,
+*   this function first waits for the completion of the oldest checkpoints.
+*/
+//**********************************************************************************************************************
+void AsyncCheckpointWriter::write( const std::string & file )
+{
+   poll();
+
+   // the decision is identical on all processes since all processes have the same list of pending checkpoints
+   auto mustWait = [&]() {
+      if( pending_.size() >= maxInFlight_ )
+         return true;
+      for( auto it = pending_.begin(); it != pending_.end(); ++it )
+         if( it->file == file )
+            return true;
+      return false;
+   };
+   while( !pending_.empty() && mustWait() )
+      completeOldest();
+
+   auto blocks = blocks_.lock();
+   WALBERLA_CHECK_NOT_NULLPTR( blocks, "Trying to access 'AsyncCheckpointWriter' for a block storage object that doesn't exist anymore" );
+
+   WALBERLA_LOG_PROGRESS( "Taking snapshot for checkpoint \"" << file << "\" ..." );
+
+   WcTimer timer;
+   timer.start();
+
+   PendingCheckpoint checkpoint;
+   checkpoint.file     = file;
+   checkpoint.snapshot = make_shared< internal::CheckpointSnapshot >();
+   checkpoint.seconds  = 0.0;
+
+   internal::serializeCheckpointChunks( blocks->getBlockForest(), ids_, *checkpoint.snapshot );
+
+   timer.end();
+   lastSnapshotTime_ = timer.last();
+   mpi::allReduceInplace( lastSnapshotTime_, mpi::MAX );
+
+   checkpoint.compression = std::async( std::launch::async, internal::compressCheckpointSnapshot, checkpoint.snapshot, compress_, elementSize_ );
+   pending_.push_back( std::move( checkpoint ) );
+
+   WALBERLA_LOG_PROGRESS( "Checkpoint \"" << file << "\" is written in the background (snapshot took " << lastSnapshotTime_ << " s)" );
+}
+
+
+
+/// Detects checkpoints whose compression or writing is finished without blocking (must be called by all processes)
+void AsyncCheckpointWriter::poll()
+{
+   // the writing is started in the same order in which the checkpoints were taken
+   for( auto checkpoint = pending_.begin(); checkpoint != pending_.end(); ++checkpoint )
+   {
+      if( !checkpoint->compression.valid() ) // writing already started
+         continue;
+      bool finished = internal::isReady( checkpoint->compression );
+      mpi::allReduceInplace( finished, mpi::LOGICAL_AND );
+      if( !finished )
+         break;
+      startWriting( *checkpoint );
+   }
+
+   while( !pending_.empty() && pending_.front().writing.valid() )
+   {
+      bool finished = internal::isReady( pending_.front().writing );
+      mpi::allReduceInplace( finished, mpi::LOGICAL_AND );
+      if( !finished )
+         break;
+      complete();
+   }
+}
+
+
+
+/// Waits until all checkpoints are completed (must be called by all processes)
+void AsyncCheckpointWriter::wait()
+{
+   while( !pending_.empty() )
+      completeOldest();
+}
+
+
+
+std::function< void () > AsyncCheckpointWriter::getFunctor( const std::string & baseName, const uint_t interval )
+{
+   auto counter = make_shared< uint_t >( uint_t(0) );
+
+   return [this, baseName, interval, counter]()
+   {
+      ++(*counter);
+      if( interval > uint_t(0) && ( *counter % interval ) == uint_t(0) )
+      {
+         std::ostringstream file;
+         file << baseName << "_" << *counter << ".dat";
+         write( file.str() );
+      }
+      else
+         poll();
+   };
+}
+
+
+
+/// Determines the position of the compressed chunks in the file and starts writing (must be called by all processes
+/// once the compression is finished on all processes)
+void AsyncCheckpointWriter::startWriting( PendingCheckpoint & checkpoint )
+{
+   checkpoint.seconds = internal::result( checkpoint.compression, checkpoint.file );
+
+   internal::layoutCheckpointSnapshot( compress_, elementSize_, *checkpoint.snapshot );
+
+   // the file must exist before any I/O thread starts writing
+   WALBERLA_ROOT_SECTION()
+   {
+      std::ofstream stream( checkpoint.file.c_str(), std::ofstream::binary | std::ofstream::trunc );
+      if( !stream )
+         WALBERLA_ABORT( "Error while opening file \"" << checkpoint.file << "\" for writing." );
+   }
+   WALBERLA_MPI_BARRIER()
+
+   checkpoint.writing = std::async( std::launch::async, internal::writeCheckpointSnapshot, checkpoint.file,
+                                    shared_ptr< const internal::CheckpointSnapshot >( checkpoint.snapshot ) );
+}
+
+
+
+/// waits for the oldest pending checkpoint and completes it (must be called by all processes)
+void AsyncCheckpointWriter::completeOldest()
+{
+   WALBERLA_ASSERT( !pending_.empty() );
+
+   PendingCheckpoint & checkpoint = pending_.front();
+   if( checkpoint.compression.valid() )
+   {
+      checkpoint.compression.wait();
+      startWriting( checkpoint );
+   }
+   checkpoint.writing.wait();
+   complete();
+}
+
+
+
+/// completes the oldest pending checkpoint, which must have been written on all processes
+void AsyncCheckpointWriter::complete()
+{
+   WALBERLA_ASSERT( !pending_.empty() );
+
+   PendingCheckpoint & checkpoint = pending_.front();
+
+   CheckpointStatistics statistics = checkpoint.snapshot->statistics;
+   statistics.seconds = checkpoint.seconds + internal::result( checkpoint.writing, checkpoint.file );
+   internal::reduceCheckpointStatistics( statistics );
+
+   const std::string file = checkpoint.file;
+   pending_.pop_front();
+
+   WALBERLA_LOG_PROGRESS( "Checkpoint \"" << file << "\" completed" );
+
+   if( callback_ )
+      callback_( file, statistics );
+}
+
+
+
+} // namespace blockforest
+} // namespace walberla
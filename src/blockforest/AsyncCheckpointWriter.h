@@ -0,0 +1,135 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file AsyncCheckpointWriter.h
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "Checkpoint.h"
+#include "StructuredBlockForest.h"
+
+#include "core/DataTypes.h"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+
+namespace walberla {
+namespace blockforest {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Writes checkpoints (see Checkpoint.h) in the background while the simulation continues
+*
+*   write() takes a snapshot of the block data, i.e., the block data is serialized into a staging buffer, and returns
+*   as soon as the snapshot is taken. The block data can be modified immediately afterwards. Everything else is done
+*   by dedicated I/O threads in two stages: first, the staging buffer is compressed. Once the compression is finished
+*   on all processes, the positions of the chunks in the file are determined (see poll()) and a second I/O thread
+*   writes the data to the checkpoint file. At most 'maxInFlight' checkpoints are processed at the same time, if the
+*   limit is reached, write() first waits for the oldest checkpoint to be completed. Hence, the memory required for
+*   the staging buffers is bounded by 'maxInFlight' times the size of the snapshots.
+*
+*   The I/O threads do not call any MPI functions (every process writes its part of the file with POSIX I/O), so the
+*   writer does not require any MPI thread support level. All communication (the positions of the chunks in the file,
+*   the index, the detection of the completion on all processes) is done by write(), poll(), wait(), and the
+*   destructor, which are collective operations and must be called by all processes in the same order. Errors of an
+*   I/O thread are passed to the thread that calls these functions, which then aborts the program.
+*
+*   A checkpoint is completed once all processes have finished writing. The completion is detected by poll() (or by
+*   wait(), write() and the destructor), which then calls the completion callback with the statistics of the
+*   checkpoint (statistics.seconds is the time spent by the I/O threads, the time the simulation is stalled for
+*   taking the snapshot is available via lastSnapshotTime()). A checkpoint file must not be read before it is
+*   completed.
+*
+*   Typical usage as a function that is executed after every time step:
+*   \code
+*   blockforest::AsyncCheckpointWriter checkpointWriter( blocks, { pdfFieldId, flagFieldId } );
+*   checkpointWriter.setCompletionCallback( []( const std::string & file, const blockforest::CheckpointStatistics & statistics ) {
+*      WALBERLA_LOG_INFO_ON_ROOT( "Checkpoint \"" << file << "\" written:\n" << statistics );
+*   } );
+*   timeloop.addFuncAfterTimeStep( checkpointWriter.getFunctor( "checkpoint", uint_t(1000) ), "checkpointing" );
+*   \endcode
+*/
+//**********************************************************************************************************************
+class AsyncCheckpointWriter
+{
+public:
+
+   typedef std::function< void ( const std::string & file, const CheckpointStatistics & statistics ) > CompletionCallback;
+
+   AsyncCheckpointWriter( const shared_ptr< StructuredBlockForest > & blocks, const std::vector< BlockDataID > & ids,
+                          const uint_t maxInFlight = uint_t(2), const bool compress = true, const uint_t elementSize = sizeof(real_t) );
+
+   /// waits for the completion of all pending checkpoints, hence the destructor is collective (see wait())
+   ~AsyncCheckpointWriter() { wait(); }
+
+   void setCompletionCallback( const CompletionCallback & callback ) { callback_ = callback; }
+
+   void write( const std::string & file );
+
+   void poll();
+   void wait();
+
+   /// number of checkpoints that are written in the background (or whose completion has not yet been detected)
+   uint_t numberOfPendingCheckpoints() const { return uint_c( pending_.size() ); }
+
+   /// time (maximum over all processes) the simulation was stalled for taking the snapshot during the last write()
+   double lastSnapshotTime() const { return lastSnapshotTime_; }
+
+   /// Returns a function that can be executed after every time step: every 'interval' calls, a checkpoint
+   /// "<baseName>_<step>.dat" is written, completed checkpoints are detected in every call.
+   std::function< void () > getFunctor( const std::string & baseName, const uint_t interval );
+
+private:
+
+   struct PendingCheckpoint
+   {
+      std::string file;
+      shared_ptr< internal::CheckpointSnapshot > snapshot;
+      std::future< double > compression; ///< valid until the compression is finished on all processes
+      std::future< double > writing;     ///< valid once the writing is started
+      double seconds;                    ///< time spent by the I/O threads for the compression
+   };
+
+   void startWriting( PendingCheckpoint & checkpoint );
+   void completeOldest();
+   void complete();
+
+   weak_ptr< StructuredBlockForest > blocks_;
+   std::vector< BlockDataID > ids_;
+
+   uint_t maxInFlight_;
+   bool compress_;
+   uint_t elementSize_;
+
+   CompletionCallback callback_;
+
+   std::deque< PendingCheckpoint > pending_;
+   double lastSnapshotTime_;
+
+}; // class AsyncCheckpointWriter
+
+
+
+} // namespace blockforest
+} // namespace walberla
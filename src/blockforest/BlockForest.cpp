@@ -637,6 +637,129 @@ BlockForest::BlockForest( const uint_t process, const char* const filename, cons
 
 
 
+//**********************************************************************************************************************
+/*!
+*   \brief Distributed construction of a block forest that only consists of root blocks (depth = 0)
+*
+*   Contrary to the construction from a SetupBlockForest, no process ever holds the global block structure: every
+*   process only passes the tree indices of its own root blocks ('rootBlocks'). The process of any other root block is
+*   determined by 'rootBlockProcess' (argument: tree index of the root block, return value: process rank), which is only
+*   called for the neighbors of the local blocks. Global block information is not available.
+*   The tree index of the root block at forest coordinates (x,y,z) is z * ySize * xSize + y * xSize + x.
+*/
+//**********************************************************************************************************************
+BlockForest::BlockForest( const uint_t process, const AABB & domain, const uint_t xSize, const uint_t ySize, const uint_t zSize,
+                          const bool xPeriodic, const bool yPeriodic, const bool zPeriodic, const uint_t numberOfProcesses,
+                          const std::vector< uint_t > & rootBlocks, const std::function< uint_t ( const uint_t ) > & rootBlockProcess ) :
+
+   BlockStorage( domain, xPeriodic, yPeriodic, zPeriodic ),
+
+   process_( process ), depth_( uint_t(0) ), insertBuffersIntoProcessNetwork_( false ), modificationStamp_( uint_t(0) ),
+   recalculateBlockLevelsInRefresh_( true ), alwaysRebalanceInRefresh_( false ), allowMultipleRefreshCycles_( true ),
+   reevaluateMinTargetLevelsAfterForcedRefinement_( false ),
+   checkForEarlyOutInRefresh_( true ), checkForLateOutInRefresh_( true ), allowChangingDepth_( true ), checkForEarlyOutAfterLoadBalancing_( false ),
+   phantomBlockMigrationIterations_( uint_t(0) ),
+   nextCallbackBeforeBlockDataIsPackedHandle_( uint_t(0) ), nextCallbackBeforeBlockDataIsUnpackedHandle_( uint_t(0) ),
+   nextCallbackAfterBlockDataIsUnpackedHandle_( uint_t(0) ),
+   snapshotExists_( false ), snapshotDepth_( uint_t(0) ), snapshotBlockDataItems_( uint_t(0) )
+{
+   WALBERLA_CHECK_GREATER( xSize, uint_t(0) );
+   WALBERLA_CHECK_GREATER( ySize, uint_t(0) );
+   WALBERLA_CHECK_GREATER( zSize, uint_t(0) );
+   WALBERLA_CHECK_LESS( process, numberOfProcesses );
+
+   blockInformation_ = make_shared< BlockInformation >( *this );
+
+   size_[0] = xSize;
+   size_[1] = ySize;
+   size_[2] = zSize;
+
+   // same tree IDs and process ID size as the ones chosen by SetupBlockForest
+
+   const uint_t maxIndex = xSize * ySize * zSize - 1;
+   uint_t treeIdMarker = 1;
+   while( treeIdMarker <= maxIndex )
+      treeIdMarker <<= 1;
+
+   treeIdDigits_ = uintMSBPosition( treeIdMarker );
+
+   const uint_t processIdBits = uintMSBPosition( numberOfProcesses - 1 );
+   processIdBytes_ = ( processIdBits >> 3 ) + ( ( processIdBits & 7 ) ? uint_c(1) : uint_c(0) );
+
+   BlockReconstruction::AABBReconstruction aabbReconstruction( domain_, size_[0], size_[1], size_[2], treeIdDigits_ );
+   BlockReconstruction::NeighborhoodReconstruction< Block > neighborhoodReconstruction( domain_, periodic_[0], periodic_[1], periodic_[2] );
+
+   std::set< uint_t > localBlocks( rootBlocks.begin(), rootBlocks.end() );
+   std::set< uint_t > neighbors;
+
+   for( auto rootBlock = localBlocks.begin(); rootBlock != localBlocks.end(); ++rootBlock )
+   {
+      WALBERLA_CHECK_LESS_EQUAL( *rootBlock, maxIndex );
+
+      uint_t x,y,z;
+      SetupBlockForest::mapTreeIndexToForestCoordinates( *rootBlock, xSize, ySize, x, y, z );
+
+      // the block itself and all root blocks of its 3x3x3 neighborhood (with respect to periodicity)
+
+      std::vector< BlockReconstruction::NeighborhoodReconstructionBlock > neighborhood;
+      std::set< uint_t > neighborhoodIndices;
+
+      for( int k = -1; k <= 1; ++k ) {
+         for( int j = -1; j <= 1; ++j ) {
+            for( int i = -1; i <= 1; ++i )
+            {
+               const int coordinates[] = { int_c(x) + i, int_c(y) + j, int_c(z) + k };
+               uint_t n[3];
+               bool inside( true );
+               for( uint_t d = 0; d != 3; ++d )
+               {
+                  const int size = int_c( size_[d] );
+                  if( coordinates[d] < 0 || coordinates[d] >= size )
+                  {
+                     if( !periodic_[d] )
+                        inside = false;
+                     n[d] = uint_c( ( coordinates[d] + size ) % size );
+                  }
+                  else
+                     n[d] = uint_c( coordinates[d] );
+               }
+               if( !inside )
+                  continue;
+
+               const uint_t treeIndex = n[2] * ySize * xSize + n[1] * xSize + n[0];
+               if( !neighborhoodIndices.insert( treeIndex ).second )
+                  continue;
+
+               uint_t neighborProcess = process_;
+               if( localBlocks.find( treeIndex ) == localBlocks.end() )
+               {
+                  neighborProcess = rootBlockProcess( treeIndex );
+                  WALBERLA_CHECK_LESS( neighborProcess, numberOfProcesses );
+                  WALBERLA_CHECK_UNEQUAL( neighborProcess, process_ );
+                  neighbors.insert( neighborProcess );
+               }
+
+               neighborhood.emplace_back( BlockID( treeIndex, treeIdMarker ), neighborProcess, aabbReconstruction );
+            }
+         }
+      }
+
+      const BlockID id( *rootBlock, treeIdMarker );
+
+      AABB aabb;
+      const uint_t level = aabbReconstruction( aabb, id );
+
+      blocks_[ id ] = std::make_shared< Block >( *this, id, aabb, Set<SUID>::emptySet(), level, neighborhoodReconstruction, neighborhood );
+   }
+
+   for( auto it = neighbors.begin(); it != neighbors.end(); ++it )
+      neighborhood_.push_back( *it );
+
+   registerRefreshTimer();
+}
+
+
+
 void BlockForest::getBlockID( IBlockID& id, const real_t x, const real_t y, const real_t z ) const {
 
    WALBERLA_ASSERT_EQUAL( dynamic_cast< BlockID* >( &id ), &id );
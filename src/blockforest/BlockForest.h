@@ -223,6 +223,9 @@ public:
 
    BlockForest( const uint_t process, const SetupBlockForest& forest, const bool keepGlobalBlockInformation = false );
    BlockForest( const uint_t process, const char* const filename, const bool broadcastFile = true, const bool keepGlobalBlockInformation = false );
+   BlockForest( const uint_t process, const AABB & domain, const uint_t xSize, const uint_t ySize, const uint_t zSize,
+                const bool xPeriodic, const bool yPeriodic, const bool zPeriodic, const uint_t numberOfProcesses,
+                const std::vector< uint_t > & rootBlocks, const std::function< uint_t ( const uint_t ) > & rootBlockProcess );
 
    ~BlockForest() {}
 
@@ -373,6 +376,16 @@ public:
                               const domain_decomposition::internal::SelectableBlockDataHandlingWrapper & dataHandling, const std::string & identifier = std::string() )
    { return BlockStorage::loadBlockData( file, dataHandling, identifier ); }
 
+   template< typename T >
+   inline BlockDataID loadBlockData( mpi::RecvBuffer & buffer, const shared_ptr< T > & dataHandling,
+                                     const std::string & identifier          = std::string(),
+                                     const Set<SUID> & requiredSelectors     = Set<SUID>::emptySet(),
+                                     const Set<SUID> & incompatibleSelectors = Set<SUID>::emptySet() );
+
+   BlockDataID loadBlockData( mpi::RecvBuffer & buffer,
+                              const domain_decomposition::internal::SelectableBlockDataHandlingWrapper & dataHandling, const std::string & identifier = std::string() )
+   { return BlockStorage::loadBlockData( buffer, dataHandling, identifier ); }
+
 
    // AMR Pipeline
    // 1) distributed block level adjustment (callbacks are called that determine if a block level changes)
@@ -411,6 +424,7 @@ public:
    /// callback for AMR pipeline step 1
    /// guaranteed minimal block level
    void setRefreshMinTargetLevelDeterminationFunction( const RefreshMinTargetLevelDeterminationFunction & f ) { refreshMinTargetLevelDeterminationFunction_ = f; }
+   const RefreshMinTargetLevelDeterminationFunction & getRefreshMinTargetLevelDeterminationFunction() const { return refreshMinTargetLevelDeterminationFunction_; }
 
    /// allow multiple AMR passes (possibility to refine more than once within one time step)
    /// if true, one all-to-all reduction with a boolean value is performed during refresh
@@ -900,6 +914,30 @@ inline BlockDataID BlockForest::loadBlockData( const std::string & file, const s
 
 
 
+template< typename T >
+inline BlockDataID BlockForest::loadBlockData( mpi::RecvBuffer & buffer, const shared_ptr< T > & dataHandling, const std::string & identifier,
+                                               const Set<SUID> & requiredSelectors, const Set<SUID> & incompatibleSelectors )
+{
+   auto downcast = dynamic_pointer_cast< blockforest::BlockDataHandling<typename T::value_type> >( dataHandling );
+
+   if( downcast )
+   {
+      domain_decomposition::internal::SelectableBlockDataHandlingWrapper sbdhw(
+               walberla::make_shared< internal::BlockDataHandlingHelper<typename T::value_type> >( downcast ),
+               requiredSelectors, incompatibleSelectors, identifier );
+
+      return loadBlockData( buffer, sbdhw, identifier );
+   }
+
+   domain_decomposition::internal::SelectableBlockDataHandlingWrapper sbdhw(
+            walberla::make_shared< domain_decomposition::internal::BlockDataHandlingHelper<typename T::value_type> >( dataHandling ),
+            requiredSelectors, incompatibleSelectors, identifier );
+
+   return loadBlockData( buffer, sbdhw, identifier );
+}
+
+
+
 inline uint_t BlockForest::addRefreshCallbackFunctionBeforeBlockDataIsPacked( const RefreshCallbackFunction & f )
 {
    callbackBeforeBlockDataIsPacked_.insert( callbackBeforeBlockDataIsPacked_.end(), std::make_pair( nextCallbackBeforeBlockDataIsPackedHandle_, f ) );
@@ -22,9 +22,11 @@
 #include "BlockForestEvaluation.h"
 #include "core/math/DistributedSample.h"
 #include "core/math/FPClassify.h"
+#include "core/math/Sample.h"
 #include "core/mpi/MPIManager.h"
 
 #include <cmath>
+#include <set>
 
 
 namespace walberla {
@@ -36,6 +38,61 @@ std::string boolToText( const bool b )
    std::string result( b ? "yes" : "no" );
    return result;
 }
+
+/// communication of the blocks of one process with blocks on other processes
+class ProcessCommunication
+{
+public:
+
+   ProcessCommunication() : edgeCut_( uint_t(0) ), volume_( uint_t(0) ) {}
+
+   /// 'neighborProcesses' contains the process of every neighbor of a block that resides on 'process'
+   void addBlock( const uint_t process, const std::vector< uint_t > & neighborProcesses )
+   {
+      std::set< uint_t > remoteProcesses;
+      for( auto neighbor = neighborProcesses.begin(); neighbor != neighborProcesses.end(); ++neighbor )
+      {
+         if( *neighbor != process )
+         {
+            ++edgeCut_;
+            remoteProcesses.insert( *neighbor );
+         }
+      }
+      volume_ += uint_c( remoteProcesses.size() );
+      neighborProcesses_.insert( remoteProcesses.begin(), remoteProcesses.end() );
+   }
+
+   real_t edgeCut() const { return real_c( edgeCut_ ); }
+   real_t volume() const { return real_c( volume_ ); }
+   real_t neighborProcesses() const { return real_c( neighborProcesses_.size() ); }
+
+private:
+
+   uint_t edgeCut_;
+   uint_t volume_;
+   std::set< uint_t > neighborProcesses_;
+};
+
+template< typename Sample_T >
+void setStatistics( BlockForestEvaluation::BlockStatistics & statistics, const Sample_T & sample )
+{
+   statistics.sum = sample.sum();
+   statistics.min = sample.min();
+   statistics.max = sample.max();
+   statistics.avg = sample.mean();
+   statistics.stdDev = sample.stdDeviation();
+   const auto relStdDev = sample.relativeStdDeviation();
+   statistics.relStdDev = math::isnan( relStdDev ) ? real_t(0) : relStdDev;
+}
+
+void statisticsToStream( std::ostream & os, const BlockForestEvaluation::BlockStatistics & statistics, const std::string & indent )
+{
+   os << "\n" << indent << "+ min       = " << statistics.min
+      << "\n" << indent << "+ max       = " << statistics.max
+      << "\n" << indent << "+ avg       = " << statistics.avg
+      << "\n" << indent << "+ stdDev    = " << statistics.stdDev
+      << "\n" << indent << "+ relStdDev = " << statistics.relStdDev;
+}
 }
 
 
@@ -63,6 +120,85 @@ BlockForestEvaluation::BlockForestEvaluation( const BlockForest & forest ) :
          blockStatistics_[i].relStdDev = math::isnan( relStdDev ) ? real_t(0) : relStdDev;
       }
    }
+
+   internal::ProcessCommunication communication;
+   const uint_t process = forest.getProcess();
+   for( auto it = forest.begin(); it != forest.end(); ++it )
+   {
+      const Block * block = dynamic_cast< const Block * >( it.get() );
+      WALBERLA_ASSERT_NOT_NULLPTR( block );
+
+      std::vector< uint_t > neighborProcesses;
+      for( uint_t n = uint_t(0); n != block->getNeighborhoodSize(); ++n )
+         neighborProcesses.push_back( block->getNeighborProcess(n) );
+      communication.addBlock( process, neighborProcesses );
+   }
+
+   math::DistributedSample edgeCut;
+   math::DistributedSample volume;
+   math::DistributedSample neighbors;
+   edgeCut.insert( communication.edgeCut() );
+   volume.insert( communication.volume() );
+   neighbors.insert( communication.neighborProcesses() );
+   edgeCut.mpiGatherRoot();
+   volume.mpiGatherRoot();
+   neighbors.mpiGatherRoot();
+
+   WALBERLA_ROOT_SECTION()
+   {
+      internal::setStatistics( communicationStatistics_.edgeCut, edgeCut );
+      internal::setStatistics( communicationStatistics_.communicationVolume, volume );
+      internal::setStatistics( communicationStatistics_.neighborProcesses, neighbors );
+   }
+}
+
+
+
+BlockForestEvaluation::CommunicationStatistics BlockForestEvaluation::communicationStatistics( const SetupBlockForest & forest )
+{
+   WALBERLA_CHECK_GREATER( forest.getNumberOfProcesses(), uint_t(0),
+                           "The blocks of the SetupBlockForest have not yet been distributed to processes (see SetupBlockForest::balanceLoad)!" );
+
+   std::vector< internal::ProcessCommunication > communication( forest.getNumberOfProcesses() );
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+   {
+      std::vector< uint_t > neighborProcesses;
+      for( uint_t n = uint_t(0); n != block->getNeighborhoodSize(); ++n )
+         neighborProcesses.push_back( block->getNeighborTargetProcess(n) );
+      communication[ block->getTargetProcess() ].addBlock( block->getTargetProcess(), neighborProcesses );
+   }
+
+   math::Sample edgeCut;
+   math::Sample volume;
+   math::Sample neighbors;
+   for( auto process = communication.begin(); process != communication.end(); ++process )
+   {
+      edgeCut.insert( process->edgeCut() );
+      volume.insert( process->volume() );
+      neighbors.insert( process->neighborProcesses() );
+   }
+
+   CommunicationStatistics statistics;
+   internal::setStatistics( statistics.edgeCut, edgeCut );
+   internal::setStatistics( statistics.communicationVolume, volume );
+   internal::setStatistics( statistics.neighborProcesses, neighbors );
+   return statistics;
+}
+
+
+
+void BlockForestEvaluation::toStream( std::ostream & os, const CommunicationStatistics & statistics )
+{
+   os << "- communication between processes (neighboring blocks on different processes):"
+      << "\n   + total edge cut (pairs of neighboring blocks on different processes): " << statistics.totalEdgeCut()
+      << "\n   + total communication volume (sum over all blocks of the number of other processes owning neighbors): "
+      << uint_c( statistics.communicationVolume.sum + real_c(0.5) )
+      << "\n   + edge cut per process:";
+   internal::statisticsToStream( os, statistics.edgeCut, "      " );
+   os << "\n   + communication volume per process:";
+   internal::statisticsToStream( os, statistics.communicationVolume, "      " );
+   os << "\n   + neighbor processes per process:";
+   internal::statisticsToStream( os, statistics.neighborProcesses, "      " );
 }
 
 
@@ -95,7 +231,9 @@ void BlockForestEvaluation::toStream( std::ostream & os ) const
             << "\n   + max       = " << blockStatistics_.back().max
             << "\n   + avg       = " << blockStatistics_.back().avg
             << "\n   + stdDev    = " << blockStatistics_.back().stdDev
-            << "\n   + relStdDev = " << blockStatistics_.back().relStdDev;
+            << "\n   + relStdDev = " << blockStatistics_.back().relStdDev
+            << "\n";
+         toStream( os, communicationStatistics_ );
       }
 
       if( forest_.getNumberOfLevels() > uint_t(1) )
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "BlockForest.h"
+#include "SetupBlockForest.h"
 #include "core/logging/Logging.h"
 
 
@@ -44,10 +45,30 @@ public:
       real_t relStdDev;
    };
 
+   /// Locality of the distribution of the blocks to the processes (all values are per process)
+   struct CommunicationStatistics
+   {
+      BlockStatistics edgeCut;             ///< number of pairs of neighboring blocks whose neighbor resides on another process
+      BlockStatistics communicationVolume; ///< for every local block: number of other processes that own neighbors of this block
+      BlockStatistics neighborProcesses;   ///< number of other processes that own neighbors of local blocks (= number of messages)
+
+      /// total number of pairs of neighboring blocks that are assigned to different processes
+      uint_t totalEdgeCut() const { return uint_c( edgeCut.sum + real_c(0.5) ) / uint_t(2); }
+   };
+
    BlockForestEvaluation( const BlockForest & forest );
 
    void toStream( std::ostream & os ) const;
 
+   const CommunicationStatistics & communicationStatistics() const { return communicationStatistics_; }
+
+   /// Evaluates the distribution of the blocks of 'forest' to the target processes (i.e., after
+   /// SetupBlockForest::balanceLoad() was called), which allows to compare different load balancing strategies before
+   /// the simulation is started on the actual number of processes. Must not be called collectively.
+   static CommunicationStatistics communicationStatistics( const SetupBlockForest & forest );
+
+   static void toStream( std::ostream & os, const CommunicationStatistics & statistics );
+
    inline std::string toString() const
    {
       std::ostringstream oss;
@@ -67,6 +88,8 @@ private:
 
    std::vector< BlockStatistics> blockStatistics_;
 
+   CommunicationStatistics communicationStatistics_;
+
 }; // class BlockForestEvaluation
 
 
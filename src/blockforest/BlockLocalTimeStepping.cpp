@@ -0,0 +1,213 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file BlockLocalTimeStepping.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "BlockLocalTimeStepping.h"
+
+#include "core/debug/Debug.h"
+#include "core/mpi/MPIManager.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+
+namespace walberla {
+namespace blockforest {
+
+
+
+BlockLocalTimeStepping::BlockLocalTimeStepping( BlockForest & forest, const BlockFunction & pull, const BlockFunction & compute,
+                                                const CommunicationFunction & communicate, const uint_t numberOfThreads ) :
+   forest_( forest ), pull_( pull ), compute_( compute ), communicate_( communicate ), numberOfThreads_( numberOfThreads ),
+   units_( uint_t(0) ), built_( false ), modificationStamp_( uint_t(0) ), initialCommunication_( true )
+{}
+
+
+
+void BlockLocalTimeStepping::operator()()
+{
+   if( !built_ || modificationStamp_ != forest_.getModificationStamp() )
+      build();
+
+   if( initialCommunication_ )
+   {
+      if( communicationRequired() )
+         for( uint_t level = 0; level <= forest_.getDepth(); ++level )
+            communicate_( level, uint_t(0) );
+      initialCommunication_ = false;
+   }
+
+   graph_.execute( numberOfThreads_ );
+}
+
+
+
+bool BlockLocalTimeStepping::communicationRequired() const
+{
+   return static_cast< bool >( communicate_ ) && MPIManager::instance()->numProcesses() > 1;
+}
+
+
+
+void BlockLocalTimeStepping::build()
+{
+   graph_.clear();
+   units_ = uint_t(0);
+
+   // time is measured in substeps of the finest level: a unit on level L starts at 'substep * length( L )'
+
+   const uint_t depth = forest_.getDepth();
+   auto length = [depth]( const uint_t level ) { return uint_t(1) << ( depth - level ); };
+   auto substeps = []( const uint_t level ) { return uint_t(1) << level; };
+
+   // communication tasks (identical on all processes): communication[L][k] exchanges the states at time k * length( L )
+
+   std::vector< std::vector< TaskGraph::TaskID > > communication( depth + uint_t(1) );
+   if( communicationRequired() )
+   {
+      // order: the state at time k is exchanged right after the units that start at time k-1 are computed
+      std::vector< std::tuple< uint_t, uint_t, uint_t > > order;
+      for( uint_t level = 0; level <= depth; ++level )
+      {
+         communication[ level ].resize( substeps( level ) + uint_t(1) );
+         for( uint_t k = 1; k <= substeps( level ); ++k )
+            order.push_back( std::make_tuple( ( k - uint_t(1) ) * length( level ), level, k ) );
+      }
+      std::sort( order.begin(), order.end() );
+
+      for( auto it = order.begin(); it != order.end(); ++it )
+      {
+         const uint_t level = std::get<1>( *it );
+         const uint_t k = std::get<2>( *it );
+         const TaskGraph::TaskID task = graph_.addTask( [this,level,k]() { communicate_( level, k ); }, true );
+         if( it != order.begin() )
+            graph_.addDependency( task - uint_t(1), task ); // the previous communication task
+         communication[ level ][ k ] = task;
+      }
+   }
+
+   // pull and compute tasks of all local blocks
+
+   struct Units
+   {
+      std::vector< TaskGraph::TaskID > pull;
+      std::vector< TaskGraph::TaskID > compute;
+   };
+   std::map< BlockID, Units > units;
+
+   const auto & blocks = forest_.getBlockMap();
+   for( auto it = blocks.begin(); it != blocks.end(); ++it )
+   {
+      Block * block = it->second.get();
+      const uint_t level = block->getLevel();
+      Units & blockUnits = units[ it->first ];
+      for( uint_t substep = 0; substep != substeps( level ); ++substep )
+      {
+         blockUnits.pull.push_back( graph_.addTask( [this,block,level,substep]() { pull_( block, level, substep ); } ) );
+         blockUnits.compute.push_back( graph_.addTask( [this,block,level,substep]() { compute_( block, level, substep ); } ) );
+         graph_.addDependency( blockUnits.pull.back(), blockUnits.compute.back() );
+         if( substep > uint_t(0) )
+            graph_.addDependency( blockUnits.compute[ substep - uint_t(1) ], blockUnits.pull.back() );
+      }
+      units_ += substeps( level );
+   }
+
+   // dependencies on the neighbor blocks
+
+   for( auto it = blocks.begin(); it != blocks.end(); ++it )
+   {
+      const Block * block = it->second.get();
+      const uint_t level = block->getLevel();
+      const Units & blockUnits = units[ it->first ];
+
+      bool remoteNeighbors( false );
+
+      for( uint_t n = 0; n != block->getNeighborhoodSize(); ++n )
+      {
+         const uint_t neighborLevel = forest_.getLevelFromBlockId( block->getNeighborId( n ) );
+         const uint_t neighborLength = length( neighborLevel );
+
+         if( block->getNeighborProcess( n ) == forest_.getProcess() )
+         {
+            WALBERLA_ASSERT( units.find( block->getNeighborId( n ) ) != units.end() );
+            const Units & neighborUnits = units[ block->getNeighborId( n ) ];
+
+            for( uint_t substep = 0; substep != substeps( level ); ++substep )
+            {
+               const uint_t start = substep * length( level );
+
+               // the last unit of the neighbor that starts before 'start' must be finished
+               if( start > uint_t(0) )
+                  graph_.addDependency( neighborUnits.compute[ ( start - uint_t(1) ) / neighborLength ], blockUnits.pull[ substep ] );
+
+               // the first unit of the neighbor that does not start before 'start' must wait
+               const uint_t next = ( start + neighborLength - uint_t(1) ) / neighborLength;
+               if( next < substeps( neighborLevel ) )
+                  graph_.addDependency( blockUnits.pull[ substep ], neighborUnits.compute[ next ] );
+            }
+         }
+         else if( communicationRequired() )
+         {
+            remoteNeighbors = true;
+
+            for( uint_t substep = 0; substep != substeps( level ); ++substep )
+            {
+               const uint_t start = substep * length( level );
+
+               // the state of the neighbor at the end of the interval that contains 'start' must be received
+               const uint_t received = ( start + neighborLength - uint_t(1) ) / neighborLength;
+               if( received > uint_t(0) )
+                  graph_.addDependency( communication[ neighborLevel ][ received ], blockUnits.pull[ substep ] );
+
+               // the state of the neighbor at the beginning of this interval must not be overwritten
+               const uint_t overwrite = start / neighborLength + uint_t(2);
+               if( overwrite <= substeps( neighborLevel ) )
+                  graph_.addDependency( blockUnits.pull[ substep ], communication[ neighborLevel ][ overwrite ] );
+            }
+         }
+      }
+
+      // the state of the block is sent after it is computed and before it is overwritten
+
+      if( remoteNeighbors )
+      {
+         for( uint_t k = 1; k <= substeps( level ); ++k )
+         {
+            graph_.addDependency( blockUnits.compute[ k - uint_t(1) ], communication[ level ][ k ] );
+            if( k < substeps( level ) )
+               graph_.addDependency( communication[ level ][ k ], blockUnits.compute[ k ] );
+         }
+      }
+   }
+
+   WALBERLA_ASSERT( graph_.isAcyclic() );
+
+   if( built_ && modificationStamp_ != forest_.getModificationStamp() )
+      initialCommunication_ = true;
+
+   built_ = true;
+   modificationStamp_ = forest_.getModificationStamp();
+}
+
+
+
+} // namespace blockforest
+} // namespace walberla
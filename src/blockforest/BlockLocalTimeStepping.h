@@ -0,0 +1,124 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file BlockLocalTimeStepping.h
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "BlockForest.h"
+
+#include "core/DataTypes.h"
+#include "core/NonCopyable.h"
+#include "core/TaskGraph.h"
+
+#include <functional>
+
+
+namespace walberla {
+namespace blockforest {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Level-aware block-local time stepping on non-uniform grids
+*
+*   One call of operator() advances all local blocks by one time step of level 0. Blocks on level L perform 2^L
+*   substeps. Every (block, substep) unit consists of two tasks:
+*    - 'pull': gathers the ghost data of the block from its local neighbors at the start time of the substep (if a
+*              neighbor is coarser, its data must be interpolated in time between the two surrounding states)
+*    - 'compute': advances the block by one substep using only data of the block itself
+*
+*   Instead of a rank-level schedule (all blocks of one level, then communication, then the next level, cf.
+*   lbm::refinement::TimeStep), the units are organized in a task graph (see TaskGraph) with dependencies on the ghost
+*   data of the neighbor blocks only. The graph is executed by a work-stealing thread pool, i.e., coarse and fine
+*   blocks interleave and a process with blocks on different levels stays busy as long as any of its blocks has work.
+*
+*   Let [t0,t1) be the time interval of a unit u of a block b and v a unit of a local neighbor n (or of b itself):
+*    - compute(v) -> pull(u) if v starts before t0 (the neighbor has reached the required state)
+*    - pull(u) -> compute(v) if v does not start before t0 (the state is not overwritten while it is read)
+*
+*   Storage requirements: the compute function must not overwrite the state of the start time of its substep, i.e.,
+*   every block keeps two states and toggles between them (like the source and destination PDF fields of the LBM).
+*   Coarse neighbors provide the states at both ends of the interval that contains t0.
+*
+*   For parallel simulations, the states of blocks that have neighbors on other processes are exchanged by the
+*   communication function communicate( level, k ), which must send the states of all local level-'level' blocks at
+*   time k * 2^-level to the neighbor processes and store the received states of remote level-'level' blocks. These
+*   tasks are only executed by the thread that calls operator() and in the same order on all processes (ordered by
+*   time and level). The received state of time k may overwrite the state of time k-2 only (again, two states are
+*   kept per remote block). Pull functions therefore also read the states of remote neighbors. The states of time
+*   zero are exchanged before the first time step and after every change of the block structure.
+*
+*   The pull and compute functions are called concurrently for different blocks and must be thread-safe in this
+*   respect. The task graph is rebuilt automatically if the block structure changes (BlockForest::refresh()).
+*/
+//**********************************************************************************************************************
+class BlockLocalTimeStepping : public NonCopyable
+{
+public:
+
+   /// signature: ( block, level of the block, substep in [0,2^level) )
+   typedef std::function< void ( Block * block, const uint_t level, const uint_t substep ) > BlockFunction;
+   /// signature: ( level, k in [0,2^level] ): exchange of the states of all level-'level' blocks at time k * 2^-level
+   typedef std::function< void ( const uint_t level, const uint_t k ) > CommunicationFunction;
+
+   BlockLocalTimeStepping( BlockForest & forest, const BlockFunction & pull, const BlockFunction & compute,
+                           const CommunicationFunction & communicate = CommunicationFunction(),
+                           const uint_t numberOfThreads = uint_t(1) );
+
+   void operator()();
+
+   uint_t numberOfThreads() const { return numberOfThreads_; }
+   void setNumberOfThreads( const uint_t threads ) { numberOfThreads_ = threads; }
+
+   /// builds the task graph (only required for inspecting the graph before the first time step)
+   void build();
+
+   const TaskGraph & getTaskGraph() const { return graph_; }
+
+   /// number of local (block, substep) units per time step
+   uint_t numberOfUnits() const { return units_; }
+
+   /// number of tasks that were stolen from the queue of another thread during the last time step
+   uint_t stolenTasks() const { return graph_.stolenTasks(); }
+
+private:
+
+   bool communicationRequired() const;
+
+   BlockForest & forest_;
+
+   BlockFunction pull_;
+   BlockFunction compute_;
+   CommunicationFunction communicate_;
+
+   uint_t numberOfThreads_;
+
+   TaskGraph graph_;
+   uint_t units_;
+
+   bool built_;
+   uint_t modificationStamp_;
+   bool initialCommunication_;
+};
+
+
+
+} // namespace blockforest
+} // namespace walberla
@@ -0,0 +1,520 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file Checkpoint.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "Checkpoint.h"
+
+#include "core/Abort.h"
+#include "core/EndianIndependentSerialization.h"
+#include "core/compression/LosslessCompression.h"
+#include "core/mpi/Broadcast.h"
+#include "core/mpi/Gatherv.h"
+#include "core/mpi/MPIManager.h"
+#include "core/mpi/Reduce.h"
+#include "core/mpi/SendBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+
+namespace walberla {
+namespace blockforest {
+namespace internal {
+
+
+
+static const uint_t CHECKPOINT_MAGIC   = uint_c( 0x54504b4843424c57 ); // "WLBCHKPT"
+static const uint_t CHECKPOINT_VERSION = uint_t(1);
+
+static const uint_t CHECKPOINT_HEADER_ENTRIES = uint_t(8);
+static const uint_t CHECKPOINT_HEADER_SIZE    = CHECKPOINT_HEADER_ENTRIES * uint_t(8);
+
+/// maximal number of bytes that are passed to one MPI-IO call (the count argument is an int)
+static const uint_t CHECKPOINT_MAX_IO_SIZE = uint_t(1) << 30;
+
+
+
+/// Positioned reads and writes, either via MPI-IO (all processes of the communicator open the file) or std::fstream
+class CheckpointFile
+{
+public:
+
+   CheckpointFile( const std::string & file, const bool write ) : file_( file ), mpiFile_( MPI_FILE_NULL )
+   {
+      WALBERLA_NON_MPI_SECTION()
+      {
+         stream_.open( file.c_str(), write ? ( std::fstream::out | std::fstream::binary | std::fstream::trunc ) :
+                                             ( std::fstream::in  | std::fstream::binary ) );
+         if( !stream_ )
+            WALBERLA_ABORT( "Error while opening file \"" << file << "\" for " << ( write ? "writing." : "reading." ) );
+      }
+
+      WALBERLA_MPI_SECTION()
+      {
+         int result = MPI_File_open( mpi::MPIManager::instance()->comm(), const_cast<char*>( file.c_str() ),
+                                     write ? ( MPI_MODE_WRONLY | MPI_MODE_CREATE ) : MPI_MODE_RDONLY, MPI_INFO_NULL, &mpiFile_ );
+         if( result != MPI_SUCCESS )
+            WALBERLA_ABORT( "Error while opening file \"" << file << "\" for " << ( write ? "writing" : "reading" ) <<
+                            ". MPI Error is \"" << mpi::MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+
+         if( write ) // an existing file must be truncated
+         {
+            result = MPI_File_set_size( mpiFile_, MPI_Offset(0) );
+            if( result != MPI_SUCCESS )
+               WALBERLA_ABORT( "Error while truncating file \"" << file << "\". MPI Error is \"" << mpi::MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+         }
+      }
+   }
+
+   ~CheckpointFile()
+   {
+      WALBERLA_NON_MPI_SECTION()
+      {
+         stream_.close();
+      }
+
+      WALBERLA_MPI_SECTION()
+      {
+         int result = MPI_File_close( &mpiFile_ );
+         if( result != MPI_SUCCESS )
+            WALBERLA_ABORT( "Error while closing file \"" << file_ << "\". MPI Error is \"" << mpi::MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+      }
+   }
+
+   void writeAt( const uint_t offset, const uint8_t * data, const uint_t size )
+   {
+      WALBERLA_NON_MPI_SECTION()
+      {
+         stream_.seekp( numeric_cast< std::streamoff >( offset ) );
+         stream_.write( reinterpret_cast< const char * >( data ), numeric_cast< std::streamsize >( size ) );
+         if( !stream_ )
+            WALBERLA_ABORT( "Error while writing to file \"" << file_ << "\"." );
+      }
+
+      WALBERLA_MPI_SECTION()
+      {
+         for( uint_t pos = uint_t(0); pos < size; pos += CHECKPOINT_MAX_IO_SIZE )
+         {
+            const uint_t count = std::min( CHECKPOINT_MAX_IO_SIZE, size - pos );
+            int result = MPI_File_write_at( mpiFile_, numeric_cast< MPI_Offset >( offset + pos ), const_cast< uint8_t * >( data + pos ),
+                                            int_c( count ), MPI_BYTE, MPI_STATUS_IGNORE );
+            if( result != MPI_SUCCESS )
+               WALBERLA_ABORT( "Error while writing to file \"" << file_ << "\". MPI Error is \"" << mpi::MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+         }
+      }
+   }
+
+   void readAt( const uint_t offset, uint8_t * data, const uint_t size )
+   {
+      WALBERLA_NON_MPI_SECTION()
+      {
+         stream_.seekg( numeric_cast< std::streamoff >( offset ) );
+         stream_.read( reinterpret_cast< char * >( data ), numeric_cast< std::streamsize >( size ) );
+         if( !stream_ )
+            WALBERLA_ABORT( "Error while reading from file \"" << file_ << "\"." );
+      }
+
+      WALBERLA_MPI_SECTION()
+      {
+         for( uint_t pos = uint_t(0); pos < size; pos += CHECKPOINT_MAX_IO_SIZE )
+         {
+            const uint_t count = std::min( CHECKPOINT_MAX_IO_SIZE, size - pos );
+            int result = MPI_File_read_at( mpiFile_, numeric_cast< MPI_Offset >( offset + pos ), data + pos,
+                                           int_c( count ), MPI_BYTE, MPI_STATUS_IGNORE );
+            if( result != MPI_SUCCESS )
+               WALBERLA_ABORT( "Error while reading from file \"" << file_ << "\". MPI Error is \"" << mpi::MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+         }
+      }
+   }
+
+private:
+
+   std::string  file_;
+   MPI_File     mpiFile_;
+   std::fstream stream_;
+};
+
+
+
+static bool sortBlocksByID( IBlock * lhs, IBlock * rhs ) { return lhs->getId() < rhs->getId(); }
+
+static std::vector< IBlock * > sortedBlocks( BlockForest & forest )
+{
+   std::vector< IBlock * > blocks;
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+      blocks.push_back( block.get() );
+   std::sort( blocks.begin(), blocks.end(), sortBlocksByID );
+   return blocks;
+}
+
+
+
+} // namespace internal
+
+
+
+std::ostream & operator<<( std::ostream & os, const CheckpointStatistics & statistics )
+{
+   const double MiB = 1024.0 * 1024.0;
+   const std::streamsize precision = os.precision();
+
+   os << "checkpoint statistics:"
+      << "\n- chunks:            " << statistics.chunks
+      << "\n- block data:        " << std::fixed << std::setprecision(2) << ( double_c( statistics.rawBytes ) / MiB ) << " MiB"
+      << "\n- file data:         " << ( double_c( statistics.storedBytes ) / MiB ) << " MiB (compression ratio: " << statistics.compressionRatio() << ")"
+      << "\n- time:              " << std::setprecision(3) << statistics.seconds << " s"
+      << "\n- bandwidth:         " << std::setprecision(2) << ( statistics.bandwidth() / MiB ) << " MiB/s (block data), "
+                                   << ( statistics.fileBandwidth() / MiB ) << " MiB/s (file)";
+   os.unsetf( std::ios_base::floatfield );
+   os.precision( precision );
+   return os;
+}
+
+
+
+namespace internal {
+
+void serializeCheckpointChunks( BlockForest & forest, const std::vector< BlockDataID > & ids, CheckpointSnapshot & snapshot )
+{
+   std::vector< std::string > & identifiers = snapshot.identifiers;
+   identifiers.clear();
+   for( auto id = ids.begin(); id != ids.end(); ++id )
+   {
+      WALBERLA_CHECK_LESS( uint_t(*id), forest.numberOfBlockDataItems() );
+      const std::string & identifier = forest.getBlockDataIdentifier( *id );
+      WALBERLA_CHECK( !identifier.empty(), "Block data items that are stored in a checkpoint must have an identifier!" );
+      WALBERLA_CHECK( std::find( identifiers.begin(), identifiers.end(), identifier ) == identifiers.end(),
+                      "Block data items that are stored in a checkpoint must have unique identifiers! (\"" << identifier << "\" is used twice)" );
+      identifiers.push_back( identifier );
+   }
+
+   std::vector< uint8_t > & data = snapshot.data;
+   data.clear();
+   snapshot.chunks.clear();
+
+   CheckpointStatistics & statistics = snapshot.statistics;
+   statistics = CheckpointStatistics();
+
+   std::vector< IBlock * > blocks = sortedBlocks( forest );
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+   {
+      for( uint_t item = uint_t(0); item != ids.size(); ++item )
+      {
+         mpi::SendBuffer buffer;
+         if( !forest.serializeBlockData( ids[item], *block, buffer ) )
+            continue;
+
+         CheckpointSnapshot::Chunk chunk = { dynamic_cast< Block * >( *block )->getId(), item, uint_c( data.size() ),
+                                             uint_c( buffer.size() ), uint_c( buffer.size() ) };
+         data.insert( data.end(), buffer.ptr(), buffer.ptr() + buffer.size() );
+         snapshot.chunks.push_back( chunk );
+
+         statistics.rawBytes += chunk.rawSize;
+      }
+   }
+   statistics.storedBytes = uint_c( data.size() );
+   statistics.chunks      = uint_c( snapshot.chunks.size() );
+}
+
+
+
+void compressCheckpointChunks( const uint_t elementSize, CheckpointSnapshot & snapshot )
+{
+   std::vector< uint8_t > data;
+   std::vector< uint8_t > compressed;
+   for( auto chunk = snapshot.chunks.begin(); chunk != snapshot.chunks.end(); ++chunk )
+   {
+      compression::compress( snapshot.data.empty() ? nullptr : &(snapshot.data[ chunk->offset ]), chunk->rawSize, elementSize, compressed );
+      chunk->offset     = uint_c( data.size() );
+      chunk->storedSize = uint_c( compressed.size() );
+      data.insert( data.end(), compressed.begin(), compressed.end() );
+   }
+   snapshot.data.swap( data );
+   snapshot.statistics.storedBytes = uint_c( snapshot.data.size() );
+}
+
+
+
+void layoutCheckpointSnapshot( const bool compress, const uint_t elementSize, CheckpointSnapshot & snapshot )
+{
+   CheckpointStatistics & statistics = snapshot.statistics;
+
+   // position of the process local data in the file
+
+   uint_t processOffset = uint_t(0);
+   uint_t totalSize = statistics.storedBytes;
+   WALBERLA_MPI_SECTION()
+   {
+      uint_t localSize = statistics.storedBytes;
+      MPI_Exscan( &localSize, &processOffset, 1, MPITrait< uint_t >::type(), MPI_SUM, mpi::MPIManager::instance()->comm() );
+      if( mpi::MPIManager::instance()->rank() == 0 )
+         processOffset = uint_t(0);
+      mpi::allReduceInplace( totalSize, mpi::SUM );
+   }
+   snapshot.offset = CHECKPOINT_HEADER_SIZE + processOffset;
+
+   // index
+
+   mpi::SendBuffer indexBuffer;
+   WALBERLA_ROOT_SECTION()
+   {
+      indexBuffer << snapshot.identifiers;
+   }
+   for( auto chunk = snapshot.chunks.begin(); chunk != snapshot.chunks.end(); ++chunk )
+      indexBuffer << chunk->block << chunk->item << ( snapshot.offset + chunk->offset ) << chunk->storedSize << chunk->rawSize;
+
+   mpi::RecvBuffer index;
+   mpi::gathervBuffer( indexBuffer, index );
+
+   uint_t numberOfChunks = statistics.chunks;
+   mpi::reduceInplace( numberOfChunks, mpi::SUM );
+
+   snapshot.header.clear();
+   snapshot.index.clear();
+   snapshot.indexOffset = CHECKPOINT_HEADER_SIZE + totalSize;
+
+   WALBERLA_ROOT_SECTION()
+   {
+      snapshot.header.assign( CHECKPOINT_HEADER_SIZE, uint8_t(0) );
+      const uint_t values[] = { CHECKPOINT_MAGIC, CHECKPOINT_VERSION, compress ? uint_t(1) : uint_t(0), elementSize,
+                                numberOfChunks, snapshot.indexOffset, uint_c( index.size() ), uint_t(0) };
+      for( uint_t i = 0; i != CHECKPOINT_HEADER_ENTRIES; ++i )
+         uintToByteArray( values[i], snapshot.header, i * uint_t(8), uint_t(8) );
+
+      snapshot.index.assign( index.ptr(), index.ptr() + index.size() );
+   }
+}
+
+
+
+void reduceCheckpointStatistics( CheckpointStatistics & statistics )
+{
+   mpi::allReduceInplace( statistics.rawBytes,    mpi::SUM );
+   mpi::allReduceInplace( statistics.storedBytes, mpi::SUM );
+   mpi::allReduceInplace( statistics.chunks,      mpi::SUM );
+   mpi::allReduceInplace( statistics.seconds,     mpi::MAX );
+}
+
+} // namespace internal
+
+
+
+CheckpointStatistics saveCheckpoint( BlockForest & forest, const std::string & file, const std::vector< BlockDataID > & ids,
+                                     const bool compress, const uint_t elementSize )
+{
+   WALBERLA_LOG_PROGRESS( "Writing checkpoint \"" << file << "\" ..." );
+
+   WcTimer timer;
+   timer.start();
+
+   internal::CheckpointSnapshot snapshot;
+   internal::serializeCheckpointChunks( forest, ids, snapshot );
+   if( compress )
+      internal::compressCheckpointChunks( elementSize, snapshot );
+   internal::layoutCheckpointSnapshot( compress, elementSize, snapshot );
+
+   {
+      internal::CheckpointFile checkpoint( file, true );
+
+      checkpoint.writeAt( snapshot.offset, snapshot.data.empty() ? nullptr : &(snapshot.data[0]), uint_c( snapshot.data.size() ) );
+
+      WALBERLA_ROOT_SECTION()
+      {
+         checkpoint.writeAt( uint_t(0), &(snapshot.header[0]), uint_c( snapshot.header.size() ) );
+         if( !snapshot.index.empty() )
+            checkpoint.writeAt( snapshot.indexOffset, &(snapshot.index[0]), uint_c( snapshot.index.size() ) );
+      }
+   }
+
+   timer.end();
+
+   CheckpointStatistics statistics = snapshot.statistics;
+   statistics.seconds = timer.last();
+   internal::reduceCheckpointStatistics( statistics );
+
+   WALBERLA_LOG_PROGRESS( "Writing checkpoint \"" << file << "\" finished" );
+
+   return statistics;
+}
+
+
+
+CheckpointReader::CheckpointReader( const std::string & file ) : file_( file ), compressed_( false )
+{
+   WcTimer timer;
+   timer.start();
+
+   std::vector< uint8_t > header( internal::CHECKPOINT_HEADER_SIZE, uint8_t(0) );
+   std::vector< uint8_t > index;
+   {
+      internal::CheckpointFile checkpoint( file, false );
+
+      WALBERLA_ROOT_SECTION()
+      {
+         checkpoint.readAt( uint_t(0), &(header[0]), internal::CHECKPOINT_HEADER_SIZE );
+
+         if( byteArrayToUint( header, uint_t(0), uint_t(8) ) != internal::CHECKPOINT_MAGIC )
+            WALBERLA_ABORT( "File \"" << file << "\" is not a checkpoint file!" );
+         if( byteArrayToUint( header, uint_t(8), uint_t(8) ) != internal::CHECKPOINT_VERSION )
+            WALBERLA_ABORT( "Checkpoint file \"" << file << "\" has an unsupported version (" << byteArrayToUint( header, uint_t(8), uint_t(8) ) << ")!" );
+
+         index.resize( byteArrayToUint( header, uint_t(48), uint_t(8) ) );
+         if( !index.empty() )
+            checkpoint.readAt( byteArrayToUint( header, uint_t(40), uint_t(8) ), &(index[0]), uint_c( index.size() ) );
+      }
+   }
+
+   mpi::broadcastObject( header );
+   mpi::broadcastObject( index );
+
+   compressed_ = ( byteArrayToUint( header, uint_t(16), uint_t(8) ) != uint_t(0) );
+   const uint_t numberOfChunks = byteArrayToUint( header, uint_t(32), uint_t(8) );
+
+   mpi::RecvBuffer buffer;
+   buffer.resize( index.size() );
+   if( !index.empty() )
+      std::memcpy( buffer.ptr(), &(index[0]), index.size() );
+
+   buffer >> identifiers_;
+   while( !buffer.isEmpty() )
+   {
+      BlockID block;
+      uint_t item;
+      Chunk chunk;
+      buffer >> block >> item >> chunk.offset >> chunk.storedSize >> chunk.rawSize;
+      WALBERLA_CHECK_LESS( item, identifiers_.size() );
+      index_[ std::make_pair( block, item ) ] = chunk;
+   }
+   WALBERLA_CHECK_EQUAL( index_.size(), numberOfChunks, "Checkpoint file \"" << file << "\" is corrupt!" );
+
+   timer.end();
+   double seconds = timer.last();
+   mpi::allReduceInplace( seconds, mpi::MAX );
+   statistics_.seconds += seconds;
+}
+
+
+
+bool CheckpointReader::hasBlockData( const std::string & identifier ) const
+{
+   return std::find( identifiers_.begin(), identifiers_.end(), identifier ) != identifiers_.end();
+}
+
+
+
+void CheckpointReader::readChunks( BlockForest & forest, const std::string & identifier, mpi::RecvBuffer & buffer,
+                                   uint_t & rawBytes, uint_t & storedBytes, uint_t & chunks ) const
+{
+   auto itemIt = std::find( identifiers_.begin(), identifiers_.end(), identifier );
+   if( itemIt == identifiers_.end() )
+      WALBERLA_ABORT( "Checkpoint \"" << file_ << "\" does not contain block data \"" << identifier << "\"!" );
+   const uint_t item = uint_c( std::distance( identifiers_.begin(), itemIt ) );
+
+   // chunks of the local blocks in the order in which they are deserialized (see BlockStorage::loadBlockData)
+
+   std::vector< const Chunk * > localChunks;
+   std::vector< IBlock * > blocks = internal::sortedBlocks( forest );
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+   {
+      auto chunk = index_.find( std::make_pair( dynamic_cast< Block * >( *block )->getId(), item ) );
+      if( chunk != index_.end() )
+      {
+         localChunks.push_back( &(chunk->second) );
+         rawBytes    += chunk->second.rawSize;
+         storedBytes += chunk->second.storedSize;
+      }
+   }
+   chunks = uint_c( localChunks.size() );
+
+   std::vector< uint8_t > stored( storedBytes );
+   std::vector< uint8_t > raw;
+   raw.reserve( rawBytes );
+
+   {
+      internal::CheckpointFile checkpoint( file_, false );
+
+      // chunks that are stored consecutively in the file (the typical case if the process distribution did not
+      // change) are read with one call
+
+      uint_t pos = uint_t(0);
+      for( uint_t first = uint_t(0); first < localChunks.size(); )
+      {
+         uint_t last = first;
+         uint_t size = localChunks[first]->storedSize;
+         while( last + uint_t(1) < localChunks.size() && localChunks[last + uint_t(1)]->offset == localChunks[last]->offset + localChunks[last]->storedSize )
+         {
+            ++last;
+            size += localChunks[last]->storedSize;
+         }
+         if( size > uint_t(0) )
+            checkpoint.readAt( localChunks[first]->offset, &(stored[pos]), size );
+         pos += size;
+         first = last + uint_t(1);
+      }
+   }
+
+   std::vector< uint8_t > decompressed;
+   uint_t pos = uint_t(0);
+   for( auto chunk = localChunks.begin(); chunk != localChunks.end(); ++chunk )
+   {
+      if( compressed_ )
+      {
+         compression::decompress( stored.empty() ? nullptr : &(stored[pos]), (*chunk)->storedSize, decompressed );
+         WALBERLA_CHECK_EQUAL( decompressed.size(), (*chunk)->rawSize, "Checkpoint file \"" << file_ << "\" is corrupt!" );
+         raw.insert( raw.end(), decompressed.begin(), decompressed.end() );
+      }
+      else
+      {
+         raw.insert( raw.end(), stored.begin() + numeric_cast< std::ptrdiff_t >( pos ),
+                                stored.begin() + numeric_cast< std::ptrdiff_t >( pos + (*chunk)->storedSize ) );
+      }
+      pos += (*chunk)->storedSize;
+   }
+
+   buffer.resize( raw.size() );
+   if( !raw.empty() )
+      std::memcpy( buffer.ptr(), &(raw[0]), raw.size() );
+}
+
+
+
+void CheckpointReader::addStatistics( const double seconds, const uint_t rawBytes, const uint_t storedBytes, const uint_t chunks )
+{
+   double time = seconds;
+   uint_t raw = rawBytes;
+   uint_t stored = storedBytes;
+   uint_t number = chunks;
+
+   mpi::allReduceInplace( time,   mpi::MAX );
+   mpi::allReduceInplace( raw,    mpi::SUM );
+   mpi::allReduceInplace( stored, mpi::SUM );
+   mpi::allReduceInplace( number, mpi::SUM );
+
+   statistics_.seconds     += time;
+   statistics_.rawBytes    += raw;
+   statistics_.storedBytes += stored;
+   statistics_.chunks      += number;
+}
+
+
+
+} // namespace blockforest
+} // namespace walberla
@@ -0,0 +1,253 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file Checkpoint.h
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "BlockForest.h"
+#include "StructuredBlockForest.h"
+
+#include "core/DataTypes.h"
+#include "core/logging/Logging.h"
+#include "core/mpi/RecvBuffer.h"
+#include "core/timing/Timer.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace walberla {
+namespace blockforest {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \file Checkpoint.h
+*   \brief Chunked checkpoint files for block data
+*
+*   In contrast to BlockForest::saveBlockData (one monolithic buffer per process, the file can only be read by the
+*   same process distribution), a checkpoint file stores every block data item of every block as an individual chunk
+*   that can optionally be compressed (see compression::compress). An index at the end of the file maps (block ID,
+*   block data identifier) to the position of the chunk in the file. Hence, every process can read the data of
+*   arbitrary blocks, which allows to restart a simulation on a different number of processes: create the block
+*   forest for the new number of processes (e.g., by balancing the SetupBlockForest again) and load the block data
+*   from the checkpoint. Every process only reads the chunks of its own blocks.
+*
+*   File format (all header values are stored as 8 byte unsigned integers in little-endian byte order):
+*
+*   BYTES            | DESCRIPTION
+*   -----------------|-----------------
+*   64               | header: magic number, version, compression flag, element size, number of chunks, offset and
+*                    | size of the index
+*   ...              | chunks, the chunks of one process are stored contiguously
+*   ...              | index: identifiers of the block data items, followed by (block ID, item, offset, stored size,
+*                    | raw size) for every chunk
+*
+*   \code
+*   // writing
+*   auto stats = blockforest::saveCheckpoint( forest->getBlockForest(), "checkpoint.dat", { pdfFieldId, flagFieldId } );
+*   WALBERLA_LOG_INFO_ON_ROOT( stats );
+*
+*   // reading (possibly on a different number of processes)
+*   blockforest::CheckpointReader checkpoint( "checkpoint.dat" );
+*   BlockDataID pdfFieldId = checkpoint.loadBlockData( *forest, "pdf field", pdfFieldDataHandling );
+*   WALBERLA_LOG_INFO_ON_ROOT( checkpoint.statistics() );
+*   \endcode
+*/
+//**********************************************************************************************************************
+
+
+
+/// Data volume and timing of writing / reading a checkpoint (global values, identical on all processes)
+struct CheckpointStatistics
+{
+   CheckpointStatistics() : rawBytes( uint_t(0) ), storedBytes( uint_t(0) ), chunks( uint_t(0) ), seconds( 0.0 ) {}
+
+   uint_t rawBytes;    ///< size of the serialized block data (summed over all processes)
+   uint_t storedBytes; ///< size of the block data chunks in the file (summed over all processes)
+   uint_t chunks;      ///< number of chunks written / read (summed over all processes)
+   double seconds;     ///< wall clock time (maximum over all processes)
+
+   /// bandwidth with respect to the serialized (uncompressed) block data in bytes per second
+   double bandwidth() const { return seconds > 0.0 ? double_c( rawBytes ) / seconds : 0.0; }
+   /// bandwidth with respect to the data that is actually written to / read from the file in bytes per second
+   double fileBandwidth() const { return seconds > 0.0 ? double_c( storedBytes ) / seconds : 0.0; }
+
+   double compressionRatio() const { return storedBytes > uint_t(0) ? double_c( rawBytes ) / double_c( storedBytes ) : 1.0; }
+};
+
+std::ostream & operator<<( std::ostream & os, const CheckpointStatistics & statistics );
+
+
+
+namespace internal {
+
+/// Serialized (and possibly compressed) checkpoint data of one process together with its position in the file
+struct CheckpointSnapshot
+{
+   struct Chunk
+   {
+      BlockID block;
+      uint_t  item;       ///< index of the block data item in 'identifiers'
+      uint_t  offset;     ///< position of the chunk in 'data'
+      uint_t  storedSize;
+      uint_t  rawSize;
+   };
+
+   std::vector< std::string > identifiers; ///< identifiers of the block data items
+   std::vector< Chunk >       chunks;      ///< chunks of all local blocks
+   std::vector< uint8_t >     data;        ///< chunks of all local blocks
+   uint_t                     offset;      ///< position of 'data' in the file
+   std::vector< uint8_t >     header;      ///< only set on the root process
+   std::vector< uint8_t >     index;       ///< only set on the root process
+   uint_t                     indexOffset; ///< position of 'index' in the file
+   CheckpointStatistics       statistics;  ///< process local data volume
+};
+
+/// serializes the block data of all local blocks without compressing it (process local)
+void serializeCheckpointChunks( BlockForest & forest, const std::vector< BlockDataID > & ids, CheckpointSnapshot & snapshot );
+
+/// compresses all chunks of the snapshot (process local, no MPI calls, hence it can be executed by any thread)
+void compressCheckpointChunks( const uint_t elementSize, CheckpointSnapshot & snapshot );
+
+/// determines the position of the chunks in the file and assembles header and index, must be called by all processes
+void layoutCheckpointSnapshot( const bool compress, const uint_t elementSize, CheckpointSnapshot & snapshot );
+
+/// turns process local statistics into global statistics, must be called by all processes
+void reduceCheckpointStatistics( CheckpointStatistics & statistics );
+
+} // namespace internal
+
+
+
+//**********************************************************************************************************************
+/*!
+*   Writes the block data items 'ids' of all local blocks to the checkpoint file 'file' (must be called by all
+*   processes). Every item must have a unique, non-empty identifier, the identifiers are used to find the data when
+*   the checkpoint is read. If 'compress' is true, the data of every chunk is compressed with compression::compress,
+*   'elementSize' is the size of the values that dominate the serialized data (e.g., sizeof(real_t) for fields).
+*/
+//**********************************************************************************************************************
+CheckpointStatistics saveCheckpoint( BlockForest & forest, const std::string & file, const std::vector< BlockDataID > & ids,
+                                     const bool compress = true, const uint_t elementSize = sizeof(real_t) );
+
+inline CheckpointStatistics saveCheckpoint( StructuredBlockForest & forest, const std::string & file, const std::vector< BlockDataID > & ids,
+                                            const bool compress = true, const uint_t elementSize = sizeof(real_t) )
+{
+   return saveCheckpoint( forest.getBlockForest(), file, ids, compress, elementSize );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   Reads a checkpoint file that was written by saveCheckpoint
+*
+*   The header and the index are read by the root process and broadcast to all processes during construction.
+*   loadBlockData must be called by all processes, it adds a new block data item to the block forest and initializes
+*   the item by deserializing the chunks that are stored in the checkpoint for the local blocks. The block forest
+*   does not need to have the same process distribution as the block forest that was used for writing the checkpoint,
+*   only the blocks must be the same. Blocks without a chunk (i.e., blocks that had no data for the item when the
+*   checkpoint was written, e.g., due to selectors) must not be selected by the data handling either.
+*/
+//**********************************************************************************************************************
+class CheckpointReader
+{
+public:
+
+   CheckpointReader( const std::string & file );
+
+   const std::string & file() const { return file_; }
+   bool compressed() const { return compressed_; }
+
+   const std::vector< std::string > & identifiers() const { return identifiers_; }
+   bool hasBlockData( const std::string & identifier ) const;
+
+   template< typename T >
+   BlockDataID loadBlockData( BlockForest & forest, const std::string & identifier, const shared_ptr< T > & dataHandling,
+                              const Set<SUID> & requiredSelectors     = Set<SUID>::emptySet(),
+                              const Set<SUID> & incompatibleSelectors = Set<SUID>::emptySet() );
+
+   template< typename T >
+   BlockDataID loadBlockData( StructuredBlockForest & forest, const std::string & identifier, const shared_ptr< T > & dataHandling,
+                              const Set<SUID> & requiredSelectors     = Set<SUID>::emptySet(),
+                              const Set<SUID> & incompatibleSelectors = Set<SUID>::emptySet() )
+   { return loadBlockData( forest.getBlockForest(), identifier, dataHandling, requiredSelectors, incompatibleSelectors ); }
+
+   /// accumulated statistics of all calls of loadBlockData (including the time for reading the index)
+   const CheckpointStatistics & statistics() const { return statistics_; }
+
+private:
+
+   struct Chunk
+   {
+      uint_t offset;
+      uint_t storedSize;
+      uint_t rawSize;
+   };
+
+   void readChunks( BlockForest & forest, const std::string & identifier, mpi::RecvBuffer & buffer, uint_t & rawBytes, uint_t & storedBytes, uint_t & chunks ) const;
+   void addStatistics( const double seconds, const uint_t rawBytes, const uint_t storedBytes, const uint_t chunks );
+
+   std::string file_;
+   bool compressed_;
+
+   std::vector< std::string > identifiers_;
+   std::map< std::pair< BlockID, uint_t >, Chunk > index_; // (block ID, index of the identifier) -> chunk
+
+   CheckpointStatistics statistics_;
+
+}; // class CheckpointReader
+
+
+
+template< typename T >
+BlockDataID CheckpointReader::loadBlockData( BlockForest & forest, const std::string & identifier, const shared_ptr< T > & dataHandling,
+                                             const Set<SUID> & requiredSelectors, const Set<SUID> & incompatibleSelectors )
+{
+   WALBERLA_LOG_PROGRESS( "Adding block data (\"" << identifier << "\"), loading data from checkpoint \"" << file_ << "\" ..." );
+
+   WcTimer timer;
+   timer.start();
+
+   uint_t rawBytes( uint_t(0) );
+   uint_t storedBytes( uint_t(0) );
+   uint_t chunks( uint_t(0) );
+
+   mpi::RecvBuffer buffer;
+   readChunks( forest, identifier, buffer, rawBytes, storedBytes, chunks );
+
+   BlockDataID id = forest.loadBlockData( buffer, dataHandling, identifier, requiredSelectors, incompatibleSelectors );
+   WALBERLA_CHECK( buffer.isEmpty(), "Loading block data \"" << identifier << "\" from checkpoint \"" << file_ << "\" did not "
+                                     "consume all data. Are the data handling and the selectors the same as when the checkpoint was written?" );
+
+   timer.end();
+   addStatistics( timer.last(), rawBytes, storedBytes, chunks );
+
+   return id;
+}
+
+
+
+} // namespace blockforest
+} // namespace walberla
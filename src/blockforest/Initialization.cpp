@@ -19,6 +19,7 @@
 //
 //======================================================================================================================
 
+#include "AABBRefinementSelection.h"
 #include "BlockNeighborhoodSection.h"
 #include "Initialization.h"
 #include "SetupBlockForest.h"
@@ -31,6 +32,7 @@
 
 #include "stencil/D3Q19.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 
@@ -622,6 +624,279 @@ createUniformBlockGrid( const std::string& filename,
 
 
 
+///////////////////////////////////////////
+// DISTRIBUTED INITIALIZATION            //
+///////////////////////////////////////////
+
+
+
+namespace internal {
+
+//**********************************************************************************************************************
+/*!
+*   Morton order (Z-order) of the root blocks of a grid of arbitrary size: The grid is embedded into the smallest cube
+*   with an edge length that is a power of two, positions outside of the grid are skipped. The position of any root
+*   block along the curve and the root blocks within any range of the curve are computed by descending the octree of
+*   this cube, the number of root blocks inside an octant is just the size of its intersection with the grid. Hence,
+*   neither memory nor time proportional to the total number of root blocks is required.
+*/
+//**********************************************************************************************************************
+class RootBlockMortonOrder
+{
+public:
+
+   RootBlockMortonOrder( const uint_t xSize, const uint_t ySize, const uint_t zSize ) : edge_( uint_t(1) )
+   {
+      size_[0] = xSize;
+      size_[1] = ySize;
+      size_[2] = zSize;
+      while( edge_ < xSize || edge_ < ySize || edge_ < zSize )
+         edge_ <<= 1;
+   }
+
+   uint_t numberOfBlocks() const { return size_[0] * size_[1] * size_[2]; }
+
+   /// position of the root block (x,y,z) along the curve
+   uint_t position( const uint_t x, const uint_t y, const uint_t z ) const
+   {
+      const uint_t target[] = { x, y, z };
+      uint_t corner[] = { uint_t(0), uint_t(0), uint_t(0) };
+      uint_t position( uint_t(0) );
+
+      for( uint_t edge = edge_ >> 1; edge != uint_t(0); edge >>= 1 )
+      {
+         uint_t branch( uint_t(0) );
+         for( uint_t d = 0; d != 3; ++d )
+            if( target[d] >= corner[d] + edge )
+               branch |= ( uint_t(1) << d );
+
+         for( uint_t c = 0; c != branch; ++c )
+            position += blocks( corner, c, edge );
+
+         for( uint_t d = 0; d != 3; ++d )
+            if( branch & ( uint_t(1) << d ) )
+               corner[d] += edge;
+      }
+
+      return position;
+   }
+
+   /// tree indices of all root blocks at the positions [begin,end) of the curve (in curve order)
+   void treeIndices( const uint_t begin, const uint_t end, std::vector< uint_t > & indices ) const
+   {
+      const uint_t corner[] = { uint_t(0), uint_t(0), uint_t(0) };
+      uint_t position( uint_t(0) );
+      treeIndices( corner, edge_, begin, end, position, indices );
+   }
+
+private:
+
+   /// number of root blocks within child 'branch' of the octant with minimal corner 'corner' (edge length = 2 * 'edge')
+   uint_t blocks( const uint_t * const corner, const uint_t branch, const uint_t edge ) const
+   {
+      uint_t child[3];
+      for( uint_t d = 0; d != 3; ++d )
+         child[d] = ( branch & ( uint_t(1) << d ) ) ? ( corner[d] + edge ) : corner[d];
+      return blocks( child, edge );
+   }
+
+   /// number of root blocks within the octant with minimal corner 'corner' and edge length 'edge'
+   uint_t blocks( const uint_t * const corner, const uint_t edge ) const
+   {
+      uint_t count( uint_t(1) );
+      for( uint_t d = 0; d != 3; ++d )
+         count *= ( corner[d] < size_[d] ) ? ( std::min( corner[d] + edge, size_[d] ) - corner[d] ) : uint_t(0);
+      return count;
+   }
+
+   void treeIndices( const uint_t * const corner, const uint_t edge, const uint_t begin, const uint_t end,
+                     uint_t & position, std::vector< uint_t > & indices ) const
+   {
+      const uint_t count = blocks( corner, edge );
+
+      if( count == uint_t(0) || position >= end )
+         return;
+
+      if( position + count <= begin )
+      {
+         position += count;
+         return;
+      }
+
+      if( edge == uint_t(1) )
+      {
+         indices.push_back( corner[2] * size_[1] * size_[0] + corner[1] * size_[0] + corner[0] );
+         ++position;
+         return;
+      }
+
+      const uint_t half = edge >> 1;
+      for( uint_t c = 0; c != 8; ++c )
+      {
+         uint_t child[3];
+         for( uint_t d = 0; d != 3; ++d )
+            child[d] = ( c & ( uint_t(1) << d ) ) ? ( corner[d] + half ) : corner[d];
+         treeIndices( child, half, begin, end, position, indices );
+      }
+   }
+
+   uint_t size_[3];
+   uint_t edge_;
+};
+
+/// first position along the curve that is assigned to 'process' (contiguous pieces of equal size, +/- one block)
+inline uint_t firstCurvePosition( const uint_t process, const uint_t numberOfProcesses, const uint_t numberOfBlocks )
+{
+   return uint_c( ( uint64_c( process ) * uint64_c( numberOfBlocks ) ) / uint64_c( numberOfProcesses ) );
+}
+
+/// process that is assigned the root block at position 'position' along the curve (inverse of firstCurvePosition)
+inline uint_t curvePositionToProcess( const uint_t position, const uint_t numberOfProcesses, const uint_t numberOfBlocks )
+{
+   return uint_c( ( ( uint64_c( position ) + uint64_c(1) ) * uint64_c( numberOfProcesses ) - uint64_c(1) ) / uint64_c( numberOfBlocks ) );
+}
+
+} // namespace internal
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Function for creating a block forest without ever constructing the global block structure
+*
+*   In contrast to createBlockForest(), no SetupBlockForest is created, i.e., no process ever stores all blocks. Every
+*   process only generates its own root blocks: The root blocks are ordered along a Morton space filling curve and the
+*   curve is split into as many contiguous pieces of (almost) equal size as there are MPI processes. The processes of
+*   the neighbor blocks are determined by the same arithmetic, which is why no communication is required at all.
+*   Memory and time required for the initialization are therefore proportional to the number of local blocks, which
+*   makes this function suitable for very large numbers of processes. Global block information is not available.
+*
+*   If there are fewer root blocks than processes, some processes do not own a block. These processes can receive
+*   blocks during a later refinement, see refineBlockForestDistributed().
+*
+*   \param domainAABB                 An axis-aligned bounding box that spans the entire simulation space/domain
+*   \param numberOfXBlocks            Number of root blocks in x direction
+*   \param numberOfYBlocks            Number of root blocks in y direction
+*   \param numberOfZBlocks            Number of root blocks in z direction
+*   \param xPeriodic                  If true, the block structure is periodic in x direction [false by default]
+*   \param yPeriodic                  If true, the block structure is periodic in y direction [false by default]
+*   \param zPeriodic                  If true, the block structure is periodic in z direction [false by default]
+*/
+//**********************************************************************************************************************
+
+shared_ptr< BlockForest >
+createBlockForestDistributed( const AABB& domainAABB,
+                              const uint_t numberOfXBlocks,         const uint_t numberOfYBlocks,         const uint_t numberOfZBlocks,
+                              const bool   xPeriodic /* = false */, const bool   yPeriodic /* = false */, const bool   zPeriodic /* = false */ )
+{
+   if( numberOfXBlocks == uint_t(0) || numberOfYBlocks == uint_t(0) || numberOfZBlocks == uint_t(0) )
+      WALBERLA_ABORT( "Distributed initialization of the block forest failed: The number of blocks in each direction must be greater "
+                      "than zero (" << numberOfXBlocks << " x " << numberOfYBlocks << " x " << numberOfZBlocks << " blocks requested)!" );
+
+   const uint_t process = uint_c( MPIManager::instance()->rank() );
+   const uint_t numberOfProcesses = uint_c( MPIManager::instance()->numProcesses() );
+
+   const internal::RootBlockMortonOrder curve( numberOfXBlocks, numberOfYBlocks, numberOfZBlocks );
+   const uint_t numberOfBlocks = curve.numberOfBlocks();
+
+   std::vector< uint_t > rootBlocks;
+   curve.treeIndices( internal::firstCurvePosition( process, numberOfProcesses, numberOfBlocks ),
+                      internal::firstCurvePosition( process + uint_t(1), numberOfProcesses, numberOfBlocks ), rootBlocks );
+
+   auto rootBlockProcess = [&]( const uint_t treeIndex )
+   {
+      uint_t x,y,z;
+      SetupBlockForest::mapTreeIndexToForestCoordinates( treeIndex, numberOfXBlocks, numberOfYBlocks, x, y, z );
+      return internal::curvePositionToProcess( curve.position( x, y, z ), numberOfProcesses, numberOfBlocks );
+   };
+
+   return std::make_shared< BlockForest >( process, domainAABB, numberOfXBlocks, numberOfYBlocks, numberOfZBlocks,
+                                           xPeriodic, yPeriodic, zPeriodic, numberOfProcesses, rootBlocks, rootBlockProcess );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Function for creating a structured block forest that represents a uniform block grid without ever
+*          constructing the global block structure
+*
+*   For the distribution of the blocks to the processes, see createBlockForestDistributed().
+*
+*   \param domainAABB                 An axis-aligned bounding box that spans the entire simulation space/domain
+*   \param numberOfXBlocks            Number of blocks in x direction
+*   \param numberOfYBlocks            Number of blocks in y direction
+*   \param numberOfZBlocks            Number of blocks in z direction
+*   \param numberOfXCellsPerBlock     Number of cells of each block in x direction
+*   \param numberOfYCellsPerBlock     Number of cells of each block in y direction
+*   \param numberOfZCellsPerBlock     Number of cells of each block in z direction
+*   \param xPeriodic                  If true, the block structure is periodic in x direction [false by default]
+*   \param yPeriodic                  If true, the block structure is periodic in y direction [false by default]
+*   \param zPeriodic                  If true, the block structure is periodic in z direction [false by default]
+*/
+//**********************************************************************************************************************
+
+shared_ptr< StructuredBlockForest >
+createUniformBlockGridDistributed( const AABB& domainAABB,
+                                   const uint_t numberOfXBlocks,         const uint_t numberOfYBlocks,         const uint_t numberOfZBlocks,
+                                   const uint_t numberOfXCellsPerBlock,  const uint_t numberOfYCellsPerBlock,  const uint_t numberOfZCellsPerBlock,
+                                   const bool   xPeriodic /* = false */, const bool   yPeriodic /* = false */, const bool   zPeriodic /* = false */ )
+{
+   auto bf = createBlockForestDistributed( domainAABB, numberOfXBlocks, numberOfYBlocks, numberOfZBlocks, xPeriodic, yPeriodic, zPeriodic );
+
+   auto sbf = std::make_shared< StructuredBlockForest >( bf, numberOfXCellsPerBlock, numberOfYCellsPerBlock, numberOfZCellsPerBlock );
+   sbf->createCellBoundingBoxes();
+
+   return sbf;
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Static refinement of an already distributed block forest
+*
+*   Replaces the refinement callbacks of SetupBlockForest (e.g., AABBRefinementSelection) for block forests that were
+*   created with createBlockForestDistributed(). The refinement is performed by the regular dynamic refinement pipeline
+*   of BlockForest::refresh(): 'minTargetLevelDetermination' is called for the local blocks only, the 2:1 balance is
+*   established with a sparse exchange between neighbor processes, and blocks are refined as many times as requested
+*   (multiple refresh cycles). If a load balancing function is registered at the block forest (see
+*   BlockForest::setRefreshPhantomBlockMigrationPreparationFunction), the refined blocks are redistributed, e.g.,
+*   DynamicDiffusionBalance keeps the whole initialization free of global information.
+*   Any min target level determination function that was registered at the block forest is restored afterwards.
+*/
+//**********************************************************************************************************************
+
+void refineBlockForestDistributed( BlockForest & forest,
+                                   const BlockForest::RefreshMinTargetLevelDeterminationFunction & minTargetLevelDetermination )
+{
+   const auto registeredFunction = forest.getRefreshMinTargetLevelDeterminationFunction();
+   const bool recalculateBlockLevels = forest.recalculateBlockLevelsInRefresh();
+   const bool allowMultipleRefreshCycles = forest.allowMultipleRefreshCycles();
+
+   forest.setRefreshMinTargetLevelDeterminationFunction( minTargetLevelDetermination );
+   forest.recalculateBlockLevelsInRefresh( true );
+   forest.allowMultipleRefreshCycles( true );
+
+   forest.refresh();
+
+   forest.setRefreshMinTargetLevelDeterminationFunction( registeredFunction );
+   forest.recalculateBlockLevelsInRefresh( recalculateBlockLevels );
+   forest.allowMultipleRefreshCycles( allowMultipleRefreshCycles );
+}
+
+/// Distributed counterpart of the static refinement of a SetupBlockForest with an AABBRefinementSelection, results in
+/// the same block structure
+void refineBlockForestDistributed( BlockForest & forest, const AABBRefinementSelection & refinementSelection )
+{
+   refineBlockForestDistributed( forest, [&refinementSelection]( std::vector< std::pair< const Block *, uint_t > > & minTargetLevels,
+                                                                 std::vector< const Block * > & blocksAlreadyMarkedForRefinement,
+                                                                 const BlockForest & blockForest )
+                                 { refinementSelection.staticRefinement( minTargetLevels, blocksAlreadyMarkedForRefinement, blockForest ); } );
+}
+
+
+
 ///////////////////////////////////////////
 // HELPER FUNCTIONS                      //
 ///////////////////////////////////////////
@@ -110,6 +110,24 @@ createUniformBlockGrid( const std::string& filename,
 
 
 
+class AABBRefinementSelection;
+
+shared_ptr< BlockForest >
+createBlockForestDistributed( const AABB& domainAABB,
+                              const uint_t numberOfXBlocks,   const uint_t numberOfYBlocks,   const uint_t numberOfZBlocks,
+                              const bool   xPeriodic = false, const bool   yPeriodic = false, const bool   zPeriodic = false );
+
+shared_ptr< StructuredBlockForest >
+createUniformBlockGridDistributed( const AABB& domainAABB,
+                                   const uint_t numberOfXBlocks,        const uint_t numberOfYBlocks,        const uint_t numberOfZBlocks,
+                                   const uint_t numberOfXCellsPerBlock, const uint_t numberOfYCellsPerBlock, const uint_t numberOfZCellsPerBlock,
+                                   const bool   xPeriodic = false,      const bool   yPeriodic = false,      const bool   zPeriodic = false );
+
+void refineBlockForestDistributed( BlockForest & forest,
+                                   const BlockForest::RefreshMinTargetLevelDeterminationFunction & minTargetLevelDetermination );
+void refineBlockForestDistributed( BlockForest & forest, const AABBRefinementSelection & refinementSelection );
+
+
 
 void calculateCellDistribution( const Vector3<uint_t> & cells, uint_t nrOfBlocks,
                                 Vector3<uint_t> & blocksOut, Vector3<uint_t> & cellsPerBlock);
@@ -28,9 +28,12 @@
 #include "BlockForest.h"
 #include "BlockForestEvaluation.h"
 #include "BlockID.h"
+#include "BlockLocalTimeStepping.h"
 #include "BlockNeighborhoodConstruction.h"
 #include "BlockNeighborhoodSection.h"
 #include "BlockReconstruction.h"
+#include "AsyncCheckpointWriter.h"
+#include "Checkpoint.h"
 #include "HilbertCurveConstruction.h"
 #include "Initialization.h"
 #include "PhantomBlock.h"
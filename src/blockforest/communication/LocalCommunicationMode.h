@@ -25,7 +25,11 @@ namespace walberla {
 namespace blockforest {
 
 
-enum LocalCommunicationMode { START = 0, WAIT = 1, BUFFER = 2 };
+/// START/WAIT: local communication is executed in startCommunication()/wait()
+/// BUFFER:     local data is packed in startCommunication() and unpacked in wait()
+/// SWEEP:      local communication is executed block by block via a sweep (only UniformBufferedScheme, see
+///             UniformBufferedScheme::getLocalCommunicationSweep())
+enum LocalCommunicationMode { START = 0, WAIT = 1, BUFFER = 2, SWEEP = 3 };
 
 
 } // namespace blockforest
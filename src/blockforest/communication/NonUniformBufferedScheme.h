@@ -365,6 +365,8 @@ inline void NonUniformBufferedScheme<Stencil>::communicateFineToCoarse( const ui
 template< typename Stencil >
 inline void NonUniformBufferedScheme<Stencil>::setLocalMode( const LocalCommunicationMode & mode )
 {
+   WALBERLA_CHECK_UNEQUAL( mode, SWEEP, "Local communication mode SWEEP is not supported by the NonUniformBufferedScheme" );
+
    if( mode != localMode_ )
    {
       localMode_ = mode;
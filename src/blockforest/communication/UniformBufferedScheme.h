@@ -75,6 +75,11 @@ namespace communication {
 *
 * When running multiple Schemes concurrently different MPI tags have to be used
 * for the schemes: the tag can be passed in the constructor.
+*
+* In local communication mode SWEEP, the ghost layers of blocks with neighbors on the same process are not filled in
+* startCommunication()/wait(). Instead, the function returned by getLocalCommunicationSweep() must be executed for
+* every block between startCommunication() and wait(). This allows the local copies to be executed by the thread
+* that owns the block (see timeloop::ThreadTeamTimeloop).
 */
 //*******************************************************************************************************************
 template< typename Stencil >
@@ -152,6 +157,11 @@ public:
    LocalCommunicationMode localMode() const { return localMode_; }
    inline void setLocalMode( const LocalCommunicationMode & mode );
 
+   /// If enabled, persistent MPI requests are used for the exchange with other processes as long as the block
+   /// structure does not change and all pack infos exchange data of constant size (see mpi::BufferSystem).
+   void usePersistentRequests( const bool use ) { WALBERLA_ASSERT( !communicationInProgress_ ); bufferSystem_.usePersistentRequests( use ); }
+   bool arePersistentRequestsUsed() const { return bufferSystem_.arePersistentRequestsUsed(); }
+
 
    //** Asynchronous Communication *************************************************************************************
    /*! \name Asynchronous Communication */
@@ -161,6 +171,11 @@ public:
 
    std::function<void()> getStartCommunicateFunctor();
    std::function<void()> getWaitFunctor();
+
+   /// Fills the ghost layers of 'block' from its neighbors on the same process (local communication mode SWEEP
+   /// only). Must be called between startCommunication() and wait(), can be called concurrently for different blocks.
+   void communicateLocal( IBlock * block );
+   std::function<void( IBlock * )> getLocalCommunicationSweep();
    //@}
    //*******************************************************************************************************************
 
@@ -194,6 +209,8 @@ protected:
 
    std::vector< SendBuffer > localBuffers_;
 
+   std::map< const IBlock *, std::vector< VoidFunction > > blockLocalCommunication_; // receiving block -> functions (mode SWEEP)
+
    bool setupBeforeNextCommunication_;
    bool communicationInProgress_;
 
@@ -281,6 +298,8 @@ void UniformBufferedScheme<Stencil>::startCommunication()
 
       localBuffers_.clear();
 
+      blockLocalCommunication_.clear();
+
       std::map< uint_t, std::vector< SendBufferFunction > > sendFunctions;
 
       for( auto it = forest->begin(); it != forest->end(); ++it )
@@ -332,6 +351,21 @@ void UniformBufferedScheme<Stencil>::startCommunication()
                      else
                         localCommunicationUnpack_.push_back( unpack );
                   }
+                  else if( localMode_ == SWEEP )
+                  {
+                     VoidFunction localCommunicationFunction = std::bind( &walberla::communication::UniformPackInfo::communicateLocal,
+                                                                            *packInfo, block, neighbor, *dir );
+                     if( !(*packInfo)->threadsafeReceiving() )
+                     {
+                        localCommunicationFunction = [localCommunicationFunction]() {
+#ifdef _OPENMP
+                           #pragma omp critical (UniformBufferedScheme_communicateLocal)
+#endif
+                           localCommunicationFunction();
+                        };
+                     }
+                     blockLocalCommunication_[ neighbor ].push_back( localCommunicationFunction );
+                  }
                   else
                   {
                      VoidFunction localCommunicationFunction = std::bind( &walberla::communication::UniformPackInfo::communicateLocal,
@@ -546,6 +580,26 @@ std::function<void()> UniformBufferedScheme<Stencil>::getWaitFunctor()
    return std::bind( &UniformBufferedScheme::wait, this );
 }
 
+template< typename Stencil >
+void UniformBufferedScheme<Stencil>::communicateLocal( IBlock * block )
+{
+   WALBERLA_ASSERT_EQUAL( localMode_, SWEEP );
+   WALBERLA_ASSERT( packInfos_.empty() || communicationInProgress_ );
+
+   auto functions = blockLocalCommunication_.find( block );
+   if( functions == blockLocalCommunication_.end() )
+      return;
+
+   for( auto function = functions->second.begin(); function != functions->second.end(); ++function )
+      (*function)();
+}
+
+template< typename Stencil >
+std::function<void( IBlock * )> UniformBufferedScheme<Stencil>::getLocalCommunicationSweep()
+{
+   return std::bind( &UniformBufferedScheme::communicateLocal, this, std::placeholders::_1 );
+}
+
 
 } // namespace communication
 } // namespace blockforest
@@ -0,0 +1,209 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file UniformHybridScheme.h
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "blockforest/StructuredBlockForest.h"
+#include "core/Set.h"
+#include "core/WeakPtrWrapper.h"
+#include "core/mpi/Datatype.h"
+#include "core/mpi/MPIManager.h"
+#include "core/mpi/MPIWrapper.h"
+#include "core/uid/SUID.h"
+
+#include <vector>
+#include <functional>
+
+#include "communication/UniformMPIDatatypeInfo.h"
+
+namespace walberla {
+namespace blockforest {
+namespace communication {
+
+//*******************************************************************************************************************
+/*! Communication of multiple block data items using MPI datatypes ( no intermediate buffers )
+*
+* In contrast to the UniformDirectScheme,
+*  - all data items that are registered at the scheme are combined into one MPI struct datatype per pair of
+*    neighboring blocks, i.e., only one message is exchanged per block pair and direction, regardless of the number
+*    of registered data items (e.g., PDF field + flag field + force field)
+*  - neighboring blocks that are located on the same process are not communicated via MPI, instead the data is
+*    copied directly by UniformMPIDatatypeInfo::communicateLocal (during startCommunication())
+*
+* The struct datatypes depend on the memory addresses of the registered data. They are rebuilt if an address changes
+* (e.g., when the data pointers of two fields are swapped). The two most recently used struct datatypes are kept per
+* message, so that alternating between two fields does not trigger a rebuild in every step.
+*/
+//*******************************************************************************************************************
+template< typename Stencil >
+class UniformHybridScheme
+{
+public:
+
+   typedef walberla::communication::UniformMPIDatatypeInfo UniformMPIDatatypeInfo;
+   typedef walberla::communication::UniformMPIDatatypeInfo CommunicationItemInfo;
+
+   //**Construction & Destruction***************************************************************************************
+   /*! \name Construction & Destruction */
+   //@{
+   explicit UniformHybridScheme( const weak_ptr_wrapper<StructuredBlockForest> & bf,
+                                 const shared_ptr<UniformMPIDatatypeInfo> & dataInfo = shared_ptr<UniformMPIDatatypeInfo>(),
+                                 const int tag = 778 ) // waLBerla = 119+97+76+66+101+114+108+97
+      : blockForest_( bf ),
+        forestModificationStamp_( uint_t(0) ),
+        setupRequired_( true ),
+        communicationRunning_( false ),
+        requiredBlockSelectors_( Set<SUID>::emptySet() ),
+        incompatibleBlockSelectors_( Set<SUID>::emptySet() ),
+        tag_( tag )
+   {
+      auto forest = blockForest_.lock();
+      WALBERLA_CHECK_NOT_NULLPTR( forest, "Trying to access communication for a block storage object that doesn't exist anymore" );
+      forestModificationStamp_ = forest->getBlockForest().getModificationStamp();
+
+      if ( dataInfo )
+         dataInfos_.push_back( dataInfo );
+   }
+
+   UniformHybridScheme( const weak_ptr_wrapper<StructuredBlockForest> & bf,
+                        const Set<SUID> & requiredBlockSelectors,
+                        const Set<SUID> & incompatibleBlockSelectors,
+                        const shared_ptr<UniformMPIDatatypeInfo> & dataInfo = shared_ptr<UniformMPIDatatypeInfo>(),
+                        const int tag = 778 ) // waLBerla = 119+97+76+66+101+114+108+97
+      : blockForest_( bf ),
+        forestModificationStamp_( uint_t(0) ),
+        setupRequired_( true ),
+        communicationRunning_( false ),
+        requiredBlockSelectors_( requiredBlockSelectors ),
+        incompatibleBlockSelectors_( incompatibleBlockSelectors ),
+        tag_( tag )
+   {
+      auto forest = blockForest_.lock();
+      WALBERLA_CHECK_NOT_NULLPTR( forest, "Trying to access communication for a block storage object that doesn't exist anymore" );
+      forestModificationStamp_ = forest->getBlockForest().getModificationStamp();
+
+      if ( dataInfo )
+         dataInfos_.push_back( dataInfo );
+   }
+
+   ~UniformHybridScheme() { wait(); }
+   //@}
+   //*******************************************************************************************************************
+
+
+
+   //** Registration of data to communicate ****************************************************************************
+   /*! \name Registration of data to communicate */
+   //@{
+   void addDataToCommunicate(  const shared_ptr<UniformMPIDatatypeInfo> & dataInfo );
+   //@}
+   //*******************************************************************************************************************
+
+
+   //** Synchronous Communication **************************************************************************************
+   /*! \name Synchronous Communication */
+   //@{
+   inline void operator() () { communicate(); }
+   inline void communicate();
+   //@}
+   //*******************************************************************************************************************
+
+
+   //** Asynchronous Communication *************************************************************************************
+   /*! \name Asynchronous Communication */
+   //@{
+   void startCommunication();
+   void wait();
+
+   std::function<void()> getStartCommunicateFunctor() { return std::bind( &UniformHybridScheme::startCommunication, this ); }
+   std::function<void()> getWaitFunctor()             { return std::bind( &UniformHybridScheme::wait,               this ); }
+   //@}
+   //*******************************************************************************************************************
+
+
+   /// number of messages that are sent to other processes in each communication step
+   uint_t numberOfMessages() { setup(); return uint_c( sendInfos_.size() ); }
+
+   /// number of block pairs on this process that are communicated by direct copies
+   uint_t numberOfLocalCopies() { setup(); return uint_c( localInfos_.size() ); }
+
+protected:
+
+   void setup();
+
+   struct LocalCommInfo
+   {
+      BlockID            senderId;
+      BlockID            receiverId;
+      stencil::Direction dir;          ///< direction from sender to receiver
+   };
+
+   /// struct datatype combining the data of all registered data items for a given set of data addresses
+   struct CoalescedDatatype
+   {
+      std::vector< void * >     pointers;
+      shared_ptr<mpi::Datatype> datatype;
+   };
+
+   struct RemoteCommInfo
+   {
+      BlockID            localBlockId;
+      BlockID            remoteBlockId;
+      uint_t             remoteProcess;
+      stencil::Direction dir;
+
+      std::vector< shared_ptr<mpi::Datatype> > datatypes;   ///< one datatype per data item
+      std::vector< int >                       counts;      ///< number of items per data item
+      std::vector< CoalescedDatatype >         coalesced;   ///< cache, only used if more than one data item is registered
+
+      static bool sortByLocal( const RemoteCommInfo & lhs, const RemoteCommInfo & rhs );
+      static bool sortByRemote( const RemoteCommInfo & lhs, const RemoteCommInfo & rhs );
+   };
+
+   void * getMessage( RemoteCommInfo & info, IBlock * block, const bool send, MPI_Datatype & datatype, int & count );
+
+   weak_ptr_wrapper<StructuredBlockForest> blockForest_;
+   uint_t forestModificationStamp_;
+
+   bool setupRequired_;          //< this is set in the beginning, when new communication item was added or the forest has changed
+   bool communicationRunning_;   //< this is true between startCommunication() and wait()
+
+   Set<SUID> requiredBlockSelectors_;
+   Set<SUID> incompatibleBlockSelectors_;
+
+   std::vector<LocalCommInfo>  localInfos_;
+   std::vector<RemoteCommInfo> sendInfos_;
+   std::vector<RemoteCommInfo> recvInfos_;
+
+   std::vector< MPI_Request > mpiRequests_;
+
+   std::vector< shared_ptr<UniformMPIDatatypeInfo> > dataInfos_;
+
+   int tag_;
+
+}; // class UniformHybridScheme
+
+
+
+} // namespace communication
+} // namespace blockforest
+} // namespace walberla
+
+#include "UniformHybridScheme.impl.h"
@@ -0,0 +1,329 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file UniformHybridScheme.impl.h
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "UniformHybridScheme.h"
+#include "blockforest/BlockNeighborhoodSection.h"
+
+#include <algorithm>
+
+namespace walberla {
+namespace blockforest {
+namespace communication {
+
+//===================================================================================================================
+//
+//  UniformHybridScheme::RemoteCommInfo
+//
+//===================================================================================================================
+
+template< typename Stencil >
+bool UniformHybridScheme<Stencil>::RemoteCommInfo::sortByLocal( const RemoteCommInfo & lhs, const RemoteCommInfo & rhs )
+{
+   // lexicographical compare in order:  localBlockId, remoteBlockId, dir
+   if( lhs.localBlockId < rhs.localBlockId ) return true;
+   if( lhs.localBlockId > rhs.localBlockId ) return false;
+   WALBERLA_ASSERT_EQUAL( lhs.localBlockId, rhs.localBlockId );
+
+   if( lhs.remoteBlockId < rhs.remoteBlockId ) return true;
+   if( lhs.remoteBlockId > rhs.remoteBlockId ) return false;
+   WALBERLA_ASSERT_EQUAL( lhs.remoteBlockId, rhs.remoteBlockId );
+
+   return lhs.dir < rhs.dir;
+}
+
+
+template< typename Stencil >
+bool UniformHybridScheme<Stencil>::RemoteCommInfo::sortByRemote( const RemoteCommInfo & lhs, const RemoteCommInfo & rhs )
+{
+   // lexicographical compare in order:  remoteBlockId, localBlockId, inverse dir
+   if( lhs.remoteBlockId < rhs.remoteBlockId ) return true;
+   if( lhs.remoteBlockId > rhs.remoteBlockId ) return false;
+   WALBERLA_ASSERT_EQUAL( lhs.remoteBlockId, rhs.remoteBlockId );
+
+   if( lhs.localBlockId < rhs.localBlockId ) return true;
+   if( lhs.localBlockId > rhs.localBlockId ) return false;
+   WALBERLA_ASSERT_EQUAL( lhs.localBlockId, rhs.localBlockId );
+
+   return stencil::inverseDir[lhs.dir] < stencil::inverseDir[rhs.dir];
+}
+
+
+
+//===================================================================================================================
+//
+//  UniformHybridScheme
+//
+//===================================================================================================================
+
+template< typename Stencil >
+inline void UniformHybridScheme<Stencil>::communicate()
+{
+   startCommunication();
+   wait();
+}
+
+
+template< typename Stencil >
+void UniformHybridScheme<Stencil>::setup()
+{
+   auto forest = blockForest_.lock();
+   WALBERLA_CHECK_NOT_NULLPTR( forest, "Trying to access communication for a block storage object that doesn't exist anymore" );
+
+   if( forest->getBlockForest().getModificationStamp() != forestModificationStamp_ )
+      setupRequired_ = true;
+
+   if ( ! setupRequired_ )
+      return;
+
+   WALBERLA_ASSERT( !communicationRunning_ );
+
+   mpiRequests_.clear();
+   localInfos_.clear();
+   sendInfos_.clear();
+   recvInfos_.clear();
+
+   for( auto it = forest->begin(); it != forest->end(); ++it )
+   {
+      Block * block = dynamic_cast< Block * >( it.get() );
+
+      if( !selectable::isSetSelected( block->getState(), requiredBlockSelectors_, incompatibleBlockSelectors_ ) )
+         continue;
+
+      for( auto dir = Stencil::beginNoCenter(); dir != Stencil::end(); ++dir )
+      {
+         const auto neighborIdx = blockforest::getBlockNeighborhoodSectionIndex( *dir );
+
+         if( block->getNeighborhoodSectionSize(neighborIdx) == uint_t(0) )
+            continue;
+
+         WALBERLA_ASSERT( block->neighborhoodSectionHasEquallySizedBlock(neighborIdx) );
+         WALBERLA_ASSERT_EQUAL( block->getNeighborhoodSectionSize(neighborIdx), uint_t(1) );
+
+         const BlockID & nBlockId = block->getNeighborId( neighborIdx, uint_t(0) );
+
+         if( !selectable::isSetSelected( block->getNeighborState( neighborIdx, uint_t(0) ), requiredBlockSelectors_, incompatibleBlockSelectors_ ) )
+            continue;
+
+         if( block->neighborExistsLocally( neighborIdx, uint_t(0) ) )
+         {
+            // only the sending side is registered, the receiving side is handled by the neighbor block
+            LocalCommInfo info = { block->getId(), nBlockId, *dir };
+            localInfos_.push_back( info );
+            continue;
+         }
+
+         // These two infos do not belong to the same data exchange
+         // here we just say for example: "recv from west", "send to west"
+         // the sorting according to communication partners is done in a second step
+         RemoteCommInfo info;
+         info.localBlockId  = block->getId();
+         info.remoteBlockId = nBlockId;
+         info.remoteProcess = block->getNeighborProcess( neighborIdx, uint_t(0) );
+         info.dir           = *dir;
+
+         sendInfos_.push_back( info );
+         recvInfos_.push_back( info );
+      }
+   }
+
+   // Sort sends and receives so they match correctly with remote sends and receives (see UniformDirectScheme)
+   std::sort( sendInfos_.begin(), sendInfos_.end(), RemoteCommInfo::sortByLocal );
+   std::sort( recvInfos_.begin(), recvInfos_.end(), RemoteCommInfo::sortByRemote );
+
+   for( auto it = sendInfos_.begin(); it != sendInfos_.end(); ++it )
+   {
+      auto block = forest->getBlock( it->localBlockId );
+      WALBERLA_ASSERT_NOT_NULLPTR( block );
+      for( auto dataInfo = dataInfos_.begin(); dataInfo != dataInfos_.end(); ++dataInfo )
+      {
+         it->datatypes.push_back( (*dataInfo)->getSendDatatype( block, it->dir ) );
+         it->counts.push_back( (*dataInfo)->getNumberOfItemsToCommunicate( block, it->dir ) );
+      }
+   }
+
+   for( auto it = recvInfos_.begin(); it != recvInfos_.end(); ++it )
+   {
+      auto block = forest->getBlock( it->localBlockId );
+      WALBERLA_ASSERT_NOT_NULLPTR( block );
+      for( auto dataInfo = dataInfos_.begin(); dataInfo != dataInfos_.end(); ++dataInfo )
+      {
+         it->datatypes.push_back( (*dataInfo)->getRecvDatatype( block, it->dir ) );
+         it->counts.push_back( (*dataInfo)->getNumberOfItemsToCommunicate( block, it->dir ) );
+      }
+   }
+
+   mpiRequests_.resize( sendInfos_.size() + recvInfos_.size(), MPI_REQUEST_NULL );
+
+   forestModificationStamp_ = forest->getBlockForest().getModificationStamp();
+   setupRequired_ = false;
+}
+
+
+/// Returns the buffer pointer, datatype and count of the single message that transfers all data items
+template< typename Stencil >
+void * UniformHybridScheme<Stencil>::getMessage( RemoteCommInfo & info, IBlock * block, const bool send,
+                                                 MPI_Datatype & datatype, int & count )
+{
+   WALBERLA_ASSERT_EQUAL( info.datatypes.size(), dataInfos_.size() );
+
+   std::vector< void * > pointers( dataInfos_.size() );
+   for( uint_t i = 0; i != dataInfos_.size(); ++i )
+      pointers[i] = send ? dataInfos_[i]->getSendPointer( block, info.dir ) : dataInfos_[i]->getRecvPointer( block, info.dir );
+
+   if( dataInfos_.size() == uint_t(1) )
+   {
+      datatype = *( info.datatypes[0] );
+      count    = info.counts[0];
+      return pointers[0];
+   }
+
+   auto cached = std::find_if( info.coalesced.begin(), info.coalesced.end(),
+                               [&pointers]( const CoalescedDatatype & c ) { return c.pointers == pointers; } );
+
+   if( cached == info.coalesced.end() )
+   {
+      std::vector< MPI_Aint >     displacements( pointers.size() );
+      std::vector< MPI_Datatype > types( pointers.size() );
+
+      MPI_Aint base;
+      MPI_Get_address( pointers[0], &base );
+      for( uint_t i = 0; i != pointers.size(); ++i )
+      {
+         MPI_Aint address;
+         MPI_Get_address( pointers[i], &address );
+         displacements[i] = address - base;
+         types[i] = *( info.datatypes[i] );
+      }
+
+      MPI_Datatype newType = MPI_DATATYPE_NULL;
+      MPI_Type_create_struct( int_c( pointers.size() ), &( info.counts.front() ), &( displacements.front() ), &( types.front() ), &newType );
+
+      // keep at most two datatypes: enough for data that is swapped in every time step (e.g., src and dst field)
+      if( info.coalesced.size() >= uint_t(2) )
+         info.coalesced.erase( info.coalesced.begin() );
+
+      CoalescedDatatype c;
+      c.pointers = pointers;
+      c.datatype = make_shared<mpi::Datatype>( newType );
+      info.coalesced.push_back( c );
+      cached = info.coalesced.end() - 1;
+   }
+
+   datatype = *( cached->datatype );
+   count    = 1;
+   return pointers[0];
+}
+
+
+template< typename Stencil >
+void UniformHybridScheme<Stencil>::startCommunication()
+{
+   WALBERLA_ASSERT( !communicationRunning_ );
+
+   if( dataInfos_.empty() )
+      return;
+
+   setup();
+
+   communicationRunning_ = true;
+
+   const MPI_Comm comm = MPIManager::instance()->comm();
+
+   auto forest = blockForest_.lock();
+
+   auto requestIt = mpiRequests_.begin();
+
+   // post receives first, so that the local copies below can overlap with the MPI communication
+
+   for( auto it = recvInfos_.begin(); it != recvInfos_.end(); ++it, ++requestIt )
+   {
+      WALBERLA_ASSERT_UNEQUAL( requestIt, mpiRequests_.end() );
+      WALBERLA_ASSERT_EQUAL( *requestIt, MPI_REQUEST_NULL );
+
+      domain_decomposition::IBlock * const block = forest->getBlock( it->localBlockId );
+      WALBERLA_ASSERT_NOT_NULLPTR( block );
+
+      MPI_Datatype datatype;
+      int count;
+      void * ptr = getMessage( *it, block, false, datatype, count );
+
+      MPI_Irecv( ptr, count, datatype, int_c( it->remoteProcess ), tag_, comm, &( *requestIt ) );
+   }
+
+   for( auto it = sendInfos_.begin(); it != sendInfos_.end(); ++it, ++requestIt )
+   {
+      WALBERLA_ASSERT_UNEQUAL( requestIt, mpiRequests_.end() );
+      WALBERLA_ASSERT_EQUAL( *requestIt, MPI_REQUEST_NULL );
+
+      domain_decomposition::IBlock * const block = forest->getBlock( it->localBlockId );
+      WALBERLA_ASSERT_NOT_NULLPTR( block );
+
+      MPI_Datatype datatype;
+      int count;
+      void * ptr = getMessage( *it, block, true, datatype, count );
+
+      MPI_Isend( ptr, count, datatype, int_c( it->remoteProcess ), tag_, comm, &( *requestIt ) );
+   }
+
+   WALBERLA_ASSERT_EQUAL( requestIt, mpiRequests_.end() );
+
+   for( auto it = localInfos_.begin(); it != localInfos_.end(); ++it )
+   {
+      IBlock * const sender   = forest->getBlock( it->senderId );
+      IBlock * const receiver = forest->getBlock( it->receiverId );
+      WALBERLA_ASSERT_NOT_NULLPTR( sender );
+      WALBERLA_ASSERT_NOT_NULLPTR( receiver );
+
+      for( auto dataInfo = dataInfos_.begin(); dataInfo != dataInfos_.end(); ++dataInfo )
+         (*dataInfo)->communicateLocal( sender, receiver, it->dir );
+   }
+}
+
+
+
+template< typename Stencil >
+void UniformHybridScheme<Stencil>::wait()
+{
+   if( !communicationRunning_ )
+      return;
+
+   if( !mpiRequests_.empty() )
+      MPI_Waitall( int_c( mpiRequests_.size() ), &(mpiRequests_.front()), MPI_STATUSES_IGNORE );
+
+   communicationRunning_ = false;
+}
+
+
+template< typename Stencil >
+void UniformHybridScheme<Stencil>::addDataToCommunicate(  const shared_ptr<UniformMPIDatatypeInfo> & dataInfo )
+{
+   WALBERLA_ASSERT( !communicationRunning_ );
+
+   setupRequired_ = true;
+   dataInfos_.push_back( dataInfo );
+}
+
+
+
+} // namespace communication
+} // namespace blockforest
+} // namespace walberla
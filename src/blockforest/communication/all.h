@@ -29,3 +29,4 @@
 #include "NonUniformPackInfo.h"
 #include "UniformBufferedScheme.h"
 #include "UniformDirectScheme.h"
+#include "UniformHybridScheme.h"
@@ -0,0 +1,284 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file MeasuredCost.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "MeasuredCost.h"
+
+#include "core/Abort.h"
+#include "core/debug/Debug.h"
+#include "core/logging/Logging.h"
+#include "core/mpi/MPIManager.h"
+#include "core/mpi/Reduce.h"
+
+#include <algorithm>
+
+
+namespace walberla {
+namespace blockforest {
+
+
+
+void MeasuredBlockCost::finishTimeStep( const uint_t windowSize )
+{
+   samples_.push_back( current_ );
+   current_ = 0.0;
+   while( samples_.size() > std::max( windowSize, uint_t(1) ) )
+      samples_.pop_front();
+}
+
+
+
+double MeasuredBlockCost::cost() const
+{
+   if( samples_.empty() )
+      return 0.0;
+
+   double sum( 0.0 );
+   for( auto sample = samples_.begin(); sample != samples_.end(); ++sample )
+      sum += *sample;
+   return sum / double_c( samples_.size() );
+}
+
+
+
+void MeasuredBlockCostHandling::serialize( IBlock * const block, const BlockDataID & id, mpi::SendBuffer & buffer )
+{
+   buffer << block->getData< MeasuredBlockCost >( id )->samples();
+}
+
+void MeasuredBlockCostHandling::serializeCoarseToFine( Block * const block, const BlockDataID & id, mpi::SendBuffer & buffer, const uint_t )
+{
+   std::deque< double > samples = block->getData< MeasuredBlockCost >( id )->samples();
+   for( auto sample = samples.begin(); sample != samples.end(); ++sample )
+      *sample /= 8.0;
+   buffer << samples;
+}
+
+void MeasuredBlockCostHandling::serializeFineToCoarse( Block * const block, const BlockDataID & id, mpi::SendBuffer & buffer )
+{
+   buffer << block->getData< MeasuredBlockCost >( id )->samples();
+}
+
+void MeasuredBlockCostHandling::deserialize( IBlock * const block, const BlockDataID & id, mpi::RecvBuffer & buffer )
+{
+   buffer >> block->getData< MeasuredBlockCost >( id )->samples();
+}
+
+void MeasuredBlockCostHandling::deserializeCoarseToFine( Block * const block, const BlockDataID & id, mpi::RecvBuffer & buffer )
+{
+   buffer >> block->getData< MeasuredBlockCost >( id )->samples();
+}
+
+void MeasuredBlockCostHandling::deserializeFineToCoarse( Block * const block, const BlockDataID & id, mpi::RecvBuffer & buffer, const uint_t )
+{
+   std::deque< double > childSamples;
+   buffer >> childSamples;
+
+   // the most recent samples of all children are added up
+   std::deque< double > & samples = block->getData< MeasuredBlockCost >( id )->samples();
+   while( samples.size() < childSamples.size() )
+      samples.push_front( 0.0 );
+   auto sample = samples.rbegin();
+   for( auto childSample = childSamples.rbegin(); childSample != childSamples.rend(); ++childSample, ++sample )
+      *sample += *childSample;
+}
+
+
+
+MeasuredCostLoadBalancing::MeasuredCostLoadBalancing( BlockForest & forest, const uint_t windowSize,
+                                                      const double imbalanceThreshold, const uint_t checkFrequency ) :
+   forest_( forest ), windowSize_( windowSize ), imbalanceThreshold_( imbalanceThreshold ), checkFrequency_( checkFrequency ),
+   baseWeight_( 0.0 ), timeSteps_( uint_t(0) ), rebalances_( uint_t(0) ), lastImbalance_( 1.0 )
+{
+   costId_ = forest_.addBlockData( make_shared< MeasuredBlockCostHandling >(), "measured block cost" );
+}
+
+
+
+void MeasuredCostLoadBalancing::record( IBlock * const block, const double seconds )
+{
+   WALBERLA_ASSERT_NOT_NULLPTR( block );
+   block->getData< MeasuredBlockCost >( costId_ )->add( seconds );
+}
+
+
+
+std::function< void ( IBlock *, const double ) > MeasuredCostLoadBalancing::getRecordingFunction()
+{
+   return [this]( IBlock * block, const double seconds ) { record( block, seconds ); };
+}
+
+
+
+void MeasuredCostLoadBalancing::operator()()
+{
+   finishTimeStep();
+
+   ++timeSteps_;
+   if( checkFrequency_ == uint_t(0) || timeSteps_ % checkFrequency_ != uint_t(0) )
+      return;
+
+   rebalance();
+}
+
+
+
+void MeasuredCostLoadBalancing::finishTimeStep()
+{
+   for( auto block = forest_.begin(); block != forest_.end(); ++block )
+      block->getData< MeasuredBlockCost >( costId_ )->finishTimeStep( windowSize_ );
+}
+
+
+
+double MeasuredCostLoadBalancing::imbalance() const
+{
+   double load( 0.0 );
+   for( auto block = forest_.begin(); block != forest_.end(); ++block )
+      load += block->getData< MeasuredBlockCost >( costId_ )->cost();
+
+   const double maxLoad = mpi::allReduce( load, mpi::MAX );
+   const double sumLoad = mpi::allReduce( load, mpi::SUM );
+
+   if( !( sumLoad > 0.0 ) )
+      return 1.0;
+
+   return maxLoad / ( sumLoad / double_c( MPIManager::instance()->numProcesses() ) );
+}
+
+
+
+bool MeasuredCostLoadBalancing::rebalance()
+{
+   lastImbalance_ = imbalance();
+   if( !( lastImbalance_ > imbalanceThreshold_ ) )
+      return false;
+
+   if( !forest_.loadBalancingFunctionRegistered() )
+      WALBERLA_ABORT( "Measured load imbalance of " << lastImbalance_ << " exceeds the threshold of " << imbalanceThreshold_ <<
+                      ", but no load balancing function is registered at the block forest "
+                      "(see BlockForest::setRefreshPhantomBlockMigrationPreparationFunction)!" );
+
+   WALBERLA_LOG_PROGRESS_ON_ROOT( "Measured load imbalance of " << lastImbalance_ << " exceeds the threshold of " <<
+                                  imbalanceThreshold_ << " -> dynamic load balancing" );
+
+   const bool alwaysRebalance = forest_.alwaysRebalanceInRefresh();
+   forest_.alwaysRebalanceInRefresh( true );
+   forest_.refresh();
+   forest_.alwaysRebalanceInRefresh( alwaysRebalance );
+
+   ++rebalances_;
+   return true;
+}
+
+
+
+void MeasuredCostLoadBalancing::operator()( std::vector< std::pair< const PhantomBlock *, walberla::any > > & blockData,
+                                            const PhantomBlockForest & phantomForest ) const
+{
+   const BlockForest & forest = phantomForest.getBlockForest();
+
+   // blocks that were not measured yet get the average cost of the measured local blocks
+
+   double averageCost( 0.0 );
+   uint_t measuredBlocks( uint_t(0) );
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+   {
+      const MeasuredBlockCost * blockCost = block->getData< MeasuredBlockCost >( costId_ );
+      if( blockCost->measured() )
+      {
+         averageCost += blockCost->cost();
+         ++measuredBlocks;
+      }
+   }
+   averageCost = ( measuredBlocks > uint_t(0) ) ? ( averageCost / double_c( measuredBlocks ) ) : 1.0;
+
+   for( auto it = blockData.begin(); it != blockData.end(); ++it )
+   {
+      const PhantomBlock * block = it->first;
+      double cost( -1.0 );
+
+      if( block->getLevel() == block->getSourceLevel() )
+      {
+         cost = measuredCost( forest, block->getId() );
+      }
+      else if( block->getLevel() > block->getSourceLevel() ) // split: one eighth of the father
+      {
+         cost = measuredCost( forest, block->getId().getFatherId() );
+         if( cost >= 0.0 )
+            cost /= 8.0;
+      }
+      else // merged: sum of the children, children that reside on other processes are extrapolated
+      {
+         double sum( 0.0 );
+         uint_t children( uint_t(0) );
+         for( uint_t c = 0; c != uint_t(8); ++c )
+         {
+            const double childCost = measuredCost( forest, BlockID( block->getId(), c ) );
+            if( childCost >= 0.0 )
+            {
+               sum += childCost;
+               ++children;
+            }
+         }
+         if( children > uint_t(0) )
+            cost = sum * 8.0 / double_c( children );
+      }
+
+      if( cost < 0.0 )
+         cost = averageCost;
+
+      it->second = PhantomBlockWeight( cost + baseWeight_ );
+   }
+}
+
+
+
+void MeasuredCostLoadBalancing::registerWeightFunctions()
+{
+   forest_.setRefreshPhantomBlockDataAssignmentFunction(
+            [this]( std::vector< std::pair< const PhantomBlock *, walberla::any > > & blockData,
+                    const PhantomBlockForest & phantomForest ) { (*this)( blockData, phantomForest ); } );
+   forest_.setRefreshPhantomBlockDataPackFunction( PhantomBlockWeightPackUnpackFunctor() );
+   forest_.setRefreshPhantomBlockDataUnpackFunction( PhantomBlockWeightPackUnpackFunctor() );
+}
+
+
+
+double MeasuredCostLoadBalancing::cost( const IBlock & block ) const
+{
+   return block.getData< MeasuredBlockCost >( costId_ )->cost();
+}
+
+
+
+double MeasuredCostLoadBalancing::measuredCost( const BlockForest & forest, const BlockID & id ) const
+{
+   const Block * block = forest.getBlock( id );
+   if( block == nullptr )
+      return -1.0;
+
+   const MeasuredBlockCost * blockCost = block->getData< MeasuredBlockCost >( costId_ );
+   return blockCost->measured() ? blockCost->cost() : -1.0;
+}
+
+
+
+} // namespace blockforest
+} // namespace walberla
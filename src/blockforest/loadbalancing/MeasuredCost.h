@@ -0,0 +1,204 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file MeasuredCost.h
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "PODPhantomData.h"
+#include "blockforest/BlockDataHandling.h"
+#include "blockforest/BlockForest.h"
+#include "blockforest/PhantomBlockForest.h"
+
+#include "core/DataTypes.h"
+#include "core/NonCopyable.h"
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+
+namespace walberla {
+namespace blockforest {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Measured computational cost (wall time in seconds) of one block
+*
+*   The time of all sweeps of one time step is accumulated, the cost of the block is the average over the last time
+*   steps (the sliding window).
+*/
+//**********************************************************************************************************************
+class MeasuredBlockCost
+{
+public:
+
+   MeasuredBlockCost() : current_( 0.0 ) {}
+
+   void add( const double seconds ) { current_ += seconds; }
+
+   /// closes the current time step, only the last 'windowSize' time steps are kept
+   void finishTimeStep( const uint_t windowSize );
+
+   bool measured() const { return !samples_.empty(); }
+
+   /// average cost of all time steps within the window (zero if nothing was measured yet)
+   double cost() const;
+
+   const std::deque< double > & samples() const { return samples_; }
+         std::deque< double > & samples()       { return samples_; }
+
+   bool operator==( const MeasuredBlockCost & other ) const { return floatIsEqual( current_, other.current_ ) && samples_ == other.samples_; }
+
+private:
+
+   double current_;
+   std::deque< double > samples_;
+};
+
+
+
+/// Block data handling that migrates the measurements together with the block. If a block is split, every child
+/// starts with one eighth of the cost of its father. If blocks are merged, the cost of the new block is the sum of the
+/// costs of its children.
+class MeasuredBlockCostHandling : public BlockDataHandling< MeasuredBlockCost >
+{
+public:
+
+   MeasuredBlockCost * initialize( IBlock * const ) { return new MeasuredBlockCost(); }
+
+   void serialize( IBlock * const block, const BlockDataID & id, mpi::SendBuffer & buffer );
+   void serializeCoarseToFine( Block * const block, const BlockDataID & id, mpi::SendBuffer & buffer, const uint_t child );
+   void serializeFineToCoarse( Block * const block, const BlockDataID & id, mpi::SendBuffer & buffer );
+
+   MeasuredBlockCost * deserialize( IBlock * const ) { return new MeasuredBlockCost(); }
+   MeasuredBlockCost * deserializeCoarseToFine( Block * const ) { return new MeasuredBlockCost(); }
+   MeasuredBlockCost * deserializeFineToCoarse( Block * const ) { return new MeasuredBlockCost(); }
+
+   void deserialize( IBlock * const block, const BlockDataID & id, mpi::RecvBuffer & buffer );
+   void deserializeCoarseToFine( Block * const block, const BlockDataID & id, mpi::RecvBuffer & buffer );
+   void deserializeFineToCoarse( Block * const block, const BlockDataID & id, mpi::RecvBuffer & buffer, const uint_t child );
+};
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Dynamic load balancing with block weights that are measured at run time
+*
+*   Instead of a hand-made weight model (cf. PODPhantomData, pe::amr::WeightAssignmentFunctor), the wall time of every
+*   sweep on every block is measured by the SweepTimeloop. The measurements are accumulated per time step and averaged
+*   over a sliding window of 'windowSize' time steps. The resulting costs are stored as block data (so that they
+*   migrate with the blocks) and are used as weights (PODPhantomWeight<double>) for the dynamic load balancing
+*   algorithms (DynamicCurveBalance, DynamicDiffusionBalance, DynamicParMetis).
+*   Every 'checkFrequency' time steps, the imbalance (maximal process load divided by the average process load) is
+*   computed. If it exceeds 'imbalanceThreshold', BlockForest::refresh() is triggered with rebalancing enforced.
+*
+*   Usage:
+*   \code
+*      blockforest::MeasuredCostLoadBalancing balancing( blocks->getBlockForest(), windowSize, 1.1, checkFrequency );
+*
+*      auto & forest = blocks->getBlockForest();
+*      forest.setRefreshPhantomBlockMigrationPreparationFunction(
+*               blockforest::DynamicCurveBalance< blockforest::MeasuredCostLoadBalancing::PhantomBlockWeight >() );
+*      balancing.registerWeightFunctions(); // phantom block weight assignment and pack/unpack
+*
+*      timeloop.setBlockTimingFunction( balancing.getRecordingFunction() );
+*      timeloop.addFuncAfterTimeStep( balancing.getTimeStepFunction(), "measured cost load balancing" );
+*   \endcode
+*   The object must outlive the timeloop and the block forest callbacks it was registered with.
+*/
+//**********************************************************************************************************************
+class MeasuredCostLoadBalancing : public NonCopyable
+{
+public:
+
+   typedef PODPhantomWeight< double >           PhantomBlockWeight;
+   typedef PODPhantomWeightPackUnpack< double > PhantomBlockWeightPackUnpackFunctor;
+
+   MeasuredCostLoadBalancing( BlockForest & forest, const uint_t windowSize = uint_t(10),
+                              const double imbalanceThreshold = 1.1, const uint_t checkFrequency = uint_t(10) );
+
+   /// adds the wall time of one sweep to the cost of 'block' (may be called concurrently for different blocks)
+   void record( IBlock * const block, const double seconds );
+   std::function< void ( IBlock *, const double ) > getRecordingFunction();
+
+   /// closes the current time step of all local blocks and checks for imbalance every 'checkFrequency' calls
+   void operator()();
+   std::function< void () > getTimeStepFunction() { return [this]() { (*this)(); }; }
+
+   /// closes the current time step of all local blocks (operator() calls this function)
+   void finishTimeStep();
+
+   /// maximal process load divided by the average process load (must be called by all processes)
+   double imbalance() const;
+
+   /// triggers BlockForest::refresh() if the imbalance exceeds the threshold (must be called by all processes)
+   bool rebalance();
+
+   /// assigns the measured costs to the phantom blocks, see BlockForest::setRefreshPhantomBlockDataAssignmentFunction()
+   void operator()( std::vector< std::pair< const PhantomBlock *, walberla::any > > & blockData,
+                    const PhantomBlockForest & phantomForest ) const;
+
+   /// registers the weight assignment and the pack/unpack functions for the phantom block weights at the block forest
+   void registerWeightFunctions();
+
+   double cost( const IBlock & block ) const;
+   BlockDataID getCostDataID() const { return costId_; }
+
+   double lastImbalance() const { return lastImbalance_; }
+   uint_t numberOfRebalances() const { return rebalances_; }
+
+   uint_t windowSize() const { return windowSize_; }
+   void setWindowSize( const uint_t windowSize ) { windowSize_ = windowSize; }
+
+   double imbalanceThreshold() const { return imbalanceThreshold_; }
+   void setImbalanceThreshold( const double threshold ) { imbalanceThreshold_ = threshold; }
+
+   uint_t checkFrequency() const { return checkFrequency_; }
+   void setCheckFrequency( const uint_t checkFrequency ) { checkFrequency_ = checkFrequency; }
+
+   /// Weight (in seconds) that is added to the measured cost of every block. Blocks with a weight of zero are
+   /// dangerous, since they might accumulate on one process.
+   double baseWeight() const { return baseWeight_; }
+   void setBaseWeight( const double weight ) { baseWeight_ = weight; }
+
+private:
+
+   /// cost of a local block, or -1 if the block was not measured yet
+   double measuredCost( const BlockForest & forest, const BlockID & id ) const;
+
+   BlockForest & forest_;
+   BlockDataID costId_;
+
+   uint_t windowSize_;
+   double imbalanceThreshold_;
+   uint_t checkFrequency_;
+   double baseWeight_;
+
+   uint_t timeSteps_;
+   uint_t rebalances_;
+   double lastImbalance_;
+};
+
+
+
+} // namespace blockforest
+} // namespace walberla
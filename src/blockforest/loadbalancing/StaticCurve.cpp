@@ -21,7 +21,11 @@
 
 #include "StaticCurve.h"
 
+#include "core/Abort.h"
+
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 
 
@@ -156,5 +160,188 @@ uint_t StaticLevelwiseCurveBalanceWeighted::operator()( SetupBlockForest & fores
 
 
 
+uint_t StaticCurveBalanceBisection::operator()( SetupBlockForest & forest, const uint_t numberOfProcesses, const memory_t perProcessMemoryLimit )
+{
+   std::vector< SetupBlock * > blocks;
+   if( hilbert_ )
+      forest.getHilbertOrder( blocks );
+   else
+      forest.getMortonOrder( blocks );
+
+   const bool memoryLimit = perProcessMemoryLimit > memory_t(0);
+   std::vector< memory_t > memory( numberOfProcesses, perProcessMemoryLimit );
+
+   if( levelwise_ )
+   {
+      for( uint_t level = uint_t(0); level < forest.getNumberOfLevels(); ++level )
+      {
+         std::vector< SetupBlock * > blocksOnLevel;
+
+         for( auto block = blocks.begin(); block != blocks.end(); ++block )
+            if( (*block)->getLevel() == level )
+               blocksOnLevel.push_back( *block );
+
+         partition( blocksOnLevel, numberOfProcesses, memoryLimit, memory );
+      }
+   }
+   else
+   {
+      partition( blocks, numberOfProcesses, memoryLimit, memory );
+   }
+
+   // every process from '0' to 'usedProcesses-1' must hold at least one block: processes that did not receive any
+   // block (only possible if memory limits forced empty pieces) are removed
+
+   std::vector< uint_t > processMap( numberOfProcesses, uint_t(0) );
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+      processMap[ (*block)->getTargetProcess() ] = uint_t(1);
+
+   uint_t usedProcesses( uint_t(0) );
+   for( auto process = processMap.begin(); process != processMap.end(); ++process )
+      *process = ( *process == uint_t(1) ) ? usedProcesses++ : numberOfProcesses;
+
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+      (*block)->assignTargetProcess( processMap[ (*block)->getTargetProcess() ] );
+
+   return usedProcesses;
+}
+
+
+
+uint_t StaticCurveBalanceBisection::partition( const std::vector< SetupBlock * > & blocks, const uint_t numberOfProcesses,
+                                               const bool memoryLimit, std::vector< memory_t > & memory ) const
+{
+   const uint_t numberOfBlocks = uint_c( blocks.size() );
+   if( numberOfBlocks == uint_t(0) || numberOfProcesses == uint_t(0) )
+      return uint_t(0);
+
+   // prefix sums over the workload and the memory along the curve (if all workloads are zero, all blocks count as one)
+
+   bool weighted( false );
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+   {
+      WALBERLA_ASSERT( !( (*block)->getWorkload() < workload_t(0) ) );
+      weighted = weighted || ( (*block)->getWorkload() > workload_t(0) );
+   }
+
+   std::vector< workload_t > workload( numberOfBlocks + uint_t(1), workload_t(0) );
+   std::vector< memory_t >   blockMemory( numberOfBlocks + uint_t(1), memory_t(0) );
+   workload_t maxWorkload( 0 );
+   for( uint_t i = uint_t(0); i != numberOfBlocks; ++i )
+   {
+      const workload_t w = weighted ? blocks[i]->getWorkload() : workload_t(1);
+      workload[i+1] = workload[i] + w;
+      blockMemory[i+1] = blockMemory[i] + blocks[i]->getMemory();
+      maxWorkload = std::max( maxWorkload, w );
+   }
+
+   // Every process takes as many blocks as possible without exceeding the bottleneck (and its remaining memory). The
+   // bottleneck is feasible if all blocks are assigned. 'overflow' is the smallest bottleneck for which at least one
+   // process could take one more block, i.e., all bottlenecks in [bottleneck,overflow) result in the same cuts. If
+   // 'fillProcesses' is true, enough blocks are left for all remaining processes, so that as many processes as
+   // possible are used.
+
+   std::vector< uint_t > cuts( numberOfProcesses + uint_t(1), uint_t(0) ); // process p: blocks [ cuts[p], cuts[p+1] )
+   workload_t overflow( 0 );
+
+   auto probe = [&]( const workload_t bottleneck, const bool fillProcesses ) -> bool
+   {
+      overflow = std::numeric_limits< workload_t >::max();
+      uint_t begin( uint_t(0) );
+      for( uint_t p = uint_t(0); p != numberOfProcesses; ++p )
+      {
+         cuts[p] = begin;
+         uint_t end = uint_c( std::upper_bound( workload.begin() + std::ptrdiff_t( begin ), workload.end(),
+                                                workload[ begin ] + bottleneck ) - workload.begin() ) - uint_t(1);
+         bool limitedByBottleneck = ( end < numberOfBlocks );
+         if( memoryLimit )
+         {
+            const uint_t memoryEnd = uint_c( std::upper_bound( blockMemory.begin() + std::ptrdiff_t( begin ), blockMemory.end(),
+                                                               blockMemory[ begin ] + memory[p] ) - blockMemory.begin() ) - uint_t(1);
+            limitedByBottleneck = limitedByBottleneck && ( end < memoryEnd );
+            end = std::min( end, memoryEnd );
+         }
+         if( limitedByBottleneck )
+            overflow = std::min( overflow, workload[ end + uint_t(1) ] - workload[ begin ] );
+         if( fillProcesses && numberOfBlocks - begin > numberOfProcesses - p - uint_t(1) )
+            end = std::min( end, numberOfBlocks - ( numberOfProcesses - p - uint_t(1) ) );
+         begin = end;
+      }
+      cuts[ numberOfProcesses ] = begin;
+      return begin == numberOfBlocks;
+   };
+
+   auto bottleneck = [&]()
+   {
+      workload_t max( 0 );
+      for( uint_t p = uint_t(0); p != numberOfProcesses; ++p )
+         max = std::max( max, workload[ cuts[p+1] ] - workload[ cuts[p] ] );
+      return max;
+   };
+
+   // bisection: 'lower' is a lower bound of the optimal bottleneck, 'upper' always is a feasible bottleneck that is
+   // actually attained by some cut. If a bottleneck is infeasible, the optimum is at least the overflow of this
+   // bottleneck, which lets the bisection jump to the exact optimum (no convergence up to floating point precision).
+
+   workload_t lower = std::max( workload.back() / workload_c( numberOfProcesses ), maxWorkload );
+   workload_t upper = lower + maxWorkload;
+   if( !probe( upper, false ) )
+   {
+      upper = workload.back();
+      if( !memoryLimit || !probe( upper, false ) )
+         WALBERLA_ABORT( "Load balancing failed: A distribution of " << numberOfBlocks << " blocks to " << numberOfProcesses <<
+                         " processes that satisfies the per process memory limit is impossible.\n"
+                         "                       (Are the memory coefficients correctly assigned to all blocks via "
+                         "a callback function that was registered with \"addWorkloadMemorySUIDAssignmentFunction()\"?)" );
+   }
+   upper = bottleneck();
+
+   if( probe( lower, false ) )
+      upper = std::min( upper, bottleneck() );
+   else
+      lower = std::max( lower, overflow );
+
+   while( lower < upper )
+   {
+      const workload_t middle = lower + ( upper - lower ) / workload_t(2);
+      if( !( lower < middle && middle < upper ) )
+         break;
+
+      if( probe( middle, false ) )
+      {
+         const workload_t attained = bottleneck();
+         if( !( attained < upper ) ) // rounding of the prefix sums
+            break;
+         upper = attained;
+      }
+      else
+      {
+         lower = std::max( middle, overflow );
+      }
+   }
+
+   // final assignment with the optimal bottleneck
+
+   if( !probe( upper, true ) )
+   {
+      const bool feasible = probe( upper, false );
+      WALBERLA_CHECK( feasible );
+   }
+
+   uint_t usedProcesses( uint_t(0) );
+   for( uint_t p = uint_t(0); p != numberOfProcesses; ++p )
+   {
+      for( uint_t i = cuts[p]; i != cuts[p+1]; ++i )
+         blocks[i]->assignTargetProcess( p );
+      memory[p] -= blockMemory[ cuts[p+1] ] - blockMemory[ cuts[p] ];
+      if( cuts[p+1] != cuts[p] )
+         usedProcesses = p + uint_t(1);
+   }
+
+   return usedProcesses;
+}
+
+
+
 } // namespace blockforest
 } // namespace walberla
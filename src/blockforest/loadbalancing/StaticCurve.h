@@ -23,6 +23,8 @@
 
 #include "blockforest/SetupBlockForest.h"
 
+#include <vector>
+
 
 
 namespace walberla {
@@ -60,5 +62,41 @@ private:
 
 
 
+/**
+ *  Takes the weight/workload of all blocks into account and computes optimal contiguous cuts of the space filling curve
+ *
+ *  The blocks are ordered along the curve (Hilbert or Morton order), and the curve is cut into (at most)
+ *  'numberOfProcesses' contiguous pieces such that the maximal workload of any process is minimal. The optimal
+ *  bottleneck is found by bisection: for a given bottleneck, the prefix sums of the workloads allow to determine every
+ *  cut with a binary search, i.e., testing one bottleneck costs O( numberOfProcesses * log( numberOfBlocks ) ).
+ *  In contrast to the greedy cuts of StaticLevelwiseCurveBalanceWeighted, the result is optimal for the given curve.
+ *
+ *  If a per process memory limit is given, the accumulated memory of all blocks that are assigned to one process
+ *  (summed over all levels) never exceeds this limit. The balancing aborts if no such distribution exists.
+ *
+ *  If 'levelwise' is true (default), every level is distributed individually to all processes (cf.
+ *  StaticLevelwiseCurveBalanceWeighted), otherwise the complete curve (blocks of all levels) is partitioned at once.
+ */
+class StaticCurveBalanceBisection
+{
+public:
+
+   StaticCurveBalanceBisection( const bool hilbert = true, const bool levelwise = true ) : hilbert_( hilbert ), levelwise_( levelwise ) {}
+
+   uint_t operator()( SetupBlockForest & forest, const uint_t numberOfProcesses, const memory_t perProcessMemoryLimit );
+
+private:
+
+   /// Partitions the chain 'blocks' (blocks in curve order) and returns the number of used processes. 'memory' contains
+   /// the memory that is still available on each process and is reduced by the memory of the assigned blocks.
+   uint_t partition( const std::vector< SetupBlock * > & blocks, const uint_t numberOfProcesses, const bool memoryLimit,
+                     std::vector< memory_t > & memory ) const;
+
+   bool hilbert_;
+   bool levelwise_;
+};
+
+
+
 } // namespace blockforest
 } // namespace walberla
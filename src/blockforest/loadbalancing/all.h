@@ -26,6 +26,7 @@
 #include "DynamicCurve.h"
 #include "DynamicDiffusive.h"
 #include "DynamicParMetis.h"
+#include "MeasuredCost.h"
 #include "NoPhantomData.h"
 #include "PODPhantomData.h"
 #include "StaticCurve.h"
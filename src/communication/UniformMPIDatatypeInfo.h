@@ -22,9 +22,13 @@
 #pragma once
 
 #include "core/mpi/Datatype.h"
+#include "core/mpi/MPIManager.h"
 #include "domain_decomposition/IBlock.h"
 #include "stencil/Directions.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace walberla {
 namespace communication {
 
@@ -77,6 +81,36 @@ namespace communication {
       * Due to custom aggregated MPI datatypes this is usually 1
       *****************************************************************************************************************/
       virtual int getNumberOfItemsToCommunicate( IBlock * , const stencil::Direction ) { return 1; }
+
+
+
+      /*************************************************************************************************************//**
+      * Copy the data that is sent in direction 'dir' from block 'sender' to block 'receiver', both blocks are
+      * located on this process (used by blockforest::communication::UniformHybridScheme).
+      * The default implementation packs the data described by the send data type into a temporary buffer and unpacks
+      * it with the receive data type. No message is exchanged, hence the copy cannot match any other communication.
+      * Implementations should override this function with a direct copy.
+      *****************************************************************************************************************/
+      virtual void communicateLocal( IBlock * sender, IBlock * receiver, const stencil::Direction dir )
+      {
+         const stencil::Direction recvDir = stencil::inverseDir[dir];
+
+         auto sendDatatype = getSendDatatype( sender, dir );
+         auto recvDatatype = getRecvDatatype( receiver, recvDir );
+
+         const MPI_Comm comm = MPIManager::instance()->comm();
+         const int sendCount = getNumberOfItemsToCommunicate( sender, dir );
+
+         int size = 0;
+         MPI_Pack_size( sendCount, *sendDatatype, comm, &size );
+         std::vector< char > buffer( std::max( size, 1 ) );
+
+         int position = 0;
+         MPI_Pack( getSendPointer( sender, dir ), sendCount, *sendDatatype, &buffer[0], size, &position, comm );
+         position = 0;
+         MPI_Unpack( &buffer[0], size, &position, getRecvPointer( receiver, recvDir ), getNumberOfItemsToCommunicate( receiver, recvDir ),
+                     *recvDatatype, comm );
+      }
    };
 
 
@@ -0,0 +1,409 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file TaskGraph.cpp
+//! \ingroup core
+//
+//======================================================================================================================
+
+#include "TaskGraph.h"
+
+#include "core/debug/CheckFunctions.h"
+#include "core/debug/Debug.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+
+namespace walberla {
+
+
+
+/// Worker threads (thread 0 is the thread that calls execute()) and the state of the current execution
+struct TaskGraph::Pool
+{
+   struct Queue
+   {
+      std::mutex mutex;
+      std::deque< TaskID > tasks;
+   };
+
+   std::vector< std::thread > threads; ///< threads 1, 2, ...
+
+   std::mutex mutex;                 ///< protects the following members and the increments of the 'ready' counters
+   std::condition_variable wakeup;   ///< new execution, new ready tasks, all tasks finished, or shutdown
+   std::condition_variable idle;     ///< the last worker thread left the current execution
+   bool shutdown;
+   bool running;                     ///< execute() is running
+   uint_t execution;                 ///< counts the calls of execute()
+   uint_t busy;                      ///< number of worker threads that take part in the current execution
+
+   std::vector< std::unique_ptr< Queue > > queues;
+
+   std::mutex masterMutex;
+   std::priority_queue< TaskID, std::vector< TaskID >, std::greater< TaskID > > masterQueue;
+
+   std::unique_ptr< std::atomic< uint_t >[] > predecessors;
+   uint_t numberOfTasks;
+
+   std::atomic< uint_t > ready;       ///< number of tasks in 'queues'
+   std::atomic< uint_t > masterReady; ///< number of tasks in 'masterQueue'
+   std::atomic< uint_t > finished;
+   std::atomic< uint_t > stolen;
+
+   Pool() : shutdown( false ), running( false ), execution( uint_t(0) ), busy( uint_t(0) ), numberOfTasks( uint_t(0) ),
+            ready( uint_t(0) ), masterReady( uint_t(0) ), finished( uint_t(0) ), stolen( uint_t(0) ) {}
+};
+
+
+
+TaskGraph::TaskGraph() : acyclic_( true ), validated_( true ), stolenTasks_( uint_t(0) ) {}
+
+
+
+TaskGraph::~TaskGraph()
+{
+   stopThreads();
+}
+
+
+
+TaskGraph::TaskID TaskGraph::addTask( const Task & task, const bool masterOnly )
+{
+   tasks_.push_back( Node( task, masterOnly ) );
+   return tasks_.size() - uint_t(1);
+}
+
+
+
+void TaskGraph::addDependency( const TaskID predecessor, const TaskID successor )
+{
+   WALBERLA_ASSERT_LESS( predecessor, tasks_.size() );
+   WALBERLA_ASSERT_LESS( successor, tasks_.size() );
+
+   auto & successors = tasks_[ predecessor ].successors;
+   if( std::find( successors.begin(), successors.end(), successor ) != successors.end() )
+      return;
+
+   successors.push_back( successor );
+   ++( tasks_[ successor ].predecessors );
+   validated_ = false;
+}
+
+
+
+uint_t TaskGraph::numberOfDependencies() const
+{
+   uint_t dependencies( uint_t(0) );
+   for( auto task = tasks_.begin(); task != tasks_.end(); ++task )
+      dependencies += task->successors.size();
+   return dependencies;
+}
+
+
+
+bool TaskGraph::isAcyclic() const
+{
+   if( validated_ )
+      return acyclic_;
+
+   // Kahn's algorithm: all tasks can be sorted topologically if and only if there is no cycle
+
+   std::vector< uint_t > predecessors( tasks_.size() );
+   std::vector< TaskID > ready;
+   for( TaskID task = 0; task != tasks_.size(); ++task )
+   {
+      predecessors[ task ] = tasks_[ task ].predecessors;
+      if( predecessors[ task ] == uint_t(0) )
+         ready.push_back( task );
+   }
+
+   uint_t sorted( uint_t(0) );
+   while( !ready.empty() )
+   {
+      const TaskID task = ready.back();
+      ready.pop_back();
+      ++sorted;
+      for( auto successor = tasks_[ task ].successors.begin(); successor != tasks_[ task ].successors.end(); ++successor )
+         if( --predecessors[ *successor ] == uint_t(0) )
+            ready.push_back( *successor );
+   }
+
+   acyclic_ = ( sorted == tasks_.size() );
+   validated_ = true;
+   return acyclic_;
+}
+
+
+
+void TaskGraph::execute( const uint_t numberOfThreads )
+{
+   stolenTasks_ = uint_t(0);
+
+   const uint_t numberOfTasks = tasks_.size();
+   if( numberOfTasks == uint_t(0) )
+      return;
+
+   WALBERLA_CHECK( isAcyclic(), "The dependencies of the task graph contain a cycle!" );
+
+   const uint_t threads = std::max( numberOfThreads, uint_t(1) );
+   if( !pool_ || pool_->queues.size() != threads )
+      startThreads( threads );
+
+   Pool & pool = *pool_;
+
+   // the worker threads are not running, so the state can be reset without locking
+
+   pool.predecessors.reset( new std::atomic< uint_t >[ numberOfTasks ] );
+   for( TaskID task = 0; task != numberOfTasks; ++task )
+      pool.predecessors[ task ].store( tasks_[ task ].predecessors );
+   pool.numberOfTasks = numberOfTasks;
+
+   pool.ready.store( uint_t(0) );
+   pool.masterReady.store( uint_t(0) );
+   pool.finished.store( uint_t(0) );
+   pool.stolen.store( uint_t(0) );
+
+   // the tasks without predecessors are distributed round-robin
+
+   uint_t next( uint_t(0) );
+   for( TaskID task = 0; task != numberOfTasks; ++task )
+   {
+      if( tasks_[ task ].predecessors != uint_t(0) )
+         continue;
+      if( tasks_[ task ].masterOnly )
+      {
+         pool.masterQueue.push( task );
+         ++pool.masterReady;
+      }
+      else
+      {
+         pool.queues[ ( next++ ) % threads ]->tasks.push_back( task );
+         ++pool.ready;
+      }
+   }
+
+   {
+      std::lock_guard< std::mutex > lock( pool.mutex );
+      pool.running = true;
+      ++pool.execution;
+   }
+   pool.wakeup.notify_all();
+
+   work( uint_t(0) );
+
+   // the state must not be reset before all worker threads have left this execution
+   {
+      std::unique_lock< std::mutex > lock( pool.mutex );
+      pool.running = false;
+      pool.idle.wait( lock, [&pool]() { return pool.busy == uint_t(0); } );
+   }
+
+   stolenTasks_ = pool.stolen.load();
+}
+
+
+
+void TaskGraph::startThreads( const uint_t numberOfThreads )
+{
+   stopThreads();
+
+   pool_.reset( new Pool );
+   for( uint_t t = 0; t != numberOfThreads; ++t )
+      pool_->queues.push_back( std::unique_ptr< Pool::Queue >( new Pool::Queue ) );
+   for( uint_t t = 1; t < numberOfThreads; ++t )
+      pool_->threads.push_back( std::thread( &TaskGraph::workerThread, this, t ) );
+}
+
+
+
+void TaskGraph::stopThreads()
+{
+   if( !pool_ )
+      return;
+
+   {
+      std::lock_guard< std::mutex > lock( pool_->mutex );
+      pool_->shutdown = true;
+   }
+   pool_->wakeup.notify_all();
+
+   for( auto thread = pool_->threads.begin(); thread != pool_->threads.end(); ++thread )
+      thread->join();
+
+   pool_.reset();
+}
+
+
+
+/// main function of the worker threads: sleeps until execute() is called and takes part in the execution
+void TaskGraph::workerThread( const uint_t thread )
+{
+   Pool & pool = *pool_;
+
+   uint_t execution( uint_t(0) );
+   while( true )
+   {
+      {
+         std::unique_lock< std::mutex > lock( pool.mutex );
+         pool.wakeup.wait( lock, [&]() { return pool.shutdown || ( pool.running && pool.execution != execution ); } );
+         if( pool.shutdown )
+            return;
+         execution = pool.execution;
+         ++pool.busy;
+      }
+
+      work( thread );
+
+      bool last( false );
+      {
+         std::lock_guard< std::mutex > lock( pool.mutex );
+         last = ( --pool.busy == uint_t(0) );
+      }
+      if( last )
+         pool.idle.notify_one();
+   }
+}
+
+
+
+/// executes tasks until all tasks of the current execution are finished, sleeps if there is no ready task
+void TaskGraph::work( const uint_t thread )
+{
+   Pool & pool = *pool_;
+
+   while( pool.finished.load() < pool.numberOfTasks )
+   {
+      TaskID task;
+      if( !pop( thread, task ) )
+      {
+         std::unique_lock< std::mutex > lock( pool.mutex );
+         pool.wakeup.wait( lock, [&]() {
+            return pool.ready.load() > uint_t(0) || ( thread == uint_t(0) && pool.masterReady.load() > uint_t(0) ) ||
+                   pool.finished.load() == pool.numberOfTasks;
+         } );
+         continue;
+      }
+
+      tasks_[ task ].task();
+
+      for( auto successor = tasks_[ task ].successors.begin(); successor != tasks_[ task ].successors.end(); ++successor )
+         if( pool.predecessors[ *successor ].fetch_sub( uint_t(1) ) == uint_t(1) )
+            push( thread, *successor );
+
+      if( ++pool.finished == pool.numberOfTasks )
+      {
+         { std::lock_guard< std::mutex > lock( pool.mutex ); }
+         pool.wakeup.notify_all();
+      }
+   }
+}
+
+
+
+/// The 'ready' counters are incremented while holding the pool mutex, hence a thread that checked the counters before
+/// going to sleep is always woken up.
+void TaskGraph::push( const uint_t thread, const TaskID task )
+{
+   Pool & pool = *pool_;
+
+   if( tasks_[ task ].masterOnly )
+   {
+      {
+         std::lock_guard< std::mutex > lock( pool.masterMutex );
+         pool.masterQueue.push( task );
+      }
+      {
+         std::lock_guard< std::mutex > lock( pool.mutex );
+         ++pool.masterReady;
+      }
+      pool.wakeup.notify_all(); // only thread 0 can execute the task
+   }
+   else
+   {
+      {
+         std::lock_guard< std::mutex > lock( pool.queues[ thread ]->mutex );
+         pool.queues[ thread ]->tasks.push_back( task );
+      }
+      {
+         std::lock_guard< std::mutex > lock( pool.mutex );
+         ++pool.ready;
+      }
+      pool.wakeup.notify_one(); // every thread can execute (steal) the task
+   }
+}
+
+
+
+bool TaskGraph::pop( const uint_t thread, TaskID & task )
+{
+   Pool & pool = *pool_;
+   const uint_t threads = pool.queues.size();
+
+   if( thread == uint_t(0) ) // the master-only tasks usually communicate and are on the critical path
+   {
+      std::lock_guard< std::mutex > lock( pool.masterMutex );
+      if( !pool.masterQueue.empty() )
+      {
+         task = pool.masterQueue.top();
+         pool.masterQueue.pop();
+         --pool.masterReady;
+         return true;
+      }
+   }
+   {
+      std::lock_guard< std::mutex > lock( pool.queues[ thread ]->mutex );
+      if( !pool.queues[ thread ]->tasks.empty() )
+      {
+         task = pool.queues[ thread ]->tasks.back();
+         pool.queues[ thread ]->tasks.pop_back();
+         --pool.ready;
+         return true;
+      }
+   }
+   for( uint_t t = 1; t < threads; ++t )
+   {
+      Pool::Queue & victim = *( pool.queues[ ( thread + t ) % threads ] );
+      std::lock_guard< std::mutex > lock( victim.mutex );
+      if( !victim.tasks.empty() )
+      {
+         task = victim.tasks.front();
+         victim.tasks.pop_front();
+         --pool.ready;
+         ++pool.stolen;
+         return true;
+      }
+   }
+   return false;
+}
+
+
+
+void TaskGraph::clear()
+{
+   tasks_.clear();
+   acyclic_ = true;
+   validated_ = true;
+   stolenTasks_ = uint_t(0);
+}
+
+
+
+} // namespace walberla
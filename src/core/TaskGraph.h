@@ -0,0 +1,128 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file TaskGraph.h
+//! \ingroup core
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "DataTypes.h"
+#include "NonCopyable.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace walberla {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Directed acyclic graph of tasks that is executed by a work-stealing thread pool
+*
+*   Tasks are added with addTask(), the order in which they must be executed is specified with addDependency(). A task
+*   is started as soon as all of its predecessors are finished. execute() runs all tasks exactly once and can be called
+*   repeatedly (e.g., once per time step) - the graph is only built once.
+*
+*   Every thread owns a task queue. Tasks that become ready are pushed to the queue of the thread that finished the
+*   last predecessor and this thread continues with the most recently pushed task (good cache locality along chains
+*   of dependent tasks). Threads without work steal the oldest task from the queue of another thread.
+*
+*   Tasks marked as 'masterOnly' are only executed by the thread that called execute(). This is required for all
+*   tasks that communicate via MPI (MPI is initialized with MPI_THREAD_FUNNELED at best, see mpi::Environment). The
+*   master-only tasks are executed in the order in which they become ready, ties are resolved by the order in which
+*   they were added. If every master-only task depends on the previously added master-only task, all processes
+*   execute their communication in the same order.
+*
+*   The calling thread takes part in the execution, i.e., execute( 1 ) runs all tasks sequentially without spawning
+*   any threads. The other threads are started by the first call of execute() and are kept alive until the graph is
+*   destroyed (or until execute() is called with a different number of threads). Threads without work, both during
+*   and between the calls of execute(), sleep on a condition variable instead of polling. Tasks must not throw
+*   exceptions.
+*/
+//**********************************************************************************************************************
+class TaskGraph : public NonCopyable
+{
+public:
+
+   typedef std::function< void () > Task;
+   typedef uint_t TaskID;
+
+   TaskGraph();
+   ~TaskGraph();
+
+   TaskID addTask( const Task & task, const bool masterOnly = false );
+
+   /// 'successor' is not started before 'predecessor' is finished (duplicate dependencies are ignored)
+   void addDependency( const TaskID predecessor, const TaskID successor );
+
+   uint_t numberOfTasks() const { return tasks_.size(); }
+   uint_t numberOfDependencies() const;
+
+   bool isMasterOnly( const TaskID task ) const { return tasks_[ task ].masterOnly; }
+   const std::vector< TaskID > & successors( const TaskID task ) const { return tasks_[ task ].successors; }
+
+   /// checks whether the dependencies contain a cycle (in which case execute() would never return)
+   bool isAcyclic() const;
+
+   /// executes all tasks with 'numberOfThreads' threads (including the calling thread) and returns once all tasks are
+   /// finished
+   void execute( const uint_t numberOfThreads = uint_t(1) );
+
+   /// number of tasks that were stolen from the queue of another thread during the last call of execute()
+   uint_t stolenTasks() const { return stolenTasks_; }
+
+   void clear();
+
+private:
+
+   struct Node
+   {
+      Node( const Task & _task, const bool _masterOnly ) : task( _task ), masterOnly( _masterOnly ), predecessors( uint_t(0) ) {}
+
+      Task task;
+      bool masterOnly;
+      std::vector< TaskID > successors;
+      uint_t predecessors;
+   };
+
+   struct Pool;
+
+   void startThreads( const uint_t numberOfThreads );
+   void stopThreads();
+
+   void workerThread( const uint_t thread );
+   void work( const uint_t thread );
+
+   void push( const uint_t thread, const TaskID task );
+   bool pop( const uint_t thread, TaskID & task );
+
+   std::vector< Node > tasks_;
+
+   std::unique_ptr< Pool > pool_; ///< worker threads and the state of the current execution
+
+   mutable bool acyclic_;
+   mutable bool validated_;
+
+   uint_t stolenTasks_;
+};
+
+
+
+} // namespace walberla
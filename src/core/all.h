@@ -39,6 +39,7 @@
 #include "Set.h"
 #include "SharedFunctor.h"
 #include "Sleep.h"
+#include "TaskGraph.h"
 #include "VectorTrait.h"
 
 #include "cell/all.h"
@@ -0,0 +1,174 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LosslessCompression.cpp
+//! \ingroup core
+//
+//======================================================================================================================
+
+#include "LosslessCompression.h"
+
+#include "core/Abort.h"
+#include "core/debug/Debug.h"
+
+#include <algorithm>
+
+
+namespace walberla {
+namespace compression {
+
+
+namespace internal {
+
+const uint_t HEADER_SIZE = uint_t(9); // 8 bytes original size + 1 byte element size
+
+const uint_t MAX_RUN     = uint_t(130); // runs of 3 to 130 equal bytes:  control byte 0x80 | ( length - 3 )
+const uint_t MAX_LITERAL = uint_t(128); // 1 to 128 literal bytes:        control byte length - 1
+
+void encodeRLE( const std::vector< uint8_t > & in, std::vector< uint8_t > & out )
+{
+   uint_t i = 0;
+   uint_t literalBegin = 0;
+
+   auto flushLiterals = [&]( const uint_t end ) {
+      while( literalBegin < end )
+      {
+         const uint_t n = std::min( end - literalBegin, MAX_LITERAL );
+         out.push_back( uint8_c( n - uint_t(1) ) );
+         out.insert( out.end(), in.begin() + numeric_cast< std::ptrdiff_t >( literalBegin ), in.begin() + numeric_cast< std::ptrdiff_t >( literalBegin + n ) );
+         literalBegin += n;
+      }
+   };
+
+   while( i < in.size() )
+   {
+      uint_t run = 1;
+      while( i + run < in.size() && run < MAX_RUN && in[ i + run ] == in[i] )
+         ++run;
+
+      if( run >= uint_t(3) )
+      {
+         flushLiterals( i );
+         out.push_back( uint8_c( uint_t(0x80) | ( run - uint_t(3) ) ) );
+         out.push_back( in[i] );
+         i += run;
+         literalBegin = i;
+      }
+      else
+      {
+         i += run;
+      }
+   }
+   flushLiterals( in.size() );
+}
+
+void decodeRLE( const uint8_t * in, const uint_t size, std::vector< uint8_t > & out )
+{
+   uint_t i = 0;
+   while( i < size )
+   {
+      const uint_t control = in[i++];
+      if( control & uint_t(0x80) )
+      {
+         if( i >= size )
+            WALBERLA_ABORT( "Decompression failed: corrupt data" );
+         out.insert( out.end(), ( control & uint_t(0x7f) ) + uint_t(3), in[i++] );
+      }
+      else
+      {
+         const uint_t n = control + uint_t(1);
+         if( i + n > size )
+            WALBERLA_ABORT( "Decompression failed: corrupt data" );
+         out.insert( out.end(), in + i, in + i + n );
+         i += n;
+      }
+   }
+}
+
+} // namespace internal
+
+
+
+void compress( const uint8_t * data, const uint_t size, const uint_t elementSize, std::vector< uint8_t > & compressed )
+{
+   WALBERLA_ASSERT_GREATER( elementSize, uint_t(0) );
+   WALBERLA_ASSERT_LESS( elementSize, uint_t(256) );
+
+   const uint_t elements = size / elementSize;
+
+   // XOR with predecessor + byte plane shuffle
+
+   std::vector< uint8_t > shuffled( size );
+   for( uint_t e = 0; e != elements; ++e )
+   {
+      for( uint_t b = 0; b != elementSize; ++b )
+      {
+         const uint8_t value = data[ e * elementSize + b ];
+         const uint8_t previous = ( e == 0 ) ? uint8_t(0) : data[ ( e - uint_t(1) ) * elementSize + b ];
+         shuffled[ b * elements + e ] = uint8_c( value ^ previous );
+      }
+   }
+   for( uint_t i = elements * elementSize; i != size; ++i )
+      shuffled[i] = data[i];
+
+   compressed.clear();
+   compressed.reserve( internal::HEADER_SIZE + size / uint_t(4) );
+
+   uint64_t originalSize = size;
+   for( uint_t i = 0; i != 8; ++i )
+      compressed.push_back( uint8_c( ( originalSize >> ( 8 * i ) ) & uint64_t(0xff) ) );
+   compressed.push_back( uint8_c( elementSize ) );
+
+   internal::encodeRLE( shuffled, compressed );
+}
+
+
+
+void decompress( const uint8_t * data, const uint_t size, std::vector< uint8_t > & decompressed )
+{
+   if( size < internal::HEADER_SIZE )
+      WALBERLA_ABORT( "Decompression failed: corrupt data" );
+
+   uint64_t originalSize = 0;
+   for( uint_t i = 0; i != 8; ++i )
+      originalSize |= uint64_c( data[i] ) << ( 8 * i );
+   const uint_t elementSize = data[8];
+
+   std::vector< uint8_t > shuffled;
+   shuffled.reserve( uint_c( originalSize ) );
+   internal::decodeRLE( data + internal::HEADER_SIZE, size - internal::HEADER_SIZE, shuffled );
+
+   if( shuffled.size() != originalSize || elementSize == uint_t(0) )
+      WALBERLA_ABORT( "Decompression failed: corrupt data" );
+
+   const uint_t elements = shuffled.size() / elementSize;
+
+   decompressed.resize( shuffled.size() );
+   for( uint_t e = 0; e != elements; ++e )
+   {
+      for( uint_t b = 0; b != elementSize; ++b )
+      {
+         const uint8_t previous = ( e == 0 ) ? uint8_t(0) : decompressed[ ( e - uint_t(1) ) * elementSize + b ];
+         decompressed[ e * elementSize + b ] = uint8_c( shuffled[ b * elements + e ] ^ previous );
+      }
+   }
+   for( uint_t i = elements * elementSize; i != shuffled.size(); ++i )
+      decompressed[i] = shuffled[i];
+}
+
+
+
+} // namespace compression
+} // namespace walberla
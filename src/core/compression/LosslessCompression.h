@@ -0,0 +1,50 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LosslessCompression.h
+//! \ingroup core
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "core/DataTypes.h"
+
+#include <vector>
+
+
+namespace walberla {
+namespace compression {
+
+
+/*! Lossless compression of binary data that mostly consists of floating point values (e.g. serialized fields)
+*
+* The data is interpreted as a sequence of elements of size 'elementSize'. Each element is XORed with its predecessor,
+* which - for smooth data - turns the sign, exponent and leading mantissa bits into zeros. Afterwards, the bytes are
+* reordered such that all first bytes of the elements are stored consecutively, followed by all second bytes, and so
+* on. The resulting byte planes contain long runs of equal bytes, which are finally run-length encoded.
+* Trailing bytes that do not form a complete element are stored unmodified.
+*
+* The compressed data is self-describing: decompress() does not need to know the element size or the original size.
+*/
+void compress( const uint8_t * data, const uint_t size, const uint_t elementSize, std::vector< uint8_t > & compressed );
+
+/// Inverse of compress(), 'decompressed' is resized to the original size
+void decompress( const uint8_t * data, const uint_t size, std::vector< uint8_t > & decompressed );
+
+
+
+} // namespace compression
+} // namespace walberla
@@ -0,0 +1,267 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LossyCompression.cpp
+//! \ingroup core
+//
+//======================================================================================================================
+
+#include "LossyCompression.h"
+#include "LosslessCompression.h"
+
+#include "core/Abort.h"
+#include "core/debug/Debug.h"
+
+#include <cstring>
+
+
+namespace walberla {
+namespace compression {
+
+
+namespace internal {
+
+// header: element size (1 byte), x/y/z size and tolerance (8 bytes each), size of the compressed codes (8 bytes)
+const uint_t LOSSY_HEADER_SIZE = uint_t(41);
+
+const int64_t MAX_CODE = int64_t(1) << 40; // larger quantization codes are stored as unmodified values
+
+void appendUInt64( std::vector< uint8_t > & out, const uint64_t value )
+{
+   for( uint_t i = 0; i != 8; ++i )
+      out.push_back( uint8_c( ( value >> ( 8 * i ) ) & uint64_t(0xff) ) );
+}
+
+uint64_t readUInt64( const uint8_t * in )
+{
+   uint64_t value = 0;
+   for( uint_t i = 0; i != 8; ++i )
+      value |= uint64_c( in[i] ) << ( 8 * i );
+   return value;
+}
+
+// codes: 0 = unmodified value, otherwise 1 + zigzag encoded quantization code (7 bits per byte)
+void appendCode( std::vector< uint8_t > & out, uint64_t code )
+{
+   while( code >= uint64_t(0x80) )
+   {
+      out.push_back( uint8_c( ( code & uint64_t(0x7f) ) | uint64_t(0x80) ) );
+      code >>= 7;
+   }
+   out.push_back( uint8_c( code ) );
+}
+
+uint64_t readCode( const std::vector< uint8_t > & in, uint_t & pos )
+{
+   uint64_t code = 0;
+   for( uint_t shift = 0; ; shift += 7 )
+   {
+      if( pos >= in.size() || shift > 63 )
+         WALBERLA_ABORT( "Decompression failed: corrupt data" );
+      const uint64_t byte = in[ pos++ ];
+      code |= ( byte & uint64_t(0x7f) ) << shift;
+      if( !( byte & uint64_t(0x80) ) )
+         return code;
+   }
+}
+
+/// Lorenzo predictor: exact for functions that are linear in each coordinate direction, values outside the array are 0
+template< typename T >
+double predict( const std::vector< T > & r, const uint_t x, const uint_t y, const uint_t z, const uint_t xSize, const uint_t ySize )
+{
+   const uint_t sy = xSize;
+   const uint_t sz = xSize * ySize;
+   const uint_t i  = x + y * sy + z * sz;
+
+   auto value = [&]( const bool inside, const uint_t j ) { return inside ? double_c( r[j] ) : 0.0; };
+
+   const bool bx = x > uint_t(0);
+   const bool by = y > uint_t(0);
+   const bool bz = z > uint_t(0);
+
+   return value( bx, i - 1 ) + value( by, i - sy ) + value( bz, i - sz )
+        - value( bx && by, i - 1 - sy ) - value( bx && bz, i - 1 - sz ) - value( by && bz, i - sy - sz )
+        + value( bx && by && bz, i - 1 - sy - sz );
+}
+
+template< typename T >
+T reconstruct( const double prediction, const int64_t code, const double step )
+{
+   return T( prediction + double_c( code ) * step );
+}
+
+} // namespace internal
+
+
+
+std::ostream & operator<<( std::ostream & os, const ErrorBound & errorBound )
+{
+   os << errorBound.tolerance << ( errorBound.mode == ErrorBound::ABSOLUTE ? " (absolute)" : " (relative to value range)" );
+   return os;
+}
+
+
+
+ErrorBound getErrorBound( const Config::BlockHandle & block, const std::string & identifier, const ErrorBound & defaultErrorBound )
+{
+   if( !block )
+      return defaultErrorBound;
+
+   if( block.isDefined( identifier ) )
+      return ErrorBound( block.getParameter< double >( identifier ) );
+
+   Config::BlockHandle item = block.getBlock( identifier );
+   if( !item )
+      return defaultErrorBound;
+
+   const std::string mode = item.getParameter< std::string >( "mode", std::string( "absolute" ) );
+   if( mode != "absolute" && mode != "relative" )
+      WALBERLA_ABORT( "Invalid error bound mode \"" << mode << "\" for \"" << identifier << "\" (valid modes: absolute, relative)" );
+
+   return ErrorBound( item.getParameter< double >( "tolerance" ), mode == "absolute" ? ErrorBound::ABSOLUTE : ErrorBound::RELATIVE );
+}
+
+
+
+template< typename T >
+void compressLossy( const T * data, const uint_t xSize, const uint_t ySize, const uint_t zSize, const double tolerance,
+                    std::vector< uint8_t > & compressed )
+{
+   const uint_t size = xSize * ySize * zSize;
+   const double step = 2.0 * tolerance;
+
+   std::vector< T > reconstructed( size );
+   std::vector< uint8_t > codes;
+   std::vector< T > unmodified;
+   codes.reserve( size );
+
+   uint_t i = 0;
+   for( uint_t z = 0; z != zSize; ++z )
+      for( uint_t y = 0; y != ySize; ++y )
+         for( uint_t x = 0; x != xSize; ++x, ++i )
+         {
+            const double value = double_c( data[i] );
+            bool valid = false;
+
+            if( tolerance > 0.0 && std::isfinite( value ) )
+            {
+               const double prediction = internal::predict( reconstructed, x, y, z, xSize, ySize );
+               const double q = std::round( ( value - prediction ) / step );
+               if( std::abs( q ) < double_c( internal::MAX_CODE ) )
+               {
+                  const int64_t code = int64_c( q );
+                  const T r = internal::reconstruct< T >( prediction, code, step );
+                  if( std::abs( double_c( r ) - value ) <= tolerance )
+                  {
+                     reconstructed[i] = r;
+                     internal::appendCode( codes, uint64_t(1) + ( code >= 0 ? uint64_c( code ) << 1 : ( uint64_c( -code ) << 1 ) - uint64_t(1) ) );
+                     valid = true;
+                  }
+               }
+            }
+
+            if( !valid )
+            {
+               reconstructed[i] = data[i];
+               unmodified.push_back( data[i] );
+               internal::appendCode( codes, uint64_t(0) );
+            }
+         }
+
+   std::vector< uint8_t > encodedCodes;
+   compress( codes.empty() ? nullptr : &(codes[0]), uint_c( codes.size() ), uint_t(1), encodedCodes );
+
+   compressed.clear();
+   compressed.reserve( internal::LOSSY_HEADER_SIZE + encodedCodes.size() + unmodified.size() * sizeof(T) );
+   compressed.push_back( uint8_c( sizeof(T) ) );
+   internal::appendUInt64( compressed, uint64_c( xSize ) );
+   internal::appendUInt64( compressed, uint64_c( ySize ) );
+   internal::appendUInt64( compressed, uint64_c( zSize ) );
+   uint64_t toleranceBits;
+   std::memcpy( &toleranceBits, &tolerance, sizeof( double ) );
+   internal::appendUInt64( compressed, toleranceBits );
+   internal::appendUInt64( compressed, uint64_c( encodedCodes.size() ) );
+   compressed.insert( compressed.end(), encodedCodes.begin(), encodedCodes.end() );
+   if( !unmodified.empty() )
+   {
+      const uint8_t * bytes = reinterpret_cast< const uint8_t * >( &(unmodified[0]) );
+      compressed.insert( compressed.end(), bytes, bytes + unmodified.size() * sizeof(T) );
+   }
+}
+
+
+
+template< typename T >
+void decompressLossy( const uint8_t * data, const uint_t size, std::vector< T > & decompressed )
+{
+   if( size < internal::LOSSY_HEADER_SIZE || data[0] != sizeof(T) )
+      WALBERLA_ABORT( "Decompression failed: corrupt data or wrong data type" );
+
+   const uint_t xSize = uint_c( internal::readUInt64( data + 1 ) );
+   const uint_t ySize = uint_c( internal::readUInt64( data + 9 ) );
+   const uint_t zSize = uint_c( internal::readUInt64( data + 17 ) );
+   const uint64_t toleranceBits = internal::readUInt64( data + 25 );
+   double tolerance;
+   std::memcpy( &tolerance, &toleranceBits, sizeof( double ) );
+   const uint_t codesSize = uint_c( internal::readUInt64( data + 33 ) );
+
+   if( internal::LOSSY_HEADER_SIZE + codesSize > size )
+      WALBERLA_ABORT( "Decompression failed: corrupt data" );
+
+   std::vector< uint8_t > codes;
+   decompress( data + internal::LOSSY_HEADER_SIZE, codesSize, codes );
+
+   const uint8_t * unmodified    = data + internal::LOSSY_HEADER_SIZE + codesSize;
+   const uint8_t * unmodifiedEnd = data + size;
+
+   const double step = 2.0 * tolerance;
+
+   decompressed.resize( xSize * ySize * zSize );
+
+   uint_t pos = 0;
+   uint_t i = 0;
+   for( uint_t z = 0; z != zSize; ++z )
+      for( uint_t y = 0; y != ySize; ++y )
+         for( uint_t x = 0; x != xSize; ++x, ++i )
+         {
+            const uint64_t code = internal::readCode( codes, pos );
+            if( code == uint64_t(0) )
+            {
+               if( unmodified + sizeof(T) > unmodifiedEnd )
+                  WALBERLA_ABORT( "Decompression failed: corrupt data" );
+               std::memcpy( &(decompressed[i]), unmodified, sizeof(T) );
+               unmodified += sizeof(T);
+            }
+            else
+            {
+               const uint64_t zigzag = code - uint64_t(1);
+               const int64_t q = ( zigzag & uint64_t(1) ) ? -int64_c( ( zigzag + uint64_t(1) ) >> 1 ) : int64_c( zigzag >> 1 );
+               decompressed[i] = internal::reconstruct< T >( internal::predict( decompressed, x, y, z, xSize, ySize ), q, step );
+            }
+         }
+}
+
+
+
+template void compressLossy< float  >( const float  *, const uint_t, const uint_t, const uint_t, const double, std::vector< uint8_t > & );
+template void compressLossy< double >( const double *, const uint_t, const uint_t, const uint_t, const double, std::vector< uint8_t > & );
+
+template void decompressLossy< float  >( const uint8_t *, const uint_t, std::vector< float  > & );
+template void decompressLossy< double >( const uint8_t *, const uint_t, std::vector< double > & );
+
+
+
+} // namespace compression
+} // namespace walberla
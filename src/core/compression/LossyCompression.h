@@ -0,0 +1,137 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LossyCompression.h
+//! \ingroup core
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "core/DataTypes.h"
+#include "core/config/Config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace walberla {
+namespace compression {
+
+
+
+/*! Maximum pointwise error that is allowed for lossy compression
+*
+* The tolerance is either an absolute value or relative to the value range (maximum - minimum) of the data that is
+* compressed. A tolerance of zero means lossless.
+*/
+struct ErrorBound
+{
+   enum Mode { ABSOLUTE, RELATIVE };
+
+   ErrorBound() : tolerance( 0.0 ), mode( ABSOLUTE ) {}
+   ErrorBound( const double _tolerance, const Mode _mode = ABSOLUTE ) : tolerance( _tolerance ), mode( _mode ) {}
+
+   /// absolute tolerance for the 'size' values stored at 'data'
+   template< typename T >
+   double absoluteTolerance( const T * data, const uint_t size ) const;
+
+   double tolerance;
+   Mode mode;
+};
+
+std::ostream & operator<<( std::ostream & os, const ErrorBound & errorBound );
+
+/*! Reads the error bound of the data item 'identifier' from the configuration block 'block'
+*
+* The error bound is either given as a parameter (absolute tolerance) or as a block:
+* \code
+*  LossyCompression
+*  {
+*     density 1e-6;                               // absolute error
+*     velocity { tolerance 1e-3; mode relative; } // error relative to the value range
+*  }
+* \endcode
+* If 'block' is invalid or does not contain 'identifier', 'defaultErrorBound' is returned.
+*/
+ErrorBound getErrorBound( const Config::BlockHandle & block, const std::string & identifier,
+                          const ErrorBound & defaultErrorBound = ErrorBound() );
+
+
+
+/*! Error-bounded lossy compression of a three-dimensional array of floating point values (float or double)
+*
+* Every value is predicted from its already reconstructed neighbors (Lorenzo predictor, x varies fastest). The
+* prediction error is quantized with a step size of twice the absolute tolerance, i.e., every reconstructed value
+* differs by at most 'tolerance' from the original value. Values for which this cannot be guaranteed (non-finite
+* values, rounding errors, very large prediction errors, tolerance zero) are stored unmodified. The quantization codes
+* are variable-length encoded and finally compressed with the lossless compression of compression::compress, which
+* collapses the long runs of identical codes that occur in smooth regions.
+*
+* The compressed data is self-describing: decompressLossy() does not need to know the size of the array.
+*/
+template< typename T >
+void compressLossy( const T * data, const uint_t xSize, const uint_t ySize, const uint_t zSize, const double tolerance,
+                    std::vector< uint8_t > & compressed );
+
+/// Inverse of compressLossy(), 'decompressed' is resized to the size of the array
+template< typename T >
+void decompressLossy( const uint8_t * data, const uint_t size, std::vector< T > & decompressed );
+
+
+
+/// Rounds 'value' to a multiple of the largest power of two that does not exceed twice the tolerance (the error is at
+/// most 'tolerance'). The trailing mantissa bits of the result are zero, which makes the data much better compressible
+/// with general-purpose compressors (e.g., zlib for VTK output).
+template< typename T >
+inline T quantize( const T value, const double tolerance )
+{
+   if( !( tolerance > 0.0 ) || !std::isfinite( value ) )
+      return value;
+
+   int exponent;
+   std::frexp( 2.0 * tolerance, &exponent );
+   const T step = T( std::ldexp( 1.0, exponent - 1 ) );
+   if( !( step > T(0) ) )
+      return value;
+   const T result = std::round( value / step ) * step;
+   return std::isfinite( result ) ? result : value;
+}
+
+
+
+template< typename T >
+double ErrorBound::absoluteTolerance( const T * data, const uint_t size ) const
+{
+   if( mode == ABSOLUTE || size == uint_t(0) )
+      return tolerance;
+
+   double min = double_c( data[0] );
+   double max = double_c( data[0] );
+   for( uint_t i = 1; i < size; ++i )
+   {
+      min = std::min( min, double_c( data[i] ) );
+      max = std::max( max, double_c( data[i] ) );
+   }
+   return std::isfinite( max - min ) ? tolerance * ( max - min ) : 0.0;
+}
+
+
+
+} // namespace compression
+} // namespace walberla
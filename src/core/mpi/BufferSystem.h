@@ -105,6 +105,18 @@ class GenericOpenMPBufferSystem;
 * When running multiple BufferSystems concurrently different MPI tags have to be used
 * for the systems: the tag can be passed in the constructor.
 *
+*
+* Persistent Requests:
+* --------------------
+*
+* For communication patterns that stay the same for many communication steps (same communication partners and
+* constant message sizes, e.g., ghost layer exchange between load balancing steps), usePersistentRequests( true )
+* can be called. As soon as the message sizes are known (i.e., after the first exchange if the sizes are not known in
+* advance), MPI_Send_init / MPI_Recv_init requests are created for the Send- and RecvBuffers, which keep their memory
+* between communication steps. In all following steps, these requests are only restarted instead of posting new
+* MPI_Isend / MPI_Irecv calls. The requests are freed (and recreated when needed) whenever the receiver information
+* is changed via setReceiverInfo*() or sizeHasChanged(). If a SendBuffer is reallocated or the size of an outgoing
+* message changes, only the affected request is recreated.
 */
 //**********************************************************************************************************************
 template< typename RecvBuffer_T = RecvBuffer, typename SendBuffer_T = SendBuffer>
@@ -135,6 +147,8 @@ public:
    void setReceiverInfoFromSendBufferState( bool useSizeFromSendBuffers, bool changingSize );
 
    void sizeHasChanged( bool alwaysChangingSize = false );
+
+   void usePersistentRequests( bool use );
    //@}
    //*******************************************************************************************************************
 
@@ -192,6 +206,7 @@ public:
    bool isSizeCommunicatedInNextStep() const { return (currentComm_ == &unknownSizeComm_); }
    bool isCommunciationRunning() const       { return communicationRunning_;               }
    bool isReceiverInformationSet() const     { return currentComm_ != NULL;                }
+   bool arePersistentRequestsUsed() const    { return usePersistentRequests_;              }
    //@}
    //*******************************************************************************************************************
 
@@ -231,10 +246,12 @@ protected:
    internal::KnownSizeCommunication<RecvBuffer_T, SendBuffer_T>   knownSizeComm_;
    internal::UnknownSizeCommunication<RecvBuffer_T, SendBuffer_T> unknownSizeComm_;
    internal::NoMPICommunication<RecvBuffer_T, SendBuffer_T>       noMPIComm_;
-   internal::AbstractCommunication<RecvBuffer_T, SendBuffer_T> *  currentComm_;  //< after receiver setup, this points to unknown- or knownSizeComm_
+   internal::PersistentCommunication<RecvBuffer_T, SendBuffer_T>  persistentComm_;
+   internal::AbstractCommunication<RecvBuffer_T, SendBuffer_T> *  currentComm_;  //< after receiver setup, this points to unknown-, knownSize- or persistentComm_
 
    bool sizeChangesEverytime_; //< if set to true, the receiveSizeUnknown_ is set to true before communicating
    bool communicationRunning_; //< indicates if a communication step is currently running
+   bool usePersistentRequests_; //< if set to true, persistentComm_ is used instead of knownSizeComm_
 
 
    /// Info about the message to be received from a certain rank:
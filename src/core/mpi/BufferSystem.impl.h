@@ -92,6 +92,8 @@ void GenericBufferSystem<Rb, Sb>::setReceiverInfo( RankIter rankBegin, RankIter
 {
    WALBERLA_ASSERT( ! communicationRunning_ );
 
+   persistentComm_.freeRequests();
+
    recvInfos_.clear();
    for ( auto it = rankBegin; it != rankEnd; ++it )
    {
@@ -128,9 +130,11 @@ GenericBufferSystem<Rb, Sb>::GenericBufferSystem( const MPI_Comm & communicator,
    : knownSizeComm_  ( communicator, tag ),
      unknownSizeComm_( communicator, tag ),
      noMPIComm_( communicator, tag ),
+     persistentComm_( communicator, tag ),
      currentComm_    ( nullptr ),
      sizeChangesEverytime_( true ),
-     communicationRunning_( false )
+     communicationRunning_( false ),
+     usePersistentRequests_( false )
 {
 }
 
@@ -139,9 +143,11 @@ GenericBufferSystem<Rb, Sb>::GenericBufferSystem( const GenericBufferSystem &oth
    : knownSizeComm_  ( other.knownSizeComm_.getCommunicator(), other.knownSizeComm_.getTag() ),
      unknownSizeComm_( other.knownSizeComm_.getCommunicator(), other.knownSizeComm_.getTag() ),
      noMPIComm_      ( other.knownSizeComm_.getCommunicator(), other.knownSizeComm_.getTag() ),
+     persistentComm_ ( other.knownSizeComm_.getCommunicator(), other.knownSizeComm_.getTag() ),
      currentComm_ ( nullptr ),
      sizeChangesEverytime_( other.sizeChangesEverytime_ ),
      communicationRunning_( other.communicationRunning_ ),
+     usePersistentRequests_( other.usePersistentRequests_ ),
      recvInfos_( other.recvInfos_ ),
      sendInfos_( other.sendInfos_ )
 {
@@ -152,6 +158,8 @@ GenericBufferSystem<Rb, Sb>::GenericBufferSystem( const GenericBufferSystem &oth
       currentComm_ = &unknownSizeComm_;
    else if ( other.currentComm_ == &other.noMPIComm_ )
       currentComm_ = &noMPIComm_;
+   else if ( other.currentComm_ == &other.persistentComm_ )
+      currentComm_ = &persistentComm_;
    else
       currentComm_ = nullptr; // receiver information not yet set
 }
@@ -161,8 +169,11 @@ GenericBufferSystem<Rb, Sb> & GenericBufferSystem<Rb, Sb>::operator=( const Gene
 {
    WALBERLA_ASSERT( !communicationRunning_, "Can't copy GenericBufferSystem while communication is running" );
 
+   persistentComm_.freeRequests(); // buffers are replaced below
+
    sizeChangesEverytime_ = other.sizeChangesEverytime_;
    communicationRunning_ = other.communicationRunning_;
+   usePersistentRequests_ = other.usePersistentRequests_;
    recvInfos_ = other.recvInfos_;
    sendInfos_ = other.sendInfos_;
 
@@ -172,6 +183,8 @@ GenericBufferSystem<Rb, Sb> & GenericBufferSystem<Rb, Sb>::operator=( const Gene
       currentComm_ = &unknownSizeComm_;
    else if ( other.currentComm_ == &other.noMPIComm_ )
       currentComm_ = &noMPIComm_;
+   else if ( other.currentComm_ == &other.persistentComm_ )
+      currentComm_ = &persistentComm_;
    else
       currentComm_ = nullptr; // receiver information not yet set
 
@@ -200,6 +213,8 @@ void GenericBufferSystem<Rb, Sb>::setReceiverInfo( const std::set<MPIRank> & ran
 {
    WALBERLA_ASSERT( ! communicationRunning_ );
 
+   persistentComm_.freeRequests();
+
    recvInfos_.clear();
    for ( auto it = ranksToRecvFrom.begin(); it != ranksToRecvFrom.end(); ++it )
    {
@@ -227,6 +242,8 @@ void GenericBufferSystem<Rb, Sb>::setReceiverInfo( const std::map<MPIRank,MPISiz
 {
    WALBERLA_ASSERT( ! communicationRunning_ );
 
+   persistentComm_.freeRequests();
+
    recvInfos_.clear();
    for ( auto it = ranksToRecvFrom.begin(); it != ranksToRecvFrom.end(); ++it )
    {
@@ -265,6 +282,8 @@ void GenericBufferSystem<Rb, Sb>::setReceiverInfoFromSendBufferState( bool useSi
 {
    WALBERLA_ASSERT( ! communicationRunning_ );
 
+   persistentComm_.freeRequests();
+
    recvInfos_.clear();
    for ( auto it = sendInfos_.begin(); it != sendInfos_.end(); ++it )
    {
@@ -299,12 +318,40 @@ void GenericBufferSystem<Rb, Sb>::sizeHasChanged( bool alwaysChangingSize )
 {
    WALBERLA_ASSERT( ! communicationRunning_ );
 
+   persistentComm_.freeRequests();
+
    sizeChangesEverytime_ = alwaysChangingSize;
    setCommunicationType( false );
 }
 
 
 
+//**********************************************************************************************************************
+/*! Enables/disables persistent MPI requests for communication steps where the message sizes are known
+*
+* Intended for fixed communication patterns: the requests are created once and reused in all following communication
+* steps until the receiver information is changed with setReceiverInfo*() or sizeHasChanged().
+* Can only be called if no communication is currently running.
+*
+* \param use  if true, MPI_Send_init / MPI_Recv_init requests are used instead of MPI_Isend / MPI_Irecv
+*/
+//**********************************************************************************************************************
+template< typename Rb, typename Sb>
+void GenericBufferSystem<Rb, Sb>::usePersistentRequests( bool use )
+{
+   WALBERLA_ASSERT( ! communicationRunning_ );
+
+   if( !use )
+      persistentComm_.freeRequests();
+
+   usePersistentRequests_ = use;
+
+   if( currentComm_ == &knownSizeComm_ || currentComm_ == &persistentComm_ )
+      setCommunicationType( true );
+}
+
+
+
 //======================================================================================================================
 //
 //  Step 1: Schedule Receives and ISends
@@ -507,7 +554,7 @@ void GenericBufferSystem<Rb, Sb>::setCommunicationType( const bool knownSize )
    WALBERLA_MPI_SECTION()
    {
       if( knownSize )
-         currentComm_ = &knownSizeComm_;
+         currentComm_ = usePersistentRequests_ ? static_cast< internal::AbstractCommunication<Rb, Sb> * >( &persistentComm_ ) : &knownSizeComm_;
       else
          currentComm_ = &unknownSizeComm_;
    }
@@ -129,6 +129,63 @@ namespace internal {
    };
 
 
+   /*****************************************************************************************************************//**
+   * Known size communication that uses persistent requests (MPI_Send_init / MPI_Recv_init)
+   *
+   * The requests are created once per communication partner and are restarted with MPI_Start / MPI_Startall in all
+   * following communication steps. A request is only recreated if the memory or the size of the corresponding buffer
+   * has changed. Since Send- and RecvBuffers keep their memory when they are cleared, this is only the case if a
+   * message grows beyond the capacity of its buffer or if the message size changes.
+   * All requests are freed by freeRequests(), which has to be called whenever the set of communication partners
+   * changes.
+   *********************************************************************************************************************/
+   template< typename RecvBuffer_T, typename SendBuffer_T>
+   class PersistentCommunication : public AbstractCommunication<RecvBuffer_T, SendBuffer_T>
+   {
+   public:
+      using typename AbstractCommunication<RecvBuffer_T, SendBuffer_T>::ReceiveInfo;
+
+      PersistentCommunication( const MPI_Comm & communicator, int tag = 0 )
+           : AbstractCommunication<RecvBuffer_T, SendBuffer_T>( communicator, tag ), sending_(false), receiving_(false) {}
+
+      virtual ~PersistentCommunication() { freeRequests(); }
+
+      virtual void send( MPIRank receiver, const SendBuffer_T & sendBuffer );
+      virtual void waitForSends();
+
+      virtual void    scheduleReceives  ( std::map<MPIRank, ReceiveInfo> & recvInfos );
+
+      /// size field of recvInfos is expected to be valid
+      virtual MPIRank waitForNextReceive( std::map<MPIRank, ReceiveInfo> & recvInfos );
+
+      /// frees all persistent requests, must not be called while a communication is running
+      void freeRequests();
+
+      size_t numberOfPersistentRequests() const { return sendRequests_.size() + recvRequests_.size(); }
+
+   private:
+
+      /// message a persistent request was created for
+      struct RequestInfo {
+         RequestInfo( MPIRank _rank, void * _ptr, MPISize _size ) : rank( _rank ), ptr( _ptr ), size( _size ) {}
+         bool matches( void * _ptr, MPISize _size ) const { return ptr == _ptr && size == _size; }
+         MPIRank rank;
+         void *  ptr;
+         MPISize size;
+      };
+
+      bool sending_;
+      bool receiving_;
+
+      std::vector<MPI_Request> sendRequests_;
+      std::vector<RequestInfo> sendRequestInfos_;
+      std::map<MPIRank,size_t> sendRequestIndex_;
+
+      std::vector<MPI_Request> recvRequests_;
+      std::vector<RequestInfo> recvRequestInfos_;
+   };
+
+
    template< typename RecvBuffer_T, typename SendBuffer_T>
    class UnknownSizeCommunication : public AbstractCommunication<RecvBuffer_T, SendBuffer_T>
    {
@@ -165,6 +165,216 @@ MPIRank KnownSizeCommunication<Rb, Sb>::waitForNextReceive( std::map<MPIRank, Re
 
 
 
+//======================================================================================================================
+//
+//  PersistentCommunication
+//
+//======================================================================================================================
+
+template< typename Rb, typename Sb>
+void PersistentCommunication<Rb, Sb>::send( MPIRank receiver, const Sb & sendBuffer )
+{
+   WALBERLA_NON_MPI_SECTION() { WALBERLA_ASSERT( false ); }
+
+   if ( ! sending_ )
+      sending_ = true;
+
+   void * const  ptr  = sendBuffer.ptr();
+   const MPISize size = int_c( sendBuffer.size() );
+
+   auto it = sendRequestIndex_.find( receiver );
+   if( it == sendRequestIndex_.end() )
+   {
+      it = sendRequestIndex_.insert( std::make_pair( receiver, sendRequests_.size() ) ).first;
+      sendRequests_.push_back( MPI_REQUEST_NULL );
+      sendRequestInfos_.push_back( RequestInfo( receiver, nullptr, INVALID_SIZE ) );
+   }
+
+   const size_t index = it->second;
+   MPI_Request & request = sendRequests_[ index ];
+
+   if( ! sendRequestInfos_[ index ].matches( ptr, size ) )
+   {
+      // buffer was reallocated or message size has changed -> persistent request has to be recreated
+      if( request != MPI_REQUEST_NULL )
+         MPI_Request_free( &request );
+
+      MPI_Send_init( ptr,                 // pointer to send buffer
+                     size,                // size of message
+                     MPI_BYTE,            // type
+                     receiver,            // receiver rank
+                     this->tag_,          // message tag
+                     this->communicator_, // communicator
+                     &request             // persistent request
+                     );
+
+      sendRequestInfos_[ index ] = RequestInfo( receiver, ptr, size );
+   }
+
+   MPI_Start( &request );
+}
+
+
+template< typename Rb, typename Sb>
+void PersistentCommunication<Rb, Sb>::waitForSends( )
+{
+   WALBERLA_NON_MPI_SECTION() { WALBERLA_ASSERT( false ); }
+
+   sending_ = false;
+
+   if ( sendRequests_.empty() )
+      return;
+
+   // requests that were not started in this communication step are inactive -> MPI_Waitall returns immediately for them
+   MPI_Waitall( int_c( sendRequests_.size() ),
+                &sendRequests_[0],
+                MPI_STATUSES_IGNORE );
+}
+
+
+template< typename Rb, typename Sb>
+void PersistentCommunication<Rb, Sb>::scheduleReceives( std::map<MPIRank, ReceiveInfo> & recvInfos )
+{
+   WALBERLA_NON_MPI_SECTION() { WALBERLA_ASSERT( false ); }
+
+   WALBERLA_ASSERT( ! receiving_ );
+
+   if( recvRequests_.size() != recvInfos.size() )
+   {
+      for( auto request = recvRequests_.begin(); request != recvRequests_.end(); ++request )
+         if( *request != MPI_REQUEST_NULL )
+            MPI_Request_free( &(*request) );
+
+      recvRequests_.assign( recvInfos.size(), MPI_REQUEST_NULL );
+      recvRequestInfos_.assign( recvInfos.size(), RequestInfo( INVALID_RANK, nullptr, INVALID_SIZE ) );
+   }
+
+   size_t recvCount = 0;
+
+   for( auto it = recvInfos.begin(); it != recvInfos.end(); ++it )
+   {
+      const MPIRank senderRank = it->first;
+      ReceiveInfo & recvInfo   = it->second;
+
+      // This is a known-size communication -> here valid sizes are needed
+      WALBERLA_ASSERT_GREATER( recvInfo.size, 0 );
+
+      recvInfo.buffer.resize( uint_c( recvInfo.size ) );
+
+      MPI_Request & request     = recvRequests_[ recvCount ];
+      RequestInfo & requestInfo = recvRequestInfos_[ recvCount ];
+
+      if( requestInfo.rank != senderRank || ! requestInfo.matches( recvInfo.buffer.ptr(), recvInfo.size ) )
+      {
+         if( request != MPI_REQUEST_NULL )
+            MPI_Request_free( &request );
+
+         MPI_Recv_init( recvInfo.buffer.ptr(), // pointer to receive buffer
+                        recvInfo.size,         // size of expected message
+                        MPI_BYTE,              // type
+                        senderRank,            // rank of sender process
+                        this->tag_,            // message tag
+                        this->communicator_,   // communicator
+                        &request               // persistent request
+                        );
+
+         requestInfo = RequestInfo( senderRank, recvInfo.buffer.ptr(), recvInfo.size );
+      }
+
+      ++recvCount;
+   }
+
+   WALBERLA_ASSERT_EQUAL( recvCount, recvRequests_.size() );
+
+   if( ! recvRequests_.empty() )
+      MPI_Startall( int_c( recvRequests_.size() ), &recvRequests_[0] );
+
+   receiving_ = true;
+}
+
+
+template< typename Rb, typename Sb>
+MPIRank PersistentCommunication<Rb, Sb>::waitForNextReceive( std::map<MPIRank, ReceiveInfo> & recvInfos )
+{
+   WALBERLA_NON_MPI_SECTION() { WALBERLA_ASSERT( false ); }
+
+   WALBERLA_ASSERT( receiving_ );
+
+   if( recvRequests_.empty() ) {
+      receiving_ = false;
+      return INVALID_RANK;
+   }
+
+   // completed persistent requests become inactive (and are ignored by all following MPI_Waitany calls),
+   // they must not be set to MPI_REQUEST_NULL since they are reused in the next communication step
+   MPI_Status status;
+   int requestIndex = -1; // output parameter initialized with invalid value
+   MPI_Waitany( int_c( recvRequests_.size() ),
+                & recvRequests_[0],
+                & requestIndex,
+                & status );
+
+   if ( requestIndex == MPI_UNDEFINED )
+   {
+      receiving_ = false;
+      return INVALID_RANK;
+   }
+
+   WALBERLA_ASSERT_GREATER_EQUAL( requestIndex, 0 );
+   WALBERLA_ASSERT_LESS( requestIndex, int_c( recvRequests_.size() ) );
+
+   MPIRank senderRank = status.MPI_SOURCE;
+   WALBERLA_ASSERT_GREATER_EQUAL( senderRank, 0 );
+   WALBERLA_ASSERT_EQUAL( senderRank, recvRequestInfos_[ uint_c( requestIndex ) ].rank );
+
+#ifndef NDEBUG
+   int receivedBytes;
+   MPI_Get_count( &status, MPI_BYTE, &receivedBytes );
+   WALBERLA_ASSERT_EQUAL ( recvInfos[senderRank].size, receivedBytes );
+#else
+   WALBERLA_UNUSED( recvInfos );
+#endif
+
+   return senderRank;
+}
+
+
+template< typename Rb, typename Sb>
+void PersistentCommunication<Rb, Sb>::freeRequests()
+{
+   WALBERLA_ASSERT( ! sending_ );
+   WALBERLA_ASSERT( ! receiving_ );
+
+   if( sendRequests_.empty() && recvRequests_.empty() )
+      return;
+
+   WALBERLA_MPI_SECTION()
+   {
+      int finalized = 0;
+      MPI_Finalized( &finalized );
+
+      if( ! finalized )
+      {
+         for( auto request = sendRequests_.begin(); request != sendRequests_.end(); ++request )
+            if( *request != MPI_REQUEST_NULL )
+               MPI_Request_free( &(*request) );
+         for( auto request = recvRequests_.begin(); request != recvRequests_.end(); ++request )
+            if( *request != MPI_REQUEST_NULL )
+               MPI_Request_free( &(*request) );
+      }
+   }
+
+   sendRequests_.clear();
+   sendRequestInfos_.clear();
+   sendRequestIndex_.clear();
+
+   recvRequests_.clear();
+   recvRequestInfos_.clear();
+}
+
+
+
+
 //======================================================================================================================
 //
 //  Unknown Size Communication
@@ -23,6 +23,7 @@
 
 #include "core/mpi/Reduce.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace walberla {
@@ -103,5 +104,84 @@ void writeMPITextFile( const std::string & filename, const std::string & process
    }
 }
 
+
+
+//======================================================================================================================
+/*!
+ *  \brief Writes file using MPI IO with each process providing several parts of it
+ *
+ *  This method has the be called collectively by all the processes in comm, all processes must provide the same
+ *  number of parts. The file will be assembled part by part: first, the first parts of all processes in the order of
+ *  the ranks of the calling processes, then the second parts of all processes, and so on. This, for example, allows
+ *  to write files that consist of a distributed XML part followed by distributed binary data.
+ *
+ *  \param filename           The name of the file to be written
+ *  \param processLocalParts  The parts of the file belonging to the calling process (sizes may differ among processes)
+ */
+//======================================================================================================================
+void writeMPITextFile( const std::string & filename, const std::vector< std::string > & processLocalParts,
+                       const MPI_Comm comm /*= MPI_COMM_WORLD*/ )
+{
+   WALBERLA_NON_MPI_SECTION()
+   {
+      std::ofstream ofs( filename.c_str(), std::ofstream::binary );
+      for( auto part = processLocalParts.begin(); part != processLocalParts.end(); ++part )
+         ofs.write( part->data(), numeric_cast< std::streamsize >( part->size() ) );
+      ofs.close();
+   }
+
+   WALBERLA_MPI_SECTION()
+   {
+      int rank;
+      MPI_Comm_rank( comm, &rank );
+
+      std::vector< uint64_t > sizes;
+      for( auto part = processLocalParts.begin(); part != processLocalParts.end(); ++part )
+      {
+         if( part->size() > numeric_cast<std::string::size_type>( std::numeric_limits<int>::max() ) )
+            WALBERLA_ABORT( "writeMPITextFile does not support more than " << std::numeric_limits<int>::max() << " characters per part and process!" );
+         sizes.push_back( uint64_c( part->size() ) );
+      }
+
+      std::vector< uint64_t > totalSizes( sizes );
+      allReduceInplace( totalSizes, mpi::SUM, comm );
+
+      std::vector< uint64_t > exscanResult( sizes.size(), uint64_t(0) );
+      if( !sizes.empty() )
+         MPI_Exscan( &(sizes[0]), &(exscanResult[0]), int_c( sizes.size() ), MPITrait<uint64_t>::type(), MPI_SUM, comm );
+      if( rank == 0 )
+         std::fill( exscanResult.begin(), exscanResult.end(), uint64_t(0) );
+
+      MPI_File mpiFile;
+      int result = MPI_File_open( comm, const_cast<char*>( filename.c_str() ), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                                  &mpiFile );
+      if( result != MPI_SUCCESS )
+         WALBERLA_ABORT( "Error while opening file \"" << filename << "\" for writing. MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+
+      uint64_t partBegin = uint64_t(0);
+      for( uint_t i = 0; i != sizes.size(); ++i )
+         partBegin += totalSizes[i];
+      MPI_File_set_size( mpiFile, numeric_cast<MPI_Offset>( partBegin ) );
+
+      partBegin = uint64_t(0);
+      for( uint_t i = 0; i != processLocalParts.size(); ++i )
+      {
+         const MPI_Offset offset = numeric_cast<MPI_Offset>( partBegin + exscanResult[i] );
+         result = MPI_File_write_at_all( mpiFile, offset, const_cast<char*>( processLocalParts[i].data() ), int_c( processLocalParts[i].size() ),
+                                         MPITrait<char>::type(), MPI_STATUS_IGNORE );
+
+         if( result != MPI_SUCCESS )
+            WALBERLA_ABORT( "Error while writing to file \"" << filename << "\". MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+
+         partBegin += totalSizes[i];
+      }
+
+      result = MPI_File_close( &mpiFile );
+
+      if( result != MPI_SUCCESS )
+         WALBERLA_ABORT( "Error while closing file \"" << filename << "\". MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+   }
+}
+
 } // namespace mpi
 } // namespace walberla
\ No newline at end of file
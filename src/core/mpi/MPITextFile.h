@@ -24,6 +24,7 @@
 #include "core/mpi/MPIWrapper.h"
 
 #include <string>
+#include <vector>
 
 namespace walberla {
 namespace mpi {
@@ -32,5 +33,8 @@ namespace mpi {
 void writeMPITextFile( const std::string & filename, const std::string & processLocalPart,
                        const MPI_Comm comm = MPI_COMM_WORLD );
 
+void writeMPITextFile( const std::string & filename, const std::vector< std::string > & processLocalParts,
+                       const MPI_Comm comm = MPI_COMM_WORLD );
+
 } // namespace mpi
 } // namespace walberla
\ No newline at end of file
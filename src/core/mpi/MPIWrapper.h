@@ -183,6 +183,7 @@ const int MPI_MAX_ERROR_STRING = 255;
 inline int MPI_Init( int*, char*** )  { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Initialized( int *)    { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Finalize()             { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_Finalized( int *)      { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Abort( MPI_Comm, int ) { WALBERLA_MPI_FUNCTION_ERROR }
 
 inline int MPI_Group_incl( MPI_Group, int, int*, MPI_Group * ) { WALBERLA_MPI_FUNCTION_ERROR }
@@ -211,6 +212,10 @@ inline int MPI_Cart_shift ( MPI_Comm, int, int, int*, int*)             { WALBER
 inline int MPI_Irecv( void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request* ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Isend( void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request* ) { WALBERLA_MPI_FUNCTION_ERROR }
 
+inline int MPI_Recv_init( void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request* ) { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_Send_init( void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request* ) { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_Request_free( MPI_Request* )                                            { WALBERLA_MPI_FUNCTION_ERROR }
+
 inline int MPI_Recv( void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Status* ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Send( void*, int, MPI_Datatype, int, int, MPI_Comm )              { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Sendrecv( void*, int, MPI_Datatype, int, int, void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Status *) { WALBERLA_MPI_FUNCTION_ERROR }
@@ -248,6 +253,11 @@ inline int MPI_Type_create_resized( MPI_Datatype, MPI_Aint, MPI_Aint, MPI_Dataty
 inline int MPI_Type_size( MPI_Datatype, int * ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Type_get_extent(MPI_Datatype, MPI_Aint*, MPI_Aint*) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_Type_create_struct(int, const int[], const MPI_Aint[], const MPI_Datatype[], MPI_Datatype*) { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_Get_address( const void*, MPI_Aint* ) { WALBERLA_MPI_FUNCTION_ERROR }
+
+inline int MPI_Pack_size( int, MPI_Datatype, MPI_Comm, int* ) { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_Pack  ( const void*, int, MPI_Datatype, void*, int, int*, MPI_Comm ) { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_Unpack( const void*, int, int*, void*, int, MPI_Datatype, MPI_Comm ) { WALBERLA_MPI_FUNCTION_ERROR }
 
 inline int MPI_Op_create(MPI_User_function*, int, MPI_Op*) { WALBERLA_MPI_FUNCTION_ERROR }
 
@@ -260,6 +270,7 @@ inline int MPI_File_write_shared( MPI_File, void*, int, MPI_Datatype, MPI_Status
 inline int MPI_File_write       ( MPI_File, void*, int, MPI_Datatype, MPI_Status* ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_File_write_all   ( MPI_File, void*, int, MPI_Datatype, MPI_Status* ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_File_write_at    ( MPI_File, MPI_Offset, void*, int, MPI_Datatype, MPI_Status* ) { WALBERLA_MPI_FUNCTION_ERROR }
+inline int MPI_File_write_at_all( MPI_File, MPI_Offset, void*, int, MPI_Datatype, MPI_Status* ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_File_read_all    ( MPI_File, void *, int, MPI_Datatype, MPI_Status * ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_File_read_at     ( MPI_File, MPI_Offset, void*, int, MPI_Datatype, MPI_Status* ) { WALBERLA_MPI_FUNCTION_ERROR }
 inline int MPI_File_close       ( MPI_File* )                                       { WALBERLA_MPI_FUNCTION_ERROR }
@@ -56,6 +56,8 @@ public:
    void enforceSerialSends( bool val ) { serialSends_ = val; }
    void enforceSerialRecvs( bool val ) { serialRecvs_ = val; }
 
+   void usePersistentRequests( bool val ) { bs_.usePersistentRequests( val ); }
+
 
    void setReceiverInfo( bool _sizeChangesEverytime ) { dirty_ = true; sizeChangesEverytime_ = _sizeChangesEverytime; }
 
@@ -73,6 +75,7 @@ public:
    bool sizeChangesEverytime() const { return sizeChangesEverytime_; }
    bool serialSends() const          { return serialSends_; }
    bool serialRecvs() const          { return serialRecvs_; }
+   bool arePersistentRequestsUsed() const { return bs_.arePersistentRequestsUsed(); }
 
 
 private:
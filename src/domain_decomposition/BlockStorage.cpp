@@ -135,12 +135,26 @@ BlockDataID BlockStorage::loadBlockData( const std::string & file, const interna
 {
    WALBERLA_LOG_PROGRESS( "Adding block data (\"" << identifier << "\"), loading data from file \"" << file << "\" ..." );
    
+   mpi::RecvBuffer buffer;
+   mpi::readMPIIO(file, buffer);
+
+   return loadBlockData( buffer, dataHandling, identifier );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   Adds a new block data "item" whose data is deserialized from 'buffer'. The buffer must contain the data of all
+*   local blocks in the order of their block IDs, as it is created by 'serializeBlockData'.
+*/
+//**********************************************************************************************************************
+BlockDataID BlockStorage::loadBlockData( mpi::RecvBuffer & buffer, const internal::SelectableBlockDataHandlingWrapper & dataHandling,
+                                         const std::string & identifier )
+{
    BlockDataID id( blockDataItem_.size() );
    internal::BlockDataItem item( id, identifier, dataHandling );
    blockDataItem_.push_back( item );
-   
-   mpi::RecvBuffer buffer;
-   mpi::readMPIIO(file, buffer);
 
    std::vector< IBlock * > blocks;
    for( auto block = begin(); block != end(); ++block )
@@ -207,6 +221,26 @@ void BlockStorage::serializeBlockData( const BlockDataID & id, mpi::SendBuffer &
 }
 
 
+//**********************************************************************************************************************
+/*!
+*   Serializes the block data of a single block into a sendbuffer. Returns false if the block does not possess data
+*   that corresponds to 'id' (i.e., nothing was serialized).
+*/
+//**********************************************************************************************************************
+bool BlockStorage::serializeBlockData( const BlockDataID & id, IBlock * block, mpi::SendBuffer & buffer )
+{
+   WALBERLA_CHECK_LESS( uint_t(id), blockDataItem_.size() );
+   WALBERLA_ASSERT_NOT_NULLPTR( block );
+
+   auto dh = blockDataItem_[ uint_t(id) ].getDataHandling( block );
+   if( !dh )
+      return false;
+
+   dh->serialize( block, id, buffer );
+   return true;
+}
+
+
 //**********************************************************************************************************************
 /*!
 *   Deserializes data form a recv buffer into existing block data
@@ -487,10 +487,20 @@ public:
                                     
    BlockDataID loadBlockData( const std::string & file,
                               const internal::SelectableBlockDataHandlingWrapper & dataHandling, const std::string & identifier = std::string() );
+
+   template< typename T >
+   inline BlockDataID loadBlockData( mpi::RecvBuffer & buffer, const shared_ptr< T > & dataHandling,
+                                     const std::string & identifier          = std::string(),
+                                     const Set<SUID> & requiredSelectors     = Set<SUID>::emptySet(),
+                                     const Set<SUID> & incompatibleSelectors = Set<SUID>::emptySet() );
+
+   BlockDataID loadBlockData( mpi::RecvBuffer & buffer,
+                              const internal::SelectableBlockDataHandlingWrapper & dataHandling, const std::string & identifier = std::string() );
                               
    void saveBlockData( const std::string & file, const BlockDataID & id );
 
    void serializeBlockData( const BlockDataID & id, mpi::SendBuffer & buffer );
+   bool serializeBlockData( const BlockDataID & id, IBlock * block, mpi::SendBuffer & buffer );
    void deserializeBlockData( const BlockDataID & id, mpi::RecvBuffer & buffer );
 
    inline void clearBlockData( const BlockDataID & id );
@@ -710,6 +720,24 @@ inline BlockDataID BlockStorage::loadBlockData( const std::string & file, const
 
 
 
+//**********************************************************************************************************************
+/*!
+*   Same as 'loadBlockData' for files, but the data is taken from a buffer that contains the data of all local blocks
+*   in the order of their block IDs (see 'serializeBlockData').
+*/
+//**********************************************************************************************************************
+template< typename T >
+inline BlockDataID BlockStorage::loadBlockData( mpi::RecvBuffer & buffer, const shared_ptr< T > & dataHandling, const std::string & identifier,
+                                                const Set<SUID> & requiredSelectors, const Set<SUID> & incompatibleSelectors )
+{
+   internal::SelectableBlockDataHandlingWrapper sbdhw( walberla::make_shared< internal::BlockDataHandlingHelper<typename T::value_type> >( dataHandling ),
+                                                       requiredSelectors, incompatibleSelectors, identifier );
+
+   return loadBlockData( buffer, sbdhw, identifier );
+}
+
+
+
 //**********************************************************************************************************************
 /*!
 *   This function can be used for removing all data that corresponds to block data ID 'id'.
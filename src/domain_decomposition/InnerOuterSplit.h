@@ -0,0 +1,199 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file InnerOuterSplit.h
+//! \ingroup domain_decomposition
+//! \brief Splitting of sweeps into a part that does not depend on ghost layer data and a part that does
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "IBlock.h"
+#include "StructuredBlockStorage.h"
+
+#include "core/DataTypes.h"
+#include "core/cell/Cell.h"
+#include "core/cell/CellInterval.h"
+#include "core/debug/Debug.h"
+
+#include <functional>
+#include <vector>
+
+
+namespace walberla {
+namespace domain_decomposition {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Splits a sweep that can be restricted to a CellInterval into an inner and an outer part
+*
+*   The inner part processes the interior of a block, i.e., all cells except for a shell of 'shellWidth' cells at the
+*   block border. For a sweep that only accesses direct neighbors (shellWidth = 1), the inner part does not read any
+*   ghost layer data and can therefore run while the ghost layers are still being communicated. The outer part
+*   processes the remaining shell (as up to six disjoint slabs) and must run after the communication has finished.
+*   Once the shell is processed, the optional 'finalize' function is called for the block (e.g., to swap src and dst
+*   fields).
+*
+*   The sweep must have the signature "void ( IBlock *, const CellInterval & )". Sweeps that provide such an operator()
+*   together with a "void swap( IBlock * )" member, like lbm::SplitSweep or pde::Jacobi, can be split with
+*   makeInnerOuterSplit. For field sweeps that are written with the WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_* macros, the
+*   InnerOuterSplit can be constructed directly.
+*
+*   Since the inner part of all blocks is processed before the outer part of any block, src/dst sweeps must be
+*   constructed with a dedicated dst field that is stored as block data. The temporary dst field that these sweeps
+*   create if only a src field is given is shared among all blocks of the same size and can therefore not be used.
+*   Overlapping communication with the inner part then looks like this:
+*
+*   \code
+*   auto sweep = make_shared< lbm::SplitSweep< LatticeModel_T, FlagField_T > >( srcFieldId, dstFieldId, flagFieldId, Fluid_Flag );
+*
+*   timeloop::addOverlappingSweep( timeloop, communication.getStartCommunicateFunctor(), communication.getWaitFunctor(),
+*                                  makeInnerOuterSplit( blocks, sweep ), "LB stream & collide" );
+*   \endcode
+*
+*   See timeloop/CommunicationOverlap.h for addOverlappingSweep and for evaluating the achieved overlap.
+*/
+//**********************************************************************************************************************
+
+class InnerOuterSplit
+{
+public:
+
+   typedef std::function< void ( IBlock *, const CellInterval & ) > CellIntervalSweep;
+   typedef std::function< void ( IBlock * ) >                        BlockSweep;
+
+   InnerOuterSplit( const weak_ptr< StructuredBlockStorage > & blocks, const CellIntervalSweep & sweep,
+                    const BlockSweep & finalize = BlockSweep(), const Cell & shellWidth = Cell( 1, 1, 1 ) ) :
+      blocks_( blocks ), sweep_( sweep ), finalize_( finalize ), shellWidth_( shellWidth )
+   {
+      WALBERLA_ASSERT( shellWidth.x() >= 0 && shellWidth.y() >= 0 && shellWidth.z() >= 0 );
+   }
+
+   void runInner( IBlock * const block ) const
+   {
+      CellInterval inner;
+      std::vector< CellInterval > outer;
+      split( block, inner, outer );
+
+      sweep_( block, inner );
+   }
+
+   void runOuter( IBlock * const block ) const
+   {
+      CellInterval inner;
+      std::vector< CellInterval > outer;
+      split( block, inner, outer );
+
+      for( auto interval = outer.begin(); interval != outer.end(); ++interval )
+         sweep_( block, *interval );
+
+      if( finalize_ )
+         finalize_( block );
+   }
+
+   /// sweep that processes the inner part (can be registered at a SweepTimeloop)
+   BlockSweep inner() const { InnerOuterSplit self( *this ); return [self]( IBlock * const block ) { self.runInner( block ); }; }
+
+   /// sweep that processes the outer part and then calls 'finalize' (can be registered at a SweepTimeloop)
+   BlockSweep outer() const { InnerOuterSplit self( *this ); return [self]( IBlock * const block ) { self.runOuter( block ); }; }
+
+   const Cell & shellWidth() const { return shellWidth_; }
+
+   /// Splits 'cells' into the interior 'inner' and disjoint slabs 'outer' that cover the remaining shell. If 'cells' is
+   /// too small to have an interior, 'inner' is empty and 'outer' consists of 'cells' only.
+   static void split( const CellInterval & cells, const Cell & shellWidth, CellInterval & inner, std::vector< CellInterval > & outer );
+
+private:
+
+   void split( IBlock * const block, CellInterval & inner, std::vector< CellInterval > & outer ) const
+   {
+      auto blocks = blocks_.lock();
+      WALBERLA_CHECK_NOT_NULLPTR( blocks, "Trying to access 'InnerOuterSplit' for a block storage object that doesn't exist anymore" );
+
+      const CellInterval cells( cell_idx_t(0), cell_idx_t(0), cell_idx_t(0),
+                                cell_idx_c( blocks->getNumberOfXCells( *block ) ) - cell_idx_t(1),
+                                cell_idx_c( blocks->getNumberOfYCells( *block ) ) - cell_idx_t(1),
+                                cell_idx_c( blocks->getNumberOfZCells( *block ) ) - cell_idx_t(1) );
+
+      split( cells, shellWidth_, inner, outer );
+   }
+
+   weak_ptr< StructuredBlockStorage > blocks_;
+
+   CellIntervalSweep sweep_;
+   BlockSweep        finalize_;
+
+   Cell shellWidth_;
+};
+
+
+
+inline void InnerOuterSplit::split( const CellInterval & cells, const Cell & shellWidth, CellInterval & inner, std::vector< CellInterval > & outer )
+{
+   outer.clear();
+
+   inner = CellInterval( cells.xMin() + shellWidth.x(), cells.yMin() + shellWidth.y(), cells.zMin() + shellWidth.z(),
+                         cells.xMax() - shellWidth.x(), cells.yMax() - shellWidth.y(), cells.zMax() - shellWidth.z() );
+
+   if( inner.empty() )
+   {
+      inner = CellInterval();
+      if( !cells.empty() )
+         outer.push_back( cells );
+      return;
+   }
+
+   // z-slabs span the whole xy-plane, y-slabs the inner z-range, and x-slabs the inner y- and z-range
+
+   if( shellWidth.z() > 0 )
+   {
+      outer.push_back( CellInterval( cells.xMin(), cells.yMin(), cells.zMin(), cells.xMax(), cells.yMax(), inner.zMin() - cell_idx_t(1) ) );
+      outer.push_back( CellInterval( cells.xMin(), cells.yMin(), inner.zMax() + cell_idx_t(1), cells.xMax(), cells.yMax(), cells.zMax() ) );
+   }
+   if( shellWidth.y() > 0 )
+   {
+      outer.push_back( CellInterval( cells.xMin(), cells.yMin(), inner.zMin(), cells.xMax(), inner.yMin() - cell_idx_t(1), inner.zMax() ) );
+      outer.push_back( CellInterval( cells.xMin(), inner.yMax() + cell_idx_t(1), inner.zMin(), cells.xMax(), cells.yMax(), inner.zMax() ) );
+   }
+   if( shellWidth.x() > 0 )
+   {
+      outer.push_back( CellInterval( cells.xMin(), inner.yMin(), inner.zMin(), inner.xMin() - cell_idx_t(1), inner.yMax(), inner.zMax() ) );
+      outer.push_back( CellInterval( inner.xMax() + cell_idx_t(1), inner.yMin(), inner.zMin(), cells.xMax(), inner.yMax(), inner.zMax() ) );
+   }
+}
+
+
+
+/// Splits a sweep that provides "operator()( IBlock *, const CellInterval & )" and "swap( IBlock * )" (e.g.,
+/// lbm::SplitSweep or pde::Jacobi). The sweep object is shared by the inner and the outer part.
+template< typename Sweep_T >
+InnerOuterSplit makeInnerOuterSplit( const weak_ptr< StructuredBlockStorage > & blocks, const shared_ptr< Sweep_T > & sweep,
+                                     const Cell & shellWidth = Cell( 1, 1, 1 ) )
+{
+   return InnerOuterSplit( blocks, [sweep]( IBlock * const block, const CellInterval & cells ) { (*sweep)( block, cells ); },
+                                   [sweep]( IBlock * const block ) { sweep->swap( block ); }, shellWidth );
+}
+
+
+
+} // namespace domain_decomposition
+
+using domain_decomposition::InnerOuterSplit;
+using domain_decomposition::makeInnerOuterSplit;
+
+} // namespace walberla
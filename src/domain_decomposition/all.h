@@ -29,6 +29,7 @@
 #include "BlockSweepWrapper.h"
 #include "IBlock.h"
 #include "IBlockID.h"
+#include "InnerOuterSplit.h"
 #include "MakeBlockDataInitFunction.h"
 #include "SharedSweep.h"
 #include "StructuredBlockStorageCellMapping.h"
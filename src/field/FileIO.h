@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <core/compression/LossyCompression.h>
 #include <core/mpi/MPIWrapper.h>
 #include <core/mpi/Reduce.h>
 
@@ -91,6 +92,51 @@ void readFromFile( const std::string & filename, BlockStorage & blockStorage, co
 
 
 
+//======================================================================================================================
+/*!
+ *  \brief Writes a field from a BlockStorage to file using error-bounded lossy compression
+ *
+ *  Only the inner cells of a Field are written to file, ghost layer cells are ignored. Every value that is read back
+ *  with readFromFileLossy differs by at most the given error bound from the original value (see
+ *  compression::compressLossy and field::compressLossy, a relative error bound refers to the value range of each
+ *  component on each block). The error bound can be read from the configuration file with compression::getErrorBound.
+ *  The value type of the field must be float or double.
+ *
+ *  Blocks are processed in the order of their block IDs. Since the size of the compressed data differs from block to
+ *  block, the file can only be read again by the same number of processes with the same blocks on every process.
+ *
+ *  This is a collective function, it has to be called by all MPI processes simultaneously.
+ *
+ *  \param filename     The name of the file to be created
+ *  \param blockStorage The BlockStorage the field is registered at
+ *  \param fieldID      The ID of the field as returned by the BlockStorage at its registration
+ *  \param errorBound   The maximal error of every value
+ */
+//======================================================================================================================
+template< typename FieldT >
+void writeToFileLossy( const std::string & filename, const BlockStorage & blockStorage, const BlockDataID & fieldID,
+                       const compression::ErrorBound & errorBound,
+                       const Set<SUID> & requiredSelectors = Set<SUID>::emptySet(), const Set<SUID> & incompatibleSelectors = Set<SUID>::emptySet() );
+
+
+
+//======================================================================================================================
+/*!
+*  \brief Reads a field from a file that was written by writeToFileLossy
+*
+*  This is a collective function, it has to be called by all MPI processes simultaneously.
+*
+*  \param filename     The name of the file to be read
+*  \param blockStorage The BlockStorage the field is registered at
+*  \param fieldID      The ID of the field as returned by the BlockStorage at its registration
+*/
+//======================================================================================================================
+template< typename FieldT >
+void readFromFileLossy( const std::string & filename, BlockStorage & blockStorage, const BlockDataID & fieldID,
+                        const Set<SUID> & requiredSelectors = Set<SUID>::emptySet(), const Set<SUID> & incompatibleSelectors = Set<SUID>::emptySet() );
+
+
+
 } // namespace walberla
 } // namespace field
 
@@ -21,6 +21,10 @@
 
 #pragma once
 
+#include "LossyCompression.h"
+
+#include "core/mpi/MPIIO.h"
+
 namespace walberla {
 namespace field {
 
@@ -336,5 +340,44 @@ void readFromFile( const std::string & filename, BlockStorage & blockStorage, co
    writer.readFromFile( blockStorage );
 }
 
+
+
+template< typename FieldT >
+void writeToFileLossy( const std::string & filename, const BlockStorage & blockStorage, const BlockDataID & fieldID,
+                       const compression::ErrorBound & errorBound,
+                       const Set<SUID> & requiredSelectors, const Set<SUID> & incompatibleSelectors )
+{
+   std::vector< const IBlock * > blocks;
+   for( auto it = blockStorage.begin( requiredSelectors, incompatibleSelectors ); it != blockStorage.end(); ++it )
+      blocks.push_back( it.get() );
+   std::sort( blocks.begin(), blocks.end(), internal::sortConstBlocksByID );
+
+   mpi::SendBuffer buffer;
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+      compressLossy( *( (*block)->template getData<FieldT>( fieldID ) ), errorBound, buffer );
+
+   mpi::writeMPIIO( filename, buffer );
+}
+
+
+
+template< typename FieldT >
+void readFromFileLossy( const std::string & filename, BlockStorage & blockStorage, const BlockDataID & fieldID,
+                        const Set<SUID> & requiredSelectors, const Set<SUID> & incompatibleSelectors )
+{
+   std::vector< IBlock * > blocks;
+   for( auto it = blockStorage.begin( requiredSelectors, incompatibleSelectors ); it != blockStorage.end(); ++it )
+      blocks.push_back( it.get() );
+   std::sort( blocks.begin(), blocks.end(), internal::sortBlocksByID );
+
+   mpi::RecvBuffer buffer;
+   mpi::readMPIIO( filename, buffer );
+
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+      decompressLossy( *( (*block)->template getData<FieldT>( fieldID ) ), buffer );
+
+   WALBERLA_CHECK( buffer.isEmpty(), "File \"" << filename << "\" contains more data than expected" );
+}
+
 } // namespace walberla
 } // namespace field
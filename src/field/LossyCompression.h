@@ -0,0 +1,105 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LossyCompression.h
+//! \ingroup field
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "core/compression/LossyCompression.h"
+#include "core/debug/CheckFunctions.h"
+#include "core/mpi/RecvBuffer.h"
+#include "core/mpi/SendBuffer.h"
+
+#include <type_traits>
+#include <vector>
+
+
+namespace walberla {
+namespace field {
+
+
+
+//======================================================================================================================
+/*!
+ *  \brief Compresses the inner cells of a field with the error-bounded lossy compression of compression::compressLossy
+ *         and appends the result to 'buffer'
+ *
+ *  Every component of the field is compressed separately, a relative error bound refers to the value range of the
+ *  component on this block. Ghost layers are not stored. The value type of the field must be float or double.
+ */
+//======================================================================================================================
+template< typename Field_T >
+void compressLossy( const Field_T & field, const compression::ErrorBound & errorBound, mpi::SendBuffer & buffer )
+{
+   typedef typename Field_T::value_type value_type;
+   static_assert( std::is_floating_point< value_type >::value, "Lossy compression is only available for fields of float or double" );
+
+   buffer << field.xSize() << field.ySize() << field.zSize() << field.fSize();
+
+   std::vector< value_type > data( field.xSize() * field.ySize() * field.zSize() );
+   std::vector< uint8_t > compressed;
+   for( cell_idx_t f = 0; f != cell_idx_c( field.fSize() ); ++f )
+   {
+      auto value = data.begin();
+      for( cell_idx_t z = 0; z != cell_idx_c( field.zSize() ); ++z )
+         for( cell_idx_t y = 0; y != cell_idx_c( field.ySize() ); ++y )
+            for( cell_idx_t x = 0; x != cell_idx_c( field.xSize() ); ++x, ++value )
+               *value = field.get( x, y, z, f );
+
+      compression::compressLossy( data.data(), field.xSize(), field.ySize(), field.zSize(),
+                                  errorBound.absoluteTolerance( data.data(), uint_c( data.size() ) ), compressed );
+      buffer << compressed;
+   }
+}
+
+
+
+/// Counterpart of compressLossy: reads the inner cells of 'field' from 'buffer' (the field must have the same size)
+template< typename Field_T >
+void decompressLossy( Field_T & field, mpi::RecvBuffer & buffer )
+{
+   typedef typename Field_T::value_type value_type;
+   static_assert( std::is_floating_point< value_type >::value, "Lossy compression is only available for fields of float or double" );
+
+   uint_t xSize, ySize, zSize, fSize;
+   buffer >> xSize >> ySize >> zSize >> fSize;
+   WALBERLA_CHECK_EQUAL( xSize, field.xSize() );
+   WALBERLA_CHECK_EQUAL( ySize, field.ySize() );
+   WALBERLA_CHECK_EQUAL( zSize, field.zSize() );
+   WALBERLA_CHECK_EQUAL( fSize, field.fSize() );
+
+   std::vector< uint8_t > compressed;
+   std::vector< value_type > data;
+   for( cell_idx_t f = 0; f != cell_idx_c( fSize ); ++f )
+   {
+      buffer >> compressed;
+      compression::decompressLossy( compressed.data(), uint_c( compressed.size() ), data );
+      WALBERLA_CHECK_EQUAL( data.size(), xSize * ySize * zSize );
+
+      auto value = data.begin();
+      for( cell_idx_t z = 0; z != cell_idx_c( zSize ); ++z )
+         for( cell_idx_t y = 0; y != cell_idx_c( ySize ); ++y )
+            for( cell_idx_t x = 0; x != cell_idx_c( xSize ); ++x, ++value )
+               field.get( x, y, z, f ) = *value;
+   }
+}
+
+
+
+} // namespace field
+} // namespace walberla
@@ -34,6 +34,7 @@
 #include "FlagFunctions.h"
 #include "Gather.h"
 #include "GhostLayerField.h"
+#include "LossyCompression.h"
 #include "MassEvaluation.h"
 #include "Printers.h"
 #include "StabilityChecker.h"
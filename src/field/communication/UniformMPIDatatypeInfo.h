@@ -25,10 +25,46 @@
 #include "communication/UniformMPIDatatypeInfo.h"
 #include "field/communication/MPIDatatypes.h"
 
+#include <utility>
+
 namespace walberla {
 namespace field {
 namespace communication {
 
+
+namespace internal {
+
+// direct copy for all fields that provide CPU iterators (selected via SFINAE, e.g., not for cuda::GPUField)
+template< typename GhostLayerField_T >
+auto copySliceToGhostLayer( const GhostLayerField_T & sf, GhostLayerField_T & rf, const stencil::Direction dir, const uint_t numberOfGhostLayers, int )
+   -> decltype( sf.beginSliceBeforeGhostLayer( dir, cell_idx_t(0) ), bool() )
+{
+   WALBERLA_ASSERT_EQUAL( sf.xSize(), rf.xSize() );
+   WALBERLA_ASSERT_EQUAL( sf.ySize(), rf.ySize() );
+   WALBERLA_ASSERT_EQUAL( sf.zSize(), rf.zSize() );
+
+   auto srcIter = sf.beginSliceBeforeGhostLayer( dir, cell_idx_c( numberOfGhostLayers ) );
+   auto dstIter = rf.beginGhostLayerOnly( numberOfGhostLayers, stencil::inverseDir[dir] );
+
+   while( srcIter != sf.end() ) {
+      *dstIter = *srcIter;
+      ++srcIter;
+      ++dstIter;
+   }
+
+   WALBERLA_ASSERT( srcIter == sf.end() && dstIter == rf.end() );
+   return true;
+}
+
+template< typename GhostLayerField_T >
+bool copySliceToGhostLayer( const GhostLayerField_T &, GhostLayerField_T &, const stencil::Direction, const uint_t, long )
+{
+   return false;
+}
+
+} // namespace internal
+
+
 template<typename GhostLayerField_T>
 class UniformMPIDatatypeInfo : public walberla::communication::UniformMPIDatatypeInfo
 {
@@ -63,6 +99,12 @@ public:
       return getField(block)->data();
    }
 
+   virtual void communicateLocal( IBlock * sender, IBlock * receiver, const stencil::Direction dir )
+   {
+      if( !internal::copySliceToGhostLayer( *getField( sender ), *getField( receiver ), dir, numberOfGhostLayersToCommunicate( sender ), 0 ) )
+         walberla::communication::UniformMPIDatatypeInfo::communicateLocal( sender, receiver, dir );
+   }
+
 private:
 
    GhostLayerField_T * getField( IBlock * block )
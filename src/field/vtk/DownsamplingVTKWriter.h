@@ -0,0 +1,123 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file DownsamplingVTKWriter.h
+//! \ingroup field
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "VTKWriter.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace walberla {
+namespace field {
+
+
+//**********************************************************************************************************************
+/*! Writes a field downsampled with a box filter (for VTKOutput objects that use a sampling resolution)
+*
+*  Behaves exactly like VTKWriter if the data is written at the resolution of the simulation. If a sampling resolution
+*  is set at the VTKOutput object, the value of every sampling cell is the average of all cells of the block whose
+*  centers lie within the sampling cell (instead of the value of the cell that contains the center of the sampling
+*  cell). If the sampling resolution is finer than the resolution of the block, the value of the cell that contains the
+*  center of the sampling cell is written.
+*  Only cells of the block are averaged, a sampling cell should therefore not extend across block boundaries. This is
+*  guaranteed if the number of cells per block is a multiple of the downsampling factor.
+*
+*  Typical usage (coarse output of the entire domain, only every fourth cell in each direction):
+*  \code
+*     auto vtkOutput = vtk::createVTKOutput_BlockData( blocks, "coarse", writeFrequency );
+*     vtkOutput->addCellDataWriter( make_shared< field::DownsamplingVTKWriter< ScalarField > >( fieldId, "density" ) );
+*     vtkOutput->setSamplingResolution( real_t(4) * blocks->dx() );
+*     vtkOutput->cacheCellLists();
+*  \endcode
+*/
+//**********************************************************************************************************************
+
+template< typename Field_T, typename OutputType = typename VectorTrait<typename Field_T::value_type >::OutputType >
+class DownsamplingVTKWriter : public VTKWriter< Field_T, OutputType >
+{
+public:
+   typedef VTKWriter< Field_T, OutputType > writer_t;
+
+   DownsamplingVTKWriter( const ConstBlockDataID bdid, const std::string& id ) :
+      writer_t( bdid, id ), dx_( real_t(1) ), dy_( real_t(1) ), dz_( real_t(1) ) {}
+
+protected:
+
+   using writer_t::evaluate;
+
+   void configure()
+   {
+      writer_t::configure();
+
+      const uint_t level = this->blockStorage_->getLevel( *(this->block_) );
+      dx_ = this->blockStorage_->dx( level );
+      dy_ = this->blockStorage_->dy( level );
+      dz_ = this->blockStorage_->dz( level );
+   }
+
+   OutputType evaluate( const cell_idx_t x,      const cell_idx_t y,      const cell_idx_t z,      const cell_idx_t f,
+                        const real_t localXCell, const real_t localYCell, const real_t localZCell,
+                        const real_t /*globalX*/, const real_t /*globalY*/, const real_t /*globalZ*/,
+                        const real_t samplingDx, const real_t samplingDy, const real_t samplingDz )
+   {
+      WALBERLA_ASSERT_NOT_NULLPTR( this->field_ );
+
+      cell_idx_t xMin, xMax, yMin, yMax, zMin, zMax;
+      cellRange( localXCell, samplingDx / dx_, cell_idx_c( this->field_->xSize() ), x, xMin, xMax );
+      cellRange( localYCell, samplingDy / dy_, cell_idx_c( this->field_->ySize() ), y, yMin, yMax );
+      cellRange( localZCell, samplingDz / dz_, cell_idx_c( this->field_->zSize() ), z, zMin, zMax );
+
+      real_t sum( real_t(0) );
+      for( cell_idx_t cz = zMin; cz <= zMax; ++cz )
+         for( cell_idx_t cy = yMin; cy <= yMax; ++cy )
+            for( cell_idx_t cx = xMin; cx <= xMax; ++cx )
+               sum += real_c( writer_t::evaluate( cx, cy, cz, f ) );
+
+      return numeric_cast< OutputType >( sum / real_c( ( xMax - xMin + 1 ) * ( yMax - yMin + 1 ) * ( zMax - zMin + 1 ) ) );
+   }
+
+private:
+
+   /// Range [min,max] of all block local cells whose centers lie within [center - width/2, center + width/2) (all
+   /// values in units of cells). If there is no such cell, min and max are set to 'nearest'.
+   static void cellRange( const real_t center, const real_t width, const cell_idx_t size, const cell_idx_t nearest,
+                          cell_idx_t & min, cell_idx_t & max )
+   {
+      min = std::max( cell_idx_c( std::ceil( center - real_t(0.5) * width - real_t(0.5) ) ), cell_idx_t(0) );
+      max = std::min( cell_idx_c( std::ceil( center + real_t(0.5) * width - real_t(0.5) ) ) - cell_idx_t(1), size - cell_idx_t(1) );
+      if( min > max )
+      {
+         min = nearest;
+         max = nearest;
+      }
+   }
+
+   real_t dx_;
+   real_t dy_;
+   real_t dz_;
+
+};
+
+
+
+} // namespace field
+} // namespace walberla
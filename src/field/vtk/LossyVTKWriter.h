@@ -0,0 +1,100 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LossyVTKWriter.h
+//! \ingroup field
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "VTKWriter.h"
+
+#include "core/compression/LossyCompression.h"
+
+#include <type_traits>
+#include <vector>
+
+
+namespace walberla {
+namespace field {
+
+
+//**********************************************************************************************************************
+/*! Writes a field with error-bounded precision (for smaller compressed VTK files)
+*
+*  Every value is rounded with compression::quantize such that it differs by at most the tolerance of the error bound
+*  from the value stored in the field. The rounded values have many trailing zero bits and are therefore compressed
+*  much better by the zlib compression of VTKOutput::useAppendedRawData( true ). The files remain standard VTK files.
+*  A relative error bound refers to the value range of the field (all components) on each block.
+*
+*  \code
+*     auto errorBound = compression::getErrorBound( config->getBlock( "LossyCompression" ), "density" );
+*     vtkOutput->addCellDataWriter( make_shared< field::LossyVTKWriter< ScalarField > >( fieldId, "density", errorBound ) );
+*     vtkOutput->useAppendedRawData( true );
+*  \endcode
+*/
+//**********************************************************************************************************************
+
+template< typename Field_T, typename OutputType = typename VectorTrait<typename Field_T::value_type >::OutputType >
+class LossyVTKWriter : public VTKWriter< Field_T, OutputType >
+{
+public:
+   typedef VTKWriter< Field_T, OutputType > writer_t;
+
+   static_assert( std::is_floating_point< OutputType >::value, "LossyVTKWriter requires a floating point output type" );
+
+   LossyVTKWriter( const ConstBlockDataID bdid, const std::string& id, const compression::ErrorBound & errorBound ) :
+      writer_t( bdid, id ), errorBound_( errorBound ), tolerance_( errorBound.tolerance ) {}
+
+   /// values must be rounded individually
+   bool pushLine( vtk::Base64Writer &, const cell_idx_t, const cell_idx_t, const cell_idx_t, const cell_idx_t ) override { return false; }
+
+protected:
+
+   using writer_t::evaluate;
+
+   void configure() override
+   {
+      writer_t::configure();
+
+      if( errorBound_.mode == compression::ErrorBound::ABSOLUTE )
+         return;
+
+      std::vector< OutputType > values;
+      for( cell_idx_t z = 0; z != cell_idx_c( this->field_->zSize() ); ++z )
+         for( cell_idx_t y = 0; y != cell_idx_c( this->field_->ySize() ); ++y )
+            for( cell_idx_t x = 0; x != cell_idx_c( this->field_->xSize() ); ++x )
+               for( cell_idx_t f = 0; f != cell_idx_c( writer_t::F_SIZE ); ++f )
+                  values.push_back( writer_t::evaluate( x, y, z, f ) );
+      tolerance_ = errorBound_.absoluteTolerance( values.data(), uint_c( values.size() ) );
+   }
+
+   OutputType evaluate( const cell_idx_t x, const cell_idx_t y, const cell_idx_t z, const cell_idx_t f ) override
+   {
+      return compression::quantize( writer_t::evaluate( x, y, z, f ), tolerance_ );
+   }
+
+private:
+
+   const compression::ErrorBound errorBound_;
+   double tolerance_;
+
+};
+
+
+
+} // namespace field
+} // namespace walberla
@@ -28,6 +28,8 @@
 #include "vtk/BlockCellDataWriter.h"
 #include <vtk/VTKOutput.h>
 
+#include <type_traits>
+
 
 namespace walberla {
 namespace field {
@@ -110,14 +112,25 @@ public:
    VTKWriter( const ConstBlockDataID bdid, const std::string& id ) :
       base_t( id ), bdid_( bdid ), field_( NULL ) {}
 
+   /// Binary output of consecutive cells: the line is copied from the memory of the field into the Base64Writer with
+   /// one append instead of one evaluate() call per cell and component. Only possible if the data is not converted
+   /// (OutputType == value_type) and the data of consecutive cells is stored contiguously (scalar fields or layout zyxf).
+   bool pushLine( vtk::Base64Writer & b64, const cell_idx_t xBegin, const cell_idx_t xEnd, const cell_idx_t y, const cell_idx_t z ) override
+   {
+      typedef typename Field_T::value_type FieldValue_T;
+      return pushLineFromMemory( b64, xBegin, xEnd, y, z,
+                                 std::integral_constant< bool, std::is_same< OutputType, FieldValue_T >::value &&
+                                                               std::is_base_of< Field< FieldValue_T, Field_T::F_SIZE >, Field_T >::value >() );
+   }
+
 protected:
 
-   void configure() {
+   void configure() override {
       WALBERLA_ASSERT_NOT_NULLPTR( this->block_ );
       field_ = this->block_->template getData< Field_T >( bdid_ );
    }
 
-   OutputType evaluate( const cell_idx_t x, const cell_idx_t y, const cell_idx_t z, const cell_idx_t f )
+   OutputType evaluate( const cell_idx_t x, const cell_idx_t y, const cell_idx_t z, const cell_idx_t f ) override
    {
       WALBERLA_ASSERT_NOT_NULLPTR( field_ );
 
@@ -135,6 +148,23 @@ protected:
       }
    }
 
+   bool pushLineFromMemory( vtk::Base64Writer &, const cell_idx_t, const cell_idx_t, const cell_idx_t, const cell_idx_t, std::false_type )
+   {
+      return false;
+   }
+
+   bool pushLineFromMemory( vtk::Base64Writer & b64, const cell_idx_t xBegin, const cell_idx_t xEnd, const cell_idx_t y, const cell_idx_t z,
+                            std::true_type )
+   {
+      WALBERLA_ASSERT_NOT_NULLPTR( field_ );
+
+      if( field_->xStride() != cell_idx_c( Field_T::F_SIZE ) || ( Field_T::F_SIZE > 1 && field_->fStride() != cell_idx_t(1) ) )
+         return false;
+
+      b64.append( field_->dataAt( xBegin, y, z, cell_idx_t(0) ), uint_c( xEnd - xBegin ) * Field_T::F_SIZE );
+      return true;
+   }
+
    const ConstBlockDataID bdid_;
    const Field_T * field_;
 
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "DownsamplingVTKWriter.h"
 #include "FlagFieldCellFilter.h"
 #include "FlagFieldMapping.h"
+#include "LossyVTKWriter.h"
 #include "VTKWriter.h"
@@ -56,6 +56,31 @@
                            }
 
 
+// same as X_LOOP, but iterates [xBegin,xEnd) instead of [0,xSize)
+#define X_LOOP_INTERVAL(loopBody) {\
+                              const cell_idx_t unroll = 4;\
+                              cell_idx_t x = xBegin;\
+                              cell_idx_t outerCounter = xBegin;\
+                              const cell_idx_t xEndMinusUnroll = xEnd-unroll;\
+                              for ( outerCounter = xBegin; outerCounter <= xEndMinusUnroll; outerCounter+=unroll )\
+                              {\
+                                 _Pragma("unroll")\
+                                 _Pragma("vector always")\
+                                 _Pragma("ivdep")\
+                                 /*_Pragma("vector aligned")*/\
+                                 x = outerCounter;\
+                                 for( cell_idx_t innerCounter = 0; innerCounter != unroll; ++innerCounter )\
+                                 {\
+                                    loopBody\
+                                    ++x;\
+                                 }\
+                              }\
+                              for( ; x < xEnd; ++x ) {\
+                                 loopBody\
+                              }\
+                           }
+
+
 #define X_LOOP_IACA(loopBody) {\
                               const cell_idx_t unroll = 4;\
                               cell_idx_t x = 0;\
@@ -88,6 +113,10 @@
 #define X_LOOP(loopBody) for( cell_idx_t x = 0; x != xSize; ++x ) { loopBody }
 
 
+// same as X_LOOP, but iterates [xBegin,xEnd) instead of [0,xSize)
+#define X_LOOP_INTERVAL(loopBody) for( cell_idx_t x = xBegin; x != xEnd; ++x ) { loopBody }
+
+
 #define X_LOOP_IACA(loopBody) for( cell_idx_t x = 0; x != xSize; ++x ) { IACA_START loopBody } IACA_END
 
 
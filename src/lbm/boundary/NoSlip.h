@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "lbm/field/InPlaceTimestep.h"
 #include "lbm/field/PdfField.h"
 
 #include "boundary/Boundary.h"
@@ -59,8 +60,10 @@ public:
 
 
 
-   NoSlip( const BoundaryUID& boundaryUID, const FlagUID& uid, PDFField* const pdfField ) :
-      Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ) { WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ ); }
+   /// 'inPlaceTimestep' must only be provided if the PDF field is updated with an InPlaceSweep
+   NoSlip( const BoundaryUID& boundaryUID, const FlagUID& uid, PDFField* const pdfField,
+           const shared_ptr< const InPlaceTimestep > & inPlaceTimestep = shared_ptr< const InPlaceTimestep >() ) :
+      Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ), inPlaceTimestep_( inPlaceTimestep ) { WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ ); }
 
    void pushFlags( std::vector< FlagUID >& uids ) const { uids.push_back( uid_ ); }
 
@@ -95,7 +98,10 @@ public:
       WALBERLA_ASSERT_EQUAL( mask & this->mask_, this->mask_ ); // only true if "this->mask_" only contains one single flag, which is the case for the
                                                                 // current implementation of this boundary condition (NoSlip)
 
-      pdfField_->get( nx, ny, nz, Stencil::invDirIdx(dir) ) = pdfField_->get( x, y, z, Stencil::idx[dir] );
+      if( skipBoundaryTreatment( inPlaceTimestep_.get() ) )
+         return;
+
+      incomingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir, nx, ny, nz ) = outgoingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir );
    }
 
 private:
@@ -104,6 +110,8 @@ private:
 
    PDFField* const pdfField_;
 
+   shared_ptr< const InPlaceTimestep > inPlaceTimestep_;
+
 }; // class NoSlip
 
 
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "lbm/field/DensityAndVelocity.h"
+#include "lbm/field/InPlaceTimestep.h"
 #include "lbm/field/PdfField.h"
 
 #include "boundary/Boundary.h"
@@ -60,11 +61,16 @@ public:
 
 
 
-   SimpleUBB( const BoundaryUID& boundaryUID, const FlagUID& uid, PDFField* const pdfField, const Vector3< real_t > & velocity ) :
-      Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ), velocity_( velocity ) { WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ ); }
+   /// 'inPlaceTimestep' must only be provided if the PDF field is updated with an InPlaceSweep
+   SimpleUBB( const BoundaryUID& boundaryUID, const FlagUID& uid, PDFField* const pdfField, const Vector3< real_t > & velocity,
+              const shared_ptr< const InPlaceTimestep > & inPlaceTimestep = shared_ptr< const InPlaceTimestep >() ) :
+      Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ), velocity_( velocity ), inPlaceTimestep_( inPlaceTimestep )
+   { WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ ); }
 
-   SimpleUBB( const BoundaryUID& boundaryUID, const FlagUID& uid, PDFField* const pdfField, const real_t x, const real_t y, const real_t z ) :
-      Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ), velocity_( x, y, z ) { WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ ); }
+   SimpleUBB( const BoundaryUID& boundaryUID, const FlagUID& uid, PDFField* const pdfField, const real_t x, const real_t y, const real_t z,
+              const shared_ptr< const InPlaceTimestep > & inPlaceTimestep = shared_ptr< const InPlaceTimestep >() ) :
+      Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ), velocity_( x, y, z ), inPlaceTimestep_( inPlaceTimestep )
+   { WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ ); }
 
    void pushFlags( std::vector< FlagUID >& uids ) const { uids.push_back( uid_ ); }
 
@@ -99,28 +105,31 @@ public:
       WALBERLA_ASSERT_EQUAL( mask & this->mask_, this->mask_ ); // only true if "this->mask_" only contains one single flag, which is the case for the
                                                                 // current implementation of this boundary condition (SimpleUBB)
 
+      if( skipBoundaryTreatment( inPlaceTimestep_.get() ) )
+         return;
+
       if( LatticeModel_T::compressible )
       {
-         const auto density  = pdfField_->getDensity(x,y,z);
+         const auto density  = postCollisionDensity( inPlaceTimestep_.get(), *pdfField_, x, y, z );
          const auto velocity = AdaptVelocityToExternalForce ? internal::AdaptVelocityToForce<LatticeModel_T>::get( x, y, z, pdfField_->latticeModel(), velocity_, density ) :
                                                               velocity_;
 
-         pdfField_->get( nx, ny, nz, Stencil::invDirIdx(dir) ) = pdfField_->get( x, y, z, Stencil::idx[dir] ) -
-                                                                 ( real_c(6) * density * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
-                                                                    ( real_c(stencil::cx[ dir ]) * velocity[0] +
-                                                                      real_c(stencil::cy[ dir ]) * velocity[1] +
-                                                                      real_c(stencil::cz[ dir ]) * velocity[2] ) );
+         incomingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir, nx, ny, nz ) = outgoingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir ) -
+                                                                                       ( real_c(6) * density * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
+                                                                                          ( real_c(stencil::cx[ dir ]) * velocity[0] +
+                                                                                            real_c(stencil::cy[ dir ]) * velocity[1] +
+                                                                                            real_c(stencil::cz[ dir ]) * velocity[2] ) );
       }
       else
       {
          const auto velocity = AdaptVelocityToExternalForce ? internal::AdaptVelocityToForce<LatticeModel_T>::get( x, y, z, pdfField_->latticeModel(), velocity_, real_t(1) ) :
                                                               velocity_;
 
-         pdfField_->get( nx, ny, nz, Stencil::invDirIdx(dir) ) = pdfField_->get( x, y, z, Stencil::idx[dir] ) -
-                                                                 ( real_c(6) * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
-                                                                    ( real_c(stencil::cx[ dir ]) * velocity[0] +
-                                                                      real_c(stencil::cy[ dir ]) * velocity[1] +
-                                                                      real_c(stencil::cz[ dir ]) * velocity[2] ) );
+         incomingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir, nx, ny, nz ) = outgoingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir ) -
+                                                                                       ( real_c(6) * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
+                                                                                          ( real_c(stencil::cx[ dir ]) * velocity[0] +
+                                                                                            real_c(stencil::cy[ dir ]) * velocity[1] +
+                                                                                            real_c(stencil::cz[ dir ]) * velocity[2] ) );
       }
    }
 
@@ -132,6 +141,8 @@ private:
 
    const Vector3< real_t > velocity_;
 
+   shared_ptr< const InPlaceTimestep > inPlaceTimestep_;
+
 }; // class SimpleUBB
 
 
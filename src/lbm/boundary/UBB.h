@@ -22,6 +22,7 @@
 #pragma once
 
 #include "lbm/field/DensityAndVelocity.h"
+#include "lbm/field/InPlaceTimestep.h"
 #include "lbm/field/PdfField.h"
 
 #include "boundary/Boundary.h"
@@ -85,7 +86,9 @@ public:
 
 
 
-   inline UBB( const BoundaryUID & boundaryUID, const FlagUID & uid, PDFField* const pdfField, FlagField<flag_t> * const flagField = NULL );
+   /// 'inPlaceTimestep' must only be provided if the PDF field is updated with an InPlaceSweep
+   inline UBB( const BoundaryUID & boundaryUID, const FlagUID & uid, PDFField* const pdfField, FlagField<flag_t> * const flagField = NULL,
+               const shared_ptr< const InPlaceTimestep > & inPlaceTimestep = shared_ptr< const InPlaceTimestep >() );
 
    void pushFlags( std::vector< FlagUID > & uids ) const { uids.push_back( uid_ ); }
 
@@ -117,6 +120,8 @@ private:
    PDFField* const      pdfField_;
    shared_ptr<VelField> vel_;
 
+   shared_ptr< const InPlaceTimestep > inPlaceTimestep_;
+
 }; // class UBB
 
 
@@ -132,9 +137,10 @@ inline UBB< LatticeModel_T, flag_t, AdaptVelocityToExternalForce >::Velocity::Ve
 
 
 template< typename LatticeModel_T, typename flag_t, bool AdaptVelocityToExternalForce >
-inline UBB< LatticeModel_T, flag_t, AdaptVelocityToExternalForce >::UBB( const BoundaryUID & boundaryUID, const FlagUID & uid, PDFField* const pdfField, FlagField<flag_t> * const flagField ) :
+inline UBB< LatticeModel_T, flag_t, AdaptVelocityToExternalForce >::UBB( const BoundaryUID & boundaryUID, const FlagUID & uid, PDFField* const pdfField, FlagField<flag_t> * const flagField,
+                                                                          const shared_ptr< const InPlaceTimestep > & inPlaceTimestep ) :
 
-   Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField )
+   Boundary<flag_t>( boundaryUID ), uid_( uid ), pdfField_( pdfField ), inPlaceTimestep_( inPlaceTimestep )
 {
    WALBERLA_ASSERT_NOT_NULLPTR( pdfField_ );
    if (flagField != NULL)
@@ -223,28 +229,31 @@ inline void UBB< LatticeModel_T, flag_t, AdaptVelocityToExternalForce >::treatDi
    WALBERLA_ASSERT_EQUAL( mask & this->mask_, this->mask_ ); // only true if "this->mask_" only contains one single flag, which is the case for the
                                                              // current implementation of this boundary condition (UBB)
 
+   if( skipBoundaryTreatment( inPlaceTimestep_.get() ) )
+      return;
+
    if( LatticeModel_T::compressible )
    {
-      const auto density  = pdfField_->getDensity(x,y,z);
+      const auto density  = postCollisionDensity( inPlaceTimestep_.get(), *pdfField_, x, y, z );
       const auto velocity = AdaptVelocityToExternalForce ? internal::AdaptVelocityToForce<LatticeModel_T>::get( x, y, z, pdfField_->latticeModel(), vel_->get(nx,ny,nz), density ) :
                                                            vel_->get(nx,ny,nz);
 
-      pdfField_->get( nx, ny, nz, Stencil::invDirIdx(dir) ) = pdfField_->get( x, y, z, Stencil::idx[dir] ) -
-                                                              ( real_c(6) * density * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
-                                                                 ( real_c(stencil::cx[ dir ]) * velocity[0] +
-                                                                   real_c(stencil::cy[ dir ]) * velocity[1] +
-                                                                   real_c(stencil::cz[ dir ]) * velocity[2] ) );
+      incomingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir, nx, ny, nz ) = outgoingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir ) -
+                                                                                    ( real_c(6) * density * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
+                                                                                       ( real_c(stencil::cx[ dir ]) * velocity[0] +
+                                                                                         real_c(stencil::cy[ dir ]) * velocity[1] +
+                                                                                         real_c(stencil::cz[ dir ]) * velocity[2] ) );
    }
    else
    {
       const auto velocity = AdaptVelocityToExternalForce ? internal::AdaptVelocityToForce<LatticeModel_T>::get( x, y, z, pdfField_->latticeModel(), vel_->get(nx,ny,nz), real_t(1) ) :
                                                            vel_->get(nx,ny,nz);
 
-      pdfField_->get( nx, ny, nz, Stencil::invDirIdx(dir) ) = pdfField_->get( x, y, z, Stencil::idx[dir] ) -
-                                                              ( real_c(6) * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
-                                                                 ( real_c(stencil::cx[ dir ]) * velocity[0] +
-                                                                   real_c(stencil::cy[ dir ]) * velocity[1] +
-                                                                   real_c(stencil::cz[ dir ]) * velocity[2] ) );
+      incomingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir, nx, ny, nz ) = outgoingPdf( inPlaceTimestep_.get(), *pdfField_, x, y, z, dir ) -
+                                                                                    ( real_c(6) * real_c(LatticeModel_T::w[ Stencil::idx[dir] ]) *
+                                                                                       ( real_c(stencil::cx[ dir ]) * velocity[0] +
+                                                                                         real_c(stencil::cy[ dir ]) * velocity[1] +
+                                                                                         real_c(stencil::cz[ dir ]) * velocity[2] ) );
    }
 }
 
@@ -0,0 +1,222 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file InPlacePdfFieldPackInfo.h
+//! \ingroup lbm
+//! \brief Communication of PDF fields that are updated with in-place ("AA pattern") streaming
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/field/InPlaceTimestep.h"
+#include "lbm/field/PdfField.h"
+
+#include "communication/UniformPackInfo.h"
+#include "core/cell/CellInterval.h"
+#include "core/debug/Debug.h"
+#include "stencil/Directions.h"
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+/**
+ * \brief PackInfo for PDF fields that are updated by an InPlaceSweep
+ *
+ * Which PDFs must be exchanged depends on the type of the next time step (see InPlaceTimestep):
+ *
+ * - Before an odd time step, the cells next to the block border pull the post-collision PDFs of the neighboring block
+ *   from the ghost layer. These PDFs are stored in the "inverse" slots, i.e., the components pointing away from the
+ *   receiver are copied from the sender's outermost inner slice into the receiver's ghost layer.
+ * - Before an even time step, the PDFs that the last odd time step pushed into the ghost layer are sent back to the
+ *   cells of the neighboring block they belong to, i.e., the components pointing towards the receiver are copied
+ *   from the sender's ghost layer into the receiver's outermost inner slice. Only PDFs that originate from an inner
+ *   cell of the sender are transferred, all other values in the ghost layer were not written by the last time step.
+ *
+ * Just like for PdfFieldPackInfo, only one ghost layer is communicated. Nothing is exchanged before the very first
+ * time step, the initial PDFs are expected to be in the regular layout in the inner part of every block.
+ *
+ * \ingroup lbm
+ */
+template< typename LatticeModel_T >
+class InPlacePdfFieldPackInfo : public walberla::communication::UniformPackInfo
+{
+public:
+
+   typedef PdfField< LatticeModel_T >        PdfField_T;
+   typedef typename LatticeModel_T::Stencil  Stencil;
+
+   InPlacePdfFieldPackInfo( const BlockDataID & pdfFieldId, const shared_ptr< const InPlaceTimestep > & timestep ) :
+      pdfFieldId_( pdfFieldId ), timestep_( timestep ) { WALBERLA_ASSERT_NOT_NULLPTR( timestep_ ); }
+   virtual ~InPlacePdfFieldPackInfo() {}
+
+   bool constantDataExchange() const { return false; }
+   bool threadsafeReceiving()  const { return true; }
+
+   void unpackData( IBlock * receiver, stencil::Direction dir, mpi::RecvBuffer & buffer );
+
+   void communicateLocal( const IBlock * sender, IBlock * receiver, stencil::Direction dir );
+
+protected:
+
+   void packDataImpl( const IBlock * sender, stencil::Direction dir, mpi::SendBuffer & outBuffer ) const;
+
+   /// the PDFs in 'pdfField' that are sent by a block to its neighbor in direction 'dir'
+   void getSendRegion   ( const PdfField_T & pdfField, const stencil::Direction dir, CellInterval & ci ) const;
+   /// the PDFs in 'pdfField' that are received from the neighbor in direction 'dir'
+   void getReceiveRegion( const PdfField_T & pdfField, const stencil::Direction dir, CellInterval & ci ) const;
+
+   /// checks whether component 'd' of cell 'cell' is exchanged, 'sourceRegion' contains all cells that are allowed to be
+   /// the origin of PDFs pushed into the ghost layer (sender: inner part of the block, receiver: ghost region of the sender)
+   bool isCommunicated( const CellInterval & sourceRegion, const Cell & cell, const stencil::Direction d ) const
+   {
+      return timestep_->isOdd() || sourceRegion.contains( cell.x() - cell_idx_c( stencil::cx[d] ),
+                                                          cell.y() - cell_idx_c( stencil::cy[d] ),
+                                                          cell.z() - cell_idx_c( stencil::cz[d] ) );
+   }
+
+   /// the components (pointing into 'dir' or into the opposite direction) that are sent to the neighbor in direction 'dir'
+   stencil::Direction sendDirection( const stencil::Direction dir ) const { return timestep_->isOdd() ? stencil::inverseDir[dir] : dir; }
+
+   bool communicationRequired() const { return !timestep_->isFirstStep(); }
+
+
+
+   const BlockDataID pdfFieldId_;
+
+   shared_ptr< const InPlaceTimestep > timestep_;
+};
+
+
+
+template< typename LatticeModel_T >
+void InPlacePdfFieldPackInfo< LatticeModel_T >::getSendRegion( const PdfField_T & pdfField, const stencil::Direction dir, CellInterval & ci ) const
+{
+   if( timestep_->isOdd() )
+      pdfField.getSliceBeforeGhostLayer( dir, ci, cell_idx_t(1), false );
+   else
+      pdfField.getGhostRegion( dir, ci, cell_idx_t(1), false );
+}
+
+
+
+template< typename LatticeModel_T >
+void InPlacePdfFieldPackInfo< LatticeModel_T >::getReceiveRegion( const PdfField_T & pdfField, const stencil::Direction dir, CellInterval & ci ) const
+{
+   if( timestep_->isOdd() )
+      pdfField.getGhostRegion( dir, ci, cell_idx_t(1), false );
+   else
+      pdfField.getSliceBeforeGhostLayer( dir, ci, cell_idx_t(1), false );
+}
+
+
+
+template< typename LatticeModel_T >
+void InPlacePdfFieldPackInfo< LatticeModel_T >::unpackData( IBlock * receiver, stencil::Direction dir, mpi::RecvBuffer & buffer )
+{
+   if( Stencil::idx[ stencil::inverseDir[dir] ] >= Stencil::Size || !communicationRequired() )
+      return;
+
+   PdfField_T * pdfField = receiver->getData< PdfField_T >( pdfFieldId_ );
+   WALBERLA_ASSERT_NOT_NULLPTR( pdfField );
+
+   const stencil::Direction packerDirection = sendDirection( stencil::inverseDir[dir] );
+
+   CellInterval ci;
+   getReceiveRegion( *pdfField, dir, ci );
+   CellInterval sourceRegion;
+   pdfField->getGhostRegion( dir, sourceRegion, cell_idx_t(1), false );
+
+   for( auto cell = ci.begin(); cell != ci.end(); ++cell )
+      for( uint_t f = 0; f < Stencil::d_per_d_length[packerDirection]; ++f )
+      {
+         const stencil::Direction d = Stencil::d_per_d[packerDirection][f];
+         if( isCommunicated( sourceRegion, *cell, d ) )
+            buffer >> pdfField->get( *cell, Stencil::idx[d] );
+      }
+}
+
+
+
+template< typename LatticeModel_T >
+void InPlacePdfFieldPackInfo< LatticeModel_T >::communicateLocal( const IBlock * sender, IBlock * receiver, stencil::Direction dir )
+{
+   if( Stencil::idx[dir] >= Stencil::Size || !communicationRequired() )
+      return;
+
+   const PdfField_T * sf = sender  ->getData< PdfField_T >( pdfFieldId_ );
+         PdfField_T * rf = receiver->getData< PdfField_T >( pdfFieldId_ );
+
+   WALBERLA_ASSERT_EQUAL( sf->xyzSize(), rf->xyzSize() );
+
+   const stencil::Direction packerDirection = sendDirection( dir );
+
+   CellInterval sci;
+   getSendRegion( *sf, dir, sci );
+   CellInterval rci;
+   getReceiveRegion( *rf, stencil::inverseDir[dir], rci );
+   const CellInterval sourceRegion = sf->xyzSize();
+
+   WALBERLA_ASSERT_EQUAL( sci.numCells(), rci.numCells() );
+
+   auto srcCell = sci.begin();
+   auto dstCell = rci.begin();
+   while( srcCell != sci.end() )
+   {
+      for( uint_t f = 0; f < Stencil::d_per_d_length[packerDirection]; ++f )
+      {
+         const stencil::Direction d = Stencil::d_per_d[packerDirection][f];
+         if( isCommunicated( sourceRegion, *srcCell, d ) )
+            rf->get( *dstCell, Stencil::idx[d] ) = sf->get( *srcCell, Stencil::idx[d] );
+      }
+      ++srcCell;
+      ++dstCell;
+   }
+   WALBERLA_ASSERT( dstCell == rci.end() );
+}
+
+
+
+template< typename LatticeModel_T >
+void InPlacePdfFieldPackInfo< LatticeModel_T >::packDataImpl( const IBlock * sender, stencil::Direction dir, mpi::SendBuffer & outBuffer ) const
+{
+   if( Stencil::idx[dir] >= Stencil::Size || !communicationRequired() )
+      return;
+
+   const PdfField_T * pdfField = sender->getData< PdfField_T >( pdfFieldId_ );
+   WALBERLA_ASSERT_NOT_NULLPTR( pdfField );
+
+   const stencil::Direction packerDirection = sendDirection( dir );
+
+   CellInterval ci;
+   getSendRegion( *pdfField, dir, ci );
+   const CellInterval sourceRegion = pdfField->xyzSize();
+
+   for( auto cell = ci.begin(); cell != ci.end(); ++cell )
+      for( uint_t f = 0; f < Stencil::d_per_d_length[packerDirection]; ++f )
+      {
+         const stencil::Direction d = Stencil::d_per_d[packerDirection][f];
+         if( isCommunicated( sourceRegion, *cell, d ) )
+            outBuffer << pdfField->get( *cell, Stencil::idx[d] );
+      }
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -0,0 +1,153 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SparsePdfListPackInfo.h
+//! \ingroup lbm
+//! \brief Communication of PDFs that are stored in a SparsePdfList
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/field/SparsePdfList.h"
+#include "communication/UniformPackInfo.h"
+#include "core/debug/Debug.h"
+#include "stencil/Directions.h"
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+/**
+ * \brief PackInfo for PDFs that are stored in a SparsePdfList
+ *
+ * Just like SparsePdfFieldPackInfo, only the PDFs of fluid cells and only the components pointing into the direction
+ * of the neighboring block are communicated. However, the cells that are sent/received are not determined by iterating
+ * the flag field in every communication step, but are taken from the exchange lists that are precomputed by the
+ * SparsePdfList. Hence, the amount of work per communication step is proportional to the number of fluid cells at the
+ * block border.
+ *
+ * The exchange lists of two neighboring blocks only match if the fluid flags in the ghost layer of a block are
+ * identical to the fluid flags of the corresponding inner cells of the neighbor.
+ *
+ * \ingroup lbm
+ */
+template< typename LatticeModel_T >
+class SparsePdfListPackInfo : public walberla::communication::UniformPackInfo
+{
+public:
+
+   typedef SparsePdfList< LatticeModel_T >   SparsePdfList_T;
+   typedef typename LatticeModel_T::Stencil  Stencil;
+
+   SparsePdfListPackInfo( const BlockDataID & pdfListId ) : pdfListId_( pdfListId ) {}
+   virtual ~SparsePdfListPackInfo() {}
+
+   bool constantDataExchange() const { return true; }
+   bool threadsafeReceiving()  const { return true; }
+
+   void unpackData( IBlock * receiver, stencil::Direction dir, mpi::RecvBuffer & buffer );
+
+   void communicateLocal( const IBlock * sender, IBlock * receiver, stencil::Direction dir );
+
+protected:
+
+   void packDataImpl( const IBlock * sender, stencil::Direction dir, mpi::SendBuffer & outBuffer ) const;
+
+   const BlockDataID pdfListId_;
+};
+
+
+
+template< typename LatticeModel_T >
+void SparsePdfListPackInfo< LatticeModel_T >::unpackData( IBlock * receiver, stencil::Direction dir, mpi::RecvBuffer & buffer )
+{
+   if( Stencil::idx[ stencil::inverseDir[dir] ] >= Stencil::Size )
+      return;
+
+   SparsePdfList_T * pdfList = receiver->getData< SparsePdfList_T >( pdfListId_ );
+   WALBERLA_ASSERT_NOT_NULLPTR( pdfList );
+
+   const stencil::Direction packerDirection = stencil::inverseDir[dir];
+   const auto & cells = pdfList->recvCells( dir );
+
+   WALBERLA_DEBUG_SECTION()
+   {
+      uint_t recvCtr = 0;
+      buffer >> recvCtr;
+      WALBERLA_ASSERT_EQUAL( cells.size(), recvCtr, "The number of cells packed by the sender and the number of cells to be unpacked do not match!\n" );
+   }
+
+   for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      for( uint_t f = 0; f < Stencil::d_per_d_length[packerDirection]; ++f )
+         buffer >> pdfList->get( *cell, Stencil::idx[ Stencil::d_per_d[packerDirection][f] ] );
+}
+
+
+
+template< typename LatticeModel_T >
+void SparsePdfListPackInfo< LatticeModel_T >::communicateLocal( const IBlock * sender, IBlock * receiver, stencil::Direction dir )
+{
+   if( Stencil::idx[dir] >= Stencil::Size )
+      return;
+
+   const SparsePdfList_T * senderList   = sender  ->getData< SparsePdfList_T >( pdfListId_ );
+         SparsePdfList_T * receiverList = receiver->getData< SparsePdfList_T >( pdfListId_ );
+
+   WALBERLA_ASSERT_NOT_NULLPTR( senderList );
+   WALBERLA_ASSERT_NOT_NULLPTR( receiverList );
+
+   const auto & sendCells = senderList->sendCells( dir );
+   const auto & recvCells = receiverList->recvCells( stencil::inverseDir[dir] );
+
+   WALBERLA_ASSERT_EQUAL( sendCells.size(), recvCells.size() );
+
+   for( uint_t i = 0; i != sendCells.size(); ++i )
+      for( uint_t f = 0; f < Stencil::d_per_d_length[dir]; ++f )
+      {
+         const uint_t idx = Stencil::idx[ Stencil::d_per_d[dir][f] ];
+         receiverList->get( recvCells[i], idx ) = senderList->get( sendCells[i], idx );
+      }
+}
+
+
+
+template< typename LatticeModel_T >
+void SparsePdfListPackInfo< LatticeModel_T >::packDataImpl( const IBlock * sender, stencil::Direction dir, mpi::SendBuffer & outBuffer ) const
+{
+   if( Stencil::idx[dir] >= Stencil::Size )
+      return;
+
+   const SparsePdfList_T * pdfList = sender->getData< SparsePdfList_T >( pdfListId_ );
+   WALBERLA_ASSERT_NOT_NULLPTR( pdfList );
+
+   const auto & cells = pdfList->sendCells( dir );
+
+   WALBERLA_DEBUG_SECTION()
+   {
+      outBuffer << uint_c( cells.size() );
+   }
+
+   for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      for( uint_t f = 0; f < Stencil::d_per_d_length[dir]; ++f )
+         outBuffer << pdfList->get( *cell, Stencil::idx[ Stencil::d_per_d[dir][f] ] );
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
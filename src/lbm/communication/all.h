@@ -22,7 +22,9 @@
 
 #pragma once
 
+#include "InPlacePdfFieldPackInfo.h"
 #include "PdfFieldMPIDatatypeInfo.h"
 #include "PdfFieldPackInfo.h"
+#include "SparsePdfListPackInfo.h"
 
 
@@ -0,0 +1,183 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file InPlaceTimestep.h
+//! \ingroup lbm
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/field/MacroscopicValueCalculation.h"
+#include "lbm/field/PdfField.h"
+
+#include "core/DataTypes.h"
+#include "stencil/Directions.h"
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Keeps track of the time step parity of the in-place ("AA pattern") streaming scheme
+*
+*   With in-place streaming, only one PDF field is allocated and the memory layout of the PDFs alternates between even
+*   and odd time steps:
+*
+*   - Before an even time step, the field is in its regular layout, i.e., the PDF f_i of cell x is stored in slot i of
+*     cell x. The even time step only collides: the post-collision value of f_i is written back into slot inv(i) of
+*     the same cell x.
+*   - Before an odd time step, the post-collision value of f_i of cell x is stored in slot inv(i) of cell x. The odd
+*     time step pulls f_i from slot inv(i) of cell x - c_i, collides, and pushes the post-collision value of f_i into
+*     slot i of cell x + c_i. Afterwards, the field is again in its regular layout.
+*
+*   Since every cell reads and writes exactly the same memory locations during one step, no second (destination) PDF
+*   field is required. The sweep (InPlaceSweep), the communication (InPlacePdfFieldPackInfo), and the boundary
+*   conditions (NoSlip, UBB, SimpleUBB) all need to know which of the two steps comes next. They therefore share one
+*   instance of this class, which must be advanced exactly once after each LBM time step (typically as an
+*   AfterFunction of the time loop step that contains the InPlaceSweep).
+*/
+//**********************************************************************************************************************
+
+class InPlaceTimestep
+{
+public:
+
+   InPlaceTimestep() : counter_( uint_t(0) ) {}
+
+   uint_t counter() const { return counter_; }
+
+   /// returns true if the next LBM time step that is executed is an even ("collide only") step
+   bool isEven() const { return ( counter_ & uint_t(1) ) == uint_t(0); }
+   /// returns true if the next LBM time step that is executed is an odd ("pull, collide, push") step
+   bool isOdd() const { return !isEven(); }
+
+   /// before the very first time step, neither communication nor boundary handling is required: the initial PDFs are
+   /// expected to be stored in the regular layout
+   bool isFirstStep() const { return counter_ == uint_t(0); }
+
+   void advance() { ++counter_; }
+   void operator()() { advance(); }
+
+   /// PDF that leaves cell (x,y,z) in direction 'dir' during the next stream step (= its post-collision value)
+   template< typename PdfField_T >
+   inline typename PdfField_T::value_type & outgoing( PdfField_T & pdfField, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z,
+                                                      const stencil::Direction dir ) const;
+
+   /// slot into which the PDF that enters cell (x,y,z) from its neighbor in direction 'dir' during the next stream step must be written
+   template< typename PdfField_T >
+   inline typename PdfField_T::value_type & incoming( PdfField_T & pdfField, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z,
+                                                      const stencil::Direction dir ) const;
+
+   /// density of cell (x,y,z) computed from its post-collision PDFs (only meaningful for cells that were part of the last LBM step)
+   template< typename LatticeModel_T >
+   inline real_t getDensity( PdfField< LatticeModel_T > & pdfField, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z ) const;
+
+private:
+
+   uint_t counter_;
+};
+
+
+
+template< typename PdfField_T >
+inline typename PdfField_T::value_type & InPlaceTimestep::outgoing( PdfField_T & pdfField, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z,
+                                                                   const stencil::Direction dir ) const
+{
+   typedef typename PdfField_T::LatticeModel::Stencil Stencil;
+
+   if( isEven() )
+      return pdfField.get( x + cell_idx_c( stencil::cx[dir] ), y + cell_idx_c( stencil::cy[dir] ), z + cell_idx_c( stencil::cz[dir] ), Stencil::idx[dir] );
+   return pdfField.get( x, y, z, Stencil::invDirIdx(dir) );
+}
+
+
+
+template< typename PdfField_T >
+inline typename PdfField_T::value_type & InPlaceTimestep::incoming( PdfField_T & pdfField, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z,
+                                                                   const stencil::Direction dir ) const
+{
+   typedef typename PdfField_T::LatticeModel::Stencil Stencil;
+
+   if( isEven() )
+      return pdfField.get( x, y, z, Stencil::invDirIdx(dir) );
+   return pdfField.get( x + cell_idx_c( stencil::cx[dir] ), y + cell_idx_c( stencil::cy[dir] ), z + cell_idx_c( stencil::cz[dir] ), Stencil::idx[dir] );
+}
+
+
+
+template< typename LatticeModel_T >
+inline real_t InPlaceTimestep::getDensity( PdfField< LatticeModel_T > & pdfField, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z ) const
+{
+   typedef typename LatticeModel_T::Stencil Stencil;
+
+   real_t pdfs[ Stencil::Size ];
+   for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+      pdfs[ d.toIdx() ] = outgoing( pdfField, x, y, z, *d );
+
+   return lbm::getDensity( pdfField.latticeModel(), pdfs );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Functions for boundary conditions that work with both the regular two-field and the in-place PDF layout
+*
+*   If 'timestep' is NULL, the regular layout is assumed (post-collision PDFs stored in the cell they belong to,
+*   incoming PDFs pulled from the neighbor cell), otherwise the layout of the in-place streaming scheme is used.
+*/
+//**********************************************************************************************************************
+
+inline bool skipBoundaryTreatment( const InPlaceTimestep * const timestep )
+{
+   return timestep != NULL && timestep->isFirstStep();
+}
+
+template< typename PdfField_T >
+inline typename PdfField_T::value_type & outgoingPdf( const InPlaceTimestep * const timestep, PdfField_T & pdfField,
+                                                      const cell_idx_t x, const cell_idx_t y, const cell_idx_t z, const stencil::Direction dir )
+{
+   if( timestep != NULL )
+      return timestep->outgoing( pdfField, x, y, z, dir );
+   return pdfField.get( x, y, z, PdfField_T::Stencil::idx[dir] );
+}
+
+template< typename PdfField_T >
+inline typename PdfField_T::value_type & incomingPdf( const InPlaceTimestep * const timestep, PdfField_T & pdfField,
+                                                      const cell_idx_t  x, const cell_idx_t  y, const cell_idx_t  z, const stencil::Direction dir,
+                                                      const cell_idx_t nx, const cell_idx_t ny, const cell_idx_t nz )
+{
+   if( timestep != NULL )
+      return timestep->incoming( pdfField, x, y, z, dir );
+   return pdfField.get( nx, ny, nz, PdfField_T::Stencil::invDirIdx(dir) );
+}
+
+template< typename LatticeModel_T >
+inline real_t postCollisionDensity( const InPlaceTimestep * const timestep, PdfField< LatticeModel_T > & pdfField,
+                                    const cell_idx_t x, const cell_idx_t y, const cell_idx_t z )
+{
+   if( timestep != NULL )
+      return timestep->getDensity( pdfField, x, y, z );
+   return pdfField.getDensity( x, y, z );
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -0,0 +1,375 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SparsePdfList.h
+//! \ingroup lbm
+//! \brief List-based storage of the PDFs of all fluid cells of a block
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/field/MacroscopicValueCalculation.h"
+#include "lbm/lattice_model/EquilibriumDistribution.h"
+
+#include "core/DataTypes.h"
+#include "core/Set.h"
+#include "core/cell/Cell.h"
+#include "core/cell/CellInterval.h"
+#include "core/debug/CheckFunctions.h"
+#include "core/debug/Debug.h"
+#include "core/math/Vector3.h"
+
+#include "domain_decomposition/StructuredBlockStorage.h"
+
+#include "field/FlagField.h"
+#include "field/FlagUID.h"
+#include "field/GhostLayerField.h"
+
+#include "stencil/D3Q27.h"
+#include "stencil/Directions.h"
+
+#include <limits>
+#include <vector>
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Stores the PDFs of the fluid cells of one block in a compact array (sparse/list-based LBM)
+*
+*   For geometries with a low fluid fraction (porous media, packed beds, ...), storing and sweeping the full dense
+*   PdfField wastes most of the memory and of the memory bandwidth. A SparsePdfList only stores the PDFs of the fluid
+*   cells of the block plus the PDFs of the fluid cells in the first ghost layer (which are required for streaming and
+*   filled by the SparsePdfListPackInfo). The PDFs are stored in a "structure of arrays" layout: all PDFs of direction
+*   f are stored contiguously, the PDF f of cell i is located at index f * numberOfCells() + i.
+*
+*   For every inner fluid cell and every direction f, the index of the PDF that is pulled during the stream step is
+*   precomputed (pull index list). Links to non-fluid cells are resolved during construction:
+*   - links to cells marked with the velocity bounce back flag point to a "boundary slot" stored after the PDFs. Before
+*     each stream step, these slots are set to the bounced back PDF including the velocity correction (see SimpleUBB).
+*   - all other links to non-fluid cells are treated as no slip walls (see NoSlip): they directly point to the
+*     post-collision PDF with the inverse direction of the same cell.
+*
+*   Inner cells are ordered like the cells of a field (x fastest, then y, then z), ghost layer cells follow after all
+*   inner cells. For every communication direction, the lists of inner cells that must be sent and of ghost layer cells
+*   that are received are precomputed as well.
+*
+*   Memory and runtime scale with the number of fluid cells. A dense flag field is only required during construction.
+*   The fluid/boundary structure of the block must not change after the construction and the flag field must be
+*   consistent in the ghost layer (i.e., a fluid cell in the ghost layer must be a fluid cell of the neighboring block).
+*/
+//**********************************************************************************************************************
+
+template< typename LatticeModel_T >
+class SparsePdfList
+{
+public:
+
+   typedef LatticeModel_T                    LatticeModel;
+   typedef typename LatticeModel_T::Stencil  Stencil;
+
+   typedef uint32_t index_t;
+
+   /// a PDF that is bounced back at a moving wall: boundary slot value = pdf - coefficient * density( cell )
+   struct VelocityBounceBackLink
+   {
+      index_t cell;
+      index_t pdf;
+      real_t  coefficient;
+   };
+
+   template< typename FlagField_T >
+   SparsePdfList( const LatticeModel_T & latticeModel, const FlagField_T & flagField,
+                  const typename FlagField_T::flag_t fluid, const typename FlagField_T::flag_t velocityBounceBack,
+                  const Vector3< real_t > & wallVelocity, const Vector3< real_t > & initialVelocity, const real_t initialDensity );
+
+   bool operator==( const SparsePdfList & other ) const { return cells_ == other.cells_ && src_ == other.src_; }
+
+   const LatticeModel_T & latticeModel() const { return latticeModel_; }
+
+   uint_t numberOfCells()      const { return cells_.size(); }
+   uint_t numberOfInnerCells() const { return numberOfInnerCells_; }
+
+   const Cell & cell( const uint_t i ) const { WALBERLA_ASSERT_LESS( i, cells_.size() ); return cells_[i]; }
+
+   uint_t pdfIndex( const uint_t i, const uint_t f ) const { return f * cells_.size() + i; }
+
+         real_t & get( const uint_t i, const uint_t f )       { return src_[ pdfIndex( i, f ) ]; }
+   const real_t & get( const uint_t i, const uint_t f ) const { return src_[ pdfIndex( i, f ) ]; }
+
+   inline real_t getDensity( const uint_t i ) const;
+   inline real_t getDensityAndVelocity( Vector3< real_t > & velocity, const uint_t i ) const;
+
+         real_t * src()       { return src_.data(); }
+   const real_t * src() const { return src_.data(); }
+         real_t * dst()       { return dst_.data(); }
+
+   void swap() { src_.swap( dst_ ); }
+
+   /// pull index of direction f of inner cell i: pullIndices()[ f * numberOfInnerCells() + i ]
+   const std::vector< index_t > & pullIndices() const { return pull_; }
+
+   /// the boundary slot of link k is stored at index Stencil::Size * numberOfCells() + k
+   const std::vector< VelocityBounceBackLink > & velocityBounceBackLinks() const { return velocityBounceBackLinks_; }
+
+   /// inner cells whose PDFs are sent to the neighbor in direction 'dir'
+   const std::vector< index_t > & sendCells( const stencil::Direction dir ) const { return sendCells_[dir]; }
+   /// ghost layer cells whose PDFs are received from the neighbor in direction 'dir'
+   const std::vector< index_t > & recvCells( const stencil::Direction dir ) const { return recvCells_[dir]; }
+
+   /// memory (in bytes) allocated for storing the PDFs and all index lists
+   inline uint_t allocatedBytes() const;
+
+private:
+
+   static const index_t InvalidIndex = std::numeric_limits< index_t >::max();
+
+   LatticeModel_T latticeModel_;
+
+   std::vector< Cell > cells_;
+   uint_t numberOfInnerCells_;
+
+   std::vector< real_t > src_;
+   std::vector< real_t > dst_;
+
+   std::vector< index_t > pull_;
+   std::vector< VelocityBounceBackLink > velocityBounceBackLinks_;
+
+   std::vector< index_t > sendCells_[ stencil::NR_OF_DIRECTIONS ];
+   std::vector< index_t > recvCells_[ stencil::NR_OF_DIRECTIONS ];
+};
+
+
+
+template< typename LatticeModel_T >
+template< typename FlagField_T >
+SparsePdfList< LatticeModel_T >::SparsePdfList( const LatticeModel_T & latticeModel, const FlagField_T & flagField,
+                                                const typename FlagField_T::flag_t fluid, const typename FlagField_T::flag_t velocityBounceBack,
+                                                const Vector3< real_t > & wallVelocity, const Vector3< real_t > & initialVelocity, const real_t initialDensity ) :
+   latticeModel_( latticeModel ), numberOfInnerCells_( uint_t(0) )
+{
+   WALBERLA_CHECK_GREATER_EQUAL( flagField.nrOfGhostLayers(), uint_t(1) );
+
+   // temporary, dense mapping from cells to list indices (only required during construction)
+
+   GhostLayerField< index_t, 1 > index( flagField.xSize(), flagField.ySize(), flagField.zSize(), uint_t(1), InvalidIndex );
+
+   const CellInterval inner = flagField.xyzSize();
+   CellInterval withGhostLayer( inner );
+   withGhostLayer.expand( cell_idx_t(1) );
+
+   for( auto cell = inner.begin(); cell != inner.end(); ++cell )
+   {
+      if( flagField.isPartOfMaskSet( *cell, fluid ) )
+      {
+         index.get( *cell ) = index_t( cells_.size() );
+         cells_.push_back( *cell );
+      }
+   }
+   numberOfInnerCells_ = cells_.size();
+
+   for( auto cell = withGhostLayer.begin(); cell != withGhostLayer.end(); ++cell )
+   {
+      if( !inner.contains( *cell ) && flagField.isPartOfMaskSet( *cell, fluid ) )
+      {
+         index.get( *cell ) = index_t( cells_.size() );
+         cells_.push_back( *cell );
+      }
+   }
+
+   WALBERLA_CHECK_LESS( ( Stencil::Size + uint_t(1) ) * cells_.size(), uint_c( InvalidIndex ),
+                        "Too many fluid cells in one block for the index type of lbm::SparsePdfList!" );
+
+   const uint_t n = cells_.size();
+
+   // pull indices and boundary links
+
+   pull_.resize( Stencil::Size * numberOfInnerCells_ );
+   for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+   {
+      for( uint_t i = uint_t(0); i != numberOfInnerCells_; ++i )
+      {
+         const Cell neighbor = cells_[i] - Cell( d.cx(), d.cy(), d.cz() );
+         index_t & pull = pull_[ d.toIdx() * numberOfInnerCells_ + i ];
+
+         if( index.get( neighbor ) != InvalidIndex )
+         {
+            pull = index_t( pdfIndex( index.get( neighbor ), d.toIdx() ) );
+         }
+         else if( flagField.isPartOfMaskSet( neighbor, velocityBounceBack ) )
+         {
+            const stencil::Direction inv = d.inverseDir();
+
+            VelocityBounceBackLink link;
+            link.cell        = index_t( i );
+            link.pdf         = index_t( pdfIndex( i, d.toInvIdx() ) );
+            link.coefficient = real_t(6) * real_c( LatticeModel_T::w[ d.toInvIdx() ] ) * ( real_c( stencil::cx[ inv ] ) * wallVelocity[0] +
+                                                                                          real_c( stencil::cy[ inv ] ) * wallVelocity[1] +
+                                                                                          real_c( stencil::cz[ inv ] ) * wallVelocity[2] );
+
+            pull = index_t( Stencil::Size * n + velocityBounceBackLinks_.size() );
+            velocityBounceBackLinks_.push_back( link );
+         }
+         else
+         {
+            pull = index_t( pdfIndex( i, d.toInvIdx() ) ); // no slip
+         }
+      }
+   }
+
+   // communication lists
+
+   for( auto dir = stencil::D3Q27::beginNoCenter(); dir != stencil::D3Q27::end(); ++dir )
+   {
+      CellInterval send;
+      flagField.getSliceBeforeGhostLayer( *dir, send, cell_idx_t(1), false );
+      for( auto cell = send.begin(); cell != send.end(); ++cell )
+         if( index.get( *cell ) != InvalidIndex )
+            sendCells_[ *dir ].push_back( index.get( *cell ) );
+
+      CellInterval recv;
+      flagField.getGhostRegion( *dir, recv, cell_idx_t(1), false );
+      for( auto cell = recv.begin(); cell != recv.end(); ++cell )
+         if( index.get( *cell ) != InvalidIndex )
+            recvCells_[ *dir ].push_back( index.get( *cell ) );
+   }
+
+   // initialization with the equilibrium distribution
+
+   src_.resize( Stencil::Size * n + velocityBounceBackLinks_.size(), real_t(0) );
+   for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+   {
+      const real_t pdf = EquilibriumDistribution< LatticeModel_T >::get( *d, initialVelocity, initialDensity );
+      for( uint_t i = uint_t(0); i != n; ++i )
+         src_[ pdfIndex( i, d.toIdx() ) ] = pdf;
+   }
+   dst_ = src_;
+}
+
+
+
+template< typename LatticeModel_T >
+inline real_t SparsePdfList< LatticeModel_T >::getDensity( const uint_t i ) const
+{
+   real_t pdfs[ Stencil::Size ];
+   for( uint_t f = uint_t(0); f != Stencil::Size; ++f )
+      pdfs[f] = get( i, f );
+   return lbm::getDensity( latticeModel_, pdfs );
+}
+
+
+
+template< typename LatticeModel_T >
+inline real_t SparsePdfList< LatticeModel_T >::getDensityAndVelocity( Vector3< real_t > & velocity, const uint_t i ) const
+{
+   real_t pdfs[ Stencil::Size ];
+   for( uint_t f = uint_t(0); f != Stencil::Size; ++f )
+      pdfs[f] = get( i, f );
+   return lbm::getDensityAndVelocity( velocity, latticeModel_, pdfs );
+}
+
+
+
+template< typename LatticeModel_T >
+inline uint_t SparsePdfList< LatticeModel_T >::allocatedBytes() const
+{
+   uint_t bytes = ( src_.capacity() + dst_.capacity() ) * sizeof( real_t ) + pull_.capacity() * sizeof( index_t ) +
+                  cells_.capacity() * sizeof( Cell ) + velocityBounceBackLinks_.capacity() * sizeof( VelocityBounceBackLink );
+   for( uint_t dir = uint_t(0); dir != stencil::NR_OF_DIRECTIONS; ++dir )
+      bytes += ( sendCells_[dir].capacity() + recvCells_[dir].capacity() ) * sizeof( index_t );
+   return bytes;
+}
+
+
+
+namespace internal {
+
+template< typename LatticeModel_T, typename FlagField_T >
+class SparsePdfListCreator
+{
+public:
+
+   SparsePdfListCreator( const LatticeModel_T & latticeModel, const ConstBlockDataID & flagFieldId, const Set< FlagUID > & fluid,
+                         const FlagUID & velocityBounceBack, const Vector3< real_t > & wallVelocity,
+                         const Vector3< real_t > & initialVelocity, const real_t initialDensity ) :
+      latticeModel_( latticeModel ), flagFieldId_( flagFieldId ), fluid_( fluid ), velocityBounceBack_( velocityBounceBack ),
+      wallVelocity_( wallVelocity ), initialVelocity_( initialVelocity ), initialDensity_( initialDensity ) {}
+
+   SparsePdfList< LatticeModel_T > * operator()( IBlock * const block, StructuredBlockStorage * const storage )
+   {
+      const FlagField_T * flagField = block->getData< FlagField_T >( flagFieldId_ );
+      WALBERLA_CHECK_NOT_NULLPTR( flagField, "The flag field must be added to the block storage before the sparse PDF list!" );
+
+      const auto fluid = flagField->getMask( fluid_ );
+      const auto velocityBounceBack = flagField->flagExists( velocityBounceBack_ ) ? flagField->getFlag( velocityBounceBack_ ) :
+                                                                                     typename FlagField_T::flag_t(0);
+
+      LatticeModel_T latticeModel = latticeModel_;
+      latticeModel.configure( *block, *storage );
+
+      return new SparsePdfList< LatticeModel_T >( latticeModel, *flagField, fluid, velocityBounceBack, wallVelocity_, initialVelocity_, initialDensity_ );
+   }
+
+private:
+
+   LatticeModel_T latticeModel_;
+
+   ConstBlockDataID flagFieldId_;
+   Set< FlagUID > fluid_;
+   FlagUID velocityBounceBack_;
+   Vector3< real_t > wallVelocity_;
+
+   Vector3< real_t > initialVelocity_;
+   real_t initialDensity_;
+};
+
+} // namespace internal
+
+
+
+/// Adds a SparsePdfList to every block. All cells that are marked with one of the flags in 'fluid' are stored. Links to
+/// non-fluid cells are treated as no slip walls.
+template< typename LatticeModel_T, typename FlagField_T >
+BlockDataID addSparsePdfListToStorage( const shared_ptr< StructuredBlockStorage > & blocks, const std::string & identifier,
+                                       const LatticeModel_T & latticeModel, const ConstBlockDataID & flagFieldId, const Set< FlagUID > & fluid,
+                                       const Vector3< real_t > & initialVelocity = Vector3< real_t >(), const real_t initialDensity = real_t(1) )
+{
+   return blocks->addStructuredBlockData< SparsePdfList< LatticeModel_T > >(
+            internal::SparsePdfListCreator< LatticeModel_T, FlagField_T >( latticeModel, flagFieldId, fluid, FlagUID(), Vector3< real_t >(),
+                                                                           initialVelocity, initialDensity ), identifier );
+}
+
+/// Same as above, but links to cells marked with 'velocityBounceBack' are treated as velocity bounce back walls that
+/// move with 'wallVelocity' (see SimpleUBB).
+template< typename LatticeModel_T, typename FlagField_T >
+BlockDataID addSparsePdfListToStorage( const shared_ptr< StructuredBlockStorage > & blocks, const std::string & identifier,
+                                       const LatticeModel_T & latticeModel, const ConstBlockDataID & flagFieldId, const Set< FlagUID > & fluid,
+                                       const FlagUID & velocityBounceBack, const Vector3< real_t > & wallVelocity,
+                                       const Vector3< real_t > & initialVelocity = Vector3< real_t >(), const real_t initialDensity = real_t(1) )
+{
+   return blocks->addStructuredBlockData< SparsePdfList< LatticeModel_T > >(
+            internal::SparsePdfListCreator< LatticeModel_T, FlagField_T >( latticeModel, flagFieldId, fluid, velocityBounceBack, wallVelocity,
+                                                                           initialVelocity, initialDensity ), identifier );
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -25,8 +25,10 @@
 #include "Adaptors.h"
 #include "AddToStorage.h"
 #include "DensityVelocityCallback.h"
+#include "InPlaceTimestep.h"
 #include "MacroscopicValueCalculation.h"
 #include "PdfField.h"
+#include "SparsePdfList.h"
 #include "VelocityFieldWriter.h"
 
 #include "initializer/all.h"
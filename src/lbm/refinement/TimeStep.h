@@ -153,6 +153,18 @@ public:
       pdfPackInfo_->optimizeForLinearExplosion( optimizedCommunication_ && performLinearExplosion_ );
    }
 
+   /// If enabled, stream and collide are fused for all blocks of the intermediate levels that do not have finer
+   /// neighbors (these blocks are not affected by the fine to coarse communication). These blocks are processed while
+   /// the fine to coarse communication is still in progress, only the remaining blocks wait for its completion.
+   /// Levels with registered post boundary handling/stream/collide void functions are never fused.
+   bool fusedStreamCollideIsUsed() const { return fusedStreamCollide_; }
+   void useFusedStreamCollide( const bool value = true )
+   {
+      fusedStreamCollide_ = value;
+      if( timing_ )
+         createTimers( postCollideVoidFunctions_.size() );
+   }
+
    void deactivateTiming() { timing_ = false; }
    void enableTiming( const shared_ptr<WcTimingPool> & timingPool, const shared_ptr<WcTimingPool> & levelwiseTimingPool )
    {
@@ -259,6 +271,7 @@ private:
    void stream( std::vector< Block * > & blocks, const uint_t level, const uint_t executionCount );
    void finishStream( std::vector< Block * > & blocks, const uint_t level, const uint_t executionCount );
    void streamCollide( std::vector< Block * > & blocks, const uint_t level, const uint_t executionCount );
+   void fusedStreamCollide( std::vector< Block * > & blocks, const uint_t level, const uint_t executionCount1st, const uint_t executionCount2nd );
 
    void startCommunicationEqualLevel( const uint_t level );
    void   endCommunicationEqualLevel( const uint_t level );
@@ -292,6 +305,8 @@ private:
    bool performLinearExplosion_;
    LinearExplosion< LatticeModel_T, BoundaryHandling_T > linearExplosion_;
 
+   bool fusedStreamCollide_;
+
    bool timing_;
    shared_ptr<WcTimingPool> timingPool_;
    shared_ptr<WcTimingPool> levelwiseTimingPool_;
@@ -341,7 +356,7 @@ TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::TimeStep( weak_ptr< Str
    communication_( blocks, requiredBlockSelectors, incompatibleBlockSelectors ),
    performEqualLevelBorderStreamCorrection_( true ), equalLevelBorderStreamCorrection_( pdfFieldId ),
    performLinearExplosion_( true ), linearExplosion_( pdfFieldId, boundaryHandlingId ),
-   timing_( false ),
+   fusedStreamCollide_( false ), timing_( false ),
    requiredBlockSelectors_( requiredBlockSelectors ), incompatibleBlockSelectors_( incompatibleBlockSelectors )
 {
    init( pdfFieldId, boundaryHandlingId );
@@ -363,7 +378,7 @@ TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::TimeStep( weak_ptr< Str
    communication_( blocks, requiredBlockSelectors, incompatibleBlockSelectors ),
    performEqualLevelBorderStreamCorrection_( true ), equalLevelBorderStreamCorrection_( pdfFieldId ),
    performLinearExplosion_( true ), linearExplosion_( pdfFieldId, boundaryHandlingId ),
-   timing_( false ),
+   fusedStreamCollide_( false ), timing_( false ),
    requiredBlockSelectors_( requiredBlockSelectors ), incompatibleBlockSelectors_( incompatibleBlockSelectors )
 {
    init( pdfFieldId, boundaryHandlingId );
@@ -819,6 +834,8 @@ void TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::createTimers( cons
       timers.push_back( getLevelwiseTimingPoolString( "stream & collide", levels - uint_t(1) ) );
       for( uint_t i = uint_t(0); i < levels; ++i )
       {
+         if( fusedStreamCollide_ && i != uint_t(0) && i != ( levels - uint_t(1) ) )
+            timers.push_back( getLevelwiseTimingPoolString( "stream & collide", i ) );
          timers.push_back( getLevelwiseTimingPoolString( "boundary handling", i ) );
          timers.push_back( getLevelwiseTimingPoolString( "collide", i ) );
          timers.push_back( getLevelwiseTimingPoolString( "communication equal level", i, "[pack & send]" ) );
@@ -1180,7 +1197,12 @@ void TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::streamCollide( std
 #ifndef NDEBUG
    auto _blocks = blocks_.lock();
    WALBERLA_CHECK_NOT_NULLPTR( _blocks, "Trying to access 'TimeStep' (refinement) for a block storage object that doesn't exist anymore" );
-   WALBERLA_ASSERT_EQUAL( level, _blocks->getNumberOfLevels() - uint_t(1) );
+   if( level != _blocks->getNumberOfLevels() - uint_t(1) ) // only blocks that are not involved in the fine to coarse communication
+   {
+      for( auto block = blocks.begin(); block != blocks.end(); ++block )
+         for( uint_t i = uint_t(0); i < uint_t(26); ++i )
+            WALBERLA_ASSERT( !(*block)->neighborhoodSectionHasSmallerBlocks(i) );
+   }
 #endif
 
    if( postStreamVoidFunctions_[level].empty() )
@@ -1449,6 +1471,49 @@ void TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::streamCollide( std
 
 
 
+template< typename LatticeModel_T, typename Sweep_T, typename BoundaryHandling_T >
+void TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::fusedStreamCollide( std::vector< Block * > & blocks, const uint_t level,
+                                                                                   const uint_t executionCount1st, const uint_t executionCount2nd )
+{
+   // replaces "stream -> wait for fine to coarse communication -> finish stream -> collide" on intermediate levels
+
+   std::vector< Block * > interiorBlocks;
+   std::vector< Block * > borderBlocks;
+
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+   {
+      bool finerNeighbors = false;
+      for( uint_t i = uint_t(0); i < uint_t(26) && !finerNeighbors; ++i )
+         finerNeighbors = (*block)->neighborhoodSectionHasSmallerBlocks(i);
+
+      if( finerNeighbors )
+         borderBlocks.push_back( *block );
+      else
+         interiorBlocks.push_back( *block );
+   }
+
+   WALBERLA_LOG_DETAIL("Stream on level " << level << " (blocks with finer neighbors)" );
+   stream( borderBlocks, level, executionCount1st );
+
+   WALBERLA_LOG_DETAIL("Stream + collide on level " << level << " (blocks without finer neighbors)" );
+   streamCollide( interiorBlocks, level, executionCount1st );
+
+   if( !asynchronousCommunication_ ) {
+      WALBERLA_LOG_DETAIL("Start communication fine to coarse, initiated by coarse level " << level );
+      startCommunicationFineToCoarse( level + uint_t(1) ); // [start] coalescence (initiated by coarse level)
+   }
+   WALBERLA_LOG_DETAIL("End communication fine to coarse, initiated by coarse level " << level );
+   endCommunicationFineToCoarse( level + uint_t(1) ); // [end] coalescence (initiated by coarse level)
+
+   WALBERLA_LOG_DETAIL("Finish stream on level " << level << " (blocks with finer neighbors)" );
+   finishStream( borderBlocks, level, executionCount1st );
+
+   WALBERLA_LOG_DETAIL("Colliding on level " << level << " (blocks with finer neighbors)" );
+   collide( borderBlocks, level, executionCount2nd );
+}
+
+
+
 template< typename LatticeModel_T, typename Sweep_T, typename BoundaryHandling_T >
 void TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::startCommunicationEqualLevel( const uint_t level )
 {
@@ -1645,6 +1710,11 @@ void TimeStep< LatticeModel_T, Sweep_T, BoundaryHandling_T >::recursiveStep( con
       WALBERLA_LOG_DETAIL("Stream + collide on level " << level );
       streamCollide( blocks, level, executionCount1st );
    }
+   else if( fusedStreamCollide_ && level != finestLevel && level != coarsestLevel && postBoundaryHandlingVoidFunctions_[level].empty() &&
+            postStreamVoidFunctions_[level].empty() && postCollideVoidFunctions_[level].empty() )
+   {
+      fusedStreamCollide( blocks, level, executionCount1st, executionCount2nd );
+   }
    else
    {
       WALBERLA_LOG_DETAIL("Stream on level " << level );
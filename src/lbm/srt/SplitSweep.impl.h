@@ -83,7 +83,23 @@ public:
    SplitSweep( const BlockDataID & src, const BlockDataID & dst, const ConstBlockDataID & flagField, const Set< FlagUID > & lbmMask ) :
       FlagFieldSweepBase<LatticeModel_T,FlagField_T>( src, dst, flagField, lbmMask ) {}
 
-   void operator()( IBlock * const block );
+   void operator()( IBlock * const block )
+   {
+      (*this)( block, this->getSrcField( block )->xyzSize() );
+      swap( block );
+   }
+
+   /// stream & collide restricted to 'cells', src and dst are NOT swapped (required for splitting the sweep into
+   /// an inner and an outer part, see domain_decomposition/InnerOuterSplit.h - requires a dedicated dst field)
+   void operator()( IBlock * const block, const CellInterval & cells );
+
+   void swap( IBlock * const block )
+   {
+      PdfField_T * src( NULL );
+      PdfField_T * dst( NULL );
+      this->getFields( block, src, dst );
+      src->swapDataPointers( dst );
+   }
 
    void stream ( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
    void collide( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
@@ -97,8 +113,11 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
                                                                                            boost::mpl::not_< boost::mpl::bool_< LatticeModel_T::compressible > >,
                                                                                            boost::is_same< typename LatticeModel_T::ForceModel::tag,
                                                                                                            force_model::None_tag > > >::type
-   >::operator()( IBlock * const block )
+   >::operator()( IBlock * const block, const CellInterval & cells )
 {
+   if( cells.empty() )
+      return;
+
    PdfField_T * src( NULL );
    PdfField_T * dst( NULL );
    const FlagField_T * flagField( NULL );
@@ -106,6 +125,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
    auto lbm = this->getLbmMaskAndFields( block, src, dst, flagField );
 
    WALBERLA_ASSERT_GREATER_EQUAL( src->nrOfGhostLayers(), 1 );
+   WALBERLA_ASSERT( src->xyzSize().contains( cells ) );
 
    // constants used during stream/collide
 
@@ -121,6 +141,9 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    const cell_idx_t xSize = cell_idx_c( src->xSize() );
 
+   const cell_idx_t xBegin = cells.xMin();
+   const cell_idx_t xEnd   = cells.xMax() + cell_idx_t(1);
+
 #ifdef _OPENMP
    #pragma omp parallel
    {
@@ -137,7 +160,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    if( src->layout() == field::fzyx && dst->layout() == field::fzyx )
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
@@ -163,7 +186,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
          real_t * WALBERLA_RESTRICT dC = &dst->get(0,y,z,Stencil::idx[C]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -189,7 +212,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dNW = &dst->get(0,y,z,Stencil::idx[NW]);
          real_t * WALBERLA_RESTRICT dSE = &dst->get(0,y,z,Stencil::idx[SE]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -204,7 +227,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dNE = &dst->get(0,y,z,Stencil::idx[NE]);
          real_t * WALBERLA_RESTRICT dSW = &dst->get(0,y,z,Stencil::idx[SW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -219,7 +242,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTW = &dst->get(0,y,z,Stencil::idx[TW]);
          real_t * WALBERLA_RESTRICT dBE = &dst->get(0,y,z,Stencil::idx[BE]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -234,7 +257,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTE = &dst->get(0,y,z,Stencil::idx[TE]);
          real_t * WALBERLA_RESTRICT dBW = &dst->get(0,y,z,Stencil::idx[BW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -249,7 +272,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTS = &dst->get(0,y,z,Stencil::idx[TS]);
          real_t * WALBERLA_RESTRICT dBN = &dst->get(0,y,z,Stencil::idx[BN]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -264,7 +287,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTN = &dst->get(0,y,z,Stencil::idx[TN]);
          real_t * WALBERLA_RESTRICT dBS = &dst->get(0,y,z,Stencil::idx[BS]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -279,7 +302,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dN = &dst->get(0,y,z,Stencil::idx[N]);
          real_t * WALBERLA_RESTRICT dS = &dst->get(0,y,z,Stencil::idx[S]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -293,7 +316,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dE = &dst->get(0,y,z,Stencil::idx[E]);
          real_t * WALBERLA_RESTRICT dW = &dst->get(0,y,z,Stencil::idx[W]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -307,7 +330,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dT = &dst->get(0,y,z,Stencil::idx[T]);
          real_t * WALBERLA_RESTRICT dB = &dst->get(0,y,z,Stencil::idx[B]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -322,11 +345,11 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
    }
    else // ==> src->layout() == field::zyxf || dst->layout() == field::zyxf
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -369,7 +392,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             else perform_lbm[x] = false;
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -381,7 +404,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -393,7 +416,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -405,7 +428,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -417,7 +440,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -429,7 +452,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -441,7 +464,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -452,7 +475,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -463,7 +486,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -474,7 +497,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
 
    delete[] velX;
@@ -486,8 +509,6 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 #ifdef _OPENMP
    }
 #endif
-
-   src->swapDataPointers( dst );
 }
 
 template< typename LatticeModel_T, typename FlagField_T >
@@ -923,7 +944,23 @@ public:
    SplitSweep( const BlockDataID & src, const BlockDataID & dst, const ConstBlockDataID & flagField, const Set< FlagUID > & lbmMask ) :
       FlagFieldSweepBase<LatticeModel_T,FlagField_T>( src, dst, flagField, lbmMask ) {}
 
-   void operator()( IBlock * const block );
+   void operator()( IBlock * const block )
+   {
+      (*this)( block, this->getSrcField( block )->xyzSize() );
+      swap( block );
+   }
+
+   /// stream & collide restricted to 'cells', src and dst are NOT swapped (required for splitting the sweep into
+   /// an inner and an outer part, see domain_decomposition/InnerOuterSplit.h - requires a dedicated dst field)
+   void operator()( IBlock * const block, const CellInterval & cells );
+
+   void swap( IBlock * const block )
+   {
+      PdfField_T * src( NULL );
+      PdfField_T * dst( NULL );
+      this->getFields( block, src, dst );
+      src->swapDataPointers( dst );
+   }
 
    void stream ( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
    void collide( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
@@ -937,8 +974,11 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
                                                                                            boost::mpl::bool_< LatticeModel_T::compressible >,
                                                                                            boost::is_same< typename LatticeModel_T::ForceModel::tag,
                                                                                                            force_model::None_tag > > >::type
-   >::operator()( IBlock * const block )                                              
+   >::operator()( IBlock * const block, const CellInterval & cells )
 {
+   if( cells.empty() )
+      return;
+
    PdfField_T * src( NULL );
    PdfField_T * dst( NULL );
    const FlagField_T * flagField( NULL );
@@ -946,6 +986,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
    auto lbm = this->getLbmMaskAndFields( block, src, dst, flagField );
 
    WALBERLA_ASSERT_GREATER_EQUAL( src->nrOfGhostLayers(), 1 );
+   WALBERLA_ASSERT( src->xyzSize().contains( cells ) );
 
    // constants used during stream/collide
 
@@ -961,6 +1002,9 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    const cell_idx_t xSize = cell_idx_c( src->xSize() );
 
+   const cell_idx_t xBegin = cells.xMin();
+   const cell_idx_t xEnd   = cells.xMax() + cell_idx_t(1);
+
 #ifdef _OPENMP
    #pragma omp parallel
    {
@@ -979,7 +1023,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    if( src->layout() == field::fzyx && dst->layout() == field::fzyx )
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
@@ -1005,7 +1049,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
          real_t * WALBERLA_RESTRICT dC = &dst->get(0,y,z,Stencil::idx[C]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -1032,7 +1076,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dNW = &dst->get(0,y,z,Stencil::idx[NW]);
          real_t * WALBERLA_RESTRICT dSE = &dst->get(0,y,z,Stencil::idx[SE]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1047,7 +1091,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dNE = &dst->get(0,y,z,Stencil::idx[NE]);
          real_t * WALBERLA_RESTRICT dSW = &dst->get(0,y,z,Stencil::idx[SW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1062,7 +1106,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTW = &dst->get(0,y,z,Stencil::idx[TW]);
          real_t * WALBERLA_RESTRICT dBE = &dst->get(0,y,z,Stencil::idx[BE]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1077,7 +1121,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTE = &dst->get(0,y,z,Stencil::idx[TE]);
          real_t * WALBERLA_RESTRICT dBW = &dst->get(0,y,z,Stencil::idx[BW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1092,7 +1136,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTS = &dst->get(0,y,z,Stencil::idx[TS]);
          real_t * WALBERLA_RESTRICT dBN = &dst->get(0,y,z,Stencil::idx[BN]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1107,7 +1151,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTN = &dst->get(0,y,z,Stencil::idx[TN]);
          real_t * WALBERLA_RESTRICT dBS = &dst->get(0,y,z,Stencil::idx[BS]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1122,7 +1166,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dN = &dst->get(0,y,z,Stencil::idx[N]);
          real_t * WALBERLA_RESTRICT dS = &dst->get(0,y,z,Stencil::idx[S]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1136,7 +1180,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dE = &dst->get(0,y,z,Stencil::idx[E]);
          real_t * WALBERLA_RESTRICT dW = &dst->get(0,y,z,Stencil::idx[W]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1150,7 +1194,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dT = &dst->get(0,y,z,Stencil::idx[T]);
          real_t * WALBERLA_RESTRICT dB = &dst->get(0,y,z,Stencil::idx[B]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1161,15 +1205,15 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          )
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
    else // ==> src->layout() == field::zyxf || dst->layout() == field::zyxf
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -1213,7 +1257,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             else perform_lbm[x] = false;
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1225,7 +1269,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1237,7 +1281,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1249,7 +1293,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1261,7 +1305,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1273,7 +1317,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1285,7 +1329,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1296,7 +1340,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1307,7 +1351,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1318,7 +1362,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
 
    delete[] velX;
@@ -1331,8 +1375,6 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 #ifdef _OPENMP
    }
 #endif
-
-   src->swapDataPointers( dst );
 }
 
 template< typename LatticeModel_T, typename FlagField_T >
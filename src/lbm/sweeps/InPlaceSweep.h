@@ -0,0 +1,161 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file InPlaceSweep.h
+//! \ingroup lbm
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "FlagFieldSweepBase.h"
+#include "PdfArrayCollision.h"
+#include "lbm/field/InPlaceTimestep.h"
+
+#include "core/debug/Debug.h"
+#include "field/iterators/IteratorMacros.h"
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief LBM stream & collide sweep that works on one single PDF field ("AA pattern" in-place streaming)
+*
+*   Contrary to all other LBM sweeps (CellwiseSweep, SplitSweep, ...), this sweep does not require a temporary
+*   destination field that is swapped with the source field after each time step. This halves the memory required
+*   for storing the PDFs and avoids the write-allocate transfers for the destination field. See InPlaceTimestep for a
+*   description of how the memory layout alternates between even and odd time steps.
+*
+*   Only the interior of a block is updated (no ghost layer support) and only cells marked with one of the flags of
+*   'lbmMask' are processed. Currently, SRT and TRT without additional forces are supported.
+*
+*   Communication and boundary handling must be aware of the in-place layout: use InPlacePdfFieldPackInfo instead of
+*   PdfFieldPackInfo, and pass the same InPlaceTimestep object to the NoSlip, UBB, and SimpleUBB boundary conditions.
+*   After each time step, the InPlaceTimestep object must be advanced:
+*
+*   \code
+*   auto timestep = make_shared< lbm::InPlaceTimestep >();
+*
+*   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > communication( blocks );
+*   communication.addPackInfo( make_shared< lbm::InPlacePdfFieldPackInfo< LatticeModel_T > >( pdfFieldId, timestep ) );
+*
+*   timeloop.add() << BeforeFunction( communication, "communication" )
+*                  << Sweep( BoundaryHandling_T::getBlockSweep( boundaryHandlingId ), "boundary handling" );
+*   timeloop.add() << Sweep( makeSharedSweep( lbm::makeInPlaceSweep< LatticeModel_T, FlagField_T >( timestep, pdfFieldId, flagFieldId, Fluid_Flag ) ),
+*                            "stream & collide (in-place)" )
+*                  << AfterFunction( [timestep](){ timestep->advance(); }, "advance in-place time step" );
+*   \endcode
+*
+*   Please note that the PDFs are only stored in their regular layout after an even number of time steps and after the
+*   subsequent communication and boundary handling (which move the PDFs that the last odd time step pushed into the
+*   ghost layer and into boundary cells to the cells they belong to). Hence, any evaluation or output that accesses
+*   the PDF field should be performed right before an even time step of the InPlaceSweep.
+*/
+//**********************************************************************************************************************
+
+template< typename LatticeModel_T, typename FlagField_T >
+class InPlaceSweep : public FlagFieldSweepBase< LatticeModel_T, FlagField_T >
+{
+public:
+
+   typedef typename FlagFieldSweepBase< LatticeModel_T, FlagField_T >::PdfField_T PdfField_T;
+   typedef typename LatticeModel_T::Stencil                                        Stencil;
+
+   InPlaceSweep( const shared_ptr< const InPlaceTimestep > & timestep, const BlockDataID & pdfField, const ConstBlockDataID & flagField,
+                 const Set< FlagUID > & lbmMask ) :
+      FlagFieldSweepBase< LatticeModel_T, FlagField_T >( pdfField, flagField, lbmMask ), timestep_( timestep )
+   {
+      WALBERLA_ASSERT_NOT_NULLPTR( timestep_ );
+   }
+
+   void operator()( IBlock * const block );
+
+private:
+
+   shared_ptr< const InPlaceTimestep > timestep_;
+};
+
+
+
+template< typename LatticeModel_T, typename FlagField_T >
+void InPlaceSweep< LatticeModel_T, FlagField_T >::operator()( IBlock * const block )
+{
+   PdfField_T * pdfs( NULL );
+   const FlagField_T * flags( NULL );
+
+   const auto lbm = this->getLbmMaskAndFields( block, pdfs, flags );
+   WALBERLA_ASSERT_NOT_NULLPTR( pdfs );
+   WALBERLA_ASSERT_NOT_NULLPTR( flags );
+
+   const internal::PdfArrayCollision< LatticeModel_T > collide( pdfs->latticeModel() );
+
+   if( timestep_->isEven() )
+   {
+      WALBERLA_FOR_ALL_CELLS_XYZ( pdfs,
+         if( flags->isPartOfMaskSet( x, y, z, lbm ) )
+         {
+            real_t in [ Stencil::Size ];
+            real_t out[ Stencil::Size ];
+
+            for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+               in[ d.toIdx() ] = pdfs->get( x, y, z, d.toIdx() );
+
+            collide( in, out );
+
+            for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+               pdfs->get( x, y, z, d.toInvIdx() ) = out[ d.toIdx() ];
+         }
+      )
+   }
+   else
+   {
+      // every cell reads exactly the memory locations that it writes to -> cells can be processed in any order/in parallel
+
+      WALBERLA_FOR_ALL_CELLS_XYZ( pdfs,
+         if( flags->isPartOfMaskSet( x, y, z, lbm ) )
+         {
+            real_t in [ Stencil::Size ];
+            real_t out[ Stencil::Size ];
+
+            for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+               in[ d.toIdx() ] = pdfs->get( x - d.cx(), y - d.cy(), z - d.cz(), d.toInvIdx() );
+
+            collide( in, out );
+
+            for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+               pdfs->get( x + d.cx(), y + d.cy(), z + d.cz(), d.toIdx() ) = out[ d.toIdx() ];
+         }
+      )
+   }
+}
+
+
+
+template< typename LatticeModel_T, typename FlagField_T >
+shared_ptr< InPlaceSweep< LatticeModel_T, FlagField_T > >
+makeInPlaceSweep( const shared_ptr< const InPlaceTimestep > & timestep, const BlockDataID & pdfFieldId, const ConstBlockDataID & flagFieldId,
+                  const Set< FlagUID > & lbmMask )
+{
+   return make_shared< InPlaceSweep< LatticeModel_T, FlagField_T > >( timestep, pdfFieldId, flagFieldId, lbmMask );
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -0,0 +1,121 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file PdfArrayCollision.h
+//! \ingroup lbm
+//! \brief Collision operators that work on a local array of PDFs (used by InPlaceSweep and SparsePdfListSweep)
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/field/MacroscopicValueCalculation.h"
+#include "lbm/lattice_model/EquilibriumDistribution.h"
+#include "lbm/lattice_model/LatticeModelBase.h"
+
+#include <boost/mpl/logical.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+namespace internal {
+
+template< typename LatticeModel_T, class Enable = void >
+class PdfArrayCollision
+{
+   static_assert( never_true<LatticeModel_T>::value, "For your current LB lattice model, there is yet no implementation for class 'lbm::internal::PdfArrayCollision'!" );
+};
+
+template< typename LatticeModel_T >
+class PdfArrayCollision< LatticeModel_T, typename boost::enable_if< boost::mpl::and_< boost::is_same< typename LatticeModel_T::CollisionModel::tag,
+                                                                                                     collision_model::SRT_tag >,
+                                                                                     boost::mpl::bool_< LatticeModel_T::CollisionModel::constant >,
+                                                                                     boost::is_same< typename LatticeModel_T::ForceModel::tag,
+                                                                                                     force_model::None_tag > > >::type >
+{
+public:
+
+   static_assert( LatticeModel_T::equilibriumAccuracyOrder == 2, "Only works for lattice models that require the equilibrium distribution to be order 2 accurate!" );
+
+   typedef typename LatticeModel_T::Stencil Stencil;
+
+   PdfArrayCollision( const LatticeModel_T & latticeModel ) : omega_( latticeModel.collisionModel().omega() ), latticeModel_( latticeModel ) {}
+
+   void operator()( const real_t * const in, real_t * const out ) const
+   {
+      Vector3<real_t> velocity;
+      const real_t rho = getDensityAndVelocity( velocity, latticeModel_, in );
+
+      for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+         out[ d.toIdx() ] = ( real_t(1.0) - omega_ ) * in[ d.toIdx() ] + omega_ * EquilibriumDistribution< LatticeModel_T >::get( *d, velocity, rho );
+   }
+
+private:
+
+   const real_t omega_;
+   const LatticeModel_T & latticeModel_;
+};
+
+template< typename LatticeModel_T >
+class PdfArrayCollision< LatticeModel_T, typename boost::enable_if< boost::mpl::and_< boost::is_same< typename LatticeModel_T::CollisionModel::tag,
+                                                                                                     collision_model::TRT_tag >,
+                                                                                     boost::is_same< typename LatticeModel_T::ForceModel::tag,
+                                                                                                     force_model::None_tag > > >::type >
+{
+public:
+
+   static_assert( LatticeModel_T::equilibriumAccuracyOrder == 2, "Only works for lattice models that require the equilibrium distribution to be order 2 accurate!" );
+
+   typedef typename LatticeModel_T::Stencil Stencil;
+
+   PdfArrayCollision( const LatticeModel_T & latticeModel ) :
+      lambda_e_( latticeModel.collisionModel().lambda_e() ), lambda_d_( latticeModel.collisionModel().lambda_d() ), latticeModel_( latticeModel ) {}
+
+   void operator()( const real_t * const in, real_t * const out ) const
+   {
+      Vector3<real_t> velocity;
+      const real_t rho = getDensityAndVelocity( velocity, latticeModel_, in );
+
+      for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+      {
+         const real_t fsym  = EquilibriumDistribution< LatticeModel_T >::getSymmetricPart ( *d, velocity, rho );
+         const real_t fasym = EquilibriumDistribution< LatticeModel_T >::getAsymmetricPart( *d, velocity, rho );
+
+         const real_t f    = in[ d.toIdx() ];
+         const real_t finv = in[ d.toInvIdx() ];
+
+         out[ d.toIdx() ] = f - lambda_e_ * ( real_t( 0.5 ) * ( f + finv ) - fsym )
+                              - lambda_d_ * ( real_t( 0.5 ) * ( f - finv ) - fasym );
+      }
+   }
+
+private:
+
+   const real_t lambda_e_;
+   const real_t lambda_d_;
+   const LatticeModel_T & latticeModel_;
+};
+
+} // namespace internal
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -0,0 +1,604 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SIMDSweep.h
+//! \ingroup lbm
+//! \brief Explicitly vectorized SRT/TRT stream & collide sweep for D3Q19 and D3Q27
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "FlagFieldSweepBase.h"
+#include "lbm/lattice_model/D3Q19.h"
+#include "lbm/lattice_model/D3Q27.h"
+#include "lbm/lattice_model/LatticeModelBase.h"
+
+#include "core/OpenMP.h"
+#include "core/debug/CheckFunctions.h"
+#include "core/math/Vector3.h"
+
+#include "simd/CPUFeatures.h"
+
+#include "stencil/Directions.h"
+
+#include <boost/mpl/logical.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+template< typename LatticeModel_T, typename FlagField_T, class Enable = void >
+class SIMDSweep
+{
+   static_assert( never_true<LatticeModel_T>::value, "For your current LB lattice model, there is yet no implementation for class 'lbm::SIMDSweep'!" );
+};
+
+
+
+namespace internal {
+
+/// operations on one single cell (used for cells at the end of a row, for rows that are partially covered by the
+/// lbm mask, and if vectorization is disabled or not available)
+struct SIMDScalarOps
+{
+   typedef real_t value_type;
+   static const uint_t Width = uint_t(1);
+
+   static WALBERLA_SIMD_INLINE void make( value_type & v, const real_t value ) { v = value; }
+   static WALBERLA_SIMD_INLINE void load( value_type & v, const real_t * const p ) { v = *p; }
+   static WALBERLA_SIMD_INLINE void store( real_t * const p, const value_type & v ) { *p = v; }
+};
+
+#ifdef WALBERLA_SIMD_CPU_DETECTION
+/// operations on Bytes / sizeof( real_t ) consecutive cells at once
+/// The generic vector type of the compiler is used instead of intrinsics: the same code is compiled to SSE2, AVX, AVX2
+/// or AVX-512 instructions depending on the WALBERLA_SIMD_TARGET of the function the kernel is inlined into. All
+/// functions take and return vectors by reference, so no vector crosses a function boundary with the default ABI.
+template< uint_t Bytes >
+struct SIMDVectorOps
+{
+   typedef real_t value_type __attribute__(( vector_size( Bytes ) ));
+   static const uint_t Width = Bytes / uint_t( sizeof( real_t ) );
+
+   static WALBERLA_SIMD_INLINE void make( value_type & v, const real_t value ) { v = value_type{} + value; }
+   static WALBERLA_SIMD_INLINE void load( value_type & v, const real_t * const p ) { std::memcpy( &v, p, sizeof( value_type ) ); }
+   static WALBERLA_SIMD_INLINE void store( real_t * const p, const value_type & v ) { std::memcpy( p, &v, sizeof( value_type ) ); }
+};
+#endif
+
+/// sum += c * u for a lattice velocity component c in { -1, 0, 1 } (c is a compile time constant after inlining, hence
+/// the branches vanish and no multiplication is generated)
+template< typename V >
+WALBERLA_SIMD_INLINE void addVelocityTerm( const int c, V & sum, const V & u )
+{
+   if( c > 0 )
+      sum += u;
+   else if( c < 0 )
+      sum -= u;
+}
+
+/// compile time loop over all directions [D,Q) of a stencil (the directions of D3Q19/D3Q27 are the first 19/27
+/// entries of stencil::Direction)
+template< uint_t D, uint_t Q >
+struct SIMDDirectionLoop
+{
+   template< typename Functor >
+   static WALBERLA_SIMD_INLINE void apply( Functor & functor ) { functor.template process< stencil::Direction(D) >(); SIMDDirectionLoop< D + uint_t(1), Q >::apply( functor ); }
+};
+template< uint_t Q >
+struct SIMDDirectionLoop< Q, Q >
+{
+   template< typename Functor >
+   static WALBERLA_SIMD_INLINE void apply( Functor & ) {}
+};
+
+
+
+/// relaxation rates and body force of a SIMDStreamCollideKernel
+struct SIMDKernelParameters
+{
+   real_t lambda_e;
+   real_t lambda_d;
+   Vector3< real_t > force;
+};
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Stream (pull) & collide kernel for Ops::Width consecutive cells of a row
+*
+*   Collision is performed in TRT form: each pair of opposite directions is split into its symmetric and its
+*   anti-symmetric part which are relaxed with lambda_e and lambda_d, respectively. SRT is the special case
+*   lambda_e = lambda_d = omega.
+*
+*   All member functions are force-inlined, so the kernel is compiled for the instruction set of the function it is
+*   constructed and called in (see SIMDSweepKernels).
+*/
+//**********************************************************************************************************************
+
+template< typename LatticeModel_T, typename Ops >
+class SIMDStreamCollideKernel
+{
+public:
+
+   typedef typename Ops::value_type          V;
+   typedef typename LatticeModel_T::Stencil  Stencil;
+
+   static const uint_t Q = Stencil::Size;
+   static const bool compressible = LatticeModel_T::compressible;
+   static const bool force = !boost::is_same< typename LatticeModel_T::ForceModel::tag, force_model::None_tag >::value;
+
+   WALBERLA_SIMD_INLINE SIMDStreamCollideKernel( const SIMDKernelParameters & parameters )
+   {
+      Ops::make( lambda_e_, parameters.lambda_e );
+      Ops::make( lambda_d_, parameters.lambda_d );
+      Ops::make( zero_, real_t(0) );
+      Ops::make( one_, real_t(1) );
+      Ops::make( half_, real_t(0.5) );
+      Ops::make( three_, real_t(3) );
+      Ops::make( oneAndHalf_, real_t(1.5) );
+      Ops::make( fourAndHalf_, real_t(4.5) );
+
+      const Vector3< real_t > & bodyForce = parameters.force;
+      for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+      {
+         WALBERLA_ASSERT_EQUAL( d.toIdx(), uint_c( *d ) );
+         Ops::make( w_[ d.toIdx() ], real_c( LatticeModel_T::w[ d.toIdx() ] ) );
+         Ops::make( force_[ d.toIdx() ], real_t(3) * real_c( LatticeModel_T::w[ d.toIdx() ] ) *
+                                         ( real_c( d.cx() ) * bodyForce[0] + real_c( d.cy() ) * bodyForce[1] + real_c( d.cz() ) * bodyForce[2] ) );
+      }
+   }
+
+   /// 'src[f]' points to the PDF that is pulled into the first cell of the row for direction f, 'dst[f]' to PDF f of the first cell
+   WALBERLA_SIMD_INLINE void operator()( const real_t * const * src, real_t * const * dst, const cell_idx_t x ) const;
+
+private:
+
+   struct Momentum
+   {
+      WALBERLA_SIMD_INLINE Momentum( const V * pdf, const V & zero ) : pdf_( pdf ), x( zero ), y( zero ), z( zero ) {}
+
+      template< stencil::Direction D >
+      WALBERLA_SIMD_INLINE void process()
+      {
+         addVelocityTerm( stencil::cx[D], x, pdf_[D] );
+         addVelocityTerm( stencil::cy[D], y, pdf_[D] );
+         addVelocityTerm( stencil::cz[D], z, pdf_[D] );
+      }
+
+      const V * pdf_;
+      V x, y, z;
+   };
+
+   struct Collision
+   {
+      WALBERLA_SIMD_INLINE Collision( const SIMDStreamCollideKernel & kernel, const V * pdf, real_t * const * dst, const cell_idx_t x,
+                                      const V & rho, const V & ux, const V & uy, const V & uz, const V & base ) :
+         kernel_( kernel ), pdf_( pdf ), dst_( dst ), x_( x ), rho_( rho ), ux_( ux ), uy_( uy ), uz_( uz ), base_( base ) {}
+
+      template< stencil::Direction D >
+      WALBERLA_SIMD_INLINE void process()
+      {
+         if( D == stencil::C || stencil::inverseDir[D] < D ) // center is treated separately, every pair of directions only once
+            return;
+
+         const uint_t I = uint_c( stencil::inverseDir[D] );
+
+         V cu = kernel_.zero_;
+         addVelocityTerm( stencil::cx[D], cu, ux_ );
+         addVelocityTerm( stencil::cy[D], cu, uy_ );
+         addVelocityTerm( stencil::cz[D], cu, uz_ );
+
+         const V w = compressible ? kernel_.w_[D] * rho_ : kernel_.w_[D];
+
+         const V  symEq = w * ( base_ + kernel_.fourAndHalf_ * cu * cu );
+         const V asymEq = w * kernel_.three_ * cu;
+
+         const V  sym = kernel_.lambda_e_ * ( kernel_.half_ * ( pdf_[D] + pdf_[I] ) - symEq );
+         const V asym = kernel_.lambda_d_ * ( kernel_.half_ * ( pdf_[D] - pdf_[I] ) - asymEq );
+
+         V dstD = pdf_[D] - sym - asym;
+         V dstI = pdf_[I] - sym + asym;
+         if( force )
+         {
+            dstD += kernel_.force_[D];
+            dstI += kernel_.force_[I];
+         }
+         Ops::store( dst_[D] + x_, dstD );
+         Ops::store( dst_[I] + x_, dstI );
+      }
+
+      const SIMDStreamCollideKernel & kernel_;
+      const V * pdf_;
+      real_t * const * dst_;
+      const cell_idx_t x_;
+      const V rho_, ux_, uy_, uz_, base_;
+   };
+
+   V lambda_e_;
+   V lambda_d_;
+
+   V zero_, one_, half_, three_, oneAndHalf_, fourAndHalf_;
+
+   V w_[ Q ];
+   V force_[ Q ];
+};
+
+template< typename LatticeModel_T, typename Ops >
+WALBERLA_SIMD_INLINE void SIMDStreamCollideKernel< LatticeModel_T, Ops >::operator()( const real_t * const * src, real_t * const * dst, const cell_idx_t x ) const
+{
+   V pdf[ Q ];
+   for( uint_t f = uint_t(0); f != Q; ++f )
+      Ops::load( pdf[f], src[f] + x );
+
+   V rho = pdf[0];
+   for( uint_t f = uint_t(1); f != Q; ++f )
+      rho += pdf[f];
+
+   Momentum momentum( pdf, zero_ );
+   SIMDDirectionLoop< uint_t(1), Q >::apply( momentum );
+
+   V ux = momentum.x;
+   V uy = momentum.y;
+   V uz = momentum.z;
+
+   if( compressible )
+   {
+      const V invRho = one_ / rho;
+      ux *= invRho;
+      uy *= invRho;
+      uz *= invRho;
+   }
+
+   // equilibrium of a direction with velocity c: w * R * ( base + 4.5 (c*u)^2 ) + w * R * 3 (c*u)
+   // with R = rho (compressible) or R = 1 (incompressible)
+
+   const V usq = ux * ux + uy * uy + uz * uz;
+   const V base = compressible ? one_ - oneAndHalf_ * usq : rho - oneAndHalf_ * usq;
+
+   const V w0 = compressible ? w_[0] * rho : w_[0];
+   const V dst0 = pdf[0] - lambda_e_ * ( pdf[0] - w0 * base ); // no force term
+   Ops::store( dst[0] + x, dst0 );
+
+   Collision collision( *this, pdf, dst, x, rho, ux, uy, uz, base );
+   SIMDDirectionLoop< uint_t(1), Q >::apply( collision );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Stream & collide for the rows [firstRow,endRow) of a block, row r is located at y = r % ySize, z = r / ySize
+*
+*   Groups of Ops::Width cells that are entirely covered by the lbm mask are processed by the vector kernel, all other
+*   cells by the scalar kernel.
+*/
+//**********************************************************************************************************************
+
+template< typename LatticeModel_T, typename FlagField_T, typename Ops >
+WALBERLA_SIMD_INLINE void simdStreamCollideRows( const PdfField< LatticeModel_T > & src, PdfField< LatticeModel_T > & dst, const FlagField_T & flagField,
+                                                 const typename FlagField_T::flag_t lbm, const cell_idx_t firstRow, const cell_idx_t endRow,
+                                                 const SIMDKernelParameters & parameters )
+{
+   typedef typename LatticeModel_T::Stencil Stencil;
+
+   const SIMDStreamCollideKernel< LatticeModel_T, SIMDScalarOps > scalarKernel( parameters );
+   const SIMDStreamCollideKernel< LatticeModel_T, Ops > vectorKernel( parameters );
+   const cell_idx_t width = cell_idx_c( Ops::Width );
+
+   const cell_idx_t xSize = cell_idx_c( src.xSize() );
+   const cell_idx_t ySize = cell_idx_c( src.ySize() );
+
+   for( cell_idx_t row = firstRow; row < endRow; ++row )
+   {
+      const cell_idx_t y = row % ySize;
+      const cell_idx_t z = row / ySize;
+
+      const real_t * srcRow[ Stencil::Size ];
+      real_t * dstRow[ Stencil::Size ];
+      for( auto d = Stencil::begin(); d != Stencil::end(); ++d )
+      {
+         srcRow[ d.toIdx() ] = &src.get( -d.cx(), y - d.cy(), z - d.cz(), d.toIdx() );
+         dstRow[ d.toIdx() ] = &dst.get( 0, y, z, d.toIdx() );
+      }
+
+      cell_idx_t x = cell_idx_t(0);
+
+      if( width > cell_idx_t(1) )
+      {
+         for( ; x + width <= xSize; x += width )
+         {
+            bool all = true;
+            for( cell_idx_t i = x; i != x + width; ++i )
+               all = all && flagField.isPartOfMaskSet( i, y, z, lbm );
+
+            if( all )
+            {
+               vectorKernel( srcRow, dstRow, x );
+            }
+            else
+            {
+               for( cell_idx_t i = x; i != x + width; ++i )
+                  if( flagField.isPartOfMaskSet( i, y, z, lbm ) )
+                     scalarKernel( srcRow, dstRow, i );
+            }
+         }
+      }
+
+      for( ; x < xSize; ++x )
+         if( flagField.isPartOfMaskSet( x, y, z, lbm ) )
+            scalarKernel( srcRow, dstRow, x );
+   }
+}
+
+
+
+/// One instantiation of the stream & collide rows for each instruction set. Only the scalar version is compiled with
+/// the compiler flags of the translation unit, all other versions are compiled for their instruction set via
+/// WALBERLA_SIMD_TARGET and must only be called if the CPU supports it (see select()).
+template< typename LatticeModel_T, typename FlagField_T >
+struct SIMDSweepKernels
+{
+   typedef PdfField< LatticeModel_T > PdfField_T;
+   typedef typename FlagField_T::flag_t flag_t;
+
+   typedef void (*Function)( const PdfField_T &, PdfField_T &, const FlagField_T &, const flag_t, const cell_idx_t, const cell_idx_t,
+                             const SIMDKernelParameters & );
+
+   static void scalar( const PdfField_T & src, PdfField_T & dst, const FlagField_T & flagField, const flag_t lbm,
+                       const cell_idx_t firstRow, const cell_idx_t endRow, const SIMDKernelParameters & parameters )
+   {
+      simdStreamCollideRows< LatticeModel_T, FlagField_T, SIMDScalarOps >( src, dst, flagField, lbm, firstRow, endRow, parameters );
+   }
+
+#ifdef WALBERLA_SIMD_CPU_DETECTION
+   WALBERLA_SIMD_TARGET( "sse2" )
+   static void sse2( const PdfField_T & src, PdfField_T & dst, const FlagField_T & flagField, const flag_t lbm,
+                     const cell_idx_t firstRow, const cell_idx_t endRow, const SIMDKernelParameters & parameters )
+   {
+      simdStreamCollideRows< LatticeModel_T, FlagField_T, SIMDVectorOps< uint_t(16) > >( src, dst, flagField, lbm, firstRow, endRow, parameters );
+   }
+
+   WALBERLA_SIMD_TARGET( "avx" )
+   static void avx( const PdfField_T & src, PdfField_T & dst, const FlagField_T & flagField, const flag_t lbm,
+                    const cell_idx_t firstRow, const cell_idx_t endRow, const SIMDKernelParameters & parameters )
+   {
+      simdStreamCollideRows< LatticeModel_T, FlagField_T, SIMDVectorOps< uint_t(32) > >( src, dst, flagField, lbm, firstRow, endRow, parameters );
+   }
+
+   WALBERLA_SIMD_TARGET( "avx2,fma" )
+   static void avx2( const PdfField_T & src, PdfField_T & dst, const FlagField_T & flagField, const flag_t lbm,
+                     const cell_idx_t firstRow, const cell_idx_t endRow, const SIMDKernelParameters & parameters )
+   {
+      simdStreamCollideRows< LatticeModel_T, FlagField_T, SIMDVectorOps< uint_t(32) > >( src, dst, flagField, lbm, firstRow, endRow, parameters );
+   }
+
+   WALBERLA_SIMD_TARGET( "avx512f" )
+   static void avx512( const PdfField_T & src, PdfField_T & dst, const FlagField_T & flagField, const flag_t lbm,
+                       const cell_idx_t firstRow, const cell_idx_t endRow, const SIMDKernelParameters & parameters )
+   {
+      simdStreamCollideRows< LatticeModel_T, FlagField_T, SIMDVectorOps< uint_t(64) > >( src, dst, flagField, lbm, firstRow, endRow, parameters );
+   }
+#endif
+
+   /// returns the kernel for instruction set 'is' and replaces 'is' by the instruction set that is actually used
+   static Function select( simd::InstructionSet & is )
+   {
+#ifdef WALBERLA_SIMD_CPU_DETECTION
+      switch( is )
+      {
+      case simd::AVX512: return &avx512;
+      case simd::AVX2:   return &avx2;
+      case simd::AVX:    return &avx;
+      case simd::SSE4:   is = simd::SSE2; return &sse2; // SSE4 provides no additional floating point instructions that are used
+      case simd::SSE2:   return &sse2;
+      default:           break;
+      }
+#endif
+      is = simd::SCALAR;
+      return &scalar;
+   }
+};
+
+template< typename CollisionModel_T, class Enable = void >
+struct SIMDRelaxation;
+
+template< typename CollisionModel_T >
+struct SIMDRelaxation< CollisionModel_T, typename boost::enable_if< boost::is_same< typename CollisionModel_T::tag, collision_model::SRT_tag > >::type >
+{
+   static real_t lambda_e( const CollisionModel_T & cm ) { return cm.omega(); }
+   static real_t lambda_d( const CollisionModel_T & cm ) { return cm.omega(); }
+};
+
+template< typename CollisionModel_T >
+struct SIMDRelaxation< CollisionModel_T, typename boost::enable_if< boost::is_same< typename CollisionModel_T::tag, collision_model::TRT_tag > >::type >
+{
+   static real_t lambda_e( const CollisionModel_T & cm ) { return cm.lambda_e(); }
+   static real_t lambda_d( const CollisionModel_T & cm ) { return cm.lambda_d(); }
+};
+
+template< typename ForceModel_T, class Enable = void >
+struct SIMDBodyForce
+{
+   static Vector3< real_t > get( const ForceModel_T & fm ) { return fm.force(); }
+};
+
+template< typename ForceModel_T >
+struct SIMDBodyForce< ForceModel_T, typename boost::enable_if< boost::is_same< typename ForceModel_T::tag, force_model::None_tag > >::type >
+{
+   static Vector3< real_t > get( const ForceModel_T & ) { return Vector3< real_t >(); }
+};
+
+/// SRT with constant relaxation rate or TRT
+template< typename CollisionModel_T, class Enable = void >
+struct SIMDCollisionSupported : public boost::false_type {};
+
+template< typename CollisionModel_T >
+struct SIMDCollisionSupported< CollisionModel_T, typename boost::enable_if< boost::is_same< typename CollisionModel_T::tag, collision_model::SRT_tag > >::type >
+   : public boost::mpl::bool_< CollisionModel_T::constant > {};
+
+template< typename CollisionModel_T >
+struct SIMDCollisionSupported< CollisionModel_T, typename boost::enable_if< boost::is_same< typename CollisionModel_T::tag, collision_model::TRT_tag > >::type >
+   : public boost::true_type {};
+
+template< typename LatticeModel_T >
+struct SIMDSweepSupported : public boost::mpl::and_< SIMDCollisionSupported< typename LatticeModel_T::CollisionModel >,
+                                                     boost::mpl::or_< boost::is_same< typename LatticeModel_T::Stencil, stencil::D3Q19 >,
+                                                                      boost::is_same< typename LatticeModel_T::Stencil, stencil::D3Q27 > >,
+                                                     boost::mpl::or_< boost::is_same< typename LatticeModel_T::ForceModel::tag, force_model::None_tag >,
+                                                                      boost::is_same< typename LatticeModel_T::ForceModel::tag, force_model::Simple_tag > > > {};
+
+} // namespace internal
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief LBM stream & collide sweep that is explicitly vectorized
+*
+*   Contrary to the SplitSweep, which relies on the compiler to vectorize its loops (see IntelCompilerOptimization.h),
+*   this sweep always processes several consecutive cells of a row at once. The performance therefore does not depend
+*   on the auto-vectorization capabilities of a specific compiler release.
+*
+*   Supported are D3Q19 and D3Q27, SRT and TRT, incompressible and compressible models, and the force models
+*   force_model::None and force_model::SimpleConstant. The PDF fields must be stored in fzyx layout.
+*
+*   The kernel is compiled for SSE2, AVX, AVX2 and AVX-512 independent of the compiler flags (see SIMDSweepKernels).
+*   It deliberately does not use the simd:: vector types: their instruction set and their width (four doubles) are
+*   fixed at compile time, while the vector type of SIMDVectorOps has the full register width of every target.
+*   When the sweep is constructed, the best instruction set that is supported by the CPU is detected (see
+*   simd/CPUFeatures.h) and the corresponding kernel is selected, hence a binary that is built without architecture
+*   specific flags (i.e., without WALBERLA_OPTIMIZE_FOR_LOCALHOST) runs on every x86 CPU and still uses AVX-512 if
+*   available. If vectorization is disabled, or on platforms without runtime detection, all cells are processed by the
+*   scalar kernel. Groups of cells that are not entirely covered by the lbm mask and the remaining cells at the end of
+*   each row are always processed by the scalar version of the kernel.
+*
+*   Only stream & collide is provided, there is no separate stream or collide function.
+*/
+//**********************************************************************************************************************
+
+template< typename LatticeModel_T, typename FlagField_T >
+class SIMDSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< internal::SIMDSweepSupported< LatticeModel_T > >::type > :
+   public FlagFieldSweepBase< LatticeModel_T, FlagField_T >
+{
+public:
+
+   static_assert( LatticeModel_T::equilibriumAccuracyOrder == 2, "Only works for lattice models that require the equilibrium distribution to be order 2 accurate!" );
+
+   typedef typename FlagFieldSweepBase<LatticeModel_T,FlagField_T>::PdfField_T  PdfField_T;
+   typedef typename LatticeModel_T::Stencil                                     Stencil;
+
+   // block has NO dst pdf field, lbm mask consists of multiple flags
+   SIMDSweep( const BlockDataID & pdfField, const ConstBlockDataID & flagField, const Set< FlagUID > & lbmMask, const bool vectorize = true ) :
+      FlagFieldSweepBase<LatticeModel_T,FlagField_T>( pdfField, flagField, lbmMask )
+   {
+      setInstructionSet( vectorize ? simd::detectInstructionSet() : simd::SCALAR );
+   }
+
+   // every block has a dedicated dst pdf field, lbm mask consists of multiple flags
+   SIMDSweep( const BlockDataID & src, const BlockDataID & dst, const ConstBlockDataID & flagField, const Set< FlagUID > & lbmMask,
+              const bool vectorize = true ) :
+      FlagFieldSweepBase<LatticeModel_T,FlagField_T>( src, dst, flagField, lbmMask )
+   {
+      setInstructionSet( vectorize ? simd::detectInstructionSet() : simd::SCALAR );
+   }
+
+   void operator()( IBlock * const block );
+
+   /// selects the kernel for instruction set 'is', which must be supported by the CPU (SSE4 selects the SSE2 kernel,
+   /// instruction sets without a dedicated kernel select the scalar kernel)
+   void setInstructionSet( simd::InstructionSet is )
+   {
+      WALBERLA_CHECK( is == simd::SCALAR || simd::cpuSupports( is ),
+                      "lbm::SIMDSweep: the CPU does not support the instruction set " << simd::instructionSetName( is ) );
+      kernel_ = internal::SIMDSweepKernels< LatticeModel_T, FlagField_T >::select( is );
+      instructionSet_ = is;
+   }
+
+   /// returns true if a vectorized kernel is used (and false if all cells are processed by the scalar kernel)
+   bool vectorized() const { return instructionSet_ != simd::SCALAR; }
+
+   /// name of the instruction set that is used by the kernel
+   const char * instructionSet() const { return vectorized() ? simd::instructionSetName( instructionSet_ ) : "none (scalar kernel)"; }
+
+private:
+
+   simd::InstructionSet instructionSet_;
+   typename internal::SIMDSweepKernels< LatticeModel_T, FlagField_T >::Function kernel_;
+};
+
+
+
+template< typename LatticeModel_T, typename FlagField_T >
+void SIMDSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< internal::SIMDSweepSupported< LatticeModel_T > >::type >::operator()( IBlock * const block )
+{
+   PdfField_T * src( NULL );
+   PdfField_T * dst( NULL );
+   const FlagField_T * flagField( NULL );
+
+   auto lbm = this->getLbmMaskAndFields( block, src, dst, flagField );
+
+   WALBERLA_ASSERT_GREATER_EQUAL( src->nrOfGhostLayers(), 1 );
+   WALBERLA_CHECK( src->layout() == field::fzyx && dst->layout() == field::fzyx, "lbm::SIMDSweep only works with PDF fields stored in fzyx layout!" );
+
+   const LatticeModel_T & lm = src->latticeModel();
+
+   internal::SIMDKernelParameters parameters;
+   parameters.lambda_e = internal::SIMDRelaxation< typename LatticeModel_T::CollisionModel >::lambda_e( lm.collisionModel() );
+   parameters.lambda_d = internal::SIMDRelaxation< typename LatticeModel_T::CollisionModel >::lambda_d( lm.collisionModel() );
+   parameters.force = internal::SIMDBodyForce< typename LatticeModel_T::ForceModel >::get( lm.forceModel() );
+
+   // the rows are distributed among the threads in contiguous chunks, each chunk constructs the kernel only once
+   const auto kernel = kernel_;
+   const int rows = int_c( src->ySize() * src->zSize() );
+   const int chunks = std::min( rows, 4 * omp_get_max_threads() );
+
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static)
+#endif
+   for( int chunk = 0; chunk < chunks; ++chunk )
+   {
+      const cell_idx_t firstRow = cell_idx_c( int64_c( rows ) * int64_c( chunk ) / int64_c( chunks ) );
+      const cell_idx_t endRow   = cell_idx_c( int64_c( rows ) * int64_c( chunk + 1 ) / int64_c( chunks ) );
+      kernel( *src, *dst, *flagField, lbm, firstRow, endRow, parameters );
+   }
+
+   src->swapDataPointers( dst );
+}
+
+
+
+template< typename LatticeModel_T, typename FlagField_T >
+shared_ptr< SIMDSweep< LatticeModel_T, FlagField_T > >
+makeSIMDSweep( const BlockDataID & pdfFieldId, const ConstBlockDataID & flagFieldId, const Set< FlagUID > & lbmMask, const bool vectorize = true )
+{
+   return make_shared< SIMDSweep< LatticeModel_T, FlagField_T > >( pdfFieldId, flagFieldId, lbmMask, vectorize );
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -0,0 +1,131 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SparsePdfListSweep.h
+//! \ingroup lbm
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/field/SparsePdfList.h"
+#include "lbm/sweeps/PdfArrayCollision.h"
+
+#include "core/debug/Debug.h"
+#include "domain_decomposition/BlockDataID.h"
+#include "domain_decomposition/IBlock.h"
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief LBM stream & collide sweep for PDFs that are stored in a SparsePdfList
+*
+*   The sweep only iterates the fluid cells of a block. PDFs are pulled via the precomputed index list of the
+*   SparsePdfList, hence no flag field is accessed and no separate boundary sweep is required: no slip and velocity
+*   bounce back walls are already part of the index list. Communication must use the SparsePdfListPackInfo:
+*
+*   \code
+*   BlockDataID pdfListId = lbm::addSparsePdfListToStorage< LatticeModel_T, FlagField_T >( blocks, "pdf list", latticeModel, flagFieldId, Fluid_Flag );
+*
+*   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > communication( blocks );
+*   communication.addPackInfo( make_shared< lbm::SparsePdfListPackInfo< LatticeModel_T > >( pdfListId ) );
+*
+*   timeloop.add() << BeforeFunction( communication, "communication" )
+*                  << Sweep( lbm::SparsePdfListSweep< LatticeModel_T >( pdfListId ), "stream & collide (sparse)" );
+*   \endcode
+*
+*   Currently, SRT and TRT without additional forces are supported.
+*/
+//**********************************************************************************************************************
+
+template< typename LatticeModel_T >
+class SparsePdfListSweep
+{
+public:
+
+   typedef SparsePdfList< LatticeModel_T >   SparsePdfList_T;
+   typedef typename LatticeModel_T::Stencil  Stencil;
+
+   SparsePdfListSweep( const BlockDataID & pdfListId ) : pdfListId_( pdfListId ) {}
+
+   void operator()( IBlock * const block );
+
+private:
+
+   const BlockDataID pdfListId_;
+};
+
+
+
+template< typename LatticeModel_T >
+void SparsePdfListSweep< LatticeModel_T >::operator()( IBlock * const block )
+{
+   SparsePdfList_T * pdfList = block->getData< SparsePdfList_T >( pdfListId_ );
+   WALBERLA_ASSERT_NOT_NULLPTR( pdfList );
+
+   const uint_t numberOfCells = pdfList->numberOfCells();
+   const uint_t numberOfInnerCells = pdfList->numberOfInnerCells();
+
+   if( numberOfInnerCells == uint_t(0) )
+      return;
+
+   real_t * src = pdfList->src();
+   real_t * dst = pdfList->dst();
+
+   // velocity bounce back: store the reflected PDFs in the boundary slots
+
+   const auto & links = pdfList->velocityBounceBackLinks();
+   real_t * slots = src + Stencil::Size * numberOfCells;
+
+   for( uint_t k = uint_t(0); k < links.size(); ++k )
+   {
+      const real_t density = LatticeModel_T::compressible ? pdfList->getDensity( links[k].cell ) : real_t(1);
+      slots[k] = src[ links[k].pdf ] - links[k].coefficient * density;
+   }
+
+   // stream (pull) & collide
+
+   const internal::PdfArrayCollision< LatticeModel_T > collide( pdfList->latticeModel() );
+   const typename SparsePdfList_T::index_t * pull = pdfList->pullIndices().data();
+
+   #ifdef _OPENMP
+   #pragma omp parallel for schedule(static)
+   #endif
+   for( int i = 0; i < int_c( numberOfInnerCells ); ++i )
+   {
+      real_t in [ Stencil::Size ];
+      real_t out[ Stencil::Size ];
+
+      for( uint_t f = uint_t(0); f != Stencil::Size; ++f )
+         in[f] = src[ pull[ f * numberOfInnerCells + uint_c(i) ] ];
+
+      collide( in, out );
+
+      for( uint_t f = uint_t(0); f != Stencil::Size; ++f )
+         dst[ f * numberOfCells + uint_c(i) ] = out[f];
+   }
+
+   pdfList->swap();
+}
+
+
+
+} // namespace lbm
+} // namespace walberla
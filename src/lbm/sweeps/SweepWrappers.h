@@ -70,6 +70,27 @@ template< typename Kernel >
 inline CollideSweep< Kernel > makeCollideSweep( const shared_ptr< Kernel > & kernel ) { return CollideSweep<Kernel>( kernel ); }
 
 
+template< typename Kernel >
+class StreamCollideSweep
+{
+public:
+
+   StreamCollideSweep( const shared_ptr< Kernel > & kernel ) : kernel_( kernel ) {}
+
+   void operator()( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) )
+   {
+      kernel_->streamCollide( block, numberOfGhostLayersToInclude );
+   }
+
+private:
+
+   shared_ptr< Kernel > kernel_;
+};
+
+template< typename Kernel >
+inline StreamCollideSweep< Kernel > makeStreamCollideSweep( const shared_ptr< Kernel > & kernel ) { return StreamCollideSweep<Kernel>( kernel ); }
+
+
 
 } // namespace lbm
 } // namespace walberla
@@ -0,0 +1,138 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file TemporalBlockingSweep.h
+//! \ingroup lbm
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "lbm/sweeps/SweepWrappers.h"
+
+#include "core/DataTypes.h"
+#include "core/debug/CheckFunctions.h"
+#include "domain_decomposition/BlockDataID.h"
+#include "domain_decomposition/IBlock.h"
+
+#include <functional>
+#include <vector>
+
+
+namespace walberla {
+namespace lbm {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Sweep that performs several LBM time steps per block before the next ghost layer exchange (temporal blocking)
+*
+*   \section docTemporalBlockingSweep Temporal Blocking for the LBM
+*
+*   The PDF field (and the flag field) must be allocated with at least 'depth' ghost layers. Once every 'depth' time
+*   steps all ghost layers are synchronized, afterwards each block is advanced by 'depth' time steps in a row: during
+*   the first sub-step 'depth - 1' ghost layers are updated redundantly, during the second sub-step 'depth - 2' ghost
+*   layers, ..., and the last sub-step only updates the interior of the block. Since all sub-steps of one block are
+*   executed right after each other, the PDF data of the block is streamed through main memory only once if the block
+*   (including its ghost layers) fits into the cache. Small blocks (i.e., many blocks per process) therefore act as the
+*   cache-sized tiles of the temporal blocking scheme.
+*
+*   All sweeps registered via 'addSweep' are executed in the order of their registration for every sub-step. They must
+*   accept the number of ghost layers that have to be included as second argument, which is the case for the
+*   'streamCollide', 'stream', and 'collide' functions of the LBM sweeps that support ghost layers (see
+*   StreamCollideSweep, StreamSweep, and CollideSweep in 'SweepWrappers.h') and for the boundary handling (see
+*   TemporalBlockingBoundarySweep below). Typically, the boundary sweep is registered first, followed by the fused
+*   stream & collide sweep of a CellwiseSweep.
+*
+*   The communication must synchronize all ghost layers and all PDF components, i.e., a
+*   field::communication::PackInfo for the PDF field together with a D3Q27 communication stencil must be used
+*   (lbm::PdfFieldPackInfo only communicates the components of the outermost ghost layer that point into the block).
+*   It is registered as a BeforeFunction of this sweep:
+*
+*   \code
+*   blockforest::communication::UniformBufferedScheme< stencil::D3Q27 > communication( blocks );
+*   communication.addPackInfo( make_shared< field::communication::PackInfo< PdfField_T > >( pdfFieldId ) );
+*
+*   auto sweep = lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( pdfFieldId, flagFieldId, Fluid_Flag );
+*
+*   lbm::TemporalBlockingSweep temporalBlocking( depth );
+*   temporalBlocking.addSweep( lbm::TemporalBlockingBoundarySweep< BoundaryHandling_T >( boundaryHandlingId ) );
+*   temporalBlocking.addSweep( lbm::makeStreamCollideSweep( sweep ) );
+*
+*   timeloop.add() << BeforeFunction( communication, "LB communication" )
+*                  << Sweep( temporalBlocking, "LB boundary sweep & stream & collide (temporal blocking)" );
+*   \endcode
+*
+*   Please note that one time step of the time loop corresponds to 'depth' LBM time steps!
+*/
+//**********************************************************************************************************************
+
+class TemporalBlockingSweep
+{
+public:
+
+   typedef std::function< void ( IBlock * const, const uint_t ) > GhostLayerSweep;
+
+   TemporalBlockingSweep( const uint_t depth ) : depth_( depth )
+   {
+      WALBERLA_CHECK_GREATER( depth_, uint_t(0), "The depth of the temporal blocking must be at least one time step!" );
+   }
+
+   void addSweep( const GhostLayerSweep & sweep ) { sweeps_.push_back( sweep ); }
+
+   uint_t depth() const { return depth_; }
+
+   void operator()( IBlock * const block )
+   {
+      for( uint_t step = uint_t(0); step != depth_; ++step )
+      {
+         const uint_t numberOfGhostLayersToInclude = depth_ - step - uint_t(1);
+         for( auto sweep = sweeps_.begin(); sweep != sweeps_.end(); ++sweep )
+            (*sweep)( block, numberOfGhostLayersToInclude );
+      }
+   }
+
+private:
+
+   uint_t depth_;
+   std::vector< GhostLayerSweep > sweeps_;
+};
+
+
+
+/// Treats all boundaries of a block's boundary handling, including the boundaries in the given number of ghost layers
+template< typename BoundaryHandling_T >
+class TemporalBlockingBoundarySweep
+{
+public:
+
+   TemporalBlockingBoundarySweep( const BlockDataID & handling ) : handling_( handling ) {}
+
+   void operator()( IBlock * const block, const uint_t numberOfGhostLayersToInclude )
+   {
+      BoundaryHandling_T * handling = block->getData< BoundaryHandling_T >( handling_ );
+      (*handling)( numberOfGhostLayersToInclude );
+   }
+
+private:
+
+   const BlockDataID handling_;
+};
+
+
+
+} // namespace lbm
+} // namespace walberla
@@ -24,9 +24,13 @@
 
 #include "ActiveCellSweep.h"
 #include "CellwiseSweep.h"
+#include "InPlaceSweep.h"
+#include "SIMDSweep.h"
 #include "SplitPureSweep.h"
+#include "SparsePdfListSweep.h"
 #include "SplitSweep.h"
 #include "SweepWrappers.h"
+#include "TemporalBlockingSweep.h"
 
 #include "cell_operations/AdvectionDiffusionCellOperation.h"
 #include "cell_operations/DefaultCellOperation.h"
@@ -83,7 +83,23 @@ public:
    SplitSweep( const BlockDataID & src, const BlockDataID & dst, const ConstBlockDataID & flagField, const Set< FlagUID > & lbmMask ) :
       FlagFieldSweepBase<LatticeModel_T,FlagField_T>( src, dst, flagField, lbmMask ) {}
 
-   void operator()( IBlock * const block );
+   void operator()( IBlock * const block )
+   {
+      (*this)( block, this->getSrcField( block )->xyzSize() );
+      swap( block );
+   }
+
+   /// stream & collide restricted to 'cells', src and dst are NOT swapped (required for splitting the sweep into
+   /// an inner and an outer part, see domain_decomposition/InnerOuterSplit.h - requires a dedicated dst field)
+   void operator()( IBlock * const block, const CellInterval & cells );
+
+   void swap( IBlock * const block )
+   {
+      PdfField_T * src( NULL );
+      PdfField_T * dst( NULL );
+      this->getFields( block, src, dst );
+      src->swapDataPointers( dst );
+   }
 
    void stream ( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
    void collide( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
@@ -96,8 +112,11 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
                                                                                            boost::mpl::not_< boost::mpl::bool_< LatticeModel_T::compressible > >,
                                                                                            boost::is_same< typename LatticeModel_T::ForceModel::tag,
                                                                                                            force_model::None_tag > > >::type
-   >::operator()( IBlock * const block )                                               
+   >::operator()( IBlock * const block, const CellInterval & cells )
 {
+   if( cells.empty() )
+      return;
+
    PdfField_T * src( NULL );
    PdfField_T * dst( NULL );
    const FlagField_T * flagField( NULL );
@@ -105,6 +124,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
    auto lbm = this->getLbmMaskAndFields( block, src, dst, flagField );
 
    WALBERLA_ASSERT_GREATER_EQUAL( src->nrOfGhostLayers(), 1 );
+   WALBERLA_ASSERT( src->xyzSize().contains( cells ) );
 
    // constants used during stream/collide
 
@@ -128,6 +148,9 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    const cell_idx_t xSize = cell_idx_c( src->xSize() );
 
+   const cell_idx_t xBegin = cells.xMin();
+   const cell_idx_t xEnd   = cells.xMax() + cell_idx_t(1);
+
 #ifdef _OPENMP
    #pragma omp parallel
    {
@@ -144,7 +167,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    if( src->layout() == field::fzyx && dst->layout() == field::fzyx )
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
@@ -170,7 +193,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
          real_t * WALBERLA_RESTRICT dC = &dst->get(0,y,z,Stencil::idx[C]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -196,7 +219,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dNE = &dst->get(0,y,z,Stencil::idx[NE]);
          real_t * WALBERLA_RESTRICT dSW = &dst->get(0,y,z,Stencil::idx[SW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -212,7 +235,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dSE = &dst->get(0,y,z,Stencil::idx[SE]);
          real_t * WALBERLA_RESTRICT dNW = &dst->get(0,y,z,Stencil::idx[NW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -228,7 +251,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTE = &dst->get(0,y,z,Stencil::idx[TE]);
          real_t * WALBERLA_RESTRICT dBW = &dst->get(0,y,z,Stencil::idx[BW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -244,7 +267,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dBE = &dst->get(0,y,z,Stencil::idx[BE]);
          real_t * WALBERLA_RESTRICT dTW = &dst->get(0,y,z,Stencil::idx[TW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -260,7 +283,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTN = &dst->get(0,y,z,Stencil::idx[TN]);
          real_t * WALBERLA_RESTRICT dBS = &dst->get(0,y,z,Stencil::idx[BS]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -276,7 +299,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dBN = &dst->get(0,y,z,Stencil::idx[BN]);
          real_t * WALBERLA_RESTRICT dTS = &dst->get(0,y,z,Stencil::idx[TS]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -292,7 +315,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dN = &dst->get(0,y,z,Stencil::idx[N]);
          real_t * WALBERLA_RESTRICT dS = &dst->get(0,y,z,Stencil::idx[S]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -307,7 +330,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dE = &dst->get(0,y,z,Stencil::idx[E]);
          real_t * WALBERLA_RESTRICT dW = &dst->get(0,y,z,Stencil::idx[W]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -322,7 +345,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dT = &dst->get(0,y,z,Stencil::idx[T]);
          real_t * WALBERLA_RESTRICT dB = &dst->get(0,y,z,Stencil::idx[B]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -334,15 +357,15 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          )
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
    else // ==> src->layout() == field::zyxf || dst->layout() == field::zyxf
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -385,7 +408,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             else perform_lbm[x] = false;
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -401,7 +424,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -417,7 +440,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -433,7 +456,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -449,7 +472,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -465,7 +488,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -481,7 +504,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -496,7 +519,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -511,7 +534,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -526,7 +549,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
 
    delete[] velX;
@@ -538,8 +561,6 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 #ifdef _OPENMP
    }
 #endif
-
-   src->swapDataPointers( dst );
 }
 
 template< typename LatticeModel_T, typename FlagField_T >
@@ -1025,7 +1046,23 @@ public:
    SplitSweep( const BlockDataID & src, const BlockDataID & dst, const ConstBlockDataID & flagField, const Set< FlagUID > & lbmMask ) :
       FlagFieldSweepBase<LatticeModel_T,FlagField_T>( src, dst, flagField, lbmMask ) {}
 
-   void operator()( IBlock * const block );
+   void operator()( IBlock * const block )
+   {
+      (*this)( block, this->getSrcField( block )->xyzSize() );
+      swap( block );
+   }
+
+   /// stream & collide restricted to 'cells', src and dst are NOT swapped (required for splitting the sweep into
+   /// an inner and an outer part, see domain_decomposition/InnerOuterSplit.h - requires a dedicated dst field)
+   void operator()( IBlock * const block, const CellInterval & cells );
+
+   void swap( IBlock * const block )
+   {
+      PdfField_T * src( NULL );
+      PdfField_T * dst( NULL );
+      this->getFields( block, src, dst );
+      src->swapDataPointers( dst );
+   }
 
    void stream ( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
    void collide( IBlock * const block, const uint_t numberOfGhostLayersToInclude = uint_t(0) );
@@ -1038,8 +1075,11 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
                                                                                            boost::mpl::bool_< LatticeModel_T::compressible >,
                                                                                            boost::is_same< typename LatticeModel_T::ForceModel::tag,
                                                                                                            force_model::None_tag > > >::type
-   >::operator()( IBlock * const block )
+   >::operator()( IBlock * const block, const CellInterval & cells )
 {
+   if( cells.empty() )
+      return;
+
    PdfField_T * src( NULL );
    PdfField_T * dst( NULL );
    const FlagField_T * flagField( NULL );
@@ -1047,6 +1087,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
    auto lbm = this->getLbmMaskAndFields( block, src, dst, flagField );
 
    WALBERLA_ASSERT_GREATER_EQUAL( src->nrOfGhostLayers(), 1 );
+   WALBERLA_ASSERT( src->xyzSize().contains( cells ) );
 
    // constants used during stream/collide
 
@@ -1068,6 +1109,9 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    const cell_idx_t xSize = cell_idx_c( src->xSize() );
 
+   const cell_idx_t xBegin = cells.xMin();
+   const cell_idx_t xEnd   = cells.xMax() + cell_idx_t(1);
+
 #ifdef _OPENMP
    #pragma omp parallel
    {
@@ -1089,7 +1133,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
    if( src->layout() == field::fzyx && dst->layout() == field::fzyx )
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
@@ -1115,7 +1159,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 
          real_t * WALBERLA_RESTRICT dC = &dst->get(0,y,z,Stencil::idx[C]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -1147,7 +1191,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dNE = &dst->get(0,y,z,Stencil::idx[NE]);
          real_t * WALBERLA_RESTRICT dSW = &dst->get(0,y,z,Stencil::idx[SW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1163,7 +1207,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dSE = &dst->get(0,y,z,Stencil::idx[SE]);
          real_t * WALBERLA_RESTRICT dNW = &dst->get(0,y,z,Stencil::idx[NW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1179,7 +1223,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTE = &dst->get(0,y,z,Stencil::idx[TE]);
          real_t * WALBERLA_RESTRICT dBW = &dst->get(0,y,z,Stencil::idx[BW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1195,7 +1239,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dBE = &dst->get(0,y,z,Stencil::idx[BE]);
          real_t * WALBERLA_RESTRICT dTW = &dst->get(0,y,z,Stencil::idx[TW]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1211,7 +1255,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dTN = &dst->get(0,y,z,Stencil::idx[TN]);
          real_t * WALBERLA_RESTRICT dBS = &dst->get(0,y,z,Stencil::idx[BS]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1227,7 +1271,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dBN = &dst->get(0,y,z,Stencil::idx[BN]);
          real_t * WALBERLA_RESTRICT dTS = &dst->get(0,y,z,Stencil::idx[TS]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1243,7 +1287,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dN = &dst->get(0,y,z,Stencil::idx[N]);
          real_t * WALBERLA_RESTRICT dS = &dst->get(0,y,z,Stencil::idx[S]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1258,7 +1302,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dE = &dst->get(0,y,z,Stencil::idx[E]);
          real_t * WALBERLA_RESTRICT dW = &dst->get(0,y,z,Stencil::idx[W]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1273,7 +1317,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
          real_t * WALBERLA_RESTRICT dT = &dst->get(0,y,z,Stencil::idx[T]);
          real_t * WALBERLA_RESTRICT dB = &dst->get(0,y,z,Stencil::idx[B]);
 
-         X_LOOP
+         X_LOOP_INTERVAL
          (
             if( perform_lbm[x] )
             {
@@ -1285,15 +1329,15 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          )
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
    else // ==> src->layout() == field::zyxf || dst->layout() == field::zyxf
    {
-      WALBERLA_FOR_ALL_CELLS_YZ_OMP( src, omp for schedule(static),
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP( cells, omp for schedule(static),
 
          using namespace stencil;
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( flagField->isPartOfMaskSet( x, y, z, lbm ) )
             {
@@ -1342,7 +1386,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             else perform_lbm[x] = false;
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1358,7 +1402,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1374,7 +1418,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1390,7 +1434,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1406,7 +1450,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1422,7 +1466,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1438,7 +1482,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1453,7 +1497,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1468,7 +1512,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-         for( cell_idx_t x = 0; x != xSize; ++x )
+         for( cell_idx_t x = xBegin; x != xEnd; ++x )
          {
             if( perform_lbm[x] )
             {
@@ -1483,7 +1527,7 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
             }
          }
 
-      ) // WALBERLA_FOR_ALL_CELLS_YZ_OMP
+      ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_YZ_OMP
    }
 
    delete[] velX;
@@ -1499,8 +1543,6 @@ void SplitSweep< LatticeModel_T, FlagField_T, typename boost::enable_if< boost::
 #ifdef _OPENMP
    }
 #endif
-
-   src->swapDataPointers( dst );
 }
 
 template< typename LatticeModel_T, typename FlagField_T >
@@ -47,13 +47,28 @@ public:
    Jacobi( const BlockDataID & src, const BlockDataID & dst, const BlockDataID & fFieldId, const BlockDataID & stencilFieldId ) :
       StencilFieldSweepBase< Stencil_T >( src, dst, fFieldId, stencilFieldId ) {}
 
-   void operator()( IBlock * const block );
+   void operator()( IBlock * const block )
+   {
+      (*this)( block, this->getSrcField( block )->xyzSize() );
+      swap( block );
+   }
+
+   /// Jacobi update restricted to 'cells', src and dst are NOT swapped (required for splitting the sweep into an
+   /// inner and an outer part, see domain_decomposition/InnerOuterSplit.h - requires a dedicated dst field)
+   void operator()( IBlock * const block, const CellInterval & cells );
+
+   void swap( IBlock * const block )
+   {
+      Field_T * sf = this->getSrcField( block );
+      Field_T * df = this->getDstField( block, sf );
+      sf->swapDataPointers( df );
+   }
 };
 
 
 
 template< typename Stencil_T >
-void Jacobi< Stencil_T >::operator()( IBlock * const block )
+void Jacobi< Stencil_T >::operator()( IBlock * const block, const CellInterval & cells )
 {
    Field_T * sf( NULL );
    Field_T * df( NULL );
@@ -62,8 +77,9 @@ void Jacobi< Stencil_T >::operator()( IBlock * const block )
    this->getFields( block, sf, df, ff, stencil );
 
    WALBERLA_ASSERT_GREATER_EQUAL( sf->nrOfGhostLayers(), 1 );
-   
-   WALBERLA_FOR_ALL_CELLS_XYZ( sf,
+   WALBERLA_ASSERT( sf->xyzSize().contains( cells ) );
+
+   WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_XYZ( cells,
 
       df->get(x,y,z) = ff->get(x,y,z);
 
@@ -72,9 +88,7 @@ void Jacobi< Stencil_T >::operator()( IBlock * const block )
 
       df->get(x,y,z) /= stencil->get( x, y, z, Stencil_T::idx[stencil::C] );
 
-   ) // WALBERLA_FOR_ALL_CELLS_XYZ
-
-   sf->swapDataPointers( df );
+   ) // WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_XYZ
 }
 
 
@@ -51,3 +51,4 @@
 
 #include "pe/utility/CreateWorld.h"
 #include "pe/utility/GetBody.h"
+#include "pe/utility/SortBodies.h"
@@ -30,6 +30,8 @@
 
 #include "core/timing/TimingTree.h"
 
+#include <limits>
+
 namespace walberla{
 namespace pe{
 namespace ccd {
@@ -183,7 +185,25 @@ void HashGrids::HashGrid::remove( BodyID body )
 void HashGrids::HashGrid::update( BodyID body )
 {
    // The hash value is recomputed based on the body's current spatial location.
-   size_t newHash = hash( body );
+   update( body, hash( body ) );
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Updates the cell association of a body that is assigned to this grid.
+ *
+ * \param body The body whose cell association is being updated.
+ * \param newHash The hash value of the body's current spatial location (see hash()).
+ * \return void
+ *
+ * Same as update( BodyID ), but with a hash value that was computed in advance. The hash value is
+ * only valid as long as the number of cells of this grid does not change (see getCellCount()).
+ */
+void HashGrids::HashGrid::update( BodyID body, size_t newHash )
+{
+   WALBERLA_ASSERT_EQUAL( newHash, hash( body ) );
+
    size_t oldHash = body->getHash();
 
    // If this new hash value is identical to the hash value of the previous time step, the body
@@ -871,50 +891,78 @@ void HashGrids::update(WcTimingTree* tt)
       //                        its current grid (=> "grid->remove()") and reassigned to a grid with
       //                        suitably sized cells (=> "addGrid()").
 
-      {
-         for( auto& body : bodystorage_ )
-         {
-            HashGrid* grid = static_cast<HashGrid*>( body.getGrid() );
-
-            if( grid != nullptr )
-            {
-               real_t size     = body.getAABBSize();
-               real_t cellSpan = grid->getCellSpan();
+      updateBodies( bodystorage_ );
 
-               if( size >= cellSpan || size < ( cellSpan / hierarchyFactor ) ) {
-                  grid->remove( &body );
-                  addGrid( &body );
-               }
-               else {
-                  grid->update( &body );
-               }
-            }
-         }
+      if( &bodystorage_ != &bodystorageShadowCopies_ ) {
+         updateBodies( bodystorageShadowCopies_ );
       }
+   }
+   if (tt != nullptr) tt->stop("Update");
+}
 
-      if( &bodystorage_ != &bodystorageShadowCopies_ ) {
-         for( auto& body : bodystorageShadowCopies_ )
-         {
-            HashGrid* grid = static_cast<HashGrid*>( body.getGrid() );
+//*************************************************************************************************
+/*!\brief Updates the grid and cell associations of all bodies of a body storage.
+ *
+ * \param storage The body storage whose bodies are updated.
+ * \return void
+ *
+ * The new associations (see update strategy 2 in update()) are computed in parallel since this only
+ * requires read access to the bodies and grids. The bodies are reassigned afterwards in the order
+ * of the body storage. A precomputed hash value is only used if the number of cells of the grid did
+ * not change in the meantime (a grid is enlarged if too many bodies are assigned to it).
+ */
+void HashGrids::updateBodies( BodyStorage& storage )
+{
+   const size_t regrid = std::numeric_limits<size_t>::max();
 
-            if( grid != nullptr )
-            {
-               real_t size     = body.getAABBSize();
-               real_t cellSpan = grid->getCellSpan();
+   std::vector< BodyID > bodies;
+   bodies.reserve( storage.size() );
+   for( auto& body : storage )
+   {
+      if( body.getGrid() != nullptr )
+         bodies.push_back( &body );
+   }
 
-               if( size >= cellSpan || size < ( cellSpan / hierarchyFactor ) ) {
-                  grid->remove( &body );
-                  addGrid( &body );
-               }
-               else {
-                  grid->update( &body );
-               }
-            }
-         }
+   std::vector< size_t > hashes   ( bodies.size() );
+   std::vector< size_t > cellCounts( bodies.size() );
+
+   const int bodyCount = static_cast<int>( bodies.size() );
+   #pragma omp parallel for schedule(static)
+   for( int i = 0; i < bodyCount; ++i )
+   {
+      BodyID    body = bodies[ static_cast<size_t>( i ) ];
+      HashGrid* grid = static_cast<HashGrid*>( body->getGrid() );
+
+      real_t size     = body->getAABBSize();
+      real_t cellSpan = grid->getCellSpan();
+
+      if( size >= cellSpan || size < ( cellSpan / hierarchyFactor ) ) {
+         hashes[ static_cast<size_t>( i ) ] = regrid;
+      }
+      else {
+         hashes    [ static_cast<size_t>( i ) ] = grid->hash( body );
+         cellCounts[ static_cast<size_t>( i ) ] = grid->getCellCount();
+      }
+   }
+
+   for( size_t i = 0; i < bodies.size(); ++i )
+   {
+      BodyID    body = bodies[i];
+      HashGrid* grid = static_cast<HashGrid*>( body->getGrid() );
+
+      if( hashes[i] == regrid ) {
+         grid->remove( body );
+         addGrid( body );
+      }
+      else if( cellCounts[i] == grid->getCellCount() ) {
+         grid->update( body, hashes[i] );
+      }
+      else {
+         grid->update( body );
       }
    }
-   if (tt != nullptr) tt->stop("Update");
 }
+//*************************************************************************************************
 
 //**Implementation of ICCD interface ********************************************************
 //*************************************************************************************************
@@ -954,33 +1002,36 @@ PossibleContacts& HashGrids::generatePossibleContacts( WcTimingTree* tt )
             (*nextGridIt)->processBodies( bodies, bodyCount, contacts_ );
          }
 
-         BodyID* bodiesEnd = bodies + bodyCount;
-         for( BodyID* a = bodies; a < bodiesEnd; ++a ) {
+         collideInParallel( bodyCount, contacts_, [this,bodies]( const size_t i, PossibleContacts& contacts )
+         {
+            BodyID* a = bodies + i;
             // Test all bodies stored in 'grid' against all bodies stored in 'nonGridBodies_'.
             for( auto bIt = nonGridBodies_.begin(); bIt < nonGridBodies_.end(); ++bIt ) {
-               collide( *a, *bIt, contacts_ );
+               collide( *a, *bIt, contacts );
             }
             // Test all bodies stored in 'grid' against all bodies stored in 'globalStorage_'.
             for( auto bIt = globalStorage_.begin(); bIt < globalStorage_.end(); ++bIt ) {
-               collide( *a, &(*bIt), contacts_ );
+               collide( *a, &(*bIt), contacts );
             }
-         }
+         } );
       }
 
       delete[] bodies;
    }
 
-   for( auto aIt = nonGridBodies_.begin(); aIt < nonGridBodies_.end(); ++aIt ) {
+   collideInParallel( nonGridBodies_.size(), contacts_, [this]( const size_t i, PossibleContacts& contacts )
+   {
+      auto aIt = nonGridBodies_.begin() + static_cast<std::ptrdiff_t>( i );
       // Pairwise test (=> contact generation) for all bodies that are stored in 'nonGridBodies_'.
       for( auto bIt = aIt + 1; bIt < nonGridBodies_.end(); ++bIt ) {
-         collide( *aIt, *bIt, contacts_ );
+         collide( *aIt, *bIt, contacts );
       }
 
       // Pairwise test (=> contact generation) for all bodies that are stored in 'nonGridBodies_' with global bodies.
       for( auto bIt = globalStorage_.begin(); bIt < globalStorage_.end(); ++bIt ) {
-         collide( *aIt, &(*bIt), contacts_ );
+         collide( *aIt, &(*bIt), contacts );
       }
-   }
+   } );
    if (tt != nullptr) tt->stop("Detection");
 
    WALBERLA_LOG_DETAIL_SECTION()
@@ -1331,6 +1382,20 @@ const size_t HashGrids::gridActivationThreshold = 32;
 const real_t HashGrids::hierarchyFactor = real_c(2);
 //*************************************************************************************************
 
+
+//*************************************************************************************************
+/*!\brief The minimal number of work items (cells or bodies) per chunk of the parallel collision detection.
+ *
+ * The contact generation is split into chunks that are processed by different OpenMP threads (see
+ * collideInParallel()). Every chunk requires a separate contact container that is merged into the
+ * final container afterwards. Chunks that are too small do not pay off this overhead - in particular,
+ * hash grids with only a few occupied cells are always processed serially.
+ *
+ * Possible settings: any integral value greater than 0.
+ */
+const size_t HashGrids::minimalParallelChunkSize = 32;
+//*************************************************************************************************
+
 }  // namespace ccd
 
 }  // namespace pe
@@ -34,7 +34,9 @@
 #include <core/logging/Logging.h>
 #include <core/debug/Debug.h>
 #include <core/NonCopyable.h>
+#include <core/OpenMP.h>
 
+#include <algorithm>
 #include <cmath>
 #include <list>
 #include <sstream>
@@ -98,6 +100,7 @@ public:
    static const size_t minimalGridDensity;
    static const size_t gridActivationThreshold;
    static const real_t hierarchyFactor;
+   static const size_t minimalParallelChunkSize;
    //**********************************************************************************************
    
    static uint64_t intersectionTestCount; // ToDo remove again
@@ -163,6 +166,7 @@ private:
       /*!\name Getter functions */
       //@{
       real_t getCellSpan() const { return cellSpan_; }  //!< Getter for \a cellSpan_.
+      size_t getCellCount() const { return xyzCellCount_; }  //!< Getter for \a xyzCellCount_.
       //@}
       //*******************************************************************************************
 
@@ -178,6 +182,9 @@ private:
       /*!\name Utility functions */
       //@{
       void update( BodyID body );
+      void update( BodyID body, size_t newHash );
+
+      size_t hash( BodyID body ) const;
 
       template< typename Contacts >
       size_t process      ( BodyID** gridBodies, Contacts& contacts ) const;
@@ -207,7 +214,9 @@ private:
       //@{
       void initializeNeighborOffsets();
 
-      size_t hash( BodyID body ) const;
+      template< typename Contacts >
+      void processCell( const Cell* cell, Contacts& contacts ) const;
+
       size_t hashPoint(real_t x, real_t y, real_t z) const;
 
       void add   ( BodyID body, Cell* cell );
@@ -315,6 +324,9 @@ protected:
    //@{
    template< typename Contacts >
    static inline void collide( BodyID a, BodyID b, Contacts& contacts );
+
+   template< typename Contacts, typename Functor >
+   static void collideInParallel( size_t size, Contacts& contacts, const Functor& functor );
    //@}
    //**********************************************************************************************
 
@@ -327,6 +339,13 @@ private:
    //@}
    //**********************************************************************************************
 
+   //**Update functions****************************************************************************
+   /*!\name Update functions */
+   //@{
+   void updateBodies( BodyStorage& storage );
+   //@}
+   //**********************************************************************************************
+
    //**Utility functions***************************************************************************
    /*!\name Utility functions */
    //@{
@@ -387,6 +406,8 @@ private:
  * contacts are added to the contact container \a contacts. Moreover, a linear array that contains
  * (handles to) all bodies that are stored in this grid is returned in order to being able to check
  * these bodies against other bodies that are stored in grids with larger sized cells.
+ * The occupied cells are processed in parallel (see HashGrids::collideInParallel()), the order of
+ * the generated contacts does not depend on the number of threads.
  */
 template< typename Contacts >  // Contact container type
 size_t HashGrids::HashGrid::process( BodyID** gridBodies, Contacts& contacts ) const
@@ -394,56 +415,78 @@ size_t HashGrids::HashGrid::process( BodyID** gridBodies, Contacts& contacts ) c
    BodyID* bodies = new BodyID[ bodyCount_ ];
    *gridBodies    = bodies;
 
-   // Iterate through all cells that are occupied by bodies (=> 'occupiedCells_') and ...
    for( typename CellVector::const_iterator cell = occupiedCells_.begin(); cell < occupiedCells_.end(); ++cell )
    {
       BodyVector* cellBodies = (*cell)->bodies_;
-
-      // ... perform pairwise collision checks within each of these cells.
-      for( auto aIt = cellBodies->begin(); aIt < cellBodies->end(); ++aIt ) {
-         auto end = cellBodies->begin();
-         if ((*aIt)->isFixed())
-         {
-            end = cellBodies->begin() + ((*cell)->lastNonFixedBody_ + 1);
-         } else
-         {
-            end = cellBodies->end();
-         }
-         for( auto bIt = aIt + 1; bIt < end; ++bIt ) {
-            WALBERLA_ASSERT( !((*aIt)->isFixed() && (*bIt)->isFixed()), "collision between two fixed bodies" );
-            HashGrids::collide( *aIt, *bIt, contacts );
-         }
+      for( auto aIt = cellBodies->begin(); aIt < cellBodies->end(); ++aIt )
          *(bodies++) = *aIt;
-      }
+   }
 
-      // Moreover, check all the bodies that are stored in the currently processed cell against all
-      // bodies that are stored in the first half of all directly adjacent cells.
-      for( unsigned int i = 0; i < 13; ++i )
+   // Iterate through all cells that are occupied by bodies (=> 'occupiedCells_').
+   HashGrids::collideInParallel( occupiedCells_.size(), contacts,
+                                 [this]( const size_t i, Contacts& localContacts ) { processCell( occupiedCells_[i], localContacts ); } );
+
+   return bodyCount_;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Generates all contacts of the bodies that are stored in one cell of this hash grid.
+ *
+ * \param cell The processed cell.
+ * \param contacts Contact container for the generated contacts.
+ * \return void
+ *
+ * Checks the bodies that are stored in the cell against each other and against all the bodies
+ * that are stored in the first half of all directly adjacent cells.
+ */
+template< typename Contacts >  // Contact container type
+void HashGrids::HashGrid::processCell( const Cell* cell, Contacts& contacts ) const
+{
+   BodyVector* cellBodies = cell->bodies_;
+
+   // ... perform pairwise collision checks within each of these cells.
+   for( auto aIt = cellBodies->begin(); aIt < cellBodies->end(); ++aIt ) {
+      auto end = cellBodies->begin();
+      if ((*aIt)->isFixed())
       {
-         Cell*       nbCell   = (*cell) + (*cell)->neighborOffset_[i];
-         BodyVector* nbBodies = nbCell->bodies_;
+         end = cellBodies->begin() + (cell->lastNonFixedBody_ + 1);
+      } else
+      {
+         end = cellBodies->end();
+      }
+      for( auto bIt = aIt + 1; bIt < end; ++bIt ) {
+         WALBERLA_ASSERT( !((*aIt)->isFixed() && (*bIt)->isFixed()), "collision between two fixed bodies" );
+         HashGrids::collide( *aIt, *bIt, contacts );
+      }
+   }
+
+   // Moreover, check all the bodies that are stored in the currently processed cell against all
+   // bodies that are stored in the first half of all directly adjacent cells.
+   for( unsigned int i = 0; i < 13; ++i )
+   {
+      const Cell* nbCell   = cell + cell->neighborOffset_[i];
+      BodyVector* nbBodies = nbCell->bodies_;
 
-         if( nbBodies != NULL )
-         {
-            for( auto aIt = cellBodies->begin(); aIt < cellBodies->end(); ++aIt ) {
-               auto endNeighbour = nbBodies->begin();
-               if ((*aIt)->isFixed())
-               {
-                  endNeighbour = nbBodies->begin() + (nbCell->lastNonFixedBody_ + 1);
-               } else
-               {
-                  endNeighbour = nbBodies->end();
-               }
-               for( auto bIt = nbBodies->begin(); bIt < endNeighbour; ++bIt ) {
-                  WALBERLA_ASSERT( !((*aIt)->isFixed() && (*bIt)->isFixed()), "collision between two fixed bodies" );
-                  HashGrids::collide( *aIt, *bIt, contacts );
-               }
+      if( nbBodies != NULL )
+      {
+         for( auto aIt = cellBodies->begin(); aIt < cellBodies->end(); ++aIt ) {
+            auto endNeighbour = nbBodies->begin();
+            if ((*aIt)->isFixed())
+            {
+               endNeighbour = nbBodies->begin() + (nbCell->lastNonFixedBody_ + 1);
+            } else
+            {
+               endNeighbour = nbBodies->end();
+            }
+            for( auto bIt = nbBodies->begin(); bIt < endNeighbour; ++bIt ) {
+               WALBERLA_ASSERT( !((*aIt)->isFixed() && (*bIt)->isFixed()), "collision between two fixed bodies" );
+               HashGrids::collide( *aIt, *bIt, contacts );
             }
          }
       }
    }
-
-   return bodyCount_;
 }
 //*************************************************************************************************
 
@@ -460,16 +503,18 @@ size_t HashGrids::HashGrid::process( BodyID** gridBodies, Contacts& contacts ) c
  *
  * This function generates all contacts between the rigid bodies that are stored in \a bodies and
  * all the rigid bodies that are assigned to this grid. The contacts are added to the contact
- * container \a contacts.
+ * container \a contacts. The bodies are processed in parallel (see HashGrids::collideInParallel()).
  */
 template< typename Contacts >  // Contact container type
 void HashGrids::HashGrid::processBodies( BodyID* bodies, size_t bodyCount, Contacts& contacts ) const
 {
    // For each body 'a' that is stored in 'bodies' ...
-   for( BodyID* aIt = bodies; aIt < bodies + bodyCount; ++aIt )
+   HashGrids::collideInParallel( bodyCount, contacts, [this,bodies]( const size_t b, Contacts& localContacts )
    {
+      BodyID* aIt = bodies + b;
+
       // ... calculate the body's cell association (=> "hash()") within this hash grid and ...
-      Cell* cell = cell_ + hash( *aIt );
+      const Cell* cell = cell_ + hash( *aIt );
 
       // ... check 'a' against every body that is stored in this or in any of the directly adjacent
       // cells. Note: one entry in the offset array of a cell is always referring back to the cell
@@ -477,7 +522,7 @@ void HashGrids::HashGrid::processBodies( BodyID* bodies, size_t bodyCount, Conta
       // simply iterating through all entries of X's offset array!
       for( unsigned int i = 0; i < 27; ++i )
       {
-         Cell*       nbCell   = cell + cell->neighborOffset_[i];
+         const Cell* nbCell   = cell + cell->neighborOffset_[i];
          BodyVector* nbBodies = nbCell->bodies_;
 
          if( nbBodies != NULL ) {
@@ -491,11 +536,11 @@ void HashGrids::HashGrid::processBodies( BodyID* bodies, size_t bodyCount, Conta
             }
             for( auto bIt = nbBodies->begin(); bIt != endNeighbour; ++bIt ) {
                WALBERLA_ASSERT( !((*aIt)->isFixed() && (*bIt)->isFixed()), "collision between two fixed bodies" );
-               HashGrids::collide( *aIt, *bIt, contacts );
+               HashGrids::collide( *aIt, *bIt, localContacts );
             }
          }
       }
-   }
+   } );
 }
 //*************************************************************************************************
 
@@ -835,6 +880,56 @@ void HashGrids::collide( BodyID a, BodyID b, Contacts& contacts )
 //*************************************************************************************************
 
 
+//*************************************************************************************************
+/*!\brief Generates contacts for the work items 0 to \a size-1 in parallel.
+ *
+ * \param size The number of work items.
+ * \param contacts Contact container for the generated contacts.
+ * \param functor Called as functor( i, localContacts ) for every work item i.
+ * \return void
+ *
+ * The work items are split into contiguous chunks of at least \a minimalParallelChunkSize items
+ * that are distributed dynamically among the OpenMP threads. Every chunk collects its contacts in
+ * a separate container, these containers are appended to \a contacts in the order of the chunks.
+ * Consequently, the contacts are generated in exactly the same order as in a serial run - the
+ * results are reproducible regardless of the number of threads.
+ */
+template< typename Contacts, typename Functor >  // Contact container type, work item functor type
+void HashGrids::collideInParallel( size_t size, Contacts& contacts, const Functor& functor )
+{
+   const size_t maxChunks = size_t(8) * static_cast<size_t>( omp_get_max_threads() );
+   const size_t chunks    = std::min( maxChunks, size / minimalParallelChunkSize );
+
+   if( chunks <= size_t(1) )
+   {
+      for( size_t i = 0; i < size; ++i )
+         functor( i, contacts );
+      return;
+   }
+
+   std::vector< Contacts > chunkContacts( chunks );
+
+   const int chunkCount = static_cast<int>( chunks );
+   #pragma omp parallel for schedule(dynamic)
+   for( int c = 0; c < chunkCount; ++c )
+   {
+      const size_t begin = ( size * static_cast<size_t>( c ) ) / chunks;
+      const size_t end   = ( size * static_cast<size_t>( c + 1 ) ) / chunks;
+      for( size_t i = begin; i < end; ++i )
+         functor( i, chunkContacts[ static_cast<size_t>( c ) ] );
+   }
+
+   size_t total = contacts.size();
+   for( auto chunk = chunkContacts.begin(); chunk != chunkContacts.end(); ++chunk )
+      total += chunk->size();
+   contacts.reserve( total );
+
+   for( auto chunk = chunkContacts.begin(); chunk != chunkContacts.end(); ++chunk )
+      contacts.insert( contacts.end(), chunk->begin(), chunk->end() );
+}
+//*************************************************************************************************
+
+
 }  // namespace ccd
 
 }  // namespace pe
@@ -0,0 +1,303 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file VerletCCD.cpp
+//
+//======================================================================================================================
+
+#include "VerletCCD.h"
+
+#include "pe/rigidbody/BodyStorage.h"
+
+#include "core/logging/Logging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace walberla {
+namespace pe {
+namespace ccd {
+
+VerletCCD::VerletCCD(BodyStorage& globalStorage, Storage& storage, const real_t skin)
+   : globalStorage_(globalStorage), storage_(storage), skin_(skin)
+   , rebuildRequired_(true), rebuilds_(0), updates_(0)
+{
+   WALBERLA_CHECK_GREATER_EQUAL( skin_, real_t(0), "skin distance must not be negative" );
+
+   storage_[0].registerAddCallback( "VerletCCD", [this](BodyID body){ add(body); } );
+   storage_[0].registerRemoveCallback( "VerletCCD", [this](BodyID body){ remove(body); } );
+
+   storage_[1].registerAddCallback( "VerletCCD", [this](BodyID body){ add(body); } );
+   storage_[1].registerRemoveCallback( "VerletCCD", [this](BodyID body){ remove(body); } );
+}
+
+VerletCCD::~VerletCCD()
+{
+   storage_[0].deregisterAddCallback( "VerletCCD" );
+   storage_[0].deregisterRemoveCallback( "VerletCCD" );
+
+   storage_[1].deregisterAddCallback( "VerletCCD" );
+   storage_[1].deregisterRemoveCallback( "VerletCCD" );
+}
+
+
+PossibleContacts& VerletCCD::generatePossibleContacts( WcTimingTree* tt ){
+   contacts_.clear();
+
+   if (tt != nullptr) tt->start("VerletCCD");
+
+   ++updates_;
+   if (isRebuildRequired())
+   {
+      if (tt != nullptr) tt->start("Rebuild");
+      rebuild();
+      if (tt != nullptr) tt->stop("Rebuild");
+   }
+
+   contacts_.reserve( neighbors_.size() );
+   for (size_t i = 0; i < bodies_.size(); ++i)
+   {
+      BodyID b1 = bodies_[i];
+      for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k)
+      {
+         BodyID b2 = neighbors_[k];
+         if ( b1->getSystemID() > b2->getSystemID() )
+            contacts_.push_back(std::make_pair(b2, b1));
+         else
+            contacts_.push_back(std::make_pair(b1, b2));
+      }
+   }
+
+   if (tt != nullptr) tt->stop("VerletCCD");
+
+   return contacts_;
+}
+
+void VerletCCD::reloadBodies()
+{
+   bodies_.clear();
+   indices_.clear();
+   for (auto& body : storage_[0])
+      add( &body );
+   for (auto& body : storage_[1])
+      add( &body );
+   rebuildRequired_ = true;
+}
+
+int VerletCCD::getObservedBodyCount() const
+{
+   return static_cast<int> (globalStorage_.size() + bodies_.size());
+}
+
+void VerletCCD::add   ( BodyID body )
+{
+   indices_[body] = bodies_.size();
+   bodies_.push_back( body );
+   rebuildRequired_ = true;
+}
+
+void VerletCCD::remove( BodyID body )
+{
+   WALBERLA_LOG_DETAIL( "Removing body " << body->getSystemID() << " from CCD." );
+   auto indexIt = indices_.find( body );
+   if (indexIt != indices_.end())
+   {
+      // the last body takes the place of the removed one
+      const size_t i = indexIt->second;
+      indices_.erase( indexIt );
+      if (i + 1 != bodies_.size())
+      {
+         bodies_[i] = bodies_.back();
+         indices_[bodies_[i]] = i;
+      }
+      bodies_.pop_back();
+   }
+   rebuildRequired_ = true;
+}
+
+//*************************************************************************************************
+/*!\brief Checks whether the neighbor list is still valid.
+ *
+ * The list is valid as long as the set of bodies is unchanged and the current bounding box of
+ * every body is contained in its enlarged bounding box of the last rebuild. For a sphere this is
+ * the case until it moved farther than half the skin along any axis.
+ */
+bool VerletCCD::isRebuildRequired() const
+{
+   if (rebuildRequired_ || globalStorage_.size() != globalBodies_.size())
+      return true;
+
+   for (size_t i = 0; i < bodies_.size(); ++i)
+   {
+      if (!aabbs_[i].contains( bodies_[i]->getAABB() ))
+         return true;
+   }
+
+   size_t j = 0;
+   for (auto it = globalStorage_.begin(); it != globalStorage_.end(); ++it, ++j)
+   {
+      if (it.getBodyID() != globalBodies_[j] || !globalAabbs_[j].contains( it->getAABB() ))
+         return true;
+   }
+
+   return false;
+}
+
+//*************************************************************************************************
+/*!\brief Rebuilds the neighbor list from the current bounding boxes enlarged by half the skin.
+ *
+ * The enlarged bounding boxes are binned by their minimum corner into a uniform grid of cubic
+ * cells whose edge length is at least the largest extent of any enlarged bounding box. Hence two
+ * overlapping boxes are located in the same or in adjacent cells, and only these cells have to be
+ * searched. For bodies of similar size the rebuild therefore scales linearly with the number of
+ * bodies. The number of cells is limited to twice the number of bodies.
+ */
+void VerletCCD::rebuild()
+{
+   ++rebuilds_;
+   rebuildRequired_ = false;
+
+   const real_t halfSkin = real_t(0.5) * skin_;
+
+   aabbs_.resize( bodies_.size() );
+   for (size_t i = 0; i < bodies_.size(); ++i)
+      aabbs_[i] = bodies_[i]->getAABB().getExtended( halfSkin );
+
+   globalBodies_.clear();
+   globalAabbs_.clear();
+   for (auto it = globalStorage_.begin(); it != globalStorage_.end(); ++it)
+   {
+      globalBodies_.push_back( it.getBodyID() );
+      globalAabbs_.push_back( it->getAABB().getExtended( halfSkin ) );
+   }
+
+   // pairs are stored in the row of the body with the smaller index
+   std::vector< std::pair<size_t, BodyID> > pairs;
+   auto addPair = [this, &pairs](const size_t i, const size_t j)
+   {
+      if (bodies_[i]->hasInfiniteMass() && bodies_[j]->hasInfiniteMass())
+         return;
+      if (aabbs_[i].intersectsClosedInterval( aabbs_[j] ))
+         pairs.push_back( std::make_pair( std::min(i, j), bodies_[std::max(i, j)] ) );
+   };
+
+   if (!bodies_.empty())
+   {
+      AABB domain = aabbs_[0];
+      real_t edge = real_t(0);
+      for (size_t i = 0; i < aabbs_.size(); ++i)
+      {
+         domain.merge( aabbs_[i] );
+         edge = std::max( edge, std::max( aabbs_[i].xSize(), std::max( aabbs_[i].ySize(), aabbs_[i].zSize() ) ) );
+      }
+      // limits the number of cells per dimension to 2^20, hence the total number cannot overflow
+      const real_t domainSize = std::max( domain.xSize(), std::max( domain.ySize(), domain.zSize() ) );
+      edge = std::max( edge, domainSize / real_c( uint64_t(1) << 20 ) );
+      if (!(edge > real_t(0)))
+         edge = real_t(1);
+
+      uint64_t cells[3];
+      auto computeCells = [&domain, &cells](const real_t e)
+      {
+         for (uint_t d = 0; d < 3; ++d)
+            cells[d] = static_cast<uint64_t>( std::floor( ( domain.max(d) - domain.min(d) ) / e ) ) + uint64_t(1);
+         return cells[0] * cells[1] * cells[2];
+      };
+      const uint64_t maxCells = uint64_t(2) * uint64_t( bodies_.size() );
+      while (computeCells( edge ) > maxCells)
+         edge *= real_t(2);
+
+      auto cellCoordinate = [&domain, &cells, edge](const AABB& aabb, const uint_t d)
+      {
+         return std::min( static_cast<uint64_t>( ( aabb.min(d) - domain.min(d) ) / edge ), cells[d] - uint64_t(1) );
+      };
+
+      // counting sort of the bodies into the cells
+      const size_t numCells = static_cast<size_t>( cells[0] * cells[1] * cells[2] );
+      std::vector<size_t> cellOfBody( bodies_.size() );
+      std::vector<size_t> cellOffsets( numCells + 1, 0 );
+      for (size_t i = 0; i < bodies_.size(); ++i)
+      {
+         cellOfBody[i] = static_cast<size_t>( ( cellCoordinate( aabbs_[i], 2 ) * cells[1] + cellCoordinate( aabbs_[i], 1 ) ) * cells[0]
+                                              + cellCoordinate( aabbs_[i], 0 ) );
+         ++cellOffsets[ cellOfBody[i] + 1 ];
+      }
+      for (size_t c = 0; c < numCells; ++c)
+         cellOffsets[c + 1] += cellOffsets[c];
+      std::vector<size_t> cellBodies( bodies_.size() );
+      std::vector<size_t> nextInCell( cellOffsets.begin(), cellOffsets.end() - 1 );
+      for (size_t i = 0; i < bodies_.size(); ++i)
+         cellBodies[ nextInCell[ cellOfBody[i] ]++ ] = i;
+
+      // every pair of cells is visited once: the cell itself and the 13 neighbors in forward direction
+      const int forward[13][3] = { { 1, 0, 0}, {-1, 1, 0}, { 0, 1, 0}, { 1, 1, 0},
+                                   {-1,-1, 1}, { 0,-1, 1}, { 1,-1, 1}, {-1, 0, 1}, { 0, 0, 1},
+                                   { 1, 0, 1}, {-1, 1, 1}, { 0, 1, 1}, { 1, 1, 1} };
+      for (uint64_t z = 0; z < cells[2]; ++z)
+         for (uint64_t y = 0; y < cells[1]; ++y)
+            for (uint64_t x = 0; x < cells[0]; ++x)
+            {
+               const size_t c = static_cast<size_t>( ( z * cells[1] + y ) * cells[0] + x );
+               for (size_t s = cellOffsets[c]; s < cellOffsets[c + 1]; ++s)
+                  for (size_t t = s + 1; t < cellOffsets[c + 1]; ++t)
+                     addPair( cellBodies[s], cellBodies[t] );
+
+               for (uint_t n = 0; n < 13; ++n)
+               {
+                  const int64_t nx = int64_c( x ) + forward[n][0];
+                  const int64_t ny = int64_c( y ) + forward[n][1];
+                  const int64_t nz = int64_c( z ) + forward[n][2];
+                  if (nx < 0 || ny < 0 || nx >= int64_c( cells[0] ) || ny >= int64_c( cells[1] ) || nz >= int64_c( cells[2] ))
+                     continue;
+                  const size_t nc = static_cast<size_t>( ( uint64_c( nz ) * cells[1] + uint64_c( ny ) ) * cells[0] + uint64_c( nx ) );
+                  for (size_t s = cellOffsets[c]; s < cellOffsets[c + 1]; ++s)
+                     for (size_t t = cellOffsets[nc]; t < cellOffsets[nc + 1]; ++t)
+                        addPair( cellBodies[s], cellBodies[t] );
+               }
+            }
+   }
+
+   for (size_t i = 0; i < bodies_.size(); ++i)
+   {
+      for (size_t g = 0; g < globalBodies_.size(); ++g)
+      {
+         if (bodies_[i]->hasInfiniteMass() && globalBodies_[g]->hasInfiniteMass())
+            continue;
+         if (aabbs_[i].intersectsClosedInterval( globalAabbs_[g] ))
+            pairs.push_back( std::make_pair( i, globalBodies_[g] ) );
+      }
+   }
+
+   // counting sort of the pairs into the rows
+   offsets_.assign( bodies_.size() + 1, 0 );
+   for (auto it = pairs.begin(); it != pairs.end(); ++it)
+      ++offsets_[it->first + 1];
+   for (size_t i = 0; i < bodies_.size(); ++i)
+      offsets_[i + 1] += offsets_[i];
+
+   neighbors_.resize( pairs.size() );
+   std::vector<size_t> next( offsets_.begin(), offsets_.end() - 1 );
+   for (auto it = pairs.begin(); it != pairs.end(); ++it)
+      neighbors_[ next[it->first]++ ] = it->second;
+
+   WALBERLA_LOG_DETAIL( "Rebuilt Verlet list: " << bodies_.size() << " bodies, " << neighbors_.size() << " pairs" );
+}
+//*************************************************************************************************
+
+}  // namespace ccd
+}  // namespace pe
+}  // namespace walberla
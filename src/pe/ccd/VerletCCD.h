@@ -0,0 +1,104 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file VerletCCD.h
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "ICCD.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace walberla{
+namespace pe{
+namespace ccd {
+
+//*************************************************************************************************
+/*!\brief Coarse collision detection based on Verlet neighbor lists.
+ *
+ * Instead of searching all possible contacts in every time step, the neighbor list stores all
+ * pairs of bodies whose axis-aligned bounding boxes, enlarged by half the skin distance, overlap.
+ * As long as every body stays within its enlarged bounding box the list contains all possible
+ * contacts and is reused, i.e., the list is only rebuilt once a body moved (or rotated) farther
+ * than half the skin since the last rebuild, if bodies were added or removed, or if the global
+ * bodies changed.
+ *
+ * The neighbor pairs are stored in compressed sparse row format: the neighbors of the i-th
+ * tracked body are neighbors_[offsets_[i]] to neighbors_[offsets_[i+1]-1]. They are determined
+ * by binning the enlarged bounding boxes into a uniform grid of cells (see rebuild()).
+ *
+ * A larger skin results in fewer rebuilds but more pairs that have to be checked by the fine
+ * collision detection. A reasonable choice is a fraction of the particle diameter.
+ */
+class VerletCCD : public ICCD{
+public:
+   explicit VerletCCD(BodyStorage& globalStorage, Storage& storage, const real_t skin = real_t(0.1));
+   ~VerletCCD();
+
+   virtual PossibleContacts& generatePossibleContacts( WcTimingTree* tt = NULL );
+
+   virtual void reloadBodies();
+   int getObservedBodyCount() const;
+
+   //**Get functions****************************************************************************
+   /*!\name Get functions */
+   //@{
+   inline real_t getSkin()          const { return skin_; }
+   inline size_t getRebuildCount()  const { return rebuilds_; }
+   inline size_t getUpdateCount()   const { return updates_; }
+   inline size_t getNeighborCount() const { return neighbors_.size(); }
+   /// fraction of calls to generatePossibleContacts() that rebuilt the neighbor list
+   inline real_t getRebuildFrequency() const { return updates_ == 0 ? real_t(0) : real_c(rebuilds_) / real_c(updates_); }
+   //@}
+   //*******************************************************************************************
+
+private:
+   //**Add/remove functions*********************************************************************
+   /*!\name Add/remove functions */
+   //@{
+   void add   ( BodyID body );
+   void remove( BodyID body );
+   //@}
+   //*******************************************************************************************
+
+   bool isRebuildRequired() const;
+   void rebuild();
+
+   BodyStorage& globalStorage_;
+   Storage& storage_;
+
+   real_t skin_;                                //!< Distance by which the bounding boxes are enlarged.
+
+   std::vector<BodyID> bodies_;                 //!< Local bodies and shadow copies.
+   std::unordered_map<BodyID, size_t> indices_; //!< Positions of the bodies in bodies_.
+   std::vector<AABB>   aabbs_;                  //!< Enlarged bounding boxes of bodies_ at the last rebuild.
+   std::vector<BodyID> globalBodies_;           //!< Global bodies at the last rebuild.
+   std::vector<AABB>   globalAabbs_;            //!< Enlarged bounding boxes of globalBodies_ at the last rebuild.
+
+   std::vector<size_t> offsets_;                //!< Row offsets of the neighbor list (size bodies_.size() + 1).
+   std::vector<BodyID> neighbors_;              //!< Neighbors of all tracked bodies.
+
+   bool   rebuildRequired_;                     //!< Set if bodies were added or removed.
+   size_t rebuilds_;                            //!< Number of neighbor list rebuilds.
+   size_t updates_;                             //!< Number of calls to generatePossibleContacts().
+};
+//*************************************************************************************************
+
+}  // namespace ccd
+}  // namespace pe
+}  // namespace walberla
@@ -0,0 +1,54 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file VerletCCDDataHandling.h
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "VerletCCD.h"
+
+#include "pe/rigidbody/BodyStorage.h"
+
+#include "blockforest/BlockDataHandling.h"
+
+namespace walberla{
+namespace pe{
+namespace ccd {
+
+class VerletCCDDataHandling : public blockforest::AlwaysInitializeBlockDataHandling<VerletCCD>{
+public:
+   VerletCCDDataHandling(const shared_ptr<BodyStorage>& globalStorage, const BlockDataID& storageID, const real_t skin) : globalStorage_(globalStorage), storageID_(storageID), skin_(skin) {}
+   VerletCCD * initialize( IBlock * const block )
+   {
+      Storage* storage = block->getData< Storage >( storageID_ );
+      return new VerletCCD(*globalStorage_, *storage, skin_);
+   }
+private:
+   shared_ptr<BodyStorage> globalStorage_;
+   BlockDataID storageID_;
+   real_t skin_;
+};
+
+inline
+shared_ptr<VerletCCDDataHandling> createVerletCCDDataHandling(const shared_ptr<BodyStorage>& globalStorage, const BlockDataID& storageID, const real_t skin = real_t(0.1))
+{
+   return make_shared<VerletCCDDataHandling>( globalStorage, storageID, skin );
+}
+
+}
+}
+}
@@ -0,0 +1,210 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file RigidBodyDeltaUpdateNotification.h
+//! \brief Header file for the RigidBodyDeltaUpdateNotification class
+//
+//======================================================================================================================
+
+#pragma once
+
+//*************************************************************************************************
+// Includes
+//*************************************************************************************************
+
+#include <pe/rigidbody/RigidBody.h>
+#include "NotificationType.h"
+#include "Marshalling.h"
+
+#include <cmath>
+
+
+namespace walberla {
+namespace pe {
+namespace communication {
+
+//=================================================================================================
+//
+//  CLASS DEFINITION
+//
+//=================================================================================================
+
+//*************************************************************************************************
+/*!\brief Wrapper class for delta-encoded rigid body updates.
+ *
+ * In contrast to the RigidBodyUpdateNotification only those quantities are transmitted which
+ * changed since the last delta-encoded update of the body. Which quantities are contained is
+ * stored in a bit mask. The shadow copies keep the values of all other quantities. If all
+ * quantities changed, a RigidBodyUpdateNotification is sent instead, which is one byte smaller.
+ */
+class RigidBodyDeltaUpdateNotification {
+public:
+   //! Bits of the mask denoting the transmitted quantities.
+   enum Field {
+      POSITION    = 1 << 0,
+      ORIENTATION = 1 << 1,
+      LINEARVEL   = 1 << 2,
+      ANGULARVEL  = 1 << 3,
+      ALL         = POSITION | ORIENTATION | LINEARVEL | ANGULARVEL
+   };
+
+   struct Parameters {
+      id_t sid_;
+      uint8_t fields_;
+      Vec3 gpos_, v_, w_;
+      Quat q_;
+   };
+
+   inline RigidBodyDeltaUpdateNotification( const RigidBody& b, const uint8_t fields ) : body_(b), fields_(fields) {}
+   const RigidBody& body_;
+   const uint8_t fields_;
+
+   static inline uint8_t changedFields( const RigidBody& b, const real_t tolerance = real_t(0) );
+   static inline void    updateSyncState( RigidBody& b, const uint8_t fields );
+
+private:
+   template< typename V >
+   static inline bool isClose( const V& lhs, const V& rhs, const uint_t size, const real_t tolerance );
+};
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Determines the quantities of a body which changed since its last delta-encoded update.
+ *
+ * \param b The locally owned body.
+ * \param tolerance Changes of at most \a tolerance in every component are ignored.
+ * \return The bit mask of the changed quantities.
+ *
+ * If the body has not been sent with a delta-encoded update before, all quantities are marked as
+ * changed. With the default tolerance of zero, quantities are compared bitwise, i.e., no
+ * information is lost. Bodies which are asleep and were already asleep at the last update are
+ * not compared at all: sleeping bodies are not moved by the time integration, and any
+ * modification wakes them up (see RigidBody::wake()).
+ */
+inline uint8_t RigidBodyDeltaUpdateNotification::changedFields( const RigidBody& b, const real_t tolerance )
+{
+   if( !b.MPITrait.hasSyncState() )
+      return ALL;
+
+   const MPIRigidBodyTrait::SyncState& state = b.MPITrait.getSyncState();
+   if( !b.isAwake() && !state.awake_ )
+      return 0;
+
+   uint8_t fields = 0;
+   if( !isClose( b.getPosition()  , state.gpos_, 3, tolerance ) ) fields |= POSITION;
+   if( !isClose( b.getQuaternion(), state.q_   , 4, tolerance ) ) fields |= ORIENTATION;
+   if( !isClose( b.getLinearVel() , state.v_   , 3, tolerance ) ) fields |= LINEARVEL;
+   if( !isClose( b.getAngularVel(), state.w_   , 3, tolerance ) ) fields |= ANGULARVEL;
+   return fields;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Stores the quantities \a fields of a body as sent to its shadow copies.
+ *
+ * \param b The locally owned body.
+ * \param fields The bit mask of the sent quantities.
+ *
+ * Quantities that were not sent keep their previous value, so changes below the tolerance of
+ * changedFields() cannot accumulate unnoticed.
+ */
+inline void RigidBodyDeltaUpdateNotification::updateSyncState( RigidBody& b, const uint8_t fields )
+{
+   if( !b.MPITrait.hasSyncState() )
+   {
+      b.MPITrait.setSyncState( b.getPosition(), b.getQuaternion(), b.getLinearVel(), b.getAngularVel(), b.isAwake() );
+      return;
+   }
+
+   MPIRigidBodyTrait::SyncState& state = b.MPITrait.getSyncState();
+   if( fields & POSITION    ) state.gpos_ = b.getPosition();
+   if( fields & ORIENTATION ) state.q_    = b.getQuaternion();
+   if( fields & LINEARVEL   ) state.v_    = b.getLinearVel();
+   if( fields & ANGULARVEL  ) state.w_    = b.getAngularVel();
+   state.awake_ = b.isAwake();
+}
+//*************************************************************************************************
+
+template< typename V >
+inline bool RigidBodyDeltaUpdateNotification::isClose( const V& lhs, const V& rhs, const uint_t size, const real_t tolerance )
+{
+   for( uint_t i = 0; i < size; ++i )
+   {
+      if( tolerance > real_t(0) ? std::fabs( lhs[i] - rhs[i] ) > tolerance : !walberla::isIdentical( lhs[i], rhs[i] ) )
+         return false;
+   }
+   return true;
+}
+
+
+//*************************************************************************************************
+/*!\brief Marshalling delta-encoded rigid body updates.
+ *
+ * \param buffer The buffer to be filled.
+ * \param obj The object to be marshalled.
+ * \return void
+ *
+ * The update consists of the system id, the bit mask and the changed quantities.
+ */
+template< typename Buffer >
+inline void marshal( Buffer& buffer, const RigidBodyDeltaUpdateNotification& obj ) {
+
+   buffer << obj.body_.getSystemID();
+   buffer << obj.fields_;
+   if( obj.fields_ & RigidBodyDeltaUpdateNotification::POSITION    ) buffer << obj.body_.getPosition();
+   if( obj.fields_ & RigidBodyDeltaUpdateNotification::ORIENTATION ) buffer << obj.body_.getQuaternion();
+   if( obj.fields_ & RigidBodyDeltaUpdateNotification::LINEARVEL   ) buffer << obj.body_.getLinearVel();
+   if( obj.fields_ & RigidBodyDeltaUpdateNotification::ANGULARVEL  ) buffer << obj.body_.getAngularVel();
+
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Unmarshalling delta-encoded rigid body updates.
+ *
+ * \param buffer The buffer from where to read.
+ * \param objparam The object to be reconstructed.
+ * \return void
+ *
+ * Only the quantities marked in the bit mask are read.
+ */
+template< typename Buffer >
+inline void unmarshal( Buffer& buffer, typename RigidBodyDeltaUpdateNotification::Parameters& objparam ) {
+   buffer >> objparam.sid_;
+   buffer >> objparam.fields_;
+   if( objparam.fields_ & RigidBodyDeltaUpdateNotification::POSITION    ) buffer >> objparam.gpos_;
+   if( objparam.fields_ & RigidBodyDeltaUpdateNotification::ORIENTATION ) buffer >> objparam.q_;
+   if( objparam.fields_ & RigidBodyDeltaUpdateNotification::LINEARVEL   ) buffer >> objparam.v_;
+   if( objparam.fields_ & RigidBodyDeltaUpdateNotification::ANGULARVEL  ) buffer >> objparam.w_;
+
+}
+//*************************************************************************************************
+
+//*************************************************************************************************
+/*!\brief Returns the notification type of a delta-encoded rigid body update.
+ * \return The notification type of a delta-encoded rigid body update.
+ */
+template<>
+inline NotificationType notificationType< RigidBodyDeltaUpdateNotification >() {
+   return rigidBodyDeltaUpdateNotification;
+}
+//*************************************************************************************************
+
+}  // namespace communication
+}  // namespace pe
+}  // namespace walberla
@@ -0,0 +1,86 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file ContactColoring.h
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "pe/Types.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace walberla {
+namespace pe {
+namespace cr {
+
+//*************************************************************************************************
+/*!\brief Partitions contacts into colors such that no two contacts of the same color share a body.
+*
+* \param bodies The two bodies of every contact. A NULL body does not conflict with any other body.
+* \param order Output: the contact indices sorted by color.
+* \param colorOffsets Output: the contacts of color c are order[colorOffsets[c]] to order[colorOffsets[c+1]-1].
+* \return void
+*
+* All contacts of one color can be treated concurrently by a contact solver that only modifies the
+* two bodies of a contact. The coloring is greedy: color c is filled with all not yet colored
+* contacts (in their original order) that do not conflict with a contact already assigned to
+* color c. The result only depends on the given contacts, i.e., it is identical on every run
+* regardless of the number of threads used afterwards.
+*/
+inline void colorContacts( const std::vector< std::pair<ConstBodyID, ConstBodyID> >& bodies,
+                           std::vector<size_t>& order, std::vector<size_t>& colorOffsets )
+{
+   order.clear();
+   order.reserve( bodies.size() );
+   colorOffsets.clear();
+   colorOffsets.push_back( 0 );
+
+   // last color a body was used in (+1, such that 0 means "not used yet")
+   std::unordered_map<ConstBodyID, size_t> usedInColor;
+
+   std::vector<size_t> remaining( bodies.size() );
+   for( size_t i = 0; i < bodies.size(); ++i )
+      remaining[i] = i;
+
+   std::vector<size_t> deferred;
+   for( size_t color = 1; !remaining.empty(); ++color )
+   {
+      deferred.clear();
+      for( auto it = remaining.begin(); it != remaining.end(); ++it )
+      {
+         ConstBodyID b1 = bodies[*it].first;
+         ConstBodyID b2 = bodies[*it].second;
+         if( ( b1 != NULL && usedInColor[b1] == color ) || ( b2 != NULL && usedInColor[b2] == color ) )
+         {
+            deferred.push_back( *it );
+            continue;
+         }
+         if( b1 != NULL ) usedInColor[b1] = color;
+         if( b2 != NULL ) usedInColor[b2] = color;
+         order.push_back( *it );
+      }
+      colorOffsets.push_back( order.size() );
+      std::swap( remaining, deferred );
+   }
+}
+//*************************************************************************************************
+
+}  // namespace cr
+}  // namespace pe
+}  // namespace walberla
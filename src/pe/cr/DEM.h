@@ -64,6 +64,14 @@ public:
    virtual inline real_t            getMaximumPenetration()        const WALBERLA_OVERRIDE { return maxPenetration_; }
    virtual inline size_t            getNumberOfContacts()          const WALBERLA_OVERRIDE { return numberOfContacts_; }
    virtual inline size_t            getNumberOfContactsTreated()   const WALBERLA_OVERRIDE { return numberOfContactsTreated_; }
+
+   /// Activates/Deactivates the multithreaded (OpenMP) execution of the contact resolution and time integration.
+   /// Contacts between two bodies with finite mass are resolved concurrently in batches of contacts that do not share
+   /// a body, the remaining contacts are resolved serially. The ContactResolver and the Integrator must only modify
+   /// the (top super) bodies they are given. The results do not depend on the number of threads, but the forces
+   /// are summed up in a different order than in the serial execution.
+   inline void                      setParallelExecution( bool active ) { parallelExecution_ = active; }
+   inline bool                      isParallelExecutionActive()    const { return parallelExecution_; }
 private:
    Integrator                        integrate_;
    ContactResolver                   resolveContact_;
@@ -77,6 +85,7 @@ private:
    real_t                            maxPenetration_;
    size_t                            numberOfContacts_;
    size_t                            numberOfContactsTreated_;
+   bool                              parallelExecution_;
 };
 
 class DEM : public DEMSolver<IntegrateImplicitEuler, ResolveContactSpringDashpotHaffWerner>
@@ -33,9 +33,11 @@
 #include "pe/rigidbody/RigidBody.h"
 #include "pe/contact/Contact.h"
 #include "pe/contact/ContactFunctions.h"
+#include "pe/cr/ContactColoring.h"
 #include "pe/synchronization/SyncForces.h"
 
 #include "core/logging/all.h"
+#include "core/OpenMP.h"
 
 namespace walberla {
 namespace pe {
@@ -60,6 +62,7 @@ DEMSolver<Integrator,ContactResolver>::DEMSolver(
    , maxPenetration_(0)
    , numberOfContacts_(0)
    , numberOfContactsTreated_(0)
+   , parallelExecution_(false)
 {
 
 }
@@ -81,14 +84,55 @@ void DEMSolver<Integrator,ContactResolver>::timestep( real_t dt )
       Contacts& cont = fcd->generateContacts( ccd->getPossibleContacts() );
       if (tt_ != NULL) tt_->stop("FCD");
 
-      for (auto cIt = cont.begin(); cIt != cont.end(); ++cIt){
-         const real_t overlap( -cIt->getDistance() );
-         if( overlap > maxPenetration_ )
-            maxPenetration_ = overlap;
-         if (shouldContactBeTreated( &(*cIt), currentBlock.getAABB() ))
+      if( parallelExecution_ )
+      {
+         // contacts involving a body with infinite mass (e.g. a wall) are resolved right away,
+         // all other contacts are colored and resolved concurrently afterwards
+         std::vector< ContactID > contacts;
+         std::vector< std::pair<ConstBodyID, ConstBodyID> > bodies;
+         for (auto cIt = cont.begin(); cIt != cont.end(); ++cIt){
+            const real_t overlap( -cIt->getDistance() );
+            if( overlap > maxPenetration_ )
+               maxPenetration_ = overlap;
+            if (shouldContactBeTreated( &(*cIt), currentBlock.getAABB() ))
+            {
+               ++numberOfContactsTreated_;
+               ConstBodyID b1( cIt->getBody1()->getTopSuperBody() );
+               ConstBodyID b2( cIt->getBody2()->getTopSuperBody() );
+               if( b1->hasInfiniteMass() || b2->hasInfiniteMass() )
+               {
+                  resolveContact_( &(*cIt), dt);
+               } else
+               {
+                  contacts.push_back( &(*cIt) );
+                  bodies.push_back( std::make_pair( b1, b2 ) );
+               }
+            }
+         }
+
+         std::vector<size_t> order;
+         std::vector<size_t> colorOffsets;
+         colorContacts( bodies, order, colorOffsets );
+         for( size_t color = 0; color + 1 < colorOffsets.size(); ++color )
          {
-            ++numberOfContactsTreated_;
-            resolveContact_( &(*cIt), dt);
+            const int begin( int_c( colorOffsets[color] ) );
+            const int end  ( int_c( colorOffsets[color + 1] ) );
+
+            #pragma omp parallel for schedule(static)
+            for( int c = begin; c < end; ++c )
+               resolveContact_( contacts[order[uint_c( c )]], dt);
+         }
+      } else
+      {
+         for (auto cIt = cont.begin(); cIt != cont.end(); ++cIt){
+            const real_t overlap( -cIt->getDistance() );
+            if( overlap > maxPenetration_ )
+               maxPenetration_ = overlap;
+            if (shouldContactBeTreated( &(*cIt), currentBlock.getAABB() ))
+            {
+               ++numberOfContactsTreated_;
+               resolveContact_( &(*cIt), dt);
+            }
          }
       }
 
@@ -116,28 +160,33 @@ void DEMSolver<Integrator,ContactResolver>::timestep( real_t dt )
 
       if (tt_ != NULL) tt_->start("Integration");
 
-      for( auto bodyIt = localStorage.begin(); bodyIt != localStorage.end(); ++bodyIt )
+      // every body only modifies itself, thus the bodies can be integrated concurrently
+      const int numLocalBodies( int_c( localStorage.size() ) );
+      #pragma omp parallel for schedule(static) if( parallelExecution_ )
+      for( int i = 0; i < numLocalBodies; ++i )
       {
-         WALBERLA_LOG_DETAIL( "Time integration of body with system id " << bodyIt->getSystemID());// << "\n" << *bodyIt );
+         BodyID body = localStorage.at( uint_c( i ) );
+
+         WALBERLA_LOG_DETAIL( "Time integration of body with system id " << body->getSystemID());// << "\n" << *body );
 
          // Checking the state of the body
-         WALBERLA_ASSERT( bodyIt->checkInvariants(), "Invalid body state detected" );
-         WALBERLA_ASSERT( !bodyIt->hasSuperBody(), "Invalid superordinate body detected" );
+         WALBERLA_ASSERT( body->checkInvariants(), "Invalid body state detected" );
+         WALBERLA_ASSERT( !body->hasSuperBody(), "Invalid superordinate body detected" );
          
          // Moving the body according to the acting forces (don't move a sleeping body)
-         if( bodyIt->isAwake() && !bodyIt->hasInfiniteMass() )
+         if( body->isAwake() && !body->hasInfiniteMass() )
          {
-            integrate_( bodyIt.getBodyID(), dt, *this );
+            integrate_( body, dt, *this );
          }
          
          // Resetting the acting forces
-         bodyIt->resetForceAndTorque();
+         body->resetForceAndTorque();
          
          // Checking the state of the rigid body
-         WALBERLA_ASSERT( bodyIt->checkInvariants(), "Invalid body state detected" );
+         WALBERLA_ASSERT( body->checkInvariants(), "Invalid body state detected" );
 
          // Resetting the acting forces
-         bodyIt->resetForceAndTorque();
+         body->resetForceAndTorque();
       }
 
       if (tt_ != NULL) tt_->stop("Integration");
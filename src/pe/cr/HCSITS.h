@@ -94,6 +94,8 @@ private:
       std::vector<Mat2>   diag_to_inv_;
       std::vector<real_t> diag_n_inv_;
       std::vector<Vec3>   p_;
+      std::vector<size_t> order_;         //!< Contact indices in the order of relaxation (sorted by color).
+      std::vector<size_t> colorOffsets_;  //!< Contacts of color c are order_[colorOffsets_[c]] to order_[colorOffsets_[c+1]-1].
    };
    std::map<IBlockID::IDType, ContactCache> blockToContactCache_;
 
@@ -151,6 +153,7 @@ public:
    inline void            setErrorReductionParameter( real_t erp );
    inline void            setAbortThreshold( real_t threshold );
    inline void            setSpeedLimiter( bool active, const real_t speedLimitFactor = real_t(0.0) );
+   inline void            setParallelExecution( bool active );
    //@}
    //**********************************************************************************************
 
@@ -160,6 +163,7 @@ public:
    inline bool            isSyncRequired()        const;
    inline bool            isSyncRequiredLocally() const;
    inline bool            isSpeedLimiterActive() const;
+   inline bool            isParallelExecutionActive() const;
    //@}
    //**********************************************************************************************
 
@@ -191,6 +195,7 @@ private:
    real_t relaxInelasticGeneralizedMaximumDissipationContacts( real_t dtinv,
                                                                HardContactSemiImplicitTimesteppingSolvers::ContactCache& contactCache,
                                                                HardContactSemiImplicitTimesteppingSolvers::BodyCache& bodyCache );
+   void applyImpulse( const ContactCache& contactCache, BodyCache& bodyCache, size_t i, const Vec3& p ) const;
    //@}
    //**********************************************************************************************
 
@@ -243,6 +248,8 @@ private:
    bool   speedLimiterActive_;        //!< is the speed limiter active?
    real_t speedLimitFactor_;          //!< what multiple of boundingbox edge length is the body allowed to travel in one timestep
 
+   bool   parallelExecution_;         //!< are contacts relaxed in colored batches and bodies integrated by multiple threads?
+
    //**********************************************************************************************
    /*! \cond WALBERLA_INTERNAL */
    /*!\brief Functor for comparing the system ID of two bodies.
@@ -420,6 +427,27 @@ inline void HardContactSemiImplicitTimesteppingSolvers::setSpeedLimiter( bool ac
 //*************************************************************************************************
 
 
+//*************************************************************************************************
+/*!\brief Activates/Deactivates the multithreaded (OpenMP) execution of the solver
+*
+* \param active activate/deactivate parallel execution
+* \return void
+*
+* If active, the contacts of each block are partitioned into colors such that no two contacts of
+* one color share a body with finite mass. The colors are relaxed one after another (Gauss-Seidel
+* between colors), the contacts within a color are relaxed concurrently. The coloring only depends
+* on the contacts, thus the results do not depend on the number of threads. However, they differ
+* from the results of the serial execution since the contacts are relaxed in a different order.
+* The time integration of the bodies is also distributed among the threads. Without OpenMP the
+* solver runs serially but still relaxes the contacts in the colored order.
+*/
+inline void HardContactSemiImplicitTimesteppingSolvers::setParallelExecution( bool active )
+{
+   parallelExecution_ = active;
+}
+//*************************************************************************************************
+
+
 
 
 //=================================================================================================
@@ -497,6 +525,18 @@ inline bool HardContactSemiImplicitTimesteppingSolvers::isSpeedLimiterActive() c
 //*************************************************************************************************
 
 
+//*************************************************************************************************
+/*!\brief Returns if the multithreaded execution of the solver is active.
+ *
+ * \return status of the parallel execution
+ */
+inline bool HardContactSemiImplicitTimesteppingSolvers::isParallelExecutionActive() const
+{
+   return parallelExecution_;
+}
+//*************************************************************************************************
+
+
 } // namespace cr
 } // namespace pe
 
@@ -30,13 +30,14 @@
 #include "pe/ccd/ICCD.h"
 #include "pe/fcd/IFCD.h"
 #include "pe/contact/ContactFunctions.h"
+#include "pe/cr/ContactColoring.h"
 
 #include "core/math/Constants.h"
 #include "core/math/Limits.h"
 #include "core/math/Shims.h"
 #include "core/math/Utility.h"
 
-#include "core/ConcatIterator.h"
+#include "core/OpenMP.h"
 
 
 namespace walberla {
@@ -103,6 +104,7 @@ inline HardContactSemiImplicitTimesteppingSolvers::HardContactSemiImplicitTimest
    , numContactsTreated_( 0)
    , speedLimiterActive_( false )
    , speedLimitFactor_ ( real_c(1.0) )
+   , parallelExecution_( false )
    , requireSync_      ( false )
 {
    // Logging the successful setup of the collision system
@@ -276,6 +278,26 @@ inline void HardContactSemiImplicitTimesteppingSolvers::timestep( const real_t d
          }
       }
 
+      // Determine the order in which the contacts are relaxed
+      if( parallelExecution_ )
+      {
+         // bodies with infinite mass are not modified during the relaxation and thus do not conflict
+         std::vector< std::pair<ConstBodyID, ConstBodyID> > bodies( numContactsMasked );
+         for( size_t i = 0; i < numContactsMasked; ++i )
+         {
+            bodies[i].first  = contactCache.body1_[i]->hasInfiniteMass() ? NULL : contactCache.body1_[i];
+            bodies[i].second = contactCache.body2_[i]->hasInfiniteMass() ? NULL : contactCache.body2_[i];
+         }
+         colorContacts( bodies, contactCache.order_, contactCache.colorOffsets_ );
+      } else
+      {
+         contactCache.order_.resize( numContactsMasked );
+         for( size_t i = 0; i < numContactsMasked; ++i )
+            contactCache.order_[i] = i;
+         contactCache.colorOffsets_.assign( 1, 0 );
+         contactCache.colorOffsets_.push_back( numContactsMasked );
+      }
+
       if (tt_ != NULL) tt_->stop("Collision Response Contact Caching");
       if (tt_ != NULL) tt_->start("Collision Response Body Caching");
 
@@ -476,12 +498,14 @@ inline void HardContactSemiImplicitTimesteppingSolvers::timestep( const real_t d
       BodyStorage& localStorage = (*storage)[0];
       BodyStorage& shadowStorage = (*storage)[1];
 
-      for( auto body = ConcatIterator<BodyStorage::iterator>
-           (localStorage.begin(),
-            localStorage.end(),
-            shadowStorage.begin(),
-            shadowStorage.end()); body != ConcatIterator<BodyStorage::iterator>(); ++body )
+      // every body only modifies itself, thus the bodies can be integrated concurrently
+      const int numLocalBodies ( int_c( localStorage.size() ) );
+      const int numShadowBodies( int_c( shadowStorage.size() ) );
+      #pragma omp parallel for schedule(static) if( parallelExecution_ )
+      for( int k = 0; k < numLocalBodies + numShadowBodies; ++k )
       {
+         BodyID body = ( k < numLocalBodies ) ? localStorage.at( uint_c( k ) ) : shadowStorage.at( uint_c( k - numLocalBodies ) );
+
          if (!body->isCommunicating())
          {
             WALBERLA_CHECK(body->hasInfiniteMass(), "It is assumed that local non communicating bodies have infinite mass!");
@@ -492,10 +516,10 @@ inline void HardContactSemiImplicitTimesteppingSolvers::timestep( const real_t d
          WALBERLA_LOG_DETAIL( "Integrating position of body with infinite mass " << *body << " with velocity " << bodyCache.v_[j] << "" );
          if( body->hasInfiniteMass() )
          {
-            integratePositions( &(*body), bodyCache.v_[j], bodyCache.w_[j], dt );
+            integratePositions( body, bodyCache.v_[j], bodyCache.w_[j], dt );
          } else
          {
-            integratePositions( &(*body), bodyCache.v_[j] + bodyCache.dv_[j], bodyCache.w_[j] + bodyCache.dw_[j], dt );
+            integratePositions( body, bodyCache.v_[j] + bodyCache.dv_[j], bodyCache.w_[j] + bodyCache.dw_[j], dt );
          }
          WALBERLA_LOG_DETAIL( "Result:\n" << *body << "" );
       }
@@ -526,53 +550,55 @@ inline real_t HardContactSemiImplicitTimesteppingSolvers::relaxInelasticFriction
                                                                                               HardContactSemiImplicitTimesteppingSolvers::BodyCache& bodyCache )
 {
    real_t delta_max( 0 );
-   size_t numContactsMasked( contactCache.p_.size() );
 
    // Relax contacts
-   for( size_t i = 0; i < numContactsMasked; ++i )
+   for( size_t color = 0; color + 1 < contactCache.colorOffsets_.size(); ++color )
    {
-      // Remove velocity corrections of this contact's reaction.
-      bodyCache.dv_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-      bodyCache.dv_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
+      const int begin( int_c( contactCache.colorOffsets_[color] ) );
+      const int end  ( int_c( contactCache.colorOffsets_[color + 1] ) );
 
-      // Calculate the relative contact VELOCITY in the global world frame (if no contact reaction is present at contact i)
-      Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
-            ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
-            ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
-            ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+      // contacts of one color do not share a body with finite mass
+      #pragma omp parallel for schedule(static) reduction(max:delta_max) if( parallelExecution_ )
+      for( int c = begin; c < end; ++c ) {
+         const size_t i( contactCache.order_[uint_c( c )] );
 
-      // Change from the global world frame to the contact frame
-      Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
-      Vec3 gdot_nto( contactframe.getTranspose() * gdot );
+         // Remove velocity corrections of this contact's reaction.
+         applyImpulse( contactCache, bodyCache, i, -contactCache.p_[i] );
 
-      // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
-      gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+         // Calculate the relative contact VELOCITY in the global world frame (if no contact reaction is present at contact i)
+         Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
+               ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
+               ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
+               ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
 
-      if( gdot_nto[0] >= 0 ) {
-         // Contact is separating if no contact reaction is present at contact i.
+         // Change from the global world frame to the contact frame
+         Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
+         Vec3 gdot_nto( contactframe.getTranspose() * gdot );
 
-         delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
-         contactCache.p_[i] = Vec3();
+         // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
+         gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
 
-         // No need to apply zero impulse.
-      }
-      else {
-         // Contact is persisting.
+         if( gdot_nto[0] >= 0 ) {
+            // Contact is separating if no contact reaction is present at contact i.
 
-         // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
-         Vec3 p_wf( contactCache.n_[i] * ( -contactCache.diag_n_inv_[i] * gdot_nto[0] ) );
-         Vec3 dp( contactCache.p_[i] - p_wf );
-         delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+            delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
+            contactCache.p_[i] = Vec3();
 
-         contactCache.p_[i] = p_wf;
+            // No need to apply zero impulse.
+         }
+         else {
+            // Contact is persisting.
 
-         // Apply impulse right away.
-         bodyCache.dv_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-         bodyCache.dv_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
+            // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
+            Vec3 p_wf( contactCache.n_[i] * ( -contactCache.diag_n_inv_[i] * gdot_nto[0] ) );
+            Vec3 dp( contactCache.p_[i] - p_wf );
+            delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+
+            contactCache.p_[i] = p_wf;
+
+            // Apply impulse right away.
+            applyImpulse( contactCache, bodyCache, i, contactCache.p_[i] );
+         }
       }
    }
 
@@ -598,158 +624,161 @@ inline real_t HardContactSemiImplicitTimesteppingSolvers::relaxApproximateInelas
                                                                                                                 HardContactSemiImplicitTimesteppingSolvers::BodyCache& bodyCache )
 {
    real_t delta_max( 0 );
-   size_t numContactsMasked( contactCache.p_.size() );
 
    // Relax contacts
-   for( size_t i = 0; i < numContactsMasked; ++i ) {
-      // Remove velocity corrections of this contact's reaction.
-      bodyCache.dv_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-      bodyCache.dv_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-
-      // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
-      Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+   for( size_t color = 0; color + 1 < contactCache.colorOffsets_.size(); ++color )
+   {
+      const int begin( int_c( contactCache.colorOffsets_[color] ) );
+      const int end  ( int_c( contactCache.colorOffsets_[color + 1] ) );
 
-      // Change from the global world frame to the contact frame
-      Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
-      Vec3 gdot_nto( contactframe.getTranspose() * gdot );
+      // contacts of one color do not share a body with finite mass
+      #pragma omp parallel for schedule(static) reduction(max:delta_max) if( parallelExecution_ )
+      for( int c = begin; c < end; ++c ) {
+         const size_t i( contactCache.order_[uint_c( c )] );
 
-      //real_t gdot_n  ( trans( contactCache.n_[i] ) * gdot );  // The component of gdot along the contact normal n
-      //Vec3 gdot_t  ( gdot - gdot_n * contactCache.n_[i] );  // The components of gdot tangential to the contact normal n
-      //real_t g_n     ( gdot_n * dt /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] );  // The gap in normal direction
+         // Remove velocity corrections of this contact's reaction.
+         applyImpulse( contactCache, bodyCache, i, -contactCache.p_[i] );
 
-      // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
-      gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+         // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
+         Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
 
-      if( gdot_nto[0] >= 0 ) {
-         // Contact is separating if no contact reaction is present at contact i.
+         // Change from the global world frame to the contact frame
+         Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
+         Vec3 gdot_nto( contactframe.getTranspose() * gdot );
 
-         delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
-         contactCache.p_[i] = Vec3();
+         //real_t gdot_n  ( trans( contactCache.n_[i] ) * gdot );  // The component of gdot along the contact normal n
+         //Vec3 gdot_t  ( gdot - gdot_n * contactCache.n_[i] );  // The components of gdot tangential to the contact normal n
+         //real_t g_n     ( gdot_n * dt /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] );  // The gap in normal direction
 
-         // No need to apply zero impulse.
-      }
-      else {
-         // Contact is persisting (either static or dynamic).
+         // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
+         gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
 
-         // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
-         Vec3 p_cf( -( contactCache.diag_nto_inv_[i] * gdot_nto ) );
+         if( gdot_nto[0] >= 0 ) {
+            // Contact is separating if no contact reaction is present at contact i.
 
-         // Can p_cf[0] be negative even though -gdot_nto[0] > 0? Yes! Try:
-         // A = [0.5 -0.1 +0.1; -0.1 0.5 -0.1; +0.1 -0.1 1];
-         // b = [0.01 -1 -1]';
-         // A\b    \approx [-0.19 -2.28 -1.21]'
-         // eig(A) \approx [ 0.40  0.56  1.04]'
+            delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
+            contactCache.p_[i] = Vec3();
 
-         real_t flimit( contactCache.mu_[i] * p_cf[0] );
-         real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
-         if( fsq > flimit * flimit || p_cf[0] < 0 ) {
-            // Contact cannot be static so it must be dynamic.
-            // => Complementarity condition on normal reaction now turns into an equation since we know that the normal reaction is definitely not zero.
-
-            // For simplicity we change to a simpler relaxation scheme here:
-            // 1. Relax normal reaction with the tangential components equal to the previous values
-            // 2. Relax tangential components with the newly relaxed normal reaction
-            // Note: The better approach would be to solve the true 3x3 block problem!
-            // Warning: Simply projecting the frictional components is wrong since then the normal action is no longer 0 and simulations break.
-
-            // Add the action of the frictional reactions from the last iteration to the relative contact velocity in normal direction so we can relax it separately.
-            // TODO This can be simplified:
-            //p_cf = trans( contactframe ) * contactCache.p_[i];
-            //p_cf[0] = 0;
-            //p_[i] = contactframe * p_cf;
-            Vec3 p_tmp = ( contactCache.t_[i] * contactCache.p_[i] ) * contactCache.t_[i] + ( contactCache.o_[i] * contactCache.p_[i] ) * contactCache.o_[i];
-
-            //      |<-- This should vanish below since p_cf[0] = 0          -->|
-            //gdot += ( contactCache.body1_[i]->getInvMass() + contactCache.body2_[i]->getInvMass() ) * p_tmp + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % p_tmp] ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % p_tmp ) ) % contactCache.r2_[i] /* + diag_[i] * p */;
-            //real_t gdot_n = trans( contactCache.n_[i] ) * gdot;
-            //gdot_n += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
-
-            real_t gdot_n = gdot_nto[0] + contactCache.n_[i] * ( ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % p_tmp ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % p_tmp ) ) % contactCache.r2_[i] /* + diag_[i] * p */ );
-            p_cf[0] = -( contactCache.diag_n_inv_[i] * gdot_n );
-
-            // We cannot be sure that gdot_n <= 0 here and thus p_cf[0] >= 0 since we just modified it with the old values of the tangential reactions! => Project
-            p_cf[0] = std::max( real_c( 0 ), p_cf[0] );
-
-            // Now add the action of the normal reaction to the relative contact velocity in the tangential directions so we can relax the frictional components separately.
-            p_tmp = contactCache.n_[i] * p_cf[0];
-            Vec3 gdot2 = gdot + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % p_tmp ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % p_tmp ) ) % contactCache.r2_[i];
-            Vec2 gdot_to;
-            gdot_to[0] = contactCache.t_[i] * gdot2;
-            gdot_to[1] = contactCache.o_[i] * gdot2;
-
-            Vec2 ret = -( contactCache.diag_to_inv_[i] * gdot_to );
-            p_cf[1] = ret[0];
-            p_cf[2] = ret[1];
-
-            flimit = contactCache.mu_[i] * p_cf[0];
-            fsq = p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2];
-            if( fsq > flimit * flimit ) {
-               const real_t f( flimit / std::sqrt( fsq ) );
-               p_cf[1] *= f;
-               p_cf[2] *= f;
-            }
+            // No need to apply zero impulse.
          }
          else {
-            // Contact is static.
-         }
-         Vec3 p_wf( contactframe * p_cf );
-         Vec3 dp( contactCache.p_[i] - p_wf );
-         delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+            // Contact is persisting (either static or dynamic).
 
-         contactCache.p_[i] = p_wf;
+            // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
+            Vec3 p_cf( -( contactCache.diag_nto_inv_[i] * gdot_nto ) );
 
-         // Apply impulse right away
-         bodyCache.dv_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-         bodyCache.dv_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-      }
+            // Can p_cf[0] be negative even though -gdot_nto[0] > 0? Yes! Try:
+            // A = [0.5 -0.1 +0.1; -0.1 0.5 -0.1; +0.1 -0.1 1];
+            // b = [0.01 -1 -1]';
+            // A\b    \approx [-0.19 -2.28 -1.21]'
+            // eig(A) \approx [ 0.40  0.56  1.04]'
+
+            real_t flimit( contactCache.mu_[i] * p_cf[0] );
+            real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
+            if( fsq > flimit * flimit || p_cf[0] < 0 ) {
+               // Contact cannot be static so it must be dynamic.
+               // => Complementarity condition on normal reaction now turns into an equation since we know that the normal reaction is definitely not zero.
+
+               // For simplicity we change to a simpler relaxation scheme here:
+               // 1. Relax normal reaction with the tangential components equal to the previous values
+               // 2. Relax tangential components with the newly relaxed normal reaction
+               // Note: The better approach would be to solve the true 3x3 block problem!
+               // Warning: Simply projecting the frictional components is wrong since then the normal action is no longer 0 and simulations break.
+
+               // Add the action of the frictional reactions from the last iteration to the relative contact velocity in normal direction so we can relax it separately.
+               // TODO This can be simplified:
+               //p_cf = trans( contactframe ) * contactCache.p_[i];
+               //p_cf[0] = 0;
+               //p_[i] = contactframe * p_cf;
+               Vec3 p_tmp = ( contactCache.t_[i] * contactCache.p_[i] ) * contactCache.t_[i] + ( contactCache.o_[i] * contactCache.p_[i] ) * contactCache.o_[i];
+
+               //      |<-- This should vanish below since p_cf[0] = 0          -->|
+               //gdot += ( contactCache.body1_[i]->getInvMass() + contactCache.body2_[i]->getInvMass() ) * p_tmp + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % p_tmp] ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % p_tmp ) ) % contactCache.r2_[i] /* + diag_[i] * p */;
+               //real_t gdot_n = trans( contactCache.n_[i] ) * gdot;
+               //gdot_n += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+
+               real_t gdot_n = gdot_nto[0] + contactCache.n_[i] * ( ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % p_tmp ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % p_tmp ) ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+               p_cf[0] = -( contactCache.diag_n_inv_[i] * gdot_n );
+
+               // We cannot be sure that gdot_n <= 0 here and thus p_cf[0] >= 0 since we just modified it with the old values of the tangential reactions! => Project
+               p_cf[0] = std::max( real_c( 0 ), p_cf[0] );
+
+               // Now add the action of the normal reaction to the relative contact velocity in the tangential directions so we can relax the frictional components separately.
+               p_tmp = contactCache.n_[i] * p_cf[0];
+               Vec3 gdot2 = gdot + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % p_tmp ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % p_tmp ) ) % contactCache.r2_[i];
+               Vec2 gdot_to;
+               gdot_to[0] = contactCache.t_[i] * gdot2;
+               gdot_to[1] = contactCache.o_[i] * gdot2;
+
+               Vec2 ret = -( contactCache.diag_to_inv_[i] * gdot_to );
+               p_cf[1] = ret[0];
+               p_cf[2] = ret[1];
+
+               flimit = contactCache.mu_[i] * p_cf[0];
+               fsq = p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2];
+               if( fsq > flimit * flimit ) {
+                  const real_t f( flimit / std::sqrt( fsq ) );
+                  p_cf[1] *= f;
+                  p_cf[2] *= f;
+               }
+            }
+            else {
+               // Contact is static.
+            }
+            Vec3 p_wf( contactframe * p_cf );
+            Vec3 dp( contactCache.p_[i] - p_wf );
+            delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+
+            contactCache.p_[i] = p_wf;
+
+            // Apply impulse right away
+            applyImpulse( contactCache, bodyCache, i, contactCache.p_[i] );
+         }
 
 #if 0
-      Vec3 gdot2   ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
-            ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
-            ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
-            ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_contactCache.[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
-      Vec3 gdot_nto2( contactframe.getTranspose() * gdot2 );
-      WALBERLA_LOG_DETAIL( "gdot_n2 = " << gdot_nto2[0] );
-      WALBERLA_LOG_DETAIL( "gdot_t2 = " << gdot_nto2[1] );
-      WALBERLA_LOG_DETAIL( "gdot_o2 = " << gdot_nto2[2] );
-      gdot_nto2[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
-      WALBERLA_LOG_DETAIL( "gdot_n2' = " << gdot_nto2[0] );
+         Vec3 gdot2   ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
+               ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
+               ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
+               ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_contactCache.[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+         Vec3 gdot_nto2( contactframe.getTranspose() * gdot2 );
+         WALBERLA_LOG_DETAIL( "gdot_n2 = " << gdot_nto2[0] );
+         WALBERLA_LOG_DETAIL( "gdot_t2 = " << gdot_nto2[1] );
+         WALBERLA_LOG_DETAIL( "gdot_o2 = " << gdot_nto2[2] );
+         gdot_nto2[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+         WALBERLA_LOG_DETAIL( "gdot_n2' = " << gdot_nto2[0] );
 #endif
 
-      /*
-       * compare DEM time-step with NSCD iteration:
-       * - projections are the same
-       * - velocities are the same if we use an explicit Euler discretization for the velocity time integration
-       *
-      f_cf[0] = -stiffness * contactCache.dist_ - damping_n * gdot_n = -[(stiffness * dt) * contactCache.dist_ * dtinv + damping_n * gdot_n] = -foo * (gdot_n + contactCache.dist_ * dtinv) where foo = stiffness * dt = damping_n;
-      f_cf[1] = -damping_t * gdot_t                     = -damping_t * gdot_t;
-      f_cf[2] = -damping_t * gdot_o                     = -damping_t * gdot_o;
+         /*
+          * compare DEM time-step with NSCD iteration:
+          * - projections are the same
+          * - velocities are the same if we use an explicit Euler discretization for the velocity time integration
+          *
+         f_cf[0] = -stiffness * contactCache.dist_ - damping_n * gdot_n = -[(stiffness * dt) * contactCache.dist_ * dtinv + damping_n * gdot_n] = -foo * (gdot_n + contactCache.dist_ * dtinv) where foo = stiffness * dt = damping_n;
+         f_cf[1] = -damping_t * gdot_t                     = -damping_t * gdot_t;
+         f_cf[2] = -damping_t * gdot_o                     = -damping_t * gdot_o;
 
-      or: f_cf = -diag(foo, damping_t, damping_t) * gdot_nto   (since gdot_nto[0] is modified)
-      vs. f_cf = -diaginv * gdot_nto in NSCD iteration
+         or: f_cf = -diag(foo, damping_t, damping_t) * gdot_nto   (since gdot_nto[0] is modified)
+         vs. f_cf = -diaginv * gdot_nto in NSCD iteration
 
-      => The NSCD iteration is more or less a DEM time step where we choose the stiffness and damping parameters such that penetration is non-existent after a time step and contacts are truly static (tangential rel. vel. is zero) unless the friction force hits its limit
+         => The NSCD iteration is more or less a DEM time step where we choose the stiffness and damping parameters such that penetration is non-existent after a time step and contacts are truly static (tangential rel. vel. is zero) unless the friction force hits its limit
 
-      f_cf[0] = std::max( 0, f_cf[0] );
+         f_cf[0] = std::max( 0, f_cf[0] );
 
-      flimit = contactCache.mu_ * f_cf[0];
-      fsq = f_cf[1] * f_cf[1] + f_cf[2] * f_cf[2]
-      if( fsq > flimit * flimit ) {
-         f = flimit / sqrt( fsq );
-         f_cf[1] *= f;
-         f_cf[2] *= f;
-      }
+         flimit = contactCache.mu_ * f_cf[0];
+         fsq = f_cf[1] * f_cf[1] + f_cf[2] * f_cf[2]
+         if( fsq > flimit * flimit ) {
+            f = flimit / sqrt( fsq );
+            f_cf[1] *= f;
+            f_cf[2] *= f;
+         }
 
-      f_wf = contactframe * f_cf;
+         f_wf = contactframe * f_cf;
 
-      b1->addForceAtPos(  f_wf, gpos );
-      b2->addForceAtPos( -f_wf, gpos );
-      */
+         b1->addForceAtPos(  f_wf, gpos );
+         b2->addForceAtPos( -f_wf, gpos );
+         */
 
+      }
    }
 
    return delta_max;
@@ -776,233 +805,236 @@ inline real_t HardContactSemiImplicitTimesteppingSolvers::relaxInelasticCoulombC
                                                                                                      HardContactSemiImplicitTimesteppingSolvers::BodyCache& bodyCache )
 {
    real_t delta_max( 0 );
-   size_t numContactsMasked( contactCache.p_.size() );
 
    // Relax contacts
-   for( size_t i = 0; i < numContactsMasked; ++i ) {
-      // Remove velocity corrections of this contact's reaction.
-      bodyCache.dv_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-      bodyCache.dv_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-
-      // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
-      Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
-
-      // Change from the global world frame to the contact frame
-      Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
-      Vec3 gdot_nto( contactframe.getTranspose() * gdot );
-
-      //real_t gdot_n  ( trans( contactCache.n_[i] ) * gdot );  // The component of gdot along the contact normal n
-      //Vec3 gdot_t  ( gdot - gdot_n * contactCache.n_[i] );  // The components of gdot tangential to the contact normal n
-      //real_t g_n     ( gdot_n * dt /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] );  // The gap in normal direction
-
-      // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
-      gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
-
-      //WALBERLA_LOG_WARNING( "Contact #" << i << " is\nA = \n" << contactCache.diag_nto_[i] << "\nb = \n" << gdot_nto << "\nmu = " << contactCache.mu_[i] );
-
-      if( gdot_nto[0] >= 0 ) {
-         // Contact is separating if no contact reaction is present at contact i.
-
-         delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
-         contactCache.p_[i] = Vec3();
-         //WALBERLA_LOG_WARNING( "Contact #" << i << " is separating." );
-
-         // No need to apply zero impulse.
-      }
-      else {
-         // Contact is persisting (either static or dynamic).
+   for( size_t color = 0; color + 1 < contactCache.colorOffsets_.size(); ++color )
+   {
+      const int begin( int_c( contactCache.colorOffsets_[color] ) );
+      const int end  ( int_c( contactCache.colorOffsets_[color + 1] ) );
 
-         // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
-         Vec3 p_cf( -( contactCache.diag_nto_inv_[i] * gdot_nto ) );
+      // contacts of one color do not share a body with finite mass
+      #pragma omp parallel for schedule(static) reduction(max:delta_max) if( parallelExecution_ )
+      for( int c = begin; c < end; ++c ) {
+         const size_t i( contactCache.order_[uint_c( c )] );
 
-         // Can p_cf[0] be negative even though -gdot_nto[0] > 0? Yes! Try:
-         // A = [0.5 -0.1 +0.1; -0.1 0.5 -0.1; +0.1 -0.1 1];
-         // b = [0.01 -1 -1]';
-         // A\b    \approx [-0.19 -2.28 -1.21]'
-         // eig(A) \approx [ 0.40  0.56  1.04]'
+         // Remove velocity corrections of this contact's reaction.
+         applyImpulse( contactCache, bodyCache, i, -contactCache.p_[i] );
 
-         real_t flimit( contactCache.mu_[i] * p_cf[0] );
-         real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
-         if( fsq > flimit * flimit || p_cf[0] < 0 ) {
-            // Contact cannot be static so it must be dynamic.
-            // => Complementarity condition on normal reaction now turns into an equation since we know that the normal reaction is definitely not zero.
+         // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
+         Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
 
-            for (int j = 0; j < 20; ++j) {
-               // For simplicity we change to a simpler relaxation scheme here:
-               // 1. Relax normal reaction with the tangential components equal to the previous values
-               // 2. Relax tangential components with the newly relaxed normal reaction
-               // Note: The better approach would be to solve the true 3x3 block problem!
-               // Warning: Simply projecting the frictional components is wrong since then the normal action is no longer 0 and simulations break.
+         // Change from the global world frame to the contact frame
+         Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
+         Vec3 gdot_nto( contactframe.getTranspose() * gdot );
 
-               Vec3 gdotCorrected;
-               real_t gdotCorrected_n;
-               Vec2 gdotCorrected_to;
+         //real_t gdot_n  ( trans( contactCache.n_[i] ) * gdot );  // The component of gdot along the contact normal n
+         //Vec3 gdot_t  ( gdot - gdot_n * contactCache.n_[i] );  // The components of gdot tangential to the contact normal n
+         //real_t g_n     ( gdot_n * dt /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] );  // The gap in normal direction
 
-               // Calculate the relative contact velocity in the global world frame (if no normal contact reaction is present at contact i)
-               p_cf[0] = 0;
-               //                       |<- p_cf is orthogonal to the normal and drops out in next line ->|
-               gdotCorrected   = /* ( contactCache.body1_[i]->getInvMass() + contactCache.body2_[i]->getInvMass() ) * p_cf  */ gdot + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % ( contactCache.t_[i] * p_cf[1] + contactCache.o_[i] * p_cf[2] ) ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % ( contactCache.t_[i] * p_cf[1] + contactCache.o_[i] * p_cf[2] ) ) ) % contactCache.r2_[i];
-               gdotCorrected_n = contactCache.n_[i] * gdotCorrected + contactCache.dist_[i] * dtinv;
+         // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
+         gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
 
-               // Relax normal component.
-               p_cf[0] = std::max( real_c( 0 ), -( contactCache.diag_n_inv_[i] * gdotCorrected_n ) );
+         //WALBERLA_LOG_WARNING( "Contact #" << i << " is\nA = \n" << contactCache.diag_nto_[i] << "\nb = \n" << gdot_nto << "\nmu = " << contactCache.mu_[i] );
 
-               // Calculate the relative contact velocity in the global world frame (if no frictional contact reaction is present at contact i)
-               p_cf[1] = p_cf[2] = real_c( 0 );
-               //                       |<- p_cf is orthogonal to the tangential plane and drops out   ->|
-               gdotCorrected   = /* ( contactCache.body1_[i]->getInvMass() + contactCache.body2_[i]->getInvMass() ) * p_cf */ gdot + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % ( contactCache.n_[i] * p_cf[0] ) ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % ( contactCache.n_[i] * p_cf[0] ) ) ) % contactCache.r2_[i];
-               gdotCorrected_to[0] = contactCache.t_[i] * gdotCorrected;
-               gdotCorrected_to[1] = contactCache.o_[i] * gdotCorrected;
+         if( gdot_nto[0] >= 0 ) {
+            // Contact is separating if no contact reaction is present at contact i.
 
-               // Relax frictional components.
-               Vec2 ret = -( contactCache.diag_to_inv_[i] * gdotCorrected_to );
-               p_cf[1] = ret[0];
-               p_cf[2] = ret[1];
+            delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
+            contactCache.p_[i] = Vec3();
+            //WALBERLA_LOG_WARNING( "Contact #" << i << " is separating." );
 
-               flimit = contactCache.mu_[i] * p_cf[0];
-               fsq = p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2];
-               if( fsq > flimit * flimit ) {
-                  // 3.2.1 Decoupling
-                  // \tilde{x}^0 = p_cf[1..2]
-
-                  // Determine \tilde{A}
-                  Mat2 diag_to( contactCache.diag_nto_[i](1, 1), contactCache.diag_nto_[i](1, 2), contactCache.diag_nto_[i](2, 1), contactCache.diag_nto_[i](2, 2) );
-
-                        const real_t f( flimit / std::sqrt( fsq ) );
-                  //p_cf[1] *= f;
-                  //p_cf[2] *= f;
-
-                  // Determine search interval for Golden Section Search
-                  const real_t phi( real_c(0.5) * ( real_c(1) + std::sqrt( real_c( 5 ) ) ) );
-                  real_t shift( std::atan2( -p_cf[2], p_cf[1] ) );
-                  real_t acos_f( std::acos( f ) );
-
-                  //WALBERLA_LOG_WARNING( acos_f << " " << shift );
-
-                  real_t alpha_left( -acos_f - shift );
-                  //Vec2 x_left( flimit * std::cos( alpha_left ), flimit * std::sin( alpha_left ) );
-                  //real_t f_left( 0.5 * trans( x_left ) * ( diag_to * x_left ) - trans( x_left ) * ( -gdot_to ) );
-
-                  real_t alpha_right( acos_f - shift );
-                  //Vec2 x_right( flimit * std::cos( alpha_right ), flimit * std::sin( alpha_right ) );
-                  //real_t f_right( 0.5 * trans( x_right ) * ( diag_to * x_right ) - trans( x_right ) * ( -gdot_to ) );
-
-                  real_t alpha_mid( ( alpha_right + alpha_left * phi ) / ( 1 + phi ) );
-                  Vec2 x_mid( flimit * std::cos( alpha_mid ), flimit * std::sin( alpha_mid ) );
-                  real_t f_mid( real_c(0.5) * x_mid * ( diag_to * x_mid ) - x_mid * ( -gdotCorrected_to ) );
-
-                  bool leftlarger = false;
-                  for( size_t k = 0; k < maxSubIterations_; ++k ) {
-                     real_t alpha_next( alpha_left + ( alpha_right - alpha_mid ) );
-                     Vec2 x_next( flimit * std::cos( alpha_next ), flimit * std::sin( alpha_next ) );
-                     real_t f_next( real_c(0.5) * x_next * ( diag_to * x_next ) - x_next * ( -gdotCorrected_to ) );
-                     //WALBERLA_LOG_WARNING( "[(" << alpha_left << ", ?); (" << alpha_mid << ", " << f_mid << "); (" << alpha_right << ", ?)] <- (" << alpha_next << ", " << f_next << ")" );
-                     //WALBERLA_LOG_WARNING( "left: " << alpha_mid - alpha_left << "  right: " << alpha_right - alpha_mid << "  ll: " << leftlarger );
-                     //WALBERLA_ASSERT(leftlarger ? (alpha_mid - alpha_left > alpha_right - alpha_mid) : (alpha_mid - alpha_left < alpha_right - alpha_mid), "ll inconsistent!" );
-
-                     if (leftlarger) {
-                        // left interval larger
-                        if( f_next < f_mid ) {
-                           alpha_right = alpha_mid;
-                           alpha_mid   = alpha_next;
-                           x_mid       = x_next;
-                           f_mid       = f_next;
-                           leftlarger = true;
-                        }
-                        else {
-                           alpha_left  = alpha_next;
-                           leftlarger = false;
-                        }
-                     }
-                     else {
-                        // right interval larger
-                        if( f_next < f_mid ) {
-                           alpha_left = alpha_mid;
-                           alpha_mid  = alpha_next;
-                           x_mid      = x_next;
-                           f_mid      = f_next;
-                           leftlarger = false;
+            // No need to apply zero impulse.
+         }
+         else {
+            // Contact is persisting (either static or dynamic).
+
+            // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
+            Vec3 p_cf( -( contactCache.diag_nto_inv_[i] * gdot_nto ) );
+
+            // Can p_cf[0] be negative even though -gdot_nto[0] > 0? Yes! Try:
+            // A = [0.5 -0.1 +0.1; -0.1 0.5 -0.1; +0.1 -0.1 1];
+            // b = [0.01 -1 -1]';
+            // A\b    \approx [-0.19 -2.28 -1.21]'
+            // eig(A) \approx [ 0.40  0.56  1.04]'
+
+            real_t flimit( contactCache.mu_[i] * p_cf[0] );
+            real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
+            if( fsq > flimit * flimit || p_cf[0] < 0 ) {
+               // Contact cannot be static so it must be dynamic.
+               // => Complementarity condition on normal reaction now turns into an equation since we know that the normal reaction is definitely not zero.
+
+               for (int j = 0; j < 20; ++j) {
+                  // For simplicity we change to a simpler relaxation scheme here:
+                  // 1. Relax normal reaction with the tangential components equal to the previous values
+                  // 2. Relax tangential components with the newly relaxed normal reaction
+                  // Note: The better approach would be to solve the true 3x3 block problem!
+                  // Warning: Simply projecting the frictional components is wrong since then the normal action is no longer 0 and simulations break.
+
+                  Vec3 gdotCorrected;
+                  real_t gdotCorrected_n;
+                  Vec2 gdotCorrected_to;
+
+                  // Calculate the relative contact velocity in the global world frame (if no normal contact reaction is present at contact i)
+                  p_cf[0] = 0;
+                  //                       |<- p_cf is orthogonal to the normal and drops out in next line ->|
+                  gdotCorrected   = /* ( contactCache.body1_[i]->getInvMass() + contactCache.body2_[i]->getInvMass() ) * p_cf  */ gdot + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % ( contactCache.t_[i] * p_cf[1] + contactCache.o_[i] * p_cf[2] ) ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % ( contactCache.t_[i] * p_cf[1] + contactCache.o_[i] * p_cf[2] ) ) ) % contactCache.r2_[i];
+                  gdotCorrected_n = contactCache.n_[i] * gdotCorrected + contactCache.dist_[i] * dtinv;
+
+                  // Relax normal component.
+                  p_cf[0] = std::max( real_c( 0 ), -( contactCache.diag_n_inv_[i] * gdotCorrected_n ) );
+
+                  // Calculate the relative contact velocity in the global world frame (if no frictional contact reaction is present at contact i)
+                  p_cf[1] = p_cf[2] = real_c( 0 );
+                  //                       |<- p_cf is orthogonal to the tangential plane and drops out   ->|
+                  gdotCorrected   = /* ( contactCache.body1_[i]->getInvMass() + contactCache.body2_[i]->getInvMass() ) * p_cf */ gdot + ( contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % ( contactCache.n_[i] * p_cf[0] ) ) ) % contactCache.r1_[i] + ( contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % ( contactCache.n_[i] * p_cf[0] ) ) ) % contactCache.r2_[i];
+                  gdotCorrected_to[0] = contactCache.t_[i] * gdotCorrected;
+                  gdotCorrected_to[1] = contactCache.o_[i] * gdotCorrected;
+
+                  // Relax frictional components.
+                  Vec2 ret = -( contactCache.diag_to_inv_[i] * gdotCorrected_to );
+                  p_cf[1] = ret[0];
+                  p_cf[2] = ret[1];
+
+                  flimit = contactCache.mu_[i] * p_cf[0];
+                  fsq = p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2];
+                  if( fsq > flimit * flimit ) {
+                     // 3.2.1 Decoupling
+                     // \tilde{x}^0 = p_cf[1..2]
+
+                     // Determine \tilde{A}
+                     Mat2 diag_to( contactCache.diag_nto_[i](1, 1), contactCache.diag_nto_[i](1, 2), contactCache.diag_nto_[i](2, 1), contactCache.diag_nto_[i](2, 2) );
+
+                           const real_t f( flimit / std::sqrt( fsq ) );
+                     //p_cf[1] *= f;
+                     //p_cf[2] *= f;
+
+                     // Determine search interval for Golden Section Search
+                     const real_t phi( real_c(0.5) * ( real_c(1) + std::sqrt( real_c( 5 ) ) ) );
+                     real_t shift( std::atan2( -p_cf[2], p_cf[1] ) );
+                     real_t acos_f( std::acos( f ) );
+
+                     //WALBERLA_LOG_WARNING( acos_f << " " << shift );
+
+                     real_t alpha_left( -acos_f - shift );
+                     //Vec2 x_left( flimit * std::cos( alpha_left ), flimit * std::sin( alpha_left ) );
+                     //real_t f_left( 0.5 * trans( x_left ) * ( diag_to * x_left ) - trans( x_left ) * ( -gdot_to ) );
+
+                     real_t alpha_right( acos_f - shift );
+                     //Vec2 x_right( flimit * std::cos( alpha_right ), flimit * std::sin( alpha_right ) );
+                     //real_t f_right( 0.5 * trans( x_right ) * ( diag_to * x_right ) - trans( x_right ) * ( -gdot_to ) );
+
+                     real_t alpha_mid( ( alpha_right + alpha_left * phi ) / ( 1 + phi ) );
+                     Vec2 x_mid( flimit * std::cos( alpha_mid ), flimit * std::sin( alpha_mid ) );
+                     real_t f_mid( real_c(0.5) * x_mid * ( diag_to * x_mid ) - x_mid * ( -gdotCorrected_to ) );
+
+                     bool leftlarger = false;
+                     for( size_t k = 0; k < maxSubIterations_; ++k ) {
+                        real_t alpha_next( alpha_left + ( alpha_right - alpha_mid ) );
+                        Vec2 x_next( flimit * std::cos( alpha_next ), flimit * std::sin( alpha_next ) );
+                        real_t f_next( real_c(0.5) * x_next * ( diag_to * x_next ) - x_next * ( -gdotCorrected_to ) );
+                        //WALBERLA_LOG_WARNING( "[(" << alpha_left << ", ?); (" << alpha_mid << ", " << f_mid << "); (" << alpha_right << ", ?)] <- (" << alpha_next << ", " << f_next << ")" );
+                        //WALBERLA_LOG_WARNING( "left: " << alpha_mid - alpha_left << "  right: " << alpha_right - alpha_mid << "  ll: " << leftlarger );
+                        //WALBERLA_ASSERT(leftlarger ? (alpha_mid - alpha_left > alpha_right - alpha_mid) : (alpha_mid - alpha_left < alpha_right - alpha_mid), "ll inconsistent!" );
+
+                        if (leftlarger) {
+                           // left interval larger
+                           if( f_next < f_mid ) {
+                              alpha_right = alpha_mid;
+                              alpha_mid   = alpha_next;
+                              x_mid       = x_next;
+                              f_mid       = f_next;
+                              leftlarger = true;
+                           }
+                           else {
+                              alpha_left  = alpha_next;
+                              leftlarger = false;
+                           }
                         }
                         else {
-                           alpha_right = alpha_next;
-                           leftlarger = true;
+                           // right interval larger
+                           if( f_next < f_mid ) {
+                              alpha_left = alpha_mid;
+                              alpha_mid  = alpha_next;
+                              x_mid      = x_next;
+                              f_mid      = f_next;
+                              leftlarger = false;
+                           }
+                           else {
+                              alpha_right = alpha_next;
+                              leftlarger = true;
+                           }
                         }
                      }
-                  }
-                  //WALBERLA_LOG_WARNING( "dalpha = " << alpha_right - alpha_left );
+                     //WALBERLA_LOG_WARNING( "dalpha = " << alpha_right - alpha_left );
 
-                  p_cf[1] = x_mid[0];
-                  p_cf[2] = x_mid[1];
+                     p_cf[1] = x_mid[0];
+                     p_cf[2] = x_mid[1];
+                  }
                }
+               //WALBERLA_LOG_WARNING( "Contact #" << i << " is dynamic." );
+            }
+            else {
+               // Contact is static.
+               //WALBERLA_LOG_WARNING( "Contact #" << i << " is static." );
             }
-            //WALBERLA_LOG_WARNING( "Contact #" << i << " is dynamic." );
-         }
-         else {
-            // Contact is static.
-            //WALBERLA_LOG_WARNING( "Contact #" << i << " is static." );
-         }
 
-         //WALBERLA_LOG_WARNING( "Contact reaction in contact frame: " << p_cf << "\n" << contactCache.diag_nto_[i]*p_cf + gdot_nto );
-         Vec3 p_wf( contactframe * p_cf );
-         Vec3 dp( contactCache.p_[i] - p_wf );
-         delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+            //WALBERLA_LOG_WARNING( "Contact reaction in contact frame: " << p_cf << "\n" << contactCache.diag_nto_[i]*p_cf + gdot_nto );
+            Vec3 p_wf( contactframe * p_cf );
+            Vec3 dp( contactCache.p_[i] - p_wf );
+            delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
 
-         contactCache.p_[i] = p_wf;
+            contactCache.p_[i] = p_wf;
 
-         // Apply impulse right away
-         bodyCache.dv_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-         bodyCache.dv_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-      }
+            // Apply impulse right away
+            applyImpulse( contactCache, bodyCache, i, contactCache.p_[i] );
+         }
 
 #if 0
-      Vec3 gdot2   ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
-            ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
-            ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
-            ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
-      Vec3 gdot_nto2( contactframe.getTranspose() * gdot2 );
-      WALBERLA_LOG_DETAIL( "gdot_n2 = " << gdot_nto2[0] );
-      WALBERLA_LOG_DETAIL( "gdot_t2 = " << gdot_nto2[1] );
-      WALBERLA_LOG_DETAIL( "gdot_o2 = " << gdot_nto2[2] );
+         Vec3 gdot2   ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
+               ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
+               ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
+               ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+         Vec3 gdot_nto2( contactframe.getTranspose() * gdot2 );
+         WALBERLA_LOG_DETAIL( "gdot_n2 = " << gdot_nto2[0] );
+         WALBERLA_LOG_DETAIL( "gdot_t2 = " << gdot_nto2[1] );
+         WALBERLA_LOG_DETAIL( "gdot_o2 = " << gdot_nto2[2] );
+      }
+      gdot_nto2[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+      WALBERLA_LOG_DETAIL( "gdot_n2' = " << gdot_nto2[0] );
    }
-   gdot_nto2[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
-   WALBERLA_LOG_DETAIL( "gdot_n2' = " << gdot_nto2[0] );
-}
 #endif
 
-/*
-       * compare DEM time-step with NSCD iteration:
-       * - projections are the same
-       * - velocities are the same if we use an explicit Euler discretization for the velocity time integration
-       *
-      f_cf[0] = -stiffness * contactCache.dist_ - damping_n * gdot_n = -[(stiffness * dt) * contactCache.dist_ * dtinv + damping_n * gdot_n] = -foo * (gdot_n + contactCache.dist_ * dtinv) where foo = stiffness * dt = damping_n;
-      f_cf[1] = -damping_t * gdot_t                     = -damping_t * gdot_t;
-      f_cf[2] = -damping_t * gdot_o                     = -damping_t * gdot_o;
-
-      or: f_cf = -diag(foo, damping_t, damping_t) * gdot_nto   (since gdot_nto[0] is modified)
-      vs. f_cf = -diaginv * gdot_nto in NSCD iteration
-
-      => The NSCD iteration is more or less a DEM time step where we choose the stiffness and damping parameters such that penetration is non-existent after a time step and contacts are truly static (tangential rel. vel. is zero) unless the friction force hits its limit
+   /*
+          * compare DEM time-step with NSCD iteration:
+          * - projections are the same
+          * - velocities are the same if we use an explicit Euler discretization for the velocity time integration
+          *
+         f_cf[0] = -stiffness * contactCache.dist_ - damping_n * gdot_n = -[(stiffness * dt) * contactCache.dist_ * dtinv + damping_n * gdot_n] = -foo * (gdot_n + contactCache.dist_ * dtinv) where foo = stiffness * dt = damping_n;
+         f_cf[1] = -damping_t * gdot_t                     = -damping_t * gdot_t;
+         f_cf[2] = -damping_t * gdot_o                     = -damping_t * gdot_o;
+
+         or: f_cf = -diag(foo, damping_t, damping_t) * gdot_nto   (since gdot_nto[0] is modified)
+         vs. f_cf = -diaginv * gdot_nto in NSCD iteration
+
+         => The NSCD iteration is more or less a DEM time step where we choose the stiffness and damping parameters such that penetration is non-existent after a time step and contacts are truly static (tangential rel. vel. is zero) unless the friction force hits its limit
+
+         f_cf[0] = std::max( 0, f_cf[0] );
+
+         flimit = contactCache.mu_ * f_cf[0];
+         fsq = f_cf[1] * f_cf[1] + f_cf[2] * f_cf[2]
+         if( fsq > flimit * flimit ) {
+            f = flimit / sqrt( fsq );
+            f_cf[1] *= f;
+            f_cf[2] *= f;
+         }
 
-      f_cf[0] = std::max( 0, f_cf[0] );
+         f_wf = contactframe * f_cf;
 
-      flimit = contactCache.mu_ * f_cf[0];
-      fsq = f_cf[1] * f_cf[1] + f_cf[2] * f_cf[2]
-      if( fsq > flimit * flimit ) {
-         f = flimit / sqrt( fsq );
-         f_cf[1] *= f;
-         f_cf[2] *= f;
+         b1->addForceAtPos(  f_wf, gpos );
+         b2->addForceAtPos( -f_wf, gpos );
+         */
       }
-
-      f_wf = contactframe * f_cf;
-
-      b1->addForceAtPos(  f_wf, gpos );
-      b2->addForceAtPos( -f_wf, gpos );
-      */
-}
+   }
 
 return delta_max;
 }
@@ -1039,76 +1071,79 @@ inline real_t HardContactSemiImplicitTimesteppingSolvers::relaxInelasticCoulombC
                                                                                                                 HardContactSemiImplicitTimesteppingSolvers::BodyCache& bodyCache )
 {
    real_t delta_max( 0 );
-   size_t numContactsMasked( contactCache.p_.size() );
 
    // Relax contacts
-   for( size_t i = 0; i < numContactsMasked; ++i ) {
-      // Remove velocity corrections of this contact's reaction.
-      bodyCache.dv_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-      bodyCache.dv_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-
-      // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
-      Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
-
-      // Change from the global world frame to the contact frame
-      Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
-      Vec3 gdot_nto( contactframe.getTranspose() * gdot );
-
-      //real_t gdot_n  ( trans( contactCache.n_[i] ) * gdot );  // The component of gdot along the contact normal n
-      //Vec3 gdot_t  ( gdot - gdot_n * contactCache.n_[i] );  // The components of gdot tangential to the contact normal n
-      //real_t g_n     ( gdot_n * dt /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] );  // The gap in normal direction
-
-      // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
-      gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
-
-      const real_t w( 1 ); // w > 0
-      Vec3 p_cf( contactframe.getTranspose() * contactCache.p_[i] );
-      if( approximate ) {
-         // Calculate next iterate (Anitescu/Tasora).
-         p_cf = p_cf - w * ( contactCache.diag_nto_[i] * p_cf + gdot_nto );
-      }
-      else {
-         // Calculate next iterate (De Saxce/Feng).
-         Vec3 tmp( contactCache.diag_nto_[i] * p_cf + gdot_nto );
-         tmp[0] += std::sqrt( math::sq( tmp[1] ) + math::sq( tmp[2] ) ) * contactCache.mu_[i];
-         p_cf = p_cf - w * tmp;
-      }
+   for( size_t color = 0; color + 1 < contactCache.colorOffsets_.size(); ++color )
+   {
+      const int begin( int_c( contactCache.colorOffsets_[color] ) );
+      const int end  ( int_c( contactCache.colorOffsets_[color + 1] ) );
 
-      // Project.
-      real_t flimit( contactCache.mu_[i] * p_cf[0] );
-      real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
-      if( p_cf[0] > 0 && fsq < flimit * flimit ) {
-         // Unconstrained minimum is in cone leading to a static contact and no projection
-         // is necessary.
-      }
-      else if( p_cf[0] < 0 && fsq < p_cf[0] / math::sq( contactCache.mu_[i] ) ) {
-         // Unconstrained minimum is in dual cone leading to a separating contact where no contact
-         // reaction is present (the unconstrained minimum is projected to the tip of the cone).
+      // contacts of one color do not share a body with finite mass
+      #pragma omp parallel for schedule(static) reduction(max:delta_max) if( parallelExecution_ )
+      for( int c = begin; c < end; ++c ) {
+         const size_t i( contactCache.order_[uint_c( c )] );
 
-         p_cf = Vec3();
-      }
-      else {
-         // The contact is dynamic.
-         real_t f( std::sqrt( fsq ) );
-         p_cf[0] = ( f * contactCache.mu_[i] + p_cf[0] ) / ( math::sq( contactCache.mu_[i] ) + 1 );
-         real_t factor( contactCache.mu_[i] * p_cf[0] / f );
-         p_cf[1] *= factor;
-         p_cf[2] *= factor;
-      }
+         // Remove velocity corrections of this contact's reaction.
+         applyImpulse( contactCache, bodyCache, i, -contactCache.p_[i] );
+
+         // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
+         Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+
+         // Change from the global world frame to the contact frame
+         Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
+         Vec3 gdot_nto( contactframe.getTranspose() * gdot );
+
+         //real_t gdot_n  ( trans( contactCache.n_[i] ) * gdot );  // The component of gdot along the contact normal n
+         //Vec3 gdot_t  ( gdot - gdot_n * contactCache.n_[i] );  // The components of gdot tangential to the contact normal n
+         //real_t g_n     ( gdot_n * dt /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] );  // The gap in normal direction
+
+         // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
+         gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
 
-      Vec3 p_wf( contactframe * p_cf );
-      Vec3 dp( contactCache.p_[i] - p_wf );
-      delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+         const real_t w( 1 ); // w > 0
+         Vec3 p_cf( contactframe.getTranspose() * contactCache.p_[i] );
+         if( approximate ) {
+            // Calculate next iterate (Anitescu/Tasora).
+            p_cf = p_cf - w * ( contactCache.diag_nto_[i] * p_cf + gdot_nto );
+         }
+         else {
+            // Calculate next iterate (De Saxce/Feng).
+            Vec3 tmp( contactCache.diag_nto_[i] * p_cf + gdot_nto );
+            tmp[0] += std::sqrt( math::sq( tmp[1] ) + math::sq( tmp[2] ) ) * contactCache.mu_[i];
+            p_cf = p_cf - w * tmp;
+         }
+
+         // Project.
+         real_t flimit( contactCache.mu_[i] * p_cf[0] );
+         real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
+         if( p_cf[0] > 0 && fsq < flimit * flimit ) {
+            // Unconstrained minimum is in cone leading to a static contact and no projection
+            // is necessary.
+         }
+         else if( p_cf[0] < 0 && fsq < p_cf[0] / math::sq( contactCache.mu_[i] ) ) {
+            // Unconstrained minimum is in dual cone leading to a separating contact where no contact
+            // reaction is present (the unconstrained minimum is projected to the tip of the cone).
+
+            p_cf = Vec3();
+         }
+         else {
+            // The contact is dynamic.
+            real_t f( std::sqrt( fsq ) );
+            p_cf[0] = ( f * contactCache.mu_[i] + p_cf[0] ) / ( math::sq( contactCache.mu_[i] ) + 1 );
+            real_t factor( contactCache.mu_[i] * p_cf[0] / f );
+            p_cf[1] *= factor;
+            p_cf[2] *= factor;
+         }
+
+         Vec3 p_wf( contactframe * p_cf );
+         Vec3 dp( contactCache.p_[i] - p_wf );
+         delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
 
-      contactCache.p_[i] = p_wf;
+         contactCache.p_[i] = p_wf;
 
-      // Apply impulse right away
-      bodyCache.dv_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-      bodyCache.dv_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
+         // Apply impulse right away
+         applyImpulse( contactCache, bodyCache, i, contactCache.p_[i] );
+      }
    }
 
    return delta_max;
@@ -1131,277 +1166,280 @@ inline real_t HardContactSemiImplicitTimesteppingSolvers::relaxInelasticGenerali
                                                                                                                HardContactSemiImplicitTimesteppingSolvers::BodyCache& bodyCache )
 {
    real_t delta_max( 0 );
-   size_t numContactsMasked( contactCache.p_.size() );
 
    // Relax contacts
-   for( size_t i = 0; i < numContactsMasked; ++i ) {
-      // Remove velocity corrections of this contact's reaction.
-      bodyCache.dv_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body1_[i]->index_] -= contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-      bodyCache.dv_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-      bodyCache.dw_[contactCache.body2_[i]->index_] += contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-
-      // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
-      Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+   for( size_t color = 0; color + 1 < contactCache.colorOffsets_.size(); ++color )
+   {
+      const int begin( int_c( contactCache.colorOffsets_[color] ) );
+      const int end  ( int_c( contactCache.colorOffsets_[color + 1] ) );
 
-      // Change from the global world frame to the contact frame
-      Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
-      Vec3 gdot_nto( contactframe.getTranspose() * gdot );
+      // contacts of one color do not share a body with finite mass
+      #pragma omp parallel for schedule(static) reduction(max:delta_max) if( parallelExecution_ )
+      for( int c = begin; c < end; ++c ) {
+         const size_t i( contactCache.order_[uint_c( c )] );
 
-      // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
-      gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+         // Remove velocity corrections of this contact's reaction.
+         applyImpulse( contactCache, bodyCache, i, -contactCache.p_[i] );
 
-      //WALBERLA_LOG_WARNING( "Contact #" << i << " is\nA = \n" << contactCache.diag_nto_[i] << "\nb = \n" << gdot_nto << "\nmu = " << contactCache.mu_[i] );
+         // Calculate the relative contact velocity in the global world frame (if no contact reaction is present at contact i)
+         Vec3 gdot    ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) - ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) + ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] - ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
 
-      if( gdot_nto[0] >= 0 ) {
-         // Contact is separating if no contact reaction is necessary without violating the penetration constraint.
+         // Change from the global world frame to the contact frame
+         Mat3 contactframe( contactCache.n_[i], contactCache.t_[i], contactCache.o_[i] );
+         Vec3 gdot_nto( contactframe.getTranspose() * gdot );
 
-         delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
-         contactCache.p_[i] = Vec3();
+         // The constraint in normal direction is actually a positional constraint but instead of g_n we use g_n/dt equivalently and call it gdot_n
+         gdot_nto[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
 
-         //WALBERLA_LOG_WARNING( "Contact #" << i << " is separating." );
+         //WALBERLA_LOG_WARNING( "Contact #" << i << " is\nA = \n" << contactCache.diag_nto_[i] << "\nb = \n" << gdot_nto << "\nmu = " << contactCache.mu_[i] );
 
-         // No need to apply zero impulse.
-      }
-      else {
-         // Contact is persisting (either static or dynamic).
+         if( gdot_nto[0] >= 0 ) {
+            // Contact is separating if no contact reaction is necessary without violating the penetration constraint.
 
-         // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
-         Vec3 p_cf( -( contactCache.diag_nto_inv_[i] * gdot_nto ) );
+            delta_max = std::max( delta_max, std::max( std::abs( contactCache.p_[i][0] ), std::max( std::abs( contactCache.p_[i][1] ), std::abs( contactCache.p_[i][2] ) ) ) );
+            contactCache.p_[i] = Vec3();
 
-         // Can p_cf[0] be negative even though -gdot_nto[0] > 0? Yes! Try:
-         // A = [0.5 -0.1 +0.1; -0.1 0.5 -0.1; +0.1 -0.1 1];
-         // b = [0.01 -1 -1]';
-         // A\b    \approx [-0.19 -2.28 -1.21]'
-         // eig(A) \approx [ 0.40  0.56  1.04]'
+            //WALBERLA_LOG_WARNING( "Contact #" << i << " is separating." );
 
-         real_t flimit( contactCache.mu_[i] * p_cf[0] );
-         real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
-         if( fsq > flimit * flimit || p_cf[0] < 0 ) {
-            // Contact cannot be static so it must be dynamic.
-            // => Complementarity condition on normal reaction now turns into an equation since we know that the normal reaction is definitely not zero.
-
-            // \breve{x}^0 = p_cf[1..2]
-
-            // Eliminate normal component from 3x3 system: contactCache.diag_nto_[i]*p_cf + gdot_nto => \breve{A} \breve{x} - \breve{b}
-            const real_t invA_nn( math::inv( contactCache.diag_nto_[i](0, 0) ) );
-                                  const real_t offdiag( contactCache.diag_nto_[i](1, 2) - invA_nn * contactCache.diag_nto_[i](0, 1) * contactCache.diag_nto_[i](0, 2) );
-                                  Mat2 A_breve( contactCache.diag_nto_[i](1, 1) - invA_nn *math::sq( contactCache.diag_nto_[i](0, 1) ), offdiag, offdiag, contactCache.diag_nto_[i](2, 2) - invA_nn *math::sq( contactCache.diag_nto_[i](0, 2) ) );
-                                                                                                     Vec2 b_breve( -gdot_nto[1] + invA_nn * contactCache.diag_nto_[i](0, 1) * gdot_nto[0], -gdot_nto[2] + invA_nn * contactCache.diag_nto_[i](0, 2) * gdot_nto[0] );
-
-                                                const real_t shiftI( std::atan2( -contactCache.diag_nto_[i](0, 2), contactCache.diag_nto_[i](0, 1) ) );
-                                                                     const real_t shiftJ( std::atan2( -p_cf[2], p_cf[1] ) );
-                                  const real_t a3( std::sqrt(math::sq( contactCache.diag_nto_[i](0, 1) ) +math::sq( contactCache.diag_nto_[i](0, 2) ) ) );
-                                                                       const real_t fractionI( -contactCache.diag_nto_[i](0, 0) / ( contactCache.mu_[i] * a3 ) );
-                                                                       const real_t fractionJ( std::min( invA_nn * contactCache.mu_[i] * ( ( -gdot_nto[0] ) / std::sqrt( fsq ) - a3 * std::cos( shiftI - shiftJ ) ), real_c( 1 ) ) );
-
-                                                             // Search interval determination.
-                                                             real_t alpha_left, alpha_right;
-                                                   if( fractionJ < -1 ) {
-                                                      // J is complete
-                                                      const real_t angleI( std::acos( fractionI ) );
-                                                      alpha_left = -angleI - shiftI;
-                                                      alpha_right = +angleI - shiftI;
-                                                      if( alpha_left < 0 ) {
-                                                         alpha_left += 2 * math::M_PI;
-                                                         alpha_right += 2 * math::M_PI;
+            // No need to apply zero impulse.
+         }
+         else {
+            // Contact is persisting (either static or dynamic).
+
+            // Calculate the impulse necessary for a static contact expressed as components in the contact frame.
+            Vec3 p_cf( -( contactCache.diag_nto_inv_[i] * gdot_nto ) );
+
+            // Can p_cf[0] be negative even though -gdot_nto[0] > 0? Yes! Try:
+            // A = [0.5 -0.1 +0.1; -0.1 0.5 -0.1; +0.1 -0.1 1];
+            // b = [0.01 -1 -1]';
+            // A\b    \approx [-0.19 -2.28 -1.21]'
+            // eig(A) \approx [ 0.40  0.56  1.04]'
+
+            real_t flimit( contactCache.mu_[i] * p_cf[0] );
+            real_t fsq( p_cf[1] * p_cf[1] + p_cf[2] * p_cf[2] );
+            if( fsq > flimit * flimit || p_cf[0] < 0 ) {
+               // Contact cannot be static so it must be dynamic.
+               // => Complementarity condition on normal reaction now turns into an equation since we know that the normal reaction is definitely not zero.
+
+               // \breve{x}^0 = p_cf[1..2]
+
+               // Eliminate normal component from 3x3 system: contactCache.diag_nto_[i]*p_cf + gdot_nto => \breve{A} \breve{x} - \breve{b}
+               const real_t invA_nn( math::inv( contactCache.diag_nto_[i](0, 0) ) );
+                                     const real_t offdiag( contactCache.diag_nto_[i](1, 2) - invA_nn * contactCache.diag_nto_[i](0, 1) * contactCache.diag_nto_[i](0, 2) );
+                                     Mat2 A_breve( contactCache.diag_nto_[i](1, 1) - invA_nn *math::sq( contactCache.diag_nto_[i](0, 1) ), offdiag, offdiag, contactCache.diag_nto_[i](2, 2) - invA_nn *math::sq( contactCache.diag_nto_[i](0, 2) ) );
+                                                                                                        Vec2 b_breve( -gdot_nto[1] + invA_nn * contactCache.diag_nto_[i](0, 1) * gdot_nto[0], -gdot_nto[2] + invA_nn * contactCache.diag_nto_[i](0, 2) * gdot_nto[0] );
+
+                                                   const real_t shiftI( std::atan2( -contactCache.diag_nto_[i](0, 2), contactCache.diag_nto_[i](0, 1) ) );
+                                                                        const real_t shiftJ( std::atan2( -p_cf[2], p_cf[1] ) );
+                                     const real_t a3( std::sqrt(math::sq( contactCache.diag_nto_[i](0, 1) ) +math::sq( contactCache.diag_nto_[i](0, 2) ) ) );
+                                                                          const real_t fractionI( -contactCache.diag_nto_[i](0, 0) / ( contactCache.mu_[i] * a3 ) );
+                                                                          const real_t fractionJ( std::min( invA_nn * contactCache.mu_[i] * ( ( -gdot_nto[0] ) / std::sqrt( fsq ) - a3 * std::cos( shiftI - shiftJ ) ), real_c( 1 ) ) );
+
+                                                                // Search interval determination.
+                                                                real_t alpha_left, alpha_right;
+                                                      if( fractionJ < -1 ) {
+                                                         // J is complete
+                                                         const real_t angleI( std::acos( fractionI ) );
+                                                         alpha_left = -angleI - shiftI;
+                                                         alpha_right = +angleI - shiftI;
+                                                         if( alpha_left < 0 ) {
+                                                            alpha_left += 2 * math::M_PI;
+                                                            alpha_right += 2 * math::M_PI;
+                                                         }
                                                       }
-                                                   }
-                                                   else if( contactCache.diag_nto_[i](0, 0) > contactCache.mu_[i] * a3 ) {
-               // I is complete
-               const real_t angleJ( std::acos( fractionJ ) );
-               alpha_left = -angleJ - shiftJ;
-               alpha_right = +angleJ - shiftJ;
-               if( alpha_left < 0 ) {
-                  alpha_left += 2 * math::M_PI;
-                  alpha_right += 2 * math::M_PI;
-               }
-            }
-            else {
-               // neither I nor J is complete
-               const real_t angleJ( std::acos( fractionJ ) );
-               real_t alpha1_left( -angleJ - shiftJ );
-               real_t alpha1_right( +angleJ - shiftJ );
-               if( alpha1_left < 0 ) {
-                  alpha1_left += 2 * math::M_PI;
-                  alpha1_right += 2 * math::M_PI;
-               }
-               const real_t angleI( std::acos( fractionI ) );
-               real_t alpha2_left( -angleI - shiftI );
-               real_t alpha2_right( +angleI - shiftI );
-               if( alpha2_left < 0 ) {
-                  alpha2_left += 2 * math::M_PI;
-                  alpha2_right += 2 * math::M_PI;
-               }
-
-               // Swap intervals if second interval does not start right of the first interval.
-               if( alpha1_left > alpha2_left ) {
-                  std::swap( alpha1_left, alpha2_left );
-                  std::swap( alpha1_right, alpha2_right );
-               }
-
-               if( alpha2_left > alpha1_right ) {
-                  alpha2_right -= 2*math::M_PI;
-                  if( alpha2_right > alpha1_right ) {
-                     // [alpha1_left; alpha1_right] \subset [alpha2_left; alpha2_right]
-                  }
-                  else {
-                     // [alpha2_left; alpha2_right] intersects the left end of [alpha1_left; alpha1_right]
-                     alpha1_right = alpha2_right;
+                                                      else if( contactCache.diag_nto_[i](0, 0) > contactCache.mu_[i] * a3 ) {
+                  // I is complete
+                  const real_t angleJ( std::acos( fractionJ ) );
+                  alpha_left = -angleJ - shiftJ;
+                  alpha_right = +angleJ - shiftJ;
+                  if( alpha_left < 0 ) {
+                     alpha_left += 2 * math::M_PI;
+                     alpha_right += 2 * math::M_PI;
                   }
                }
                else {
-                  alpha1_left = alpha2_left;
-                  if( alpha2_right > alpha1_right ) {
-                     // [alpha2_left; alpha2_right] intersects the right end of [alpha1_left; alpha1_right]
+                  // neither I nor J is complete
+                  const real_t angleJ( std::acos( fractionJ ) );
+                  real_t alpha1_left( -angleJ - shiftJ );
+                  real_t alpha1_right( +angleJ - shiftJ );
+                  if( alpha1_left < 0 ) {
+                     alpha1_left += 2 * math::M_PI;
+                     alpha1_right += 2 * math::M_PI;
                   }
-                  else {
-                     // [alpha2_left; alpha2_right] \subset [alpha1_left; alpha1_right]
-                     alpha1_right = alpha2_right;
+                  const real_t angleI( std::acos( fractionI ) );
+                  real_t alpha2_left( -angleI - shiftI );
+                  real_t alpha2_right( +angleI - shiftI );
+                  if( alpha2_left < 0 ) {
+                     alpha2_left += 2 * math::M_PI;
+                     alpha2_right += 2 * math::M_PI;
                   }
-               }
-
-               alpha_left = alpha1_left;
-               alpha_right = alpha1_right;
-            }
 
-            const real_t phi( real_c(0.5) * ( real_c(1) + std::sqrt( real_c( 5 ) ) ) );
-                                                   real_t alpha_mid( ( alpha_right + alpha_left * phi ) / ( 1 + phi ) );
-                                  Vec2 x_mid;
-                  real_t f_mid;
-
-            {
-               real_t r_ub = contactCache.mu_[i] * ( -gdot_nto[0] ) / ( contactCache.diag_nto_[i](0, 0) + contactCache.mu_[i] * a3 * std::cos( alpha_mid + shiftI ) );
-                     if( r_ub < 0 )
-                     r_ub = math::Limits<real_t>::inf();
-               x_mid = Vec2( r_ub * std::cos( alpha_mid ), r_ub * std::sin( alpha_mid ) );
-               f_mid = real_c(0.5) * x_mid * ( A_breve * x_mid ) - x_mid * b_breve;
-            }
+                  // Swap intervals if second interval does not start right of the first interval.
+                  if( alpha1_left > alpha2_left ) {
+                     std::swap( alpha1_left, alpha2_left );
+                     std::swap( alpha1_right, alpha2_right );
+                  }
 
-            bool leftlarger = false;
-            for( size_t k = 0; k < maxSubIterations_; ++k ) {
-               real_t alpha_next( alpha_left + ( alpha_right - alpha_mid ) );
-               real_t r_ub = contactCache.mu_[i] * ( -gdot_nto[0] ) / ( contactCache.diag_nto_[i](0, 0) + contactCache.mu_[i] * a3 * std::cos( alpha_next + shiftI ) );
-                     if( r_ub < 0 )
-                     r_ub = math::Limits<real_t>::inf();
-               Vec2 x_next( r_ub * std::cos( alpha_next ), r_ub * std::sin( alpha_next ) );
-               real_t f_next( real_c(0.5) * x_next * ( A_breve * x_next ) - x_next * b_breve );
-
-               //WALBERLA_LOG_WARNING( "[(" << alpha_left << ", ?); (" << alpha_mid << ", " << f_mid << "); (" << alpha_right << ", ?)] <- (" << alpha_next << ", " << f_next << ")" );
-               //WALBERLA_LOG_WARNING( "left: " << alpha_mid - alpha_left << "  right: " << alpha_right - alpha_mid << "  ll: " << leftlarger );
-               //WALBERLA_ASSERT(leftlarger ? (alpha_mid - alpha_left > alpha_right - alpha_mid) : (alpha_mid - alpha_left < alpha_right - alpha_mid), "ll inconsistent!" );
-
-               if (leftlarger) {
-                  // left interval larger
-                  if( f_next < f_mid ) {
-                     alpha_right = alpha_mid;
-                     alpha_mid   = alpha_next;
-                     x_mid       = x_next;
-                     f_mid       = f_next;
-                     leftlarger = true;
+                  if( alpha2_left > alpha1_right ) {
+                     alpha2_right -= 2*math::M_PI;
+                     if( alpha2_right > alpha1_right ) {
+                        // [alpha1_left; alpha1_right] \subset [alpha2_left; alpha2_right]
+                     }
+                     else {
+                        // [alpha2_left; alpha2_right] intersects the left end of [alpha1_left; alpha1_right]
+                        alpha1_right = alpha2_right;
+                     }
                   }
                   else {
-                     alpha_left  = alpha_next;
-                     leftlarger = false;
+                     alpha1_left = alpha2_left;
+                     if( alpha2_right > alpha1_right ) {
+                        // [alpha2_left; alpha2_right] intersects the right end of [alpha1_left; alpha1_right]
+                     }
+                     else {
+                        // [alpha2_left; alpha2_right] \subset [alpha1_left; alpha1_right]
+                        alpha1_right = alpha2_right;
+                     }
                   }
+
+                  alpha_left = alpha1_left;
+                  alpha_right = alpha1_right;
                }
-               else {
-                  // right interval larger
-                  if( f_next < f_mid ) {
-                     alpha_left = alpha_mid;
-                     alpha_mid  = alpha_next;
-                     x_mid      = x_next;
-                     f_mid      = f_next;
-                     leftlarger = false;
+
+               const real_t phi( real_c(0.5) * ( real_c(1) + std::sqrt( real_c( 5 ) ) ) );
+                                                      real_t alpha_mid( ( alpha_right + alpha_left * phi ) / ( 1 + phi ) );
+                                     Vec2 x_mid;
+                     real_t f_mid;
+
+               {
+                  real_t r_ub = contactCache.mu_[i] * ( -gdot_nto[0] ) / ( contactCache.diag_nto_[i](0, 0) + contactCache.mu_[i] * a3 * std::cos( alpha_mid + shiftI ) );
+                        if( r_ub < 0 )
+                        r_ub = math::Limits<real_t>::inf();
+                  x_mid = Vec2( r_ub * std::cos( alpha_mid ), r_ub * std::sin( alpha_mid ) );
+                  f_mid = real_c(0.5) * x_mid * ( A_breve * x_mid ) - x_mid * b_breve;
+               }
+
+               bool leftlarger = false;
+               for( size_t k = 0; k < maxSubIterations_; ++k ) {
+                  real_t alpha_next( alpha_left + ( alpha_right - alpha_mid ) );
+                  real_t r_ub = contactCache.mu_[i] * ( -gdot_nto[0] ) / ( contactCache.diag_nto_[i](0, 0) + contactCache.mu_[i] * a3 * std::cos( alpha_next + shiftI ) );
+                        if( r_ub < 0 )
+                        r_ub = math::Limits<real_t>::inf();
+                  Vec2 x_next( r_ub * std::cos( alpha_next ), r_ub * std::sin( alpha_next ) );
+                  real_t f_next( real_c(0.5) * x_next * ( A_breve * x_next ) - x_next * b_breve );
+
+                  //WALBERLA_LOG_WARNING( "[(" << alpha_left << ", ?); (" << alpha_mid << ", " << f_mid << "); (" << alpha_right << ", ?)] <- (" << alpha_next << ", " << f_next << ")" );
+                  //WALBERLA_LOG_WARNING( "left: " << alpha_mid - alpha_left << "  right: " << alpha_right - alpha_mid << "  ll: " << leftlarger );
+                  //WALBERLA_ASSERT(leftlarger ? (alpha_mid - alpha_left > alpha_right - alpha_mid) : (alpha_mid - alpha_left < alpha_right - alpha_mid), "ll inconsistent!" );
+
+                  if (leftlarger) {
+                     // left interval larger
+                     if( f_next < f_mid ) {
+                        alpha_right = alpha_mid;
+                        alpha_mid   = alpha_next;
+                        x_mid       = x_next;
+                        f_mid       = f_next;
+                        leftlarger = true;
+                     }
+                     else {
+                        alpha_left  = alpha_next;
+                        leftlarger = false;
+                     }
                   }
                   else {
-                     alpha_right = alpha_next;
-                     leftlarger = true;
+                     // right interval larger
+                     if( f_next < f_mid ) {
+                        alpha_left = alpha_mid;
+                        alpha_mid  = alpha_next;
+                        x_mid      = x_next;
+                        f_mid      = f_next;
+                        leftlarger = false;
+                     }
+                     else {
+                        alpha_right = alpha_next;
+                        leftlarger = true;
+                     }
                   }
                }
-            }
-            //WALBERLA_LOG_DETAIL( "dalpha = " << alpha_right - alpha_left << "\n");
-            {
-               real_t alpha_init( std::atan2( p_cf[2], p_cf[1] ) );
-               real_t r_ub = contactCache.mu_[i] * ( -gdot_nto[0] ) / ( contactCache.diag_nto_[i](0, 0) + contactCache.mu_[i] * a3 * std::cos( alpha_init + shiftI ) );
-                     if( r_ub < 0 )
-                     r_ub = math::Limits<real_t>::inf();
-               Vec2 x_init( r_ub * std::cos( alpha_init ), r_ub * std::sin( alpha_init ) );
-               real_t f_init( real_c(0.5) * x_init * ( A_breve * x_init ) - x_init * b_breve );
-
-               if( f_init < f_mid )
+               //WALBERLA_LOG_DETAIL( "dalpha = " << alpha_right - alpha_left << "\n");
                {
-                  x_mid = x_init;
-                  WALBERLA_LOG_DETAIL( "Replacing solution by primitive dissipative solution (" << f_init << " < " << f_mid << " at " << alpha_init << " vs. " << alpha_mid << ").\n");
+                  real_t alpha_init( std::atan2( p_cf[2], p_cf[1] ) );
+                  real_t r_ub = contactCache.mu_[i] * ( -gdot_nto[0] ) / ( contactCache.diag_nto_[i](0, 0) + contactCache.mu_[i] * a3 * std::cos( alpha_init + shiftI ) );
+                        if( r_ub < 0 )
+                        r_ub = math::Limits<real_t>::inf();
+                  Vec2 x_init( r_ub * std::cos( alpha_init ), r_ub * std::sin( alpha_init ) );
+                  real_t f_init( real_c(0.5) * x_init * ( A_breve * x_init ) - x_init * b_breve );
+
+                  if( f_init < f_mid )
+                  {
+                     x_mid = x_init;
+                     WALBERLA_LOG_DETAIL( "Replacing solution by primitive dissipative solution (" << f_init << " < " << f_mid << " at " << alpha_init << " vs. " << alpha_mid << ").\n");
+                  }
                }
-            }
 
-            p_cf[0] = invA_nn * ( -gdot_nto[0] - contactCache.diag_nto_[i](0, 1) * x_mid[0] - contactCache.diag_nto_[i](0, 2) * x_mid[1] );
-            p_cf[1] = x_mid[0];
-            p_cf[2] = x_mid[1];
-            //WALBERLA_LOG_DETAIL( "Contact #" << i << " is dynamic." );
-         }
-         else {
-            // Contact is static.
-            //WALBERLA_LOG_DETAIL( "Contact #" << i << " is static." );
-         }
-         Vec3 p_wf( contactframe * p_cf );
-         Vec3 dp( contactCache.p_[i] - p_wf );
-         delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
-         //WALBERLA_LOG_DETAIL( "Contact reaction in contact frame: " << p_cf << "\nContact action in contact frame: " << contactCache.diag_nto_[i]*p_cf + gdot_nto );
+               p_cf[0] = invA_nn * ( -gdot_nto[0] - contactCache.diag_nto_[i](0, 1) * x_mid[0] - contactCache.diag_nto_[i](0, 2) * x_mid[1] );
+               p_cf[1] = x_mid[0];
+               p_cf[2] = x_mid[1];
+               //WALBERLA_LOG_DETAIL( "Contact #" << i << " is dynamic." );
+            }
+            else {
+               // Contact is static.
+               //WALBERLA_LOG_DETAIL( "Contact #" << i << " is static." );
+            }
+            Vec3 p_wf( contactframe * p_cf );
+            Vec3 dp( contactCache.p_[i] - p_wf );
+            delta_max = std::max( delta_max, std::max( std::abs( dp[0] ), std::max( std::abs( dp[1] ), std::abs( dp[2] ) ) ) );
+            //WALBERLA_LOG_DETAIL( "Contact reaction in contact frame: " << p_cf << "\nContact action in contact frame: " << contactCache.diag_nto_[i]*p_cf + gdot_nto );
 
-         contactCache.p_[i] = p_wf;
+            contactCache.p_[i] = p_wf;
 
-         // Apply impulse right away
-         bodyCache.dv_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body1_[i]->index_] += contactCache.body1_[i]->getInvInertia() * ( contactCache.r1_[i] % contactCache.p_[i] );
-         bodyCache.dv_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvMass() * contactCache.p_[i];
-         bodyCache.dw_[contactCache.body2_[i]->index_] -= contactCache.body2_[i]->getInvInertia() * ( contactCache.r2_[i] % contactCache.p_[i] );
-      }
+            // Apply impulse right away
+            applyImpulse( contactCache, bodyCache, i, contactCache.p_[i] );
+         }
 
 #if 0
-      Vec3 gdot2   ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
-            ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
-            ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
-            ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
-      Vec3 gdot_nto2( contactframe.getTranspose() * gdot2 );
-      WALBERLA_LOG_DETAIL( "gdot_n2 = " << gdot_nto2[0] );
-      WALBERLA_LOG_DETAIL( "gdot_t2 = " << gdot_nto2[1] );
-      WALBERLA_LOG_DETAIL( "gdot_o2 = " << gdot_nto2[2] );
-
-      gdot_nto2[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
-      WALBERLA_LOG_DETAIL( "gdot_n2' = " << gdot_nto2[0] << "\n");
+         Vec3 gdot2   ( ( bodyCache.v_[contactCache.body1_[i]->index_] + bodyCache.dv_[contactCache.body1_[i]->index_] ) -
+               ( bodyCache.v_[contactCache.body2_[i]->index_] + bodyCache.dv_[contactCache.body2_[i]->index_] ) +
+               ( bodyCache.w_[contactCache.body1_[i]->index_] + bodyCache.dw_[contactCache.body1_[i]->index_] ) % contactCache.r1_[i] -
+               ( bodyCache.w_[contactCache.body2_[i]->index_] + bodyCache.dw_[contactCache.body2_[i]->index_] ) % contactCache.r2_[i] /* + diag_[i] * p */ );
+         Vec3 gdot_nto2( contactframe.getTranspose() * gdot2 );
+         WALBERLA_LOG_DETAIL( "gdot_n2 = " << gdot_nto2[0] );
+         WALBERLA_LOG_DETAIL( "gdot_t2 = " << gdot_nto2[1] );
+         WALBERLA_LOG_DETAIL( "gdot_o2 = " << gdot_nto2[2] );
+
+         gdot_nto2[0] += ( /* + trans( contactCache.n_[i] ) * ( contactCache.body1_[i]->getPosition() + contactCache.r1_[i] ) - ( contactCache.body2_[i]->getPosition() + contactCache.r2_[i] ) */ + contactCache.dist_[i] ) * dtinv;
+         WALBERLA_LOG_DETAIL( "gdot_n2' = " << gdot_nto2[0] << "\n");
 #endif
 
-      /*
-       * compare DEM time-step with NSCD iteration:
-       * - projections are the same
-       * - velocities are the same if we use an explicit Euler discretization for the velocity time integration
-       *
-      f_cf[0] = -stiffness * contactCache.dist_ - damping_n * gdot_n = -[(stiffness * dt) * contactCache.dist_ * dtinv + damping_n * gdot_n] = -foo * (gdot_n + contactCache.dist_ * dtinv) where foo = stiffness * dt = damping_n;
-      f_cf[1] = -damping_t * gdot_t                     = -damping_t * gdot_t;
-      f_cf[2] = -damping_t * gdot_o                     = -damping_t * gdot_o;
+         /*
+          * compare DEM time-step with NSCD iteration:
+          * - projections are the same
+          * - velocities are the same if we use an explicit Euler discretization for the velocity time integration
+          *
+         f_cf[0] = -stiffness * contactCache.dist_ - damping_n * gdot_n = -[(stiffness * dt) * contactCache.dist_ * dtinv + damping_n * gdot_n] = -foo * (gdot_n + contactCache.dist_ * dtinv) where foo = stiffness * dt = damping_n;
+         f_cf[1] = -damping_t * gdot_t                     = -damping_t * gdot_t;
+         f_cf[2] = -damping_t * gdot_o                     = -damping_t * gdot_o;
 
-      or: f_cf = -diag(foo, damping_t, damping_t) * gdot_nto   (since gdot_nto[0] is modified)
-      vs. f_cf = -diaginv * gdot_nto in NSCD iteration
+         or: f_cf = -diag(foo, damping_t, damping_t) * gdot_nto   (since gdot_nto[0] is modified)
+         vs. f_cf = -diaginv * gdot_nto in NSCD iteration
 
-      => The NSCD iteration is more or less a DEM time step where we choose the stiffness and damping parameters such that penetration is non-existent after a time step and contacts are truly static (tangential rel. vel. is zero) unless the friction force hits its limit
+         => The NSCD iteration is more or less a DEM time step where we choose the stiffness and damping parameters such that penetration is non-existent after a time step and contacts are truly static (tangential rel. vel. is zero) unless the friction force hits its limit
 
-      f_cf[0] = std::max( 0, f_cf[0] );
+         f_cf[0] = std::max( 0, f_cf[0] );
 
-      flimit = contactCache.mu_ * f_cf[0];
-      fsq = f_cf[1] * f_cf[1] + f_cf[2] * f_cf[2]
-      if( fsq > flimit * flimit ) {
-         f = flimit / sqrt( fsq );
-         f_cf[1] *= f;
-         f_cf[2] *= f;
-      }
+         flimit = contactCache.mu_ * f_cf[0];
+         fsq = f_cf[1] * f_cf[1] + f_cf[2] * f_cf[2]
+         if( fsq > flimit * flimit ) {
+            f = flimit / sqrt( fsq );
+            f_cf[1] *= f;
+            f_cf[2] *= f;
+         }
 
-      f_wf = contactframe * f_cf;
+         f_wf = contactframe * f_cf;
 
-      b1->addForceAtPos(  f_wf, gpos );
-      b2->addForceAtPos( -f_wf, gpos );
-      */
+         b1->addForceAtPos(  f_wf, gpos );
+         b2->addForceAtPos( -f_wf, gpos );
+         */
+      }
    }
 
    return delta_max;
@@ -1409,6 +1447,38 @@ inline real_t HardContactSemiImplicitTimesteppingSolvers::relaxInelasticGenerali
 //*************************************************************************************************
 
 
+//*************************************************************************************************
+/*!\brief Applies an impulse at a contact to the velocity corrections of both bodies.
+ *
+ * \param contactCache The contacts of the block.
+ * \param bodyCache The bodies of the block.
+ * \param i The index of the contact.
+ * \param p The impulse acting on body 1 (body 2 experiences -p).
+ * \return void
+ *
+ * Bodies with infinite mass are skipped since their velocity corrections vanish anyway. Thus only
+ * the bodies with finite mass are written, which allows contacts sharing a body with infinite
+ * mass (e.g. a wall) to be relaxed concurrently.
+ */
+inline void HardContactSemiImplicitTimesteppingSolvers::applyImpulse( const ContactCache& contactCache, BodyCache& bodyCache, size_t i, const Vec3& p ) const
+{
+   ConstBodyID b1( contactCache.body1_[i] );
+   ConstBodyID b2( contactCache.body2_[i] );
+
+   if( !b1->hasInfiniteMass() )
+   {
+      bodyCache.dv_[b1->index_] += b1->getInvMass() * p;
+      bodyCache.dw_[b1->index_] += b1->getInvInertia() * ( contactCache.r1_[i] % p );
+   }
+   if( !b2->hasInfiniteMass() )
+   {
+      bodyCache.dv_[b2->index_] -= b2->getInvMass() * p;
+      bodyCache.dw_[b2->index_] -= b2->getInvInertia() * ( contactCache.r2_[i] % p );
+   }
+}
+//*************************************************************************************************
+
+
 
 
 //=================================================================================================
@@ -1880,11 +1950,15 @@ void configure( const Config::BlockHandle& config, pe::cr::HCSITS& cr )
    Vec3 globalLinearAcceleration = config.getParameter<Vec3>("globalLinearAcceleration", Vec3(0, 0, 0));
    WALBERLA_LOG_INFO_ON_ROOT("globalLinearAcceleration: " << globalLinearAcceleration);
 
+   bool HCSITSParallelExecution = config.getParameter<bool>("HCSITSParallelExecution", false );
+   WALBERLA_LOG_INFO_ON_ROOT("HCSITSParallelExecution: " << HCSITSParallelExecution);
+
    cr.setMaxIterations( uint_c(HCSITSmaxIterations) );
    cr.setRelaxationModel( HCSITSRelaxationModel );
    cr.setRelaxationParameter( HCSITSRelaxationParameter );
    cr.setErrorReductionParameter( HCSITSErrorReductionParameter );
    cr.setGlobalLinearAcceleration( globalLinearAcceleration );
+   cr.setParallelExecution( HCSITSParallelExecution );
 }
 
 } // namespace walberla
@@ -0,0 +1,92 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SoAIntegrators.h
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "pe/Types.h"
+#include "pe/rigidbody/SoABodyStorage.h"
+
+#include "core/math/Utility.h"
+#include "core/OpenMP.h"
+
+namespace walberla {
+namespace pe {
+namespace cr {
+
+//*************************************************************************************************
+/*!\brief Integrate the trajectories of all bodies of a SoABodyStorage using implicit Euler.
+*
+* \param bodies The body storage.
+* \param dt Time step size.
+* \param globalLinearAcceleration Acceleration acting on all bodies (e.g. gravity).
+* \return void
+*
+* Array counterpart of IntegrateImplicitEuler: same update for every body with finite mass,
+* followed by resetting the forces and torques of all bodies. The bodies are processed in
+* parallel if OpenMP is enabled. In contrast to the PlainIntegrator, bodies are not put to sleep,
+* i.e., all bodies with finite mass are moved.
+*/
+inline void integrateImplicitEuler( SoABodyStorage& bodies, const real_t dt, const Vec3& globalLinearAcceleration = Vec3() )
+{
+   const int size = int_c( bodies.size() );
+
+   #pragma omp parallel for schedule(static)
+   for( int b = 0; b < size; ++b )
+   {
+      const SoABodyStorage::size_type i = uint_c( b );
+
+      if( !bodies.hasInfiniteMass( i ) )
+      {
+         Quat& q = bodies.getOrientation( i );
+
+         // Calculating the linear acceleration by the equation
+         //   force * m^(-1) + gravity
+         const Vec3 vdot( bodies.getForce( i ) * bodies.getInvMass( i ) + globalLinearAcceleration );
+
+         // Calculating the angular acceleration by the equation
+         //   R * Iinv * R^T * torque
+         const Vec3 wdot( math::transformMatrixRART( q.toRotationMatrix(), bodies.getInvBodyInertia( i ) ) * bodies.getTorque( i ) );
+
+         // Updating the linear velocity
+         bodies.getLinearVel( i ) += vdot * dt;
+
+         // Updating the angular velocity
+         bodies.getAngularVel( i ) += wdot * dt;
+
+         // Calculating the translational displacement
+         bodies.getPosition( i ) += bodies.getLinearVel( i ) * dt;
+
+         // Calculating the rotation angle
+         const Vec3 phi( bodies.getAngularVel( i ) * dt );
+
+         // Calculating the new orientation
+         if (!floatIsEqual(phi.length(), 0))
+            q = Quat( phi, phi.length() ) * q;
+      }
+
+      // Resetting the acting forces
+      bodies.getForce( i )  = Vec3();
+      bodies.getTorque( i ) = Vec3();
+   }
+}
+//*************************************************************************************************
+
+}  // namespace cr
+} // namespace pe
+}  // namespace walberla
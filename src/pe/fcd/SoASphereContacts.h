@@ -0,0 +1,97 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SoASphereContacts.h
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "pe/Thresholds.h"
+#include "pe/Types.h"
+#include "pe/rigidbody/SoABodyStorage.h"
+#include "pe/rigidbody/Sphere.h"
+
+#include <utility>
+#include <vector>
+
+namespace walberla {
+namespace pe {
+namespace fcd {
+
+//*************************************************************************************************
+/*!\brief Contact between two bodies of a SoABodyStorage.
+ *
+ * Same data as pe::Contact, but the bodies are referenced by their index in the storage.
+ */
+struct SoAContact
+{
+   SoABodyStorage::size_type body1;   //!< Index of the first body.
+   SoABodyStorage::size_type body2;   //!< Index of the second body.
+   Vec3   position;                   //!< The global position of the contact.
+   Vec3   normal;                     //!< The normal of the contact (pointing from body2 to body1).
+   real_t distance;                   //!< The distance between the surfaces (negative: penetration).
+};
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Sphere-sphere contact detection on a SoABodyStorage.
+ *
+ * \param bodies The body storage.
+ * \param pairs Container of index pairs (std::pair of body indices) of possibly colliding bodies.
+ * \param contacts Container for the generated contacts.
+ * \return void
+ *
+ * Array counterpart of fcd::analytic::collide( SphereID, SphereID, Container& ): contacts are
+ * generated for all pairs of spheres whose surfaces are closer than pe::contactThreshold. The
+ * shape table is only consulted for the type and radius, pairs that are not made up of two spheres
+ * are skipped.
+ */
+template< typename Pairs >
+inline void generateSphereContacts( const SoABodyStorage& bodies, const Pairs& pairs, std::vector<SoAContact>& contacts )
+{
+   const id_t sphereTypeID = Sphere::getStaticTypeID();
+
+   for( auto pair = pairs.begin(); pair != pairs.end(); ++pair )
+   {
+      const SoABodyStorage::size_type i = pair->first;
+      const SoABodyStorage::size_type j = pair->second;
+      WALBERLA_ASSERT_UNEQUAL( i, j, "colliding with itself!" );
+
+      const SoABodyStorage::Shape& shape1 = bodies.getShape( bodies.getShapeIndex( i ) );
+      const SoABodyStorage::Shape& shape2 = bodies.getShape( bodies.getShapeIndex( j ) );
+      if( shape1.typeID != sphereTypeID || shape2.typeID != sphereTypeID )
+         continue;
+
+      const real_t radius1 = shape1.parameters[0];
+      const real_t radius2 = shape2.parameters[0];
+
+      Vec3 contactNormal = ( bodies.getPosition( i ) - bodies.getPosition( j ) );
+      const real_t penetrationDepth = ( contactNormal.length() - radius1 - radius2 );
+
+      if( penetrationDepth < contactThreshold ) {
+         normalize(contactNormal);
+         const real_t k( radius2 + real_c(0.5) * penetrationDepth );
+         SoAContact contact = { i, j, bodies.getPosition( j ) + contactNormal * k, contactNormal, penetrationDepth };
+         contacts.push_back( contact );
+      }
+   }
+}
+//*************************************************************************************************
+
+}  // namespace fcd
+}  // namespace pe
+}  // namespace walberla
@@ -37,6 +37,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace walberla {
@@ -52,7 +53,8 @@ namespace pe {
 /*!\brief Body storage of the rigid body simulation world.
  *
  * A BodyStorage is a data structure for storing rigid bodies. It supports efficient insertion and
- * deletion operations.
+ * deletion operations. Bodies are found by their system ID in constant time (hashed index). For
+ * a contiguous storage of the state of the bodies see SoABodyStorage.
  */
 class BodyStorage : private NonCopyable
 {
@@ -145,6 +147,13 @@ public:
    //@}
    //**********************************************************************************************
 
+   //**Reordering functions************************************************************************
+   /*!\name Reordering functions */
+   //@{
+   inline void           reorder ( const std::vector<size_type>& order );
+   //@}
+   //**********************************************************************************************
+
    //**Callbacks************************************************************************
    /*!\name Callbacks */
    //@{
@@ -163,7 +172,7 @@ private:
    /*!\name Member variables */
    //@{
    VectorContainer           bodies_;    //!< The rigid bodies contained in the simulation world.
-   std::map<id_t, size_type> bodyIDs_;   //!< The association of system IDs to rigid bodies.
+   std::unordered_map<id_t, size_type> bodyIDs_;   //!< The association of system IDs to rigid bodies.
 
    std::map< std::string, std::function<void (BodyID)> > addCallbacks_;
    std::map< std::string, std::function<void (BodyID)> > removeCallbacks_;
@@ -475,7 +484,7 @@ inline ConstBodyID BodyStorage::at( size_type index ) const
 
 inline BodyStorage::iterator BodyStorage::find( id_t sid )
 {
-   std::map<id_t, size_type>::const_iterator pos = bodyIDs_.find( sid );
+   std::unordered_map<id_t, size_type>::const_iterator pos = bodyIDs_.find( sid );
    if( pos == bodyIDs_.end() )
       return BodyStorage::iterator(bodies_.end());
 
@@ -497,7 +506,7 @@ inline BodyStorage::iterator BodyStorage::find( id_t sid )
 
 inline BodyStorage::const_iterator BodyStorage::find( id_t sid ) const
 {
-   std::map<id_t, size_type>::const_iterator pos = bodyIDs_.find( sid );
+   std::unordered_map<id_t, size_type>::const_iterator pos = bodyIDs_.find( sid );
    if( pos == bodyIDs_.end() )
       return BodyStorage::const_iterator(bodies_.end());
 
@@ -619,7 +628,7 @@ inline RigidBody& BodyStorage::add( std::unique_ptr<RigidBody>&& body )
 inline
 BodyStorage::iterator BodyStorage::remove( const id_t sid )
 {
-   std::map<id_t, size_type>::iterator it = bodyIDs_.find( sid );
+   std::unordered_map<id_t, size_type>::iterator it = bodyIDs_.find( sid );
    WALBERLA_ASSERT( it != bodyIDs_.end(), "The body's system ID was not registered." );
 
    // Move last element to deleted place and update the system ID to index mapping.
@@ -708,7 +717,7 @@ BodyStorage::iterator BodyStorage::remove( BodyID body )
 
 inline std::unique_ptr<RigidBody> BodyStorage::release( const id_t sid )
 {
-   std::map<id_t, size_type>::iterator it = bodyIDs_.find( sid );
+   std::unordered_map<id_t, size_type>::iterator it = bodyIDs_.find( sid );
    WALBERLA_ASSERT( it != bodyIDs_.end(), "The body's system ID was not registered." );
 
    // Move last element to deleted place and update the system ID to index mapping.
@@ -813,6 +822,38 @@ inline void BodyStorage::clear()
 }
 //*************************************************************************************************
 
+
+//*************************************************************************************************
+/*!\brief Reordering the rigid bodies of the body storage.
+ *
+ * \param order The permutation: the body at index \a order[i] is moved to index \a i.
+ * \return void
+ *
+ * This function permutes the iteration order of the bodies and updates the mapping of system IDs
+ * to storage indices. Only the order of the body handles changes, the bodies themselves are not
+ * moved in memory. Hence all body handles stay valid and no callbacks are triggered, but all
+ * iterators of this container are invalidated.
+ *
+ * Reordering does not improve the memory locality of the bodies themselves. It is meant for data
+ * that is built by iterating over the storage, e.g. SoABodyStorage::load(), which copies the
+ * bodies into contiguous arrays in iteration order (see also sortBodies()).
+ */
+inline void BodyStorage::reorder( const std::vector<size_type>& order )
+{
+   WALBERLA_ASSERT_EQUAL( order.size(), bodies_.size(), "Permutation does not match the number of bodies" );
+
+   std::vector< std::unique_ptr<RigidBody> > bodies( bodies_.size() );
+   for( size_type i = 0; i < order.size(); ++i )
+   {
+      WALBERLA_ASSERT_LESS( order[i], bodies_.size(), "Invalid index in permutation" );
+      WALBERLA_ASSERT( bodies_[ order[i] ] != nullptr, "Index occurs twice in permutation" );
+      bodies[i] = std::move( bodies_[ order[i] ] );
+      bodyIDs_[ bodies[i]->getSystemID() ] = i;
+   }
+   bodies_.swap( bodies );
+}
+//*************************************************************************************************
+
 inline void          BodyStorage::registerAddCallback     ( const std::string& name, const std::function<void (BodyID)>& func )
 {
    WALBERLA_ASSERT_EQUAL(addCallbacks_.find(name), addCallbacks_.end(), "Callback '" << name << "' already exists!");
@@ -866,7 +907,7 @@ inline void          BodyStorage::clearRemoveCallbacks       ( )
 inline void BodyStorage::validate()
 {
    std::vector<bool> tmp(bodies_.size());
-   std::map<id_t, size_type>::iterator it = bodyIDs_.begin();
+   std::unordered_map<id_t, size_type>::iterator it = bodyIDs_.begin();
    while( it != bodyIDs_.end() ) {
       WALBERLA_ASSERT(tmp[it->second] == false, "Two system IDs point to the same storage index.");
       tmp[it->second] = true;
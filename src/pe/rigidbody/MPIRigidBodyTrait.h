@@ -24,7 +24,14 @@
 
 #include "Owner.h"
 
+#include "pe/Types.h"
+
+#include "core/debug/Debug.h"
+#include "core/math/Quaternion.h"
+#include "core/math/Vector3.h"
+
 #include <iostream>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -56,6 +63,13 @@ public:
    typedef ShadowOwners::iterator        ShadowOwnersIterator;       //!< Iterator over the connected processes.
    typedef ShadowOwners::const_iterator  ConstShadowOwnersIterator;  //!< ConstIterator over the connected processes.
    typedef size_t                        SizeType;
+
+   //! State of the rigid body as last sent to the shadow copies.
+   struct SyncState {
+      Vec3 gpos_, v_, w_;
+      Quat q_;
+      bool awake_;
+   };
    //**********************************************************************************************
 
    //**Constructor*********************************************************************************
@@ -109,6 +123,17 @@ public:
    //@}
    //**********************************************************************************************
 
+   //** functions to store the synchronized state *************************************************
+   /*!\name synchronization state functions */
+   //@{
+   inline bool                 hasSyncState  () const;
+   inline const SyncState&     getSyncState  () const;
+   inline SyncState&           getSyncState  ();
+   inline void                 setSyncState  ( const Vec3& gpos, const Quat& q, const Vec3& v, const Vec3& w, const bool awake );
+   inline void                 clearSyncState();
+   //@}
+   //**********************************************************************************************
+
 private:
    //**Member variables****************************************************************************
    /*!\name Member variables */
@@ -116,6 +141,7 @@ private:
    ShadowOwners shadowOwners_;    //!< Vector of all processes the rigid body intersects with.
    BlockStates  blockStates_;
    Owner        owner_;    //!< Rank of the process owning the rigid body.
+   std::unique_ptr<SyncState> syncState_;  //!< State sent with the last delta-encoded update (only allocated if used).
    //@}
    //**********************************************************************************************
 };
@@ -334,5 +360,44 @@ inline size_t MPIRigidBodyTrait::getBlockStateSize() const
    return blockStates_.size();
 }
 
+//*************************************************************************************************
+/*!\brief Returns whether the state sent with the last delta-encoded update is known.
+ *
+ * The state is only known to the process which sent it, i.e., it is lost on migration.
+ */
+inline bool MPIRigidBodyTrait::hasSyncState() const
+{
+   return syncState_ != nullptr;
+}
+//*************************************************************************************************
+
+inline const MPIRigidBodyTrait::SyncState& MPIRigidBodyTrait::getSyncState() const
+{
+   WALBERLA_ASSERT_NOT_NULLPTR( syncState_ );
+   return *syncState_;
+}
+
+inline MPIRigidBodyTrait::SyncState& MPIRigidBodyTrait::getSyncState()
+{
+   WALBERLA_ASSERT_NOT_NULLPTR( syncState_ );
+   return *syncState_;
+}
+
+inline void MPIRigidBodyTrait::setSyncState( const Vec3& gpos, const Quat& q, const Vec3& v, const Vec3& w, const bool awake )
+{
+   if( syncState_ == nullptr )
+      syncState_ = std::make_unique<SyncState>();
+   syncState_->gpos_  = gpos;
+   syncState_->q_     = q;
+   syncState_->v_     = v;
+   syncState_->w_     = w;
+   syncState_->awake_ = awake;
+}
+
+inline void MPIRigidBodyTrait::clearSyncState()
+{
+   syncState_.reset();
+}
+
 }  // namespace pe
 }  // namespace walberla
@@ -0,0 +1,521 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SoABodyStorage.h
+//
+//======================================================================================================================
+
+#pragma once
+
+
+//*************************************************************************************************
+// Includes
+//*************************************************************************************************
+
+#include <core/DataTypes.h>
+#include <core/NonCopyable.h>
+#include <core/debug/Debug.h>
+#include <pe/rigidbody/BodyStorage.h>
+#include <pe/rigidbody/Box.h>
+#include <pe/rigidbody/Capsule.h>
+#include <pe/rigidbody/Ellipsoid.h>
+#include <pe/rigidbody/Sphere.h>
+#include <pe/Types.h>
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace walberla {
+namespace pe {
+
+//=================================================================================================
+//
+//  CLASS DEFINITION
+//
+//=================================================================================================
+
+//*************************************************************************************************
+/*!\brief Structure-of-arrays storage of the state of rigid bodies.
+ *
+ * In contrast to the BodyStorage, which stores (polymorphic) rigid body objects, the SoABodyStorage
+ * stores every property of the bodies in a separate contiguous array: position, orientation, linear
+ * and angular velocity, force, torque, inverse mass, inverse body frame inertia and shape index.
+ * Integrators (see cr::integrateImplicitEuler()) and collision functions (see
+ * fcd::generateSphereContacts()) that operate on these arrays stream through memory instead of
+ * chasing pointers to individually allocated bodies and calling virtual functions.
+ *
+ * The geometry of the bodies is kept out of the arrays: every body only stores the index of its
+ * shape in a table of distinct shapes. Equal shapes (e.g. millions of spheres of the same radius)
+ * share one table entry.
+ *
+ * Bodies are found by their system ID in constant time. Removing a body moves the last body into
+ * the freed slot, i.e., indices of bodies are not stable across removals.
+ *
+ * The storage can be filled from and written back to a BodyStorage (see load() and store()).
+ */
+class SoABodyStorage : private NonCopyable
+{
+public:
+   //**Type definitions****************************************************************************
+   using size_type = std::vector<id_t>::size_type;   //!< Size type of the body storage.
+
+   //! Geometry of a body: type ID of the body class and its geometric parameters.
+   /*! The parameters are the radius (Sphere), the side lengths (Box), the semi-axes (Ellipsoid)
+       or the radius and length (Capsule). They are zero for all other body types. */
+   struct Shape
+   {
+      id_t typeID;
+      Vec3 parameters;
+
+      inline bool operator==( const Shape& other ) const;
+   };
+
+   //! Hash function of shapes, used to look up the index of a shape in the shape table.
+   struct ShapeHash
+   {
+      inline std::size_t operator()( const Shape& shape ) const;
+   };
+   //**********************************************************************************************
+
+   //**Utility functions***************************************************************************
+   /*!\name Utility functions */
+   //@{
+   inline bool      isEmpty() const { return sid_.empty(); }
+   inline size_type size   () const { return sid_.size(); }
+   inline size_type find   ( id_t sid ) const;
+   inline void      reserve( size_type capacity );
+   //@}
+   //**********************************************************************************************
+
+   //**Add/Remove functions************************************************************************
+   /*!\name Add/Remove functions */
+   //@{
+   inline size_type add   ( id_t sid, const Vec3& position, const Quat& orientation,
+                            const Vec3& linearVel, const Vec3& angularVel,
+                            real_t invMass, const Mat3& invBodyInertia, size_type shape );
+   inline size_type add   ( ConstBodyID body );
+   inline void      remove( id_t sid );
+   inline void      clear ();
+
+   inline void      load  ( const BodyStorage& storage );
+   inline void      store ( BodyStorage& storage ) const;
+   //@}
+   //**********************************************************************************************
+
+   //**Shape functions*****************************************************************************
+   /*!\name Shape functions */
+   //@{
+   inline size_type    addShape     ( const Shape& shape );
+   inline size_type    getShapeCount() const { return shapes_.size(); }
+   inline const Shape& getShape     ( size_type shape ) const { WALBERLA_ASSERT_LESS( shape, shapes_.size() ); return shapes_[shape]; }
+
+   static inline Shape getShape( ConstBodyID body );
+   //@}
+   //**********************************************************************************************
+
+   //**Get functions*******************************************************************************
+   /*!\name Get functions */
+   //@{
+   inline id_t        getSystemID      ( size_type i ) const { return sid_[i]; }
+   inline const Vec3& getPosition      ( size_type i ) const { return position_[i]; }
+   inline       Vec3& getPosition      ( size_type i )       { return position_[i]; }
+   inline const Quat& getOrientation   ( size_type i ) const { return orientation_[i]; }
+   inline       Quat& getOrientation   ( size_type i )       { return orientation_[i]; }
+   inline const Vec3& getLinearVel     ( size_type i ) const { return linearVel_[i]; }
+   inline       Vec3& getLinearVel     ( size_type i )       { return linearVel_[i]; }
+   inline const Vec3& getAngularVel    ( size_type i ) const { return angularVel_[i]; }
+   inline       Vec3& getAngularVel    ( size_type i )       { return angularVel_[i]; }
+   inline const Vec3& getForce         ( size_type i ) const { return force_[i]; }
+   inline       Vec3& getForce         ( size_type i )       { return force_[i]; }
+   inline const Vec3& getTorque        ( size_type i ) const { return torque_[i]; }
+   inline       Vec3& getTorque        ( size_type i )       { return torque_[i]; }
+   inline real_t      getInvMass       ( size_type i ) const { return invMass_[i]; }
+   inline const Mat3& getInvBodyInertia( size_type i ) const { return invBodyInertia_[i]; }
+   inline size_type   getShapeIndex    ( size_type i ) const { return shape_[i]; }
+   inline bool        hasInfiniteMass  ( size_type i ) const { return isIdentical( invMass_[i], real_t(0) ); }
+   //@}
+   //**********************************************************************************************
+
+private:
+   //**Member variables****************************************************************************
+   /*!\name Member variables */
+   //@{
+   std::vector<id_t>      sid_;              //!< The system IDs of the bodies.
+   std::vector<Vec3>      position_;         //!< The global positions of the centers of mass.
+   std::vector<Quat>      orientation_;      //!< The orientations of the bodies.
+   std::vector<Vec3>      linearVel_;        //!< The linear velocities.
+   std::vector<Vec3>      angularVel_;       //!< The angular velocities.
+   std::vector<Vec3>      force_;            //!< The forces acting on the bodies.
+   std::vector<Vec3>      torque_;           //!< The torques acting on the bodies.
+   std::vector<real_t>    invMass_;          //!< The inverse masses (zero for bodies with infinite mass).
+   std::vector<Mat3>      invBodyInertia_;   //!< The inverse moments of inertia within the body frames.
+   std::vector<size_type> shape_;            //!< The indices of the shapes of the bodies in 'shapes_'.
+
+   std::vector<Shape>                               shapes_;         //!< The distinct shapes of the bodies.
+   std::unordered_map<Shape, size_type, ShapeHash>  shapeIndices_;   //!< The association of shapes to indices in 'shapes_'.
+   std::unordered_map<id_t, size_type>              bodyIDs_;        //!< The association of system IDs to indices.
+   //@}
+   //**********************************************************************************************
+};
+//*************************************************************************************************
+
+
+
+
+//=================================================================================================
+//
+//  UTILITY FUNCTIONS
+//
+//=================================================================================================
+
+//*************************************************************************************************
+/*!\brief Finding a rigid body with a certain unique system-specific ID.
+ *
+ * \param sid The unique system-specific ID for the search.
+ * \return The index of the body or size() in case the body is not stored.
+ */
+inline SoABodyStorage::size_type SoABodyStorage::find( id_t sid ) const
+{
+   auto pos = bodyIDs_.find( sid );
+   if( pos == bodyIDs_.end() )
+      return size();
+   return pos->second;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Reserves storage for the given number of bodies.
+ *
+ * \param capacity The number of bodies.
+ * \return void
+ */
+inline void SoABodyStorage::reserve( size_type capacity )
+{
+   sid_.reserve( capacity );
+   position_.reserve( capacity );
+   orientation_.reserve( capacity );
+   linearVel_.reserve( capacity );
+   angularVel_.reserve( capacity );
+   force_.reserve( capacity );
+   torque_.reserve( capacity );
+   invMass_.reserve( capacity );
+   invBodyInertia_.reserve( capacity );
+   shape_.reserve( capacity );
+   bodyIDs_.reserve( capacity );
+}
+//*************************************************************************************************
+
+
+
+
+//=================================================================================================
+//
+//  ADD/REMOVE FUNCTIONS
+//
+//=================================================================================================
+
+//*************************************************************************************************
+/*!\brief Adding a rigid body to the body storage.
+ *
+ * \param sid The unique system-specific ID of the body.
+ * \param position The global position of the center of mass.
+ * \param orientation The orientation of the body.
+ * \param linearVel The linear velocity.
+ * \param angularVel The angular velocity.
+ * \param invMass The inverse mass (zero for bodies with infinite mass).
+ * \param invBodyInertia The inverse moment of inertia within the body frame.
+ * \param shape The index of the shape of the body (see addShape()).
+ * \return The index of the new body.
+ *
+ * The force and torque of the new body are zero.
+ */
+inline SoABodyStorage::size_type SoABodyStorage::add( id_t sid, const Vec3& position, const Quat& orientation,
+                                                      const Vec3& linearVel, const Vec3& angularVel,
+                                                      real_t invMass, const Mat3& invBodyInertia, size_type shape )
+{
+   WALBERLA_ASSERT( bodyIDs_.find( sid ) == bodyIDs_.end(), "Body with same system ID already added." );
+   WALBERLA_ASSERT_LESS( shape, shapes_.size(), "Invalid shape index" );
+
+   const size_type index = size();
+   bodyIDs_[ sid ] = index;
+
+   sid_.push_back( sid );
+   position_.push_back( position );
+   orientation_.push_back( orientation );
+   linearVel_.push_back( linearVel );
+   angularVel_.push_back( angularVel );
+   force_.push_back( Vec3() );
+   torque_.push_back( Vec3() );
+   invMass_.push_back( invMass );
+   invBodyInertia_.push_back( invBodyInertia );
+   shape_.push_back( shape );
+
+   return index;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Adding (the state of) a rigid body to the body storage.
+ *
+ * \param body The rigid body.
+ * \return The index of the new body.
+ *
+ * The current force and torque of the body are copied, too.
+ */
+inline SoABodyStorage::size_type SoABodyStorage::add( ConstBodyID body )
+{
+   const size_type index = add( body->getSystemID(), body->getPosition(), body->getQuaternion(),
+                                body->getLinearVel(), body->getAngularVel(),
+                                body->getInvMass(), body->getInvBodyInertia(), addShape( getShape( body ) ) );
+   force_[index]  = body->getForce();
+   torque_[index] = body->getTorque();
+   return index;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Removing a rigid body from the body storage.
+ *
+ * \param sid The system ID of the body to be removed.
+ * \return void
+ *
+ * The last body of the storage is moved to the index of the removed body.
+ */
+inline void SoABodyStorage::remove( id_t sid )
+{
+   auto it = bodyIDs_.find( sid );
+   WALBERLA_ASSERT( it != bodyIDs_.end(), "The body's system ID was not registered." );
+
+   const size_type i    = it->second;
+   const size_type last = size() - 1;
+
+   bodyIDs_.erase( it );
+
+   if( i != last )
+   {
+      bodyIDs_[ sid_[last] ] = i;
+
+      sid_[i]            = sid_[last];
+      position_[i]       = position_[last];
+      orientation_[i]    = orientation_[last];
+      linearVel_[i]      = linearVel_[last];
+      angularVel_[i]     = angularVel_[last];
+      force_[i]          = force_[last];
+      torque_[i]         = torque_[last];
+      invMass_[i]        = invMass_[last];
+      invBodyInertia_[i] = invBodyInertia_[last];
+      shape_[i]          = shape_[last];
+   }
+
+   sid_.pop_back();
+   position_.pop_back();
+   orientation_.pop_back();
+   linearVel_.pop_back();
+   angularVel_.pop_back();
+   force_.pop_back();
+   torque_.pop_back();
+   invMass_.pop_back();
+   invBodyInertia_.pop_back();
+   shape_.pop_back();
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Removing all rigid bodies from the body storage.
+ *
+ * \return void
+ *
+ * The shape table is kept.
+ */
+inline void SoABodyStorage::clear()
+{
+   sid_.clear();
+   position_.clear();
+   orientation_.clear();
+   linearVel_.clear();
+   angularVel_.clear();
+   force_.clear();
+   torque_.clear();
+   invMass_.clear();
+   invBodyInertia_.clear();
+   shape_.clear();
+   bodyIDs_.clear();
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Replaces the content of this storage by the state of all bodies of a BodyStorage.
+ *
+ * \param storage The body storage.
+ * \return void
+ *
+ * The bodies are stored in the order of the body storage.
+ */
+inline void SoABodyStorage::load( const BodyStorage& storage )
+{
+   clear();
+   reserve( storage.size() );
+   for( auto it = storage.begin(); it != storage.end(); ++it )
+      add( it.getBodyID() );
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Writes the state of the bodies back to the corresponding bodies of a BodyStorage.
+ *
+ * \param storage The body storage.
+ * \return void
+ *
+ * Position, orientation and velocities are only written for bodies with finite mass, forces and
+ * torques are written for all bodies. Bodies of \a storage that are not stored in this storage are
+ * not changed.
+ */
+inline void SoABodyStorage::store( BodyStorage& storage ) const
+{
+   for( auto it = storage.begin(); it != storage.end(); ++it )
+   {
+      const size_type i = find( it->getSystemID() );
+      if( i == size() )
+         continue;
+
+      if( !it->hasInfiniteMass() )
+      {
+         it->setPosition   ( position_[i] );
+         it->setOrientation( orientation_[i] );
+         it->setLinearVel  ( linearVel_[i] );
+         it->setAngularVel ( angularVel_[i] );
+      }
+      it->setForce ( force_[i] );
+      it->setTorque( torque_[i] );
+   }
+}
+//*************************************************************************************************
+
+
+
+
+//=================================================================================================
+//
+//  SHAPE FUNCTIONS
+//
+//=================================================================================================
+
+//*************************************************************************************************
+/*!\brief Adding a shape to the shape table.
+ *
+ * \param shape The shape.
+ * \return The index of the shape in the shape table.
+ *
+ * If an equal shape is already stored, its index is returned. The lookup takes constant time, hence
+ * loading polydisperse bodies (e.g. spheres with random radii) scales linearly with the number of bodies.
+ */
+inline SoABodyStorage::size_type SoABodyStorage::addShape( const Shape& shape )
+{
+   auto it = shapeIndices_.find( shape );
+   if( it != shapeIndices_.end() )
+      return it->second;
+
+   shapes_.push_back( shape );
+   shapeIndices_.insert( std::make_pair( shape, shapes_.size() - 1 ) );
+   return shapes_.size() - 1;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Exact comparison of two shapes.
+ *
+ * \param other The shape to compare with.
+ * \return \a true if the type IDs and all parameters are identical, \a false otherwise.
+ *
+ * The parameters are compared exactly (in contrast to the tolerance of Vec3::operator==), which is
+ * consistent with ShapeHash. -0 and +0 compare equal, as they share the same hash value.
+ */
+inline bool SoABodyStorage::Shape::operator==( const Shape& other ) const
+{
+   if( typeID != other.typeID )
+      return false;
+   for( uint_t i = 0; i < 3; ++i )
+   {
+      if( !isIdentical( parameters[i], other.parameters[i] ) )
+         return false;
+   }
+   return true;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Returns the hash value of a shape.
+ *
+ * \param shape The shape.
+ * \return The hash value combining the type ID and the geometric parameters.
+ */
+inline std::size_t SoABodyStorage::ShapeHash::operator()( const Shape& shape ) const
+{
+   std::size_t seed = std::hash<id_t>()( shape.typeID );
+   for( uint_t i = 0; i < 3; ++i )
+   {
+      // adding zero maps -0 to +0, which compare equal but have different bit patterns
+      const real_t parameter = shape.parameters[i] + real_t(0);
+      seed ^= std::hash<real_t>()( parameter ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+   }
+   return seed;
+}
+//*************************************************************************************************
+
+
+//*************************************************************************************************
+/*!\brief Returns the shape of a rigid body.
+ *
+ * \param body The rigid body.
+ * \return The shape of the body.
+ */
+inline SoABodyStorage::Shape SoABodyStorage::getShape( ConstBodyID body )
+{
+   Shape shape = { body->getTypeID(), Vec3() };
+
+   if( shape.typeID == Sphere::getStaticTypeID() )
+   {
+      shape.parameters[0] = static_cast<ConstSphereID>( body )->getRadius();
+   }
+   else if( shape.typeID == Box::getStaticTypeID() )
+   {
+      shape.parameters = static_cast<ConstBoxID>( body )->getLengths();
+   }
+   else if( shape.typeID == Ellipsoid::getStaticTypeID() )
+   {
+      shape.parameters = static_cast<ConstEllipsoidID>( body )->getSemiAxes();
+   }
+   else if( shape.typeID == Capsule::getStaticTypeID() )
+   {
+      shape.parameters[0] = static_cast<ConstCapsuleID>( body )->getRadius();
+      shape.parameters[1] = static_cast<ConstCapsuleID>( body )->getLength();
+   }
+
+   return shape;
+}
+//*************************************************************************************************
+
+}  // namespace pe
+}  // namespace walberla
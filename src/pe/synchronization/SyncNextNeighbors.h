@@ -26,6 +26,7 @@
 #include "pe/communication/ParseMessage.h"
 #include "pe/communication/DynamicMarshalling.h"
 #include "pe/communication/RigidBodyCopyNotification.h"
+#include "pe/communication/RigidBodyDeltaUpdateNotification.h"
 #include "pe/communication/RigidBodyDeletionNotification.h"
 #include "pe/communication/RigidBodyForceNotification.h"
 #include "pe/communication/RigidBodyMigrationNotification.h"
@@ -47,7 +48,7 @@ namespace walberla {
 namespace pe {
 
 template <typename BodyTypeTuple>
-void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, BodyStorage& localStorage, BodyStorage& shadowStorage, const real_t dx, const bool syncNonCommunicatingBodies)
+void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, BodyStorage& localStorage, BodyStorage& shadowStorage, const real_t dx, const bool syncNonCommunicatingBodies, const bool deltaUpdates = false, const real_t deltaTolerance = real_t(0))
 {
    using namespace walberla::pe::communication;
 
@@ -105,6 +106,9 @@ void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, B
 
       WALBERLA_LOG_DETAIL( "Processing local body " << b->getSystemID() );
 
+      // quantities which changed since the last delta-encoded update (all registered shadow copies share this state)
+      const uint8_t changedFields = deltaUpdates ? RigidBodyDeltaUpdateNotification::changedFields( *b, deltaTolerance ) : uint8_t(0);
+
       // Update (nearest) neighbor processes.
       for( uint_t nb = uint_t(0); nb < block.getNeighborhoodSize(); ++nb )
       {
@@ -114,11 +118,28 @@ void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, B
             // The body is needed by the process.
 
             if( body->MPITrait.isShadowOwnerRegistered( nbProcess ) ) {
-               mpi::SendBuffer& buffer( bs.sendBuffer(nbProcess.rank_) );
+               if( deltaUpdates ) {
+                  // bodies at rest are skipped entirely, if everything changed the mask is not needed
+                  if( changedFields == RigidBodyDeltaUpdateNotification::ALL ) {
+                     mpi::SendBuffer& buffer( bs.sendBuffer(nbProcess.rank_) );
+
+                     WALBERLA_LOG_DETAIL( "Sending update notification for body " << b->getSystemID() << " to process " << (nbProcess) );
+
+                     packNotification(me, nbProcess, buffer, RigidBodyUpdateNotification( *b ));
+                  } else if( changedFields != 0 ) {
+                     mpi::SendBuffer& buffer( bs.sendBuffer(nbProcess.rank_) );
+
+                     WALBERLA_LOG_DETAIL( "Sending delta update notification for body " << b->getSystemID() << " to process " << (nbProcess) );
+
+                     packNotification(me, nbProcess, buffer, RigidBodyDeltaUpdateNotification( *b, changedFields ));
+                  }
+               } else {
+                  mpi::SendBuffer& buffer( bs.sendBuffer(nbProcess.rank_) );
 
-               WALBERLA_LOG_DETAIL( "Sending update notification for body " << b->getSystemID() << " to process " << (nbProcess) );
+                  WALBERLA_LOG_DETAIL( "Sending update notification for body " << b->getSystemID() << " to process " << (nbProcess) );
 
-               packNotification(me, nbProcess, buffer, RigidBodyUpdateNotification( *b ));
+                  packNotification(me, nbProcess, buffer, RigidBodyUpdateNotification( *b ));
+               }
             }
             else {
                mpi::SendBuffer& buffer( bs.sendBuffer(nbProcess.rank_) );
@@ -234,6 +255,7 @@ void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, B
             }
 
             b->MPITrait.clearShadowOwners();
+            b->MPITrait.clearSyncState();
 
             continue;
          }
@@ -241,6 +263,12 @@ void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, B
       {
          // Body still is locally owned after position update.
          WALBERLA_LOG_DETAIL( "Owner of body " << b->getSystemID() << " is still process " << body->MPITrait.getOwner() );
+
+         // remember the state of the shadow copies for the next delta-encoded update
+         if( deltaUpdates && b->MPITrait.hasShadowOwners() )
+            RigidBodyDeltaUpdateNotification::updateSyncState( *b, changedFields );
+         else
+            b->MPITrait.clearSyncState();
       }
 
       ++body;
@@ -249,8 +277,9 @@ void generateSynchonizationMessages(mpi::BufferSystem& bs, const Block& block, B
    WALBERLA_LOG_DETAIL( "Assembling of body synchronization message ended." );
 }
 
+namespace internal {
 template <typename BodyTypeTuple>
-void syncNextNeighbors( BlockForest& forest, BlockDataID storageID, WcTimingTree* tt = NULL, const real_t dx = real_t(0), const bool syncNonCommunicatingBodies = false )
+int64_t syncNextNeighbors( BlockForest& forest, BlockDataID storageID, WcTimingTree* tt, const real_t dx, const bool syncNonCommunicatingBodies, const bool deltaUpdates, const real_t deltaTolerance = real_t(0) )
 {
    if (tt != NULL) tt->start("Sync");
    if (tt != NULL) tt->start("Assembling Body Synchronization");
@@ -272,7 +301,7 @@ void syncNextNeighbors( BlockForest& forest, BlockDataID storageID, WcTimingTree
             bs.sendBuffer(neighborRank) << walberla::uint8_c(0);
          }
       }
-      generateSynchonizationMessages<BodyTypeTuple>(bs, *block, *localStorage, *shadowStorage, dx, syncNonCommunicatingBodies);
+      generateSynchonizationMessages<BodyTypeTuple>(bs, *block, *localStorage, *shadowStorage, dx, syncNonCommunicatingBodies, deltaUpdates, deltaTolerance);
    }
    if (tt != NULL) tt->stop("Assembling Body Synchronization");
 
@@ -305,7 +334,46 @@ void syncNextNeighbors( BlockForest& forest, BlockDataID storageID, WcTimingTree
    WALBERLA_LOG_DETAIL( "Parsing of body synchronization response ended." );
    if (tt != NULL) tt->stop("Parsing Body Synchronization");
    if (tt != NULL) tt->stop("Sync");
+
+   WALBERLA_LOG_DETAIL( "Body synchronization sent " << bs.getBytesSent() << " bytes." );
+   return bs.getBytesSent();
+}
+}
+
+template <typename BodyTypeTuple>
+void syncNextNeighbors( BlockForest& forest, BlockDataID storageID, WcTimingTree* tt = NULL, const real_t dx = real_t(0), const bool syncNonCommunicatingBodies = false )
+{
+   internal::syncNextNeighbors<BodyTypeTuple>( forest, storageID, tt, dx, syncNonCommunicatingBodies, false );
+}
+
+//*************************************************************************************************
+/*!\brief Same as syncNextNeighbors() but with delta-encoded shadow copy updates.
+ *
+ * \param tolerance Changes of at most \a tolerance in every component of a quantity are not sent.
+ * \return The number of bytes sent by this process.
+ *
+ * Instead of the full state only the quantities (position, orientation, linear and angular
+ * velocity) which changed since the last call are sent to already existing shadow copies.
+ * Bodies whose state did not change, e.g., bodies at rest or bodies which stay asleep, are not
+ * sent at all. Bodies whose quantities all changed are sent with a regular update notification,
+ * so the delta-encoded updates never send more data than syncNextNeighbors().
+ *
+ * With the default tolerance of zero the comparison is exact, so the shadow copies end up in the
+ * same state as with syncNextNeighbors(). This relies on the shadow copies only being modified by
+ * the synchronization, or in the same way as their owners (as done by the collision response
+ * algorithms). With a positive tolerance every component of a shadow copy differs by at most
+ * \a tolerance from its owner, since the comparison is done against the state that was sent last.
+ *
+ * The state sent last is stored with each locally owned body which has shadow copies. Both
+ * synchronization variants can be mixed, syncNextNeighbors() resets this state.
+ */
+template <typename BodyTypeTuple>
+int64_t syncNextNeighborsDelta( BlockForest& forest, BlockDataID storageID, WcTimingTree* tt = NULL, const real_t dx = real_t(0), const bool syncNonCommunicatingBodies = false,
+                                const real_t tolerance = real_t(0) )
+{
+   return internal::syncNextNeighbors<BodyTypeTuple>( forest, storageID, tt, dx, syncNonCommunicatingBodies, true, tolerance );
 }
+//*************************************************************************************************
 
 }  // namespace pe
 }  // namespace walberla
@@ -0,0 +1,93 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//! \file SortBodies.cpp
+//
+//======================================================================================================================
+
+#include "SortBodies.h"
+
+#include <pe/rigidbody/BodyStorage.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace walberla {
+namespace pe {
+
+namespace {
+/// spreads the lower 21 bits of \a x such that two zero bits lie between two consecutive bits
+uint64_t spreadBits( uint64_t x )
+{
+   x &= 0x1fffff;
+   x = (x | x << 32) & 0x1f00000000ffff;
+   x = (x | x << 16) & 0x1f0000ff0000ff;
+   x = (x | x << 8)  & 0x100f00f00f00f00f;
+   x = (x | x << 4)  & 0x10c30c30c30c30c3;
+   x = (x | x << 2)  & 0x1249249249249249;
+   return x;
+}
+}
+
+uint64_t getMortonKey( const Vec3& pos, const math::AABB& aabb )
+{
+   const real_t maxCoordinate = real_c( ( uint64_t(1) << 21 ) - 1 );
+
+   uint64_t key = 0;
+   for( uint_t d = 0; d < 3; ++d )
+   {
+      const real_t extent = aabb.max(d) - aabb.min(d);
+      real_t c = extent > real_t(0) ? ( pos[d] - aabb.min(d) ) / extent * maxCoordinate : real_t(0);
+      c = std::min( std::max( c, real_t(0) ), maxCoordinate );
+      key |= spreadBits( static_cast<uint64_t>( c ) ) << d;
+   }
+   return key;
+}
+
+void sortBodies( BodyStorage& storage )
+{
+   if( storage.size() < 2 ) return;
+
+   math::AABB bounds( storage.front().getPosition(), storage.front().getPosition() );
+   for( auto bodyIt = storage.begin(); bodyIt != storage.end(); ++bodyIt )
+      bounds.merge( bodyIt->getPosition() );
+
+   // every key is computed once, the index makes the order of bodies with equal keys deterministic
+   std::vector< std::pair<uint64_t, BodyStorage::size_type> > keys;
+   keys.reserve( storage.size() );
+   for( auto bodyIt = storage.begin(); bodyIt != storage.end(); ++bodyIt )
+      keys.push_back( std::make_pair( getMortonKey( bodyIt->getPosition(), bounds ), keys.size() ) );
+   std::sort( keys.begin(), keys.end() );
+
+   std::vector<BodyStorage::size_type> order( keys.size() );
+   for( size_t i = 0; i < keys.size(); ++i )
+      order[i] = keys[i].second;
+   storage.reorder( order );
+}
+
+void sortBodies( domain_decomposition::BlockStorage& bs, const BlockDataID& storageID )
+{
+   for( auto& block : bs )
+   {
+      Storage& storage = *block.getData< Storage >( storageID );
+      sortBodies( storage[0] );
+      sortBodies( storage[1] );
+   }
+}
+
+}  // namespace pe
+}  // namespace walberla
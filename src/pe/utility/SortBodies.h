@@ -0,0 +1,48 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//! \file SortBodies.h
+//
+//======================================================================================================================
+
+#pragma once
+
+#include <core/DataTypes.h>
+#include <core/math/AABB.h>
+#include <domain_decomposition/BlockStorage.h>
+#include <pe/Types.h>
+
+namespace walberla {
+namespace pe {
+
+/// Returns the key of \a pos on a Morton (Z-order) curve through \a aabb (21 bits per dimension).
+/// Positions outside of \a aabb are clamped to its boundary.
+uint64_t getMortonKey( const Vec3& pos, const math::AABB& aabb );
+
+/// Sorts the bodies of \a storage along a Morton curve through the bounding box of their positions,
+/// such that bodies which are close in space are also close in the iteration order of the storage.
+/// Only the order changes, the bodies are not moved in memory (see BodyStorage::reorder()), so
+/// sorting alone does not speed up functions that operate on the storage. It is meant to be called
+/// before building data by iterating over the storage: e.g. the arrays of a SoABodyStorage that is
+/// filled with SoABodyStorage::load() inherit the spatial order.
+void sortBodies( BodyStorage& storage );
+
+/// Sorts the local and shadow bodies of all blocks, see sortBodies( BodyStorage& ).
+/// \attention Per-body data indexed by the storage position has to be rebuilt afterwards.
+void sortBodies( domain_decomposition::BlockStorage& bs, const BlockDataID& storageID );
+
+}  // namespace pe
+}  // namespace walberla
@@ -0,0 +1,137 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file CPUFeatures.h
+//! \ingroup simd
+//! \brief Runtime detection of the SIMD instruction sets supported by the CPU
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "SIMD.h"
+
+#include <iterator>
+
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define WALBERLA_SIMD_CPU_DETECTION 1
+#endif
+
+
+#ifdef WALBERLA_SIMD_CPU_DETECTION
+/// compiles a function for the given instruction set(s) independent of the compiler flags, e.g. WALBERLA_SIMD_TARGET( "avx2,fma" ),
+/// the function must only be called if the CPU supports the instruction set(s)
+#define WALBERLA_SIMD_TARGET( isa ) __attribute__(( target( isa ) ))
+/// forces inlining, hence the function is compiled for the instruction set of the WALBERLA_SIMD_TARGET function it is called from
+#define WALBERLA_SIMD_INLINE __attribute__(( always_inline )) inline
+#else
+#define WALBERLA_SIMD_INLINE inline
+#endif
+
+
+namespace walberla {
+namespace simd {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   The instruction set that is used by the simd:: functions is selected at compile time (see SIMD.h). The functions
+*   in this file query the CPU the program is actually running on (via cpuid). This allows, for example, kernels to
+*   fall back to a scalar code path if the binary is executed on a machine that does not support the instruction set
+*   the code was compiled for, to select one of several kernels that are compiled for different instruction sets via
+*   WALBERLA_SIMD_TARGET (see lbm::SIMDSweep), and to report the instruction sets in performance logs.
+*
+*   There is no simd:: backend for AVX512, so AVX512 is never the compile time instruction set. At runtime, AVX512
+*   stands for AVX-512F, which matches WALBERLA_SIMD_TARGET( "avx512f" ).
+*
+*   On platforms without runtime detection support, the compile time instruction set is assumed to be available.
+*/
+//**********************************************************************************************************************
+
+enum InstructionSet { SCALAR = 0, SSE2 = 1, SSE4 = 2, AVX = 3, AVX2 = 4, AVX512 = 5, QPX = 6 };
+
+inline const char * instructionSetName( const InstructionSet is )
+{
+   switch( is )
+   {
+   case SSE2:   return "SSE2";
+   case SSE4:   return "SSE4";
+   case AVX:    return "AVX";
+   case AVX2:   return "AVX2";
+   case AVX512: return "AVX512";
+   case QPX:    return "QPX";
+   default:     return "scalar emulation";
+   }
+}
+
+/// instruction set used by the simd:: functions (selected at compile time)
+inline InstructionSet compiledInstructionSet()
+{
+#if   defined( WALBERLA_USE_AVX2 )
+   return AVX2;
+#elif defined( WALBERLA_USE_AVX )
+   return AVX;
+#elif defined( WALBERLA_USE_SSE4 )
+   return SSE4;
+#elif defined( WALBERLA_USE_SSE2 )
+   return SSE2;
+#elif defined( WALBERLA_USE_QPX )
+   return QPX;
+#else
+   return SCALAR;
+#endif
+}
+
+/// returns true if the CPU the program is running on supports instruction set 'is'
+inline bool cpuSupports( const InstructionSet is )
+{
+#ifdef WALBERLA_SIMD_CPU_DETECTION
+   switch( is )
+   {
+   case SSE2:   return __builtin_cpu_supports( "sse2" ) != 0;
+   case SSE4:   return __builtin_cpu_supports( "sse4.2" ) != 0;
+   case AVX:    return __builtin_cpu_supports( "avx" ) != 0;
+   case AVX2:   return __builtin_cpu_supports( "avx2" ) != 0;
+   case AVX512: return __builtin_cpu_supports( "avx512f" ) != 0;
+   case QPX:    return false;
+   default:     return true;
+   }
+#else
+   return is == SCALAR || is == compiledInstructionSet();
+#endif
+}
+
+/// best instruction set supported by the CPU the program is running on (independent of the compile time selection)
+inline InstructionSet detectInstructionSet()
+{
+   const InstructionSet candidates[] = { AVX512, AVX2, AVX, SSE4, SSE2, QPX };
+   for( auto is = std::begin( candidates ); is != std::end( candidates ); ++is )
+      if( cpuSupports( *is ) )
+         return *is;
+   return SCALAR;
+}
+
+/// returns true if the instruction set selected at compile time can be executed on this CPU
+inline bool compiledInstructionSetSupported()
+{
+   return cpuSupports( compiledInstructionSet() );
+}
+
+
+
+} // namespace simd
+} // namespace walberla
@@ -0,0 +1,117 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file CommunicationOverlap.h
+//! \ingroup timeloop
+//! \brief Overlapping of ghost layer communication with the computation of the block interior
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "SweepTimeloop.h"
+
+#include "core/timing/TimingPool.h"
+#include "domain_decomposition/InnerOuterSplit.h"
+
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+
+namespace walberla {
+namespace timeloop {
+
+
+
+namespace internal {
+inline std::string overlapTimerName( const std::string & identifier, const std::string & part ) { return identifier + " (" + part + ")"; }
+}
+
+
+
+/// Registers two consecutive sweeps at the timeloop: first, the communication is started and the inner part of the
+/// split sweep is executed on all blocks, then, the communication is finished and the outer part is executed. The
+/// communication functions are typically obtained from blockforest::communication::UniformBufferedScheme via
+/// getStartCommunicateFunctor() and getWaitFunctor(). When the timeloop is run with a WcTimingPool, the four parts
+/// are timed separately and can be evaluated with evaluateCommunicationOverlap.
+inline void addOverlappingSweep( SweepTimeloop & timeloop, const std::function< void () > & startCommunication,
+                                 const std::function< void () > & waitForCommunication, const InnerOuterSplit & split,
+                                 const std::string & identifier )
+{
+   timeloop.add() << BeforeFunction( startCommunication, internal::overlapTimerName( identifier, "communication start" ) )
+                  << Sweep( split.inner(), internal::overlapTimerName( identifier, "inner" ) );
+   timeloop.add() << BeforeFunction( waitForCommunication, internal::overlapTimerName( identifier, "communication wait" ) )
+                  << Sweep( split.outer(), internal::overlapTimerName( identifier, "outer" ) );
+}
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Times (in seconds) of the four parts registered by addOverlappingSweep
+*
+*   While the inner part is computed, messages are in flight. The time the process still has to wait for the
+*   communication to finish afterwards is communication that could not be hidden. Hence, the achieved overlap is the
+*   fraction of the time between starting and finishing the communication that was spent on computing the inner part:
+*   overlap = inner / ( inner + wait ). An overlap of 1 means that the communication was completely hidden.
+*/
+//**********************************************************************************************************************
+
+struct CommunicationOverlap
+{
+   CommunicationOverlap() : start( 0.0 ), inner( 0.0 ), wait( 0.0 ), outer( 0.0 ) {}
+
+   double start;
+   double inner;
+   double wait;
+   double outer;
+
+   double overlap() const { return ( inner + wait > 0.0 ) ? inner / ( inner + wait ) : 0.0; }
+};
+
+inline CommunicationOverlap evaluateCommunicationOverlap( const WcTimingPool & timing, const std::string & identifier )
+{
+   auto total = [&]( const std::string & part ) {
+      const std::string name = internal::overlapTimerName( identifier, part );
+      return timing.timerExists( name ) ? timing[ name ].total() : 0.0;
+   };
+
+   CommunicationOverlap result;
+   result.start = total( "communication start" );
+   result.inner = total( "inner" );
+   result.wait  = total( "communication wait" );
+   result.outer = total( "outer" );
+   return result;
+}
+
+inline std::ostream & operator<<( std::ostream & os, const CommunicationOverlap & o )
+{
+   const std::ios_base::fmtflags flags = os.flags();
+   const std::streamsize precision = os.precision();
+
+   os << "communication start: " << o.start << " s, inner: " << o.inner << " s, communication wait: " << o.wait
+      << " s, outer: " << o.outer << " s -> overlap " << std::fixed << std::setprecision(1) << ( 100.0 * o.overlap() ) << " %";
+
+   os.flags( flags );
+   os.precision( precision );
+   return os;
+}
+
+
+
+} // namespace timeloop
+} // namespace walberla
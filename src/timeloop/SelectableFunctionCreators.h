@@ -185,6 +185,7 @@ namespace timeloop {
 
    private:
       friend class SweepTimeloop;
+      friend class ThreadTeamTimeloop;
 
       BlockStorage & bs_;
 
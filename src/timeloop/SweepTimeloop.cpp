@@ -66,7 +66,7 @@ void SweepTimeloop::doTimeStep(const Set<SUID> &selectors)
             WALBERLA_LOG_PROGRESS("Running sweep \"" << sweepName << "\" on block " << bi->getId() );
          }
 
-         (selectedSweep->function_)( bi.get() );
+         runSweep( *selectedSweep, bi.get() );
       }
 
       // select and execute after functions
@@ -119,7 +119,7 @@ void SweepTimeloop::doTimeStep(const Set<SUID> &selectors, WcTimingPool &timing)
 
          // loop over all blocks
          timing[sweepName].start();
-            (selectedSweep->function_)( bi.get() );
+            runSweep( *selectedSweep, bi.get() );
          timing[sweepName].end();
       }
 
@@ -24,6 +24,7 @@
 
 #include "SelectableFunctionCreators.h"
 #include "Timeloop.h"
+#include "core/timing/WcPolicy.h"
 #include "domain_decomposition/StructuredBlockStorage.h"
 
 #include <functional>
@@ -157,6 +158,23 @@ namespace timeloop {
       //@}
       //****************************************************************************************************************
 
+
+
+      //****************************************************************************************************************
+      /*!\name Per-block timing */
+      //@{
+
+      /// Function that is called after every execution of a sweep on a block with the wall time (in seconds) the
+      /// sweep took on this block, e.g., blockforest::MeasuredCostLoadBalancing::getRecordingFunction().
+      /// ThreadTeamTimeloop calls this function concurrently for different blocks.
+      typedef std::function< void ( IBlock * block, const double seconds ) > BlockTimingFunction;
+
+      /// Registers a function that records the wall time of every sweep on every block (no timing if empty)
+      void setBlockTimingFunction( const BlockTimingFunction & function ) { blockTimingFunction_ = function; }
+
+      //@}
+      //****************************************************************************************************************
+
    protected:
       BlockStorage & blockStorage_;
 
@@ -174,9 +192,28 @@ namespace timeloop {
       std::map< uint_t,SweepAdder* > sweeps_;
 
       bool firstRun_; ///< required to register timer in doTimeStep( selectors, timingPool)
+
+      BlockTimingFunction blockTimingFunction_;
+
+      inline void runSweep( Sweep & sweep, IBlock * const block );
    };
 
 
+
+   inline void SweepTimeloop::runSweep( Sweep & sweep, IBlock * const block )
+   {
+      if( !blockTimingFunction_ )
+      {
+         (sweep.function_)( block );
+         return;
+      }
+
+      const double start = timing::WcPolicy::getTimestamp();
+      (sweep.function_)( block );
+      blockTimingFunction_( block, timing::WcPolicy::getTimestamp() - start );
+   }
+
+
 } // namespace timeloop
 } // namespace walberla
 
@@ -0,0 +1,309 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file ThreadTeamTimeloop.cpp
+//! \ingroup timeloop
+//
+//======================================================================================================================
+
+#include "ThreadTeamTimeloop.h"
+#include "core/Abort.h"
+#include "core/OpenMP.h"
+
+
+namespace walberla {
+namespace timeloop {
+
+
+namespace internal {
+
+inline uint_t threadNumber()
+{
+#ifdef _OPENMP
+   return uint_c( omp_get_thread_num() );
+#else
+   return uint_t(0);
+#endif
+}
+
+inline uint_t numberOfThreads()
+{
+#ifdef _OPENMP
+   return uint_c( omp_get_num_threads() );
+#else
+   return uint_t(1);
+#endif
+}
+
+} // namespace internal
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////   Setup   ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+void ThreadTeamTimeloop::assignBlocksToThreads()
+{
+   std::vector< IBlock * > blocks;
+   for( auto block = blockStorage_.begin(); block != blockStorage_.end(); ++block )
+      blocks.push_back( block.get() );
+
+#ifdef _OPENMP
+   const uint_t numThreads = uint_c( omp_get_max_threads() );
+#else
+   const uint_t numThreads = uint_t(1);
+#endif
+
+   // contiguous chunks: neighboring blocks in the block storage are likely to be neighbors in space
+   threadBlocks_.assign( numThreads, std::vector< IBlock * >() );
+   for( uint_t t = 0; t != numThreads; ++t )
+   {
+      const uint_t begin = ( t * blocks.size() ) / numThreads;
+      const uint_t end   = ( ( t + uint_t(1) ) * blocks.size() ) / numThreads;
+      threadBlocks_[t].assign( blocks.begin() + numeric_cast< std::ptrdiff_t >( begin ), blocks.begin() + numeric_cast< std::ptrdiff_t >( end ) );
+   }
+}
+
+
+void ThreadTeamTimeloop::registerTimers( WcTimingPool & timing )
+{
+   // see SweepTimeloop::doTimeStep: all timing pools have to contain the same timers on all processes
+   if ( firstRun_ || timing.empty() )
+   {
+      for( auto sweepIt = sweeps_.begin(); sweepIt != sweeps_.end(); ++sweepIt )
+      {
+         SweepAdder & s = * ( sweepIt->second );
+         for( auto it = s.sweep.begin(); it != s.sweep.end(); ++it )
+            timing.registerTimer( it.identifier() );
+      }
+      firstRun_ = false;
+   }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////   Execution of Timeloop  ///////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+void ThreadTeamTimeloop::run( const bool logTimeStep )
+{
+   runTeam( nullptr, logTimeStep );
+}
+
+
+void ThreadTeamTimeloop::run( WcTimingPool & timing, const bool logTimeStep )
+{
+   runTeam( &timing, logTimeStep );
+}
+
+
+void ThreadTeamTimeloop::runTeam( WcTimingPool * timing, const bool logTimeStep )
+{
+   WALBERLA_LOG_PROGRESS( "Running thread team timeloop for " << nrOfTimeSteps_ << " time steps" );
+
+   removeForDeletionMarkedSweeps();
+   assignBlocksToThreads();
+   if( timing != nullptr )
+      registerTimers( *timing );
+
+   bool stopped = false;
+
+#ifdef _OPENMP
+   #pragma omp parallel num_threads( int_c( threadBlocks_.size() ) )
+#endif
+   {
+      while( true )
+      {
+#ifdef _OPENMP
+         #pragma omp master
+#endif
+         {
+            running_ = !stopped && curTimeStep_ < nrOfTimeSteps_;
+            if( running_ )
+            {
+               loggingStamp_.reset( new LoggingStampManager( make_shared<LoggingStamp>( *this ), logTimeStep ) );
+               WALBERLA_LOG_PROGRESS( "Running time step " << curTimeStep_ );
+
+               selectors_ = uid::globalState();
+               for( size_t i = 0; i < beforeFunctions_.size(); ++i )
+               {
+                  if( timing != nullptr )
+                     executeSelectable( beforeFunctions_[i], selectors_, "Pre-Timestep Function", *timing );
+                  else
+                     executeSelectable( beforeFunctions_[i], selectors_, "Pre-Timestep Function" );
+               }
+            }
+         }
+#ifdef _OPENMP
+         #pragma omp barrier
+#endif
+         if( !running_ )
+            break;
+
+         teamTimeStep( selectors_, timing );
+
+#ifdef _OPENMP
+         #pragma omp master
+#endif
+         {
+            for( size_t i = 0; i < afterFunctions_.size(); ++i )
+            {
+               if( timing != nullptr )
+                  executeSelectable( afterFunctions_[i], selectors_, "Post-Timestep Function", *timing );
+               else
+                  executeSelectable( afterFunctions_[i], selectors_, "Post-Timestep Function" );
+            }
+
+            ++curTimeStep_;
+            loggingStamp_.reset();
+
+            if( stop_ )
+            {
+               stop_ = false;
+               stopped = true;
+            }
+         }
+         // no thread may read running_ or selectors_ of the next time step before the master has written them, and
+         // without sweeps there is no other barrier between the two master sections
+#ifdef _OPENMP
+         #pragma omp barrier
+#endif
+      }
+   }
+
+   WALBERLA_LOG_PROGRESS( "Timeloop finished" );
+}
+
+
+/// Executes all sweeps of one time step, must be called by all threads of the team
+void ThreadTeamTimeloop::teamTimeStep( const Set<SUID> & selectors, WcTimingPool * timing )
+{
+   // num_threads() is only an upper bound: if the OpenMP runtime starts a smaller team (dynamic adjustment, thread
+   // limits, nested parallelism), the chunks of the missing threads are taken over by the threads of the team
+   const uint_t numThreads = internal::numberOfThreads();
+   std::vector< IBlock * > redistributedBlocks;
+   if( numThreads < threadBlocks_.size() )
+   {
+      for( uint_t t = internal::threadNumber(); t < threadBlocks_.size(); t += numThreads )
+         redistributedBlocks.insert( redistributedBlocks.end(), threadBlocks_[t].begin(), threadBlocks_[t].end() );
+   }
+   const std::vector< IBlock * > & blocks = ( numThreads < threadBlocks_.size() ) ? redistributedBlocks :
+                                                                                     threadBlocks_[ internal::threadNumber() ];
+
+   for( auto sweepIt = sweeps_.begin(); sweepIt != sweeps_.end(); ++sweepIt )
+   {
+      SweepAdder & s = * ( sweepIt->second );
+
+      if( !s.beforeFuncs.empty() )
+      {
+#ifdef _OPENMP
+         #pragma omp master
+#endif
+         {
+            for( size_t j = 0; j < s.beforeFuncs.size(); ++j )
+            {
+               if( timing != nullptr )
+                  executeSelectable( s.beforeFuncs[j].selectableFunc_, selectors, "Pre-Sweep Function", *timing );
+               else
+                  executeSelectable( s.beforeFuncs[j].selectableFunc_, selectors, "Pre-Sweep Function" );
+            }
+         }
+#ifdef _OPENMP
+         #pragma omp barrier
+#endif
+      }
+
+      // the master thread measures the time until all threads have finished the sweep
+      std::string timerName;
+      if( timing != nullptr && internal::threadNumber() == uint_t(0) && !blocks.empty() )
+      {
+         s.sweep.getUnique( selectors + blocks.front()->getState(), timerName );
+         (*timing)[ timerName ].start();
+      }
+
+      for( auto block = blocks.begin(); block != blocks.end(); ++block )
+      {
+         Sweep * selectedSweep = s.sweep.getUnique( selectors + (*block)->getState() );
+
+         if( !selectedSweep )
+            WALBERLA_ABORT("Selecting Sweep " << sweepIt->first << ": " <<
+                           "Ambiguous, or no sweep selected. Check your selector " <<
+                            selectors + (*block)->getState() << std::endl << s.sweep);
+
+         runSweep( *selectedSweep, *block );
+      }
+
+#ifdef _OPENMP
+      #pragma omp barrier
+#endif
+
+      if( !timerName.empty() )
+         (*timing)[ timerName ].end();
+
+      if( !s.afterFuncs.empty() )
+      {
+#ifdef _OPENMP
+         #pragma omp master
+#endif
+         {
+            for( size_t j = 0; j < s.afterFuncs.size(); ++j )
+            {
+               if( timing != nullptr )
+                  executeSelectable( s.afterFuncs[j].selectableFunc_, selectors, "Post-Sweep Function", *timing );
+               else
+                  executeSelectable( s.afterFuncs[j].selectableFunc_, selectors, "Post-Sweep Function" );
+            }
+         }
+#ifdef _OPENMP
+         #pragma omp barrier
+#endif
+      }
+   }
+}
+
+
+/// single time steps (Timeloop::singleStep) start a new thread team for the sweeps of the time step
+void ThreadTeamTimeloop::doTimeStep( const Set<SUID> & selectors )
+{
+   removeForDeletionMarkedSweeps();
+   assignBlocksToThreads();
+
+#ifdef _OPENMP
+   #pragma omp parallel num_threads( int_c( threadBlocks_.size() ) )
+#endif
+   teamTimeStep( selectors, nullptr );
+}
+
+
+void ThreadTeamTimeloop::doTimeStep( const Set<SUID> & selectors, WcTimingPool & timing )
+{
+   removeForDeletionMarkedSweeps();
+   assignBlocksToThreads();
+   registerTimers( timing );
+
+#ifdef _OPENMP
+   #pragma omp parallel num_threads( int_c( threadBlocks_.size() ) )
+#endif
+   teamTimeStep( selectors, &timing );
+}
+
+
+
+} // namespace timeloop
+} // namespace walberla
@@ -0,0 +1,147 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file ThreadTeamTimeloop.h
+//! \ingroup timeloop
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "SweepTimeloop.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace walberla {
+namespace timeloop {
+
+
+   //*******************************************************************************************************************
+   /*!\brief SweepTimeloop variant for hybrid MPI+OpenMP runs that keeps one persistent OpenMP thread team alive for
+    *        all time steps of run()
+    *
+    * The blocks of the process are assigned to the threads once (contiguous chunks in the order of the block storage,
+    * so that each thread always works on the same memory). If the OpenMP runtime starts fewer threads than
+    * omp_get_max_threads(), the chunks of the missing threads are processed by the threads of the team. Within a time step, every thread runs all sweeps on its
+    * own blocks, separated by barriers. All Before- and AfterFunctions of the sweeps as well as the functions that
+    * are registered before/after the time step are executed by the master thread only, i.e., MPI is only called by
+    * the master thread (MPI_THREAD_FUNNELED is sufficient). Hence, the only synchronization per time step are team
+    * barriers, there is no fork/join of thread teams.
+    *
+    * Sweeps must be safe to be called concurrently for different blocks. Sweep functors that allocate temporary data
+    * on first use (e.g., lbm sweeps without an explicitly given destination field) do not fulfill this requirement.
+    * OpenMP parallel regions that are opened within the sweeps are nested and are therefore executed by one thread.
+    *
+    * Local ghost layer copies can be executed by the owning threads as well: switch the communication scheme to the
+    * blockforest::SWEEP local communication mode and register its local communication sweep, e.g.
+      \code
+      UniformBufferedScheme< Stencil > comm( blocks );
+      comm.addPackInfo( ... );
+      comm.setLocalMode( blockforest::SWEEP );
+
+      ThreadTeamTimeloop timeloop( blocks, timesteps );
+      timeloop.add() << BeforeFunction( comm.getStartCommunicateFunctor(), "communication start" )
+                     << Sweep( comm.getLocalCommunicationSweep(), "local communication" );
+      timeloop.add() << BeforeFunction( comm.getWaitFunctor(), "communication wait" )
+                     << Sweep( streamCollide, "stream collide" );
+      \endcode
+    *
+    * The block structure must not change while run() is executed. Blocks are reassigned to the threads at the
+    * beginning of each call of run() / singleStep().
+    *
+    * \ingroup timeloop
+    */
+   //*******************************************************************************************************************
+   class ThreadTeamTimeloop : public SweepTimeloop
+   {
+   public:
+
+      //****************************************************************************************************************
+      /*!\name Constructor & Destructor */
+      //@{
+
+      ThreadTeamTimeloop( BlockStorage & blockStorage, uint_t nrOfTimeSteps )
+         : SweepTimeloop( blockStorage, nrOfTimeSteps ), running_( false )
+      {}
+
+      ThreadTeamTimeloop( const shared_ptr<StructuredBlockStorage> & structuredBlockStorage, uint_t nrOfTimeSteps )
+         : SweepTimeloop( structuredBlockStorage, nrOfTimeSteps ), running_( false )
+      {}
+
+      virtual ~ThreadTeamTimeloop() {}
+
+      //@}
+      //****************************************************************************************************************
+
+
+      //****************************************************************************************************************
+      /*!\name Execution Control */
+      //@{
+
+      virtual void run() { run( true ); }
+      void run( const bool logTimeStep );
+      void run( WcTimingPool & timing, const bool logTimeStep = true );
+
+      //@}
+      //****************************************************************************************************************
+
+
+      /// number of threads of the team (as used in the last call of run() / singleStep())
+      uint_t numberOfThreads() const { return uint_c( threadBlocks_.size() ); }
+
+      /// blocks that are processed by thread 'thread' (as assigned in the last call of run() / singleStep())
+      const std::vector< IBlock * > & blocksOfThread( const uint_t thread ) const
+      {
+         WALBERLA_ASSERT_LESS( thread, threadBlocks_.size() );
+         return threadBlocks_[ thread ];
+      }
+
+   protected:
+
+      virtual void doTimeStep( const Set<SUID> & selectors );
+      virtual void doTimeStep( const Set<SUID> & selectors, WcTimingPool & timing );
+
+      void runTeam( WcTimingPool * timing, const bool logTimeStep );
+
+      void assignBlocksToThreads();
+      void registerTimers( WcTimingPool & timing );
+
+      void teamTimeStep( const Set<SUID> & selectors, WcTimingPool * timing );
+
+      std::vector< std::vector< IBlock * > > threadBlocks_;
+
+      // state of the thread team, only written by the master thread
+      bool running_;
+      Set<SUID> selectors_;
+      std::unique_ptr< LoggingStampManager > loggingStamp_;
+   };
+
+
+} // namespace timeloop
+} // namespace walberla
+
+
+
+//======================================================================================================================
+//
+//  EXPORT
+//
+//======================================================================================================================
+
+namespace walberla {
+   using timeloop::ThreadTeamTimeloop;
+}
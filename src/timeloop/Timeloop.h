@@ -50,7 +50,7 @@ typedef std::function<void ()> VoidFctNoArguments;
 //*******************************************************************************************************************
 class Timeloop : public ITimeloop
 {
-private:
+protected:
 
    class LoggingStamp;
    friend class LoggingStamp;
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#include "CommunicationOverlap.h"
 #include "PerformanceMeter.h"
 #include "SelectableFunctionCreators.h"
 #include "SweepTimeloop.h"
+#include "ThreadTeamTimeloop.h"
 #include "Timeloop.h"
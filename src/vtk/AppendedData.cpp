@@ -0,0 +1,150 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file AppendedData.cpp
+//! \ingroup vtk
+//
+//======================================================================================================================
+
+#include "AppendedData.h"
+
+#include "core/Abort.h"
+#include "core/debug/Debug.h"
+
+#include <algorithm>
+
+#ifdef WALBERLA_BUILD_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+
+namespace walberla {
+namespace vtk {
+
+
+
+#ifdef WALBERLA_BUILD_WITH_ZLIB
+/// size of the blocks that are compressed individually (identical to the default of vtkZLibDataCompressor)
+static const uint64_t COMPRESSION_BLOCK_SIZE = uint64_t(32768);
+#endif
+
+
+
+void AppendedData::setCompression( const bool compress )
+{
+#ifndef WALBERLA_BUILD_WITH_ZLIB
+   if( compress )
+      WALBERLA_ABORT( "Compressed VTK output requires zlib! Reconfigure waLBerla with WALBERLA_BUILD_WITH_ZLIB=ON." );
+#endif
+   compress_ = compress;
+}
+
+
+
+std::string AppendedData::fileAttributes() const
+{
+   return compress_ ? std::string( " header_type=\"UInt64\" compressor=\"vtkZLibDataCompressor\"" ) :
+                      std::string( " header_type=\"UInt64\"" );
+}
+
+
+
+void AppendedData::writeFormat( std::ostream & os )
+{
+   os << "format=\"appended\" offset=\"";
+
+   const std::string offset = std::to_string( data_.size() );
+   offsetPositions_.emplace_back( uint_c( std::streamoff( os.tellp() ) ), uint_c( offset.size() ) );
+
+   os << offset << "\"";
+}
+
+
+
+void AppendedData::append( const std::vector< char > & data )
+{
+   auto appendUInt64 = [this]( const uint64_t value ) {
+      data_.append( reinterpret_cast< const char * >( &value ), sizeof( uint64_t ) );
+   };
+
+   if( !compress_ )
+   {
+      appendUInt64( uint64_c( data.size() ) );
+      data_.append( data.begin(), data.end() );
+      return;
+   }
+
+#ifdef WALBERLA_BUILD_WITH_ZLIB
+   // header: number of blocks, block size, size of the last (partial) block, compressed sizes of all blocks
+
+   const uint64_t bytes  = uint64_c( data.size() );
+   const uint64_t blocks = ( bytes + COMPRESSION_BLOCK_SIZE - uint64_t(1) ) / COMPRESSION_BLOCK_SIZE;
+
+   const std::size_t header = data_.size();
+   appendUInt64( blocks );
+   appendUInt64( COMPRESSION_BLOCK_SIZE );
+   appendUInt64( bytes % COMPRESSION_BLOCK_SIZE );
+   for( uint64_t b = 0; b != blocks; ++b )
+      appendUInt64( uint64_t(0) );
+
+   std::vector< Bytef > compressed( compressBound( uLong( COMPRESSION_BLOCK_SIZE ) ) );
+   for( uint64_t b = 0; b != blocks; ++b )
+   {
+      const uint64_t begin = b * COMPRESSION_BLOCK_SIZE;
+      const uint64_t size  = std::min( COMPRESSION_BLOCK_SIZE, bytes - begin );
+
+      uLongf compressedSize = uLongf( compressed.size() );
+      const int result = compress2( &(compressed[0]), &compressedSize, reinterpret_cast< const Bytef * >( &(data[ begin ]) ),
+                                    uLong( size ), Z_DEFAULT_COMPRESSION );
+      if( result != Z_OK )
+         WALBERLA_ABORT( "Error while compressing VTK output data (zlib error code " << result << ")" );
+
+      const uint64_t blockSize = uint64_c( compressedSize );
+      data_.replace( header + ( std::size_t(3) + b ) * sizeof( uint64_t ), sizeof( uint64_t ),
+                     reinterpret_cast< const char * >( &blockSize ), sizeof( uint64_t ) );
+      data_.append( reinterpret_cast< const char * >( &(compressed[0]) ), compressedSize );
+   }
+#endif
+}
+
+
+
+void AppendedData::toStream( std::ostream & os ) const
+{
+   os << beginTag();
+   os.write( data_.data(), std::streamsize( data_.size() ) );
+   os << endTag();
+}
+
+
+
+void AppendedData::shiftOffsets( std::string & xml, const uint_t base ) const
+{
+   if( base == uint_t(0) )
+      return;
+
+   // back to front, so that the positions of the remaining offsets stay valid
+   for( auto it = offsetPositions_.rbegin(); it != offsetPositions_.rend(); ++it )
+   {
+      WALBERLA_ASSERT_LESS_EQUAL( it->first + it->second, xml.size() );
+      const uint_t offset = uint_c( std::stoull( xml.substr( it->first, it->second ) ) );
+      xml.replace( it->first, it->second, std::to_string( offset + base ) );
+   }
+}
+
+
+
+} // namespace vtk
+} // namespace walberla
@@ -0,0 +1,134 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file AppendedData.h
+//! \ingroup vtk
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "core/DataTypes.h"
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace walberla {
+namespace vtk {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Collects the data of all DataArrays of one VTK XML file that is written in "appended raw" mode
+*
+*   In appended mode, the DataArray elements only contain the offset of their data within the <AppendedData> section
+*   at the end of the file. The data is stored unencoded (in contrast to the base64 encoding used by Base64Writer),
+*   every array is preceded by a 64bit unsigned int value specifying its size in bytes. If compression is activated
+*   (only available if waLBerla is built with zlib), every array is split into blocks of 32 KiB which are compressed
+*   individually and the array is preceded by the header that is expected by vtkZLibDataCompressor.
+*
+*   Usage (one AppendedData object is used for one file, clear() must be called before the next file is written):
+*   \code
+*      ofs << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\"" << appended.fileAttributes() << ">\n";
+*      [...]
+*      ofs << "<DataArray type=\"Float64\" Name=\"density\" " << DataArrayFormat( "binary", &appended ) << ">\n";
+*      appended.append( base64.rawData() ); // base64: Base64Writer that was filled with the data of the array
+*      ofs << "</DataArray>\n";
+*      [...]
+*      appended.toStream( ofs );
+*      ofs << "</VTKFile>\n";
+*   \endcode
+*/
+//**********************************************************************************************************************
+class AppendedData
+{
+public:
+
+   AppendedData() : compress_( false ) {}
+
+   void setCompression( const bool compress );
+   bool compressed() const { return compress_; }
+
+   /// additional attributes of the VTKFile element (header type and compressor)
+   std::string fileAttributes() const;
+
+   /// writes the 'format' and 'offset' attribute of a DataArray element whose data is appended next
+   void writeFormat( std::ostream & os );
+
+   /// appends the data of one DataArray
+   void append( const std::vector< char > & data );
+
+   /// writes the <AppendedData> element
+   void toStream( std::ostream & os ) const;
+
+   /// text that precedes/follows the data in the <AppendedData> element (toStream() writes beginTag(), data(), endTag())
+   static std::string beginTag() { return std::string( " <AppendedData encoding=\"raw\">\n  _" ); }
+   static std::string endTag() { return std::string( "\n </AppendedData>\n" ); }
+
+   /// Adds 'base' to all offsets that were written by writeFormat() into the stream that now is 'xml' (required if the
+   /// appended data of several processes is combined into one file).
+   void shiftOffsets( std::string & xml, const uint_t base ) const;
+
+   const std::string & data() const { return data_; }
+   uint_t size() const { return uint_c( data_.size() ); }
+
+   void clear() { data_.clear(); offsetPositions_.clear(); }
+
+private:
+
+   bool compress_;
+
+   std::string data_;
+   std::vector< std::pair< uint_t, uint_t > > offsetPositions_; ///< position and length of the offsets in the XML stream
+
+}; // class AppendedData
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Stream manipulator that writes the 'format' attribute of a DataArray element
+*
+*   If 'appended' is a null pointer, the attribute format="<format>" is written. Otherwise, the data of the DataArray is
+*   expected to be appended to 'appended' and format="appended" offset="<offset>" is written.
+*/
+//**********************************************************************************************************************
+class DataArrayFormat
+{
+public:
+   DataArrayFormat( const std::string & format, AppendedData * appended ) : format_( format ), appended_( appended ) {}
+
+   friend std::ostream & operator<<( std::ostream & os, const DataArrayFormat & format )
+   {
+      if( format.appended_ == nullptr )
+         os << "format=\"" << format.format_ << "\"";
+      else
+         format.appended_->writeFormat( os );
+      return os;
+   }
+
+private:
+   std::string format_;
+   AppendedData * appended_;
+};
+
+
+
+} // namespace vtk
+} // namespace walberla
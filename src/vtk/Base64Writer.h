@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <ostream>
 #include <vector>
 
@@ -71,8 +72,20 @@ public:
       return *this;
    }
 
+   /// adds 'n' consecutive elements starting at 'data' (equivalent to n calls of the left shift operator, but faster)
+   template< typename T > Base64Writer& append( const T * data, const std::size_t n )
+   {
+      const char * bytePointer = reinterpret_cast<const char*>( data );
+      buffer_.insert( buffer_.end(), bytePointer, bytePointer + n * sizeof( T ) );
+      return *this;
+   }
+
    void toStream( std::ostream& os );
 
+   /// data that was added so far (not encoded, without the size prefix), can be used for writing raw binary files
+   const std::vector<char> & rawData() const { return buffer_; }
+   void clear() { buffer_.clear(); }
+
 private:
 
    void encodeblock( unsigned char in[3], unsigned char out[4], int len )
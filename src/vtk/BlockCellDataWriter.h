@@ -131,6 +131,16 @@ public:
                                                 const real_t globalX,    const real_t globalY,    const real_t globalZ,
                                                 const real_t samplingDx, const real_t samplingDy, const real_t samplingDz );
 
+   //*******************************************************************************************************************
+   /*!
+   *   Optional fast path for binary output: pushes the data of all components of the consecutive cells
+   *   (xBegin,y,z) to (xEnd-1,y,z) at once (e.g., by directly copying the data from the memory of a field). Must return
+   *   false if this is not supported, the data is then pushed cell by cell.
+   */
+   //*******************************************************************************************************************
+   virtual bool pushLine( Base64Writer& /*b64*/, const cell_idx_t /*xBegin*/, const cell_idx_t /*xEnd*/,
+                          const cell_idx_t /*y*/, const cell_idx_t /*z*/ ) { return false; }
+
            uint_t xSize() const { WALBERLA_ASSERT_NOT_NULLPTR( block_ ); WALBERLA_ASSERT_NOT_NULLPTR( blockStorage_ ); return blockStorage_->getNumberOfXCells( *block_ ); }
            uint_t ySize() const { WALBERLA_ASSERT_NOT_NULLPTR( block_ ); WALBERLA_ASSERT_NOT_NULLPTR( blockStorage_ ); return blockStorage_->getNumberOfYCells( *block_ ); }
            uint_t zSize() const { WALBERLA_ASSERT_NOT_NULLPTR( block_ ); WALBERLA_ASSERT_NOT_NULLPTR( blockStorage_ ); return blockStorage_->getNumberOfZCells( *block_ ); }
@@ -31,7 +31,9 @@
 #include "core/selectable/IsSetSelected.h"
 
 #include <algorithm>
+#include <iterator>
 #include <numeric>
+#include <set>
 
 
 namespace walberla {
@@ -50,10 +52,10 @@ VTKOutput::VTKOutput( const BlockStorage & bs, const std::string & identifier, c
    executionCounter_(initialExecutionCount), initialWriteCallsToSkip_(0), writeFrequency_( writeFrequency ), continuousNumbering_( continuousNumbering ),
    pvdEnd_(-2), binary_( binary ), format_( binary ? std::string("binary") : std::string("ascii") ),
    endianness_( littleEndian ? std::string("LittleEndian") : std::string("BigEndian") ),
-   useMPIIO_( useMPIIO ),
+   appendedRawData_( false ), useMPIIO_( useMPIIO ),
    outputDomainDecomposition_( true ),
    samplingDx_( real_c(-1) ), samplingDy_( real_c(-1) ), samplingDz_( real_c(-1) ),
-   forcePVTU_( false ), configured_( false ), uniformGrid_( false ), ghostLayers_( uint_c(0) ), writeNextStep_( false )
+   forcePVTU_( false ), configured_( false ), uniformGrid_( false ), cacheCellLists_( false ), ghostLayers_( uint_c(0) ), writeNextStep_( false )
 {
    init( identifier );
 }
@@ -71,10 +73,10 @@ VTKOutput::VTKOutput( const StructuredBlockStorage & sbs, const std::string & id
    executionCounter_(initialExecutionCount), initialWriteCallsToSkip_(0), writeFrequency_( writeFrequency ), continuousNumbering_( continuousNumbering ),
    pvdEnd_(-2), binary_( binary ), format_( binary ? std::string("binary") : std::string("ascii") ),
    endianness_( littleEndian ? std::string("LittleEndian") : std::string("BigEndian") ),
-   useMPIIO_( useMPIIO ),
+   appendedRawData_( false ), useMPIIO_( useMPIIO ),
    outputDomainDecomposition_( false ),
    samplingDx_( real_c(-1) ), samplingDy_( real_c(-1) ), samplingDz_( real_c(-1) ),
-   forcePVTU_( forcePVTU ), configured_( false ), uniformGrid_( false ), ghostLayers_( ghostLayers ), writeNextStep_( false )
+   forcePVTU_( forcePVTU ), configured_( false ), uniformGrid_( false ), cacheCellLists_( false ), ghostLayers_( ghostLayers ), writeNextStep_( false )
 {
    init( identifier );
 }
@@ -91,10 +93,10 @@ VTKOutput::VTKOutput( const shared_ptr< PointDataSource >& pds, const std::strin
    executionCounter_(initialExecutionCount), initialWriteCallsToSkip_(0), writeFrequency_( writeFrequency ), continuousNumbering_( continuousNumbering ),
    pvdEnd_(-2), binary_( binary ), format_( binary ? std::string("binary") : std::string("ascii") ),
    endianness_( littleEndian ? std::string("LittleEndian") : std::string("BigEndian") ),
-   useMPIIO_( useMPIIO ),
+   appendedRawData_( false ), useMPIIO_( useMPIIO ),
    outputDomainDecomposition_( false ),
    samplingDx_( real_c(-1) ), samplingDy_( real_c(-1) ), samplingDz_( real_c(-1) ),
-   forcePVTU_( false ), configured_( false ), uniformGrid_( false ), ghostLayers_( uint_c(0) ), writeNextStep_( false )
+   forcePVTU_( false ), configured_( false ), uniformGrid_( false ), cacheCellLists_( false ), ghostLayers_( uint_c(0) ), writeNextStep_( false )
 {
    init( identifier );
 }
@@ -112,10 +114,10 @@ VTKOutput::VTKOutput( const shared_ptr< PolylineDataSource >& pds, const std::st
    executionCounter_(initialExecutionCount), initialWriteCallsToSkip_(0), writeFrequency_( writeFrequency ), continuousNumbering_( continuousNumbering ),
    pvdEnd_(-2), binary_( binary ), format_( binary ? std::string("binary") : std::string("ascii") ),
    endianness_( littleEndian ? std::string("LittleEndian") : std::string("BigEndian") ),
-   useMPIIO_( useMPIIO ),
+   appendedRawData_( false ), useMPIIO_( useMPIIO ),
    outputDomainDecomposition_( false ),
    samplingDx_( real_c(-1) ), samplingDy_( real_c(-1) ), samplingDz_( real_c(-1) ),
-   forcePVTU_( false ), configured_( false ), uniformGrid_( false ), ghostLayers_( uint_c(0) ), writeNextStep_( false )
+   forcePVTU_( false ), configured_( false ), uniformGrid_( false ), cacheCellLists_( false ), ghostLayers_( uint_c(0) ), writeNextStep_( false )
 {
    init( identifier );
 }
@@ -297,13 +299,16 @@ void VTKOutput::writeDomainDecomposition( const std::string& path, const Set<SUI
    std::ofstream ofs( file.str().c_str() );
 
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <UnstructuredGrid>\n";
 
    writeDomainDecompositionPieces( ofs, requiredStates, incompatibleStates );
 
-   ofs << " </UnstructuredGrid>\n"
-       << "</VTKFile>" << std::endl;
+   ofs << " </UnstructuredGrid>\n";
+
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 
    ofs.close();
 }
@@ -324,7 +329,7 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
 
    ofs << "  <Piece NumberOfPoints=\"" << points << "\" NumberOfCells=\"" << numberOfBlocks << "\">\n"
        << "   <Points>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" " << dataArrayFormat() << ">\n";
 
    std::vector< float > vertex;
    for( auto block = blocks.begin(); block != blocks.end(); ++block )
@@ -353,7 +358,7 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
       Base64Writer base64;
       for( auto v = vertex.begin(); v != vertex.end(); ++v )
          base64 << *v;
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != vertex.size(); i += 3 )
       ofs << "     " << vertex[ i ] << " " << vertex[ i + 1 ] << " " << vertex[ i + 2 ] << "\n";
@@ -361,41 +366,41 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
    ofs << "    </DataArray>\n"
       << "   </Points>\n"
       << "   <Cells>\n"
-      << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" format=\"" << format_ << "\">\n";
+      << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint32_t i = 0; i != uint32_c( points ); ++i )
          base64 << i;
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points; i += 8 )
       ofs << "     " << ( i ) << " " << ( i + 1 ) << " " << ( i + 2 ) << " " << ( i + 3 ) << " "
       << ( i + 4 ) << " " << ( i + 5 ) << " " << ( i + 6 ) << " " << ( i + 7 ) << "\n";
 
    ofs << "    </DataArray>\n"
-      << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" format=\"" << format_ << "\">\n";
+      << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint_t i = 0; i != points; i += 8 )
          base64 << uint32_c( i + uint_c( 8 ) );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points; i += 8 )
       ofs << "     " << uint32_c( i + uint_c( 8 ) ) << "\n";
 
    ofs << "    </DataArray>\n"
-      << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" format=\"" << format_ << "\">\n";
+      << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint_t i = 0; i != points; i += 8 )
          base64 << uint8_c( 11 );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points; i += 8 )
       ofs << "     11" << "\n";
@@ -404,7 +409,7 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
       << "   </Cells>\n"
       << "   <CellData>\n"
       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >()
-      << "\" Name=\"Level\" NumberOfComponents=\"1\" format=\"" << format_ << "\">\n"
+      << "\" Name=\"Level\" NumberOfComponents=\"1\" " << dataArrayFormat() << ">\n"
       << "     ";
 
    if( binary_ )
@@ -412,7 +417,7 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
       Base64Writer base64;
       for( auto block = blocks.begin(); block != blocks.end(); ++block )
          base64 << uint8_c( unstructuredBlockStorage_->getLevel( **block ) );
-      base64.toStream( ofs );
+      writeBinaryData( ofs, base64 );
    }
    else
    {
@@ -423,7 +428,7 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
 
    ofs << "    </DataArray>\n"
       << "    <DataArray type=\"" << vtk::typeToString< int >()
-      << "\" Name=\"Process\" NumberOfComponents=\"1\" format=\"" << format_ << "\">\n"
+      << "\" Name=\"Process\" NumberOfComponents=\"1\" " << dataArrayFormat() << ">\n"
       << "     ";
 
    if( binary_ )
@@ -431,7 +436,7 @@ void VTKOutput::writeDomainDecompositionPieces( std::ostream& ofs, const Set<SUI
       Base64Writer base64;
       for( uint_t i = 0; i != numberOfBlocks; ++i )
          base64 << process;
-      base64.toStream( ofs );
+      writeBinaryData( ofs, base64 );
    }
    else
    {
@@ -483,7 +488,7 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
 {
    ofs << "  <Piece NumberOfPoints=\"" << numberOfPoints << "\" NumberOfCells=\"" << numberOfPoints << "\">\n"
        << "   <Points>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
@@ -491,7 +496,7 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
       for( uint_t i = 0; i != points.size(); ++i )
          if( outputPoint[ i ] ) base64 << numeric_cast<float>( points[ i ][ 0 ] ) << numeric_cast<float>( points[ i ][ 1 ] )
             << numeric_cast<float>( points[ i ][ 2 ] );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points.size(); ++i )
       if( outputPoint[ i ] ) ofs << "     " << numeric_cast<float>( points[ i ][ 0 ] ) << " " << numeric_cast<float>( points[ i ][ 1 ] )
@@ -500,7 +505,7 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
    ofs << "    </DataArray>\n"
        << "   </Points>\n"
        << "   <Cells>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" " << dataArrayFormat() << ">\n";
 
    Index j = 0;
    if( binary_ )
@@ -508,13 +513,13 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
       Base64Writer base64;
       for( uint_t i = 0; i != points.size(); ++i )
          if( outputPoint[ i ] ) base64 << j++;
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points.size(); ++i )
       if( outputPoint[ i ] ) ofs << "     " << j++ << "\n";
 
    ofs << "    </DataArray>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" " << dataArrayFormat() << ">\n";
 
    j = 0;
    if( binary_ )
@@ -522,20 +527,20 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
       Base64Writer base64;
       for( uint_t i = 0; i != points.size(); ++i )
          if( outputPoint[ i ] ) base64 << ++j;
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points.size(); ++i )
       if( outputPoint[ i ] ) ofs << "     " << ++j << "\n";
 
    ofs << "    </DataArray>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint_t i = 0; i != points.size(); ++i )
          if( outputPoint[ i ] ) base64 << uint8_c( 1 );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != points.size(); ++i )
       if( outputPoint[ i ] ) ofs << "     1" << "\n";
@@ -552,7 +557,7 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
       WALBERLA_ASSERT_GREATER( components, 0 );
 
       ofs << "    <DataArray type=\"" << dataArray->type << "\" Name=\"" << dataArray->name << "\" NumberOfComponents=\""
-         << components << "\" format=\"" << format_ << "\">\n";
+         << components << "\" " << dataArrayFormat() << ">\n";
 
       if( binary_ )
       {
@@ -561,7 +566,7 @@ void VTKOutput::writePointDataPieceHelper( const std::vector<Vector3<real_t> > &
             if( outputPoint[ i ] )
                for( uint_t c = 0; c != components; ++c )
                   pointDataSource_->push( base64, dataIndex, i, c );
-         ofs << "     "; base64.toStream( ofs );
+         ofs << "     "; writeBinaryData( ofs, base64 );
       }
       else for( uint_t i = 0; i != points.size(); ++i )
          if( outputPoint[ i ] )
@@ -605,14 +610,17 @@ void VTKOutput::writePointData( const std::string& path )
    std::ofstream ofs( file.str().c_str() );
 
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <UnstructuredGrid>\n";
        
 
    writePointDataPieceHelper( points, outputPoint, numberOfPoints, ofs );
 
-   ofs << " </UnstructuredGrid>\n"
-       << "</VTKFile>" << std::endl;
+   ofs << " </UnstructuredGrid>\n";
+
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 
    ofs.close();
 }
@@ -698,7 +706,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
 {
    ofs << "  <Piece NumberOfPoints=\"" << numberOfPolylinePoints << "\" NumberOfCells=\"" << numberOfPolylines << "\">\n"
        << "   <Points>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
@@ -715,7 +723,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
          }
       }
 
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else
    {
@@ -734,7 +742,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
    ofs << "    </DataArray>\n"
        << "   </Points>\n"
        << "   <Cells>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" " << dataArrayFormat() << ">\n";
 
    Index j = 0;
    if( binary_ )
@@ -751,7 +759,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
          }
       }
 
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
 
    }
    else
@@ -768,7 +776,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
    }
 
    ofs << "    </DataArray>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" " << dataArrayFormat() << ">\n";
 
    j = 0;
    if( binary_ )
@@ -785,7 +793,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
          }
       }
 
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else
    {
@@ -802,7 +810,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
    }
 
    ofs << "    </DataArray>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
@@ -815,7 +823,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
          base64 << uint8_c( 4 );
          }
 
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else
    {
@@ -839,7 +847,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
       WALBERLA_ASSERT_GREATER( components, 0 );
 
       ofs << "    <DataArray type=\"" << dataArray->type << "\" Name=\"" << dataArray->name << "\" NumberOfComponents=\""
-         << components << "\" format=\"" << format_ << "\">\n";
+         << components << "\" " << dataArrayFormat() << ">\n";
 
       if( binary_ )
       {
@@ -853,7 +861,7 @@ void VTKOutput::writePolylineDataPieceHelper( const std::vector< std::vector< Ve
                   polylineDataSource_->push( base64, dataIndex, polylineIdx, polylinePointIdx, c );
             }
 
-         ofs << "     "; base64.toStream( ofs );
+         ofs << "     "; writeBinaryData( ofs, base64 );
       }
       else
       {
@@ -901,13 +909,16 @@ void VTKOutput::writePolylineData( const std::string& path )
    std::ofstream ofs( file.str().c_str() );
 
    ofs << "<?xml version=\"1.0\"?>\n"
-      << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+      << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
       << " <UnstructuredGrid>\n";
 
    writePolylineDataPieceHelper( lines, outputPolylinePoint, polylineSize, numberOfPolylines, numberOfPolylinePoints, ofs );
 
-   ofs << " </UnstructuredGrid>\n"
-       << "</VTKFile>" << std::endl;
+   ofs << " </UnstructuredGrid>\n";
+
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 
    ofs.close();
 }
@@ -980,6 +991,66 @@ void VTKOutput::computeVTUCells( const IBlock& block, CellVector & cellsOut ) co
 }
 
 
+
+/// Returns the cells of 'block' that are written to file. The cells are computed and stored in 'cellCache_' if they
+/// are not yet cached for this block (or if the AABB of the block changed since they were cached).
+const VTKOutput::BlockCells & VTKOutput::blockCells( const IBlock& block ) const
+{
+   auto cached = cellCache_.find( &block );
+   if( cached != cellCache_.end() )
+   {
+      if( cached->second.aabb_ == block.getAABB() )
+         return cached->second;
+      cellCache_.erase( cached );
+   }
+
+   BlockCells & cells = cellCache_[ &block ];
+   cells.aabb_ = block.getAABB();
+
+   const bool sampling = samplingDx_ > real_c(0) && samplingDy_ > real_c(0) && samplingDz_ > real_c(0);
+
+   if( uniformGrid_ )
+   {
+      if( sampling )
+      {
+         CellInterval cellBB = getSampledCellInterval( block.getAABB() );
+         for( auto it = cellBB.begin(); it != cellBB.end(); ++it )
+            cells.samplingCells_.push_back( getSamplingCell( block, *it ) );
+      }
+      else
+      {
+         for( uint_t z = 0; z < blockStorage_->getNumberOfZCells( block ); ++z )
+            for( uint_t y = 0; y < blockStorage_->getNumberOfYCells( block ); ++y )
+               for( uint_t x = 0; x < blockStorage_->getNumberOfXCells( block ); ++x )
+                  cells.cells_.push_back( x, y, z );
+      }
+   }
+   else
+   {
+      computeVTUCells( block, cells.cells_ );
+      if( sampling && !cells.cells_.empty() )
+         cells.samplingCells_ = getSamplingCells( block, cells.cells_ );
+   }
+
+   return cells;
+}
+
+
+
+/// Removes all cached cell lists of blocks that are not contained in 'blocks' (i.e., blocks that do not exist anymore)
+void VTKOutput::removeCachedCells( const std::vector< const IBlock* > & blocks ) const
+{
+   std::set< const IBlock* > existing( blocks.begin(), blocks.end() );
+   for( auto it = cellCache_.begin(); it != cellCache_.end(); )
+   {
+      if( existing.find( it->first ) == existing.end() )
+         it = cellCache_.erase( it );
+      else
+         ++it;
+   }
+}
+
+
 void VTKOutput::writeBlocks( const std::string& path, const Set<SUID>& requiredStates, const Set<SUID>& incompatibleStates )
 {
    WALBERLA_ASSERT_NOT_NULLPTR( blockStorage_ );
@@ -1000,6 +1071,8 @@ void VTKOutput::writeBlocks( const std::string& path, const Set<SUID>& requiredS
       configured_ = true;
    }
 
+   removeCachedCells( blocks );
+
    for( auto it = blocks.begin(); it != blocks.end(); ++it )
    {
       WALBERLA_ASSERT_NOT_NULLPTR( *it );
@@ -1020,21 +1093,23 @@ void VTKOutput::writeBlocks( const std::string& path, const Set<SUID>& requiredS
       }
       else // unstructured data -> vtu
       {
-         CellVector cells; // cells to be written to file
-         computeVTUCells( block, cells );
+         const BlockCells & cells = blockCells( block ); // cells to be written to file
 
-         if( !cells.empty() )
+         if( !cells.cells_.empty() )
          {
             file << "vtu";
             std::ofstream ofs( file.str().c_str()  );
             if( samplingDx_ <= real_c(0) || samplingDy_ <= real_c(0) || samplingDz_ <= real_c(0) )
-               writeVTU( ofs, block, cells );
+               writeVTU( ofs, block, cells.cells_ );
             else
-               writeVTU_sampling( ofs, block, cells );
+               writeVTU_sampling( ofs, block, cells.samplingCells_ );
             ofs.close();
          }
       }
    }
+
+   if( !cacheCellLists_ )
+      cellCache_.clear();
 }
 
 
@@ -1059,6 +1134,8 @@ void VTKOutput::writeBlockPieces( std::ostream & oss, const Set<SUID>& requiredS
       configured_ = true;
    }
 
+   removeCachedCells( blocks );
+
    for( auto it = blocks.begin(); it != blocks.end(); ++it )
    {
       WALBERLA_ASSERT_NOT_NULLPTR( *it );
@@ -1073,18 +1150,20 @@ void VTKOutput::writeBlockPieces( std::ostream & oss, const Set<SUID>& requiredS
       }
       else // unstructured data -> vtu
       {  
-         CellVector cells; // cells to be written to file
-         computeVTUCells( block, cells );
+         const BlockCells & cells = blockCells( block ); // cells to be written to file
          
-         if( !cells.empty() )
+         if( !cells.cells_.empty() )
          {
             if( samplingDx_ <= real_c(0) || samplingDy_ <= real_c(0) || samplingDz_ <= real_c(0) )
-               writeVTUPiece( oss, block, cells );
+               writeVTUPiece( oss, block, cells.cells_ );
             else
-               writeVTUPiece_sampling( oss, block, cells );
+               writeVTUPiece_sampling( oss, block, cells.samplingCells_ );
          }
       }
    }
+
+   if( !cacheCellLists_ )
+      cellCache_.clear();
 }
 
 
@@ -1095,7 +1174,7 @@ void VTKOutput::writeVTI( std::ostream& ofs, const IBlock& block ) const
    const AABB&         domain = blockStorage_->getDomain();
 
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <ImageData WholeExtent=\"" << cellBB.xMin() << " " << ( cellBB.xMax() + 1 ) << " "
        << cellBB.yMin() << " " << ( cellBB.yMax() + 1 ) << " "
        << cellBB.zMin() << " " << ( cellBB.zMax() + 1 ) << "\""
@@ -1104,8 +1183,11 @@ void VTKOutput::writeVTI( std::ostream& ofs, const IBlock& block ) const
 
    writeVTIPiece( ofs, block );
 
-   ofs << " </ImageData>\n"
-       << "</VTKFile>" << std::endl;
+   ofs << " </ImageData>\n";
+
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 }
 
 void VTKOutput::writeVTIPiece( std::ostream& ofs, const IBlock& block ) const
@@ -1120,14 +1202,7 @@ void VTKOutput::writeVTIPiece( std::ostream& ofs, const IBlock& block ) const
        << cellBB.zMin() << " " << ( cellBB.zMax() + 1 ) << "\">\n"
        << "   <CellData>\n";
 
-   CellVector cells;
-
-   for( uint_t z = 0; z < blockStorage_->getNumberOfZCells( block ); ++z )
-      for( uint_t y = 0; y < blockStorage_->getNumberOfYCells( block ); ++y )
-         for( uint_t x = 0; x < blockStorage_->getNumberOfXCells( block ); ++x )
-            cells.push_back( x, y, z );
-
-   writeCellData( ofs, block, cells );
+   writeCellData( ofs, block, blockCells( block ).cells_ );
 
    ofs << "   </CellData>\n"
       << "  </Piece>\n";
@@ -1141,7 +1216,7 @@ void VTKOutput::writeVTI_sampling( std::ostream& ofs, const IBlock& block ) cons
    CellInterval cellBB = getSampledCellInterval( blockBB );
 
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <ImageData WholeExtent=\"" << cellBB.xMin() << " " << ( cellBB.xMax() + 1 ) << " "
        << cellBB.yMin() << " " << ( cellBB.yMax() + 1 ) << " "
        << cellBB.zMin() << " " << ( cellBB.zMax() + 1 ) << "\""
@@ -1150,8 +1225,11 @@ void VTKOutput::writeVTI_sampling( std::ostream& ofs, const IBlock& block ) cons
 
    writeVTIPiece_sampling( ofs, block );
 
-   ofs << " </ImageData>\n"
-       << "</VTKFile>" << std::endl;
+   ofs << " </ImageData>\n";
+
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 }
 
 void VTKOutput::writeVTIPiece_sampling( std::ostream& ofs, const IBlock& block ) const
@@ -1163,32 +1241,14 @@ void VTKOutput::writeVTIPiece_sampling( std::ostream& ofs, const IBlock& block )
    WALBERLA_ASSERT_GREATER( samplingDy_, real_t(0) );
    WALBERLA_ASSERT_GREATER( samplingDz_, real_t(0) );
 
-   const AABB&  blockBB = block.getAABB();
-   const AABB&  domain = blockStorage_->getDomain();
-   const uint_t level = blockStorage_->getLevel( block );
-
-   CellInterval cellBB = getSampledCellInterval( blockBB );
+   CellInterval cellBB = getSampledCellInterval( block.getAABB() );
 
    ofs << "  <Piece Extent=\"" << cellBB.xMin() << " " << (cellBB.xMax()+1) << " "
        << cellBB.yMin() << " " << (cellBB.yMax()+1) << " "
        << cellBB.zMin() << " " << (cellBB.zMax()+1) << "\">\n"
        << "   <CellData>\n";
 
-   CellVector cells;
-   for( auto it = cellBB.begin(); it != cellBB.end(); ++it )
-   {
-      Vector3<real_t> world( domain.xMin() + ( real_c( it->x() ) + real_t(0.5) ) * samplingDx_,
-         domain.yMin() + ( real_c( it->y() ) + real_t(0.5) ) * samplingDy_,
-         domain.zMin() + ( real_c( it->z() ) + real_t(0.5) ) * samplingDz_ );
-
-      Cell cell;
-      blockStorage_->getCell( cell, world[0], world[1], world[2], level );
-
-      blockStorage_->transformGlobalToBlockLocalCell( cell, block );
-      cells.push_back( cell );
-   }
-
-   writeCellData( ofs, block, cells );
+   writeCellData( ofs, block, blockCells( block ).samplingCells_ );
 
    ofs << "   </CellData>\n"
        << "  </Piece>\n";
@@ -1199,13 +1259,16 @@ void VTKOutput::writeVTIPiece_sampling( std::ostream& ofs, const IBlock& block )
 void VTKOutput::writeVTU( std::ostream& ofs, const IBlock& block, const CellVector& cells ) const
 {
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <UnstructuredGrid>\n";
 
    writeVTUPiece( ofs, block, cells );
 
-   ofs << " </UnstructuredGrid>\n"
-       << "</VTKFile>" << std::endl;
+   ofs << " </UnstructuredGrid>\n";
+
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 }
 
 
@@ -1260,7 +1323,7 @@ void VTKOutput::writeVTUPiece( std::ostream& ofs, const IBlock& block, const Cel
    if (ghostLayers_ > 0)
    {
       ofs << "    <DataArray type=\"" << vtk::typeToString< uint8_t >()
-          << "\" Name=\"vtkGhostLevels\" NumberOfComponents=\"1\" format=\"" << format_ << "\">\n"
+          << "\" Name=\"vtkGhostLevels\" NumberOfComponents=\"1\" " << dataArrayFormat() << ">\n"
           << "     ";
 
       if (binary_)
@@ -1268,7 +1331,7 @@ void VTKOutput::writeVTUPiece( std::ostream& ofs, const IBlock& block, const Cel
          Base64Writer base64;
          for (auto cell = cells.begin(); cell != cells.end(); ++cell)
             base64 << ghostLayerNr(block, cell->x(), cell->y(), cell->z());
-         base64.toStream(ofs);
+         writeBinaryData( ofs, base64 );
       }
       else
       {
@@ -1288,25 +1351,26 @@ void VTKOutput::writeVTUPiece( std::ostream& ofs, const IBlock& block, const Cel
 
 
 
-void VTKOutput::writeVTU_sampling( std::ostream& ofs, const IBlock& block, const CellVector& localCells ) const
+void VTKOutput::writeVTU_sampling( std::ostream& ofs, const IBlock& block, const std::vector< SamplingCell >& cells ) const
 {
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <UnstructuredGrid>\n";
 
-   writeVTUPiece_sampling( ofs, block, localCells );
+   writeVTUPiece_sampling( ofs, block, cells );
+
+   ofs << " </UnstructuredGrid>\n";
 
-   ofs << " </UnstructuredGrid>\n"
-       << "</VTKFile>" << std::endl;
+   writeAppendedData( ofs );
+
+   ofs << "</VTKFile>" << std::endl;
 
 }
 
 
 
-void VTKOutput::writeVTUPiece_sampling(std::ostream& ofs, const IBlock& block, const CellVector& localCells) const
+void VTKOutput::writeVTUPiece_sampling(std::ostream& ofs, const IBlock& block, const std::vector< SamplingCell >& cells) const
 {
-   std::vector< SamplingCell > cells = getSamplingCells(block, localCells);
-
    // setting up vertex-index mapping --->
 
    std::map< Vertex, Index, VertexCompare > vimap; // vertex<->index map
@@ -1358,7 +1422,7 @@ void VTKOutput::writeVTUHeader( std::ofstream& ofs, const uint_t numberOfCells,
                                 const std::vector< VertexCoord > & vc, const std::vector< Index > & ci ) const
 {
    ofs << "<?xml version=\"1.0\"?>\n"
-       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
        << " <UnstructuredGrid>\n";
 
    writeVTUHeaderPiece( ofs, numberOfCells, vc, ci );
@@ -1371,7 +1435,7 @@ void VTKOutput::writeVTUHeaderPiece( std::ostream& ofs, const uint_t numberOfCel
 {
    ofs << "  <Piece NumberOfPoints=\"" << vc.size() << "\" NumberOfCells=\"" << numberOfCells << "\">\n"
        << "   <Points>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< float >() << "\" NumberOfComponents=\"3\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
@@ -1379,7 +1443,7 @@ void VTKOutput::writeVTUHeaderPiece( std::ostream& ofs, const uint_t numberOfCel
       for( auto vertex = vc.begin(); vertex != vc.end(); ++vertex )
          base64 << numeric_cast<float>( ( *vertex ).get<0>() ) << numeric_cast<float>( ( *vertex ).get<1>() )
                 << numeric_cast<float>( ( *vertex ).get<2>() );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( auto vertex = vc.begin(); vertex != vc.end(); ++vertex )
       ofs << "     " << numeric_cast<float>( ( *vertex ).get<0>() ) << " " << numeric_cast<float>( ( *vertex ).get<1>() )
@@ -1388,41 +1452,41 @@ void VTKOutput::writeVTUHeaderPiece( std::ostream& ofs, const uint_t numberOfCel
    ofs << "    </DataArray>\n"
        << "   </Points>\n"
        << "   <Cells>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"connectivity\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint_t i = 0; i != ci.size(); i += 8 )
          base64 << ci[ i ] << ci[ i + 1 ] << ci[ i + 2 ] << ci[ i + 3 ] << ci[ i + 4 ] << ci[ i + 5 ] << ci[ i + 6 ] << ci[ i + 7 ];
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != ci.size(); i += 8 )
       ofs << "     " << ci[ i ] << " " << ci[ i + 1 ] << " " << ci[ i + 2 ] << " " << ci[ i + 3 ] << " "
           << ci[ i + 4 ] << " " << ci[ i + 5 ] << " " << ci[ i + 6 ] << " " << ci[ i + 7 ] << "\n";
 
    ofs << "    </DataArray>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< Index >() << "\" Name=\"offsets\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint_t i = 0; i != ci.size(); i += 8 )
          base64 << numeric_cast<Index>( i + uint_c( 8 ) );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != ci.size(); i += 8 )
       ofs << "     " << numeric_cast<Index>( i + uint_c( 8 ) ) << "\n";
 
    ofs << "    </DataArray>\n"
-       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" format=\"" << format_ << "\">\n";
+       << "    <DataArray type=\"" << vtk::typeToString< uint8_t >() << "\" Name=\"types\" " << dataArrayFormat() << ">\n";
 
    if( binary_ )
    {
       Base64Writer base64;
       for( uint_t i = 0; i != ci.size(); i += 8 )
          base64 << uint8_c( 11 );
-      ofs << "     "; base64.toStream( ofs );
+      ofs << "     "; writeBinaryData( ofs, base64 );
    }
    else for( uint_t i = 0; i != ci.size(); i += 8 )
       ofs << "     " << "11" << "\n";
@@ -1461,64 +1525,62 @@ uint8_t VTKOutput::ghostLayerNr( const IBlock& block, const cell_idx_t x, const
 
 
 
-std::vector< VTKOutput::SamplingCell > VTKOutput::getSamplingCells( const IBlock& block, const CellVector& cells ) const
+VTKOutput::SamplingCell VTKOutput::getSamplingCell( const IBlock& block, const Cell& coordinates ) const
 {
    WALBERLA_ASSERT_NOT_NULLPTR( blockStorage_ );
 
-   std::vector< SamplingCell > samplingCells;
-   CellSet cellSet( cells );
+   const AABB& domainBB = blockStorage_->getDomain();
 
-   const AABB& domainBB  = blockStorage_->getDomain();
-   const AABB& blockAABB = block.getAABB();
+   const real_t xMin = domainBB.xMin() + real_c( coordinates.x() ) * samplingDx_;
+   const real_t yMin = domainBB.yMin() + real_c( coordinates.y() ) * samplingDy_;
+   const real_t zMin = domainBB.zMin() + real_c( coordinates.z() ) * samplingDz_;
 
-   const real_t xEnd = std::floor( ( blockAABB.xMax() - domainBB.xMin() ) / samplingDx_ );
-   const real_t yEnd = std::floor( ( blockAABB.yMax() - domainBB.yMin() ) / samplingDy_ );
-   const real_t zEnd = std::floor( ( blockAABB.zMax() - domainBB.zMin() ) / samplingDz_ );
+   SamplingCell cell;
+   cell.coordinates_ = coordinates;
+   cell.aabb_.init( xMin, yMin, zMin, xMin + samplingDx_, yMin + samplingDy_, zMin + samplingDz_ );
+   cell.globalX_ = ( cell.aabb_.xMin() + cell.aabb_.xMax() ) / real_c(2);
+   cell.globalY_ = ( cell.aabb_.yMin() + cell.aabb_.yMax() ) / real_c(2);
+   cell.globalZ_ = ( cell.aabb_.zMin() + cell.aabb_.zMax() ) / real_c(2);
 
-   for( real_t z = std::floor( ( blockAABB.zMin() - domainBB.zMin() ) / samplingDz_ ); z <= zEnd; ++z )
-   {
-      real_t zMin = domainBB.zMin() +   z   * samplingDz_;
-      real_t zMax = domainBB.zMin() + (z+1) * samplingDz_;
+   blockStorage_->getBlockLocalCell( cell.localCell_, block, cell.globalX_, cell.globalY_, cell.globalZ_ );
 
-      for( real_t y = std::floor( ( blockAABB.yMin() - domainBB.yMin() ) / samplingDy_ ); y <= yEnd; ++y )
-      {
-         real_t yMin = domainBB.yMin() +   y   * samplingDy_;
-         real_t yMax = domainBB.yMin() + (y+1) * samplingDy_;
+   AABB localCellAABB;
+   blockStorage_->getBlockLocalCellAABB( block, cell.localCell_, localCellAABB );
 
-         for( real_t x = std::floor( ( blockAABB.xMin() - domainBB.xMin() ) / samplingDx_ ); x <= xEnd; ++x )
-         {
-            real_t xMin = domainBB.xMin() +   x   * samplingDx_;
-            real_t xMax = domainBB.xMin() + (x+1) * samplingDx_;
+   cell.localCellX_ = real_c( cell.localCell_.x() ) +
+                      ( ( cell.globalX_ - localCellAABB.xMin() ) / ( localCellAABB.xMax() - localCellAABB.xMin() ) );
+   cell.localCellY_ = real_c( cell.localCell_.y() ) +
+                      ( ( cell.globalY_ - localCellAABB.yMin() ) / ( localCellAABB.yMax() - localCellAABB.yMin() ) );
+   cell.localCellZ_ = real_c( cell.localCell_.z() ) +
+                      ( ( cell.globalZ_ - localCellAABB.zMin() ) / ( localCellAABB.zMax() - localCellAABB.zMin() ) );
 
-            SamplingCell cell;
-            cell.aabb_.init( xMin, yMin, zMin, xMax, yMax, zMax );
-            cell.globalX_ = ( xMin + xMax ) / real_c(2);
-            cell.globalY_ = ( yMin + yMax ) / real_c(2);
-            cell.globalZ_ = ( zMin + zMax ) / real_c(2);
+   return cell;
+}
 
-            blockStorage_->getBlockLocalCell( cell.localCell_, block, cell.globalX_, cell.globalY_, cell.globalZ_ );
 
-            if( cellSet.contains( cell.localCell_ ) )
-            {
-               cell.coordinates_.x() = cell_idx_c( x );
-               cell.coordinates_.y() = cell_idx_c( y );
-               cell.coordinates_.z() = cell_idx_c( z );
 
-               AABB localCellAABB;
-               blockStorage_->getBlockLocalCellAABB( block, cell.localCell_, localCellAABB );
+std::vector< VTKOutput::SamplingCell > VTKOutput::getSamplingCells( const IBlock& block, const CellVector& cells ) const
+{
+   WALBERLA_ASSERT_NOT_NULLPTR( blockStorage_ );
+
+   std::vector< SamplingCell > samplingCells;
+   CellSet cellSet( cells );
+
+   const AABB& domainBB  = blockStorage_->getDomain();
+   const AABB& blockAABB = block.getAABB();
 
-               cell.localCellX_ = real_c( cell.localCell_.x() ) +
-                                  ( ( cell.globalX_ - localCellAABB.xMin() ) / ( localCellAABB.xMax() - localCellAABB.xMin() ) );
-               cell.localCellY_ = real_c( cell.localCell_.y() ) +
-                                  ( ( cell.globalY_ - localCellAABB.yMin() ) / ( localCellAABB.yMax() - localCellAABB.yMin() ) );
-               cell.localCellZ_ = real_c( cell.localCell_.z() ) +
-                                  ( ( cell.globalZ_ - localCellAABB.zMin() ) / ( localCellAABB.zMax() - localCellAABB.zMin() ) );
+   const cell_idx_t xEnd = cell_idx_c( std::floor( ( blockAABB.xMax() - domainBB.xMin() ) / samplingDx_ ) );
+   const cell_idx_t yEnd = cell_idx_c( std::floor( ( blockAABB.yMax() - domainBB.yMin() ) / samplingDy_ ) );
+   const cell_idx_t zEnd = cell_idx_c( std::floor( ( blockAABB.zMax() - domainBB.zMin() ) / samplingDz_ ) );
 
+   for( cell_idx_t z = cell_idx_c( std::floor( ( blockAABB.zMin() - domainBB.zMin() ) / samplingDz_ ) ); z <= zEnd; ++z )
+      for( cell_idx_t y = cell_idx_c( std::floor( ( blockAABB.yMin() - domainBB.yMin() ) / samplingDy_ ) ); y <= yEnd; ++y )
+         for( cell_idx_t x = cell_idx_c( std::floor( ( blockAABB.xMin() - domainBB.xMin() ) / samplingDx_ ) ); x <= xEnd; ++x )
+         {
+            SamplingCell cell = getSamplingCell( block, Cell( x, y, z ) );
+            if( cellSet.contains( cell.localCell_ ) )
                samplingCells.push_back( cell );
-            }
          }
-      }
-   }
 
    return samplingCells;
 }
@@ -1534,15 +1596,30 @@ void VTKOutput::writeCellData( std::ostream& ofs, const IBlock& block, const Cel
       (*writer)->configure( block, *blockStorage_ );
 
       ofs << "    <DataArray type=\"" << (*writer)->typeString() << "\" Name=\"" << (*writer)->identifier()
-                                      << "\" NumberOfComponents=\"" << (*writer)->fSize() << "\" format=\"" << format_ << "\">\n";
+                                      << "\" NumberOfComponents=\"" << (*writer)->fSize() << "\" " << dataArrayFormat() << ">\n";
 
       if( binary_ )
       {
          Base64Writer base64;
-         for( auto cell = cells.begin(); cell != cells.end(); ++cell )
-            for( uint_t f = 0; f != (*writer)->fSize(); ++f )
-               (*writer)->push( base64, cell->x(), cell->y(), cell->z(), cell_idx_c(f) );
-         ofs << "     "; base64.toStream( ofs );
+         for( auto cell = cells.begin(); cell != cells.end(); )
+         {
+            // consecutive cells along the x-axis can be pushed at once
+            auto last = cell;
+            while( std::next( last ) != cells.end() && std::next( last )->z() == cell->z() && std::next( last )->y() == cell->y() &&
+                   std::next( last )->x() == last->x() + cell_idx_t(1) )
+               ++last;
+
+            if( (*writer)->pushLine( base64, cell->x(), last->x() + cell_idx_t(1), cell->y(), cell->z() ) )
+            {
+               cell = std::next( last );
+               continue;
+            }
+
+            for( ; cell != std::next( last ); ++cell )
+               for( uint_t f = 0; f != (*writer)->fSize(); ++f )
+                  (*writer)->push( base64, cell->x(), cell->y(), cell->z(), cell_idx_c(f) );
+         }
+         ofs << "     "; writeBinaryData( ofs, base64 );
       }
       else
       {
@@ -1571,7 +1648,7 @@ void VTKOutput::writeCellData( std::ostream& ofs, const IBlock& block, const std
       (*writer)->configure( block, *blockStorage_ );
 
       ofs << "    <DataArray type=\"" << (*writer)->typeString() << "\" Name=\"" << (*writer)->identifier()
-                                      << "\" NumberOfComponents=\"" << (*writer)->fSize() << "\" format=\"" << format_ << "\">\n";
+                                      << "\" NumberOfComponents=\"" << (*writer)->fSize() << "\" " << dataArrayFormat() << ">\n";
 
       if( binary_ )
       {
@@ -1582,7 +1659,7 @@ void VTKOutput::writeCellData( std::ostream& ofs, const IBlock& block, const std
                                         cell->localCellX_,    cell->localCellY_,    cell->localCellZ_,
                                         cell->globalX_   ,    cell->globalY_,       cell->globalZ_,
                                         samplingDx_,          samplingDy_,          samplingDz_ );
-         ofs << "     "; base64.toStream( ofs );
+         ofs << "     "; writeBinaryData( ofs, base64 );
       }
       else
       {
@@ -1809,7 +1886,6 @@ bool VTKOutput::writeCombinedVTI( std::string localPart, const uint_t collector
 
    const MPI_Comm comm    = MPIManager::instance()->comm();
    const int rank         = MPIManager::instance()->rank();
-   const int numProcesses = MPIManager::instance()->numProcesses();
 
    const bool noData = mpi::allReduce( localPart.empty(), mpi::LOGICAL_AND, comm );
    if( noData )
@@ -1821,30 +1897,22 @@ bool VTKOutput::writeCombinedVTI( std::string localPart, const uint_t collector
    const CellInterval& cellBB = blockStorage_->getDomainCellBB();
    const AABB&         domain = blockStorage_->getDomain();
 
+   std::ostringstream header;
    if( rank == 0 )
    {
-      std::ostringstream header;
-
       header << "<?xml version=\"1.0\"?>\n"
-         << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+         << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
          << " <ImageData WholeExtent=\"" << cellBB.xMin() << " " << ( cellBB.xMax() + 1 ) << " "
          << cellBB.yMin() << " " << ( cellBB.yMax() + 1 ) << " "
          << cellBB.zMin() << " " << ( cellBB.zMax() + 1 ) << "\""
          << " Origin=\"" << domain.xMin() << " " << domain.yMin() << " " << domain.zMin() << "\""
          << " Spacing=\"" << blockStorage_->dx() << " " << blockStorage_->dy() << " " << blockStorage_->dz() 
          << "\">\n\n";
-
-      localPart.insert( 0, header.str() );
    }
 
    localPart.append( "\n\n" );
 
-   if( rank == numProcesses - 1 )
-   {
-      localPart.append( " </ImageData>\n</VTKFile>\n" );
-   }
-
-   mpi::writeMPITextFile( collection.str(), localPart, comm );
+   writeCombinedFile( collection.str(), header.str(), localPart, " </ImageData>\n" );
 
    return true;
 }
@@ -1858,7 +1926,6 @@ bool VTKOutput::writeCombinedVTI_sampled( std::string localPart, const uint_t co
 
    const MPI_Comm comm    = MPIManager::instance()->comm();
    const int rank         = MPIManager::instance()->rank();
-   const int numProcesses = MPIManager::instance()->numProcesses();
 
    const bool noData = mpi::allReduce( localPart.empty(), mpi::LOGICAL_AND, comm );
    if( noData )
@@ -1867,32 +1934,24 @@ bool VTKOutput::writeCombinedVTI_sampled( std::string localPart, const uint_t co
    std::ostringstream collection;
    collection << baseFolder_ << "/" << identifier_ << "/" << executionFolder_ << "_" << collector << ".vti";
 
+   std::ostringstream header;
    if( rank == 0 )
    {
-      std::ostringstream header;
-
       const AABB&         domain = blockStorage_->getDomain();
       const CellInterval  cellBB = getSampledCellInterval( domain );
 
       header << "<?xml version=\"1.0\"?>\n"
-         << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+         << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
          << " <ImageData WholeExtent=\"" << cellBB.xMin() << " " << ( cellBB.xMax() + 1 ) << " "
          << cellBB.yMin() << " " << ( cellBB.yMax() + 1 ) << " "
          << cellBB.zMin() << " " << ( cellBB.zMax() + 1 ) << "\""
          << " Origin=\"" << domain.xMin() << " " << domain.yMin() << " " << domain.zMin() << "\""
          << " Spacing=\"" << samplingDx_ << " " << samplingDy_ << " " << samplingDz_ << "\">\n\n";
-
-      localPart.insert( 0, header.str() );
    }
 
    localPart.append( "\n\n" );
 
-   if( rank == numProcesses - 1 )
-   {
-      localPart.append( " </ImageData>\n</VTKFile>\n" );
-   }
-
-   mpi::writeMPITextFile( collection.str(), localPart, comm );
+   writeCombinedFile( collection.str(), header.str(), localPart, " </ImageData>\n" );
 
    return true;
 }
@@ -1947,7 +2006,6 @@ bool VTKOutput::writeCombinedVTU( std::string localPart, const uint_t collector
 {
    const MPI_Comm comm    = MPIManager::instance()->comm();
    const int rank         = MPIManager::instance()->rank();
-   const int numProcesses = MPIManager::instance()->numProcesses();
 
    const bool noData = mpi::allReduce( localPart.empty(), mpi::LOGICAL_AND, comm );
    if( noData )
@@ -1956,26 +2014,89 @@ bool VTKOutput::writeCombinedVTU( std::string localPart, const uint_t collector
    std::ostringstream collection;
    collection << baseFolder_ << "/" << identifier_ << "/" << executionFolder_ << "_" << collector << ".vtu";
 
+   std::ostringstream header;
    if( rank == 0 )
    {
-      std::ostringstream header;
       header << "<?xml version=\"1.0\"?>\n"
-         << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\">\n"
+         << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << endianness_ << "\"" << vtkFileAttributes() << ">\n"
          << " <UnstructuredGrid GhostLevel=\"" << ghostLayers_ << "\">\n\n";
-
-      localPart.insert( 0, header.str() );
    }
 
    localPart.append( "\n\n" );
 
+   writeCombinedFile( collection.str(), header.str(), localPart, " </UnstructuredGrid>\n" );
+
+   return true;
+}
+
+
+
+void VTKOutput::writeBinaryData( std::ostream& ofs, Base64Writer& base64 ) const
+{
+   if( appendedRawData_ )
+   {
+      appendedData_.append( base64.rawData() );
+      ofs << "\n";
+   }
+   else
+      base64.toStream( ofs );
+}
+
+
+
+void VTKOutput::writeAppendedData( std::ostream& ofs ) const
+{
+   if( appendedRawData_ )
+   {
+      appendedData_.toStream( ofs );
+      appendedData_.clear();
+   }
+}
+
+
+
+/// Writes a file that is combined from the pieces of all processes ('header' is only used on the root process). In
+/// appended mode, the appended data of all processes follows after the pieces of all processes.
+void VTKOutput::writeCombinedFile( const std::string& file, const std::string& header, std::string& localPart,
+                                   const std::string& gridEndTag ) const
+{
+   const MPI_Comm comm    = MPIManager::instance()->comm();
+   const int rank         = MPIManager::instance()->rank();
+   const int numProcesses = MPIManager::instance()->numProcesses();
+
+   if( !appendedRawData_ )
+   {
+      localPart.insert( 0, header );
+      if( rank == numProcesses - 1 )
+         localPart.append( gridEndTag + "</VTKFile>\n" );
+
+      mpi::writeMPITextFile( file, localPart, comm );
+      return;
+   }
+
+   // the offsets of the pieces refer to the appended data of this process
+   uint_t offset = uint_t(0);
+   WALBERLA_MPI_SECTION()
+   {
+      uint_t size = appendedData_.size();
+      MPI_Exscan( &size, &offset, 1, MPITrait< uint_t >::type(), MPI_SUM, comm );
+      if( rank == 0 )
+         offset = uint_t(0);
+   }
+   appendedData_.shiftOffsets( localPart, offset );
+
+   std::vector< std::string > parts( 3 );
+   parts[0] = header + localPart;
+   parts[1] = appendedData_.data();
    if( rank == numProcesses - 1 )
    {
-      localPart.append( " </UnstructuredGrid>\n</VTKFile>\n" );
+      parts[0].append( gridEndTag + AppendedData::beginTag() );
+      parts[2] = AppendedData::endTag() + "</VTKFile>\n";
    }
 
-   mpi::writeMPITextFile( collection.str(), localPart, comm );
+   appendedData_.clear();
 
-   return true;
+   mpi::writeMPITextFile( file, parts, comm );
 }
 
 
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "AABBCellFilter.h"
+#include "AppendedData.h"
 #include "Base64Writer.h"
 #include "BlockCellDataWriter.h"
 #include "CellBBCellFilter.h"
@@ -38,6 +39,7 @@
 #include <boost/tuple/tuple.hpp>
 
 #include <fstream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -85,6 +87,14 @@ private:
       real_t globalZ_; // ... in global coordinates
    };
 
+   struct BlockCells
+   {
+      AABB aabb_; // AABB of the block for which the cells were computed
+
+      CellVector cells_; // block local cells that are written to file (not used for sampled vti output)
+      std::vector< SamplingCell > samplingCells_; // only for sampled output
+   };
+
 public:
 
    class Write {
@@ -166,6 +176,15 @@ public:
    inline void setSamplingResolution( const real_t spacing );
    inline void setSamplingResolution( const real_t dx, const real_t dy, const real_t dz );
 
+   // binary data is stored unencoded in an <AppendedData> section at the end of each file instead of being base64
+   // encoded inline (only for binary output, zlib compression requires WALBERLA_BUILD_WITH_ZLIB)
+   inline void useAppendedRawData( const bool compress = false );
+
+   // The cells (and sampling cells) that are written for a block are only computed once and then reused by all
+   // subsequent writes for as long as the block exists and its AABB does not change. Cell lists must only be cached if
+   // the result of all cell filters does not change over time!
+   void cacheCellLists( const bool cache = true ) { cacheCellLists_ = cache; }
+
    void write( const bool immediatelyWriteCollectors = true,
                const int simultaneousIOOperations = 0,
                const Set<SUID>& requiredStates     = Set<SUID>::emptySet(),
@@ -235,6 +254,9 @@ private:
 
    void computeVTUCells( const IBlock& block, CellVector & cellsOut ) const;
 
+   const BlockCells & blockCells( const IBlock& block ) const;
+   void removeCachedCells( const std::vector< const IBlock* > & blocks ) const;
+
    void writeBlocks( const std::string& path, const Set<SUID>& requiredStates, const Set<SUID>& incompatibleStates );
    void writeBlockPieces( std::ostream & oss, const Set<SUID>& requiredStates, const Set<SUID>& incompatibleStates );
 
@@ -245,16 +267,17 @@ private:
    void writeVTIPiece_sampling( std::ostream& ofs, const IBlock& block ) const;
 
    void writeVTU( std::ostream& ofs, const IBlock& block, const CellVector& cells ) const;
-   void writeVTU_sampling( std::ostream& ofs, const IBlock& block, const CellVector& cells ) const;
+   void writeVTU_sampling( std::ostream& ofs, const IBlock& block, const std::vector< SamplingCell >& cells ) const;
 
    void writeVTUPiece(std::ostream& ofs, const IBlock& block, const CellVector& cells) const;
-   void writeVTUPiece_sampling(std::ostream& ofs, const IBlock& block, const CellVector& cells) const;
+   void writeVTUPiece_sampling(std::ostream& ofs, const IBlock& block, const std::vector< SamplingCell >& cells) const;
 
    void writeVTUHeader( std::ofstream& ofs, const uint_t numberOfCells, const std::vector< VertexCoord > & vc, const std::vector< Index > & ci ) const;
    void writeVTUHeaderPiece (std::ostream& ofs, const uint_t numberOfCells, const std::vector< VertexCoord > & vc, const std::vector< Index > & ci) const;
 
    uint8_t ghostLayerNr( const IBlock& block, const cell_idx_t x, const cell_idx_t y, const cell_idx_t z ) const;
 
+   SamplingCell getSamplingCell( const IBlock& block, const Cell& coordinates ) const;
    std::vector< SamplingCell > getSamplingCells( const IBlock& block, const CellVector& cells ) const;
 
    void writeCellData( std::ostream& ofs, const IBlock& block, const CellVector& cells ) const;
@@ -276,6 +299,12 @@ private:
 
    CellInterval getSampledCellInterval( const AABB & aabb ) const;
 
+   DataArrayFormat dataArrayFormat() const { return DataArrayFormat( format_, appendedRawData_ ? &appendedData_ : nullptr ); }
+   std::string vtkFileAttributes() const { return appendedRawData_ ? appendedData_.fileAttributes() : std::string(); }
+   void writeBinaryData( std::ostream& ofs, Base64Writer& base64 ) const;
+   void writeAppendedData( std::ostream& ofs ) const;
+   void writeCombinedFile( const std::string& file, const std::string& header, std::string& localPart, const std::string& gridEndTag ) const;
+
 
    std::string identifier_;
 
@@ -303,6 +332,9 @@ private:
    const std::string format_;     // "binary" or "ascii"
    const std::string endianness_; // "LittleEndian" or "BigEndian"
 
+   bool appendedRawData_;
+   mutable AppendedData appendedData_; // appended data of the file that is currently written
+
    const bool useMPIIO_;
 
    const bool outputDomainDecomposition_; // if true, only the block structure (= the domain decomposition) is written to file
@@ -315,6 +347,9 @@ private:
          bool configured_;
          bool uniformGrid_;
 
+   bool cacheCellLists_;
+   mutable std::map< const IBlock*, BlockCells > cellCache_;
+
    const uint_t ghostLayers_;
 
    std::vector< AABB >  aabbInclusionFilters_;
@@ -509,6 +544,18 @@ inline void VTKOutput::setSamplingResolution( const real_t dx, const real_t dy,
 
 
 
+inline void VTKOutput::useAppendedRawData( const bool compress )
+{
+   if( !binary_ )
+      WALBERLA_ABORT( "You are trying to activate appended raw data for VTKOutput \"" << identifier_ << "\", "
+                      "but this VTKOutput is configured to write ASCII files. Appended data is only supported for binary output." );
+
+   appendedRawData_ = true;
+   appendedData_.setCompression( compress );
+}
+
+
+
 
 ////////////////////
 // FREE FUNCTIONS //
@@ -0,0 +1,359 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file XDMFOutput.cpp
+//! \ingroup vtk
+//
+//======================================================================================================================
+
+#include "XDMFOutput.h"
+#include "Base64Writer.h"
+#include "UtilityFunctions.h"
+
+#include "core/Abort.h"
+#include "core/Filesystem.h"
+#include "core/logging/Logging.h"
+#include "core/mpi/Gatherv.h"
+#include "core/mpi/MPIManager.h"
+#include "core/mpi/Reduce.h"
+#include "core/selectable/IsSetSelected.h"
+#include "core/uid/GlobalState.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+
+namespace walberla {
+namespace vtk {
+namespace internal {
+
+
+
+/// maximal number of bytes that are passed to one MPI-IO call (the count argument is an int)
+static const uint_t XDMF_MAX_IO_SIZE = uint_t(1) << 30;
+
+
+
+/// converts the VTK type strings returned by BlockCellDataWriter::typeString() into XDMF number types
+static void xdmfNumberType( const std::string & vtkType, std::string & numberType, uint_t & precision )
+{
+   if     ( vtkType == "Int8"    ) { numberType = "Char";  precision = uint_t(1); }
+   else if( vtkType == "UInt8"   ) { numberType = "UChar"; precision = uint_t(1); }
+   else if( vtkType == "Int16"   ) { numberType = "Int";   precision = uint_t(2); }
+   else if( vtkType == "UInt16"  ) { numberType = "UInt";  precision = uint_t(2); }
+   else if( vtkType == "Int32"   ) { numberType = "Int";   precision = uint_t(4); }
+   else if( vtkType == "UInt32"  ) { numberType = "UInt";  precision = uint_t(4); }
+   else if( vtkType == "Int64"   ) { numberType = "Int";   precision = uint_t(8); }
+   else if( vtkType == "UInt64"  ) { numberType = "UInt";  precision = uint_t(8); }
+   else if( vtkType == "Float32" ) { numberType = "Float"; precision = uint_t(4); }
+   else if( vtkType == "Float64" ) { numberType = "Float"; precision = uint_t(8); }
+   else
+      WALBERLA_ABORT( "XDMF output: data type \"" << vtkType << "\" is not supported!" );
+}
+
+static std::string xdmfAttributeType( const uint_t fSize )
+{
+   switch( fSize )
+   {
+   case 1: return "Scalar";
+   case 3: return "Vector";
+   case 6: return "Tensor6";
+   case 9: return "Tensor";
+   default: return "Matrix";
+   }
+}
+
+static void writeXDMFHeader( std::ostream & os, const bool xinclude )
+{
+   os << "<?xml version=\"1.0\" ?>\n"
+      << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+      << "<Xdmf" << ( xinclude ? " xmlns:xi=\"http://www.w3.org/2001/XInclude\"" : "" ) << " Version=\"2.0\">\n"
+      << " <Domain>\n";
+}
+
+static void writeXDMFFooter( std::ostream & os )
+{
+   os << " </Domain>\n"
+      << "</Xdmf>\n";
+}
+
+
+
+} // namespace internal
+
+
+
+XDMFOutput::XDMFOutput( const StructuredBlockStorage & sbs, const std::string & identifier, const uint_t writeFrequency,
+                        const std::string & baseFolder, const Set<SUID> & requiredStates, const Set<SUID> & incompatibleStates ) :
+   blockStorage_( sbs ), identifier_( identifier ), writeFrequency_( writeFrequency ), baseFolder_( baseFolder ),
+   requiredStates_( requiredStates ), incompatibleStates_( incompatibleStates ), executionCounter_( uint_t(0) )
+{
+   WALBERLA_ROOT_SECTION()
+   {
+      filesystem::path path( baseFolder_ + "/" + identifier_ );
+      if( filesystem::exists( path ) )
+         filesystem::remove_all( path );
+
+      filesystem::path series( seriesFile() );
+      if( filesystem::exists( series ) )
+         std::remove( series.string().c_str() );
+
+      filesystem::create_directories( path );
+   }
+
+   WALBERLA_MPI_WORLD_BARRIER();
+}
+
+
+
+std::string XDMFOutput::rawFile( const uint_t number ) const
+{
+   std::ostringstream file;
+   file << baseFolder_ << "/" << identifier_ << "/" << identifier_ << "_" << number << ".raw";
+   return file.str();
+}
+
+std::string XDMFOutput::xdmfFile( const uint_t number ) const
+{
+   std::ostringstream file;
+   file << baseFolder_ << "/" << identifier_ << "/" << identifier_ << "_" << number << ".xmf";
+   return file.str();
+}
+
+std::string XDMFOutput::seriesFile() const
+{
+   return baseFolder_ + "/" + identifier_ + ".xmf";
+}
+
+
+
+void XDMFOutput::write()
+{
+   ++executionCounter_;
+
+   if( writeFrequency_ == uint_t(0) || ( executionCounter_ - uint_t(1) ) % writeFrequency_ != uint_t(0) )
+      return;
+
+   forceWrite( executionCounter_ - uint_t(1) );
+}
+
+
+
+void XDMFOutput::forceWrite( const uint_t number )
+{
+   for( auto func = beforeFunctions_.begin(); func != beforeFunctions_.end(); ++func )
+      ( *func )();
+
+   std::vector< const IBlock * > blocks;
+   for( auto block = blockStorage_.begin(); block != blockStorage_.end(); ++block )
+   {
+      if( selectable::isSetSelected( uid::globalState() + block->getState(), requiredStates_, incompatibleStates_ ) )
+         blocks.push_back( block.get() );
+   }
+
+   // data of all local blocks (block after block, writer after writer, x fastest, components innermost)
+
+   std::vector< char > data;
+   std::vector< std::vector< uint_t > > offsets( blocks.size() );
+
+   Base64Writer buffer;
+   for( uint_t b = 0; b != blocks.size(); ++b )
+   {
+      const IBlock & block = *( blocks[b] );
+      for( auto writer = cellDataWriter_.begin(); writer != cellDataWriter_.end(); ++writer )
+      {
+         (*writer)->configure( block, blockStorage_ );
+
+         const cell_idx_t xSize = cell_idx_c( (*writer)->xSize() );
+         const cell_idx_t ySize = cell_idx_c( (*writer)->ySize() );
+         const cell_idx_t zSize = cell_idx_c( (*writer)->zSize() );
+         const cell_idx_t fSize = cell_idx_c( (*writer)->fSize() );
+
+         buffer.clear();
+         for( cell_idx_t z = 0; z != zSize; ++z )
+            for( cell_idx_t y = 0; y != ySize; ++y )
+               for( cell_idx_t x = 0; x != xSize; ++x )
+                  for( cell_idx_t f = 0; f != fSize; ++f )
+                     (*writer)->push( buffer, x, y, z, f );
+
+         offsets[b].push_back( uint_c( data.size() ) );
+         data.insert( data.end(), buffer.rawData().begin(), buffer.rawData().end() );
+      }
+   }
+
+   // position of the process local data in the file
+
+   uint_t processOffset = uint_t(0);
+   WALBERLA_MPI_SECTION()
+   {
+      uint_t localSize = uint_c( data.size() );
+      MPI_Exscan( &localSize, &processOffset, 1, MPITrait< uint_t >::type(), MPI_SUM, MPIManager::instance()->comm() );
+      if( MPIManager::instance()->rank() == 0 )
+         processOffset = uint_t(0);
+   }
+   for( auto blockOffsets = offsets.begin(); blockOffsets != offsets.end(); ++blockOffsets )
+      for( auto offset = blockOffsets->begin(); offset != blockOffsets->end(); ++offset )
+         *offset += processOffset;
+
+   writeRawData( rawFile( number ), data, processOffset );
+
+   // XDMF description of all blocks, assembled on the root process
+
+   std::vector< std::string > grids = mpi::gatherv( std::vector< std::string >( 1, blockGrids( number, blocks, offsets ) ) );
+
+   WALBERLA_ROOT_SECTION()
+   {
+      std::ofstream ofs( xdmfFile( number ).c_str() );
+
+      internal::writeXDMFHeader( ofs, false );
+      ofs << "  <Grid Name=\"" << identifier_ << "_" << number << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n"
+          << "   <Time Value=\"" << number << "\"/>\n";
+      for( auto grid = grids.begin(); grid != grids.end(); ++grid )
+         ofs << *grid;
+      ofs << "  </Grid>\n";
+      internal::writeXDMFFooter( ofs );
+
+      ofs.close();
+
+      writtenSteps_.push_back( number );
+      writeSeries();
+   }
+}
+
+
+
+std::string XDMFOutput::blockGrids( const uint_t number, const std::vector< const IBlock * > & blocks,
+                                    const std::vector< std::vector< uint_t > > & offsets ) const
+{
+   std::ostringstream raw;
+   raw << identifier_ << "_" << number << ".raw"; // relative to the location of the XDMF file
+
+   std::string realType;
+   uint_t realPrecision;
+   internal::xdmfNumberType( typeToString< real_t >(), realType, realPrecision );
+
+   std::ostringstream os;
+   os.precision( 16 );
+
+   for( uint_t b = 0; b != blocks.size(); ++b )
+   {
+      const IBlock & block = *( blocks[b] );
+      const uint_t level = blockStorage_.getLevel( block );
+
+      const uint_t xSize = blockStorage_.getNumberOfXCells( block );
+      const uint_t ySize = blockStorage_.getNumberOfYCells( block );
+      const uint_t zSize = blockStorage_.getNumberOfZCells( block );
+
+      const AABB & aabb = block.getAABB();
+
+      os << "   <Grid Name=\"block " << block.getId() << "\" GridType=\"Uniform\">\n"
+         << "    <Topology TopologyType=\"3DCoRectMesh\" Dimensions=\"" << ( zSize + 1 ) << " " << ( ySize + 1 ) << " " << ( xSize + 1 ) << "\"/>\n"
+         << "    <Geometry GeometryType=\"ORIGIN_DXDYDZ\">\n"
+         << "     <DataItem Dimensions=\"3\" NumberType=\"" << realType << "\" Precision=\"" << realPrecision << "\" Format=\"XML\">"
+         << aabb.zMin() << " " << aabb.yMin() << " " << aabb.xMin() << "</DataItem>\n"
+         << "     <DataItem Dimensions=\"3\" NumberType=\"" << realType << "\" Precision=\"" << realPrecision << "\" Format=\"XML\">"
+         << blockStorage_.dz( level ) << " " << blockStorage_.dy( level ) << " " << blockStorage_.dx( level ) << "</DataItem>\n"
+         << "    </Geometry>\n";
+
+      for( uint_t w = 0; w != cellDataWriter_.size(); ++w )
+      {
+         const auto & writer = cellDataWriter_[w];
+         writer->configure( block, blockStorage_ );
+
+         std::string numberType;
+         uint_t precision;
+         internal::xdmfNumberType( writer->typeString(), numberType, precision );
+
+         os << "    <Attribute Name=\"" << writer->identifier() << "\" AttributeType=\"" << internal::xdmfAttributeType( writer->fSize() )
+            << "\" Center=\"Cell\">\n"
+            << "     <DataItem Dimensions=\"" << zSize << " " << ySize << " " << xSize;
+         if( writer->fSize() != uint_t(1) )
+            os << " " << writer->fSize();
+         os << "\" NumberType=\"" << numberType << "\" Precision=\"" << precision << "\" Format=\"Binary\" Endian=\"Native\" Seek=\""
+            << offsets[b][w] << "\">" << raw.str() << "</DataItem>\n"
+            << "    </Attribute>\n";
+      }
+
+      os << "   </Grid>\n";
+   }
+
+   return os.str();
+}
+
+
+
+void XDMFOutput::writeRawData( const std::string & file, const std::vector< char > & data, const uint_t offset ) const
+{
+   WALBERLA_NON_MPI_SECTION()
+   {
+      std::ofstream ofs( file.c_str(), std::ofstream::binary );
+      ofs.write( data.empty() ? nullptr : &(data[0]), numeric_cast< std::streamsize >( data.size() ) );
+      ofs.close();
+   }
+
+   WALBERLA_MPI_SECTION()
+   {
+      MPI_File mpiFile = MPI_FILE_NULL;
+      int result = MPI_File_open( MPIManager::instance()->comm(), const_cast<char*>( file.c_str() ), MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                                  MPI_INFO_NULL, &mpiFile );
+      if( result != MPI_SUCCESS )
+         WALBERLA_ABORT( "Error while opening file \"" << file << "\" for writing. MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+
+      // an existing (longer) file of an earlier run must not leave stale data at its end
+      result = MPI_File_set_size( mpiFile, MPI_Offset(0) );
+      if( result != MPI_SUCCESS )
+         WALBERLA_ABORT( "Error while truncating file \"" << file << "\". MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+
+      // collective writes: all processes must perform the same number of calls
+      uint_t calls = ( uint_c( data.size() ) + internal::XDMF_MAX_IO_SIZE - uint_t(1) ) / internal::XDMF_MAX_IO_SIZE;
+      mpi::allReduceInplace( calls, mpi::MAX );
+
+      for( uint_t call = 0; call != calls; ++call )
+      {
+         const uint_t begin = std::min( call * internal::XDMF_MAX_IO_SIZE, uint_c( data.size() ) );
+         const uint_t count = std::min( internal::XDMF_MAX_IO_SIZE, uint_c( data.size() ) - begin );
+
+         result = MPI_File_write_at_all( mpiFile, numeric_cast< MPI_Offset >( offset + begin ),
+                                         count > uint_t(0) ? const_cast< char * >( &(data[begin]) ) : nullptr,
+                                         int_c( count ), MPI_BYTE, MPI_STATUS_IGNORE );
+         if( result != MPI_SUCCESS )
+            WALBERLA_ABORT( "Error while writing to file \"" << file << "\". MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+      }
+
+      result = MPI_File_close( &mpiFile );
+      if( result != MPI_SUCCESS )
+         WALBERLA_ABORT( "Error while closing file \"" << file << "\". MPI Error is \"" << MPIManager::instance()->getMPIErrorString( result ) << "\"" );
+   }
+}
+
+
+
+void XDMFOutput::writeSeries() const
+{
+   std::ofstream ofs( seriesFile().c_str() );
+
+   internal::writeXDMFHeader( ofs, true );
+   ofs << "  <Grid Name=\"" << identifier_ << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+   for( auto step = writtenSteps_.begin(); step != writtenSteps_.end(); ++step )
+      ofs << "   <xi:include href=\"" << identifier_ << "/" << identifier_ << "_" << *step << ".xmf\" xpointer=\"xpointer(//Xdmf/Domain/Grid)\"/>\n";
+   ofs << "  </Grid>\n";
+   internal::writeXDMFFooter( ofs );
+}
+
+
+
+} // namespace vtk
+} // namespace walberla
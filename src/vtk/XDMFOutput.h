@@ -0,0 +1,124 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file XDMFOutput.h
+//! \ingroup vtk
+//
+//======================================================================================================================
+
+#pragma once
+
+#include "BlockCellDataWriter.h"
+
+#include "core/DataTypes.h"
+#include "core/NonCopyable.h"
+#include "core/uid/SUID.h"
+
+#include "domain_decomposition/StructuredBlockStorage.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace walberla {
+namespace vtk {
+
+
+
+//**********************************************************************************************************************
+/*!
+*   \brief Cell data output with one binary file per time step, described by XDMF files
+*
+*   In contrast to VTKOutput, which writes one file per block (plus collector files), XDMFOutput writes the data of
+*   all blocks of all processes into one raw binary file per time step ("<baseFolder>/<identifier>/<identifier>_<n>.raw").
+*   Every process writes its part of the file with collective MPI-IO. The root process writes an XDMF file
+*   ("<identifier>_<n>.xmf") that describes the blocks (uniform grids with their position and cell size, i.e.,
+*   refined block structures are supported) and the position of the block data within the binary file. Additionally,
+*   a temporal collection "<baseFolder>/<identifier>.xmf" that references all time steps is written, which can be
+*   opened with ParaView or VisIt.
+*
+*   The data is produced by the same BlockCellDataWriter objects that are used by VTKOutput (via their Base64Writer
+*   push function), hence all existing writers can be used:
+*   \code
+*   auto xdmf = make_shared< vtk::XDMFOutput >( *blocks, "fluid", uint_t(100) );
+*   xdmf->addCellDataWriter( make_shared< lbm::VelocityVTKWriter< LatticeModel_T > >( pdfFieldId, "velocity" ) );
+*   timeloop.addFuncAfterTimeStep( vtk::writeFiles( xdmf ), "XDMF output" );
+*   \endcode
+*   The data is stored in the native byte order, ghost layers, cell filters, and sampling are not supported.
+*/
+//**********************************************************************************************************************
+class XDMFOutput : public NonCopyable
+{
+public:
+
+   typedef std::function< void () > BeforeFunction;
+
+   XDMFOutput( const StructuredBlockStorage & sbs, const std::string & identifier, const uint_t writeFrequency = uint_t(1),
+               const std::string & baseFolder = std::string( "vtk_out" ),
+               const Set<SUID> & requiredStates = Set<SUID>::emptySet(), const Set<SUID> & incompatibleStates = Set<SUID>::emptySet() );
+
+   void addBeforeFunction( BeforeFunction f ) { beforeFunctions_.push_back( f ); }
+   void addCellDataWriter( const shared_ptr< BlockCellDataWriterInterface > & writer ) { cellDataWriter_.push_back( writer ); }
+
+   /// counts the calls and writes every 'writeFrequency' calls
+   void write();
+   /// writes time step 'number' (must be called by all processes)
+   void forceWrite( const uint_t number );
+
+   void operator()() { write(); }
+
+   const std::string & identifier() const { return identifier_; }
+
+   std::string rawFile( const uint_t number ) const;
+   std::string xdmfFile( const uint_t number ) const;
+   std::string seriesFile() const;
+
+private:
+
+   std::string blockGrids( const uint_t number, const std::vector< const IBlock * > & blocks,
+                           const std::vector< std::vector< uint_t > > & offsets ) const;
+
+   void writeRawData( const std::string & file, const std::vector< char > & data, const uint_t offset ) const;
+   void writeSeries() const;
+
+   const StructuredBlockStorage & blockStorage_;
+
+   std::string identifier_;
+   uint_t writeFrequency_;
+   std::string baseFolder_;
+
+   Set<SUID> requiredStates_;
+   Set<SUID> incompatibleStates_;
+
+   uint_t executionCounter_;
+
+   std::vector< BeforeFunction > beforeFunctions_;
+   std::vector< shared_ptr< BlockCellDataWriterInterface > > cellDataWriter_;
+
+   std::vector< uint_t > writtenSteps_; // only maintained on the root process
+};
+
+
+
+inline std::function< void () > writeFiles( const shared_ptr< XDMFOutput > & xdmf )
+{
+   return std::bind( &XDMFOutput::write, xdmf );
+}
+
+
+
+} // namespace vtk
+} // namespace walberla
@@ -0,0 +1,142 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file AsyncCheckpointWriterTest.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "blockforest/AsyncCheckpointWriter.h"
+#include "blockforest/Initialization.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "field/AddToStorage.h"
+#include "field/Field.h"
+
+#include <string>
+#include <vector>
+
+
+namespace async_checkpoint_writer_test {
+
+using namespace walberla;
+
+typedef field::GhostLayerField< double, 3 > ScalarField;
+
+static double value( const Cell & cell, const uint_t f, const uint_t step )
+{
+   return double_c( step ) * 1000.0 + double_c( cell.x() ) + 0.1 * double_c( cell.y() ) + 0.01 * double_c( cell.z() ) + 0.001 * double_c( f );
+}
+
+static void setStep( StructuredBlockForest & blocks, const BlockDataID & id, const uint_t step )
+{
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+   {
+      auto field = block->getData< ScalarField >( id );
+      for( auto it = field->begin(); it != field->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         blocks.transformBlockLocalToGlobalCell( cell, *block );
+         *it = value( cell, uint_c( it.f() ), step );
+      }
+   }
+}
+
+static void checkStep( StructuredBlockForest & blocks, const BlockDataID & id, const uint_t step )
+{
+   for( auto block = blocks.begin(); block != blocks.end(); ++block )
+   {
+      auto field = block->getData< ScalarField >( id );
+      for( auto it = field->begin(); it != field->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         blocks.transformBlockLocalToGlobalCell( cell, *block );
+         WALBERLA_CHECK_IDENTICAL( *it, value( cell, uint_c( it.f() ), step ) );
+      }
+   }
+}
+
+static std::string fileName( const uint_t step )
+{
+   return std::string( "async_checkpoint_" ) + std::to_string( step ) + ".dat";
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2) * processes, uint_t(2), uint_t(1), uint_t(8), uint_t(6), uint_t(4),
+                                                      real_t(1), processes, uint_t(1), uint_t(1) );
+
+   auto dataHandling = make_shared< field::DefaultBlockDataHandling< ScalarField > >( blocks, uint_t(1), 0.0, field::fzyx );
+   auto fieldId = blocks->addBlockData( dataHandling, "scalar" );
+
+   std::vector< std::string > completed;
+
+   {
+      blockforest::AsyncCheckpointWriter writer( blocks, { fieldId }, uint_t(2) );
+      writer.setCompletionCallback( [&]( const std::string & file, const blockforest::CheckpointStatistics & statistics ) {
+         WALBERLA_CHECK_GREATER( statistics.chunks, uint_t(0) );
+         WALBERLA_CHECK_GREATER( statistics.rawBytes, uint_t(0) );
+         completed.push_back( file );
+      } );
+
+      // the block data is modified right after each write: the checkpoints must contain the data of the snapshots
+      for( uint_t step = uint_t(1); step <= uint_t(4); ++step )
+      {
+         setStep( *blocks, fieldId, step );
+         writer.write( fileName( step ) );
+         WALBERLA_CHECK_LESS_EQUAL( writer.numberOfPendingCheckpoints(), uint_t(2) );
+         setStep( *blocks, fieldId, uint_t(0) );
+      }
+
+      writer.wait();
+      WALBERLA_CHECK_EQUAL( writer.numberOfPendingCheckpoints(), uint_t(0) );
+
+      // timeloop functor: a checkpoint every third call
+      auto functor = writer.getFunctor( "async_checkpoint_functor", uint_t(3) );
+      for( uint_t i = 0; i != uint_t(6); ++i )
+         functor();
+   } // destructor waits for the completion
+
+   WALBERLA_CHECK_EQUAL( completed.size(), uint_t(6) );
+   for( uint_t step = uint_t(1); step <= uint_t(4); ++step )
+      WALBERLA_CHECK_EQUAL( completed[ step - uint_t(1) ], fileName( step ) );
+   WALBERLA_CHECK_EQUAL( completed[4], "async_checkpoint_functor_3.dat" );
+   WALBERLA_CHECK_EQUAL( completed[5], "async_checkpoint_functor_6.dat" );
+
+   for( uint_t step = uint_t(1); step <= uint_t(4); ++step )
+   {
+      blockforest::CheckpointReader checkpoint( fileName( step ) );
+      auto id = checkpoint.loadBlockData( *blocks, "scalar", dataHandling );
+      checkStep( *blocks, id, step );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace async_checkpoint_writer_test
+
+int main( int argc, char* argv[] )
+{
+   return async_checkpoint_writer_test::main( argc, argv );
+}
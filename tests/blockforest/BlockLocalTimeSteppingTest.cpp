@@ -0,0 +1,288 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file BlockLocalTimeSteppingTest.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "blockforest/AABBRefinementSelection.h"
+#include "blockforest/BlockLocalTimeStepping.h"
+#include "blockforest/Initialization.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/BufferSystem.h"
+#include "core/mpi/Environment.h"
+#include "core/mpi/Reduce.h"
+
+#include <atomic>
+#include <limits>
+#include <map>
+#include <set>
+#include <vector>
+
+
+namespace block_local_time_stepping_test {
+
+using namespace walberla;
+using namespace walberla::blockforest;
+
+/// Every block stores two (time, value) states. A substep replaces the value by a mixture of the old value and the
+/// average of the neighbor values (interpolated in time if the neighbor is coarser). Every access checks that the
+/// scheduler provides exactly the required states.
+class Model
+{
+public:
+
+   struct State
+   {
+      State() { time[0] = time[1] = std::numeric_limits< uint_t >::max(); value[0] = value[1] = real_t(0); ghost = real_t(0); }
+      uint_t time[2];
+      real_t value[2];
+      real_t ghost;
+   };
+
+   Model( BlockForest & forest ) : forest_( forest ), step_( uint_t(0) ), units_( uint_t(0) )
+   {
+      for( auto it = forest_.getBlockMap().begin(); it != forest_.getBlockMap().end(); ++it )
+      {
+         State & state = states_[ it->first ];
+         const auto center = it->second->getAABB().center();
+         state.time[0] = uint_t(0);
+         state.value[0] = center[0] + real_t(2) * center[1] + real_t(3) * center[2];
+
+         // all remote states are allocated in advance, they are accessed concurrently
+         for( uint_t n = 0; n != it->second->getNeighborhoodSize(); ++n )
+            if( it->second->getNeighborProcess( n ) != forest_.getProcess() )
+               remoteStates_[ it->second->getNeighborId( n ) ];
+      }
+   }
+
+   void pull( Block * block, const uint_t level, const uint_t substep )
+   {
+      const uint_t start = time( level, substep );
+      State & state = states_.find( block->getId() )->second;
+      WALBERLA_CHECK_EQUAL( state.time[ ( start / length( level ) ) % uint_t(2) ], start );
+
+      real_t sum( real_t(0) );
+      for( uint_t n = 0; n != block->getNeighborhoodSize(); ++n )
+      {
+         const BlockID & id = block->getNeighborId( n );
+         const State & neighbor = ( block->getNeighborProcess( n ) == forest_.getProcess() ) ? states_.find( id )->second :
+                                                                                               remoteStates_.find( id )->second;
+         const uint_t neighborLength = length( forest_.getLevelFromBlockId( id ) );
+         const uint_t previous = start / neighborLength;
+         const uint_t next = ( start + neighborLength - uint_t(1) ) / neighborLength;
+
+         WALBERLA_CHECK_EQUAL( neighbor.time[ previous % uint_t(2) ], previous * neighborLength );
+         WALBERLA_CHECK_EQUAL( neighbor.time[ next % uint_t(2) ], next * neighborLength );
+
+         const real_t weight = real_c( start - previous * neighborLength ) / real_c( neighborLength );
+         sum += ( real_t(1) - weight ) * neighbor.value[ previous % uint_t(2) ] + weight * neighbor.value[ next % uint_t(2) ];
+      }
+      state.ghost = ( block->getNeighborhoodSize() > uint_t(0) ) ? ( sum / real_c( block->getNeighborhoodSize() ) ) : real_t(0);
+   }
+
+   void compute( Block * block, const uint_t level, const uint_t substep )
+   {
+      const uint_t start = time( level, substep );
+      const uint_t index = start / length( level );
+      State & state = states_.find( block->getId() )->second;
+      WALBERLA_CHECK_EQUAL( state.time[ index % uint_t(2) ], start );
+
+      state.value[ ( index + uint_t(1) ) % uint_t(2) ] = real_t(0.5) * state.value[ index % uint_t(2) ] + real_t(0.5) * state.ghost + real_t(0.01);
+      state.time[ ( index + uint_t(1) ) % uint_t(2) ] = start + length( level );
+      ++units_;
+   }
+
+   void communicate( const uint_t level, const uint_t k )
+   {
+      const uint_t time = step_ * length( uint_t(0) ) + k * length( level );
+      const uint_t slot = ( time / length( level ) ) % uint_t(2);
+
+      mpi::BufferSystem bufferSystem( MPIManager::instance()->comm(), 4242 );
+      const auto & neighborhood = forest_.getNeighboringProcesses();
+      bufferSystem.setReceiverInfo( std::set< mpi::MPIRank >( neighborhood.begin(), neighborhood.end() ), true );
+
+      std::map< uint_t, std::vector< const Block * > > sendBlocks;
+      for( auto it = neighborhood.begin(); it != neighborhood.end(); ++it )
+         sendBlocks[ *it ];
+      for( auto it = forest_.getBlockMap().begin(); it != forest_.getBlockMap().end(); ++it )
+      {
+         if( it->second->getLevel() != level )
+            continue;
+         std::set< uint_t > processes;
+         for( uint_t n = 0; n != it->second->getNeighborhoodSize(); ++n )
+            if( it->second->getNeighborProcess( n ) != forest_.getProcess() )
+               processes.insert( it->second->getNeighborProcess( n ) );
+         for( auto p = processes.begin(); p != processes.end(); ++p )
+            sendBlocks[ *p ].push_back( it->second.get() );
+      }
+
+      for( auto it = sendBlocks.begin(); it != sendBlocks.end(); ++it )
+      {
+         auto & buffer = bufferSystem.sendBuffer( it->first );
+         buffer << it->second.size();
+         for( auto block = it->second.begin(); block != it->second.end(); ++block )
+         {
+            const State & state = states_.find( (*block)->getId() )->second;
+            WALBERLA_CHECK_EQUAL( state.time[ slot ], time );
+            (*block)->getId().toBuffer( buffer );
+            buffer << state.time[ slot ] << state.value[ slot ];
+         }
+      }
+      bufferSystem.sendAll();
+
+      for( auto it = bufferSystem.begin(); it != bufferSystem.end(); ++it )
+      {
+         uint_t size( uint_t(0) );
+         it.buffer() >> size;
+         for( uint_t i = 0; i != size; ++i )
+         {
+            BlockID id;
+            id.fromBuffer( it.buffer() );
+            uint_t receivedTime;
+            real_t value;
+            it.buffer() >> receivedTime >> value;
+            WALBERLA_CHECK_EQUAL( receivedTime, time );
+            WALBERLA_CHECK_EQUAL( forest_.getLevelFromBlockId( id ), level );
+
+            auto remote = remoteStates_.find( id );
+            if( remote != remoteStates_.end() )
+            {
+               remote->second.time[ slot ] = receivedTime;
+               remote->second.value[ slot ] = value;
+            }
+         }
+      }
+   }
+
+   void finishTimeStep() { ++step_; }
+
+   uint_t units() const { return units_.load(); }
+
+   const std::map< BlockID, State > & states() const { return states_; }
+
+private:
+
+   uint_t length( const uint_t level ) const { return uint_t(1) << ( forest_.getDepth() - level ); }
+   uint_t time( const uint_t level, const uint_t substep ) const { return step_ * length( uint_t(0) ) + substep * length( level ); }
+
+   BlockForest & forest_;
+
+   std::map< BlockID, State > states_;
+   std::map< BlockID, State > remoteStates_;
+
+   uint_t step_;
+   std::atomic< uint_t > units_;
+};
+
+static std::map< BlockID, real_t > simulate( BlockForest & forest, const uint_t numberOfThreads, const uint_t timeSteps )
+{
+   Model model( forest );
+
+   BlockLocalTimeStepping timeStepping( forest,
+                                        [&model]( Block * block, const uint_t level, const uint_t substep ) { model.pull( block, level, substep ); },
+                                        [&model]( Block * block, const uint_t level, const uint_t substep ) { model.compute( block, level, substep ); },
+                                        [&model]( const uint_t level, const uint_t k ) { model.communicate( level, k ); },
+                                        numberOfThreads );
+
+   timeStepping.build();
+   WALBERLA_CHECK( timeStepping.getTaskGraph().isAcyclic() );
+
+   uint_t expectedUnits( uint_t(0) );
+   for( auto it = forest.getBlockMap().begin(); it != forest.getBlockMap().end(); ++it )
+      expectedUnits += uint_t(1) << it->second->getLevel();
+   WALBERLA_CHECK_EQUAL( timeStepping.numberOfUnits(), expectedUnits );
+
+   for( uint_t step = 0; step != timeSteps; ++step )
+   {
+      timeStepping();
+      model.finishTimeStep();
+   }
+   WALBERLA_CHECK_EQUAL( model.units(), timeSteps * expectedUnits );
+
+   std::map< BlockID, real_t > result;
+   for( auto it = model.states().begin(); it != model.states().end(); ++it )
+   {
+      const uint_t slot = ( timeSteps << forest.getLevelFromBlockId( it->first ) ) % uint_t(2);
+      WALBERLA_CHECK_EQUAL( it->second.time[ slot ], timeSteps << forest.getDepth() );
+      result[ it->first ] = it->second.value[ slot ];
+   }
+   return result;
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   auto forest = createBlockForestDistributed( AABB( real_t(0), real_t(0), real_t(0), real_t(4), real_t(4), real_t(4) ),
+                                               uint_t(4), uint_t(4), uint_t(4), true, true, false );
+
+   AABBRefinementSelection refinementSelection;
+   refinementSelection.addAABB( AABB( real_t(0.5), real_t(0.5), real_t(0.5), real_t(1.5), real_t(1.5), real_t(1.5) ), uint_t(2) );
+   refineBlockForestDistributed( *forest, refinementSelection );
+   WALBERLA_CHECK_EQUAL( forest->getDepth(), uint_t(2) );
+
+   const uint_t timeSteps = uint_t(3);
+
+   // the result does not depend on the number of threads
+
+   const auto reference = simulate( *forest, uint_t(1), timeSteps );
+   const auto threaded = simulate( *forest, uint_t(4), timeSteps );
+
+   WALBERLA_CHECK_EQUAL( reference.size(), threaded.size() );
+   for( auto it = reference.begin(); it != reference.end(); ++it )
+   {
+      WALBERLA_CHECK( threaded.find( it->first ) != threaded.end() );
+      WALBERLA_CHECK_IDENTICAL( it->second, threaded.find( it->first )->second );
+   }
+
+   // the task graph is rebuilt after the block structure changed
+
+   shared_ptr< Model > model = make_shared< Model >( *forest );
+   BlockLocalTimeStepping timeStepping( *forest,
+                                        [&model]( Block * block, const uint_t level, const uint_t substep ) { model->pull( block, level, substep ); },
+                                        [&model]( Block * block, const uint_t level, const uint_t substep ) { model->compute( block, level, substep ); },
+                                        [&model]( const uint_t level, const uint_t k ) { model->communicate( level, k ); },
+                                        uint_t(2) );
+   timeStepping();
+   model->finishTimeStep();
+   const uint_t units = mpi::allReduce( timeStepping.numberOfUnits(), mpi::SUM );
+
+   refinementSelection.addAABB( AABB( real_t(2.5), real_t(2.5), real_t(2.5), real_t(3.5), real_t(3.5), real_t(3.5) ), uint_t(1) );
+   refineBlockForestDistributed( *forest, refinementSelection );
+
+   model = make_shared< Model >( *forest ); // the model restarts at time zero (the initial states are exchanged again)
+   for( uint_t step = 0; step != uint_t(2); ++step )
+   {
+      timeStepping();
+      model->finishTimeStep();
+   }
+   WALBERLA_CHECK_EQUAL( model->units(), uint_t(2) * timeStepping.numberOfUnits() );
+   WALBERLA_CHECK_GREATER( mpi::allReduce( timeStepping.numberOfUnits(), mpi::SUM ), units );
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace block_local_time_stepping_test
+
+int main( int argc, char* argv[] )
+{
+   return block_local_time_stepping_test::main( argc, argv );
+}
@@ -0,0 +1,228 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file CheckpointTest.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "blockforest/Checkpoint.h"
+#include "blockforest/SetupBlockForest.h"
+#include "blockforest/StructuredBlockForest.h"
+#include "blockforest/loadbalancing/StaticCurve.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "field/AddToStorage.h"
+#include "field/Field.h"
+
+#include <cmath>
+#include <string>
+
+
+namespace checkpoint_test {
+
+using namespace walberla;
+
+typedef field::GhostLayerField< double, 2 > PdfField;
+typedef field::GhostLayerField< int, 1 >    IntField;
+
+const SUID Empty( "empty" );
+const Set<SUID> None( Set<SUID>::emptySet() );
+
+static void refinementSelectionFunction( SetupBlockForest& forest )
+{
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+      if( block->getAABB().contains( Vector3<real_t>( real_t(75) ) ) )
+         if( !block->hasFather() )
+            block->setMarker( true );
+}
+
+static void workloadMemorySUIDAssignmentFunction( SetupBlockForest& forest )
+{
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+   {
+      block->setMemory( memory_t(1) );
+      block->setWorkload( workload_t(1) );
+      if( block->getAABB().contains( Vector3<real_t>( real_t(25) ) ) )
+         block->addState( Empty );
+   }
+}
+
+// the same blocks are created for every process count, only their distribution to the processes differs
+static shared_ptr< StructuredBlockForest > createForest( const bool hilbert )
+{
+   SetupBlockForest sforest;
+
+   sforest.addRefinementSelectionFunction( refinementSelectionFunction );
+   sforest.addWorkloadMemorySUIDAssignmentFunction( workloadMemorySUIDAssignmentFunction );
+
+   sforest.init( AABB( 0, 0, 0, 100, 100, 100 ), uint_t(2), uint_t(2), uint_t(2), true, false, false );
+   sforest.balanceLoad( blockforest::StaticLevelwiseCurveBalance( hilbert ), uint_c( MPIManager::instance()->numProcesses() ) );
+
+   auto forest = make_shared< StructuredBlockForest >( make_shared< BlockForest >( uint_c( MPIManager::instance()->rank() ), sforest, true ),
+                                                       uint_t(10), uint_t(8), uint_t(14) );
+   forest->createCellBoundingBoxes();
+   return forest;
+}
+
+// values only depend on the global cell and the level, so they can be checked on any process distribution
+// (only the interior of the fields is serialized)
+static double pdfValue( const Cell & cell, const uint_t level, const uint_t f )
+{
+   return std::sin( 0.05 * double_c( cell.x() ) ) * std::cos( 0.03 * double_c( cell.y() ) ) + 0.01 * double_c( cell.z() ) +
+          double_c( level ) + double_c( f );
+}
+
+static int intValue( const Cell & cell, const uint_t level )
+{
+   return int_c( ( uint_c( cell.x() + 1 ) * uint_t(73856093) ) ^ ( uint_c( cell.y() + 1 ) * uint_t(19349663) ) ^
+                 ( uint_c( cell.z() + 1 ) * uint_t(83492791) ) ^ level ) & 0xffff;
+}
+
+static void initialize( StructuredBlockForest & forest, const BlockDataID & pdfId, const BlockDataID & intId )
+{
+   for( auto block = forest.begin( None, Empty ); block != forest.end(); ++block )
+   {
+      const uint_t level = forest.getLevel( *block );
+
+      auto pdf = block->getData< PdfField >( pdfId );
+      for( auto it = pdf->begin(); it != pdf->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         forest.transformBlockLocalToGlobalCell( cell, *block );
+         *it = pdfValue( cell, level, uint_c( it.f() ) );
+      }
+
+      auto ints = block->getData< IntField >( intId );
+      for( auto it = ints->begin(); it != ints->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         forest.transformBlockLocalToGlobalCell( cell, *block );
+         *it = intValue( cell, level );
+      }
+   }
+}
+
+static void check( StructuredBlockForest & forest, const BlockDataID & pdfId, const BlockDataID & intId )
+{
+   for( auto block = forest.begin( None, Empty ); block != forest.end(); ++block )
+   {
+      const uint_t level = forest.getLevel( *block );
+
+      auto pdf = block->getData< PdfField >( pdfId );
+      for( auto it = pdf->begin(); it != pdf->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         forest.transformBlockLocalToGlobalCell( cell, *block );
+         WALBERLA_CHECK_IDENTICAL( *it, pdfValue( cell, level, uint_c( it.f() ) ) );
+      }
+
+      auto ints = block->getData< IntField >( intId );
+      for( auto it = ints->begin(); it != ints->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         forest.transformBlockLocalToGlobalCell( cell, *block );
+         WALBERLA_CHECK_EQUAL( *it, intValue( cell, level ) );
+      }
+   }
+
+   for( auto block = forest.begin( Empty ); block != forest.end(); ++block )
+   {
+      WALBERLA_CHECK( !block->isBlockDataAllocated( pdfId ) );
+      WALBERLA_CHECK( !block->isBlockDataAllocated( intId ) );
+   }
+}
+
+static void write( const std::string & file, const bool compress )
+{
+   auto forest = createForest( true );
+
+   auto pdfHandling = make_shared< field::DefaultBlockDataHandling< PdfField > >( forest, uint_t(1), 0.0, field::fzyx );
+   auto intHandling = make_shared< field::DefaultBlockDataHandling< IntField > >( forest, uint_t(1), 0, field::fzyx );
+   auto pdfId = forest->addBlockData( pdfHandling, "pdf", None, Empty );
+   auto intId = forest->addBlockData( intHandling, "int", None, Empty );
+
+   initialize( *forest, pdfId, intId );
+
+   auto statistics = blockforest::saveCheckpoint( *forest, file, { pdfId, intId }, compress, sizeof(double) );
+   WALBERLA_LOG_INFO_ON_ROOT( "Writing " << file << ":\n" << statistics );
+
+   WALBERLA_CHECK_GREATER( statistics.chunks, uint_t(0) );
+   if( !compress )
+      WALBERLA_CHECK_EQUAL( statistics.rawBytes, statistics.storedBytes );
+}
+
+static void read( const std::string & file, const bool compress, const bool hilbert )
+{
+   auto forest = createForest( hilbert );
+
+   auto pdfHandling = make_shared< field::DefaultBlockDataHandling< PdfField > >( forest, uint_t(1), 0.0, field::fzyx );
+   auto intHandling = make_shared< field::DefaultBlockDataHandling< IntField > >( forest, uint_t(1), 0, field::fzyx );
+
+   blockforest::CheckpointReader checkpoint( file );
+   WALBERLA_CHECK_EQUAL( checkpoint.compressed(), compress );
+   WALBERLA_CHECK( checkpoint.hasBlockData( "pdf" ) );
+   WALBERLA_CHECK( checkpoint.hasBlockData( "int" ) );
+   WALBERLA_CHECK( !checkpoint.hasBlockData( "velocity" ) );
+
+   // items can be read in arbitrary order
+   auto intId = checkpoint.loadBlockData( *forest, "int", intHandling, None, Empty );
+   auto pdfId = checkpoint.loadBlockData( *forest, "pdf", pdfHandling, None, Empty );
+   WALBERLA_LOG_INFO_ON_ROOT( "Reading " << file << ":\n" << checkpoint.statistics() );
+
+   check( *forest, pdfId, intId );
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   // "write" / "read": a checkpoint is written by one run and read by another run that possibly uses a different
+   // number of processes, otherwise the checkpoint is read back with a different process distribution of the blocks
+   const std::string mode = ( argc > 1 ) ? std::string( argv[1] ) : std::string();
+
+   if( mode == "write" )
+   {
+      write( "checkpoint.dat", true );
+   }
+   else if( mode == "read" )
+   {
+      read( "checkpoint.dat", true, false );
+   }
+   else
+   {
+      write( "checkpoint_compressed.dat", true );
+      write( "checkpoint_raw.dat", false );
+
+      WALBERLA_MPI_BARRIER()
+
+      read( "checkpoint_compressed.dat", true, false );
+      read( "checkpoint_raw.dat", false, true );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace checkpoint_test
+
+int main( int argc, char* argv[] )
+{
+   return checkpoint_test::main( argc, argv );
+}
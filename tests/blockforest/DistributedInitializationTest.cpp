@@ -0,0 +1,180 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file DistributedInitializationTest.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "blockforest/AABBRefinementSelection.h"
+#include "blockforest/BlockForest.h"
+#include "blockforest/Initialization.h"
+#include "blockforest/SetupBlockForest.h"
+#include "blockforest/loadbalancing/DynamicCurve.h"
+#include "blockforest/loadbalancing/NoPhantomData.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+#include "core/mpi/Gatherv.h"
+#include "core/mpi/Reduce.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+
+namespace distributed_initialization_test {
+
+using namespace walberla;
+using namespace walberla::blockforest;
+
+/// block ID and process of every block of the distributed forest (gathered on all processes)
+static std::map< BlockID::IDType, uint_t > globalBlocks( const BlockForest & forest )
+{
+   std::vector< uint_t > local;
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+   {
+      local.push_back( uint_c( block->getId().getID() ) );
+      local.push_back( forest.getProcess() );
+   }
+   const std::vector< uint_t > all = mpi::allGatherv( local );
+
+   std::map< BlockID::IDType, uint_t > blocks;
+   for( uint_t i = 0; i < all.size(); i += 2 )
+   {
+      WALBERLA_CHECK( blocks.find( all[i] ) == blocks.end(), "Block " << all[i] << " exists twice!" );
+      blocks[ all[i] ] = all[i+1];
+   }
+   return blocks;
+}
+
+/// compares the distributed forest with a SetupBlockForest that was refined/initialized in the same way
+static void compare( const BlockForest & forest, const SetupBlockForest & sforest )
+{
+   WALBERLA_CHECK_EQUAL( forest.getTreeIdDigits(), sforest.getTreeIdDigits() );
+   WALBERLA_CHECK_EQUAL( forest.getDepth(), sforest.getDepth() );
+
+   const auto blocks = globalBlocks( forest );
+   WALBERLA_CHECK_EQUAL( blocks.size(), sforest.getNumberOfBlocks() );
+
+   std::set< uint_t > neighborProcesses;
+
+   for( auto it = forest.getBlockMap().begin(); it != forest.getBlockMap().end(); ++it )
+   {
+      const Block * block = it->second.get();
+      const SetupBlock * setupBlock = sforest.getBlock( block->getId() );
+      WALBERLA_CHECK_NOT_NULLPTR( setupBlock );
+      WALBERLA_CHECK_EQUAL( block->getAABB(), setupBlock->getAABB() );
+      WALBERLA_CHECK_EQUAL( block->getLevel(), setupBlock->getLevel() );
+
+      // same neighbors, the processes of the neighbors match the processes of the (remote) blocks
+
+      WALBERLA_CHECK_EQUAL( block->getNeighborhoodSize(), setupBlock->getNeighborhoodSize() );
+      for( uint_t n = 0; n != block->getNeighborhoodSize(); ++n )
+      {
+         const BlockID & id = block->getNeighborId(n);
+         bool found( false );
+         for( uint_t s = 0; s != setupBlock->getNeighborhoodSize(); ++s )
+            found = found || ( setupBlock->getNeighborId(s) == id );
+         WALBERLA_CHECK( found );
+
+         WALBERLA_CHECK( blocks.find( id.getID() ) != blocks.end() );
+         WALBERLA_CHECK_EQUAL( block->getNeighborProcess(n), blocks.find( id.getID() )->second );
+         if( block->getNeighborProcess(n) != forest.getProcess() )
+            neighborProcesses.insert( block->getNeighborProcess(n) );
+      }
+      for( uint_t i = 0; i != 26; ++i )
+         WALBERLA_CHECK_EQUAL( block->getNeighborhoodSectionSize(i), setupBlock->getNeighborhoodSectionSize(i) );
+   }
+
+   const auto & neighborhood = forest.getNeighborhood();
+   WALBERLA_CHECK( std::set< uint_t >( neighborhood.begin(), neighborhood.end() ) == neighborProcesses );
+}
+
+static void testUniform( const uint_t xSize, const uint_t ySize, const uint_t zSize, const bool periodic )
+{
+   const AABB domain( real_t(0), real_t(0), real_t(0), real_c( xSize ), real_c( ySize ), real_c( zSize ) );
+
+   auto forest = createBlockForestDistributed( domain, xSize, ySize, zSize, periodic, false, periodic );
+
+   SetupBlockForest sforest;
+   sforest.init( domain, xSize, ySize, zSize, periodic, false, periodic );
+
+   compare( *forest, sforest );
+
+   // contiguous pieces of the curve of (almost) equal size
+
+   const uint_t blocks = forest->getNumberOfBlocks();
+   WALBERLA_CHECK_LESS_EQUAL( mpi::allReduce( blocks, mpi::MAX ) - mpi::allReduce( blocks, mpi::MIN ), uint_t(1) );
+}
+
+static void testRefinement()
+{
+   const AABB domain( real_t(0), real_t(0), real_t(0), real_t(4), real_t(3), real_t(2) );
+
+   AABBRefinementSelection refinementSelection;
+   refinementSelection.addAABB( AABB( real_t(0.5), real_t(0.5), real_t(0.5), real_t(1.2), real_t(1.2), real_t(0.8) ), uint_t(3) );
+   refinementSelection.addRegion( AABB( real_t(0.9), real_t(0.9), real_t(0.9), real_t(1), real_t(1), real_t(1) ), uint_t(1) );
+
+   SetupBlockForest sforest;
+   sforest.addRefinementSelectionFunction( std::function< void ( SetupBlockForest & ) >( refinementSelection ) );
+   sforest.init( domain, uint_t(4), uint_t(3), uint_t(2), true, false, false );
+
+   auto forest = createBlockForestDistributed( domain, uint_t(4), uint_t(3), uint_t(2), true, false, false );
+   forest->setRefreshPhantomBlockMigrationPreparationFunction( DynamicCurveBalance< NoPhantomData >( true, true ) );
+
+   refineBlockForestDistributed( *forest, refinementSelection );
+
+   WALBERLA_CHECK_EQUAL( sforest.getDepth(), uint_t(3) );
+   compare( *forest, sforest );
+
+   for( uint_t level = 0; level <= sforest.getDepth(); ++level )
+   {
+      WALBERLA_CHECK_EQUAL( mpi::allReduce( forest->getNumberOfBlocks( level ), mpi::SUM ), sforest.getNumberOfBlocks( level ) );
+   }
+
+   // the refined blocks were redistributed (level-wise)
+
+   for( uint_t level = 0; level <= sforest.getDepth(); ++level )
+   {
+      const uint_t blocks = forest->getNumberOfBlocks( level );
+      WALBERLA_CHECK_LESS_EQUAL( mpi::allReduce( blocks, mpi::MAX ) - mpi::allReduce( blocks, mpi::MIN ), uint_t(1) );
+   }
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   testUniform( uint_t(1), uint_t(1), uint_t(1), true );
+   testUniform( uint_t(5), uint_t(3), uint_t(7), false );
+   testUniform( uint_t(5), uint_t(3), uint_t(7), true );
+   testUniform( uint_t(2), uint_t(9), uint_t(1), true );
+
+   testRefinement();
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace distributed_initialization_test
+
+int main( int argc, char* argv[] )
+{
+   return distributed_initialization_test::main( argc, argv );
+}
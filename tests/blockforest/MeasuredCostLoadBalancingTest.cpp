@@ -0,0 +1,140 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file MeasuredCostLoadBalancingTest.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+#include "blockforest/loadbalancing/DynamicCurve.h"
+#include "blockforest/loadbalancing/MeasuredCost.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+#include "core/mpi/Reduce.h"
+
+#include "timeloop/SweepTimeloop.h"
+
+
+namespace measured_cost_load_balancing_test {
+
+using namespace walberla;
+
+/// synthetic cost of a block: the blocks that are initially assigned to the first process are ten times as expensive
+static double syntheticCost( const IBlock & block )
+{
+   return ( block.getAABB().xMin() < real_t(6) ) ? 10.0 : 1.0;
+}
+
+static void testWindow()
+{
+   blockforest::MeasuredBlockCost cost;
+   WALBERLA_CHECK( !cost.measured() );
+   WALBERLA_CHECK_IDENTICAL( cost.cost(), 0.0 );
+
+   for( uint_t step = 1; step <= uint_t(4); ++step )
+   {
+      cost.add( 0.5 * double_c( step ) );
+      cost.add( 0.5 * double_c( step ) );
+      cost.finishTimeStep( uint_t(3) );
+   }
+   WALBERLA_CHECK( cost.measured() );
+   WALBERLA_CHECK_EQUAL( cost.samples().size(), uint_t(3) );
+   WALBERLA_CHECK_FLOAT_EQUAL( cost.cost(), 3.0 );
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   testWindow();
+
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+   const uint_t numberOfBlocks = uint_t(6) * processes;
+
+   auto blocks = blockforest::createUniformBlockGrid( numberOfBlocks, uint_t(1), uint_t(1), uint_t(4), uint_t(4), uint_t(4),
+                                                      real_t(0.25), processes, uint_t(1), uint_t(1) );
+   auto & forest = blocks->getBlockForest();
+
+   forest.recalculateBlockLevelsInRefresh( false );
+   forest.setRefreshPhantomBlockMigrationPreparationFunction(
+            blockforest::DynamicCurveBalance< blockforest::MeasuredCostLoadBalancing::PhantomBlockWeight >( false, true, true ) );
+
+   const uint_t windowSize = uint_t(5);
+   const uint_t checkFrequency = uint_t(5);
+   blockforest::MeasuredCostLoadBalancing balancing( forest, windowSize, 1.5, checkFrequency );
+   balancing.registerWeightFunctions();
+
+   // measured wall time of the sweeps
+
+   SweepTimeloop timeloop( forest, uint_t(2) );
+   uint_t sweeps( uint_t(0) );
+   timeloop.add() << Sweep( [&sweeps]( IBlock * ) { ++sweeps; }, "sweep" );
+   timeloop.setBlockTimingFunction( balancing.getRecordingFunction() );
+   timeloop.addFuncAfterTimeStep( [&balancing]() { balancing.finishTimeStep(); }, "finish time step" );
+   timeloop.run();
+
+   WALBERLA_CHECK_EQUAL( sweeps, uint_t(2) * uint_t(6) );
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+   {
+      auto cost = block->getData< blockforest::MeasuredBlockCost >( balancing.getCostDataID() );
+      WALBERLA_CHECK_EQUAL( cost->samples().size(), uint_t(2) );
+      WALBERLA_CHECK_GREATER_EQUAL( balancing.cost( *block ), 0.0 );
+   }
+
+   // synthetic costs -> the imbalance triggers exactly one rebalancing
+
+   SweepTimeloop synthetic( forest, uint_t(2) * checkFrequency );
+   synthetic.add() << Sweep( []( IBlock * ) {}, "sweep" );
+   synthetic.setBlockTimingFunction( [&balancing]( IBlock * block, const double ) { balancing.record( block, syntheticCost( *block ) ); } );
+   synthetic.addFuncAfterTimeStep( balancing.getTimeStepFunction(), "measured cost load balancing" );
+
+   const double expectedImbalance = ( processes == uint_t(1) ) ? 1.0 : 60.0 / ( ( 60.0 + 6.0 * double_c( processes - uint_t(1) ) ) / double_c( processes ) );
+
+   for( uint_t step = 0; step != checkFrequency; ++step )
+      synthetic.singleStep();
+
+   WALBERLA_CHECK_FLOAT_EQUAL( balancing.lastImbalance(), expectedImbalance );
+   WALBERLA_CHECK_EQUAL( balancing.numberOfRebalances(), ( processes == uint_t(1) ) ? uint_t(0) : uint_t(1) );
+   WALBERLA_CHECK_EQUAL( mpi::allReduce( forest.getNumberOfBlocks(), mpi::SUM ), numberOfBlocks );
+
+   // the measurements migrated with the blocks
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+      WALBERLA_CHECK_FLOAT_EQUAL( balancing.cost( *block ), syntheticCost( *block ) );
+
+   if( processes > uint_t(1) )
+   {
+      WALBERLA_CHECK_LESS( balancing.imbalance(), 1.5 );
+   }
+
+   for( uint_t step = 0; step != checkFrequency; ++step )
+      synthetic.singleStep();
+
+   WALBERLA_CHECK_LESS_EQUAL( balancing.lastImbalance(), 1.5 );
+   WALBERLA_CHECK_EQUAL( balancing.numberOfRebalances(), ( processes == uint_t(1) ) ? uint_t(0) : uint_t(1) );
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace measured_cost_load_balancing_test
+
+int main( int argc, char* argv[] )
+{
+   return measured_cost_load_balancing_test::main( argc, argv );
+}
@@ -0,0 +1,195 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file StaticCurveBisectionTest.cpp
+//! \ingroup blockforest
+//
+//======================================================================================================================
+
+#include "blockforest/BlockForest.h"
+#include "blockforest/BlockForestEvaluation.h"
+#include "blockforest/SetupBlockForest.h"
+#include "blockforest/loadbalancing/StaticCurve.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+namespace static_curve_bisection_test {
+
+using namespace walberla;
+using namespace walberla::blockforest;
+
+static void assignWorkloadAndMemory( SetupBlockForest & forest )
+{
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+   {
+      const auto center = block->getAABB().center();
+      const uint_t x = uint_c( center[0] );
+      const uint_t y = uint_c( center[1] );
+      const uint_t z = uint_c( center[2] );
+      block->setWorkload( workload_c( uint_t(1) + ( uint_t(7) * x + uint_t(3) * y + z ) % uint_t(5) ) );
+      block->setMemory( memory_t(1) );
+   }
+}
+
+static void init( SetupBlockForest & forest, const uint_t xSize, const uint_t ySize, const uint_t zSize )
+{
+   forest.addWorkloadMemorySUIDAssignmentFunction( assignWorkloadAndMemory );
+   forest.init( AABB( real_t(0), real_t(0), real_t(0), real_c( xSize ), real_c( ySize ), real_c( zSize ) ), xSize, ySize, zSize,
+                false, false, false );
+}
+
+static std::vector< workload_t > processWorkload( SetupBlockForest & forest, const uint_t numberOfProcesses )
+{
+   std::vector< workload_t > workload( numberOfProcesses, workload_t(0) );
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+      workload[ block->getTargetProcess() ] += block->getWorkload();
+   return workload;
+}
+
+/// optimal bottleneck of a partitioning of the Hilbert curve into contiguous pieces (dynamic programming)
+static workload_t optimalBottleneck( SetupBlockForest & forest, const uint_t numberOfProcesses )
+{
+   std::vector< SetupBlock * > blocks;
+   forest.getHilbertOrder( blocks );
+   const uint_t n = uint_c( blocks.size() );
+
+   std::vector< workload_t > prefix( n + uint_t(1), workload_t(0) );
+   for( uint_t i = 0; i != n; ++i )
+      prefix[i+1] = prefix[i] + blocks[i]->getWorkload();
+
+   // best[i]: optimal bottleneck for the first i blocks with the current number of processes
+   std::vector< workload_t > best( prefix );
+   for( uint_t p = 1; p < numberOfProcesses; ++p )
+   {
+      std::vector< workload_t > next( n + uint_t(1), std::numeric_limits< workload_t >::max() );
+      for( uint_t i = 0; i <= n; ++i )
+         for( uint_t j = 0; j <= i; ++j )
+            next[i] = std::min( next[i], std::max( best[j], prefix[i] - prefix[j] ) );
+      best = next;
+   }
+   return best[n];
+}
+
+static void testOptimalCuts()
+{
+   for( uint_t numberOfProcesses : { uint_t(3), uint_t(7), uint_t(16), uint_t(120) } )
+   {
+      SetupBlockForest forest;
+      init( forest, uint_t(6), uint_t(5), uint_t(4) );
+
+      forest.balanceLoad( StaticLevelwiseCurveBalanceWeighted( true ), numberOfProcesses );
+      const auto greedy = processWorkload( forest, forest.getNumberOfProcesses() );
+
+      forest.balanceLoad( StaticCurveBalanceBisection( true ), numberOfProcesses );
+      WALBERLA_CHECK_EQUAL( forest.getNumberOfProcesses(), numberOfProcesses );
+      const auto bisection = processWorkload( forest, forest.getNumberOfProcesses() );
+
+      const workload_t bottleneck = *std::max_element( bisection.begin(), bisection.end() );
+      WALBERLA_CHECK_FLOAT_EQUAL( bottleneck, optimalBottleneck( forest, numberOfProcesses ) );
+      WALBERLA_CHECK_LESS_EQUAL( bottleneck, *std::max_element( greedy.begin(), greedy.end() ) );
+   }
+}
+
+static void testMemoryLimit()
+{
+   const uint_t numberOfProcesses = uint_t(16);
+   const memory_t limit = memory_t(9);
+
+   SetupBlockForest forest;
+   init( forest, uint_t(6), uint_t(5), uint_t(4) );
+
+   forest.balanceLoad( StaticCurveBalanceBisection( true ), numberOfProcesses );
+   const auto unlimited = processWorkload( forest, numberOfProcesses );
+
+   forest.balanceLoad( StaticCurveBalanceBisection( true ), numberOfProcesses, uint_t(0), limit );
+   const auto limited = processWorkload( forest, forest.getNumberOfProcesses() );
+
+   std::vector< memory_t > memory( forest.getNumberOfProcesses(), memory_t(0) );
+   for( auto block = forest.begin(); block != forest.end(); ++block )
+      memory[ block->getTargetProcess() ] += block->getMemory();
+   for( auto m = memory.begin(); m != memory.end(); ++m )
+      WALBERLA_CHECK_LESS_EQUAL( *m, limit );
+
+   WALBERLA_CHECK_GREATER_EQUAL( *std::max_element( limited.begin(), limited.end() ),
+                                 *std::max_element( unlimited.begin(), unlimited.end() ) );
+}
+
+static void testCommunicationStatistics()
+{
+   SetupBlockForest forest;
+   init( forest, uint_t(8), uint_t(1), uint_t(1) );
+   forest.balanceLoad( StaticCurveBalanceBisection( false, false ), uint_t(2) );
+
+   auto statistics = BlockForestEvaluation::communicationStatistics( forest );
+   WALBERLA_CHECK_EQUAL( statistics.totalEdgeCut(), uint_t(1) );
+   WALBERLA_CHECK_FLOAT_EQUAL( statistics.communicationVolume.sum, real_t(2) );
+   WALBERLA_CHECK_FLOAT_EQUAL( statistics.neighborProcesses.min, real_t(1) );
+   WALBERLA_CHECK_FLOAT_EQUAL( statistics.neighborProcesses.max, real_t(1) );
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   testOptimalCuts();
+   testMemoryLimit();
+   testCommunicationStatistics();
+
+   // the statistics of the setup forest match the statistics of the distributed forest
+
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+
+   SetupBlockForest sforest;
+   init( sforest, uint_t(4), uint_t(3), uint_t(3) );
+   sforest.balanceLoad( StaticCurveBalanceBisection( true ), processes );
+   WALBERLA_CHECK_EQUAL( sforest.getNumberOfProcesses(), processes );
+
+   const auto expected = BlockForestEvaluation::communicationStatistics( sforest );
+
+   BlockForest forest( uint_c( MPIManager::instance()->rank() ), sforest );
+   BlockForestEvaluation evaluation( forest );
+   WALBERLA_LOG_INFO_ON_ROOT( evaluation.toString() );
+
+   WALBERLA_ROOT_SECTION()
+   {
+      const auto & statistics = evaluation.communicationStatistics();
+      WALBERLA_CHECK_EQUAL( statistics.totalEdgeCut(), expected.totalEdgeCut() );
+      WALBERLA_CHECK_FLOAT_EQUAL( statistics.communicationVolume.sum, expected.communicationVolume.sum );
+      WALBERLA_CHECK_FLOAT_EQUAL( statistics.neighborProcesses.max, expected.neighborProcesses.max );
+      WALBERLA_CHECK_FLOAT_EQUAL( statistics.edgeCut.max, expected.edgeCut.max );
+      if( processes == uint_t(1) )
+      {
+         WALBERLA_CHECK_EQUAL( statistics.totalEdgeCut(), uint_t(0) );
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace static_curve_bisection_test
+
+int main( int argc, char* argv[] )
+{
+   return static_curve_bisection_test::main( argc, argv );
+}
@@ -0,0 +1,156 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file UniformHybridSchemeTest.cpp
+//! \ingroup comm
+//! \brief Compares the ghost layers obtained with the UniformHybridScheme (several fields in one message) to the
+//!        ghost layers obtained with the UniformBufferedScheme
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+#include "blockforest/communication/UniformHybridScheme.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "field/AddToStorage.h"
+#include "field/communication/PackInfo.h"
+#include "field/communication/UniformMPIDatatypeInfo.h"
+#include "field/iterators/IteratorMacros.h"
+
+#include "stencil/D3Q27.h"
+
+
+namespace walberla {
+
+typedef GhostLayerField<real_t,19> PdfField;
+typedef GhostLayerField<int,1>     IntField;
+
+typedef stencil::D3Q27 Stencil;
+
+
+// uses the default local copy of the base class (pack/unpack with the MPI datatypes) instead of the slice copy
+template< typename Field_T >
+class DefaultLocalCopyDatatypeInfo : public field::communication::UniformMPIDatatypeInfo< Field_T >
+{
+public:
+   DefaultLocalCopyDatatypeInfo( const BlockDataID & id ) : field::communication::UniformMPIDatatypeInfo< Field_T >( id ) {}
+
+   virtual void communicateLocal( IBlock * sender, IBlock * receiver, const stencil::Direction dir )
+   {
+      walberla::communication::UniformMPIDatatypeInfo::communicateLocal( sender, receiver, dir );
+   }
+};
+
+
+// interior: unique value depending on global cell, f and time step; ghost layers: garbage
+template< typename Field_T >
+void initField( StructuredBlockForest & blocks, IBlock & block, Field_T & field, const int step )
+{
+   WALBERLA_FOR_ALL_CELLS_INCLUDING_GHOST_LAYER_XYZ( &field,
+      Cell global( x, y, z );
+      blocks.transformBlockLocalToGlobalCell( global, block );
+      const bool interior = field.xyzSize().contains( x, y, z );
+      for( uint_t f = 0; f < Field_T::F_SIZE; ++f )
+      {
+         const int value = ( ( int_c( global.x() ) * 97 + int_c( global.y() ) ) * 97 + int_c( global.z() ) ) * 31 + int_c( f ) + step * 1000003;
+         field.get( x, y, z, cell_idx_c( f ) ) = interior ? typename Field_T::value_type( value ) : typename Field_T::value_type( -1 );
+      }
+   )
+}
+
+
+template< typename Field_T >
+void compareFields( const Field_T & hybrid, const Field_T & reference )
+{
+   WALBERLA_FOR_ALL_CELLS_INCLUDING_GHOST_LAYER_XYZ( &hybrid,
+      for( uint_t f = 0; f < Field_T::F_SIZE; ++f )
+         WALBERLA_CHECK_IDENTICAL( hybrid.get( x, y, z, cell_idx_c( f ) ), reference.get( x, y, z, cell_idx_c( f ) ) );
+   )
+}
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+   mpi::Environment env( argc, argv );
+
+   auto blocks = blockforest::createUniformBlockGrid( 4, 2, 2,      // blocks
+                                                      3, 4, 5,      // cells per block
+                                                      real_t(1),    // dx
+                                                      uint_t(0), false, false,
+                                                      true, true, true ); // periodicity
+
+   // fields communicated with the hybrid scheme
+   const BlockDataID pdfId    = field::addToStorage<PdfField> ( blocks, "pdf",  real_t(0), field::fzyx, uint_t(2) );
+   const BlockDataID tmpId    = field::addToStorage<PdfField> ( blocks, "tmp",  real_t(0), field::fzyx, uint_t(2) );
+   const BlockDataID intId   = field::addToStorage<IntField>( blocks, "int", 0,         field::zyxf, uint_t(1) );
+
+   // reference fields communicated with the buffered scheme
+   const BlockDataID pdfRefId  = field::addToStorage<PdfField> ( blocks, "pdfRef",  real_t(0), field::fzyx, uint_t(2) );
+   const BlockDataID intRefId = field::addToStorage<IntField>( blocks, "intRef", 0,         field::zyxf, uint_t(1) );
+
+   blockforest::communication::UniformHybridScheme<Stencil> hybridScheme( blocks );
+   hybridScheme.addDataToCommunicate( make_shared< field::communication::UniformMPIDatatypeInfo<PdfField>  >( pdfId ) );
+   hybridScheme.addDataToCommunicate( make_shared< DefaultLocalCopyDatatypeInfo<IntField> >( intId ) );
+
+   blockforest::communication::UniformBufferedScheme<Stencil> referenceScheme( blocks );
+   referenceScheme.addPackInfo( make_shared< field::communication::PackInfo<PdfField>  >( pdfRefId ) );
+   referenceScheme.addPackInfo( make_shared< field::communication::PackInfo<IntField> >( intRefId ) );
+
+   // each block has one neighbor in each of the 26 directions, either local or remote
+   WALBERLA_CHECK_EQUAL( hybridScheme.numberOfMessages() + hybridScheme.numberOfLocalCopies(), blocks->getNumberOfBlocks() * uint_t(26) );
+
+   for( int step = 0; step < 4; ++step )
+   {
+      for( auto block = blocks->begin(); block != blocks->end(); ++block )
+      {
+         // the pdf field is swapped with the tmp field in every step to exercise the cached datatypes
+         initField( *blocks, *block, *block->getData<PdfField>( tmpId ), step );
+         block->getData<PdfField>( pdfId )->swapDataPointers( block->getData<PdfField>( tmpId ) );
+
+         initField( *blocks, *block, *block->getData<IntField>( intId ),    step );
+         initField( *blocks, *block, *block->getData<PdfField> ( pdfRefId ),  step );
+         initField( *blocks, *block, *block->getData<IntField>( intRefId ), step );
+      }
+
+      if( step % 2 == 0 )
+         hybridScheme();
+      else
+      {
+         hybridScheme.startCommunication();
+         hybridScheme.wait();
+      }
+      referenceScheme();
+
+      for( auto block = blocks->begin(); block != blocks->end(); ++block )
+      {
+         compareFields( *block->getData<PdfField> ( pdfId ),  *block->getData<PdfField> ( pdfRefId ) );
+         compareFields( *block->getData<IntField>( intId ), *block->getData<IntField>( intRefId ) );
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace walberla
+
+
+int main( int argc, char ** argv )
+{
+   return walberla::main( argc, argv );
+}
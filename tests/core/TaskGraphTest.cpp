@@ -0,0 +1,170 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file TaskGraphTest.cpp
+//! \ingroup core
+//
+//======================================================================================================================
+
+#include "core/TaskGraph.h"
+#include "core/debug/TestSubsystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+namespace task_graph_test {
+
+using namespace walberla;
+
+/// random DAG (dependencies only point from smaller to larger task IDs), every task checks that all of its
+/// predecessors are finished
+static void testRandomGraph( const uint_t numberOfThreads )
+{
+   const uint_t numberOfTasks = uint_t(2000);
+
+   TaskGraph graph;
+   std::vector< std::atomic< uint_t > > executions( numberOfTasks );
+   std::vector< std::vector< uint_t > > predecessors( numberOfTasks );
+   std::atomic< uint_t > wrongThread( uint_t(0) );
+   const std::thread::id master = std::this_thread::get_id();
+
+   for( uint_t i = 0; i != numberOfTasks; ++i )
+   {
+      executions[i].store( uint_t(0) );
+      const bool masterOnly = ( i % uint_t(97) == uint_t(0) );
+      graph.addTask( [&,i,masterOnly]()
+      {
+         for( auto p = predecessors[i].begin(); p != predecessors[i].end(); ++p )
+            WALBERLA_CHECK_EQUAL( executions[*p].load(), executions[i].load() + uint_t(1) );
+         if( masterOnly && std::this_thread::get_id() != master )
+            ++wrongThread;
+         ++( executions[i] );
+      }, masterOnly );
+   }
+
+   std::mt19937 generator( 42 );
+   for( uint_t i = 1; i != numberOfTasks; ++i )
+   {
+      std::uniform_int_distribution< uint_t > distribution( i > uint_t(50) ? i - uint_t(50) : uint_t(0), i - uint_t(1) );
+      for( uint_t d = 0; d != uint_t(3); ++d )
+      {
+         const uint_t predecessor = distribution( generator );
+         if( std::find( predecessors[i].begin(), predecessors[i].end(), predecessor ) == predecessors[i].end() )
+            predecessors[i].push_back( predecessor );
+         graph.addDependency( predecessor, i ); // duplicates are ignored
+      }
+   }
+
+   WALBERLA_CHECK( graph.isAcyclic() );
+   WALBERLA_CHECK_EQUAL( graph.numberOfTasks(), numberOfTasks );
+
+   uint_t dependencies( uint_t(0) );
+   for( auto p = predecessors.begin(); p != predecessors.end(); ++p )
+      dependencies += p->size();
+   WALBERLA_CHECK_EQUAL( graph.numberOfDependencies(), dependencies );
+
+   // the graph can be executed repeatedly
+   for( uint_t run = 1; run <= uint_t(3); ++run )
+   {
+      graph.execute( numberOfThreads );
+      for( uint_t i = 0; i != numberOfTasks; ++i )
+         WALBERLA_CHECK_EQUAL( executions[i].load(), run );
+   }
+   WALBERLA_CHECK_EQUAL( wrongThread.load(), uint_t(0) );
+   if( numberOfThreads == uint_t(1) )
+   {
+      WALBERLA_CHECK_EQUAL( graph.stolenTasks(), uint_t(0) );
+   }
+}
+
+static void testCycle()
+{
+   TaskGraph graph;
+   auto a = graph.addTask( [](){} );
+   auto b = graph.addTask( [](){} );
+   auto c = graph.addTask( [](){} );
+   graph.addDependency( a, b );
+   graph.addDependency( b, c );
+   WALBERLA_CHECK( graph.isAcyclic() );
+   graph.addDependency( c, a );
+   WALBERLA_CHECK( !graph.isAcyclic() );
+
+   graph.clear();
+   WALBERLA_CHECK_EQUAL( graph.numberOfTasks(), uint_t(0) );
+   WALBERLA_CHECK( graph.isAcyclic() );
+   graph.execute( uint_t(4) );
+}
+
+/// master-only tasks that become ready at the same time are executed in the order in which they were added
+static void testMasterOrder()
+{
+   TaskGraph graph;
+   std::vector< uint_t > order;
+   for( uint_t i = 0; i != uint_t(10); ++i )
+      graph.addTask( [&order,i]() { order.push_back( i ); }, true );
+   graph.execute( uint_t(3) );
+
+   WALBERLA_CHECK_EQUAL( order.size(), uint_t(10) );
+   for( uint_t i = 0; i != uint_t(10); ++i )
+      WALBERLA_CHECK_EQUAL( order[i], i );
+}
+
+/// a chain of tasks keeps all threads but one idle, the worker threads are reused or restarted between executions
+static void testChain()
+{
+   TaskGraph graph;
+   std::vector< uint_t > order;
+   for( uint_t i = 0; i != uint_t(100); ++i )
+   {
+      graph.addTask( [&order,i]() { order.push_back( i ); } );
+      if( i > uint_t(0) )
+         graph.addDependency( i - uint_t(1), i );
+   }
+
+   const uint_t numberOfThreads[] = { uint_t(4), uint_t(4), uint_t(2), uint_t(1), uint_t(4) };
+   for( auto threads = std::begin( numberOfThreads ); threads != std::end( numberOfThreads ); ++threads )
+   {
+      order.clear();
+      graph.execute( *threads );
+      WALBERLA_CHECK_EQUAL( order.size(), uint_t(100) );
+      for( uint_t i = 0; i != uint_t(100); ++i )
+         WALBERLA_CHECK_EQUAL( order[i], i );
+   }
+}
+
+int main( int /*argc*/, char** /*argv*/ )
+{
+   debug::enterTestMode();
+
+   testRandomGraph( uint_t(1) );
+   testRandomGraph( uint_t(4) );
+   testCycle();
+   testMasterOrder();
+   testChain();
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace task_graph_test
+
+int main( int argc, char* argv[] )
+{
+   return task_graph_test::main( argc, argv );
+}
@@ -330,6 +330,69 @@ void selfSend()
    }
 }
 
+/**
+ * Same as symmetricCommunication, but over several steps with persistent requests.
+ * After some steps the message size is increased, which invalidates the persistent requests.
+ */
+void persistentRequests()
+{
+   auto mpiManager = MPIManager::instance();
+
+   int numProcesses  = mpiManager->numProcesses();
+   int rank          = mpiManager->worldRank();
+   int leftNeighbor  = (rank-1+numProcesses)  % numProcesses;
+   int rightNeighbor = (rank+1) % numProcesses;
+
+   WALBERLA_CHECK_GREATER_EQUAL( numProcesses, 3 );
+
+   BufferSystem bs ( MPI_COMM_WORLD, 11 );
+   bs.usePersistentRequests( true );
+
+   std::set<mpi::MPIRank> neighbors;
+   neighbors.insert( leftNeighbor  );
+   neighbors.insert( rightNeighbor );
+   bs.setReceiverInfo( neighbors, false );
+
+   const int steps = 6;
+   for( int step = 0; step < steps; ++step )
+   {
+      if( step == steps / 2 )
+         bs.sizeHasChanged();
+
+      // larger messages in the second half
+      const int msgSize = ( step < steps / 2 ) ? 10 : 1000;
+
+      WALBERLA_CHECK_EQUAL( bs.isSizeCommunicatedInNextStep(), step == 0 || step == steps / 2 );
+
+      for( int i = 0; i < msgSize; ++i )
+      {
+         bs.sendBuffer( leftNeighbor  ) << rank << step;
+         bs.sendBuffer( rightNeighbor ) << rank << step;
+      }
+
+      bs.sendAll();
+      randomSleep( 5 );
+
+      int numReceived = 0;
+      for( auto it = bs.begin(); it != bs.end(); ++it )
+      {
+         WALBERLA_CHECK ( it.rank() == leftNeighbor || it.rank() == rightNeighbor );
+
+         for( int i = 0; i < msgSize; ++i )
+         {
+            int receivedRank = -1;
+            int receivedStep = -1;
+            it.buffer() >> receivedRank >> receivedStep;
+            WALBERLA_CHECK_EQUAL( receivedRank, it.rank() );
+            WALBERLA_CHECK_EQUAL( receivedStep, step );
+         }
+         WALBERLA_CHECK( it.buffer().isEmpty() );
+         ++numReceived;
+      }
+      WALBERLA_CHECK_EQUAL( numReceived, leftNeighbor == rightNeighbor ? 1 : 2 );
+   }
+}
+
 void copyTest()
 {
    int rank = MPIManager::instance()->worldRank();
@@ -392,6 +455,9 @@ int main(int argc, char**argv)
    WALBERLA_LOG_INFO_ON_ROOT("Testing self-send...");
    selfSend();
 
+   WALBERLA_LOG_INFO_ON_ROOT("Testing persistent requests...");
+   persistentRequests();
+
    WALBERLA_LOG_INFO_ON_ROOT("Testing Buffer System copy...");
    copyTest();
 
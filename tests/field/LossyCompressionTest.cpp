@@ -0,0 +1,203 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file LossyCompressionTest.cpp
+//! \ingroup field
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+
+#include "core/compression/LossyCompression.h"
+#include "core/config/Config.h"
+#include "core/debug/TestSubsystem.h"
+#include "core/math/Random.h"
+#include "core/mpi/Environment.h"
+
+#include "field/AddToStorage.h"
+#include "field/FileIO.h"
+#include "field/vtk/LossyVTKWriter.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace lossy_compression_test {
+
+using namespace walberla;
+
+typedef GhostLayerField< real_t, 3 > VectorField;
+
+template< typename T >
+static double maxError( const std::vector< T > & original, const std::vector< T > & decompressed )
+{
+   WALBERLA_CHECK_EQUAL( original.size(), decompressed.size() );
+   double error = 0.0;
+   for( uint_t i = 0; i != original.size(); ++i )
+      error = std::max( error, std::abs( double_c( original[i] ) - double_c( decompressed[i] ) ) );
+   return error;
+}
+
+template< typename T >
+static void testArray( const std::vector< T > & data, const uint_t xSize, const uint_t ySize, const uint_t zSize,
+                       const compression::ErrorBound & errorBound, const double minimalRatio )
+{
+   const double tolerance = errorBound.absoluteTolerance( data.data(), uint_c( data.size() ) );
+
+   std::vector< uint8_t > compressed;
+   compression::compressLossy( data.data(), xSize, ySize, zSize, tolerance, compressed );
+
+   std::vector< T > decompressed;
+   compression::decompressLossy( compressed.data(), uint_c( compressed.size() ), decompressed );
+
+   WALBERLA_CHECK_LESS_EQUAL( maxError( data, decompressed ), tolerance, "error bound " << errorBound << " violated" );
+   WALBERLA_CHECK_GREATER_EQUAL( double_c( data.size() * sizeof(T) ) / double_c( compressed.size() ), minimalRatio );
+}
+
+template< typename T >
+static void testCompression()
+{
+   const uint_t xSize = uint_t(17);
+   const uint_t ySize = uint_t(13);
+   const uint_t zSize = uint_t(11);
+
+   std::vector< T > smooth;
+   std::vector< T > noise;
+   for( uint_t z = 0; z != zSize; ++z )
+      for( uint_t y = 0; y != ySize; ++y )
+         for( uint_t x = 0; x != xSize; ++x )
+         {
+            smooth.push_back( T( 1.0 + 0.1 * std::sin( 0.3 * double_c(x) ) * std::cos( 0.2 * double_c(y) ) + 0.01 * double_c(z) ) );
+            noise.push_back( T( math::realRandom( real_t(-1000), real_t(1000) ) ) );
+         }
+
+   testArray( smooth, xSize, ySize, zSize, compression::ErrorBound( 1e-3 ), 4.0 );
+   testArray( smooth, xSize, ySize, zSize, compression::ErrorBound( 1e-5, compression::ErrorBound::RELATIVE ), 1.5 );
+   testArray( noise, xSize, ySize, zSize, compression::ErrorBound( 1.0 ), 1.0 );
+   testArray( noise, xSize, ySize, zSize, compression::ErrorBound( 1e-2, compression::ErrorBound::RELATIVE ), 1.0 );
+
+   // lossless
+
+   std::vector< uint8_t > compressed;
+   std::vector< T > decompressed;
+   compression::compressLossy( noise.data(), xSize, ySize, zSize, 0.0, compressed );
+   compression::decompressLossy( compressed.data(), uint_c( compressed.size() ), decompressed );
+   for( uint_t i = 0; i != noise.size(); ++i )
+      WALBERLA_CHECK_IDENTICAL( noise[i], decompressed[i] );
+
+   // non-finite values are stored unmodified
+
+   std::vector< T > special( smooth );
+   special[5]  = std::numeric_limits< T >::infinity();
+   special[77] = std::numeric_limits< T >::quiet_NaN();
+   special[78] = std::numeric_limits< T >::max();
+   compression::compressLossy( special.data(), xSize, ySize, zSize, 1e-3, compressed );
+   compression::decompressLossy( compressed.data(), uint_c( compressed.size() ), decompressed );
+   WALBERLA_CHECK( std::isinf( decompressed[5] ) );
+   WALBERLA_CHECK( std::isnan( decompressed[77] ) );
+   for( uint_t i = 0; i != special.size(); ++i )
+      if( std::isfinite( special[i] ) )
+         WALBERLA_CHECK_LESS_EQUAL( std::abs( double_c( special[i] ) - double_c( decompressed[i] ) ), 1e-3 );
+
+   // rounding for visualization output
+
+   for( auto value = noise.begin(); value != noise.end(); ++value )
+      WALBERLA_CHECK_LESS_EQUAL( std::abs( double_c( compression::quantize( *value, 0.3 ) ) - double_c( *value ) ), 0.3 );
+}
+
+static void testConfig()
+{
+   Config::Block block( "LossyCompression" );
+   block.addParameter( "density", "1e-6" );
+   Config::Block & velocity = block.createBlock( "velocity" );
+   velocity.addParameter( "tolerance", "1e-3" );
+   velocity.addParameter( "mode", "relative" );
+
+   const Config::BlockHandle handle( &block );
+
+   auto density = compression::getErrorBound( handle, "density" );
+   WALBERLA_CHECK_FLOAT_EQUAL( density.tolerance, 1e-6 );
+   WALBERLA_CHECK_EQUAL( density.mode, compression::ErrorBound::ABSOLUTE );
+
+   auto vel = compression::getErrorBound( handle, "velocity" );
+   WALBERLA_CHECK_FLOAT_EQUAL( vel.tolerance, 1e-3 );
+   WALBERLA_CHECK_EQUAL( vel.mode, compression::ErrorBound::RELATIVE );
+
+   auto pressure = compression::getErrorBound( handle, "pressure", compression::ErrorBound( 0.5 ) );
+   WALBERLA_CHECK_FLOAT_EQUAL( pressure.tolerance, 0.5 );
+}
+
+static void testFileIO()
+{
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+
+   auto blocks = blockforest::createUniformBlockGrid( processes, uint_t(2), uint_t(1), uint_t(8), uint_t(6), uint_t(5),
+                                                      real_t(1), processes, uint_t(1), uint_t(1) );
+
+   auto originalId = field::addToStorage< VectorField >( blocks, "original", real_t(0), field::zyxf, uint_t(1) );
+   auto readId     = field::addToStorage< VectorField >( blocks, "read", real_t(0), field::fzyx, uint_t(1) );
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      auto field = block->getData< VectorField >( originalId );
+      for( auto it = field->begin(); it != field->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         blocks->transformBlockLocalToGlobalCell( cell, *block );
+         *it = real_c( std::sin( 0.1 * double_c( cell.x() ) + double_c( it.f() ) ) + 0.05 * double_c( cell.y() * cell.z() ) );
+      }
+   }
+
+   const compression::ErrorBound errorBound( 1e-4 );
+   field::writeToFileLossy< VectorField >( "lossy.dat", blocks->getBlockStorage(), originalId, errorBound );
+   field::readFromFileLossy< VectorField >( "lossy.dat", blocks->getBlockStorage(), readId );
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      auto original = block->getData< VectorField >( originalId );
+      auto read     = block->getData< VectorField >( readId );
+      for( auto it = original->begin(); it != original->end(); ++it )
+         WALBERLA_CHECK_LESS_EQUAL( std::abs( double_c( *it ) - double_c( read->get( it.x(), it.y(), it.z(), it.f() ) ) ), errorBound.tolerance );
+   }
+
+   auto vtkOutput = vtk::createVTKOutput_BlockData( blocks, "lossy" );
+   vtkOutput->addCellDataWriter( make_shared< field::LossyVTKWriter< VectorField > >( originalId, "absolute", errorBound ) );
+   vtkOutput->addCellDataWriter( make_shared< field::LossyVTKWriter< VectorField, float > >(
+                                    originalId, "relative", compression::ErrorBound( 1e-3, compression::ErrorBound::RELATIVE ) ) );
+   vtkOutput->write();
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   testCompression< float >();
+   testCompression< double >();
+   testConfig();
+   testFileIO();
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace lossy_compression_test
+
+int main( int argc, char* argv[] )
+{
+   return lossy_compression_test::main( argc, argv );
+}
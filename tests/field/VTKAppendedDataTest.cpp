@@ -0,0 +1,226 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file VTKAppendedDataTest.cpp
+//! \ingroup field
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+#include "core/mpi/Reduce.h"
+
+#include "field/AddToStorage.h"
+#include "field/vtk/VTKWriter.h"
+
+#include "vtk/VTKOutput.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace vtk_appended_data_test {
+
+using namespace walberla;
+
+typedef GhostLayerField< double, 1 > ScalarField;
+typedef GhostLayerField< float, 3 >  VectorField;
+
+static double value( const Cell & cell )
+{
+   return double_c( cell.x() ) + 100.0 * double_c( cell.y() ) + 10000.0 * double_c( cell.z() );
+}
+
+static std::string readFile( const std::string & file )
+{
+   std::ifstream ifs( file.c_str(), std::ifstream::binary );
+   WALBERLA_CHECK( ifs.good(), "Cannot open file \"" << file << "\"" );
+   return std::string( std::istreambuf_iterator< char >( ifs ), std::istreambuf_iterator< char >() );
+}
+
+/// returns the (uncompressed) data of all DataArrays "name" of a VTK file written in appended raw mode
+template< typename T >
+static std::vector< std::vector< T > > readArrays( const std::string & file, const std::string & name )
+{
+   const std::string content = readFile( file );
+
+   const auto appended = content.find( "<AppendedData encoding=\"raw\">" );
+   WALBERLA_CHECK( appended != std::string::npos );
+   const auto base = content.find( '_', appended ) + 1;
+   const std::string xml = content.substr( 0, appended );
+
+   WALBERLA_CHECK( xml.find( "header_type=\"UInt64\"" ) != std::string::npos );
+   WALBERLA_CHECK( xml.find( "format=\"binary\"" ) == std::string::npos );
+
+   std::vector< std::vector< T > > arrays;
+   const std::string attribute = "Name=\"" + name + "\"";
+   for( auto pos = xml.find( attribute ); pos != std::string::npos; pos = xml.find( attribute, pos + attribute.size() ) )
+   {
+      const auto offsetBegin = xml.find( "offset=\"", pos ) + std::string( "offset=\"" ).size();
+      const std::size_t offset = std::stoul( xml.substr( offsetBegin, xml.find( '"', offsetBegin ) - offsetBegin ) );
+
+      uint64_t bytes;
+      std::memcpy( &bytes, content.data() + base + offset, sizeof( uint64_t ) );
+      WALBERLA_CHECK_LESS_EQUAL( base + offset + sizeof( uint64_t ) + bytes, content.size() );
+      WALBERLA_CHECK_EQUAL( bytes % sizeof( T ), uint64_t(0) );
+
+      std::vector< T > values( bytes / sizeof( T ) );
+      std::memcpy( values.data(), content.data() + base + offset + sizeof( uint64_t ), bytes );
+      arrays.push_back( values );
+   }
+   return arrays;
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+
+   const uint_t xCells = uint_t(6);
+   const uint_t yCells = uint_t(5);
+   const uint_t zCells = uint_t(4);
+   const uint_t cellsPerBlock = xCells * yCells * zCells;
+   const uint_t numberOfBlocks = uint_t(4) * processes;
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2) * processes, uint_t(1), uint_t(2), xCells, yCells, zCells,
+                                                      real_t(1), processes, uint_t(1), uint_t(1) );
+
+   auto scalarId = field::addToStorage< ScalarField >( blocks, "scalar", 0.0, field::fzyx, uint_t(1) );
+   auto vectorId = field::addToStorage< VectorField >( blocks, "vector", 0.0f, field::zyxf, uint_t(1) ); // data copied from memory
+   auto vectorFzyxId = field::addToStorage< VectorField >( blocks, "vectorFzyx", 0.0f, field::fzyx, uint_t(1) ); // cell by cell
+
+   double scalarSum = 0.0;
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      auto scalar = block->getData< ScalarField >( scalarId );
+      auto vector = block->getData< VectorField >( vectorId );
+      auto vectorFzyx = block->getData< VectorField >( vectorFzyxId );
+      for( auto it = scalar->begin(); it != scalar->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         blocks->transformBlockLocalToGlobalCell( cell, *block );
+         *it = value( cell );
+         scalarSum += *it;
+         for( cell_idx_t f = 0; f != cell_idx_t(3); ++f )
+         {
+            vector->get( it.x(), it.y(), it.z(), f ) = float_c( value( cell ) ) + float_c( f );
+            vectorFzyx->get( it.x(), it.y(), it.z(), f ) = float_c( value( cell ) ) + float_c( f );
+         }
+      }
+   }
+   mpi::allReduceInplace( scalarSum, mpi::SUM );
+
+   auto addWriters = [&]( const shared_ptr< vtk::VTKOutput > & output ) {
+      output->addCellDataWriter( make_shared< field::VTKWriter< ScalarField > >( scalarId, "scalar" ) );
+      output->addCellDataWriter( make_shared< field::VTKWriter< VectorField > >( vectorId, "vector" ) );
+      output->addCellDataWriter( make_shared< field::VTKWriter< VectorField > >( vectorFzyxId, "vectorFzyx" ) );
+      output->useAppendedRawData();
+   };
+
+   // one file per block (vti): every process checks the files of its blocks
+
+   auto perBlock = vtk::createVTKOutput_BlockData( blocks, "appended_block", uint_t(1), uint_t(0), false, "vtk_out", "simulation_step",
+                                                   false, true, true, false );
+   addWriters( perBlock );
+   perBlock->write();
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      std::ostringstream file;
+      file << "vtk_out/appended_block/simulation_step_0/block [" << block->getId() << "].vti";
+
+      auto scalar = readArrays< double >( file.str(), "scalar" );
+      auto vector = readArrays< float >( file.str(), "vector" );
+      auto vectorFzyx = readArrays< float >( file.str(), "vectorFzyx" );
+      WALBERLA_CHECK_EQUAL( scalar.size(), uint_t(1) );
+      WALBERLA_CHECK_EQUAL( scalar[0].size(), cellsPerBlock );
+      WALBERLA_CHECK_EQUAL( vector[0].size(), uint_t(3) * cellsPerBlock );
+      WALBERLA_CHECK_EQUAL( vectorFzyx[0].size(), uint_t(3) * cellsPerBlock );
+
+      const CellInterval & cellBB = blocks->getBlockCellBB( *block );
+      uint_t i = uint_t(0);
+      for( auto cell = cellBB.begin(); cell != cellBB.end(); ++cell, ++i ) // x fastest
+      {
+         WALBERLA_CHECK_IDENTICAL( scalar[0][i], value( *cell ) );
+         for( uint_t f = 0; f != uint_t(3); ++f )
+         {
+            WALBERLA_CHECK_IDENTICAL( vector[0][ uint_t(3) * i + f ], float_c( value( *cell ) ) + float_c( f ) );
+            WALBERLA_CHECK_IDENTICAL( vectorFzyx[0][ uint_t(3) * i + f ], float_c( value( *cell ) ) + float_c( f ) );
+         }
+      }
+   }
+
+   // one file for all processes (MPI-IO), vti and vtu
+
+   auto combinedVTI = vtk::createVTKOutput_BlockData( blocks, "appended_vti" );
+   addWriters( combinedVTI );
+   combinedVTI->write();
+
+   auto combinedVTU = vtk::createVTKOutput_BlockData( blocks, "appended_vtu", uint_t(1), uint_t(0), true );
+   addWriters( combinedVTU );
+   combinedVTU->write();
+
+   WALBERLA_MPI_BARRIER()
+
+   WALBERLA_ROOT_SECTION()
+   {
+      const std::string files[] = { "vtk_out/appended_vti/simulation_step_0.vti", "vtk_out/appended_vtu/simulation_step_0.vtu" };
+      for( auto file = std::begin( files ); file != std::end( files ); ++file )
+      {
+         auto scalar = readArrays< double >( *file, "scalar" );
+         auto vector = readArrays< float >( *file, "vector" );
+         WALBERLA_CHECK_EQUAL( scalar.size(), numberOfBlocks );
+         WALBERLA_CHECK_EQUAL( vector.size(), numberOfBlocks );
+
+         double sum = 0.0;
+         for( auto array = scalar.begin(); array != scalar.end(); ++array )
+         {
+            WALBERLA_CHECK_EQUAL( array->size(), cellsPerBlock );
+            for( auto v = array->begin(); v != array->end(); ++v )
+               sum += *v;
+         }
+         WALBERLA_CHECK_FLOAT_EQUAL( sum, scalarSum );
+
+         for( auto array = vector.begin(); array != vector.end(); ++array )
+         {
+            WALBERLA_CHECK_EQUAL( array->size(), uint_t(3) * cellsPerBlock );
+            for( uint_t i = 0; i != cellsPerBlock; ++i )
+            {
+               WALBERLA_CHECK_IDENTICAL( (*array)[ uint_t(3) * i + uint_t(1) ], (*array)[ uint_t(3) * i ] + 1.0f );
+               WALBERLA_CHECK_IDENTICAL( (*array)[ uint_t(3) * i + uint_t(2) ], (*array)[ uint_t(3) * i ] + 2.0f );
+            }
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace vtk_appended_data_test
+
+int main( int argc, char* argv[] )
+{
+   return vtk_appended_data_test::main( argc, argv );
+}
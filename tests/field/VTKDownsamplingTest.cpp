@@ -0,0 +1,191 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file VTKDownsamplingTest.cpp
+//! \ingroup field
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+#include "core/mpi/Reduce.h"
+
+#include "field/AddToStorage.h"
+#include "field/vtk/DownsamplingVTKWriter.h"
+#include "field/vtk/VTKWriter.h"
+
+#include "vtk/VTKOutput.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace vtk_downsampling_test {
+
+using namespace walberla;
+
+typedef GhostLayerField< double, 1 > ScalarField;
+
+static double value( const Cell & cell )
+{
+   return double_c( cell.x() ) + 100.0 * double_c( cell.y() ) + 10000.0 * double_c( cell.z() );
+}
+
+static std::string readFile( const std::string & file )
+{
+   std::ifstream ifs( file.c_str(), std::ifstream::binary );
+   WALBERLA_CHECK( ifs.good(), "Cannot open file \"" << file << "\"" );
+   return std::string( std::istreambuf_iterator< char >( ifs ), std::istreambuf_iterator< char >() );
+}
+
+/// returns the data of the DataArray "name" of a VTK file that contains one piece and is written in appended raw mode
+static std::vector< double > readArray( const std::string & content, const std::string & name )
+{
+   const auto appended = content.find( "<AppendedData encoding=\"raw\">" );
+   WALBERLA_CHECK( appended != std::string::npos );
+   const auto base = content.find( '_', appended ) + 1;
+
+   const auto pos = content.find( "Name=\"" + name + "\"" );
+   WALBERLA_CHECK( pos != std::string::npos );
+   const auto offsetBegin = content.find( "offset=\"", pos ) + std::string( "offset=\"" ).size();
+   const std::size_t offset = std::stoul( content.substr( offsetBegin, content.find( '"', offsetBegin ) - offsetBegin ) );
+
+   uint64_t bytes;
+   std::memcpy( &bytes, content.data() + base + offset, sizeof( uint64_t ) );
+   std::vector< double > values( bytes / sizeof( double ) );
+   std::memcpy( values.data(), content.data() + base + offset + sizeof( uint64_t ), bytes );
+   return values;
+}
+
+static std::string blockFile( const std::string & identifier, const uint_t step, const IBlock & block, const std::string & extension )
+{
+   std::ostringstream file;
+   file << "vtk_out/" << identifier << "/simulation_step_" << step << "/block [" << block.getId() << "]." << extension;
+   return file.str();
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2) * processes, uint_t(1), uint_t(2), uint_t(6), uint_t(4), uint_t(4),
+                                                      real_t(1), processes, uint_t(1), uint_t(1) );
+
+   auto scalarId = field::addToStorage< ScalarField >( blocks, "scalar", 0.0, field::fzyx, uint_t(1) );
+
+   auto initialize = [&]( const double shift ) {
+      for( auto block = blocks->begin(); block != blocks->end(); ++block )
+      {
+         auto scalar = block->getData< ScalarField >( scalarId );
+         for( auto it = scalar->begin(); it != scalar->end(); ++it )
+         {
+            Cell cell( it.x(), it.y(), it.z() );
+            blocks->transformBlockLocalToGlobalCell( cell, *block );
+            *it = value( cell ) + shift;
+         }
+      }
+   };
+   initialize( 0.0 );
+
+   // downsampling by a factor of two (box filter) vs. nearest neighbor sampling
+
+   auto coarse = vtk::createVTKOutput_BlockData( blocks, "downsampled", uint_t(1), uint_t(0), false, "vtk_out", "simulation_step",
+                                                 false, true, true, false );
+   coarse->addCellDataWriter( make_shared< field::DownsamplingVTKWriter< ScalarField > >( scalarId, "average" ) );
+   coarse->addCellDataWriter( make_shared< field::VTKWriter< ScalarField > >( scalarId, "nearest" ) );
+   coarse->setSamplingResolution( real_t(2) );
+   coarse->useAppendedRawData();
+   coarse->cacheCellLists();
+   coarse->write();
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      const std::string content = readFile( blockFile( "downsampled", uint_t(0), *block, "vti" ) );
+      auto average = readArray( content, "average" );
+      auto nearest = readArray( content, "nearest" );
+      WALBERLA_CHECK_EQUAL( average.size(), uint_t(12) );
+      WALBERLA_CHECK_EQUAL( nearest.size(), uint_t(12) );
+
+      const CellInterval & cellBB = blocks->getBlockCellBB( *block );
+      CellInterval sampled( cellBB.xMin() / 2, cellBB.yMin() / 2, cellBB.zMin() / 2, cellBB.xMax() / 2, cellBB.yMax() / 2, cellBB.zMax() / 2 );
+      uint_t i = uint_t(0);
+      for( auto cell = sampled.begin(); cell != sampled.end(); ++cell, ++i ) // x fastest
+      {
+         const Cell fine( cell_idx_t(2) * cell->x(), cell_idx_t(2) * cell->y(), cell_idx_t(2) * cell->z() );
+         WALBERLA_CHECK_FLOAT_EQUAL( average[i], value( fine ) + 0.5 * value( Cell( 1, 1, 1 ) ) );
+         WALBERLA_CHECK_IDENTICAL( nearest[i], value( fine + Cell( 1, 1, 1 ) ) );
+      }
+   }
+
+   // region of interest, cell lists are cached and reused by the second write
+
+   const AABB roi( real_t(1), real_t(1), real_t(1), real_t(5), real_t(3), real_t(3) );
+   const CellInterval roiCells( 1, 1, 1, 4, 2, 2 );
+
+   auto fine = vtk::createVTKOutput_BlockData( blocks, "roi", uint_t(1), uint_t(0), false, "vtk_out", "simulation_step",
+                                               false, true, true, false );
+   fine->addCellDataWriter( make_shared< field::VTKWriter< ScalarField > >( scalarId, "scalar" ) );
+   fine->addAABBInclusionFilter( roi );
+   fine->useAppendedRawData();
+   fine->cacheCellLists();
+
+   for( uint_t step = uint_t(0); step != uint_t(2); ++step )
+   {
+      initialize( double_c( step ) );
+      fine->write();
+
+      uint_t cells = uint_t(0);
+      double sum = 0.0;
+      for( auto block = blocks->begin(); block != blocks->end(); ++block )
+      {
+         if( !blocks->getBlockCellBB( *block ).overlaps( roiCells ) )
+            continue;
+
+         auto scalar = readArray( readFile( blockFile( "roi", step, *block, "vtu" ) ), "scalar" );
+         cells += uint_c( scalar.size() );
+         for( auto v = scalar.begin(); v != scalar.end(); ++v )
+            sum += *v;
+      }
+      mpi::allReduceInplace( cells, mpi::SUM );
+      mpi::allReduceInplace( sum, mpi::SUM );
+
+      double expected = 0.0;
+      for( auto cell = roiCells.begin(); cell != roiCells.end(); ++cell )
+         expected += value( *cell ) + double_c( step );
+
+      WALBERLA_CHECK_EQUAL( cells, uint_t(16) );
+      WALBERLA_CHECK_FLOAT_EQUAL( sum, expected );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace vtk_downsampling_test
+
+int main( int argc, char* argv[] )
+{
+   return vtk_downsampling_test::main( argc, argv );
+}
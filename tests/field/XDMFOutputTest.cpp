@@ -0,0 +1,163 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file XDMFOutputTest.cpp
+//! \ingroup field
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+#include "core/mpi/Reduce.h"
+
+#include "field/AddToStorage.h"
+#include "field/vtk/VTKWriter.h"
+
+#include "vtk/XDMFOutput.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace xdmf_output_test {
+
+using namespace walberla;
+
+typedef GhostLayerField< double, 1 > ScalarField;
+typedef GhostLayerField< float, 3 > VectorField;
+
+static std::string readFile( const std::string & file )
+{
+   std::ifstream ifs( file.c_str(), std::ifstream::binary );
+   WALBERLA_CHECK( ifs.good(), "Cannot open file \"" << file << "\"" );
+   return std::string( std::istreambuf_iterator< char >( ifs ), std::istreambuf_iterator< char >() );
+}
+
+static uint_t count( const std::string & text, const std::string & pattern )
+{
+   uint_t n = uint_t(0);
+   for( auto pos = text.find( pattern ); pos != std::string::npos; pos = text.find( pattern, pos + pattern.size() ) )
+      ++n;
+   return n;
+}
+
+/// sum of all values of all attributes "name" listed in the XDMF file (read from the raw file)
+static double sumAttribute( const std::string & xdmf, const std::string & raw, const std::string & name, const uint_t cellsPerBlock )
+{
+   double sum = 0.0;
+   const std::string attribute = "<Attribute Name=\"" + name + "\"";
+   for( auto pos = xdmf.find( attribute ); pos != std::string::npos; pos = xdmf.find( attribute, pos + attribute.size() ) )
+   {
+      const auto seek = xdmf.find( "Seek=\"", pos ) + std::string( "Seek=\"" ).size();
+      const uint_t offset = std::stoul( xdmf.substr( seek, xdmf.find( '"', seek ) - seek ) );
+      WALBERLA_CHECK_LESS_EQUAL( offset + cellsPerBlock * sizeof(double), raw.size() );
+
+      const double * values = reinterpret_cast< const double * >( raw.data() + offset );
+      for( uint_t i = 0; i != cellsPerBlock; ++i )
+         sum += values[i];
+   }
+   return sum;
+}
+
+int main( int argc, char* argv[] )
+{
+   debug::enterTestMode();
+
+   mpi::Environment mpiEnv( argc, argv );
+   MPIManager::instance()->useWorldComm();
+
+   const uint_t processes = uint_c( MPIManager::instance()->numProcesses() );
+
+   const uint_t xCells = uint_t(6);
+   const uint_t yCells = uint_t(5);
+   const uint_t zCells = uint_t(4);
+   const uint_t cellsPerBlock = xCells * yCells * zCells;
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2) * processes, uint_t(1), uint_t(2), xCells, yCells, zCells,
+                                                      real_t(1), processes, uint_t(1), uint_t(1) );
+
+   auto scalarId = field::addToStorage< ScalarField >( blocks, "scalar", 0.0, field::fzyx, uint_t(1) );
+   auto vectorId = field::addToStorage< VectorField >( blocks, "vector", 1.0f, field::fzyx, uint_t(1) );
+
+   double localSum = 0.0;
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      auto field = block->getData< ScalarField >( scalarId );
+      for( auto it = field->begin(); it != field->end(); ++it )
+      {
+         Cell cell( it.x(), it.y(), it.z() );
+         blocks->transformBlockLocalToGlobalCell( cell, *block );
+         *it = double_c( cell.x() ) + 100.0 * double_c( cell.y() ) + 10000.0 * double_c( cell.z() );
+         localSum += *it;
+      }
+   }
+   mpi::allReduceInplace( localSum, mpi::SUM );
+
+   auto xdmf = make_shared< vtk::XDMFOutput >( *blocks, "xdmf_test", uint_t(2) );
+   xdmf->addCellDataWriter( make_shared< field::VTKWriter< ScalarField > >( scalarId, "scalar" ) );
+   xdmf->addCellDataWriter( make_shared< field::VTKWriter< VectorField > >( vectorId, "vector" ) );
+
+   // an existing, larger raw file must be truncated when it is overwritten
+   WALBERLA_ROOT_SECTION()
+   {
+      std::ofstream stale( xdmf->rawFile( uint_t(0) ).c_str(), std::ofstream::binary );
+      const std::vector< char > garbage( uint_t(16) * processes * cellsPerBlock * sizeof(double), char(1) );
+      stale.write( &(garbage[0]), numeric_cast< std::streamsize >( garbage.size() ) );
+   }
+   WALBERLA_MPI_BARRIER()
+
+   auto write = vtk::writeFiles( xdmf );
+   for( uint_t i = 0; i != uint_t(3); ++i ) // writes steps 0 and 2
+      write();
+
+   WALBERLA_MPI_BARRIER()
+
+   WALBERLA_ROOT_SECTION()
+   {
+      const uint_t numberOfBlocks = uint_t(4) * processes;
+
+      for( uint_t step = uint_t(0); step <= uint_t(2); step += uint_t(2) )
+      {
+         const std::string raw = readFile( xdmf->rawFile( step ) );
+         WALBERLA_CHECK_EQUAL( raw.size(), numberOfBlocks * cellsPerBlock * ( sizeof(double) + uint_t(3) * sizeof(float) ) );
+
+         const std::string step_xdmf = readFile( xdmf->xdmfFile( step ) );
+         WALBERLA_CHECK_EQUAL( count( step_xdmf, "GridType=\"Uniform\"" ), numberOfBlocks );
+         WALBERLA_CHECK_EQUAL( count( step_xdmf, "AttributeType=\"Scalar\"" ), numberOfBlocks );
+         WALBERLA_CHECK_EQUAL( count( step_xdmf, "AttributeType=\"Vector\"" ), numberOfBlocks );
+
+         WALBERLA_CHECK_FLOAT_EQUAL( sumAttribute( step_xdmf, raw, "scalar", cellsPerBlock ), localSum );
+      }
+
+      WALBERLA_CHECK( !std::ifstream( xdmf->rawFile( uint_t(1) ).c_str() ).good() );
+
+      const std::string series = readFile( xdmf->seriesFile() );
+      WALBERLA_CHECK_EQUAL( count( series, "<xi:include" ), uint_t(2) );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace xdmf_output_test
+
+int main( int argc, char* argv[] )
+{
+   return xdmf_output_test::main( argc, argv );
+}
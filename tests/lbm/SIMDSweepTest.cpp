@@ -0,0 +1,237 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SIMDSweepTest.cpp
+//! \ingroup lbm
+//! \brief Checks that the explicitly vectorized SIMDSweep produces the same results as the CellwiseSweep
+//
+//======================================================================================================================
+
+#include "lbm/boundary/NoSlip.h"
+#include "lbm/communication/PdfFieldPackInfo.h"
+#include "lbm/field/AddToStorage.h"
+#include "lbm/field/PdfField.h"
+#include "lbm/lattice_model/D3Q19.h"
+#include "lbm/lattice_model/D3Q27.h"
+#include "lbm/sweeps/CellwiseSweep.h"
+#include "lbm/sweeps/SIMDSweep.h"
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+
+#include "boundary/BoundaryHandling.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "domain_decomposition/SharedSweep.h"
+
+#include "field/AddToStorage.h"
+#include "field/FlagField.h"
+
+#include "simd/CPUFeatures.h"
+
+#include "timeloop/SweepTimeloop.h"
+
+#include <iterator>
+
+
+namespace simd_sweep_test {
+
+using namespace walberla;
+
+using flag_t = walberla::uint8_t;
+using FlagField_T = FlagField<flag_t>;
+
+const FlagUID  Fluid_Flag( "fluid" );
+const FlagUID NoSlip_Flag( "no slip" );
+
+const uint_t TimeSteps = uint_t(10);
+
+
+
+// periodic domain with obstacles, the number of cells in x-direction is not a multiple of the SIMD width
+
+template< typename LatticeModel_T >
+class MyBoundaryHandling
+{
+public:
+
+   typedef lbm::PdfField< LatticeModel_T > PdfField_T;
+   typedef lbm::NoSlip< LatticeModel_T, flag_t > NoSlip_T;
+   typedef BoundaryHandling< FlagField_T, typename LatticeModel_T::Stencil, boost::tuples::tuple< NoSlip_T > > BoundaryHandling_T;
+
+   MyBoundaryHandling( const BlockDataID & flagField, const BlockDataID & pdfField ) : flagField_( flagField ), pdfField_( pdfField ) {}
+
+   BoundaryHandling_T * operator()( IBlock* const block, const StructuredBlockStorage* const ) const
+   {
+      FlagField_T * flagField = block->getData< FlagField_T >( flagField_ );
+      PdfField_T *   pdfField = block->getData< PdfField_T > (  pdfField_ );
+
+      const auto fluid = flagField->flagExists( Fluid_Flag ) ? flagField->getFlag( Fluid_Flag ) : flagField->registerFlag( Fluid_Flag );
+
+      BoundaryHandling_T * handling = new BoundaryHandling_T( "boundary handling", flagField, fluid,
+                                                              boost::tuples::make_tuple( NoSlip_T( "no slip", NoSlip_Flag, pdfField ) ) );
+
+      // obstacles are set based on periodic coordinates, so that the ghost layers are consistent with the inner cells
+
+      const cell_idx_t xSize = cell_idx_c( flagField->xSize() );
+      const cell_idx_t ySize = cell_idx_c( flagField->ySize() );
+      const cell_idx_t zSize = cell_idx_c( flagField->zSize() );
+
+      CellInterval cells = flagField->xyzSizeWithGhostLayer();
+      for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      {
+         const cell_idx_t x = ( cell->x() + xSize ) % xSize;
+         const cell_idx_t y = ( cell->y() + ySize ) % ySize;
+         const cell_idx_t z = ( cell->z() + zSize ) % zSize;
+         if( ( x * 7 + y * 13 + z * 5 ) % 11 == 0 )
+            handling->forceBoundary( NoSlip_Flag, cell->x(), cell->y(), cell->z() );
+      }
+
+      handling->fillWithDomain( cells );
+
+      return handling;
+   }
+
+private:
+
+   const BlockDataID flagField_;
+   const BlockDataID  pdfField_;
+};
+
+
+
+template< typename LatticeModel_T, typename Sweep_T >
+void run( const shared_ptr< StructuredBlockForest > & blocks, const shared_ptr< Sweep_T > & sweep,
+          const BlockDataID & pdfFieldId, const BlockDataID & flagFieldId )
+{
+   typedef typename MyBoundaryHandling< LatticeModel_T >::BoundaryHandling_T BoundaryHandling_T;
+
+   BlockDataID handlingId = blocks->addStructuredBlockData< BoundaryHandling_T >( MyBoundaryHandling< LatticeModel_T >( flagFieldId, pdfFieldId ),
+                                                                                  "boundary handling" );
+
+   SweepTimeloop timeloop( blocks->getBlockStorage(), TimeSteps );
+
+   blockforest::communication::UniformBufferedScheme< typename LatticeModel_T::CommunicationStencil > communication( blocks );
+   communication.addPackInfo( make_shared< lbm::PdfFieldPackInfo< LatticeModel_T > >( pdfFieldId ) );
+
+   timeloop.add() << BeforeFunction( communication, "communication" )
+                  << Sweep( BoundaryHandling_T::getBlockSweep( handlingId ), "boundary handling" );
+   timeloop.add() << Sweep( makeSharedSweep( sweep ), "stream & collide" );
+
+   timeloop.run();
+}
+
+
+
+template< typename LatticeModel_T >
+void test( const LatticeModel_T & latticeModel )
+{
+   typedef lbm::PdfField< LatticeModel_T > PdfField_T;
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(1), uint_t(1), uint_t(1),
+                                                      uint_t(13), uint_t(6), uint_t(5),
+                                                      real_t(1), false,
+                                                      true, true, true );
+
+   const Vector3< real_t > initialVelocity( real_t(0.02), real_t(-0.01), real_t(0.005) );
+
+   BlockDataID referenceId    = lbm::addPdfFieldToStorage( blocks, "reference", latticeModel, initialVelocity, real_t(1), field::fzyx );
+   BlockDataID referenceFlags = field::addFlagFieldToStorage< FlagField_T >( blocks, "reference flags" );
+   run< LatticeModel_T >( blocks, lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( referenceId, referenceFlags, Fluid_Flag ), referenceId, referenceFlags );
+
+   // every kernel that can be executed on this CPU is compared to the reference
+
+   const simd::InstructionSet instructionSets[] = { simd::SCALAR, simd::SSE2, simd::AVX, simd::AVX2, simd::AVX512 };
+   for( auto is = std::begin( instructionSets ); is != std::end( instructionSets ); ++is )
+   {
+      if( *is != simd::SCALAR && !simd::cpuSupports( *is ) )
+         continue;
+
+      BlockDataID simdId    = lbm::addPdfFieldToStorage( blocks, "simd", latticeModel, initialVelocity, real_t(1), field::fzyx );
+      BlockDataID simdFlags = field::addFlagFieldToStorage< FlagField_T >( blocks, "simd flags" );
+      auto simdSweep = lbm::makeSIMDSweep< LatticeModel_T, FlagField_T >( simdId, simdFlags, Fluid_Flag, false );
+      WALBERLA_CHECK( !simdSweep->vectorized() );
+      simdSweep->setInstructionSet( *is );
+      WALBERLA_CHECK_EQUAL( simdSweep->vectorized(), *is != simd::SCALAR );
+      run< LatticeModel_T >( blocks, simdSweep, simdId, simdFlags );
+
+      WALBERLA_LOG_INFO( "SIMDSweep: checking " << LatticeModel_T::NAME << ( LatticeModel_T::compressible ? " (compressible)" : " (incompressible)" ) <<
+                         ", kernel uses " << simdSweep->instructionSet() );
+
+      for( auto block = blocks->begin(); block != blocks->end(); ++block )
+      {
+         PdfField_T * reference = block->getData< PdfField_T >( referenceId );
+         PdfField_T * simd      = block->getData< PdfField_T >( simdId );
+         FlagField_T * flags    = block->getData< FlagField_T >( simdFlags );
+
+         const auto fluid = flags->getFlag( Fluid_Flag );
+
+         for( auto cell = flags->beginXYZ(); cell != flags->end(); ++cell )
+         {
+            if( !isFlagSet( cell, fluid ) )
+               continue;
+
+            const Cell c( cell.x(), cell.y(), cell.z() );
+            for( uint_t f = uint_t(0); f < LatticeModel_T::Stencil::Size; ++f )
+               WALBERLA_CHECK_FLOAT_EQUAL_EPSILON( reference->get( c, f ), simd->get( c, f ), real_t(1e-12) );
+         }
+      }
+   }
+
+#ifdef WALBERLA_SIMD_CPU_DETECTION
+   // by default, the best instruction set of the CPU is selected (every x86 CPU supports at least SSE2)
+   auto defaultSweep = lbm::makeSIMDSweep< LatticeModel_T, FlagField_T >( referenceId, referenceFlags, Fluid_Flag );
+   WALBERLA_CHECK( defaultSweep->vectorized() );
+#endif
+}
+
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+
+   mpi::Environment env( argc, argv );
+
+   WALBERLA_LOG_INFO( "best instruction set of this CPU: " << simd::instructionSetName( simd::detectInstructionSet() ) );
+
+   const real_t omega( real_t(1.6) );
+   const lbm::collision_model::SRT srt( omega );
+   const lbm::collision_model::TRT trt = lbm::collision_model::TRT::constructWithMagicNumber( omega );
+   const lbm::force_model::SimpleConstant force( Vector3< real_t >( real_t(1e-4), real_t(-2e-4), real_t(5e-5) ) );
+
+   test( lbm::D3Q19< lbm::collision_model::SRT, false >( srt ) );
+   test( lbm::D3Q19< lbm::collision_model::SRT, true  >( srt ) );
+   test( lbm::D3Q19< lbm::collision_model::TRT, false >( trt ) );
+   test( lbm::D3Q19< lbm::collision_model::TRT, true  >( trt ) );
+   test( lbm::D3Q19< lbm::collision_model::TRT, false, lbm::force_model::SimpleConstant >( trt, force ) );
+   test( lbm::D3Q19< lbm::collision_model::SRT, true,  lbm::force_model::SimpleConstant >( srt, force ) );
+
+   test( lbm::D3Q27< lbm::collision_model::SRT, false >( srt ) );
+   test( lbm::D3Q27< lbm::collision_model::TRT, true  >( trt ) );
+   test( lbm::D3Q27< lbm::collision_model::SRT, false, lbm::force_model::SimpleConstant >( srt, force ) );
+   test( lbm::D3Q27< lbm::collision_model::TRT, true,  lbm::force_model::SimpleConstant >( trt, force ) );
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace simd_sweep_test
+
+int main( int argc, char ** argv )
+{
+   return simd_sweep_test::main( argc, argv );
+}
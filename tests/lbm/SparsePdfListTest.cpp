@@ -0,0 +1,220 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SparsePdfListTest.cpp
+//! \ingroup lbm
+//! \brief Checks that the list-based sparse LBM produces the same results as the dense CellwiseSweep
+//
+//======================================================================================================================
+
+#include "lbm/boundary/NoSlip.h"
+#include "lbm/boundary/SimpleUBB.h"
+#include "lbm/communication/PdfFieldPackInfo.h"
+#include "lbm/communication/SparsePdfListPackInfo.h"
+#include "lbm/field/AddToStorage.h"
+#include "lbm/field/PdfField.h"
+#include "lbm/field/SparsePdfList.h"
+#include "lbm/lattice_model/D3Q19.h"
+#include "lbm/sweeps/CellwiseSweep.h"
+#include "lbm/sweeps/SparsePdfListSweep.h"
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+
+#include "boundary/BoundaryHandling.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "domain_decomposition/SharedSweep.h"
+
+#include "field/AddToStorage.h"
+#include "field/FlagField.h"
+
+#include "timeloop/SweepTimeloop.h"
+
+
+namespace sparse_pdf_list_test {
+
+using namespace walberla;
+
+using flag_t = walberla::uint8_t;
+using FlagField_T = FlagField<flag_t>;
+
+typedef lbm::D3Q19< lbm::collision_model::TRT, true > LatticeModel_T;
+typedef lbm::PdfField< LatticeModel_T > PdfField_T;
+typedef lbm::SparsePdfList< LatticeModel_T > SparsePdfList_T;
+
+typedef lbm::NoSlip< LatticeModel_T, flag_t >    NoSlip_T;
+typedef lbm::SimpleUBB< LatticeModel_T, flag_t > UBB_T;
+typedef BoundaryHandling< FlagField_T, LatticeModel_T::Stencil, boost::tuples::tuple< NoSlip_T, UBB_T > > BoundaryHandling_T;
+
+const FlagUID  Fluid_Flag( "fluid" );
+const FlagUID    UBB_Flag( "velocity bounce back" );
+const FlagUID NoSlip_Flag( "no slip" );
+
+const uint_t CellsPerBlock = uint_t(8);
+const uint_t TimeSteps     = uint_t(20);
+const Vector3< real_t > WallVelocity( real_t(0.05), real_t(0.02), real_t(0) );
+
+
+
+// porous medium that is periodic in x- and y-direction, with a no slip wall at the bottom and a moving wall at the top
+
+class MyBoundaryHandling
+{
+public:
+
+   MyBoundaryHandling( const BlockDataID & flagField, const BlockDataID & pdfField ) : flagField_( flagField ), pdfField_( pdfField ) {}
+
+   BoundaryHandling_T * operator()( IBlock* const block, const StructuredBlockStorage* const storage ) const
+   {
+      FlagField_T * flagField = block->getData< FlagField_T >( flagField_ );
+      PdfField_T *   pdfField = block->getData< PdfField_T > (  pdfField_ );
+
+      const auto fluid = flagField->flagExists( Fluid_Flag ) ? flagField->getFlag( Fluid_Flag ) : flagField->registerFlag( Fluid_Flag );
+
+      BoundaryHandling_T * handling = new BoundaryHandling_T( "boundary handling", flagField, fluid,
+            boost::tuples::make_tuple( NoSlip_T( "no slip", NoSlip_Flag, pdfField ),
+                                       UBB_T( "velocity bounce back", UBB_Flag, pdfField, WallVelocity ) ) );
+
+      const cell_idx_t gl = cell_idx_c( flagField->nrOfGhostLayers() );
+
+      CellInterval domainBB = storage->getDomainCellBB();
+      const cell_idx_t xSize = cell_idx_c( domainBB.xSize() );
+      const cell_idx_t ySize = cell_idx_c( domainBB.ySize() );
+      storage->transformGlobalToBlockLocalCellInterval( domainBB, *block );
+
+      domainBB.xMin() -= gl;
+      domainBB.xMax() += gl;
+      domainBB.yMin() -= gl;
+      domainBB.yMax() += gl;
+
+      CellInterval bottom( domainBB.xMin(), domainBB.yMin(), domainBB.zMin() - 1, domainBB.xMax(), domainBB.yMax(), domainBB.zMin() - 1 );
+      handling->forceBoundary( NoSlip_Flag, bottom );
+
+      CellInterval top( domainBB.xMin(), domainBB.yMin(), domainBB.zMax() + 1, domainBB.xMax(), domainBB.yMax(), domainBB.zMax() + 1 );
+      handling->forceBoundary( UBB_Flag, top );
+
+      // obstacles are set based on periodic global coordinates, so that the ghost layers are consistent with the neighbors
+
+      CellInterval cells = flagField->xyzSizeWithGhostLayer();
+      cells.intersect( domainBB );
+      for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      {
+         Cell global;
+         storage->transformBlockLocalToGlobalCell( global, *block, *cell );
+         const cell_idx_t x = ( global.x() + xSize ) % xSize;
+         const cell_idx_t y = ( global.y() + ySize ) % ySize;
+         if( ( x * 7 + y * 13 + global.z() * 5 ) % 5 == 0 || ( x * 3 + y * 11 + global.z() * 17 ) % 7 == 0 )
+            handling->forceBoundary( NoSlip_Flag, cell->x(), cell->y(), cell->z() );
+      }
+
+      handling->fillWithDomain( domainBB );
+
+      return handling;
+   }
+
+private:
+
+   const BlockDataID flagField_;
+   const BlockDataID  pdfField_;
+};
+
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+
+   mpi::Environment env( argc, argv );
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2), uint_t(2), uint_t(2),
+                                                      CellsPerBlock, CellsPerBlock, CellsPerBlock,
+                                                      real_t(1), uint_t(2), uint_t(2), uint_t(1),
+                                                      true, true, false );
+
+   const LatticeModel_T latticeModel( lbm::collision_model::TRT::constructWithMagicNumber( real_t(1.6) ) );
+   const Vector3< real_t > initialVelocity( real_t(0.02), real_t(0), real_t(0) );
+
+   // reference: dense PDF field, regular boundary handling
+
+   BlockDataID pdfFieldId  = lbm::addPdfFieldToStorage( blocks, "pdf field", latticeModel, initialVelocity, real_t(1) );
+   BlockDataID flagFieldId = field::addFlagFieldToStorage< FlagField_T >( blocks, "flag field" );
+   BlockDataID handlingId  = blocks->addStructuredBlockData< BoundaryHandling_T >( MyBoundaryHandling( flagFieldId, pdfFieldId ), "boundary handling" );
+
+   SweepTimeloop referenceTimeloop( blocks->getBlockStorage(), TimeSteps );
+
+   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > referenceCommunication( blocks );
+   referenceCommunication.addPackInfo( make_shared< lbm::PdfFieldPackInfo< LatticeModel_T > >( pdfFieldId ) );
+
+   referenceTimeloop.add() << BeforeFunction( referenceCommunication, "communication" )
+                           << Sweep( BoundaryHandling_T::getBlockSweep( handlingId ), "boundary handling" );
+   referenceTimeloop.add() << Sweep( makeSharedSweep( lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( pdfFieldId, flagFieldId, Fluid_Flag ) ),
+                                    "stream & collide" );
+
+   // sparse: only fluid cells are stored, boundaries are part of the pull index list
+
+   BlockDataID pdfListId = lbm::addSparsePdfListToStorage< LatticeModel_T, FlagField_T >( blocks, "sparse pdf list", latticeModel, flagFieldId, Fluid_Flag,
+                                                                                          UBB_Flag, WallVelocity, initialVelocity, real_t(1) );
+
+   SweepTimeloop timeloop( blocks->getBlockStorage(), TimeSteps );
+
+   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > communication( blocks );
+   communication.addPackInfo( make_shared< lbm::SparsePdfListPackInfo< LatticeModel_T > >( pdfListId ) );
+
+   timeloop.add() << BeforeFunction( communication, "communication" )
+                  << Sweep( lbm::SparsePdfListSweep< LatticeModel_T >( pdfListId ), "stream & collide (sparse)" );
+
+   referenceTimeloop.run();
+   timeloop.run();
+
+   uint_t fluidCells = uint_t(0);
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      PdfField_T * reference  = block->getData< PdfField_T >( pdfFieldId );
+      FlagField_T * flags     = block->getData< FlagField_T >( flagFieldId );
+      SparsePdfList_T * list  = block->getData< SparsePdfList_T >( pdfListId );
+
+      const auto fluid = flags->getFlag( Fluid_Flag );
+
+      uint_t blockFluidCells = uint_t(0);
+      for( auto cell = flags->beginXYZ(); cell != flags->end(); ++cell )
+         if( isFlagSet( cell, fluid ) )
+            ++blockFluidCells;
+
+      WALBERLA_CHECK_EQUAL( blockFluidCells, list->numberOfInnerCells() );
+      WALBERLA_CHECK_LESS( blockFluidCells, CellsPerBlock * CellsPerBlock * CellsPerBlock );
+      fluidCells += blockFluidCells;
+
+      for( uint_t i = uint_t(0); i != list->numberOfInnerCells(); ++i )
+      {
+         const Cell & cell = list->cell(i);
+         WALBERLA_CHECK( flags->isFlagSet( cell, fluid ) );
+         for( uint_t f = uint_t(0); f < LatticeModel_T::Stencil::Size; ++f )
+            WALBERLA_CHECK_FLOAT_EQUAL( reference->get( cell, f ), list->get( i, f ) );
+      }
+   }
+   WALBERLA_CHECK_GREATER( fluidCells, uint_t(0) );
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace sparse_pdf_list_test
+
+int main( int argc, char ** argv )
+{
+   return sparse_pdf_list_test::main( argc, argv );
+}
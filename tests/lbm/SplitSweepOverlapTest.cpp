@@ -0,0 +1,212 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SplitSweepOverlapTest.cpp
+//! \ingroup lbm
+//! \brief Checks that splitting the SplitSweep into an inner and an outer part that overlaps with the communication
+//!        produces the same results as the regular communicate-then-compute scheme
+//
+//======================================================================================================================
+
+#include "lbm/communication/PdfFieldPackInfo.h"
+#include "lbm/field/AddToStorage.h"
+#include "lbm/field/PdfField.h"
+#include "lbm/lattice_model/D3Q19.h"
+#include "lbm/sweeps/SplitSweep.h"
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/math/Constants.h"
+#include "core/mpi/Environment.h"
+
+#include "domain_decomposition/InnerOuterSplit.h"
+#include "domain_decomposition/SharedSweep.h"
+
+#include "field/AddToStorage.h"
+#include "field/FlagField.h"
+
+#include "timeloop/CommunicationOverlap.h"
+#include "timeloop/SweepTimeloop.h"
+
+#include <cmath>
+#include <map>
+
+
+namespace split_sweep_overlap_test {
+
+using namespace walberla;
+
+using flag_t = walberla::uint8_t;
+using FlagField_T = FlagField<flag_t>;
+
+typedef lbm::D3Q19< lbm::collision_model::TRT, false > LatticeModel_T;
+typedef lbm::PdfField< LatticeModel_T > PdfField_T;
+
+const FlagUID Fluid_Flag( "fluid" );
+
+const uint_t TimeSteps = uint_t(10);
+
+
+
+// every cell of 'cells' must be covered exactly once by 'inner' and 'outer'
+void checkSplit( const CellInterval & cells, const Cell & shellWidth )
+{
+   CellInterval inner;
+   std::vector< CellInterval > outer;
+   InnerOuterSplit::split( cells, shellWidth, inner, outer );
+
+   std::map< Cell, uint_t > counter;
+   for( auto cell = inner.begin(); cell != inner.end(); ++cell )
+      ++counter[ *cell ];
+   for( auto interval = outer.begin(); interval != outer.end(); ++interval )
+   {
+      WALBERLA_CHECK( cells.contains( *interval ) );
+      for( auto cell = interval->begin(); cell != interval->end(); ++cell )
+         ++counter[ *cell ];
+   }
+
+   WALBERLA_CHECK_EQUAL( counter.size(), cells.numCells() );
+   for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      WALBERLA_CHECK_EQUAL( counter[ *cell ], uint_t(1) );
+
+   if( !inner.empty() )
+   {
+      CellInterval expected( cells );
+      expected.expand( Cell( -shellWidth.x(), -shellWidth.y(), -shellWidth.z() ) );
+      WALBERLA_CHECK_EQUAL( inner, expected );
+   }
+}
+
+
+
+void initialize( const shared_ptr< StructuredBlockForest > & blocks, const BlockDataID & pdfFieldId, const BlockDataID & flagFieldId )
+{
+   const real_t xSize = real_c( blocks->getNumberOfXCells() );
+   const real_t ySize = real_c( blocks->getNumberOfYCells() );
+   const real_t zSize = real_c( blocks->getNumberOfZCells() );
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      PdfField_T  * pdfField  = block->getData< PdfField_T >( pdfFieldId );
+      FlagField_T * flagField = block->getData< FlagField_T >( flagFieldId );
+
+      const auto fluid = flagField->registerFlag( Fluid_Flag );
+
+      CellInterval cells = pdfField->xyzSize();
+      for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      {
+         Cell global;
+         blocks->transformBlockLocalToGlobalCell( global, *block, *cell );
+
+         const Vector3< real_t > velocity( real_t(0.05) * std::sin( real_t(2) * math::PI * real_c( global.x() ) / xSize ),
+                                           real_t(0.03) * std::cos( real_t(2) * math::PI * real_c( global.y() ) / ySize ),
+                                           real_t(0.02) * std::sin( real_t(2) * math::PI * real_c( global.z() ) / zSize ) );
+         pdfField->setDensityAndVelocity( *cell, velocity, real_t(1) );
+         flagField->addFlag( *cell, fluid );
+      }
+   }
+}
+
+
+
+void test( const shared_ptr< StructuredBlockForest > & blocks, const field::Layout layout )
+{
+   const LatticeModel_T latticeModel( lbm::collision_model::TRT::constructWithMagicNumber( real_t(1.7) ) );
+
+   // reference: communicate, then stream & collide
+
+   BlockDataID referenceId    = lbm::addPdfFieldToStorage( blocks, "reference", latticeModel, layout );
+   BlockDataID referenceFlags = field::addFlagFieldToStorage< FlagField_T >( blocks, "reference flags" );
+   initialize( blocks, referenceId, referenceFlags );
+
+   SweepTimeloop referenceTimeloop( blocks->getBlockStorage(), TimeSteps );
+
+   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > referenceCommunication( blocks );
+   referenceCommunication.addPackInfo( make_shared< lbm::PdfFieldPackInfo< LatticeModel_T > >( referenceId ) );
+
+   referenceTimeloop.add() << BeforeFunction( referenceCommunication, "communication" )
+                           << Sweep( makeSharedSweep( make_shared< lbm::SplitSweep< LatticeModel_T, FlagField_T > >( referenceId, referenceFlags, Fluid_Flag ) ),
+                                     "stream & collide" );
+
+   // overlap: start communication, inner part, wait, outer part
+
+   BlockDataID pdfFieldId  = lbm::addPdfFieldToStorage( blocks, "pdf field", latticeModel, layout );
+   BlockDataID tmpFieldId  = lbm::addPdfFieldToStorage( blocks, "tmp field", latticeModel, layout );
+   BlockDataID flagFieldId = field::addFlagFieldToStorage< FlagField_T >( blocks, "flag field" );
+   initialize( blocks, pdfFieldId, flagFieldId );
+
+   SweepTimeloop timeloop( blocks->getBlockStorage(), TimeSteps );
+
+   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > communication( blocks );
+   communication.addPackInfo( make_shared< lbm::PdfFieldPackInfo< LatticeModel_T > >( pdfFieldId ) );
+
+   auto sweep = make_shared< lbm::SplitSweep< LatticeModel_T, FlagField_T > >( pdfFieldId, tmpFieldId, flagFieldId, Fluid_Flag );
+   timeloop::addOverlappingSweep( timeloop, communication.getStartCommunicateFunctor(), communication.getWaitFunctor(),
+                                  makeInnerOuterSplit( blocks, sweep ), "stream & collide" );
+
+   referenceTimeloop.run();
+
+   WcTimingPool timing;
+   timeloop.run( timing );
+
+   const auto overlap = timeloop::evaluateCommunicationOverlap( timing, "stream & collide" );
+   WALBERLA_LOG_INFO_ON_ROOT( overlap );
+   WALBERLA_CHECK_GREATER( overlap.inner, 0.0 );
+   WALBERLA_CHECK_GREATER( overlap.outer, 0.0 );
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      PdfField_T * reference = block->getData< PdfField_T >( referenceId );
+      PdfField_T * pdfField  = block->getData< PdfField_T >( pdfFieldId );
+
+      CellInterval cells = pdfField->xyzSize();
+      for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+         for( uint_t f = uint_t(0); f < LatticeModel_T::Stencil::Size; ++f )
+            WALBERLA_CHECK_FLOAT_EQUAL( reference->get( *cell, f ), pdfField->get( *cell, f ) );
+   }
+}
+
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+
+   mpi::Environment env( argc, argv );
+
+   checkSplit( CellInterval( 0, 0, 0, 9, 7, 5 ), Cell( 1, 1, 1 ) );
+   checkSplit( CellInterval( 0, 0, 0, 9, 7, 5 ), Cell( 2, 1, 0 ) );
+   checkSplit( CellInterval( 0, 0, 0, 9, 7, 0 ), Cell( 1, 1, 0 ) );
+   checkSplit( CellInterval( 0, 0, 0, 1, 7, 5 ), Cell( 1, 1, 1 ) ); // no interior
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2), uint_t(2), uint_t(2),
+                                                      uint_t(10), uint_t(8), uint_t(6),
+                                                      real_t(1), uint_t(2), uint_t(2), uint_t(1),
+                                                      true, true, true );
+
+   test( blocks, field::fzyx );
+   test( blocks, field::zyxf );
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace split_sweep_overlap_test
+
+int main( int argc, char ** argv )
+{
+   return split_sweep_overlap_test::main( argc, argv );
+}
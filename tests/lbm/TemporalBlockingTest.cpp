@@ -0,0 +1,197 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file TemporalBlockingTest.cpp
+//! \ingroup lbm
+//! \brief Checks that temporal blocking produces exactly the same results as one ghost layer exchange per time step
+//
+//======================================================================================================================
+
+#include "lbm/boundary/NoSlip.h"
+#include "lbm/boundary/SimpleUBB.h"
+#include "lbm/communication/PdfFieldPackInfo.h"
+#include "lbm/field/AddToStorage.h"
+#include "lbm/field/PdfField.h"
+#include "lbm/lattice_model/D3Q19.h"
+#include "lbm/sweeps/CellwiseSweep.h"
+#include "lbm/sweeps/SweepWrappers.h"
+#include "lbm/sweeps/TemporalBlockingSweep.h"
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+
+#include "boundary/BoundaryHandling.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "domain_decomposition/SharedSweep.h"
+
+#include "field/AddToStorage.h"
+#include "field/FlagField.h"
+#include "field/communication/PackInfo.h"
+
+#include "stencil/D3Q27.h"
+
+#include "timeloop/SweepTimeloop.h"
+
+
+namespace temporal_blocking_test {
+
+using namespace walberla;
+
+using flag_t = walberla::uint8_t;
+using FlagField_T = FlagField<flag_t>;
+
+typedef lbm::D3Q19< lbm::collision_model::TRT, false > LatticeModel_T;
+typedef lbm::PdfField< LatticeModel_T > PdfField_T;
+
+typedef lbm::NoSlip< LatticeModel_T, flag_t >    NoSlip_T;
+typedef lbm::SimpleUBB< LatticeModel_T, flag_t > UBB_T;
+typedef BoundaryHandling< FlagField_T, LatticeModel_T::Stencil, boost::tuples::tuple< NoSlip_T, UBB_T > > BoundaryHandling_T;
+
+const FlagUID  Fluid_Flag( "fluid" );
+const FlagUID    UBB_Flag( "velocity bounce back" );
+const FlagUID NoSlip_Flag( "no slip" );
+
+const uint_t CellsPerBlock = uint_t(6);
+const uint_t Depth         = uint_t(3);
+const uint_t TimeSteps     = uint_t(12);
+const real_t Velocity      = real_t(0.05);
+
+
+
+// channel that is periodic in x- and y-direction, with a no slip wall at the bottom and a moving wall at the top
+
+class MyBoundaryHandling
+{
+public:
+
+   MyBoundaryHandling( const BlockDataID & flagField, const BlockDataID & pdfField ) :
+      flagField_( flagField ), pdfField_( pdfField ) {}
+
+   BoundaryHandling_T * operator()( IBlock* const block, const StructuredBlockStorage* const storage ) const
+   {
+      FlagField_T * flagField = block->getData< FlagField_T >( flagField_ );
+      PdfField_T *   pdfField = block->getData< PdfField_T > (  pdfField_ );
+
+      const auto fluid = flagField->flagExists( Fluid_Flag ) ? flagField->getFlag( Fluid_Flag ) : flagField->registerFlag( Fluid_Flag );
+
+      BoundaryHandling_T * handling = new BoundaryHandling_T( "boundary handling", flagField, fluid,
+            boost::tuples::make_tuple( NoSlip_T( "no slip", NoSlip_Flag, pdfField ),
+                                       UBB_T( "velocity bounce back", UBB_Flag, pdfField, Velocity, real_t(0), real_t(0) ) ) );
+
+      const cell_idx_t gl = cell_idx_c( flagField->nrOfGhostLayers() );
+
+      CellInterval domainBB = storage->getDomainCellBB();
+      storage->transformGlobalToBlockLocalCellInterval( domainBB, *block );
+
+      domainBB.xMin() -= gl;
+      domainBB.xMax() += gl;
+      domainBB.yMin() -= gl;
+      domainBB.yMax() += gl;
+
+      CellInterval bottom( domainBB.xMin(), domainBB.yMin(), domainBB.zMin() - 1, domainBB.xMax(), domainBB.yMax(), domainBB.zMin() - 1 );
+      handling->forceBoundary( NoSlip_Flag, bottom );
+
+      CellInterval top( domainBB.xMin(), domainBB.yMin(), domainBB.zMax() + 1, domainBB.xMax(), domainBB.yMax(), domainBB.zMax() + 1 );
+      handling->forceBoundary( UBB_Flag, top );
+
+      handling->fillWithDomain( domainBB );
+
+      return handling;
+   }
+
+private:
+
+   const BlockDataID flagField_;
+   const BlockDataID  pdfField_;
+};
+
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+
+   mpi::Environment env( argc, argv );
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(2), uint_t(2), uint_t(2),
+                                                      CellsPerBlock, CellsPerBlock, CellsPerBlock,
+                                                      real_t(1), false,
+                                                      true, true, false );
+
+   const LatticeModel_T latticeModel( lbm::collision_model::TRT::constructWithMagicNumber( real_t(1.4) ) );
+   const Vector3< real_t > initialVelocity( Velocity, Velocity / real_t(2), real_t(0) );
+
+   // reference: ghost layer exchange and boundary handling before every stream & collide step
+
+   BlockDataID referencePdfFieldId  = lbm::addPdfFieldToStorage( blocks, "reference pdf field", latticeModel, initialVelocity, real_t(1), uint_t(1) );
+   BlockDataID referenceFlagFieldId = field::addFlagFieldToStorage< FlagField_T >( blocks, "reference flag field", uint_t(1) );
+   BlockDataID referenceHandlingId  = blocks->addStructuredBlockData< BoundaryHandling_T >(
+            MyBoundaryHandling( referenceFlagFieldId, referencePdfFieldId ), "reference boundary handling" );
+
+   SweepTimeloop referenceTimeloop( blocks->getBlockStorage(), TimeSteps );
+
+   blockforest::communication::UniformBufferedScheme< LatticeModel_T::CommunicationStencil > referenceCommunication( blocks );
+   referenceCommunication.addPackInfo( make_shared< lbm::PdfFieldPackInfo< LatticeModel_T > >( referencePdfFieldId ) );
+
+   referenceTimeloop.add() << BeforeFunction( referenceCommunication, "communication" )
+                           << Sweep( BoundaryHandling_T::getBlockSweep( referenceHandlingId ), "boundary handling" );
+   referenceTimeloop.add() << Sweep( makeSharedSweep( lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( referencePdfFieldId, referenceFlagFieldId, Fluid_Flag ) ),
+                                     "stream & collide" );
+
+   // temporal blocking: 'Depth' ghost layers, exchanged only every 'Depth' time steps
+
+   BlockDataID pdfFieldId  = lbm::addPdfFieldToStorage( blocks, "pdf field", latticeModel, initialVelocity, real_t(1), Depth );
+   BlockDataID flagFieldId = field::addFlagFieldToStorage< FlagField_T >( blocks, "flag field", Depth );
+   BlockDataID handlingId  = blocks->addStructuredBlockData< BoundaryHandling_T >( MyBoundaryHandling( flagFieldId, pdfFieldId ), "boundary handling" );
+
+   SweepTimeloop timeloop( blocks->getBlockStorage(), TimeSteps / Depth );
+
+   blockforest::communication::UniformBufferedScheme< stencil::D3Q27 > communication( blocks );
+   communication.addPackInfo( make_shared< field::communication::PackInfo< PdfField_T > >( pdfFieldId ) );
+
+   lbm::TemporalBlockingSweep temporalBlocking( Depth );
+   temporalBlocking.addSweep( lbm::TemporalBlockingBoundarySweep< BoundaryHandling_T >( handlingId ) );
+   temporalBlocking.addSweep( lbm::makeStreamCollideSweep( lbm::makeCellwiseSweep< LatticeModel_T, FlagField_T >( pdfFieldId, flagFieldId, Fluid_Flag ) ) );
+
+   timeloop.add() << BeforeFunction( communication, "communication" )
+                  << Sweep( temporalBlocking, "boundary handling & stream & collide (temporal blocking)" );
+
+   referenceTimeloop.run();
+   timeloop.run();
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      PdfField_T * reference = block->getData< PdfField_T >( referencePdfFieldId );
+      PdfField_T * field     = block->getData< PdfField_T >( pdfFieldId );
+
+      for( cell_idx_t z = cell_idx_t(0); z < cell_idx_c( CellsPerBlock ); ++z )
+         for( cell_idx_t y = cell_idx_t(0); y < cell_idx_c( CellsPerBlock ); ++y )
+            for( cell_idx_t x = cell_idx_t(0); x < cell_idx_c( CellsPerBlock ); ++x )
+               for( uint_t f = uint_t(0); f < LatticeModel_T::Stencil::Size; ++f )
+                  WALBERLA_CHECK_FLOAT_EQUAL( reference->get( x, y, z, f ), field->get( x, y, z, f ) );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace temporal_blocking_test
+
+int main( int argc, char ** argv )
+{
+   return temporal_blocking_test::main( argc, argv );
+}
@@ -370,8 +370,12 @@ int main( int argc, char ** argv )
    mpi::Environment env( argc, argv );
 
    bool shortrun = false;
+   bool fused = false;
    for( int i = 1; i < argc; ++i )
+   {
       if( std::strcmp( argv[i], "--shortrun" ) == 0 ) shortrun = true;
+      if( std::strcmp( argv[i], "--fused" )    == 0 ) fused    = true;
+   }
 
    logging::Logging::printHeaderOnStream();
 
@@ -457,6 +461,12 @@ int main( int argc, char ** argv )
    auto tstep2 = lbm::refinement::makeTimeStep< LatticeModel_T, BoundaryHandling_T >( blocks, mySweep2, pdfFieldId2, boundaryHandlingId2 );
    tstep1->optimizeCommunication( true );
    tstep2->optimizeCommunication( false );
+   if( fused )
+   {
+      // fused stream & collide on intermediate levels (with timing) must yield the same result as the default schedule
+      tstep1->useFusedStreamCollide( true );
+      tstep1->enableTiming();
+   }
 
    timeloop.addFuncBeforeTimeStep( makeSharedFunctor( tstep1 ), "LBM refinement time step (1)" );
    timeloop.addFuncBeforeTimeStep( makeSharedFunctor( tstep2 ), "LBM refinement time step (2)" );
@@ -483,6 +493,12 @@ int main( int argc, char ** argv )
    timeloop.run( timeloopTiming );
    timeloopTiming.logResultOnRoot();
 
+   if( fused )
+   {
+      WALBERLA_CHECK( tstep1->fusedStreamCollideIsUsed() );
+      WALBERLA_CHECK( tstep1->getLevelWiseTimingPool()->timerExists( "stream & collide (1)" ) );
+   }
+
    logging::Logging::printFooterOnStream();
    
    return EXIT_SUCCESS;
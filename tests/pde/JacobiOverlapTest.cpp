@@ -0,0 +1,225 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file JacobiOverlapTest.cpp
+//! \ingroup pde
+//! \brief Checks that Jacobi sweeps and generic field sweeps that are split into an inner and an outer part (with the
+//!        inner part overlapping the communication) produce the same results as the regular scheme
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/math/Constants.h"
+#include "core/mpi/Environment.h"
+
+#include "domain_decomposition/InnerOuterSplit.h"
+#include "domain_decomposition/SharedSweep.h"
+
+#include "field/AddToStorage.h"
+#include "field/GhostLayerField.h"
+#include "field/communication/PackInfo.h"
+#include "field/iterators/IteratorMacros.h"
+
+#include "pde/sweeps/Jacobi.h"
+
+#include "stencil/D2Q5.h"
+
+#include "timeloop/CommunicationOverlap.h"
+#include "timeloop/SweepTimeloop.h"
+
+#include <cmath>
+
+
+namespace jacobi_overlap_test {
+
+using namespace walberla;
+
+typedef GhostLayerField< real_t, 1 > PdeField_T;
+using Stencil_T = stencil::D2Q5;
+using StencilField_T = pde::Jacobi<Stencil_T>::StencilField_T;
+
+const uint_t Iterations = uint_t(20);
+
+
+
+void initialize( const shared_ptr< StructuredBlockForest > & blocks, const BlockDataID & uId, const BlockDataID & fId, const BlockDataID & stencilId )
+{
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      PdeField_T * u = block->getData< PdeField_T >( uId );
+      PdeField_T * f = block->getData< PdeField_T >( fId );
+      StencilField_T * stencil = block->getData< StencilField_T >( stencilId );
+
+      CellInterval cells = u->xyzSize();
+      for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+      {
+         const Vector3< real_t > p = blocks->getBlockLocalCellCenter( *block, *cell );
+         u->get( *cell ) = std::sin( real_t(3) * p[0] ) * std::cos( real_t(2) * p[1] );
+         f->get( *cell ) = real_t(0.1) * p[0] * p[1];
+
+         stencil->get( *cell, Stencil_T::idx[ stencil::C ] ) = real_t(4.5) + real_t(0.01) * p[0];
+         stencil->get( *cell, Stencil_T::idx[ stencil::N ] ) = real_t(-1);
+         stencil->get( *cell, Stencil_T::idx[ stencil::S ] ) = real_t(-1);
+         stencil->get( *cell, Stencil_T::idx[ stencil::E ] ) = real_t(-1);
+         stencil->get( *cell, Stencil_T::idx[ stencil::W ] ) = real_t(-1);
+      }
+   }
+}
+
+
+
+void compare( const shared_ptr< StructuredBlockForest > & blocks, const BlockDataID & referenceId, const BlockDataID & uId )
+{
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      PdeField_T * reference = block->getData< PdeField_T >( referenceId );
+      PdeField_T * u         = block->getData< PdeField_T >( uId );
+
+      CellInterval cells = u->xyzSize();
+      for( auto cell = cells.begin(); cell != cells.end(); ++cell )
+         WALBERLA_CHECK_FLOAT_EQUAL( reference->get( *cell ), u->get( *cell ) );
+   }
+}
+
+
+
+// generic field sweep: dst = average of the four neighbors in src, src and dst are swapped in 'finalize'
+
+class Smoothing
+{
+public:
+
+   Smoothing( const BlockDataID & src, const BlockDataID & dst ) : src_( src ), dst_( dst ) {}
+
+   void operator()( IBlock * const block, const CellInterval & cells )
+   {
+      PdeField_T * src = block->getData< PdeField_T >( src_ );
+      PdeField_T * dst = block->getData< PdeField_T >( dst_ );
+
+      WALBERLA_FOR_ALL_CELLS_IN_INTERVAL_XYZ( cells,
+         dst->get(x,y,z) = real_t(0.25) * ( src->get(x+1,y,z) + src->get(x-1,y,z) + src->get(x,y+1,z) + src->get(x,y-1,z) );
+      )
+   }
+
+   void swap( IBlock * const block )
+   {
+      block->getData< PdeField_T >( src_ )->swapDataPointers( block->getData< PdeField_T >( dst_ ) );
+   }
+
+   void operator()( IBlock * const block )
+   {
+      (*this)( block, block->getData< PdeField_T >( src_ )->xyzSize() );
+      swap( block );
+   }
+
+private:
+
+   const BlockDataID src_;
+   const BlockDataID dst_;
+};
+
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+
+   mpi::Environment env( argc, argv );
+
+   auto blocks = blockforest::createUniformBlockGrid( uint_t(4), uint_t(2), uint_t(1),
+                                                      uint_t(12), uint_t(9), uint_t(1),
+                                                      real_t(0.1), uint_t(2), uint_t(2), uint_t(1),
+                                                      true, true, false );
+
+   BlockDataID fId       = field::addToStorage< PdeField_T >( blocks, "f", real_t(0), field::zyxf, uint_t(1) );
+   BlockDataID stencilId = field::addToStorage< StencilField_T >( blocks, "w" );
+
+   BlockDataID referenceId = field::addToStorage< PdeField_T >( blocks, "u (reference)", real_t(0), field::zyxf, uint_t(1) );
+   BlockDataID uId         = field::addToStorage< PdeField_T >( blocks, "u", real_t(0), field::zyxf, uint_t(1) );
+   BlockDataID tmpId       = field::addToStorage< PdeField_T >( blocks, "tmp", real_t(0), field::zyxf, uint_t(1) );
+
+   initialize( blocks, referenceId, fId, stencilId );
+   initialize( blocks, uId, fId, stencilId );
+
+   // pde::Jacobi
+
+   {
+      SweepTimeloop referenceTimeloop( blocks->getBlockStorage(), Iterations );
+
+      blockforest::communication::UniformBufferedScheme< Stencil_T > referenceCommunication( blocks );
+      referenceCommunication.addPackInfo( make_shared< field::communication::PackInfo< PdeField_T > >( referenceId ) );
+
+      referenceTimeloop.add() << BeforeFunction( referenceCommunication, "communication" )
+                              << Sweep( makeSharedSweep( make_shared< pde::Jacobi< Stencil_T > >( referenceId, fId, stencilId ) ), "Jacobi" );
+
+      SweepTimeloop timeloop( blocks->getBlockStorage(), Iterations );
+
+      blockforest::communication::UniformBufferedScheme< Stencil_T > communication( blocks );
+      communication.addPackInfo( make_shared< field::communication::PackInfo< PdeField_T > >( uId ) );
+
+      auto jacobi = make_shared< pde::Jacobi< Stencil_T > >( uId, tmpId, fId, stencilId );
+      timeloop::addOverlappingSweep( timeloop, communication.getStartCommunicateFunctor(), communication.getWaitFunctor(),
+                                     makeInnerOuterSplit( blocks, jacobi, Cell( 1, 1, 0 ) ), "Jacobi" );
+
+      referenceTimeloop.run();
+
+      WcTimingPool timing;
+      timeloop.run( timing );
+      WALBERLA_LOG_INFO_ON_ROOT( "Jacobi: " << timeloop::evaluateCommunicationOverlap( timing, "Jacobi" ) );
+
+      compare( blocks, referenceId, uId );
+   }
+
+   // generic field sweep, split by constructing the InnerOuterSplit directly
+
+   {
+      BlockDataID referenceTmpId = field::addToStorage< PdeField_T >( blocks, "tmp (reference)", real_t(0), field::zyxf, uint_t(1) );
+
+      SweepTimeloop referenceTimeloop( blocks->getBlockStorage(), Iterations );
+
+      blockforest::communication::UniformBufferedScheme< Stencil_T > referenceCommunication( blocks );
+      referenceCommunication.addPackInfo( make_shared< field::communication::PackInfo< PdeField_T > >( referenceId ) );
+
+      referenceTimeloop.add() << BeforeFunction( referenceCommunication, "communication" )
+                              << Sweep( makeSharedSweep( make_shared< Smoothing >( referenceId, referenceTmpId ) ), "smoothing" );
+
+      SweepTimeloop timeloop( blocks->getBlockStorage(), Iterations );
+
+      blockforest::communication::UniformBufferedScheme< Stencil_T > communication( blocks );
+      communication.addPackInfo( make_shared< field::communication::PackInfo< PdeField_T > >( uId ) );
+
+      auto smoothing = make_shared< Smoothing >( uId, tmpId );
+      InnerOuterSplit split( blocks, [smoothing]( IBlock * const block, const CellInterval & cells ) { (*smoothing)( block, cells ); },
+                                     [smoothing]( IBlock * const block ) { smoothing->swap( block ); }, Cell( 1, 1, 0 ) );
+      timeloop::addOverlappingSweep( timeloop, communication.getStartCommunicateFunctor(), communication.getWaitFunctor(), split, "smoothing" );
+
+      referenceTimeloop.run();
+      timeloop.run();
+
+      compare( blocks, referenceId, uId );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace jacobi_overlap_test
+
+int main( int argc, char ** argv )
+{
+   return jacobi_overlap_test::main( argc, argv );
+}
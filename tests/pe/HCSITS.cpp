@@ -181,6 +181,14 @@ int main( int argc, char** argv )
    cr.setRelaxationModel( cr::HardContactSemiImplicitTimesteppingSolvers::InelasticFrictionlessContact );
    speedLimiterTest(cr, sp);
 
+   WALBERLA_LOG_PROGRESS("Normal Reaction Test: InelasticFrictionlessContact (parallel execution)");
+   cr.setSpeedLimiter( false );
+   cr.setParallelExecution( true );
+   normalReactionTest(cr, sp);
+   WALBERLA_LOG_PROGRESS( "Normal Reaction Test: InelasticGeneralizedMaximumDissipationContact (parallel execution)");
+   cr.setRelaxationModel( cr::HardContactSemiImplicitTimesteppingSolvers::InelasticGeneralizedMaximumDissipationContact );
+   normalReactionTest(cr, sp);
+
    return EXIT_SUCCESS;
 }
 } // namespace walberla
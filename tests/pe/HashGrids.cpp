@@ -27,6 +27,7 @@
 #include "core/all.h"
 #include "domain_decomposition/all.h"
 
+#include "core/OpenMP.h"
 #include "core/timing/TimingPool.h"
 #include "core/debug/TestSubsystem.h"
 #include "core/math/Random.h"
@@ -140,6 +141,23 @@ int main( int argc, char** argv )
              WALBERLA_CHECK_LESS(cont1[i].getBody1()->getSystemID(), cont1[i].getBody2()->getSystemID());
              WALBERLA_CHECK_LESS(cont2[i].getBody1()->getSystemID(), cont2[i].getBody2()->getSystemID());
           }
+
+          // the parallel contact generation must yield the same contacts in the same order as the serial one
+          WALBERLA_OPENMP_SECTION()
+          {
+             const int threads = omp_get_max_threads();
+             omp_set_num_threads( 1 );
+             const PossibleContacts serial = hccd->generatePossibleContacts();
+             omp_set_num_threads( 4 );
+             const PossibleContacts parallel = hccd->generatePossibleContacts();
+             omp_set_num_threads( threads );
+             WALBERLA_CHECK_EQUAL( serial.size(), parallel.size() );
+             for (size_t i = 0; i < serial.size(); ++i)
+             {
+                WALBERLA_CHECK_EQUAL( serial[i].first , parallel[i].first  );
+                WALBERLA_CHECK_EQUAL( serial[i].second, parallel[i].second );
+             }
+          }
        }
     }
 
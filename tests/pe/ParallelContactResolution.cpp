@@ -0,0 +1,193 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file ParallelContactResolution.cpp
+//
+//======================================================================================================================
+
+#include "pe/basic.h"
+#include "pe/cr/ContactColoring.h"
+
+#include "blockforest/all.h"
+#include "core/all.h"
+#include "domain_decomposition/all.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/OpenMP.h"
+
+#include <boost/tuple/tuple.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace walberla {
+using namespace walberla::pe;
+
+typedef boost::tuple<Sphere, Plane> BodyTuple ;
+
+void coloringTest()
+{
+   BodyStorage storage;
+   std::vector<ConstBodyID> b;
+   for( id_t i = 0; i < 4; ++i )
+      b.push_back( &storage.add( std::make_unique<Sphere>( i, i, Vec3( real_c(i), 0, 0 ), Vec3(), Quat(), real_t(1), Material::find("iron"), false, true, false ) ) );
+
+   std::vector< std::pair<ConstBodyID, ConstBodyID> > bodies;
+   bodies.push_back( std::make_pair( b[0], b[1] ) );
+   bodies.push_back( std::make_pair( b[1], b[2] ) );
+   bodies.push_back( std::make_pair( b[2], b[3] ) );
+   bodies.push_back( std::make_pair( b[0], ConstBodyID( NULL ) ) );
+   bodies.push_back( std::make_pair( b[3], ConstBodyID( NULL ) ) );
+   bodies.push_back( std::make_pair( b[0], b[2] ) );
+
+   std::vector<size_t> order;
+   std::vector<size_t> colorOffsets;
+   cr::colorContacts( bodies, order, colorOffsets );
+
+   const std::vector<size_t> expectedOrder = { 0, 2, 1, 3, 4, 5 };
+   const std::vector<size_t> expectedOffsets = { 0, 2, 5, 6 };
+   WALBERLA_CHECK( order == expectedOrder );
+   WALBERLA_CHECK( colorOffsets == expectedOffsets );
+
+   for( size_t color = 0; color + 1 < colorOffsets.size(); ++color )
+   {
+      std::set<ConstBodyID> used;
+      for( size_t c = colorOffsets[color]; c < colorOffsets[color + 1]; ++c )
+      {
+         if( bodies[order[c]].first != NULL )
+            WALBERLA_CHECK( used.insert( bodies[order[c]].first ).second );
+         if( bodies[order[c]].second != NULL )
+            WALBERLA_CHECK( used.insert( bodies[order[c]].second ).second );
+      }
+   }
+
+   storage.clear();
+}
+
+template< typename Solver >
+std::vector<Vec3> sim()
+{
+   shared_ptr<BodyStorage> globalStorage = make_shared<BodyStorage>();
+
+   shared_ptr< StructuredBlockForest > forest = blockforest::createUniformBlockGrid(
+            math::AABB(0,0,0,6,6,6),
+            uint_c( 1), uint_c( 1), uint_c( 1), // number of blocks in x,y,z direction
+            uint_c( 1), uint_c( 1), uint_c( 1), // how many cells per block (x,y,z)
+            true,                               // max blocks per process
+            false, false, false,                // no periodicity
+            false);
+
+   auto storageID = forest->addBlockData(createStorageDataHandling<BodyTuple>(), "Storage");
+   auto ccdID     = forest->addBlockData(ccd::createHashGridsDataHandling( globalStorage, storageID ), "CCD");
+   auto fcdID     = forest->addBlockData(fcd::createGenericFCDDataHandling<BodyTuple, fcd::AnalyticCollideFunctor>(), "FCD");
+
+   Solver cr( globalStorage, forest->getBlockStoragePointer(), storageID, ccdID, fcdID );
+   cr.setGlobalLinearAcceleration( Vec3( 0, 0, real_t(-1) ) );
+   cr.setParallelExecution( true );
+   WALBERLA_CHECK( cr.isParallelExecutionActive() );
+
+   MaterialID granular = Material::find( "granular" );
+   pe::createPlane( *globalStorage, 0, Vec3(0, 0, +1), Vec3(3,3,0), granular);
+   pe::createPlane( *globalStorage, 0, Vec3(0, 0, -1), Vec3(3,3,6), granular);
+   pe::createPlane( *globalStorage, 0, Vec3(0, +1, 0), Vec3(3,0,3), granular);
+   pe::createPlane( *globalStorage, 0, Vec3(0, -1, 0), Vec3(3,6,3), granular);
+   pe::createPlane( *globalStorage, 0, Vec3(+1, 0, 0), Vec3(0,3,3), granular);
+   pe::createPlane( *globalStorage, 0, Vec3(-1, 0, 0), Vec3(6,3,3), granular);
+
+   // densely packed spheres with random velocities: many simultaneous collisions
+   const real_t dv = real_c(1);
+   math::seedRandomGenerator(1337);
+   walberla::id_t counter = 0;
+   for (int z = 0; z < 6; ++z)
+      for (int y = 0; y < 6; ++y)
+         for (int x = 0; x < 6; ++x)
+         {
+            SphereID sp = pe::createSphere( *globalStorage, forest->getBlockStorage(), storageID,
+                                            ++counter, Vec3(real_c(x) + real_c(0.5), real_c(y) + real_c(0.5), real_c(z) + real_c(0.5)), real_c(0.45));
+            sp->setLinearVel( Vec3( math::realRandom<real_t>(-dv, dv), math::realRandom<real_t>(-dv, dv), math::realRandom<real_t>(-dv, dv) ) );
+         }
+
+   size_t contacts = 0;
+   for (int i = 0; i < 100; ++i)
+   {
+      cr.timestep( real_c(0.01) );
+      contacts += cr.getNumberOfContactsTreated();
+   }
+   WALBERLA_CHECK_GREATER( contacts, 100 );
+
+   std::vector<Vec3> res( counter );
+   for (auto it = forest->begin(); it != forest->end(); ++it)
+   {
+      BodyStorage& localStorage = (*it->getData< Storage >( storageID ))[0];
+      for (auto bodyIt = localStorage.begin(); bodyIt != localStorage.end(); ++bodyIt)
+      {
+         WALBERLA_CHECK( !math::isnan( bodyIt->getPosition() ) );
+         res[ bodyIt->getID() - 1 ] = bodyIt->getPosition();
+      }
+   }
+   return res;
+}
+
+/// The contact resolution in parallel mode must not depend on the number of threads.
+template< typename Solver >
+void threadIndependenceTest()
+{
+   const std::vector<Vec3> reference = sim<Solver>();
+
+   WALBERLA_OPENMP_SECTION()
+   {
+      const int threads = omp_get_max_threads();
+
+      omp_set_num_threads( 1 );
+      const std::vector<Vec3> serial = sim<Solver>();
+      omp_set_num_threads( 4 );
+      const std::vector<Vec3> parallel = sim<Solver>();
+      omp_set_num_threads( threads );
+
+      WALBERLA_CHECK_EQUAL( reference.size(), serial.size() );
+      WALBERLA_CHECK_EQUAL( reference.size(), parallel.size() );
+      for( size_t i = 0; i < reference.size(); ++i )
+      {
+         WALBERLA_CHECK_IDENTICAL( reference[i], serial[i] );
+         WALBERLA_CHECK_IDENTICAL( reference[i], parallel[i] );
+      }
+   }
+}
+
+int main( int argc, char** argv )
+{
+   walberla::debug::enterTestMode();
+   walberla::MPIManager::instance()->initializeMPI( &argc, &argv );
+
+   SetBodyTypeIDs<BodyTuple>::execute();
+
+   WALBERLA_LOG_INFO("Coloring test");
+   coloringTest();
+
+   WALBERLA_LOG_INFO("DEM test");
+   threadIndependenceTest<cr::DEM>();
+
+   WALBERLA_LOG_INFO("HCSITS test");
+   threadIndependenceTest<cr::HCSITS>();
+
+   return EXIT_SUCCESS;
+}
+} // namespace walberla
+
+int main( int argc, char* argv[] )
+{
+  return walberla::main( argc, argv );
+}
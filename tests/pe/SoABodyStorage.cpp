@@ -0,0 +1,254 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SoABodyStorage.cpp
+//
+//======================================================================================================================
+
+#include "pe/contact/Contact.h"
+#include "pe/cr/Integrators.h"
+#include "pe/cr/PlainIntegrator.h"
+#include "pe/cr/SoAIntegrators.h"
+#include "pe/fcd/AnalyticCollisionDetection.h"
+#include "pe/fcd/SoASphereContacts.h"
+#include "pe/Materials.h"
+#include "pe/rigidbody/Box.h"
+#include "pe/rigidbody/SetBodyTypeIDs.h"
+#include "pe/rigidbody/SoABodyStorage.h"
+#include "pe/rigidbody/Sphere.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/math/Random.h"
+
+#include <boost/tuple/tuple.hpp>
+
+namespace walberla {
+using namespace walberla::pe;
+
+typedef boost::tuple<Sphere, Box> BodyTuple ;
+
+/// solver that only provides the gravity for the reference integrator
+class Gravity : public cr::ICR
+{
+public:
+   Gravity( const Vec3& g ) { setGlobalLinearAcceleration( g ); }
+   void timestep( const real_t ) {}
+};
+
+void fill( BodyStorage& storage )
+{
+   MaterialID iron = Material::find("iron");
+   math::seedRandomGenerator(42);
+   for( id_t i = 0; i < 200; ++i )
+   {
+      const Vec3 pos( math::realRandom<real_t>(0, 10), math::realRandom<real_t>(0, 10), math::realRandom<real_t>(0, 10) );
+      BodyID body;
+      if( i % 4 == 3 )
+         body = &storage.add( std::make_unique<Box>( i, i, pos, Vec3(), Quat(), Vec3(real_t(0.5), real_t(1), real_t(1.5)), iron, false, true, false ) );
+      else
+         body = &storage.add( std::make_unique<Sphere>( i, i, pos, Vec3(), Quat(), real_c( i % 2 == 0 ? 0.5 : 0.7 ), iron, false, true, i == 10 ) );
+      if( !body->hasInfiniteMass() )
+      {
+         body->setLinearVel ( Vec3( math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1) ) );
+         body->setAngularVel( Vec3( math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1) ) );
+      }
+      body->setForce ( Vec3( math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1) ) );
+      body->setTorque( Vec3( math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1), math::realRandom<real_t>(-1, 1) ) );
+   }
+}
+
+void storageTest()
+{
+   BodyStorage storage;
+   fill( storage );
+
+   SoABodyStorage soa;
+   soa.load( storage );
+   WALBERLA_CHECK_EQUAL( soa.size(), storage.size() );
+   // two sphere radii and one box
+   WALBERLA_CHECK_EQUAL( soa.getShapeCount(), 3 );
+
+   for( auto it = storage.begin(); it != storage.end(); ++it )
+   {
+      const auto i = soa.find( it->getSystemID() );
+      WALBERLA_CHECK_LESS( i, soa.size() );
+      WALBERLA_CHECK_EQUAL( soa.getSystemID( i ), it->getSystemID() );
+      WALBERLA_CHECK_EQUAL( soa.getPosition( i ), it->getPosition() );
+      WALBERLA_CHECK_EQUAL( soa.getForce( i ), it->getForce() );
+      WALBERLA_CHECK_EQUAL( soa.hasInfiniteMass( i ), it->hasInfiniteMass() );
+      WALBERLA_CHECK_EQUAL( soa.getShape( soa.getShapeIndex( i ) ).typeID, it->getTypeID() );
+   }
+   WALBERLA_CHECK_EQUAL( soa.find( 999 ), soa.size() );
+
+   // removing moves the last body into the freed slot
+   const id_t last = soa.getSystemID( soa.size() - 1 );
+   soa.remove( soa.getSystemID( 5 ) );
+   WALBERLA_CHECK_EQUAL( soa.size(), storage.size() - 1 );
+   WALBERLA_CHECK_EQUAL( soa.find( last ), 5 );
+   WALBERLA_CHECK_EQUAL( soa.getPosition( 5 ), storage.find( last )->getPosition() );
+   WALBERLA_CHECK_EQUAL( soa.find( 5 ), soa.size() );
+
+   storage.clear();
+}
+
+void shapeTest()
+{
+   // polydisperse spheres: every radius is a distinct shape, equal radii share one entry
+   BodyStorage storage;
+   MaterialID iron = Material::find("iron");
+   for( id_t i = 0; i < 1000; ++i )
+      storage.add( std::make_unique<Sphere>( i, i, Vec3( real_c(i), 0, 0 ), Vec3(), Quat(), real_c( i % 500 + 1 ) * real_t(0.001), iron, false, true, false ) );
+
+   SoABodyStorage soa;
+   soa.load( storage );
+   WALBERLA_CHECK_EQUAL( soa.getShapeCount(), 500 );
+   for( auto it = storage.begin(); it != storage.end(); ++it )
+   {
+      const auto& shape = soa.getShape( soa.getShapeIndex( soa.find( it->getSystemID() ) ) );
+      WALBERLA_CHECK_EQUAL( shape.typeID, Sphere::getStaticTypeID() );
+      WALBERLA_CHECK_FLOAT_EQUAL( shape.parameters[0], static_cast<ConstSphereID>( it.getBodyID() )->getRadius() );
+   }
+
+   SoABodyStorage::Shape box = { Box::getStaticTypeID(), Vec3( 1, 2, 3 ) };
+   const auto boxIndex = soa.addShape( box );
+   WALBERLA_CHECK_EQUAL( boxIndex, 500 );
+   WALBERLA_CHECK_EQUAL( soa.addShape( box ), boxIndex );
+
+   // shapes are compared exactly: parameters within the tolerance of Vec3::operator== are distinct shapes
+   SoABodyStorage::Shape closeBox = { Box::getStaticTypeID(), Vec3( 1, 2, real_t(3) + real_t(1e-10) ) };
+   WALBERLA_CHECK( !( closeBox == box ) );
+   WALBERLA_CHECK_EQUAL( soa.addShape( closeBox ), 501 );
+
+   // -0 and +0 are the same shape
+   SoABodyStorage::Shape positiveZero = { Box::getStaticTypeID(), Vec3( 1, 2, real_t(0) ) };
+   SoABodyStorage::Shape negativeZero = { Box::getStaticTypeID(), Vec3( 1, 2, -real_t(0) ) };
+   WALBERLA_CHECK( positiveZero == negativeZero );
+   WALBERLA_CHECK_EQUAL( SoABodyStorage::ShapeHash()( positiveZero ), SoABodyStorage::ShapeHash()( negativeZero ) );
+   WALBERLA_CHECK_EQUAL( soa.addShape( negativeZero ), soa.addShape( positiveZero ) );
+
+   storage.clear();
+}
+
+void integratorTest()
+{
+   BodyStorage reference;
+   fill( reference );
+   BodyStorage storage;
+   fill( storage );
+
+   SoABodyStorage soa;
+   soa.load( storage );
+
+   const Vec3 g( 0, 0, real_t(-9.81) );
+   Gravity gravity( g );
+   cr::IntegrateImplicitEuler integrate;
+   const real_t dt = real_t(0.01);
+
+   for( int step = 0; step < 10; ++step )
+   {
+      for( auto it = reference.begin(); it != reference.end(); ++it )
+      {
+         if( !it->hasInfiniteMass() )
+            integrate( it.getBodyID(), dt, gravity );
+         it->resetForceAndTorque();
+         // same forces in every time step for both storages
+         it->setForce( Vec3( 0, real_t(1), 0 ) );
+         it->setTorque( Vec3( real_t(0.1), 0, 0 ) );
+      }
+
+      cr::integrateImplicitEuler( soa, dt, g );
+      for( SoABodyStorage::size_type i = 0; i < soa.size(); ++i )
+      {
+         soa.getForce( i ) = Vec3( 0, real_t(1), 0 );
+         soa.getTorque( i ) = Vec3( real_t(0.1), 0, 0 );
+      }
+   }
+
+   soa.store( storage );
+
+   for( auto it = reference.begin(); it != reference.end(); ++it )
+   {
+      auto body = storage.find( it->getSystemID() );
+      WALBERLA_CHECK_FLOAT_EQUAL( body->getPosition(),   it->getPosition() );
+      WALBERLA_CHECK_FLOAT_EQUAL( body->getLinearVel(),  it->getLinearVel() );
+      WALBERLA_CHECK_FLOAT_EQUAL( body->getAngularVel(), it->getAngularVel() );
+      WALBERLA_CHECK_FLOAT_EQUAL( body->getRotation(),   it->getRotation() );
+      WALBERLA_CHECK_FLOAT_EQUAL( body->getForce(),      it->getForce() );
+   }
+
+   reference.clear();
+   storage.clear();
+}
+
+void contactTest()
+{
+   BodyStorage storage;
+   fill( storage );
+
+   SoABodyStorage soa;
+   soa.load( storage );
+
+   std::vector< std::pair<SoABodyStorage::size_type, SoABodyStorage::size_type> > pairs;
+   for( SoABodyStorage::size_type i = 0; i < soa.size(); ++i )
+      for( SoABodyStorage::size_type j = i + 1; j < soa.size(); ++j )
+         pairs.push_back( std::make_pair( i, j ) );
+
+   std::vector< fcd::SoAContact > contacts;
+   fcd::generateSphereContacts( soa, pairs, contacts );
+
+   std::vector< Contact > reference;
+   for( auto pair = pairs.begin(); pair != pairs.end(); ++pair )
+   {
+      BodyID b1 = storage.find( soa.getSystemID( pair->first ) ).getBodyID();
+      BodyID b2 = storage.find( soa.getSystemID( pair->second ) ).getBodyID();
+      if( b1->getTypeID() == Sphere::getStaticTypeID() && b2->getTypeID() == Sphere::getStaticTypeID() )
+         fcd::analytic::collide( static_cast<SphereID>( b1 ), static_cast<SphereID>( b2 ), reference );
+   }
+
+   WALBERLA_CHECK_GREATER( reference.size(), 0 );
+   WALBERLA_CHECK_EQUAL( contacts.size(), reference.size() );
+   for( size_t c = 0; c < contacts.size(); ++c )
+   {
+      WALBERLA_CHECK_EQUAL( soa.getSystemID( contacts[c].body1 ), reference[c].getBody1()->getSystemID() );
+      WALBERLA_CHECK_EQUAL( soa.getSystemID( contacts[c].body2 ), reference[c].getBody2()->getSystemID() );
+      WALBERLA_CHECK_FLOAT_EQUAL( contacts[c].position, reference[c].getPosition() );
+      WALBERLA_CHECK_FLOAT_EQUAL( contacts[c].normal,   reference[c].getNormal() );
+      WALBERLA_CHECK_FLOAT_EQUAL( contacts[c].distance, reference[c].getDistance() );
+   }
+
+   storage.clear();
+}
+
+int main( int argc, char ** argv )
+{
+   walberla::debug::enterTestMode();
+
+   walberla::MPIManager::instance()->initializeMPI( &argc, &argv );
+
+   SetBodyTypeIDs<BodyTuple>::execute();
+
+   storageTest();
+   shapeTest();
+   integratorTest();
+   contactTest();
+
+   return EXIT_SUCCESS;
+}
+} // namespace walberla
+
+int main( int argc, char* argv[] )
+{
+  return walberla::main( argc, argv );
+}
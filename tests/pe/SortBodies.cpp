@@ -0,0 +1,104 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//! \file SortBodies.cpp
+//
+//======================================================================================================================
+
+#include "pe/basic.h"
+#include "pe/utility/SortBodies.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/math/Random.h"
+
+#include <map>
+
+namespace walberla {
+using namespace walberla::pe;
+
+void mortonKeyTest()
+{
+   const math::AABB aabb( 0, 0, 0, 1, 1, 1 );
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( 0, 0, 0 ), aabb ), uint64_t(0) );
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( 1, 1, 1 ), aabb ), ( uint64_t(1) << 63 ) - 1 );
+   // positions outside are clamped
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( -1, -1, -1 ), aabb ), uint64_t(0) );
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( 2, 2, 2 ), aabb ), ( uint64_t(1) << 63 ) - 1 );
+   // the x-coordinate determines the lowest bit, the z-coordinate the highest
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( 1, 0, 0 ), aabb ), uint64_t(0x1249249249249249) );
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( 0, 1, 0 ), aabb ), uint64_t(0x1249249249249249) << 1 );
+   WALBERLA_CHECK_EQUAL( getMortonKey( Vec3( 0, 0, 1 ), aabb ), uint64_t(0x1249249249249249) << 2 );
+   // the upper half of the domain in z comes after the lower half
+   WALBERLA_CHECK_LESS( getMortonKey( Vec3( real_t(0.49), real_t(0.99), real_t(0.49) ), aabb ),
+                        getMortonKey( Vec3( real_t(0.01), real_t(0.01), real_t(0.51) ), aabb ) );
+}
+
+void sortTest()
+{
+   MaterialID iron = Material::find("iron");
+
+   BodyStorage storage;
+   std::map<walberla::id_t, ConstBodyID> bodies;
+   math::seedRandomGenerator(1337);
+   for (walberla::id_t i = 0; i < 1000; ++i)
+   {
+      const Vec3 pos( math::realRandom<real_t>(0, 10), math::realRandom<real_t>(0, 10), math::realRandom<real_t>(0, 10) );
+      bodies[i] = &storage.add( std::make_unique<Sphere>( i, i, pos, Vec3(), Quat(), real_t(0.1), iron, false, true, false ) );
+   }
+
+   sortBodies( storage );
+   storage.validate();
+
+   WALBERLA_CHECK_EQUAL( storage.size(), bodies.size() );
+   math::AABB bounds( storage.front().getPosition(), storage.front().getPosition() );
+   for (auto it = storage.begin(); it != storage.end(); ++it)
+      bounds.merge( it->getPosition() );
+   for (size_t i = 1; i < storage.size(); ++i)
+   {
+      WALBERLA_CHECK_LESS_EQUAL( getMortonKey( storage.at(i - 1)->getPosition(), bounds ), getMortonKey( storage.at(i)->getPosition(), bounds ) );
+   }
+
+   // bodies are found by their system id and are not moved in memory
+   for (auto it = bodies.begin(); it != bodies.end(); ++it)
+   {
+      auto bodyIt = storage.find( it->first );
+      WALBERLA_CHECK( bodyIt != storage.end() );
+      WALBERLA_CHECK_EQUAL( bodyIt.getBodyID(), it->second );
+   }
+
+   // removal still works on the reordered storage
+   storage.remove( walberla::id_t(500) );
+   storage.validate();
+   WALBERLA_CHECK( storage.find( walberla::id_t(500) ) == storage.end() );
+   WALBERLA_CHECK_EQUAL( storage.find( walberla::id_t(501) ).getBodyID(), bodies[501] );
+}
+
+int main( int argc, char** argv )
+{
+   walberla::debug::enterTestMode();
+   walberla::MPIManager::instance()->initializeMPI( &argc, &argv );
+
+   mortonKeyTest();
+   sortTest();
+
+   return EXIT_SUCCESS;
+}
+} // namespace walberla
+
+int main( int argc, char* argv[] )
+{
+  return walberla::main( argc, argv );
+}
@@ -0,0 +1,206 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file SynchronizationDelta.cpp
+//
+//======================================================================================================================
+
+#include "pe/basic.h"
+#include "pe/communication/Instantiate.h"
+#include "pe/synchronization/SyncNextNeighbors.h"
+
+#include "blockforest/all.h"
+#include "core/all.h"
+#include "domain_decomposition/all.h"
+
+#include "core/debug/TestSubsystem.h"
+
+#include <boost/tuple/tuple.hpp>
+
+#include <cmath>
+#include <map>
+
+namespace walberla {
+using namespace walberla::pe;
+
+typedef boost::tuple<Sphere> BodyTuple ;
+
+template< typename V >
+void checkClose( const V& shadow, const V& owner, const uint_t size, const real_t tolerance )
+{
+   for (uint_t i = 0; i < size; ++i)
+   {
+      if (tolerance > real_t(0))
+      {
+         WALBERLA_CHECK_LESS_EQUAL( std::fabs( shadow[i] - owner[i] ), tolerance );
+      } else
+      {
+         WALBERLA_CHECK_IDENTICAL( shadow[i], owner[i] );
+      }
+   }
+}
+
+/// Shadow copies must hold exactly the state of their (process local) owners, or differ by at most 'tolerance'.
+void checkShadowCopies( StructuredBlockForest& forest, BlockDataID storageID, const real_t tolerance )
+{
+   std::map<walberla::id_t, ConstBodyID> owners;
+   for (auto it = forest.begin(); it != forest.end(); ++it)
+   {
+      BodyStorage& localStorage = (*it->getData< Storage >( storageID ))[0];
+      for (auto bodyIt = localStorage.begin(); bodyIt != localStorage.end(); ++bodyIt)
+         owners[ bodyIt->getSystemID() ] = bodyIt.getBodyID();
+   }
+
+   for (auto it = forest.begin(); it != forest.end(); ++it)
+   {
+      BodyStorage& shadowStorage = (*it->getData< Storage >( storageID ))[1];
+      for (auto bodyIt = shadowStorage.begin(); bodyIt != shadowStorage.end(); ++bodyIt)
+      {
+         auto owner = owners.find( bodyIt->getSystemID() );
+         if (owner == owners.end()) continue;
+
+         // the shadow copy is shifted by the domain size across periodic boundaries
+         Vec3 position = owner->second->getPosition();
+         pe::communication::correctBodyPosition( forest.getDomain(), it->getAABB().center(), position );
+
+         checkClose( bodyIt->getPosition(),    position,                          3, tolerance );
+         checkClose( bodyIt->getQuaternion(),  owner->second->getQuaternion(),    4, tolerance );
+         checkClose( bodyIt->getLinearVel(),   owner->second->getLinearVel(),     3, tolerance );
+         checkClose( bodyIt->getAngularVel(),  owner->second->getAngularVel(),    3, tolerance );
+      }
+   }
+}
+
+/// 'movingColumns' of the 8 columns of particles move, the others are at rest until hit
+std::map<walberla::id_t, Vec3> sim( shared_ptr< StructuredBlockForest > forest, const bool deltaUpdates, const int movingColumns, const real_t tolerance,
+                                    int64_t& bytes )
+{
+   shared_ptr<BodyStorage> globalStorage = make_shared<BodyStorage>();
+
+   auto storageID = forest->addBlockData(createStorageDataHandling<BodyTuple>(), "Storage");
+   auto ccdID     = forest->addBlockData(ccd::createHashGridsDataHandling( globalStorage, storageID ), "CCD");
+   auto fcdID     = forest->addBlockData(fcd::createGenericFCDDataHandling<BodyTuple, fcd::AnalyticCollideFunctor>(), "FCD");
+
+   cr::DEM cr( globalStorage, forest->getBlockStoragePointer(), storageID, ccdID, fcdID, nullptr );
+
+   const real_t dv = real_c(0.5);
+   math::seedRandomGenerator(1337);
+   for (int z = 0; z < 8; ++z)
+      for (int y = 0; y < 8; ++y)
+         for (int x = 0; x < 8; ++x)
+         {
+            SphereID sp = pe::createSphere( *globalStorage, forest->getBlockStorage(), storageID,
+                                            static_cast<walberla::id_t>(x + 8 * (y + 8 * z)), Vec3(real_c(x) + real_c(0.5), real_c(y) + real_c(0.5), real_c(z) + real_c(0.5)), real_c(0.45));
+            const Vec3 v( math::realRandom<real_t>(-dv, dv), math::realRandom<real_t>(-dv, dv), math::realRandom<real_t>(-dv, dv) );
+            if (sp != nullptr && x < movingColumns) sp->setLinearVel( v );
+         }
+
+   bytes = 0;
+   for (int i = 0; i < 50; ++i)
+   {
+      bytes += pe::internal::syncNextNeighbors<BodyTuple>( forest->getBlockForest(), storageID, nullptr, real_t(0), false, deltaUpdates, tolerance );
+      checkShadowCopies( *forest, storageID, tolerance );
+      cr.timestep( real_c(0.05) );
+   }
+   bytes += pe::internal::syncNextNeighbors<BodyTuple>( forest->getBlockForest(), storageID, nullptr, real_t(0), false, deltaUpdates, tolerance );
+   checkShadowCopies( *forest, storageID, tolerance );
+
+   std::map<walberla::id_t, Vec3> res;
+   for (auto it = forest->begin(); it != forest->end(); ++it)
+   {
+      BodyStorage& localStorage = (*it->getData< Storage >( storageID ))[0];
+      for (auto bodyIt = localStorage.begin(); bodyIt != localStorage.end(); ++bodyIt)
+         res[ bodyIt->getID() ] = bodyIt->getPosition();
+   }
+   return res;
+}
+
+void checkIdentical( const std::map<walberla::id_t, Vec3>& full, const std::map<walberla::id_t, Vec3>& delta )
+{
+   WALBERLA_CHECK_EQUAL( full.size(), delta.size() );
+   for (auto it = full.begin(); it != full.end(); ++it)
+   {
+      auto other = delta.find( it->first );
+      WALBERLA_CHECK( other != delta.end(), "body " << it->first << " missing" );
+      WALBERLA_CHECK_IDENTICAL( it->second, other->second );
+   }
+}
+
+void checkBytes( int64_t fullBytes, int64_t deltaBytes, const bool allowEqual )
+{
+   mpi::allReduceInplace( fullBytes, mpi::SUM );
+   mpi::allReduceInplace( deltaBytes, mpi::SUM );
+   WALBERLA_LOG_INFO_ON_ROOT( "bytes sent: " << fullBytes << " (full) / " << deltaBytes << " (delta)" );
+   if (allowEqual)
+   {
+      WALBERLA_CHECK_LESS_EQUAL( deltaBytes, fullBytes );
+   } else
+   {
+      WALBERLA_CHECK_LESS( deltaBytes, fullBytes );
+   }
+}
+
+int main( int argc, char** argv )
+{
+   walberla::debug::enterTestMode();
+   walberla::MPIManager::instance()->initializeMPI( &argc, &argv );
+
+   SetBodyTypeIDs<BodyTuple>::execute();
+
+   shared_ptr< StructuredBlockForest > forest = blockforest::createUniformBlockGrid(
+            uint_c( 2), uint_c( 2), uint_c( 2), // number of blocks in x,y,z direction
+            uint_c( 1), uint_c( 1), uint_c( 1), // how many cells per block (x,y,z)
+            real_c(4),                          // dx: length of one cell in physical coordinates
+            0,                                  // max blocks per process
+            false, false,                       // include metis / force metis
+            true, true, true );                 // full periodicity
+
+   // half of the particles at rest: the delta-encoded updates send less data, but must not change the simulation
+   {
+      int64_t fullBytes  = 0;
+      int64_t deltaBytes = 0;
+      const auto full  = sim( forest, false, 4, real_t(0), fullBytes );
+      const auto delta = sim( forest, true,  4, real_t(0), deltaBytes );
+      checkIdentical( full, delta );
+      checkBytes( fullBytes, deltaBytes, false );
+   }
+
+   // all particles move: nearly every body changes in every step, the delta-encoded updates must not send more data
+   {
+      int64_t fullBytes  = 0;
+      int64_t deltaBytes = 0;
+      const auto full  = sim( forest, false, 8, real_t(0), fullBytes );
+      const auto delta = sim( forest, true,  8, real_t(0), deltaBytes );
+      checkIdentical( full, delta );
+      checkBytes( fullBytes, deltaBytes, true );
+   }
+
+   // with a tolerance, small changes are not sent (checkShadowCopies verifies the deviation)
+   {
+      int64_t fullBytes  = 0;
+      int64_t deltaBytes = 0;
+      sim( forest, false, 8, real_t(0), fullBytes );
+      sim( forest, true,  8, real_c(1e-3), deltaBytes );
+      checkBytes( fullBytes, deltaBytes, false );
+   }
+
+   return EXIT_SUCCESS;
+}
+} // namespace walberla
+
+int main( int argc, char* argv[] )
+{
+  return walberla::main( argc, argv );
+}
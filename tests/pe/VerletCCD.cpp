@@ -0,0 +1,143 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file VerletCCD.cpp
+//
+//======================================================================================================================
+
+#include "pe/basic.h"
+#include "pe/cr/PlainIntegrator.h"
+#include "pe/ccd/SimpleCCDDataHandling.h"
+#include "pe/ccd/VerletCCDDataHandling.h"
+
+#include "blockforest/all.h"
+#include "core/all.h"
+#include "domain_decomposition/all.h"
+
+#include "core/debug/TestSubsystem.h"
+#include "core/math/Random.h"
+
+namespace walberla {
+using namespace walberla::pe;
+
+typedef boost::tuple<Sphere, Plane> BodyTuple ;
+
+int main( int argc, char** argv )
+{
+    walberla::debug::enterTestMode();
+
+    walberla::MPIManager::instance()->initializeMPI( &argc, &argv );
+
+    MaterialID iron = Material::find("iron");
+
+    shared_ptr<BodyStorage> globalBodyStorage = make_shared<BodyStorage>();
+
+    // create blocks
+    shared_ptr< StructuredBlockForest > forest = blockforest::createUniformBlockGrid(
+             uint_c( 1), uint_c( 1), uint_c( 1), // number of blocks in x,y,z direction
+             uint_c( 1), uint_c( 1), uint_c( 1), // how many cells per block (x,y,z)
+             real_c(10),                         // dx: length of one cell in physical coordinates
+             0,                                  // max blocks per process
+             false, false,                       // include metis / force metis
+             false, false, false );              // no periodicity
+
+    SetBodyTypeIDs<BodyTuple>::execute();
+
+    auto storageID           = forest->addBlockData(createStorageDataHandling<BodyTuple>(), "Storage");
+    auto sccdID              = forest->addBlockData(ccd::createSimpleCCDDataHandling( globalBodyStorage, storageID ), "SCCD");
+    auto vccdID              = forest->addBlockData(ccd::createVerletCCDDataHandling( globalBodyStorage, storageID, real_c(0.4) ), "VCCD");
+    auto fcdID               = forest->addBlockData(fcd::createGenericFCDDataHandling<BodyTuple, fcd::AnalyticCollideFunctor>(), "FCD");
+    cr::PlainIntegrator cr(globalBodyStorage, forest->getBlockStoragePointer(), storageID, nullptr);
+
+    pe::createPlane( *globalBodyStorage, 0, Vec3(0, +1, 0), Vec3(5, 0,5), iron);
+    pe::createPlane( *globalBodyStorage, 0, Vec3(0, -1, 0), Vec3(5,10,5), iron);
+
+    pe::createPlane( *globalBodyStorage, 0, Vec3(+1, 0, 0), Vec3( 0,5,5), iron);
+    pe::createPlane( *globalBodyStorage, 0, Vec3(-1, 0, 0), Vec3(10,5,5), iron);
+
+    pe::createPlane( *globalBodyStorage, 0, Vec3( 0, 0,+1), Vec3(5,5, 0), iron);
+    pe::createPlane( *globalBodyStorage, 0, Vec3( 0, 0,-1), Vec3(5,5,10), iron);
+
+    math::seedRandomGenerator(1337);
+
+    const real_t dv = 1;
+    for (uint_t i = 0; i < 1000; ++i)
+    {
+       SphereID sp = pe::createSphere(*globalBodyStorage, forest->getBlockStorage(), storageID, i,
+                        Vec3(math::realRandom<real_t>(real_c(0), real_c(10)), math::realRandom<real_t>(real_c(0), real_c(10)), math::realRandom<real_t>(real_c(0), real_c(10))), real_c(0.4));
+       if (sp != nullptr) sp->setLinearVel(Vec3(math::realRandom<real_t>(-dv, dv), math::realRandom<real_t>(-dv, dv), math::realRandom<real_t>(-dv, dv)));
+    }
+
+    const int steps = 100;
+    for (int step=0; step < steps; ++step)
+    {
+       for (auto it = forest->begin(); it != forest->end(); ++it){
+          IBlock & currentBlock = *it;
+
+          ccd::ICCD* sccd = currentBlock.getData< ccd::ICCD >( sccdID );
+          ccd::ICCD* vccd = currentBlock.getData< ccd::ICCD >( vccdID );
+          fcd::IFCD* fcd  = currentBlock.getData< fcd::IFCD >( fcdID );
+          Contacts cont1 = fcd->generateContacts( sccd->generatePossibleContacts() );
+          auto tmp1 = cont1.size();
+          Contacts cont2 = fcd->generateContacts( vccd->generatePossibleContacts() );
+          auto tmp2 = cont2.size();
+          WALBERLA_CHECK_EQUAL(sccd->getObservedBodyCount(), vccd->getObservedBodyCount());
+          WALBERLA_CHECK_EQUAL(tmp1, tmp2);
+          WALBERLA_LOG_DETAIL_ON_ROOT("contacts on root: " << cont1.size());
+
+          // check for correct ordering of bodies within contacts
+          for (size_t i = 0; i < cont2.size(); ++i)
+          {
+             WALBERLA_CHECK_LESS(cont2[i].getBody1()->getSystemID(), cont2[i].getBody2()->getSystemID());
+          }
+       }
+
+       cr( real_c(0.01) );
+    }
+
+    // removing bodies updates the tracked bodies of both coarse collision detections
+    for (auto it = forest->begin(); it != forest->end(); ++it){
+       BodyStorage& localStorage = (*it->getData< Storage >( storageID ))[0];
+       for (walberla::id_t sid = 0; sid < 1000; sid += 3)
+          if (localStorage.find( sid ) != localStorage.end())
+             localStorage.remove( sid );
+
+       ccd::ICCD* sccd = it->getData< ccd::ICCD >( sccdID );
+       ccd::ICCD* vccd = it->getData< ccd::ICCD >( vccdID );
+       fcd::IFCD* fcd  = it->getData< fcd::IFCD >( fcdID );
+       const auto contacts = fcd->generateContacts( sccd->generatePossibleContacts() ).size();
+       WALBERLA_CHECK_EQUAL(sccd->getObservedBodyCount(), vccd->getObservedBodyCount());
+       WALBERLA_CHECK_EQUAL(contacts, fcd->generateContacts( vccd->generatePossibleContacts() ).size());
+    }
+
+    for (auto it = forest->begin(); it != forest->end(); ++it){
+       ccd::VerletCCD* vccd = it->getData< ccd::VerletCCD >( vccdID );
+       WALBERLA_LOG_INFO("rebuilds: " << vccd->getRebuildCount() << "/" << vccd->getUpdateCount()
+                         << " (" << vccd->getRebuildFrequency() << "), neighbors: " << vccd->getNeighborCount());
+       WALBERLA_CHECK_EQUAL(vccd->getUpdateCount(), steps + 1);
+       WALBERLA_CHECK_GREATER(vccd->getRebuildCount(), 1);
+       WALBERLA_CHECK_LESS(vccd->getRebuildCount(), steps / 2);
+    }
+
+    forest.reset();
+
+    return EXIT_SUCCESS;
+}
+} // namespace walberla
+
+int main( int argc, char* argv[] )
+{
+  return walberla::main( argc, argv );
+}
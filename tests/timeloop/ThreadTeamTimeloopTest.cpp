@@ -0,0 +1,217 @@
+//======================================================================================================================
+//
+//  This file is part of waLBerla. waLBerla is free software: you can
+//  redistribute it and/or modify it under the terms of the GNU General Public
+//  License as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version.
+//
+//  waLBerla is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//  for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with waLBerla (see COPYING.txt). If not, see <http://www.gnu.org/licenses/>.
+//
+//! \file ThreadTeamTimeloopTest.cpp
+//! \ingroup timeloop
+//! \brief Compares a smoothing iteration run with the ThreadTeamTimeloop (local communication executed as sweep)
+//!        to the same iteration run with the SweepTimeloop
+//
+//======================================================================================================================
+
+#include "blockforest/Initialization.h"
+#include "blockforest/communication/UniformBufferedScheme.h"
+
+#include "core/OpenMP.h"
+#include "core/debug/TestSubsystem.h"
+#include "core/mpi/Environment.h"
+
+#include "field/AddToStorage.h"
+#include "field/GhostLayerField.h"
+#include "field/communication/PackInfo.h"
+#include "field/iterators/IteratorMacros.h"
+
+#include "stencil/D3Q7.h"
+
+#include "timeloop/SweepTimeloop.h"
+#include "timeloop/ThreadTeamTimeloop.h"
+
+#include <set>
+
+
+namespace thread_team_timeloop_test {
+
+using namespace walberla;
+
+typedef GhostLayerField< real_t, 1 > ScalarField;
+using Stencil_T = stencil::D3Q7;
+
+const uint_t Iterations = uint_t(10);
+
+
+
+class SmoothingSweep
+{
+public:
+
+   SmoothingSweep( const BlockDataID & srcId, const BlockDataID & dstId ) : srcId_( srcId ), dstId_( dstId ) {}
+
+   void operator()( IBlock * block ) const
+   {
+      ScalarField * src = block->getData< ScalarField >( srcId_ );
+      ScalarField * dst = block->getData< ScalarField >( dstId_ );
+
+      WALBERLA_FOR_ALL_CELLS_XYZ( src,
+         real_t sum = src->get( x, y, z );
+         for( auto d = Stencil_T::beginNoCenter(); d != Stencil_T::end(); ++d )
+            sum += src->get( x + d.cx(), y + d.cy(), z + d.cz() );
+         dst->get( x, y, z ) = sum / real_c( Stencil_T::Size );
+      )
+
+      src->swapDataPointers( dst );
+   }
+
+private:
+
+   BlockDataID srcId_;
+   BlockDataID dstId_;
+};
+
+
+
+void initialize( const shared_ptr< StructuredBlockForest > & blocks, const BlockDataID & id )
+{
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      ScalarField * field = block->getData< ScalarField >( id );
+      WALBERLA_FOR_ALL_CELLS_XYZ( field,
+         Cell global( x, y, z );
+         blocks->transformBlockLocalToGlobalCell( global, *block );
+         field->get( x, y, z ) = real_c( ( global.x() * 7 + global.y() * 3 + global.z() ) % 11 );
+      )
+   }
+}
+
+
+
+int main( int argc, char ** argv )
+{
+   debug::enterTestMode();
+   mpi::Environment env( argc, argv );
+
+   auto blocks = blockforest::createUniformBlockGrid( 4, 2, 2,      // blocks
+                                                      4, 4, 4,      // cells per block
+                                                      real_t(1),    // dx
+                                                      uint_t(0), false, false,
+                                                      true, true, true ); // periodicity
+
+   const BlockDataID refId    = field::addToStorage< ScalarField >( blocks, "reference",     real_t(0), field::zyxf, uint_t(1) );
+   const BlockDataID refTmpId = field::addToStorage< ScalarField >( blocks, "reference tmp", real_t(0), field::zyxf, uint_t(1) );
+   const BlockDataID id       = field::addToStorage< ScalarField >( blocks, "field",         real_t(0), field::zyxf, uint_t(1) );
+   const BlockDataID tmpId    = field::addToStorage< ScalarField >( blocks, "field tmp",     real_t(0), field::zyxf, uint_t(1) );
+
+   initialize( blocks, refId );
+   initialize( blocks, id );
+
+   // reference: SweepTimeloop, local communication in startCommunication()
+
+   blockforest::communication::UniformBufferedScheme< Stencil_T > refCommunication( blocks );
+   refCommunication.addPackInfo( make_shared< field::communication::PackInfo< ScalarField > >( refId ) );
+
+   SweepTimeloop refTimeloop( blocks, Iterations );
+   refTimeloop.add() << BeforeFunction( refCommunication, "communication" )
+                     << Sweep( SmoothingSweep( refId, refTmpId ), "smoothing" );
+   refTimeloop.run();
+
+   // thread team timeloop, local communication executed by the threads that own the receiving blocks
+
+   blockforest::communication::UniformBufferedScheme< Stencil_T > communication( blocks );
+   communication.addPackInfo( make_shared< field::communication::PackInfo< ScalarField > >( id ) );
+   communication.setLocalMode( blockforest::SWEEP );
+
+   uint_t afterTimeStepCalls = uint_t(0);
+
+   ThreadTeamTimeloop timeloop( blocks, Iterations );
+   timeloop.add() << BeforeFunction( communication.getStartCommunicateFunctor(), "communication start" )
+                  << Sweep( communication.getLocalCommunicationSweep(), "local communication" );
+   timeloop.add() << BeforeFunction( communication.getWaitFunctor(), "communication wait" )
+                  << Sweep( SmoothingSweep( id, tmpId ), "smoothing" );
+   timeloop.addFuncAfterTimeStep( [&afterTimeStepCalls]() { ++afterTimeStepCalls; }, "counter" );
+
+   WcTimingPool timing;
+   timeloop.run( timing );
+
+   WALBERLA_CHECK_EQUAL( timeloop.getCurrentTimeStep(), Iterations );
+   WALBERLA_CHECK_EQUAL( afterTimeStepCalls, Iterations );
+   WALBERLA_CHECK( timing.timerExists( "smoothing" ) );
+
+   // every block is owned by exactly one thread
+   std::set< IBlock * > ownedBlocks;
+   for( uint_t t = 0; t != timeloop.numberOfThreads(); ++t )
+      for( auto block = timeloop.blocksOfThread( t ).begin(); block != timeloop.blocksOfThread( t ).end(); ++block )
+         WALBERLA_CHECK( ownedBlocks.insert( *block ).second );
+   WALBERLA_CHECK_EQUAL( ownedBlocks.size(), blocks->getNumberOfBlocks() );
+
+   for( auto block = blocks->begin(); block != blocks->end(); ++block )
+   {
+      ScalarField * reference = block->getData< ScalarField >( refId );
+      ScalarField * field     = block->getData< ScalarField >( id );
+      WALBERLA_FOR_ALL_CELLS_XYZ( field,
+         WALBERLA_CHECK_FLOAT_EQUAL( field->get( x, y, z ), reference->get( x, y, z ) );
+      )
+   }
+
+   // stop() called from a function that is executed by the master thread
+
+   ThreadTeamTimeloop stoppedTimeloop( blocks, Iterations );
+   stoppedTimeloop.add() << Sweep( []( IBlock * ) {}, "empty" );
+   stoppedTimeloop.addFuncAfterTimeStep( [&stoppedTimeloop]() { if( stoppedTimeloop.getCurrentTimeStep() == uint_t(2) ) stoppedTimeloop.stop(); }, "stop" );
+   stoppedTimeloop.run();
+
+   WALBERLA_CHECK_EQUAL( stoppedTimeloop.getCurrentTimeStep(), uint_t(3) );
+
+   // no sweeps: all threads must still leave the loop after the same time step
+
+   uint_t emptyTimeStepCalls = uint_t(0);
+
+   ThreadTeamTimeloop emptyTimeloop( blocks, Iterations );
+   emptyTimeloop.addFuncAfterTimeStep( [&emptyTimeStepCalls]() { ++emptyTimeStepCalls; }, "counter" );
+   emptyTimeloop.run();
+
+   WALBERLA_CHECK_EQUAL( emptyTimeloop.getCurrentTimeStep(), Iterations );
+   WALBERLA_CHECK_EQUAL( emptyTimeStepCalls, Iterations );
+
+#ifdef _OPENMP
+   // smaller thread team than requested: within an active parallel region (and without nested parallelism), the team
+   // of run() consists of one thread, which has to process the blocks of all threads
+
+   uint_t sweepCalls = uint_t(0);
+
+   ThreadTeamTimeloop nestedTimeloop( blocks, Iterations );
+   nestedTimeloop.add() << Sweep( [&sweepCalls]( IBlock * ) {
+      #pragma omp atomic
+      ++sweepCalls;
+   }, "counter" );
+
+   const int maxActiveLevels = omp_get_max_active_levels();
+   omp_set_max_active_levels( 1 );
+   #pragma omp parallel num_threads( 2 )
+   {
+      #pragma omp master
+      nestedTimeloop.run();
+   }
+   omp_set_max_active_levels( maxActiveLevels );
+
+   WALBERLA_CHECK_EQUAL( sweepCalls, Iterations * blocks->getNumberOfBlocks() );
+#endif
+
+   return EXIT_SUCCESS;
+}
+
+} // namespace thread_team_timeloop_test
+
+int main( int argc, char ** argv )
+{
+   return thread_team_timeloop_test::main( argc, argv );
+}